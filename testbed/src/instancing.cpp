@@ -0,0 +1,131 @@
+#include "instancing.hpp"
+
+#include <cmath>
+
+#include "scripts/camera.hpp"
+
+namespace {
+
+// A tetrahedron with flat normals, so that the vertex work stays negligible next to the instance data.
+constexpr glm::vec3 corner_a{ 0.5f, 0.5f, 0.5f };
+constexpr glm::vec3 corner_b{ 0.5f, -0.5f, -0.5f };
+constexpr glm::vec3 corner_c{ -0.5f, 0.5f, -0.5f };
+constexpr glm::vec3 corner_d{ -0.5f, -0.5f, 0.5f };
+
+constexpr std::array faces = {
+    std::array{ corner_a, corner_b, corner_c },
+    std::array{ corner_a, corner_d, corner_b },
+    std::array{ corner_a, corner_c, corner_d },
+    std::array{ corner_b, corner_d, corner_c },
+};
+
+auto create_tetrahedron(zth::InstanceFormat instance_format) -> std::shared_ptr<const zth::Mesh>
+{
+    zth::Vector<zth::StandardVertex> vertices;
+    zth::Vector<zth::u8> indices;
+
+    for (const auto& [a, b, c] : faces)
+    {
+        auto normal = glm::normalize(glm::cross(b - a, c - a));
+
+        for (auto [position, uv] : { std::pair{ a, glm::vec2{ 0.0f, 0.0f } }, std::pair{ b, glm::vec2{ 1.0f, 0.0f } },
+                                     std::pair{ c, glm::vec2{ 0.0f, 1.0f } } })
+        {
+            indices.push_back(static_cast<zth::u8>(vertices.size()));
+            vertices.push_back(zth::StandardVertex{ .position = position, .normal = normal, .uv = uv });
+        }
+    }
+
+    return std::make_shared<zth::IndexedMesh<zth::StandardVertex, zth::u8>>(vertices, indices, instance_format);
+}
+
+} // namespace
+
+Instancing::Instancing(zth::InstanceFormat instance_format, bool retained)
+    : Scene(retained                                           ? "Retained Instancing"
+            : instance_format == zth::InstanceFormat::Compact ? "Compact Instancing"
+                                                               : "Instancing"),
+      _instance_format{ instance_format }, _retained{ retained }
+{}
+
+auto Instancing::on_load() -> void
+{
+    constexpr auto extent = static_cast<float>(grid_size) * spacing;
+
+    // --- Camera ---
+    // Far enough away to see the whole grid, so that nothing gets culled.
+    _camera.transform()
+        .translate(glm::vec3{ 0.0f, extent * 0.6f, extent * 0.6f })
+        .set_direction(glm::normalize(glm::vec3{ 0.0f, -1.0f, -1.0f }));
+    _camera.emplace_or_replace<zth::CameraComponent>(zth::CameraComponent{ .far = extent * 2.0f });
+    _camera.emplace_or_replace<zth::ScriptComponent>(zth::make_unique<scripts::Camera>());
+
+    // --- Lights ---
+    _ambient_light.emplace_or_replace<zth::LightComponent>(zth::LightType::Ambient);
+    _directional_light.transform().set_direction(glm::normalize(glm::vec3{ -0.3f, -1.0f, -0.5f }));
+    _directional_light.emplace_or_replace<zth::LightComponent>(zth::LightType::Directional);
+
+    // --- Instances ---
+    _mesh = create_tetrahedron(_instance_format);
+
+    for (zth::u32 x = 0; x < grid_size; x++)
+    {
+        for (zth::u32 z = 0; z < grid_size; z++)
+        {
+            glm::vec3 position{ static_cast<float>(x) * spacing - extent * 0.5f, 0.0f,
+                                static_cast<float>(z) * spacing - extent * 0.5f };
+
+            // Every instance gets its own rotation and a non-uniform scale, so that the normal matrices aren't trivial.
+            auto angle = static_cast<float>(x * 7 + z * 13);
+            auto instance = create_entity("Instance");
+
+            instance.emplace_or_replace<zth::MeshRendererComponent>(_mesh, _retained);
+            instance.emplace_or_replace<zth::MaterialComponent>(_material);
+            instance.transform()
+                .translate(position)
+                .rotate(angle, glm::normalize(glm::vec3{ std::sin(angle), 1.0f, std::cos(angle) }))
+                .set_scale(glm::vec3{ 1.0f, 0.5f + static_cast<float>((x + z) % 4) * 0.25f, 1.0f });
+
+            if (_retained && (x * grid_size + z) % animated_instance_stride == 0)
+                _animated_instances.push_back(instance);
+        }
+    }
+}
+
+auto Instancing::on_update() -> void
+{
+    _frames++;
+    _frame_time_sum += zth::Application::frame_time();
+    _instance_bytes_sum += zth::Renderer::stats_last_frame().instance_bytes_uploaded;
+
+    const auto& retained_stats = zth::Renderer::retained_instance_stats_last_frame();
+    _reused_instances_sum += retained_stats.reused_instances;
+    _uploaded_instances_sum += retained_stats.uploaded_instances;
+
+    auto angle = static_cast<float>(zth::Application::frame_time());
+
+    for (auto& instance : _animated_instances)
+        instance.transform().rotate(angle, glm::vec3{ 0.0f, 1.0f, 0.0f });
+}
+
+auto Instancing::on_unload() -> void
+{
+    if (_frames == 0)
+        return;
+
+    auto frames = static_cast<double>(_frames);
+
+    ZTH_INFO("[{}] {} instances of {} bytes, {} frames: {:.3f}ms per frame, {:.2f}MB of instance data per frame.",
+             name(), grid_size * grid_size,
+             _instance_format == zth::InstanceFormat::Compact ? sizeof(zth::CompactInstanceVertex)
+                                                              : sizeof(zth::InstanceVertex),
+             _frames, _frame_time_sum / frames * 1000.0,
+             zth::memory::to_megabytes(_instance_bytes_sum) / frames);
+
+    if (_retained)
+    {
+        ZTH_INFO("[{}] {:.0f} instances reused and {:.0f} uploaded per frame.", name(),
+                 static_cast<double>(_reused_instances_sum) / frames,
+                 static_cast<double>(_uploaded_instances_sum) / frames);
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+// A large grid of small meshes, all of them in view. Every instance gets streamed to the GPU every frame, so the frame
+// is dominated by writing the instance data, which makes the scene a benchmark for the instance formats:
+//
+// testbed --headless --frames 600 --scene Instancing
+// testbed --headless --frames 600 --scene "Compact Instancing"
+// testbed --headless --frames 600 --scene "Retained Instancing"
+//
+// In the retained variant the meshes are static, so their instance data stays on the GPU, and only every
+// animated_instance_stride-th instance moves and gets uploaded again every frame.
+//
+// The average frame time and the amount of instance data streamed per frame get logged when the scene gets unloaded.
+
+class Instancing : public zth::Scene
+{
+public:
+    static constexpr zth::u32 grid_size = 448; // About 200k instances.
+    static constexpr float spacing = 1.5f;
+    static constexpr zth::u32 animated_instance_stride = 100;
+
+public:
+    explicit Instancing(zth::InstanceFormat instance_format = zth::InstanceFormat::Standard, bool retained = false);
+    ZTH_NO_COPY_NO_MOVE(Instancing)
+    ~Instancing() override = default;
+
+private:
+    zth::InstanceFormat _instance_format;
+    bool _retained;
+
+    zth::EntityHandle _camera = create_entity("Camera");
+    zth::EntityHandle _ambient_light = create_entity("Ambient Light");
+    zth::EntityHandle _directional_light = create_entity("Directional Light");
+
+    std::shared_ptr<const zth::Mesh> _mesh;
+    std::shared_ptr<zth::Material> _material = std::make_shared<zth::Material>();
+    zth::Vector<zth::EntityHandle> _animated_instances;
+
+    zth::u64 _frames = 0;
+    double _frame_time_sum = 0.0;
+    zth::u64 _instance_bytes_sum = 0;
+    zth::u64 _reused_instances_sum = 0;
+    zth::u64 _uploaded_instances_sum = 0;
+
+private:
+    auto on_load() -> void override;
+    auto on_update() -> void override;
+    auto on_unload() -> void override;
+};
+
+class CompactInstancing : public Instancing
+{
+public:
+    explicit CompactInstancing() : Instancing{ zth::InstanceFormat::Compact } {}
+};
+
+class RetainedInstancing : public Instancing
+{
+public:
+    explicit RetainedInstancing() : Instancing{ zth::InstanceFormat::Standard, true } {}
+};
@@ -1,9 +1,11 @@
 #include "main_layer.hpp"
 #include "main_scene.hpp"
 
+#include <charconv>
+
 namespace {
 
-const zth::ApplicationSpec app_spec = {
+zth::ApplicationSpec app_spec = {
     .window_spec = {
         .size = { 800, 600 },
         .title = "Testbed",
@@ -19,10 +21,92 @@ const zth::ApplicationSpec app_spec = {
     }
 };
 
+struct CommandLineOptions
+{
+    zth::Optional<zth::String> scene = zth::nil;
+    bool headless = false;
+};
+
+// Lets benchmarks and CI run the testbed unattended:
+// --headless           Renders into an invisible window, as fast as possible, with a fixed delta time.
+// --frames <count>     Quits after rendering the given number of frames.
+// --screenshot <path>  Saves the last frame as a PNG image.
+// --scene <name>       Starts with the given scene instead of the main scene.
+// --shader-cache <dir> Keeps linked shader programs in the given directory. Pointing it at an empty directory gives a
+//                      cold start, running again with the same one gives a warm start.
+// --no-shader-cache    Compiles every shader from source.
+auto parse_command_line(std::span<char*> args, zth::ApplicationSpec& spec)
+    -> zth::Result<CommandLineOptions, zth::String>
+{
+    CommandLineOptions options;
+
+    for (zth::usize i = 1; i < args.size(); i++)
+    {
+        std::string_view arg = args[i];
+
+        if (arg == "--headless")
+        {
+            options.headless = true;
+            spec.window_spec.headless = true;
+            spec.window_spec.frame_rate_limit = zth::nil;
+            spec.fixed_delta_time = 1.0 / 60.0;
+            continue;
+        }
+
+        if (arg == "--no-shader-cache")
+        {
+            spec.shader_cache_directory = zth::nil;
+            continue;
+        }
+
+        if (i + 1 >= args.size())
+            return zth::Error{ zth::format("Unknown option or missing value: \"{}\".", arg) };
+
+        std::string_view value = args[++i];
+
+        if (arg == "--frames")
+        {
+            zth::u64 frame_count = 0;
+            auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), frame_count);
+
+            if (error != std::errc{} || end != value.data() + value.size() || frame_count == 0)
+                return zth::Error{ zth::format("Invalid frame count: \"{}\".", value) };
+
+            spec.frame_count = frame_count;
+        }
+        else if (arg == "--screenshot")
+        {
+            spec.screenshot_path = std::filesystem::path{ value };
+        }
+        else if (arg == "--scene")
+        {
+            options.scene = zth::String{ value };
+        }
+        else if (arg == "--shader-cache")
+        {
+            spec.shader_cache_directory = std::filesystem::path{ value };
+        }
+        else
+        {
+            return zth::Error{ zth::format("Unknown option: \"{}\".", arg) };
+        }
+    }
+
+    return options;
+}
+
 } // namespace
 
-auto main() -> int
+auto main(int argc, char* argv[]) -> int
 {
+    auto options = parse_command_line(std::span{ argv, static_cast<std::size_t>(argc) }, app_spec);
+
+    if (!options)
+    {
+        std::println(std::cerr, "CRITICAL ERROR: {}", options.error());
+        return -1;
+    }
+
     auto init_application_result = zth::Application::init(app_spec);
 
     if (!init_application_result)
@@ -31,7 +115,7 @@ auto main() -> int
         return -1;
     }
 
-    auto push_layer_result = zth::Application::push_layer(zth::make_unique<MainLayer>());
+    auto push_layer_result = zth::Application::push_layer(zth::make_unique<MainLayer>(options->scene));
 
     if (!push_layer_result)
     {
@@ -39,14 +123,20 @@ auto main() -> int
         return -1;
     }
 
-    push_layer_result = zth::Application::push_overlay(zth::make_unique<zth::DebugOverlay>());
-
-    if (!push_layer_result)
+    // The debug overlay would end up in the screenshots.
+    if (!options->headless)
     {
-        std::println(std::cerr, "CRITICAL ERROR: {}", push_layer_result.error());
-        return -1;
+        push_layer_result = zth::Application::push_overlay(zth::make_unique<zth::DebugOverlay>());
+
+        if (!push_layer_result)
+        {
+            std::println(std::cerr, "CRITICAL ERROR: {}", push_layer_result.error());
+            return -1;
+        }
     }
 
-    zth::SceneManager::queue_scene<MainScene>();
+    if (!options->scene)
+        zth::SceneManager::queue_scene<MainScene>();
+
     zth::Application::run();
 }
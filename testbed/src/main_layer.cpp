@@ -1,14 +1,28 @@
 #include "main_layer.hpp"
 
 #include "containers.hpp"
+#include "instancing.hpp"
 #include "main_scene.hpp"
+#include "occlusion.hpp"
+#include "overdraw.hpp"
 #include "sprites.hpp"
 
+MainLayer::MainLayer(zth::Optional<zth::String> initial_scene) : _initial_scene{ std::move(initial_scene) } {}
+
 auto MainLayer::on_attach() -> zth::Result<void, zth::String>
 {
     _scene_picker.add_scene<MainScene>("Main Scene");
     _scene_picker.add_scene<Containers>("Containers");
     _scene_picker.add_scene<Sprites>("Sprites");
+    _scene_picker.add_scene<Overdraw>("Overdraw");
+    _scene_picker.add_scene<Instancing>("Instancing");
+    _scene_picker.add_scene<CompactInstancing>("Compact Instancing");
+    _scene_picker.add_scene<RetainedInstancing>("Retained Instancing");
+    _scene_picker.add_scene<Occlusion>("Occlusion");
+
+    if (_initial_scene && !_scene_picker.select_scene(*_initial_scene))
+        return zth::Error{ zth::format("Unknown scene: \"{}\".", *_initial_scene) };
+
     return {};
 }
 
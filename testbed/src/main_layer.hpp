@@ -7,12 +7,15 @@ public:
     static constexpr auto next_scene_key = zth::Key::Right;
 
 public:
+    explicit MainLayer(zth::Optional<zth::String> initial_scene = zth::nil);
+
     auto on_attach() -> zth::Result<void, zth::String> override;
     auto on_event(const zth::Event& event) -> void override;
     auto on_update() -> void override;
 
 private:
     zth::debug::ScenePicker _scene_picker;
+    zth::Optional<zth::String> _initial_scene;
 
 private:
     auto on_key_pressed_event(const zth::KeyPressedEvent& event) -> void;
@@ -0,0 +1,117 @@
+#include "occlusion.hpp"
+
+#include "scripts/camera.hpp"
+
+Occlusion::Occlusion() : Scene("Occlusion") {}
+
+auto Occlusion::on_load() -> void
+{
+    constexpr auto extent = static_cast<float>(room_count) * room_size;
+    constexpr auto wall_thickness = 0.2f;
+
+    // --- Camera ---
+    // In the middle of the room in the middle of the grid.
+    auto center_room = static_cast<float>(room_count / 2) * room_size - extent * 0.5f + room_size * 0.5f;
+    _camera.transform().translate(glm::vec3{ center_room, 1.7f, center_room });
+    _camera.emplace_or_replace<zth::CameraComponent>(zth::CameraComponent{ .far = extent * 1.5f });
+    _camera.emplace_or_replace<zth::ScriptComponent>(zth::make_unique<scripts::Camera>());
+
+    // --- Lights ---
+    _ambient_light.emplace_or_replace<zth::LightComponent>(zth::LightType::Ambient);
+    _directional_light.transform().set_direction(glm::normalize(glm::vec3{ -0.3f, -1.0f, -0.5f }));
+    _directional_light.emplace_or_replace<zth::LightComponent>(zth::LightType::Directional);
+
+    // --- Floor ---
+    _floor.emplace_or_replace<zth::MeshRendererComponent>(zth::meshes::cube());
+    _floor.emplace_or_replace<zth::MaterialComponent>(zth::materials::plain());
+    _floor.transform().translate(glm::vec3{ 0.0f, -0.05f, 0.0f }).set_scale(glm::vec3{ extent, 0.1f, extent });
+
+    // --- Walls ---
+    // The cube's box is an exact occluder for the cube itself, so every wall can share it.
+    _wall_occluder = std::make_shared<zth::OccluderMesh>(zth::OccluderMesh::box(zth::meshes::cube()->aabb()));
+    _wall_material = std::make_shared<zth::Material>(zth::Material{ .albedo = glm::vec3{ 0.8f, 0.8f, 0.7f } });
+
+    // Every wall gets split in two by a doorway in its middle.
+    constexpr auto segment_length = (room_size - doorway_width) * 0.5f;
+    constexpr auto segment_offset = (doorway_width + segment_length) * 0.5f;
+
+    for (zth::u32 line = 0; line <= room_count; line++)
+    {
+        auto line_position = static_cast<float>(line) * room_size - extent * 0.5f;
+
+        for (zth::u32 room = 0; room < room_count; room++)
+        {
+            auto room_center = static_cast<float>(room) * room_size - extent * 0.5f + room_size * 0.5f;
+
+            for (auto side : { -1.0f, 1.0f })
+            {
+                auto along = room_center + side * segment_offset;
+
+                create_wall(glm::vec3{ line_position, wall_height * 0.5f, along },
+                            glm::vec3{ wall_thickness, wall_height, segment_length });
+                create_wall(glm::vec3{ along, wall_height * 0.5f, line_position },
+                            glm::vec3{ segment_length, wall_height, wall_thickness });
+            }
+        }
+    }
+
+    // --- Objects ---
+    _object_material = std::make_shared<zth::Material>(zth::Material{ .albedo = glm::vec3{ 0.3f, 0.5f, 0.9f } });
+
+    constexpr zth::u32 objects_per_row = 8;
+    constexpr auto object_spacing = (room_size - 2.0f) / static_cast<float>(objects_per_row);
+
+    for (zth::u32 room_x = 0; room_x < room_count; room_x++)
+    {
+        for (zth::u32 room_z = 0; room_z < room_count; room_z++)
+        {
+            glm::vec3 room_corner{ static_cast<float>(room_x) * room_size - extent * 0.5f + 1.0f, 0.0f,
+                                   static_cast<float>(room_z) * room_size - extent * 0.5f + 1.0f };
+
+            for (zth::u32 i = 0; i < objects_per_room; i++)
+            {
+                auto x = static_cast<float>(i % objects_per_row) + 0.5f;
+                auto z = static_cast<float>(i / objects_per_row) + 0.5f;
+                auto height = 0.3f + static_cast<float>((i * 7 + room_x + room_z) % 5) * 0.2f;
+
+                auto object = create_entity("Object");
+                object.emplace_or_replace<zth::MeshRendererComponent>(zth::meshes::cube());
+                object.emplace_or_replace<zth::MaterialComponent>(_object_material);
+                object.transform()
+                    .translate(room_corner + glm::vec3{ x * object_spacing, height * 0.5f, z * object_spacing })
+                    .set_scale(glm::vec3{ 0.4f, height, 0.4f });
+            }
+        }
+    }
+}
+
+auto Occlusion::on_update() -> void
+{
+    _frames++;
+    _frame_time_sum += zth::Application::frame_time();
+
+    const auto& occlusion_culling_stats = zth::Renderer::occlusion_culling_stats_last_frame();
+    _tested_objects_sum += occlusion_culling_stats.tested_objects;
+    _occluded_objects_sum += occlusion_culling_stats.occluded_objects;
+}
+
+auto Occlusion::on_unload() -> void
+{
+    if (_frames == 0)
+        return;
+
+    auto frames = static_cast<double>(_frames);
+
+    ZTH_INFO("[{}] {} frames: {:.3f}ms per frame, {:.0f} of {:.0f} objects tested occluded per frame.", name(),
+             _frames, _frame_time_sum / frames * 1000.0, static_cast<double>(_occluded_objects_sum) / frames,
+             static_cast<double>(_tested_objects_sum) / frames);
+}
+
+auto Occlusion::create_wall(glm::vec3 center, glm::vec3 size) -> void
+{
+    auto wall = create_entity("Wall");
+    wall.emplace_or_replace<zth::MeshRendererComponent>(zth::meshes::cube());
+    wall.emplace_or_replace<zth::MaterialComponent>(_wall_material);
+    wall.emplace_or_replace<zth::OccluderComponent>(_wall_occluder);
+    wall.transform().translate(center).set_scale(size);
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+// A grid of rooms separated by walls with doorways, full of small objects, with the camera in one of the rooms. Almost
+// everything which lies within the frustum is hidden behind the walls, which are occluders, so most of the objects
+// should get culled by occlusion culling:
+//
+// testbed --headless --frames 600 --scene Occlusion
+//
+// The average frame time and the number of objects occluded per frame get logged when the scene gets unloaded.
+
+class Occlusion : public zth::Scene
+{
+public:
+    static constexpr zth::u32 room_count = 12; // Along every axis.
+    static constexpr float room_size = 10.0f;
+    static constexpr float wall_height = 4.0f;
+    static constexpr float doorway_width = 2.0f;
+    static constexpr zth::u32 objects_per_room = 64;
+
+public:
+    explicit Occlusion();
+    ZTH_NO_COPY_NO_MOVE(Occlusion)
+    ~Occlusion() override = default;
+
+private:
+    zth::EntityHandle _camera = create_entity("Camera");
+    zth::EntityHandle _ambient_light = create_entity("Ambient Light");
+    zth::EntityHandle _directional_light = create_entity("Directional Light");
+    zth::EntityHandle _floor = create_entity("Floor");
+
+    std::shared_ptr<const zth::OccluderMesh> _wall_occluder;
+    std::shared_ptr<zth::Material> _wall_material;
+    std::shared_ptr<zth::Material> _object_material;
+
+    zth::u64 _frames = 0;
+    double _frame_time_sum = 0.0;
+    zth::u64 _tested_objects_sum = 0;
+    zth::u64 _occluded_objects_sum = 0;
+
+private:
+    auto on_load() -> void override;
+    auto on_update() -> void override;
+    auto on_unload() -> void override;
+
+    auto create_wall(glm::vec3 center, glm::vec3 size) -> void;
+};
@@ -0,0 +1,56 @@
+#include "overdraw.hpp"
+
+#include <cmath>
+#include <numbers>
+
+#include "scripts/camera.hpp"
+
+namespace {
+
+constexpr std::array wall_colors = { glm::vec3{ 0.9f, 0.3f, 0.3f }, glm::vec3{ 0.3f, 0.9f, 0.3f },
+                                     glm::vec3{ 0.3f, 0.3f, 0.9f }, glm::vec3{ 0.9f, 0.9f, 0.3f } };
+
+constexpr float wall_spacing = 0.5f;
+
+} // namespace
+
+Overdraw::Overdraw() : Scene("Overdraw") {}
+
+auto Overdraw::on_load() -> void
+{
+    static_assert(wall_colors.size() == material_count);
+
+    // --- Camera ---
+    _camera.transform().translate(glm::vec3{ 0.0f, 0.0f, 2.0f });
+    _camera.emplace_or_replace<zth::ScriptComponent>(zth::make_unique<scripts::Camera>());
+
+    // --- Ambient Light ---
+    _ambient_light.emplace_or_replace<zth::LightComponent>(zth::LightType::Ambient);
+
+    // --- Walls ---
+    for (zth::usize i = 0; i < material_count; i++)
+        _wall_materials[i] = std::make_shared<zth::Material>(zth::Material{ .albedo = wall_colors[i] });
+
+    // Every wall uses the same mesh and material bindings, so without front-to-back sorting they get drawn in whatever
+    // order the scene submits them in.
+    for (zth::usize i = 0; i < wall_count; i++)
+    {
+        auto depth = static_cast<float>(wall_count - i) * wall_spacing;
+        auto wall = create_entity(zth::format("Wall {}", i));
+
+        wall.emplace_or_replace<zth::MeshRendererComponent>(zth::meshes::cube());
+        wall.emplace_or_replace<zth::MaterialComponent>(_wall_materials[i % material_count]);
+        wall.transform().translate(glm::vec3{ 0.0f, 0.0f, -depth }).set_scale(glm::vec3{ 100.0f, 100.0f, 0.1f });
+    }
+
+    // --- Point Lights ---
+    // Make the shading expensive enough for the overdraw to dominate the frame.
+    for (zth::usize i = 0; i < point_light_count; i++)
+    {
+        auto angle = 2.0f * std::numbers::pi_v<float> * static_cast<float>(i) / static_cast<float>(point_light_count);
+        auto light = create_entity(zth::format("Point Light {}", i));
+
+        light.transform().translate(glm::vec3{ std::cos(angle) * 3.0f, std::sin(angle) * 3.0f, 0.5f });
+        light.emplace_or_replace<zth::LightComponent>(zth::LightType::Point);
+    }
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+// A stack of walls one behind another, all of them covering the whole view, lit by many point lights. Almost every
+// pixel gets shaded once per wall unless the walls get rendered front to back or with the depth pre-pass, which makes
+// it a benchmark for both.
+
+class Overdraw : public zth::Scene
+{
+public:
+    static constexpr zth::usize wall_count = 48;
+    static constexpr zth::usize material_count = 4;
+    static constexpr zth::usize point_light_count = 16;
+
+public:
+    explicit Overdraw();
+    ZTH_NO_COPY_NO_MOVE(Overdraw)
+    ~Overdraw() override = default;
+
+private:
+    zth::EntityHandle _camera = create_entity("Camera");
+    zth::EntityHandle _ambient_light = create_entity("Ambient Light");
+
+    std::array<std::shared_ptr<zth::Material>, material_count> _wall_materials;
+
+private:
+    auto on_load() -> void override;
+};
@@ -0,0 +1,81 @@
+#include <catch2/catch_test_macros.hpp>
+#include <entt/entity/entity.hpp>
+#include <glm/vec3.hpp>
+
+#include <algorithm>
+#include <ranges>
+#include <vector>
+
+#include <zenith/ecs/change_log.hpp>
+#include <zenith/ecs/components.hpp>
+#include <zenith/ecs/ecs.hpp>
+
+using zth::ChangeLog;
+using zth::Registry;
+using zth::TransformComponent;
+
+namespace {
+
+auto logged_entities(const ChangeLog& log) -> std::vector<entt::entity>
+{
+    auto entities = log.entities();
+    std::vector<entt::entity> result{ entities.begin(), entities.end() };
+    std::ranges::sort(result);
+    return result;
+}
+
+auto sorted(std::vector<entt::entity> entities) -> std::vector<entt::entity>
+{
+    std::ranges::sort(entities);
+    return entities;
+}
+
+} // namespace
+
+TEST_CASE("Registry logs the entities whose transforms changed", "[ChangeLog]")
+{
+    Registry registry;
+    auto& log = registry.transform_changes();
+
+    auto first = registry.create();
+    auto second = registry.create();
+    auto third = registry.create();
+
+    REQUIRE(logged_entities(log) == sorted({ first.id(), second.id(), third.id() }));
+
+    log.clear();
+    REQUIRE(log.entities().empty());
+
+    SECTION("every entity gets logged once")
+    {
+        second.transform().translate(glm::vec3{ 1.0f });
+        second.transform().set_scale(2.0f);
+        REQUIRE(logged_entities(log) == std::vector{ second.id() });
+
+        log.clear();
+        second.transform().translate(glm::vec3{ 1.0f });
+        REQUIRE(logged_entities(log) == std::vector{ second.id() });
+    }
+
+    SECTION("replacing the component logs its entity")
+    {
+        first.replace<TransformComponent>(glm::vec3{ 2.0f });
+        REQUIRE(logged_entities(log) == std::vector{ first.id() });
+
+        log.clear();
+        first.transform().translate(glm::vec3{ 1.0f });
+        REQUIRE(logged_entities(log) == std::vector{ first.id() });
+    }
+
+    SECTION("components stay attached to their entities after other entities get destroyed")
+    {
+        auto first_id = first.id();
+        first.destroy_now();
+        REQUIRE(std::ranges::contains(log.entities(), first_id));
+
+        log.clear();
+        third.transform().translate(glm::vec3{ 1.0f });
+        second.transform().translate(glm::vec3{ 1.0f });
+        REQUIRE(logged_entities(log) == sorted({ second.id(), third.id() }));
+    }
+}
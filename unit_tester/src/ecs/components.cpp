@@ -0,0 +1,30 @@
+#include <catch2/catch_test_macros.hpp>
+#include <glm/vec3.hpp>
+
+#include <zenith/ecs/components.hpp>
+
+using zth::TransformComponent;
+
+TEST_CASE("Transform versions never repeat", "[TransformComponent]")
+{
+    TransformComponent transform;
+    auto initial_version = transform.version();
+
+    transform.translate(glm::vec3{ 1.0f });
+    auto translated_version = transform.version();
+    REQUIRE(translated_version != initial_version);
+
+    SECTION("a transform which replaces another one gets a version of its own")
+    {
+        transform = TransformComponent{};
+        REQUIRE(transform.version() != initial_version);
+        REQUIRE(transform.version() != translated_version);
+    }
+
+    SECTION("every transform gets a version of its own")
+    {
+        TransformComponent other;
+        other.translate(glm::vec3{ 1.0f });
+        REQUIRE(other.version() != translated_version);
+    }
+}
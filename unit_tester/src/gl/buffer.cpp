@@ -0,0 +1,98 @@
+#include <algorithm>
+
+#include <zenith/core/typedefs.hpp>
+#include <zenith/gl/buffer.hpp>
+#include <zenith/util/optional.hpp>
+
+using zth::u32;
+
+using zth::gl::StreamingRegions;
+
+namespace {
+
+// Not a power of two, like the size of an instance.
+constexpr u32 instance_size = 112;
+constexpr u32 instances_per_region = 16384;
+constexpr u32 region_size_bytes = instance_size * instances_per_region;
+constexpr u32 region_count = 3;
+
+// Does what Buffer::allocate_streaming() does, minus the fences.
+auto allocate(StreamingRegions& regions, u32 size_bytes, u32 alignment) -> zth::Optional<u32>
+{
+    auto offset = regions.offset_in_current_region(size_bytes, alignment);
+
+    if (!offset)
+    {
+        if (!regions.offset_in_next_region(size_bytes, alignment))
+            return zth::nil;
+
+        regions.next_region();
+        offset = regions.offset_in_current_region(size_bytes, alignment);
+    }
+
+    if (offset)
+        regions.allocate(*offset, size_bytes);
+
+    return offset;
+}
+
+} // namespace
+
+TEST_CASE("Allocations as big as a whole region go to the start of the next region", "[StreamingRegions]")
+{
+    StreamingRegions regions{ region_size_bytes, region_count };
+
+    auto small = allocate(regions, instance_size * 10, instance_size);
+    REQUIRE(small == 0u);
+
+    REQUIRE_FALSE(regions.offset_in_current_region(region_size_bytes, instance_size).has_value());
+    REQUIRE(regions.offset_in_next_region(region_size_bytes, instance_size) == region_size_bytes);
+
+    auto whole_region = allocate(regions, region_size_bytes, instance_size);
+    REQUIRE(whole_region == region_size_bytes);
+    REQUIRE(regions.current_region() == 1);
+    REQUIRE(regions.current_region_offset() == region_size_bytes);
+}
+
+TEST_CASE("Allocations bigger than a region fail", "[StreamingRegions]")
+{
+    StreamingRegions regions{ region_size_bytes, region_count };
+
+    REQUIRE_FALSE(allocate(regions, region_size_bytes + 1, 1).has_value());
+    REQUIRE(regions.current_region() == 0);
+    REQUIRE(regions.current_region_offset() == 0);
+}
+
+TEST_CASE("A batch can stream through more than two regions", "[StreamingRegions]")
+{
+    StreamingRegions regions{ region_size_bytes, region_count };
+
+    // Something from an earlier batch, so that the batch doesn't start at the beginning of a region.
+    REQUIRE(allocate(regions, 100, 1).has_value());
+
+    // Chunked the same way as Renderer::stream_instances().
+    u32 instances_left = instances_per_region * 4 + 123;
+    u32 chunks = 0;
+    u32 regions_entered = 0;
+
+    while (instances_left > 0)
+    {
+        auto instance_count = std::min(instances_left, instances_per_region);
+        auto region_before = regions.current_region();
+
+        auto offset = allocate(regions, instance_count * instance_size, instance_size);
+
+        REQUIRE(offset.has_value());
+        REQUIRE(*offset % instance_size == 0);
+        REQUIRE(*offset + instance_count * instance_size <= region_size_bytes * region_count);
+
+        if (regions.current_region() != region_before)
+            regions_entered++;
+
+        instances_left -= instance_count;
+        chunks++;
+    }
+
+    REQUIRE(chunks == 5);
+    REQUIRE(regions_entered >= 4);
+}
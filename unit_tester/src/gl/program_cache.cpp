@@ -0,0 +1,83 @@
+#include <algorithm>
+#include <array>
+#include <span>
+
+#include <zenith/core/typedefs.hpp>
+#include <zenith/gl/program_cache.hpp>
+#include <zenith/gl/shader.hpp>
+
+using zth::byte;
+using zth::u64;
+
+using zth::gl::ProgramBinary;
+using zth::gl::ProgramStage;
+using zth::gl::ShaderType;
+
+namespace {
+
+constexpr auto driver = "Vendor\nRenderer\n4.6.0 Driver 1.0";
+
+const std::array stages = {
+    ProgramStage{ .type = ShaderType::Vertex, .source = "#version 460 core\nvoid main() {}\n" },
+    ProgramStage{ .type = ShaderType::Fragment, .source = "#version 460 core\nout vec4 color;\nvoid main() {}\n" },
+};
+
+const std::array binary_data = { byte{ 0x01 }, byte{ 0x23 }, byte{ 0x45 }, byte{ 0x67 }, byte{ 0x89 } };
+constexpr GLenum binary_format = 0x8e21;
+
+} // namespace
+
+TEST_CASE("Program cache keys change with the sources and the driver", "[ProgramCache]")
+{
+    auto key = zth::gl::program_cache_key(stages, driver);
+
+    REQUIRE(zth::gl::program_cache_key(stages, driver) == key);
+
+    auto edited_stages = stages;
+    edited_stages[1].source = "#version 460 core\nout vec4 color;\nvoid main() { color = vec4(1.0); }\n";
+    REQUIRE(zth::gl::program_cache_key(edited_stages, driver) != key);
+
+    auto swapped_types = stages;
+    swapped_types[0].type = ShaderType::Fragment;
+    swapped_types[1].type = ShaderType::Vertex;
+    REQUIRE(zth::gl::program_cache_key(swapped_types, driver) != key);
+
+    REQUIRE(zth::gl::program_cache_key(stages, "Vendor\nRenderer\n4.6.0 Driver 1.1") != key);
+    REQUIRE(zth::gl::program_cache_key(std::span{ stages }.first(1), driver) != key);
+}
+
+TEST_CASE("Program cache entries round-trip", "[ProgramCache]")
+{
+    auto key = zth::gl::program_cache_key(stages, driver);
+    auto entry = zth::gl::encode_program_binary(key, ProgramBinary{ .format = binary_format, .binary = binary_data });
+
+    auto decoded = zth::gl::decode_program_binary(entry, key);
+
+    REQUIRE(decoded.has_value());
+    REQUIRE(decoded->format == binary_format);
+    REQUIRE(std::ranges::equal(decoded->binary, binary_data));
+}
+
+TEST_CASE("Program cache rejects entries which don't match", "[ProgramCache]")
+{
+    auto key = zth::gl::program_cache_key(stages, driver);
+    auto entry = zth::gl::encode_program_binary(key, ProgramBinary{ .format = binary_format, .binary = binary_data });
+
+    SECTION("Different key")
+    {
+        REQUIRE_FALSE(zth::gl::decode_program_binary(entry, key + 1).has_value());
+    }
+
+    SECTION("Truncated entry")
+    {
+        REQUIRE_FALSE(zth::gl::decode_program_binary(std::span{ entry }.first(entry.size() - 1), key).has_value());
+        REQUIRE_FALSE(zth::gl::decode_program_binary(std::span{ entry }.first(4), key).has_value());
+        REQUIRE_FALSE(zth::gl::decode_program_binary({}, key).has_value());
+    }
+
+    SECTION("Corrupted binary")
+    {
+        entry.back() ^= byte{ 0xff };
+        REQUIRE_FALSE(zth::gl::decode_program_binary(entry, key).has_value());
+    }
+}
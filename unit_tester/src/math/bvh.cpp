@@ -0,0 +1,417 @@
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/ext/matrix_transform.hpp>
+#include <glm/trigonometric.hpp>
+#include <glm/vector_relational.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <zenith/core/typedefs.hpp>
+#include <zenith/log/format.hpp>
+#include <zenith/math/bounds.hpp>
+#include <zenith/math/bvh.hpp>
+#include <zenith/math/frustum.hpp>
+
+using zth::u32;
+using zth::usize;
+
+namespace {
+
+auto generate_boxes(usize count, std::mt19937& generator) -> std::vector<zth::math::Aabb>
+{
+    std::uniform_real_distribution<float> position_distribution{ -200.0f, 200.0f };
+    std::uniform_real_distribution<float> extent_distribution{ 0.1f, 3.0f };
+
+    std::vector<zth::math::Aabb> boxes;
+    boxes.reserve(count);
+
+    for (usize i = 0; i < count; i++)
+    {
+        glm::vec3 center{ position_distribution(generator), position_distribution(generator),
+                          position_distribution(generator) };
+        glm::vec3 extents{ extent_distribution(generator), extent_distribution(generator),
+                           extent_distribution(generator) };
+        boxes.push_back(zth::math::Aabb{ .min = center - extents, .max = center + extents });
+    }
+
+    return boxes;
+}
+
+auto make_frustum() -> zth::math::Frustum
+{
+    auto projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 150.0f);
+    auto view = glm::lookAt(glm::vec3{ 0.0f, 20.0f, 0.0f }, glm::vec3{ 50.0f, 0.0f, -50.0f },
+                            glm::vec3{ 0.0f, 1.0f, 0.0f });
+    return zth::math::Frustum::from_view_projection(projection * view);
+}
+
+auto contains(const zth::math::Aabb& outer, const zth::math::Aabb& inner) -> bool
+{
+    return glm::all(glm::lessThanEqual(outer.min, inner.min)) && glm::all(glm::greaterThanEqual(outer.max, inner.max));
+}
+
+// Checks that every node reachable from the root contains the bounds of its children and of its primitives, that the
+// nodes' links are consistent, and that every primitive in the hierarchy is in exactly one leaf.
+auto require_valid_hierarchy(const zth::math::Bvh& bvh) -> void
+{
+    using zth::math::Bvh;
+
+    auto nodes = bvh.nodes();
+    auto slots = bvh.slots();
+    auto primitive_bounds = bvh.primitive_bounds();
+
+    std::vector<u32> leaf_counts(primitive_bounds.size(), 0);
+
+    if (!bvh.empty())
+    {
+        REQUIRE(bvh.parent(0) == Bvh::no_node);
+
+        std::vector<u32> stack{ 0 };
+
+        while (!stack.empty())
+        {
+            auto node_index = stack.back();
+            stack.pop_back();
+
+            const auto& node = nodes[node_index];
+
+            if (!node.is_leaf())
+            {
+                for (auto child : { node.first, node.first + 1 })
+                {
+                    REQUIRE(bvh.parent(child) == node_index);
+                    REQUIRE(contains(node.bounds, nodes[child].bounds));
+                    stack.push_back(child);
+                }
+
+                continue;
+            }
+
+            REQUIRE(node.first % Bvh::max_leaf_size == 0);
+            REQUIRE(node.primitive_count > 0);
+            REQUIRE(node.primitive_count <= Bvh::max_leaf_size);
+
+            for (auto slot = node.first; slot < node.first + Bvh::max_leaf_size; slot++)
+            {
+                if (slot >= node.first + node.primitive_count)
+                {
+                    REQUIRE(slots[slot] == Bvh::no_primitive);
+                    continue;
+                }
+
+                REQUIRE(bvh.contains(slots[slot]));
+                REQUIRE(contains(node.bounds, primitive_bounds[slots[slot]]));
+                leaf_counts[slots[slot]]++;
+            }
+        }
+    }
+
+    usize primitive_count = 0;
+
+    for (u32 i = 0; i < leaf_counts.size(); i++)
+    {
+        REQUIRE(leaf_counts[i] == (bvh.contains(i) ? 1 : 0));
+        primitive_count += leaf_counts[i];
+    }
+
+    REQUIRE(primitive_count == bvh.primitive_count());
+}
+
+auto query_brute_force(const zth::math::Bvh& bvh, const zth::math::Frustum& frustum) -> std::vector<u32>
+{
+    std::vector<u32> visible;
+    auto primitive_bounds = bvh.primitive_bounds();
+
+    for (u32 i = 0; i < primitive_bounds.size(); i++)
+    {
+        if (bvh.contains(i) && zth::math::intersects(frustum, primitive_bounds[i]))
+            visible.push_back(i);
+    }
+
+    return visible;
+}
+
+auto query(const zth::math::Bvh& bvh, const zth::math::Frustum& frustum) -> std::vector<u32>
+{
+    std::vector<u32> visible;
+    bvh.query(frustum, [&](u32 primitive_index) { visible.push_back(primitive_index); });
+    std::ranges::sort(visible);
+    return visible;
+}
+
+} // namespace
+
+TEST_CASE("Bvh contains every primitive", "[Bvh]")
+{
+    std::mt19937 generator{ 2025 };
+
+    for (auto count : { usize{ 1 }, usize{ 2 }, usize{ 7 }, usize{ 100 }, usize{ 10'000 } })
+    {
+        zth::math::Bvh bvh;
+        bvh.build(generate_boxes(count, generator));
+
+        REQUIRE(bvh.primitive_count() == count);
+        require_valid_hierarchy(bvh);
+    }
+
+    SECTION("no primitives")
+    {
+        zth::math::Bvh bvh;
+        bvh.build({});
+
+        REQUIRE(bvh.empty());
+        REQUIRE(!bvh.raycast(zth::math::Ray{}));
+        bvh.query(make_frustum(), [](u32) { FAIL(); });
+    }
+
+    SECTION("primitives in the same spot")
+    {
+        std::vector boxes(100, zth::math::Aabb{ .min = glm::vec3{ -1.0f }, .max = glm::vec3{ 1.0f } });
+
+        zth::math::Bvh bvh;
+        bvh.build(boxes);
+        require_valid_hierarchy(bvh);
+    }
+}
+
+TEST_CASE("Bvh frustum query gives the same results as testing primitives one by one", "[Bvh]")
+{
+    std::mt19937 generator{ 2025 };
+    auto frustum = make_frustum();
+
+    zth::math::Bvh bvh;
+    bvh.build(generate_boxes(10'000, generator));
+
+    auto visible = query(bvh, frustum);
+    REQUIRE(!visible.empty());
+    REQUIRE(visible == query_brute_force(bvh, frustum));
+
+    // Refitting takes different paths depending on how many primitives were updated.
+    for (auto moved_count : { usize{ 10 }, usize{ 10'000 } })
+    {
+        std::uniform_int_distribution<u32> index_distribution{ 0, 9'999 };
+        std::uniform_real_distribution<float> offset_distribution{ -20.0f, 20.0f };
+
+        for (usize i = 0; i < moved_count; i++)
+        {
+            auto primitive_index = index_distribution(generator);
+            glm::vec3 offset{ offset_distribution(generator), offset_distribution(generator),
+                              offset_distribution(generator) };
+
+            auto bounds = bvh.primitive_bounds()[primitive_index];
+            bvh.update_primitive(primitive_index,
+                                 zth::math::Aabb{ .min = bounds.min + offset, .max = bounds.max + offset });
+        }
+
+        bvh.refit();
+
+        require_valid_hierarchy(bvh);
+        REQUIRE(query(bvh, frustum) == query_brute_force(bvh, frustum));
+    }
+}
+
+TEST_CASE("Bvh stays valid as primitives get inserted and removed", "[Bvh]")
+{
+    std::mt19937 generator{ 2025 };
+    auto frustum = make_frustum();
+    auto boxes = generate_boxes(5'000, generator);
+
+    zth::math::Bvh bvh;
+    std::vector<u32> primitives;
+
+    for (const auto& box : boxes)
+        primitives.push_back(bvh.insert(box));
+
+    REQUIRE(bvh.primitive_count() == boxes.size());
+    require_valid_hierarchy(bvh);
+    REQUIRE(query(bvh, frustum) == query_brute_force(bvh, frustum));
+
+    // Removing a primitive can empty a leaf, which takes its parent out of the hierarchy.
+    std::ranges::shuffle(primitives, generator);
+    auto removed_count = primitives.size() / 2;
+
+    for (usize i = 0; i < removed_count; i++)
+        bvh.remove(primitives[i]);
+
+    REQUIRE(bvh.primitive_count() == boxes.size() - removed_count);
+    require_valid_hierarchy(bvh);
+    REQUIRE(query(bvh, frustum) == query_brute_force(bvh, frustum));
+
+    SECTION("inserted primitives reuse the indices of removed ones")
+    {
+        for (usize i = 0; i < removed_count; i++)
+        {
+            auto primitive_index = bvh.insert(boxes[i]);
+            REQUIRE(primitive_index < boxes.size());
+        }
+
+        REQUIRE(bvh.primitive_count() == boxes.size());
+        require_valid_hierarchy(bvh);
+        REQUIRE(query(bvh, frustum) == query_brute_force(bvh, frustum));
+    }
+
+    SECTION("primitives which move out of their leaves move to other leaves")
+    {
+        std::uniform_real_distribution<float> offset_distribution{ -100.0f, 100.0f };
+
+        for (auto i = removed_count; i < primitives.size(); i++)
+        {
+            glm::vec3 offset{ offset_distribution(generator), offset_distribution(generator),
+                              offset_distribution(generator) };
+
+            auto bounds = bvh.primitive_bounds()[primitives[i]];
+            bvh.update_primitive(primitives[i],
+                                 zth::math::Aabb{ .min = bounds.min + offset, .max = bounds.max + offset });
+        }
+
+        // The hierarchy has to be valid even before it gets refitted.
+        require_valid_hierarchy(bvh);
+        REQUIRE(query(bvh, frustum) == query_brute_force(bvh, frustum));
+
+        bvh.refit();
+        require_valid_hierarchy(bvh);
+        REQUIRE(query(bvh, frustum) == query_brute_force(bvh, frustum));
+    }
+
+    SECTION("removing every primitive empties the hierarchy")
+    {
+        for (auto i = removed_count; i < primitives.size(); i++)
+            bvh.remove(primitives[i]);
+
+        REQUIRE(bvh.empty());
+        REQUIRE(bvh.primitive_count() == 0);
+        bvh.query(frustum, [](u32) { FAIL(); });
+
+        auto primitive_index = bvh.insert(boxes[0]);
+        REQUIRE(bvh.contains(primitive_index));
+        require_valid_hierarchy(bvh);
+    }
+
+    SECTION("refitting after the updated primitives were removed")
+    {
+        for (auto i = removed_count; i < primitives.size(); i++)
+        {
+            // Shrinking the bounds keeps the primitive in its leaf, so it waits for the refit.
+            auto bounds = bvh.primitive_bounds()[primitives[i]];
+            auto center = bounds.center();
+            bvh.update_primitive(primitives[i], zth::math::Aabb{ .min = center, .max = center });
+        }
+
+        for (auto i = removed_count; i < primitives.size(); i++)
+            bvh.remove(primitives[i]);
+
+        REQUIRE(bvh.empty());
+        bvh.refit();
+        REQUIRE(bvh.empty());
+
+        auto primitive_index = bvh.insert(boxes[0]);
+        bvh.refit();
+        REQUIRE(bvh.contains(primitive_index));
+        require_valid_hierarchy(bvh);
+    }
+}
+
+TEST_CASE("Bvh raycast returns the closest hit", "[Bvh]")
+{
+    std::mt19937 generator{ 2025 };
+    auto boxes = generate_boxes(10'000, generator);
+
+    zth::math::Bvh bvh;
+    bvh.build(boxes);
+
+    std::uniform_real_distribution<float> distribution{ -1.0f, 1.0f };
+
+    for (usize i = 0; i < 100; i++)
+    {
+        zth::math::Ray ray{
+            .origin = glm::vec3{ distribution(generator), distribution(generator), distribution(generator) } * 250.0f,
+            .direction = glm::vec3{ distribution(generator), distribution(generator), distribution(generator) },
+        };
+
+        zth::Optional<float> closest_distance = zth::nil;
+
+        for (const auto& box : boxes)
+        {
+            auto distance = zth::math::intersect(ray, box);
+
+            if (distance && (!closest_distance || *distance < *closest_distance))
+                closest_distance = distance;
+        }
+
+        auto hit = bvh.raycast(ray);
+        REQUIRE(hit.has_value() == closest_distance.has_value());
+
+        if (hit)
+        {
+            REQUIRE(hit->distance == *closest_distance);
+            REQUIRE(zth::math::intersect(ray, boxes[hit->primitive_index]) == closest_distance);
+        }
+    }
+}
+
+TEST_CASE("Bvh benchmark", "[.][benchmark][Bvh]")
+{
+    std::mt19937 generator{ 2025 };
+    auto frustum = make_frustum();
+
+    for (auto count : { usize{ 10'000 }, usize{ 100'000 }, usize{ 1'000'000 } })
+    {
+        auto boxes = generate_boxes(count, generator);
+
+        BENCHMARK(zth::format("build ({} objects)", count))
+        {
+            zth::math::Bvh bvh;
+            bvh.build(boxes);
+            return bvh.nodes().size();
+        };
+
+        BENCHMARK(zth::format("insert ({} objects)", count))
+        {
+            zth::math::Bvh bvh;
+
+            for (const auto& box : boxes)
+                static_cast<void>(bvh.insert(box));
+
+            return bvh.nodes().size();
+        };
+
+        zth::math::Bvh bvh;
+        bvh.build(boxes);
+
+        // Every primitive moves, so this is the worst case for refitting.
+        BENCHMARK(zth::format("refit ({} objects)", count))
+        {
+            for (u32 i = 0; i < boxes.size(); i++)
+                bvh.update_primitive(i, boxes[i]);
+
+            bvh.refit();
+        };
+
+        BENCHMARK(zth::format("frustum query ({} objects)", count))
+        {
+            usize visible_count = 0;
+            bvh.query(frustum, [&](u32) { visible_count++; });
+            return visible_count;
+        };
+
+        BENCHMARK(zth::format("linear frustum culling ({} objects)", count))
+        {
+            usize visible_count = 0;
+
+            for (const auto& box : boxes)
+            {
+                if (zth::math::intersects(frustum, box))
+                    visible_count++;
+            }
+
+            return visible_count;
+        };
+
+        BENCHMARK(zth::format("raycast ({} objects)", count))
+        {
+            return bvh.raycast(zth::math::Ray{ .origin = glm::vec3{ -250.0f, 0.0f, 0.0f },
+                                               .direction = glm::vec3{ 1.0f, 0.01f, 0.02f } });
+        };
+    }
+}
@@ -0,0 +1,188 @@
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/ext/matrix_transform.hpp>
+#include <glm/geometric.hpp>
+#include <glm/trigonometric.hpp>
+#include <glm/vector_relational.hpp>
+
+#include <array>
+#include <random>
+#include <vector>
+
+#include <zenith/core/typedefs.hpp>
+#include <zenith/math/bounds.hpp>
+#include <zenith/math/frustum.hpp>
+
+using zth::u32;
+using zth::usize;
+
+namespace {
+
+// A camera at the origin looking down the negative z axis, with near plane at 1 and far plane at 100.
+auto make_perspective_frustum() -> zth::math::Frustum
+{
+    auto projection = glm::perspective(glm::radians(90.0f), 1.0f, 1.0f, 100.0f);
+    return zth::math::Frustum::from_view_projection(projection);
+}
+
+} // namespace
+
+TEST_CASE("Bounds get computed from points", "[Bounds]")
+{
+    std::array points = {
+        glm::vec3{ -1.0f, 0.0f, 2.0f },
+        glm::vec3{ 3.0f, -2.0f, 0.0f },
+        glm::vec3{ 1.0f, 4.0f, -2.0f },
+    };
+
+    auto aabb = zth::math::compute_aabb(points);
+    REQUIRE(aabb.min == glm::vec3{ -1.0f, -2.0f, -2.0f });
+    REQUIRE(aabb.max == glm::vec3{ 3.0f, 4.0f, 2.0f });
+    REQUIRE(aabb.center() == glm::vec3{ 1.0f, 1.0f, 0.0f });
+
+    auto sphere = zth::math::compute_bounding_sphere(points);
+    REQUIRE(sphere.center == aabb.center());
+
+    for (auto point : points)
+        REQUIRE(glm::length(point - sphere.center) <= sphere.radius);
+
+    SECTION("no points")
+    {
+        auto empty_aabb = zth::math::compute_aabb(std::vector<glm::vec3>{});
+        REQUIRE(empty_aabb.min == glm::vec3{ 0.0f });
+        REQUIRE(empty_aabb.max == glm::vec3{ 0.0f });
+    }
+}
+
+TEST_CASE("Bounds get transformed", "[Bounds]")
+{
+    auto transform = glm::translate(glm::mat4{ 1.0f }, glm::vec3{ 10.0f, 0.0f, 0.0f });
+    transform = glm::rotate(transform, glm::radians(45.0f), glm::vec3{ 0.0f, 0.0f, 1.0f });
+    transform = glm::scale(transform, glm::vec3{ 1.0f, 3.0f, 2.0f });
+
+    zth::math::BoundingSphere sphere{ .center = glm::vec3{ 0.0f }, .radius = 2.0f };
+    auto transformed_sphere = zth::math::transform_bounding_sphere(sphere, transform);
+    REQUIRE_THAT(transformed_sphere.center.x, Catch::Matchers::WithinAbs(10.0f, 1e-5f));
+    REQUIRE_THAT(transformed_sphere.radius, Catch::Matchers::WithinAbs(6.0f, 1e-5f)); // Scaled by the largest scale.
+
+    zth::math::Aabb aabb{ .min = glm::vec3{ -1.0f }, .max = glm::vec3{ 1.0f } };
+    auto transformed_aabb = zth::math::transform_aabb(aabb, transform);
+
+    // Every transformed corner of the box must lie inside of the transformed box.
+    for (auto x : { -1.0f, 1.0f })
+    {
+        for (auto y : { -1.0f, 1.0f })
+        {
+            for (auto z : { -1.0f, 1.0f })
+            {
+                auto corner = glm::vec3{ transform * glm::vec4{ x, y, z, 1.0f } };
+                REQUIRE(glm::all(glm::greaterThanEqual(corner, transformed_aabb.min - 1e-5f)));
+                REQUIRE(glm::all(glm::lessThanEqual(corner, transformed_aabb.max + 1e-5f)));
+            }
+        }
+    }
+}
+
+TEST_CASE("Frustum planes get extracted from a view-projection matrix", "[Frustum]")
+{
+    using zth::math::FrustumPlane;
+
+    auto frustum = make_perspective_frustum();
+
+    for (const auto& plane : frustum.planes)
+        REQUIRE_THAT(glm::length(glm::vec3{ plane }), Catch::Matchers::WithinAbs(1.0f, 1e-5f));
+
+    // The plane normals point inwards.
+    REQUIRE(frustum.plane(FrustumPlane::Near).z < 0.0f);
+    REQUIRE(frustum.plane(FrustumPlane::Far).z > 0.0f);
+    REQUIRE(frustum.plane(FrustumPlane::Left).x > 0.0f);
+    REQUIRE(frustum.plane(FrustumPlane::Right).x < 0.0f);
+
+    SECTION("view transform gets taken into account")
+    {
+        auto view = glm::lookAt(glm::vec3{ 0.0f }, glm::vec3{ 1.0f, 0.0f, 0.0f }, glm::vec3{ 0.0f, 1.0f, 0.0f });
+        auto looking_right = zth::math::Frustum::from_view_projection(
+            glm::perspective(glm::radians(90.0f), 1.0f, 1.0f, 100.0f) * view);
+
+        REQUIRE(zth::math::contains(looking_right, glm::vec3{ 50.0f, 0.0f, 0.0f }));
+        REQUIRE(!zth::math::contains(looking_right, glm::vec3{ 0.0f, 0.0f, -50.0f }));
+    }
+}
+
+TEST_CASE("Frustum intersection predicates", "[Frustum]")
+{
+    using zth::math::Aabb;
+    using zth::math::BoundingSphere;
+    using zth::math::contains;
+    using zth::math::intersects;
+
+    auto frustum = make_perspective_frustum();
+
+    SECTION("points")
+    {
+        REQUIRE(contains(frustum, glm::vec3{ 0.0f, 0.0f, -50.0f }));
+        REQUIRE(contains(frustum, glm::vec3{ 9.0f, -9.0f, -10.0f }));
+        REQUIRE(!contains(frustum, glm::vec3{ 0.0f, 0.0f, -0.5f }));  // In front of the near plane.
+        REQUIRE(!contains(frustum, glm::vec3{ 0.0f, 0.0f, -101.0f })); // Behind the far plane.
+        REQUIRE(!contains(frustum, glm::vec3{ 11.0f, 0.0f, -10.0f }));
+        REQUIRE(!contains(frustum, glm::vec3{ 0.0f, 0.0f, 50.0f }));
+    }
+
+    SECTION("spheres")
+    {
+        REQUIRE(intersects(frustum, BoundingSphere{ .center = glm::vec3{ 0.0f, 0.0f, -50.0f }, .radius = 1.0f }));
+        // Center is outside, but the sphere crosses the right plane.
+        REQUIRE(intersects(frustum, BoundingSphere{ .center = glm::vec3{ 11.0f, 0.0f, -10.0f }, .radius = 1.0f }));
+        REQUIRE(!intersects(frustum, BoundingSphere{ .center = glm::vec3{ 20.0f, 0.0f, -10.0f }, .radius = 1.0f }));
+        REQUIRE(!intersects(frustum, BoundingSphere{ .center = glm::vec3{ 0.0f, 0.0f, 10.0f }, .radius = 5.0f }));
+        REQUIRE(intersects(frustum, zth::math::infinite_bounding_sphere));
+    }
+
+    SECTION("boxes")
+    {
+        auto box = [](glm::vec3 min, glm::vec3 max) { return Aabb{ .min = min, .max = max }; };
+
+        REQUIRE(intersects(frustum, box(glm::vec3{ -1.0f, -1.0f, -51.0f }, glm::vec3{ 1.0f, 1.0f, -49.0f })));
+        // Center is outside, but the box crosses the right plane.
+        REQUIRE(intersects(frustum, box(glm::vec3{ 9.0f, -1.0f, -11.0f }, glm::vec3{ 12.0f, 1.0f, -9.0f })));
+        REQUIRE(!intersects(frustum, box(glm::vec3{ 15.0f, -1.0f, -11.0f }, glm::vec3{ 17.0f, 1.0f, -9.0f })));
+        REQUIRE(!intersects(frustum, box(glm::vec3{ -1.0f, -1.0f, 1.0f }, glm::vec3{ 1.0f, 1.0f, 3.0f })));
+    }
+}
+
+TEST_CASE("Culling bounding spheres gives the same results as testing them one by one", "[Frustum]")
+{
+    auto frustum = make_perspective_frustum();
+
+    std::mt19937 generator{ 2025 };
+    std::uniform_real_distribution<float> position_distribution{ -120.0f, 120.0f };
+    std::uniform_real_distribution<float> radius_distribution{ 0.0f, 10.0f };
+
+    // Counts which aren't multiples of the SIMD width exercise the scalar tail.
+    for (auto count : { usize{ 0 }, usize{ 3 }, usize{ 4 }, usize{ 7 }, usize{ 1000 }, usize{ 1001 } })
+    {
+        std::vector<zth::math::BoundingSphere> spheres;
+
+        for (usize i = 0; i < count; i++)
+        {
+            spheres.push_back(zth::math::BoundingSphere{
+                .center = glm::vec3{ position_distribution(generator), position_distribution(generator),
+                                     position_distribution(generator) },
+                .radius = radius_distribution(generator),
+            });
+        }
+
+        std::vector<u32> expected;
+
+        for (usize i = 0; i < spheres.size(); i++)
+        {
+            if (zth::math::intersects(frustum, spheres[i]))
+                expected.push_back(static_cast<u32>(i));
+        }
+
+        std::vector<u32> visible_indices(spheres.size());
+        auto visible_count = zth::math::cull_bounding_spheres(frustum, spheres, visible_indices);
+        visible_indices.resize(visible_count);
+
+        REQUIRE(visible_indices == expected);
+    }
+}
@@ -0,0 +1,143 @@
+#include <glm/gtc/matrix_inverse.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <span>
+#include <vector>
+
+#include <zenith/core/typedefs.hpp>
+#include <zenith/log/format.hpp>
+#include <zenith/math/matrix.hpp>
+
+using zth::usize;
+
+namespace {
+
+struct TrsTransforms
+{
+    std::vector<glm::quat> rotations;
+    std::vector<glm::vec3> scales;
+    std::vector<glm::mat4> transforms;
+};
+
+auto generate_transforms(usize count, std::mt19937& generator) -> TrsTransforms
+{
+    std::uniform_real_distribution<float> component_distribution{ -1.0f, 1.0f };
+    std::uniform_real_distribution<float> scale_distribution{ 0.2f, 5.0f };
+    std::uniform_real_distribution<float> translation_distribution{ -100.0f, 100.0f };
+
+    TrsTransforms result;
+
+    for (usize i = 0; i < count; i++)
+    {
+        auto rotation = glm::normalize(glm::quat{ component_distribution(generator), component_distribution(generator),
+                                                  component_distribution(generator),
+                                                  component_distribution(generator) });
+        glm::vec3 scale{ scale_distribution(generator), scale_distribution(generator), scale_distribution(generator) };
+        glm::vec3 translation{ translation_distribution(generator), translation_distribution(generator),
+                               translation_distribution(generator) };
+
+        result.rotations.push_back(rotation);
+        result.scales.push_back(scale);
+        result.transforms.push_back(zth::math::compose_transform(scale, rotation, translation));
+    }
+
+    return result;
+}
+
+// Normal matrices only have to be correct up to a positive factor, as the shaders normalize the normals anyway. The
+// matrices computed here are exact though, so we compare them element by element.
+auto require_close(const glm::mat3& actual, const glm::mat3& expected) -> void
+{
+    for (glm::length_t column = 0; column < 3; column++)
+    {
+        for (glm::length_t row = 0; row < 3; row++)
+        {
+            auto tolerance = 1e-4f * std::max(1.0f, std::abs(expected[column][row]));
+            REQUIRE(std::abs(actual[column][row] - expected[column][row]) <= tolerance);
+        }
+    }
+}
+
+} // namespace
+
+TEST_CASE("Batched normal matrices match the inverse transpose", "[NormalMatrix]")
+{
+    std::mt19937 generator{ 2025 };
+    std::uniform_real_distribution<float> shear_distribution{ -0.5f, 0.5f };
+
+    // Counts which aren't multiples of the SIMD width exercise the scalar tail.
+    for (auto count : { usize{ 0 }, usize{ 1 }, usize{ 3 }, usize{ 4 }, usize{ 9 }, usize{ 17 }, usize{ 1'000 } })
+    {
+        auto transforms = generate_transforms(count, generator).transforms;
+
+        // Every other transform gets sheared, so it can't be expressed with a rotation and a scale.
+        for (usize i = 0; i < count; i += 2)
+        {
+            glm::mat4 shear{ 1.0f };
+            shear[1][0] = shear_distribution(generator);
+            shear[2][1] = shear_distribution(generator);
+            transforms[i] *= shear;
+        }
+
+        // One more matrix than needed, which must not get overwritten.
+        std::vector<glm::mat3> normal_matrices(count + 1, glm::mat3{ 7.0f });
+        zth::math::compute_normal_matrices(transforms, std::span{ normal_matrices }.first(count));
+
+        for (usize i = 0; i < count; i++)
+            require_close(normal_matrices[i], glm::inverseTranspose(glm::mat3{ transforms[i] }));
+
+        REQUIRE(normal_matrices[count] == glm::mat3{ 7.0f });
+    }
+}
+
+TEST_CASE("Normal matrices computed from the rotation and the scale match the batched ones", "[NormalMatrix]")
+{
+    std::mt19937 generator{ 2025 };
+    auto [rotations, scales, transforms] = generate_transforms(100, generator);
+
+    std::vector<glm::mat3> from_matrices(transforms.size());
+    std::vector<glm::mat3> from_components(transforms.size());
+
+    zth::math::compute_normal_matrices(transforms, from_matrices);
+    zth::math::compute_normal_matrices(rotations, scales, from_components);
+
+    for (usize i = 0; i < transforms.size(); i++)
+    {
+        require_close(from_components[i], from_matrices[i]);
+        require_close(zth::math::get_normal_matrix(rotations[i], scales[i]), from_matrices[i]);
+    }
+}
+
+TEST_CASE("Normal matrix benchmark", "[.][benchmark][NormalMatrix]")
+{
+    std::mt19937 generator{ 2025 };
+
+    for (auto count : { usize{ 1'000 }, usize{ 100'000 } })
+    {
+        auto generated = generate_transforms(count, generator);
+        std::vector<glm::mat3> normal_matrices(count);
+
+        BENCHMARK(zth::format("get_normal_matrix per instance ({} transforms)", count))
+        {
+            for (usize i = 0; i < count; i++)
+                normal_matrices[i] = zth::math::get_normal_matrix(generated.transforms[i]);
+
+            return normal_matrices.back();
+        };
+
+        BENCHMARK(zth::format("batched from matrices ({} transforms)", count))
+        {
+            zth::math::compute_normal_matrices(generated.transforms, normal_matrices);
+            return normal_matrices.back();
+        };
+
+        BENCHMARK(zth::format("batched from rotations and scales ({} transforms)", count))
+        {
+            zth::math::compute_normal_matrices(generated.rotations, generated.scales, normal_matrices);
+            return normal_matrices.back();
+        };
+    }
+}
@@ -0,0 +1,205 @@
+#include <glm/geometric.hpp>
+
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <random>
+
+#include <zenith/core/typedefs.hpp>
+#include <zenith/math/quantization.hpp>
+
+using zth::u16;
+using zth::u32;
+
+namespace {
+
+auto random_unit_vector(std::mt19937& generator) -> glm::vec3
+{
+    std::normal_distribution<float> distribution;
+
+    while (true)
+    {
+        glm::vec3 vector{ distribution(generator), distribution(generator), distribution(generator) };
+        auto length = glm::length(vector);
+
+        if (length > 1e-3f)
+            return vector / length;
+    }
+}
+
+} // namespace
+
+TEST_CASE("Half float conversion", "[Quantization]")
+{
+    using zth::math::float_to_half;
+    using zth::math::half_to_float;
+
+    SECTION("Exactly representable values")
+    {
+        REQUIRE(float_to_half(0.0f) == 0x0000);
+        REQUIRE(float_to_half(-0.0f) == 0x8000);
+        REQUIRE(float_to_half(1.0f) == 0x3c00);
+        REQUIRE(float_to_half(-2.0f) == 0xc000);
+        REQUIRE(float_to_half(0.5f) == 0x3800);
+        REQUIRE(float_to_half(65504.0f) == 0x7bff);         // The largest half float.
+        REQUIRE(float_to_half(std::ldexp(1.0f, -14)) == 0x0400); // The smallest normal half float.
+        REQUIRE(float_to_half(std::ldexp(1.0f, -24)) == 0x0001); // The smallest subnormal half float.
+
+        REQUIRE(half_to_float(0x3c00) == 1.0f);
+        REQUIRE(half_to_float(0xc000) == -2.0f);
+        REQUIRE(half_to_float(0x7bff) == 65504.0f);
+        REQUIRE(half_to_float(0x0001) == std::ldexp(1.0f, -24));
+    }
+
+    SECTION("Special values")
+    {
+        constexpr auto infinity = std::numeric_limits<float>::infinity();
+
+        REQUIRE(float_to_half(infinity) == 0x7c00);
+        REQUIRE(float_to_half(-infinity) == 0xfc00);
+        REQUIRE(float_to_half(70000.0f) == 0x7c00);
+        REQUIRE(float_to_half(std::ldexp(1.0f, -26)) == 0x0000);
+        REQUIRE(std::isnan(half_to_float(float_to_half(std::numeric_limits<float>::quiet_NaN()))));
+        REQUIRE(half_to_float(0x7c00) == infinity);
+    }
+
+    SECTION("Rounding to nearest even")
+    {
+        // The half floats next to 1 are 1 - 2^-11 and 1 + 2^-10.
+        REQUIRE(float_to_half(1.0f + std::ldexp(1.0f, -11)) == 0x3c00);
+        REQUIRE(float_to_half(1.0f + std::ldexp(1.0f, -11) + std::ldexp(1.0f, -20)) == 0x3c01);
+        REQUIRE(float_to_half(1.0f + 3.0f * std::ldexp(1.0f, -11)) == 0x3c02);
+    }
+
+    SECTION("Every half float survives a round trip")
+    {
+        for (u32 bits = 0; bits <= 0xffff; bits++)
+        {
+            auto half = static_cast<u16>(bits);
+            auto value = half_to_float(half);
+
+            if (!std::isnan(value))
+                REQUIRE(float_to_half(value) == half);
+        }
+    }
+
+    SECTION("The error stays within the bounds")
+    {
+        std::mt19937 generator{ 2025 };
+        std::uniform_real_distribution<float> exponent_distribution{ -14.0f, 15.9f };
+
+        for (auto i = 0; i < 10'000; i++)
+        {
+            auto value = std::exp2(exponent_distribution(generator));
+            auto error = std::abs(half_to_float(float_to_half(value)) - value);
+            REQUIRE(error <= value * zth::math::half_max_relative_error);
+        }
+    }
+}
+
+TEST_CASE("Normalized integer quantization", "[Quantization]")
+{
+    using namespace zth::math;
+
+    SECTION("Range ends are exact and values outside of the range get clamped")
+    {
+        REQUIRE(quantize_snorm16(1.0f) == 32767);
+        REQUIRE(quantize_snorm16(-1.0f) == -32767);
+        REQUIRE(quantize_snorm16(0.0f) == 0);
+        REQUIRE(quantize_snorm16(2.0f) == 32767);
+        REQUIRE(dequantize_snorm16(-32768) == -1.0f);
+
+        REQUIRE(quantize_unorm16(0.0f) == 0);
+        REQUIRE(quantize_unorm16(1.0f) == 65535);
+        REQUIRE(quantize_unorm16(-1.0f) == 0);
+        REQUIRE(dequantize_unorm16(65535) == 1.0f);
+    }
+
+    SECTION("The error stays within the bounds")
+    {
+        std::mt19937 generator{ 2025 };
+        std::uniform_real_distribution<float> signed_distribution{ -1.0f, 1.0f };
+        std::uniform_real_distribution<float> unsigned_distribution{ 0.0f, 1.0f };
+
+        // Allows for the rounding error of the float math itself.
+        constexpr auto float_error = 1e-7f;
+
+        for (auto i = 0; i < 10'000; i++)
+        {
+            auto value = signed_distribution(generator);
+            REQUIRE(std::abs(dequantize_snorm16(quantize_snorm16(value)) - value) <= snorm16_max_error + float_error);
+
+            value = unsigned_distribution(generator);
+            REQUIRE(std::abs(dequantize_unorm16(quantize_unorm16(value)) - value) <= unorm16_max_error + float_error);
+
+            glm::vec4 vector{ signed_distribution(generator), signed_distribution(generator),
+                              signed_distribution(generator), signed_distribution(generator) };
+
+            auto packed = unpack(pack_snorm16(vector));
+            REQUIRE(glm::length(packed - vector) <= 2.0f * (snorm16_max_error + float_error));
+        }
+    }
+}
+
+TEST_CASE("10-10-10-2 packing", "[Quantization]")
+{
+    using namespace zth::math;
+
+    SECTION("Bit layout")
+    {
+        // x = 511, y = -511 (two's complement), z = 0, w = -1 (two's complement).
+        auto packed = pack_snorm1010102(glm::vec4{ 1.0f, -1.0f, 0.0f, -1.0f });
+        REQUIRE(packed.bits == (0x1ffu | 0x201u << 10 | 0x3u << 30));
+        REQUIRE(unpack(packed) == glm::vec4{ 1.0f, -1.0f, 0.0f, -1.0f });
+    }
+
+    SECTION("The error stays within the bounds")
+    {
+        std::mt19937 generator{ 2025 };
+        std::uniform_real_distribution<float> distribution{ -1.0f, 1.0f };
+
+        for (auto i = 0; i < 10'000; i++)
+        {
+            auto w = static_cast<float>(i % 3) - 1.0f;
+            glm::vec4 value{ distribution(generator), distribution(generator), distribution(generator), w };
+            auto unpacked = unpack(pack_snorm1010102(value));
+
+            REQUIRE(std::abs(unpacked.x - value.x) <= snorm10_max_error + 1e-7f);
+            REQUIRE(std::abs(unpacked.y - value.y) <= snorm10_max_error + 1e-7f);
+            REQUIRE(std::abs(unpacked.z - value.z) <= snorm10_max_error + 1e-7f);
+            REQUIRE(unpacked.w == w);
+        }
+    }
+}
+
+TEST_CASE("Octahedral encoding", "[Quantization]")
+{
+    using namespace zth::math;
+
+    std::mt19937 generator{ 2025 };
+
+    SECTION("Axes")
+    {
+        for (auto axis : { glm::vec3{ 1.0f, 0.0f, 0.0f }, glm::vec3{ -1.0f, 0.0f, 0.0f }, glm::vec3{ 0.0f, 1.0f, 0.0f },
+                           glm::vec3{ 0.0f, -1.0f, 0.0f }, glm::vec3{ 0.0f, 0.0f, 1.0f },
+                           glm::vec3{ 0.0f, 0.0f, -1.0f } })
+        {
+            REQUIRE(glm::distance(decode_octahedral(encode_octahedral(axis)), axis) < 1e-6f);
+            REQUIRE(glm::distance(unpack_octahedral(pack_octahedral(axis)), axis) <= octahedral_snorm16_max_error);
+        }
+    }
+
+    SECTION("The error stays within the bounds")
+    {
+        for (auto i = 0; i < 100'000; i++)
+        {
+            auto vector = random_unit_vector(generator);
+            auto encoded = encode_octahedral(vector);
+
+            REQUIRE(std::abs(encoded.x) <= 1.0f);
+            REQUIRE(std::abs(encoded.y) <= 1.0f);
+            REQUIRE(glm::distance(decode_octahedral(encoded), vector) < 1e-5f);
+            REQUIRE(glm::distance(unpack_octahedral(pack_octahedral(vector)), vector) <= octahedral_snorm16_max_error);
+        }
+    }
+}
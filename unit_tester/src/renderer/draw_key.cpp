@@ -0,0 +1,214 @@
+#include <algorithm>
+#include <array>
+#include <random>
+#include <vector>
+
+#include <zenith/core/typedefs.hpp>
+#include <zenith/log/format.hpp>
+#include <zenith/renderer/draw_key.hpp>
+
+using zth::u16;
+using zth::u32;
+using zth::usize;
+
+namespace {
+
+struct TestScene
+{
+    static constexpr usize shader_count = 4;
+    static constexpr usize material_count = 64;
+    static constexpr usize vertex_array_count = 32;
+
+    // Stand-ins for the objects referenced by draw commands. Only their addresses matter.
+    std::array<int, shader_count> shaders{};
+    std::array<int, material_count> materials{};
+    std::array<int, vertex_array_count> vertex_arrays{};
+};
+
+// The draw command as it looked before draw keys were introduced, sorted by comparing pointers.
+struct PointerDrawCommand
+{
+    const void* vertex_array;
+    const void* material;
+    const void* transform;
+
+    auto operator<(const PointerDrawCommand& other) const -> bool
+    {
+        if (vertex_array != other.vertex_array)
+            return vertex_array < other.vertex_array;
+
+        return material < other.material;
+    }
+};
+
+struct GeneratedCommands
+{
+    std::vector<PointerDrawCommand> pointer_commands;
+    std::vector<zth::DrawKeyEntry> keys;
+};
+
+auto generate_commands(const TestScene& scene, usize count) -> GeneratedCommands
+{
+    std::mt19937 generator{ 2025 };
+    std::uniform_int_distribution<usize> material_distribution{ 0, TestScene::material_count - 1 };
+    std::uniform_int_distribution<usize> vertex_array_distribution{ 0, TestScene::vertex_array_count - 1 };
+    std::uniform_real_distribution<float> depth_distribution{ 0.1f, 100.0f };
+
+    zth::DrawKeyIdMap<int> shader_ids;
+    zth::DrawKeyIdMap<int> material_ids;
+    zth::DrawKeyIdMap<int> vertex_array_ids;
+
+    GeneratedCommands result;
+    result.pointer_commands.reserve(count);
+    result.keys.reserve(count);
+
+    for (usize i = 0; i < count; i++)
+    {
+        auto material_idx = material_distribution(generator);
+        const auto* shader = &scene.shaders[material_idx % TestScene::shader_count];
+        const auto* material = &scene.materials[material_idx];
+        const auto* vertex_array = &scene.vertex_arrays[vertex_array_distribution(generator)];
+
+        auto key = zth::make_draw_key(zth::RenderPass::Opaque, shader_ids.get(shader), material_ids.get(material),
+                                      vertex_array_ids.get(vertex_array),
+                                      zth::quantize_draw_key_depth(depth_distribution(generator), 0.1f, 100.0f));
+
+        result.pointer_commands.emplace_back(vertex_array, material, nullptr);
+        result.keys.emplace_back(key, static_cast<u32>(i));
+    }
+
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("Draw keys order fields from the most to the least significant", "[DrawKey]")
+{
+    using zth::make_draw_key;
+    using zth::RenderPass;
+
+    constexpr u32 max_id = 0xffff;
+    constexpr u16 max_depth = 0xffff;
+    // The largest depth which still falls into the first depth bucket.
+    constexpr u16 max_fine_depth = (1u << zth::draw_key_fine_depth_bits) - 1;
+
+    REQUIRE(make_draw_key(RenderPass::Opaque, 0, 0, 0, 0) == 0);
+    REQUIRE(make_draw_key(RenderPass::Opaque, 1, 0, 0, 0)
+            > make_draw_key(RenderPass::Opaque, 0, max_id, max_id, max_fine_depth));
+    REQUIRE(make_draw_key(RenderPass::Opaque, 0, 1, 0, 0)
+            > make_draw_key(RenderPass::Opaque, 0, 0, max_id, max_fine_depth));
+    REQUIRE(make_draw_key(RenderPass::Opaque, 0, 0, 1, 0)
+            > make_draw_key(RenderPass::Opaque, 0, 0, 0, max_fine_depth));
+    REQUIRE(make_draw_key(RenderPass::Deferred, 0, 0, 0, 0)
+            > make_draw_key(RenderPass::Opaque, max_id, max_id, max_id, max_depth));
+    REQUIRE(make_draw_key(RenderPass::Transparent, 0, 0, 0, max_depth)
+            > make_draw_key(RenderPass::Deferred, max_id, max_id, max_id, max_depth));
+
+    SECTION("opaque draw commands are ordered roughly front to back")
+    {
+        REQUIRE(make_draw_key(RenderPass::Opaque, 0, 0, 0, max_fine_depth + 1)
+                > make_draw_key(RenderPass::Opaque, max_id, max_id, max_id, max_fine_depth));
+        REQUIRE(make_draw_key(RenderPass::Deferred, 0, 0, 0, max_fine_depth + 1)
+                > make_draw_key(RenderPass::Deferred, max_id, max_id, max_id, max_fine_depth));
+
+        // Within a depth bucket the state comes first.
+        REQUIRE(make_draw_key(RenderPass::Opaque, 1, 0, 0, 0)
+                > make_draw_key(RenderPass::Opaque, 0, 0, 0, max_fine_depth));
+    }
+
+    SECTION("transparent draw commands are ordered back to front")
+    {
+        REQUIRE(make_draw_key(RenderPass::Transparent, max_id, max_id, max_id, max_depth)
+                < make_draw_key(RenderPass::Transparent, 0, 0, 0, max_depth - 1));
+        REQUIRE(make_draw_key(RenderPass::Transparent, 0, 0, 0, 1)
+                < make_draw_key(RenderPass::Transparent, 0, 0, 0, 0));
+
+        // At the same depth the state comes first.
+        REQUIRE(make_draw_key(RenderPass::Transparent, 1, 0, 0, 0)
+                > make_draw_key(RenderPass::Transparent, 0, max_id, max_id, 0));
+    }
+
+    SECTION("the pass can be read back from the key")
+    {
+        for (auto pass : { RenderPass::Opaque, RenderPass::Deferred, RenderPass::Transparent })
+        {
+            REQUIRE(zth::draw_key_pass(make_draw_key(pass, max_id, max_id, max_id, max_depth)) == pass);
+            REQUIRE(zth::draw_key_pass(make_draw_key(pass, 0, 0, 0, 0)) == pass);
+        }
+    }
+
+    SECTION("ids which don't fit into their fields don't spill into other fields")
+    {
+        REQUIRE(make_draw_key(RenderPass::Opaque, 1u << zth::draw_key_shader_bits, 0, 0, 0) == 0);
+        REQUIRE(make_draw_key(RenderPass::Opaque, 0, 1u << zth::draw_key_material_bits, 0, 0) == 0);
+        REQUIRE(make_draw_key(RenderPass::Opaque, 0, 0, 1u << zth::draw_key_vertex_array_bits, 0) == 0);
+        REQUIRE(make_draw_key(RenderPass::Transparent, 1u << zth::draw_key_shader_bits, 0, 0, max_depth)
+                == make_draw_key(RenderPass::Transparent, 0, 0, 0, max_depth));
+    }
+
+    SECTION("depth gets quantized over the whole range of the depth field")
+    {
+        REQUIRE(zth::quantize_draw_key_depth(0.1f, 0.1f, 100.0f) == 0);
+        REQUIRE(zth::quantize_draw_key_depth(100.0f, 0.1f, 100.0f) == 0xffff);
+        REQUIRE(zth::quantize_draw_key_depth(-5.0f, 0.1f, 100.0f) == 0);
+        REQUIRE(zth::quantize_draw_key_depth(500.0f, 0.1f, 100.0f) == 0xffff);
+        REQUIRE(zth::quantize_draw_key_depth(10.0f, 0.1f, 100.0f) < zth::quantize_draw_key_depth(20.0f, 0.1f, 100.0f));
+    }
+
+    SECTION("depth buckets grow with the distance")
+    {
+        // Every bucket covers the same ratio of distances.
+        auto bucket = [](float view_depth) {
+            return zth::quantize_draw_key_depth(view_depth, 0.1f, 100.0f) >> zth::draw_key_fine_depth_bits;
+        };
+
+        REQUIRE(bucket(0.11f) == 0);
+        REQUIRE(bucket(1.0f) == 5);
+        REQUIRE(bucket(10.0f) == 10);
+        REQUIRE(bucket(99.0f) == 15);
+    }
+}
+
+TEST_CASE("Radix sort sorts draw keys", "[DrawKey]")
+{
+    TestScene scene;
+
+    for (auto count : { usize{ 0 }, usize{ 1 }, usize{ 2 }, usize{ 1000 }, usize{ 50000 } })
+    {
+        auto keys = generate_commands(scene, count).keys;
+        auto expected = keys;
+        std::ranges::stable_sort(expected, {}, &zth::DrawKeyEntry::key);
+
+        std::vector<zth::DrawKeyEntry> scratch(keys.size());
+        zth::radix_sort_draw_keys(keys, scratch);
+
+        REQUIRE(std::ranges::equal(keys, expected, [](const auto& lhs, const auto& rhs) {
+            return lhs.key == rhs.key && lhs.index == rhs.index;
+        }));
+    }
+}
+
+TEST_CASE("Draw command sorting benchmark", "[.][benchmark][DrawKey]")
+{
+    TestScene scene;
+
+    for (auto count : { usize{ 10'000 }, usize{ 100'000 }, usize{ 1'000'000 } })
+    {
+        auto [pointer_commands, keys] = generate_commands(scene, count);
+        std::vector<zth::DrawKeyEntry> scratch(keys.size());
+
+        BENCHMARK_ADVANCED(zth::format("std::ranges::sort on pointers ({} commands)", count))
+        (Catch::Benchmark::Chronometer meter)
+        {
+            std::vector inputs(static_cast<usize>(meter.runs()), pointer_commands);
+            meter.measure([&](int run) { std::ranges::sort(inputs[static_cast<usize>(run)]); });
+        };
+
+        BENCHMARK_ADVANCED(zth::format("radix sort on draw keys ({} commands)", count))
+        (Catch::Benchmark::Chronometer meter)
+        {
+            std::vector inputs(static_cast<usize>(meter.runs()), keys);
+            meter.measure([&](int run) { zth::radix_sort_draw_keys(inputs[static_cast<usize>(run)], scratch); });
+        };
+    }
+}
@@ -0,0 +1,377 @@
+#include <glm/gtc/quaternion.hpp>
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include <zenith/core/typedefs.hpp>
+#include <zenith/ecs/components.hpp>
+#include <zenith/renderer/draw_key.hpp>
+#include <zenith/renderer/draw_list.hpp>
+#include <zenith/renderer/material.hpp>
+#include <zenith/renderer/renderer.hpp>
+#include <zenith/stl/vector.hpp>
+
+using zth::u32;
+using zth::u8;
+using zth::usize;
+
+namespace {
+
+constexpr float near = 0.1f;
+constexpr float far = 100.0f;
+
+struct TestScene
+{
+    static constexpr usize material_count = 16;
+    static constexpr usize vertex_array_count = 8;
+
+    // Stand-ins for the vertex arrays referenced by draw commands. Only their addresses matter, they never get
+    // dereferenced.
+    std::array<int, vertex_array_count> vertex_arrays{};
+    // Every two consecutive materials are treated as if they had the same bindings.
+    std::vector<zth::Material> materials;
+
+    explicit TestScene()
+    {
+        for (usize i = 0; i < material_count; i++)
+            materials.push_back(zth::Material{ .shader = nullptr, .albedo = glm::vec3{ static_cast<float>(i) } });
+    }
+
+    [[nodiscard]] auto vertex_array(usize index) const -> const zth::gl::VertexArray&
+    {
+        return *reinterpret_cast<const zth::gl::VertexArray*>(&vertex_arrays[index]);
+    }
+
+    [[nodiscard]] auto material_index(const zth::Material* material) const -> u32
+    {
+        return static_cast<u32>(material - materials.data());
+    }
+};
+
+enum class SubmissionKind : u8
+{
+    Matrix,
+    Transform,
+    Instances,
+};
+
+struct Submission
+{
+    SubmissionKind kind;
+    usize vertex_array;
+    usize material;
+    std::vector<zth::TransformComponent> components;
+    std::vector<glm::mat4> transforms;
+};
+
+auto generate_submissions(usize count) -> std::vector<Submission>
+{
+    std::mt19937 generator{ 2025 };
+    std::uniform_int_distribution<int> kind_distribution{ 0, 2 };
+    std::uniform_int_distribution<usize> vertex_array_distribution{ 0, TestScene::vertex_array_count - 1 };
+    std::uniform_int_distribution<usize> material_distribution{ 0, TestScene::material_count - 1 };
+    std::uniform_int_distribution<usize> instance_count_distribution{ 1, 5 };
+    std::uniform_real_distribution<float> position_distribution{ -50.0f, 50.0f };
+    std::uniform_real_distribution<float> depth_distribution{ -90.0f, -1.0f };
+    std::uniform_real_distribution<float> scale_distribution{ 0.5f, 3.0f };
+
+    auto random_transform = [&] {
+        auto rotation = glm::angleAxis(position_distribution(generator), glm::vec3{ 0.0f, 1.0f, 0.0f });
+        auto x = position_distribution(generator);
+        auto y = position_distribution(generator);
+        auto z = depth_distribution(generator);
+
+        return zth::TransformComponent{ glm::vec3{ x, y, z }, rotation, scale_distribution(generator) };
+    };
+
+    std::vector<Submission> result;
+
+    for (usize i = 0; i < count; i++)
+    {
+        Submission submission{
+            .kind = static_cast<SubmissionKind>(kind_distribution(generator)),
+            .vertex_array = vertex_array_distribution(generator),
+            .material = material_distribution(generator),
+            .components = {},
+            .transforms = {},
+        };
+
+        auto instance_count =
+            submission.kind == SubmissionKind::Instances ? instance_count_distribution(generator) : usize{ 1 };
+
+        for (usize instance = 0; instance < instance_count; instance++)
+        {
+            submission.components.push_back(random_transform());
+            submission.transforms.push_back(submission.components.back().transform());
+        }
+
+        result.push_back(std::move(submission));
+    }
+
+    return result;
+}
+
+auto record(zth::DrawList& draw_list, const TestScene& scene, std::span<const Submission> submissions) -> void
+{
+    for (const auto& submission : submissions)
+    {
+        const auto& vertex_array = scene.vertex_array(submission.vertex_array);
+        const auto& material = scene.materials[submission.material];
+
+        switch (submission.kind)
+        {
+            using enum SubmissionKind;
+        case Matrix:
+            draw_list.submit(vertex_array, submission.transforms.front(), material);
+            break;
+        case Transform:
+            draw_list.submit(vertex_array, submission.components.front(), material);
+            break;
+        case Instances:
+            draw_list.submit_instances(vertex_array, material, submission.transforms);
+            break;
+        }
+    }
+}
+
+struct MergedDrawLists
+{
+    zth::Vector<zth::DrawListEntry> entries;
+    zth::Vector<glm::mat4> transforms;
+    zth::Vector<glm::quat> rotations;
+    zth::Vector<glm::vec3> scales;
+};
+
+auto merge(std::span<const zth::DrawList> draw_lists) -> MergedDrawLists
+{
+    std::vector<const zth::DrawList*> pointers;
+
+    for (const auto& draw_list : draw_lists)
+        pointers.push_back(&draw_list);
+
+    MergedDrawLists result;
+    zth::DrawList::merge(pointers, result.entries, result.transforms, result.rotations, result.scales);
+    return result;
+}
+
+struct Batches
+{
+    zth::Vector<zth::DrawKeyEntry> draw_keys;
+    zth::Vector<zth::RenderBatch> batches;
+    zth::BatchingStats stats;
+};
+
+// Does what the renderer does with the merged draw lists.
+auto batch(const TestScene& scene, const MergedDrawLists& merged) -> Batches
+{
+    zth::DrawKeyIdMap<zth::Material> material_ids;
+    zth::DrawKeyIdMap<zth::gl::VertexArray> vertex_array_ids;
+
+    std::vector<zth::DrawCommand> draw_commands;
+    Batches result;
+
+    for (const auto& entry : merged.entries)
+    {
+        auto view_depth = -merged.transforms[entry.first_transform][3].z;
+        auto material_index = material_ids.get(entry.material);
+        auto material_bindings_id = scene.material_index(entry.material) / 2;
+
+        auto key = zth::make_draw_key(zth::RenderPass::Opaque, 0, material_bindings_id,
+                                      vertex_array_ids.get(entry.vertex_array),
+                                      zth::quantize_draw_key_depth(view_depth, near, far));
+
+        result.draw_keys.emplace_back(key, static_cast<u32>(draw_commands.size()));
+        draw_commands.push_back(zth::DrawCommand{
+            .pass = zth::RenderPass::Opaque,
+            .vertex_array = entry.vertex_array,
+            .material = entry.material,
+            .material_index = material_index,
+            .material_bindings_id = material_bindings_id,
+            .first_transform = entry.first_transform,
+            .transform_count = entry.transform_count,
+        });
+    }
+
+    zth::Vector<zth::DrawKeyEntry> scratch(result.draw_keys.size());
+    zth::radix_sort_draw_keys(result.draw_keys, scratch);
+
+    zth::Vector<u32> material_last_batch;
+    result.stats = zth::build_render_batches(draw_commands, result.draw_keys, TestScene::material_count,
+                                             material_last_batch, result.batches);
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("Recording draw lists on multiple threads gives the same batches as serial submission", "[DrawList]")
+{
+    const TestScene scene;
+    const auto submissions = generate_submissions(2000);
+
+    std::vector<zth::DrawList> serial_draw_lists(1);
+    record(serial_draw_lists.front(), scene, submissions);
+
+    constexpr usize thread_count = 4;
+    std::vector<zth::DrawList> parallel_draw_lists(thread_count);
+
+    {
+        std::vector<std::jthread> threads;
+        auto submissions_per_thread = (submissions.size() + thread_count - 1) / thread_count;
+
+        for (usize i = 0; i < thread_count; i++)
+        {
+            auto first = std::min(i * submissions_per_thread, submissions.size());
+            auto count = std::min(submissions_per_thread, submissions.size() - first);
+            auto chunk = std::span{ submissions }.subspan(first, count);
+
+            threads.emplace_back([&, chunk, i] { record(parallel_draw_lists[i], scene, chunk); });
+        }
+    }
+
+    auto serial = merge(serial_draw_lists);
+    auto parallel = merge(parallel_draw_lists);
+
+    REQUIRE(serial.entries == parallel.entries);
+    REQUIRE(serial.transforms == parallel.transforms);
+    REQUIRE(serial.rotations.size() == serial.transforms.size());
+    REQUIRE(serial.scales.size() == serial.transforms.size());
+
+    for (const auto& entry : serial.entries)
+    {
+        if (!entry.composed)
+            continue;
+
+        for (auto i = entry.first_transform; i < entry.first_transform + entry.transform_count; i++)
+        {
+            REQUIRE(serial.rotations[i] == parallel.rotations[i]);
+            REQUIRE(serial.scales[i] == parallel.scales[i]);
+        }
+    }
+
+    auto serial_batches = batch(scene, serial);
+    auto parallel_batches = batch(scene, parallel);
+
+    REQUIRE(serial_batches.batches.size() == parallel_batches.batches.size());
+    REQUIRE(serial_batches.stats.batches == parallel_batches.stats.batches);
+    REQUIRE(serial_batches.stats.merged_batches == parallel_batches.stats.merged_batches);
+    REQUIRE(serial_batches.stats.merged_batches > 0);
+
+    for (usize i = 0; i < serial_batches.batches.size(); i++)
+    {
+        const auto& serial_batch = serial_batches.batches[i];
+        const auto& parallel_batch = parallel_batches.batches[i];
+
+        REQUIRE(serial_batch.vertex_array == parallel_batch.vertex_array);
+        REQUIRE(serial_batch.material == parallel_batch.material);
+        REQUIRE(serial_batch.material_bindings_id == parallel_batch.material_bindings_id);
+        REQUIRE(serial_batch.first_draw_key == parallel_batch.first_draw_key);
+        REQUIRE(serial_batch.draw_key_count == parallel_batch.draw_key_count);
+        REQUIRE(serial_batch.instance_count == parallel_batch.instance_count);
+    }
+
+    for (usize i = 0; i < serial_batches.draw_keys.size(); i++)
+    {
+        REQUIRE(serial_batches.draw_keys[i].key == parallel_batches.draw_keys[i].key);
+        REQUIRE(serial_batches.draw_keys[i].index == parallel_batches.draw_keys[i].index);
+    }
+}
+
+TEST_CASE("Draw commands from different passes don't get batched together", "[DrawList]")
+{
+    const TestScene scene;
+
+    // The same vertex array and bindings, but the second material is transparent. The pass occupies the most
+    // significant bits of the keys, so the two commands end up next to each other.
+    std::array draw_commands{
+        zth::DrawCommand{
+            .pass = zth::RenderPass::Opaque,
+            .vertex_array = &scene.vertex_array(0),
+            .material = &scene.materials[0],
+            .material_index = 0,
+            .material_bindings_id = 0,
+            .first_transform = 0,
+            .transform_count = 1,
+        },
+        zth::DrawCommand{
+            .pass = zth::RenderPass::Transparent,
+            .vertex_array = &scene.vertex_array(0),
+            .material = &scene.materials[1],
+            .material_index = 1,
+            .material_bindings_id = 0,
+            .first_transform = 1,
+            .transform_count = 1,
+        },
+    };
+
+    std::array draw_keys{
+        zth::DrawKeyEntry{ zth::make_draw_key(zth::RenderPass::Opaque, 0, 0, 0, 0), 0 },
+        zth::DrawKeyEntry{ zth::make_draw_key(zth::RenderPass::Transparent, 0, 0, 0, 0), 1 },
+    };
+
+    zth::Vector<u32> material_last_batch;
+    zth::Vector<zth::RenderBatch> batches;
+    auto stats = zth::build_render_batches(draw_commands, draw_keys, 2, material_last_batch, batches);
+
+    REQUIRE(stats.batches == 2);
+    REQUIRE(batches.size() == 2);
+    REQUIRE(batches[0].pass == zth::RenderPass::Opaque);
+    REQUIRE(batches[0].instance_count == 1);
+    REQUIRE(batches[1].pass == zth::RenderPass::Transparent);
+    REQUIRE(batches[1].instance_count == 1);
+}
+
+TEST_CASE("Merging draw lists rebases their transforms", "[DrawList]")
+{
+    const TestScene scene;
+    std::array<zth::DrawList, 3> draw_lists;
+
+    std::array transforms{ glm::mat4{ 1.0f }, glm::mat4{ 2.0f }, glm::mat4{ 3.0f } };
+    draw_lists[0].submit_instances(scene.vertex_array(0), scene.materials[0], std::span{ transforms }.first(2));
+    // The second draw list stays empty.
+    draw_lists[2].submit(scene.vertex_array(1), transforms[2], scene.materials[1]);
+    draw_lists[2].submit_instances(scene.vertex_array(1), scene.materials[1], {}); // Doesn't record anything.
+
+    REQUIRE(draw_lists[1].empty());
+    REQUIRE(draw_lists[2].entries().size() == 1);
+
+    auto merged = merge(draw_lists);
+
+    REQUIRE(merged.entries.size() == 2);
+    REQUIRE(merged.entries[0].first_transform == 0);
+    REQUIRE(merged.entries[0].transform_count == 2);
+    REQUIRE(merged.entries[1].first_transform == 2);
+    REQUIRE(merged.entries[1].transform_count == 1);
+    REQUIRE(merged.transforms.size() == 3);
+    REQUIRE(merged.transforms[2] == transforms[2]);
+    REQUIRE(merged.rotations.size() == 3);
+    REQUIRE(merged.scales.size() == 3);
+
+    draw_lists[0].clear();
+    REQUIRE(draw_lists[0].empty());
+    REQUIRE(draw_lists[0].transforms().empty());
+}
+
+TEST_CASE("Draw lists record the rotations and scales of composed transforms", "[DrawList]")
+{
+    const TestScene scene;
+    std::array<zth::DrawList, 1> draw_lists;
+
+    auto rotation = glm::angleAxis(0.75f, glm::normalize(glm::vec3{ 1.0f, 2.0f, 3.0f }));
+    const zth::TransformComponent composed{ glm::vec3{ 1.0f, 2.0f, -3.0f }, rotation, glm::vec3{ 0.5f, 2.0f, 4.0f } };
+
+    draw_lists[0].submit(scene.vertex_array(0), composed.transform(), scene.materials[0]);
+    draw_lists[0].submit(scene.vertex_array(0), composed, scene.materials[0]);
+
+    auto merged = merge(draw_lists);
+
+    REQUIRE(merged.entries.size() == 2);
+    REQUIRE_FALSE(merged.entries[0].composed);
+    REQUIRE(merged.entries[1].composed);
+    REQUIRE(merged.transforms[1] == composed.transform());
+    REQUIRE(merged.rotations[1] == composed.rotation());
+    REQUIRE(merged.scales[1] == composed.scale());
+}
@@ -0,0 +1,235 @@
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <span>
+#include <vector>
+
+#include <zenith/core/typedefs.hpp>
+#include <zenith/math/bounds.hpp>
+#include <zenith/renderer/light.hpp>
+#include <zenith/renderer/light_clusters.hpp>
+
+using zth::u32;
+using zth::usize;
+using zth::math::BoundingSphere;
+
+namespace {
+
+constexpr float near = 0.1f;
+constexpr float far = 100.0f;
+
+auto generate_lights(usize count, std::mt19937& generator) -> std::vector<BoundingSphere>
+{
+    std::uniform_real_distribution<float> xy_distribution{ -60.0f, 60.0f };
+    std::uniform_real_distribution<float> z_distribution{ -120.0f, 5.0f }; // Some lights end up behind the camera.
+    std::uniform_real_distribution<float> radius_distribution{ 0.1f, 15.0f };
+
+    std::vector<BoundingSphere> result;
+
+    for (usize i = 0; i < count; i++)
+    {
+        result.push_back(BoundingSphere{
+            .center = glm::vec3{ xy_distribution(generator), xy_distribution(generator), z_distribution(generator) },
+            .radius = radius_distribution(generator),
+        });
+    }
+
+    return result;
+}
+
+auto contains(const BoundingSphere& sphere, glm::vec3 point) -> bool
+{
+    auto offset = point - sphere.center;
+    return glm::dot(offset, offset) <= sphere.radius * sphere.radius;
+}
+
+auto intersects(const BoundingSphere& sphere, const zth::math::Aabb& aabb) -> bool
+{
+    return contains(sphere, glm::clamp(sphere.center, aabb.min, aabb.max));
+}
+
+} // namespace
+
+TEST_CASE("Light clusters list every light that reaches them", "[LightClusters]")
+{
+    std::mt19937 generator{ 2025 };
+    std::uniform_real_distribution<float> unit_distribution{ 0.0f, 1.0f };
+
+    auto projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, near, far);
+    auto point_lights = generate_lights(300, generator);
+    auto spot_lights = generate_lights(100, generator);
+
+    zth::LightClusterGrid grid;
+    grid.build(projection, near, far, point_lights, spot_lights);
+
+    auto size = grid.size();
+    REQUIRE(grid.clusters().size() == grid.cluster_count());
+
+    for (u32 slice = 0; slice < size.z; slice++)
+    {
+        for (u32 y = 0; y < size.y; y++)
+        {
+            for (u32 x = 0; x < size.x; x++)
+            {
+                const auto& cluster = grid.clusters()[grid.cluster_index(x, y, slice)];
+                const auto& bounds = grid.cluster_bounds()[grid.cluster_index(x, y, slice)];
+
+                auto lights = grid.light_indices().subspan(cluster.first_light_index,
+                                                           cluster.point_light_count + cluster.spot_light_count);
+                auto cluster_point_lights = lights.first(cluster.point_light_count);
+                auto cluster_spot_lights = lights.last(cluster.spot_light_count);
+
+                // No light gets listed unless it touches the cluster.
+                for (auto index : cluster_point_lights)
+                    REQUIRE(intersects(point_lights[index], bounds));
+
+                for (auto index : cluster_spot_lights)
+                    REQUIRE(intersects(spot_lights[index], bounds));
+
+                // Every light which reaches a point within the cluster gets listed.
+                for (int sample = 0; sample < 4; sample++)
+                {
+                    auto ndc_x = -1.0f + 2.0f * (static_cast<float>(x) + unit_distribution(generator)) /
+                                             static_cast<float>(size.x);
+                    auto ndc_y = -1.0f + 2.0f * (static_cast<float>(y) + unit_distribution(generator)) /
+                                             static_cast<float>(size.y);
+                    auto depth = glm::mix(-bounds.max.z, -bounds.min.z, unit_distribution(generator));
+
+                    if (grid.slice_at_depth(depth) != slice)
+                        continue;
+
+                    glm::vec3 point{ (ndc_x + projection[2][0]) * depth / projection[0][0],
+                                     (ndc_y + projection[2][1]) * depth / projection[1][1], -depth };
+
+                    for (u32 i = 0; i < point_lights.size(); i++)
+                    {
+                        if (contains(point_lights[i], point))
+                            REQUIRE(std::ranges::find(cluster_point_lights, i) != cluster_point_lights.end());
+                    }
+
+                    for (u32 i = 0; i < spot_lights.size(); i++)
+                    {
+                        if (contains(spot_lights[i], point))
+                            REQUIRE(std::ranges::find(cluster_spot_lights, i) != cluster_spot_lights.end());
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Light cluster stats", "[LightClusters]")
+{
+    auto projection = glm::perspective(glm::radians(60.0f), 1.0f, near, far);
+    zth::LightClusterGrid grid{ glm::uvec3{ 4, 4, 8 } };
+
+    SECTION("No lights")
+    {
+        grid.build(projection, near, far, {}, {});
+        auto stats = grid.stats();
+
+        REQUIRE(stats.cluster_count == 4 * 4 * 8);
+        REQUIRE(stats.occupied_clusters == 0);
+        REQUIRE(stats.max_lights_per_cluster == 0);
+        REQUIRE(stats.light_index_count == 0);
+    }
+
+    SECTION("Lights outside of the frustum don't occupy any clusters")
+    {
+        std::vector<BoundingSphere> lights{
+            BoundingSphere{ .center = glm::vec3{ 0.0f, 0.0f, 10.0f }, .radius = 1.0f },   // Behind the camera.
+            BoundingSphere{ .center = glm::vec3{ 0.0f, 0.0f, -200.0f }, .radius = 1.0f }, // Beyond the far plane.
+            BoundingSphere{ .center = glm::vec3{ 100.0f, 0.0f, -10.0f }, .radius = 1.0f },
+        };
+
+        grid.build(projection, near, far, lights, {});
+        REQUIRE(grid.stats().occupied_clusters == 0);
+    }
+
+    SECTION("A light which covers the whole frustum occupies every cluster")
+    {
+        std::vector<BoundingSphere> lights{ BoundingSphere{ .center = glm::vec3{ 0.0f }, .radius = 1000.0f } };
+        grid.build(projection, near, far, {}, lights);
+        auto stats = grid.stats();
+
+        REQUIRE(stats.occupied_clusters == stats.cluster_count);
+        REQUIRE(stats.max_lights_per_cluster == 1);
+        REQUIRE(stats.average_lights_per_occupied_cluster == 1.0f);
+        REQUIRE(stats.light_index_count == stats.cluster_count);
+
+        for (const auto& cluster : grid.clusters())
+        {
+            REQUIRE(cluster.point_light_count == 0);
+            REQUIRE(cluster.spot_light_count == 1);
+        }
+    }
+}
+
+TEST_CASE("Light cluster slices grow exponentially from the near plane", "[LightClusters]")
+{
+    auto projection = glm::perspective(glm::radians(45.0f), 1.0f, near, far);
+    zth::LightClusterGrid grid;
+    grid.build(projection, near, far, {}, {});
+
+    auto slice_count = grid.size().z;
+
+    REQUIRE(grid.slice_at_depth(near) == 0);
+    REQUIRE(grid.slice_at_depth(far) == slice_count - 1);
+    REQUIRE(grid.slice_at_depth(0.0f) == 0);
+    REQUIRE(grid.slice_at_depth(far * 2.0f) == slice_count - 1);
+
+    for (u32 slice = 0; slice < slice_count; slice++)
+    {
+        const auto& bounds = grid.cluster_bounds()[grid.cluster_index(0, 0, slice)];
+        REQUIRE(grid.slice_at_depth(-(bounds.min.z + bounds.max.z) * 0.5f) == slice);
+    }
+}
+
+TEST_CASE("Light attenuation range", "[LightClusters]")
+{
+    zth::LightAttenuation attenuation{ .constant = 1.0f, .linear = 0.09f, .quadratic = 0.032f };
+
+    auto range = attenuation.range(0.01f);
+    auto strength_at_range =
+        1.0f / (attenuation.constant + attenuation.linear * range + attenuation.quadratic * range * range);
+    REQUIRE(std::abs(strength_at_range - 0.01f) < 1e-5f);
+
+    REQUIRE(std::isinf(zth::LightAttenuation{ .constant = 1.0f, .linear = 0.0f, .quadratic = 0.0f }.range()));
+    REQUIRE(zth::LightAttenuation{ .constant = 1000.0f, .linear = 1.0f, .quadratic = 1.0f }.range() == 0.0f);
+}
+
+TEST_CASE("Spot light bounds contain the lit region", "[LightClusters]")
+{
+    std::mt19937 generator{ 2025 };
+    std::uniform_real_distribution<float> unit_distribution{ 0.0f, 1.0f };
+
+    glm::vec3 position{ 1.0f, 2.0f, 3.0f };
+    glm::vec3 direction = glm::normalize(glm::vec3{ 1.0f, -1.0f, 0.5f });
+    constexpr float range = 10.0f;
+
+    // Any vector perpendicular to the direction.
+    auto side = glm::normalize(glm::cross(direction, glm::vec3{ 0.0f, 1.0f, 0.0f }));
+
+    for (auto outer_cutoff_degrees : { 5.0f, 30.0f, 45.0f, 60.0f, 89.0f, 120.0f })
+    {
+        auto outer_cutoff_cosine = std::cos(glm::radians(outer_cutoff_degrees));
+        auto bounds = zth::spot_light_bounds(position, direction, range, outer_cutoff_cosine);
+
+        REQUIRE(bounds.radius <= range + 1e-4f);
+
+        for (int sample = 0; sample < 100; sample++)
+        {
+            // A point on the edge of the lit region.
+            auto angle = glm::radians(outer_cutoff_degrees) * unit_distribution(generator);
+            auto distance = range * unit_distribution(generator);
+            auto point = position + (direction * std::cos(angle) + side * std::sin(angle)) * distance;
+
+            auto offset = point - bounds.center;
+            REQUIRE(glm::length(offset) <= bounds.radius * (1.0f + 1e-4f) + 1e-4f);
+        }
+    }
+}
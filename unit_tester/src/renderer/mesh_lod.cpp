@@ -0,0 +1,255 @@
+#include <glm/geometric.hpp>
+#include <glm/trigonometric.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numbers>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include <zenith/core/typedefs.hpp>
+#include <zenith/math/bounds.hpp>
+#include <zenith/renderer/mesh_lod.hpp>
+#include <zenith/renderer/mesh_simplifier.hpp>
+#include <zenith/renderer/vertex.hpp>
+#include <zenith/stl/vector.hpp>
+
+#include "test_meshes.hpp"
+
+using zth::u32;
+using zth::u64;
+using zth::usize;
+
+namespace {
+
+struct TestMesh
+{
+    zth::Vector<zth::StandardVertex> vertices;
+    zth::Vector<u32> indices;
+};
+
+auto vertex(glm::vec3 position) -> zth::StandardVertex
+{
+    return zth::StandardVertex{ .position = position, .normal = glm::vec3{ 0.0f }, .uv = glm::vec2{ 0.0f } };
+}
+
+auto from_positions(const PositionMesh& mesh) -> TestMesh
+{
+    TestMesh result;
+
+    for (auto position : mesh.positions)
+        result.vertices.push_back(vertex(position));
+
+    result.indices = mesh.indices;
+    return result;
+}
+
+// A closed unit sphere without any seams.
+auto generate_sphere(u32 rings, u32 segments) -> TestMesh
+{
+    TestMesh result;
+
+    result.vertices.push_back(vertex(glm::vec3{ 0.0f, 1.0f, 0.0f }));
+
+    for (u32 ring = 1; ring < rings; ring++)
+    {
+        for (u32 segment = 0; segment < segments; segment++)
+        {
+            constexpr auto pi = std::numbers::pi_v<float>;
+            auto polar = pi * static_cast<float>(ring) / static_cast<float>(rings);
+            auto azimuth = 2.0f * pi * static_cast<float>(segment) / static_cast<float>(segments);
+
+            result.vertices.push_back(vertex(glm::vec3{ std::sin(polar) * std::cos(azimuth), std::cos(polar),
+                                                        std::sin(polar) * std::sin(azimuth) }));
+        }
+    }
+
+    result.vertices.push_back(vertex(glm::vec3{ 0.0f, -1.0f, 0.0f }));
+
+    auto north_pole = u32{ 0 };
+    auto south_pole = static_cast<u32>(result.vertices.size() - 1);
+    auto at = [&](u32 ring, u32 segment) { return 1 + (ring - 1) * segments + segment % segments; };
+
+    for (u32 segment = 0; segment < segments; segment++)
+        result.indices.insert(result.indices.end(), { north_pole, at(1, segment + 1), at(1, segment) });
+
+    for (u32 ring = 1; ring + 1 < rings; ring++)
+    {
+        for (u32 segment = 0; segment < segments; segment++)
+        {
+            auto a = at(ring, segment);
+            auto b = at(ring, segment + 1);
+            auto c = at(ring + 1, segment);
+            auto d = at(ring + 1, segment + 1);
+
+            result.indices.insert(result.indices.end(), { a, b, d, a, d, c });
+        }
+    }
+
+    for (u32 segment = 0; segment < segments; segment++)
+        result.indices.insert(result.indices.end(), { south_pole, at(rings - 1, segment), at(rings - 1, segment + 1) });
+
+    return result;
+}
+
+auto triangle_normal(const TestMesh& mesh, std::span<const u32> indices, usize triangle) -> glm::vec3
+{
+    auto a = mesh.vertices[indices[triangle * 3]].position;
+    auto b = mesh.vertices[indices[triangle * 3 + 1]].position;
+    auto c = mesh.vertices[indices[triangle * 3 + 2]].position;
+    return glm::cross(b - a, c - a);
+}
+
+// Every edge of a closed manifold mesh is shared by exactly two triangles.
+auto is_closed_manifold(std::span<const u32> indices) -> bool
+{
+    std::unordered_map<u64, u32> edge_triangle_counts;
+
+    for (usize i = 0; i < indices.size(); i += 3)
+    {
+        for (usize corner = 0; corner < 3; corner++)
+        {
+            auto a = indices[i + corner];
+            auto b = indices[i + (corner + 1) % 3];
+            edge_triangle_counts[u64{ std::min(a, b) } << 32 | std::max(a, b)]++;
+        }
+    }
+
+    for (const auto& [edge, triangle_count] : edge_triangle_counts)
+    {
+        if (triangle_count != 2)
+            return false;
+    }
+
+    return true;
+}
+
+} // namespace
+
+TEST_CASE("Simplifying a flat mesh doesn't introduce any error", "[MeshLod]")
+{
+    auto grid = from_positions(generate_grid(21));
+    auto simplified = zth::simplify_mesh(grid.vertices, grid.indices, 0, 1e-4f);
+
+    REQUIRE(simplified.indices.size() < grid.indices.size() / 4);
+    REQUIRE(simplified.indices.size() % 3 == 0);
+    REQUIRE(simplified.error == 0.0f);
+
+    for (usize triangle = 0; triangle < simplified.indices.size() / 3; triangle++)
+        REQUIRE(triangle_normal(grid, simplified.indices, triangle).z > 0.0f);
+
+    // The border stays where it was.
+    std::vector<bool> used(grid.vertices.size(), false);
+
+    for (auto index : simplified.indices)
+        used[index] = true;
+
+    for (usize i = 0; i < grid.vertices.size(); i++)
+    {
+        auto position = grid.vertices[i].position;
+        auto on_border = position.x == 0.0f || position.y == 0.0f || position.x == 20.0f || position.y == 20.0f;
+
+        if (on_border)
+            REQUIRE(used[i]);
+    }
+}
+
+TEST_CASE("Simplifying a closed mesh keeps it closed and doesn't flip triangles", "[MeshLod]")
+{
+    auto sphere = generate_sphere(40, 80);
+    REQUIRE(is_closed_manifold(sphere.indices));
+
+    auto previous_error = 0.0f;
+
+    for (auto ratio : { 2u, 4u, 10u, 50u })
+    {
+        auto target_index_count = sphere.indices.size() / ratio;
+        auto simplified = zth::simplify_mesh(sphere.vertices, sphere.indices, target_index_count);
+
+        REQUIRE(simplified.indices.size() <= target_index_count);
+        REQUIRE(simplified.indices.size() > 0);
+        REQUIRE(is_closed_manifold(simplified.indices));
+
+        // The sphere is centered at the origin, so every triangle should keep facing away from it.
+        for (usize triangle = 0; triangle < simplified.indices.size() / 3; triangle++)
+        {
+            auto corner = sphere.vertices[simplified.indices[triangle * 3]].position;
+            REQUIRE(glm::dot(triangle_normal(sphere, simplified.indices, triangle), corner) > 0.0f);
+        }
+
+        REQUIRE(simplified.error >= previous_error);
+        REQUIRE(simplified.error < 0.2f);
+        previous_error = simplified.error;
+    }
+}
+
+TEST_CASE("Simplification stops at the max error", "[MeshLod]")
+{
+    auto sphere = generate_sphere(20, 40);
+
+    auto unlimited = zth::simplify_mesh(sphere.vertices, sphere.indices, 0);
+    auto limited = zth::simplify_mesh(sphere.vertices, sphere.indices, 0, 0.01f);
+
+    REQUIRE(limited.error <= 0.01f);
+    REQUIRE(limited.indices.size() > unlimited.indices.size());
+    REQUIRE(limited.indices.size() < sphere.indices.size());
+}
+
+TEST_CASE("LOD level selection", "[MeshLod]")
+{
+    // Only the screen sizes matter for the selection.
+    std::array levels{
+        zth::MeshLodLevel{ .mesh = nullptr, .min_screen_size = 0.5f },
+        zth::MeshLodLevel{ .mesh = nullptr, .min_screen_size = 0.25f },
+        zth::MeshLodLevel{ .mesh = nullptr, .min_screen_size = 0.1f },
+        zth::MeshLodLevel{ .mesh = nullptr, .min_screen_size = 0.0f },
+    };
+
+    SECTION("Without hysteresis")
+    {
+        REQUIRE(zth::select_lod_level(levels, 1.0f, 0, 0.0f) == 0);
+        REQUIRE(zth::select_lod_level(levels, 0.5f, 3, 0.0f) == 0);
+        REQUIRE(zth::select_lod_level(levels, 0.49f, 0, 0.0f) == 1);
+        REQUIRE(zth::select_lod_level(levels, 0.2f, 0, 0.0f) == 2);
+        REQUIRE(zth::select_lod_level(levels, 0.01f, 0, 0.0f) == 3);
+        REQUIRE(zth::select_lod_level(levels, 0.0f, 1, 0.0f) == 3);
+    }
+
+    SECTION("With hysteresis")
+    {
+        // Moving away from the camera.
+        REQUIRE(zth::select_lod_level(levels, 0.49f, 0, 0.1f) == 0);
+        REQUIRE(zth::select_lod_level(levels, 0.46f, 0, 0.1f) == 0);
+        REQUIRE(zth::select_lod_level(levels, 0.44f, 0, 0.1f) == 1);
+
+        // Moving back towards the camera.
+        REQUIRE(zth::select_lod_level(levels, 0.51f, 1, 0.1f) == 1);
+        REQUIRE(zth::select_lod_level(levels, 0.54f, 1, 0.1f) == 1);
+        REQUIRE(zth::select_lod_level(levels, 0.56f, 1, 0.1f) == 0);
+
+        // Big jumps skip over levels.
+        REQUIRE(zth::select_lod_level(levels, 0.01f, 0, 0.1f) == 3);
+        REQUIRE(zth::select_lod_level(levels, 2.0f, 3, 0.1f) == 0);
+    }
+
+    SECTION("A single level")
+    {
+        std::array single_level{ zth::MeshLodLevel{ .mesh = nullptr, .min_screen_size = 0.5f } };
+        REQUIRE(zth::select_lod_level(single_level, 0.01f, 0) == 0);
+        REQUIRE(zth::select_lod_level(single_level, 1.0f, 0) == 0);
+    }
+}
+
+TEST_CASE("LOD screen size", "[MeshLod]")
+{
+    auto fov = glm::radians(90.0f);
+    zth::math::BoundingSphere sphere{ .center = glm::vec3{ 0.0f, 0.0f, -10.0f }, .radius = 1.0f };
+
+    // With a 90 degree field of view, the frustum is 20 units tall at a distance of 10.
+    REQUIRE(std::abs(zth::lod_screen_size(sphere, glm::vec3{ 0.0f }, fov) - 0.1f) < 1e-5f);
+    REQUIRE(std::abs(zth::lod_screen_size(sphere, glm::vec3{ 0.0f, 0.0f, 10.0f }, fov) - 0.05f) < 1e-5f);
+    REQUIRE(std::isinf(zth::lod_screen_size(sphere, glm::vec3{ 0.0f, 0.0f, -10.5f }, fov)));
+    REQUIRE(std::isinf(zth::lod_screen_size(zth::math::infinite_bounding_sphere, glm::vec3{ 0.0f }, fov)));
+}
@@ -0,0 +1,299 @@
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numbers>
+#include <random>
+#include <span>
+#include <vector>
+
+#include <zenith/core/typedefs.hpp>
+#include <zenith/log/format.hpp>
+#include <zenith/renderer/mesh_optimizer.hpp>
+#include <zenith/renderer/vertex.hpp>
+#include <zenith/stl/vector.hpp>
+
+#include "test_meshes.hpp"
+
+using zth::u16;
+using zth::u32;
+using zth::usize;
+
+namespace {
+
+// Appends a sphere centered at the origin with its triangles facing outwards. Doesn't bother closing the poles.
+auto append_sphere(PositionMesh& mesh, float radius, u32 rings, u32 segments) -> void
+{
+    auto first_vertex = static_cast<u32>(mesh.positions.size());
+
+    for (u32 ring = 0; ring <= rings; ring++)
+    {
+        for (u32 segment = 0; segment < segments; segment++)
+        {
+            constexpr auto pi = std::numbers::pi_v<float>;
+            auto polar = pi * static_cast<float>(ring) / static_cast<float>(rings);
+            auto azimuth = 2.0f * pi * static_cast<float>(segment) / static_cast<float>(segments);
+
+            mesh.positions.push_back(glm::vec3{ std::sin(polar) * std::cos(azimuth), std::cos(polar),
+                                                std::sin(polar) * std::sin(azimuth) }
+                                     * radius);
+        }
+    }
+
+    auto at = [&](u32 ring, u32 segment) { return first_vertex + ring * segments + segment % segments; };
+
+    for (u32 ring = 0; ring < rings; ring++)
+    {
+        for (u32 segment = 0; segment < segments; segment++)
+        {
+            auto a = at(ring, segment);
+            auto b = at(ring, segment + 1);
+            auto c = at(ring + 1, segment);
+            auto d = at(ring + 1, segment + 1);
+
+            mesh.indices.insert(mesh.indices.end(), { a, b, d, a, d, c });
+        }
+    }
+}
+
+auto shuffle_triangles(std::span<u32> indices, std::mt19937& generator) -> void
+{
+    std::vector<std::array<u32, 3>> triangles;
+
+    for (usize i = 0; i < indices.size(); i += 3)
+        triangles.push_back({ indices[i], indices[i + 1], indices[i + 2] });
+
+    std::ranges::shuffle(triangles, generator);
+
+    for (usize i = 0; i < triangles.size(); i++)
+        std::ranges::copy(triangles[i], indices.begin() + static_cast<std::ptrdiff_t>(i * 3));
+}
+
+// Returns the triangles rotated so that they start with their lowest index, which keeps their winding, in sorted order.
+auto sorted_triangles(std::span<const u32> indices) -> std::vector<std::array<u32, 3>>
+{
+    std::vector<std::array<u32, 3>> result;
+
+    for (usize i = 0; i < indices.size(); i += 3)
+    {
+        std::array triangle{ indices[i], indices[i + 1], indices[i + 2] };
+        std::ranges::rotate(triangle, std::ranges::min_element(triangle));
+        result.push_back(triangle);
+    }
+
+    std::ranges::sort(result);
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("Vertex cache analysis", "[MeshOptimizer]")
+{
+    SECTION("A single triangle")
+    {
+        std::array<u32, 3> indices{ 0, 1, 2 };
+        auto stats = zth::analyze_vertex_cache(indices, 3);
+
+        REQUIRE(stats.acmr == 3.0f);
+        REQUIRE(stats.atvr == 1.0f);
+    }
+
+    SECTION("Triangles sharing an edge")
+    {
+        std::array<u32, 6> indices{ 0, 1, 2, 2, 1, 3 };
+        auto stats = zth::analyze_vertex_cache(indices, 4);
+
+        REQUIRE(stats.acmr == 2.0f);
+        REQUIRE(stats.atvr == 1.0f);
+    }
+
+    SECTION("Vertices falling out of the cache")
+    {
+        std::array<u32, 9> indices{ 0, 1, 2, 3, 4, 5, 0, 1, 2 };
+
+        REQUIRE(zth::analyze_vertex_cache(indices, 6, 6).acmr == 2.0f);
+        REQUIRE(zth::analyze_vertex_cache(indices, 6, 3).acmr == 3.0f);
+        REQUIRE(zth::analyze_vertex_cache(indices, 6, 3).atvr == 1.5f);
+    }
+}
+
+TEST_CASE("Vertex cache optimization keeps the triangles and lowers the ACMR", "[MeshOptimizer]")
+{
+    std::mt19937 generator{ 2025 };
+
+    auto grid = generate_grid(100);
+    shuffle_triangles(grid.indices, generator);
+
+    auto before = zth::analyze_vertex_cache(grid.indices, grid.positions.size());
+    auto optimized_indices = grid.indices;
+    zth::optimize_vertex_cache(optimized_indices, grid.positions.size());
+    auto after = zth::analyze_vertex_cache(optimized_indices, grid.positions.size());
+
+    REQUIRE(sorted_triangles(optimized_indices) == sorted_triangles(grid.indices));
+    REQUIRE(before.acmr > 2.0f);
+    REQUIRE(after.acmr < 0.8f);
+    REQUIRE(after.atvr < 1.6f);
+}
+
+TEST_CASE("Overdraw optimization draws the outer clusters first", "[MeshOptimizer]")
+{
+    // Two spheres, one inside of the other. The inner sphere comes first, so drawing the mesh as it is shades most of
+    // the pixels twice.
+    PositionMesh mesh;
+    append_sphere(mesh, 0.25f, 16, 32);
+    auto inner_vertex_count = static_cast<u32>(mesh.positions.size());
+    append_sphere(mesh, 1.0f, 16, 32);
+
+    auto indices = mesh.indices;
+    zth::optimize_vertex_cache(indices, mesh.positions.size());
+    auto cache_optimized = zth::analyze_vertex_cache(indices, mesh.positions.size());
+
+    zth::optimize_overdraw(indices, mesh.positions);
+    auto overdraw_optimized = zth::analyze_vertex_cache(indices, mesh.positions.size());
+
+    REQUIRE(sorted_triangles(indices) == sorted_triangles(mesh.indices));
+    REQUIRE(overdraw_optimized.acmr <= cache_optimized.acmr * 1.1f);
+
+    // Every triangle of the outer sphere comes before every triangle of the inner one.
+    auto is_inner = [&](usize triangle) { return indices[triangle * 3] < inner_vertex_count; };
+    auto triangle_count = indices.size() / 3;
+    auto first_inner_triangle = usize{ 0 };
+
+    while (first_inner_triangle < triangle_count && !is_inner(first_inner_triangle))
+        first_inner_triangle++;
+
+    REQUIRE(first_inner_triangle > 0);
+
+    for (auto triangle = first_inner_triangle; triangle < triangle_count; triangle++)
+        REQUIRE(is_inner(triangle));
+}
+
+TEST_CASE("Vertex fetch remapping", "[MeshOptimizer]")
+{
+    std::array<u32, 6> indices{ 8, 2, 4, 4, 2, 6 };
+    auto remap = zth::remap_for_vertex_fetch(indices, 9);
+
+    REQUIRE(indices == std::array<u32, 6>{ 0, 1, 2, 2, 1, 3 });
+    REQUIRE(remap.size() == 9);
+    REQUIRE(remap[8] == 0);
+    REQUIRE(remap[2] == 1);
+    REQUIRE(remap[4] == 2);
+    REQUIRE(remap[6] == 3);
+
+    for (auto unused : { 0, 1, 3, 5, 7 })
+        REQUIRE(remap[static_cast<usize>(unused)] == zth::unused_vertex);
+}
+
+TEST_CASE("Optimizing a mesh", "[MeshOptimizer]")
+{
+    std::mt19937 generator{ 2025 };
+
+    auto grid = generate_grid(50);
+    shuffle_triangles(grid.indices, generator);
+
+    zth::Vector<zth::StandardVertex> vertices;
+
+    auto vertex = [](glm::vec3 position) {
+        return zth::StandardVertex{
+            .position = position, .normal = glm::vec3{ 0.0f, 0.0f, 1.0f }, .uv = glm::vec2{ 0.0f }
+        };
+    };
+
+    for (auto position : grid.positions)
+        vertices.push_back(vertex(position));
+
+    // A vertex which no triangle uses.
+    vertices.push_back(vertex(glm::vec3{ -1.0f }));
+
+    zth::Vector<u16> indices;
+
+    for (auto index : grid.indices)
+        indices.push_back(static_cast<u16>(index));
+
+    auto source_vertices = vertices;
+    auto source_indices = indices;
+    auto stats = zth::optimize_mesh(vertices, indices);
+
+    REQUIRE(stats.after.acmr < stats.before.acmr);
+    REQUIRE(stats.after.acmr < 0.8f);
+    REQUIRE(vertices.size() == source_vertices.size() - 1);
+    REQUIRE(indices.size() == source_indices.size());
+
+    // The vertices are in the order in which they're first used.
+    u32 next_vertex = 0;
+
+    for (auto index : indices)
+    {
+        REQUIRE(index <= next_vertex);
+
+        if (index == next_vertex)
+            next_vertex++;
+    }
+
+    REQUIRE(next_vertex == vertices.size());
+
+    // Every triangle still has the same corners, in the same winding.
+    auto corners = [](const auto& mesh_vertices, const auto& mesh_indices) {
+        std::vector<std::array<float, 9>> result;
+
+        for (usize i = 0; i < mesh_indices.size(); i += 3)
+        {
+            std::array<glm::vec3, 3> triangle{ mesh_vertices[mesh_indices[i]].position,
+                                               mesh_vertices[mesh_indices[i + 1]].position,
+                                               mesh_vertices[mesh_indices[i + 2]].position };
+
+            std::ranges::rotate(triangle, std::ranges::min_element(triangle, {}, [](glm::vec3 position) {
+                                    return std::array{ position.x, position.y, position.z };
+                                }));
+
+            result.push_back({ triangle[0].x, triangle[0].y, triangle[0].z, triangle[1].x, triangle[1].y,
+                               triangle[1].z, triangle[2].x, triangle[2].y, triangle[2].z });
+        }
+
+        std::ranges::sort(result);
+        return result;
+    };
+
+    REQUIRE(corners(vertices, indices) == corners(source_vertices, source_indices));
+}
+
+TEST_CASE("Mesh optimizer benchmark", "[.][benchmark][MeshOptimizer]")
+{
+    std::mt19937 generator{ 2025 };
+
+    for (auto size : { u32{ 256 }, u32{ 1024 } })
+    {
+        auto grid = generate_grid(size);
+        shuffle_triangles(grid.indices, generator);
+
+        auto triangle_count = grid.indices.size() / 3;
+        auto cache_optimized = grid.indices;
+        zth::optimize_vertex_cache(cache_optimized, grid.positions.size());
+
+        BENCHMARK(zth::format("analyze vertex cache ({} triangles)", triangle_count))
+        {
+            return zth::analyze_vertex_cache(grid.indices, grid.positions.size()).acmr;
+        };
+
+        BENCHMARK(zth::format("optimize vertex cache ({} triangles)", triangle_count))
+        {
+            auto indices = grid.indices;
+            zth::optimize_vertex_cache(indices, grid.positions.size());
+            return indices.front();
+        };
+
+        BENCHMARK(zth::format("optimize overdraw ({} triangles)", triangle_count))
+        {
+            auto indices = cache_optimized;
+            zth::optimize_overdraw(indices, grid.positions);
+            return indices.front();
+        };
+
+        BENCHMARK(zth::format("remap for vertex fetch ({} triangles)", triangle_count))
+        {
+            auto indices = cache_optimized;
+            return zth::remap_for_vertex_fetch(indices, grid.positions.size()).size();
+        };
+    }
+}
@@ -0,0 +1,165 @@
+#include <glm/common.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/trigonometric.hpp>
+
+#include <algorithm>
+#include <random>
+
+#include <zenith/core/typedefs.hpp>
+#include <zenith/math/bounds.hpp>
+#include <zenith/renderer/occlusion_buffer.hpp>
+
+using zth::u32;
+using zth::math::Aabb;
+
+using zth::OccluderMesh;
+using zth::OcclusionBuffer;
+
+namespace {
+
+// Looks down the negative z axis from the origin. The aspect ratio matches the buffer's, so that the pixels are square.
+auto view_projection() -> glm::mat4
+{
+    auto projection = glm::perspective(glm::radians(60.0f), 2.0f, 0.1f, 100.0f);
+    auto view = glm::lookAt(glm::vec3{ 0.0f }, glm::vec3{ 0.0f, 0.0f, -1.0f }, glm::vec3{ 0.0f, 1.0f, 0.0f });
+    return projection * view;
+}
+
+auto box_at(glm::vec3 center, float half_size = 0.5f) -> Aabb
+{
+    return Aabb{ .min = center - half_size, .max = center + half_size };
+}
+
+// Scales and moves the unit box centered at the origin into the given box.
+auto transform_into(const Aabb& aabb) -> glm::mat4
+{
+    auto transform = glm::translate(glm::mat4{ 1.0f }, aabb.center());
+    return glm::scale(transform, aabb.max - aabb.min);
+}
+
+} // namespace
+
+TEST_CASE("Nothing is occluded without occluders", "[OcclusionBuffer]")
+{
+    OcclusionBuffer buffer;
+    buffer.begin(view_projection());
+    buffer.finish();
+
+    REQUIRE(buffer.triangle_count() == 0);
+    REQUIRE(buffer.is_visible(box_at(glm::vec3{ 0.0f, 0.0f, -10.0f })));
+    REQUIRE(buffer.is_visible(box_at(glm::vec3{ 3.0f, -2.0f, -50.0f })));
+}
+
+TEST_CASE("An occluder hides what lies entirely behind it", "[OcclusionBuffer]")
+{
+    auto wall =
+        OccluderMesh::box(Aabb{ .min = glm::vec3{ -2.0f, -2.0f, -5.1f }, .max = glm::vec3{ 2.0f, 2.0f, -5.0f } });
+
+    OcclusionBuffer buffer;
+    buffer.begin(view_projection());
+    buffer.add_occluder(wall, glm::mat4{ 1.0f });
+    buffer.finish();
+
+    REQUIRE(buffer.occluder_count() == 1);
+    REQUIRE(buffer.triangle_count() > 0);
+
+    // The wall covers |x| < 8 at this depth.
+    REQUIRE(!buffer.is_visible(box_at(glm::vec3{ 0.0f, 0.0f, -20.0f })));
+    REQUIRE(!buffer.is_visible(box_at(glm::vec3{ 5.0f, 3.0f, -20.0f })));
+
+    // In front of the wall.
+    REQUIRE(buffer.is_visible(box_at(glm::vec3{ 0.0f, 0.0f, -3.0f })));
+    // Sticks out from behind the wall.
+    REQUIRE(buffer.is_visible(box_at(glm::vec3{ 8.0f, 0.0f, -20.0f })));
+    // Next to the wall.
+    REQUIRE(buffer.is_visible(box_at(glm::vec3{ 15.0f, 0.0f, -20.0f })));
+    // Passes through the wall.
+    REQUIRE(buffer.is_visible(box_at(glm::vec3{ 0.0f, 0.0f, -5.0f })));
+}
+
+TEST_CASE("Occluders get transformed and clipped against the near plane", "[OcclusionBuffer]")
+{
+    auto unit_box = OccluderMesh::box(Aabb{ .min = glm::vec3{ -0.5f }, .max = glm::vec3{ 0.5f } });
+
+    // A wall along the right side of the camera, which reaches behind it.
+    auto wall = Aabb{ .min = glm::vec3{ 2.0f, -50.0f, -50.0f }, .max = glm::vec3{ 2.2f, 50.0f, 10.0f } };
+
+    OcclusionBuffer buffer;
+    buffer.begin(view_projection());
+    buffer.add_occluder(unit_box, transform_into(wall));
+    buffer.finish();
+
+    REQUIRE(!buffer.is_visible(box_at(glm::vec3{ 5.0f, 0.0f, -20.0f })));
+    REQUIRE(buffer.is_visible(box_at(glm::vec3{ -5.0f, 0.0f, -20.0f })));
+
+    SECTION("Boxes which reach the camera are always visible")
+    {
+        REQUIRE(buffer.is_visible(box_at(glm::vec3{ 0.0f }, 1.0f)));
+        auto reaching_box = Aabb{ .min = glm::vec3{ 3.0f, -1.0f, -20.0f }, .max = glm::vec3{ 4.0f, 1.0f, 1.0f } };
+        REQUIRE(buffer.is_visible(reaching_box));
+    }
+
+    SECTION("Beginning a new frame forgets the occluders")
+    {
+        buffer.begin(view_projection());
+        buffer.finish();
+
+        REQUIRE(buffer.occluder_count() == 0);
+        REQUIRE(buffer.is_visible(box_at(glm::vec3{ 5.0f, 0.0f, -20.0f })));
+    }
+}
+
+TEST_CASE("Every level of the depth pyramid holds the farthest depth of the level below it", "[OcclusionBuffer]")
+{
+    std::mt19937 generator{ 2025 };
+    std::uniform_real_distribution<float> xy_distribution{ -20.0f, 20.0f };
+    std::uniform_real_distribution<float> z_distribution{ -60.0f, -2.0f };
+    std::uniform_real_distribution<float> size_distribution{ 0.5f, 8.0f };
+
+    auto unit_box = OccluderMesh::box(Aabb{ .min = glm::vec3{ -0.5f }, .max = glm::vec3{ 0.5f } });
+
+    OcclusionBuffer buffer{ glm::uvec2{ 96, 64 } };
+    buffer.begin(view_projection());
+
+    for (auto i = 0; i < 32; i++)
+    {
+        glm::vec3 center{ xy_distribution(generator), xy_distribution(generator), z_distribution(generator) };
+        glm::vec3 size{ size_distribution(generator), size_distribution(generator), size_distribution(generator) };
+        buffer.add_occluder(unit_box, transform_into(Aabb{ .min = center - size * 0.5f, .max = center + size * 0.5f }));
+    }
+
+    buffer.finish();
+
+    auto depths = buffer.level(0);
+    REQUIRE(std::ranges::all_of(depths, [](float depth) { return depth >= 0.0f && depth <= 1.0f; }));
+    REQUIRE(std::ranges::any_of(depths, [](float depth) { return depth < 1.0f; }));
+
+    REQUIRE(buffer.level_size(buffer.level_count() - 1) == glm::uvec2{ 1 });
+
+    for (u32 level = 1; level < buffer.level_count(); level++)
+    {
+        auto size = buffer.level_size(level);
+        auto previous_size = buffer.level_size(level - 1);
+
+        REQUIRE(size == (previous_size + 1u) / 2u);
+
+        auto texels = buffer.level(level);
+        auto previous_texels = buffer.level(level - 1);
+
+        for (u32 y = 0; y < size.y; y++)
+        {
+            for (u32 x = 0; x < size.x; x++)
+            {
+                auto farthest = 0.0f;
+
+                for (auto ty = y * 2; ty < std::min(y * 2 + 2, previous_size.y); ty++)
+                {
+                    for (auto tx = x * 2; tx < std::min(x * 2 + 2, previous_size.x); tx++)
+                        farthest = std::max(farthest, previous_texels[ty * previous_size.x + tx]);
+                }
+
+                REQUIRE(texels[y * size.x + x] == farthest);
+            }
+        }
+    }
+}
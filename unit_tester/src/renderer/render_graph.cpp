@@ -0,0 +1,346 @@
+#include <algorithm>
+#include <vector>
+
+#include <zenith/core/typedefs.hpp>
+#include <zenith/renderer/render_graph.hpp>
+
+using zth::u32;
+using zth::usize;
+
+using zth::RenderGraph;
+using zth::RenderGraphPassBuilder;
+using zth::RenderGraphTextureDesc;
+using zth::gl::SizedTextureFormat;
+
+namespace {
+
+const RenderGraphTextureDesc color_desc{ .size = { 256, 128 }, .format = SizedTextureFormat::Rgba8 };
+constexpr usize color_bytes = 256 * 128 * 4;
+
+auto execution_order_names(const RenderGraph& graph) -> std::vector<zth::String>
+{
+    std::vector<zth::String> names;
+
+    for (auto pass_index : graph.execution_order())
+        names.push_back(graph.passes()[pass_index].name);
+
+    return names;
+}
+
+} // namespace
+
+TEST_CASE("Render graph culls the passes whose results nobody uses", "[RenderGraph]")
+{
+    RenderGraph graph;
+
+    auto backbuffer = graph.backbuffer();
+    auto scene = graph.create_texture("Scene", color_desc);
+    auto unused = graph.create_texture("Unused", color_desc);
+    auto debug = graph.create_texture("Debug", color_desc);
+
+    graph.add_pass("Scene", [&](RenderGraphPassBuilder& builder) { builder.write_color(scene); }, {});
+    graph.add_pass("Unused", [&](RenderGraphPassBuilder& builder) { builder.write_color(unused); }, {});
+    graph.add_pass(
+        "Unused Reader",
+        [&](RenderGraphPassBuilder& builder) {
+            builder.read(unused);
+            builder.write_color(debug);
+        },
+        {});
+    graph.add_pass(
+        "Composite",
+        [&](RenderGraphPassBuilder& builder) {
+            builder.read(scene);
+            builder.write_color(backbuffer);
+        },
+        {});
+
+    REQUIRE(graph.compile());
+
+    REQUIRE(execution_order_names(graph) == std::vector<zth::String>{ "Scene", "Composite" });
+    REQUIRE(graph.stats().passes == 4);
+    REQUIRE(graph.stats().culled_passes == 2);
+    REQUIRE(graph.passes()[1].culled);
+    REQUIRE(graph.passes()[2].culled);
+
+    // The resources which only the culled passes use don't get allocated.
+    REQUIRE(!graph.resource(unused).first_use);
+    REQUIRE(!graph.resource(unused).allocation);
+    REQUIRE(graph.stats().transient_resources == 1);
+
+    SECTION("Side effects keep passes alive")
+    {
+        graph.add_pass("Readback", [&](RenderGraphPassBuilder& builder) { builder.set_side_effect(); }, {});
+
+        REQUIRE(graph.compile());
+        REQUIRE(execution_order_names(graph) == std::vector<zth::String>{ "Scene", "Composite", "Readback" });
+    }
+
+    SECTION("Writes to imported resources keep passes alive")
+    {
+        auto history = graph.import_texture("History");
+        graph.add_pass(
+            "Store History",
+            [&](RenderGraphPassBuilder& builder) {
+                builder.read(debug);
+                builder.write_color(history);
+            },
+            {});
+
+        REQUIRE(graph.compile());
+        REQUIRE(execution_order_names(graph)
+                == std::vector<zth::String>{ "Scene", "Unused", "Unused Reader", "Composite", "Store History" });
+    }
+}
+
+TEST_CASE("Render graph only keeps the writes which get read", "[RenderGraph]")
+{
+    RenderGraph graph;
+
+    auto backbuffer = graph.backbuffer();
+    auto target = graph.create_texture("Target", color_desc);
+
+    // The second pass overwrites the target before anything reads it, so the first one is useless.
+    graph.add_pass("Overwritten", [&](RenderGraphPassBuilder& builder) { builder.write_color(target); }, {});
+    graph.add_pass("Overwrite", [&](RenderGraphPassBuilder& builder) { builder.write_color(target); }, {});
+    graph.add_pass(
+        "Present",
+        [&](RenderGraphPassBuilder& builder) {
+            builder.read(target);
+            builder.write_color(backbuffer);
+        },
+        {});
+
+    REQUIRE(graph.compile());
+    REQUIRE(execution_order_names(graph) == std::vector<zth::String>{ "Overwrite", "Present" });
+
+    SECTION("Unless the overwriting pass reads it too")
+    {
+        graph.clear();
+
+        backbuffer = graph.backbuffer();
+        target = graph.create_texture("Target", color_desc);
+
+        graph.add_pass("Draw", [&](RenderGraphPassBuilder& builder) { builder.write_color(target); }, {});
+        graph.add_pass(
+            "Blend",
+            [&](RenderGraphPassBuilder& builder) {
+                builder.read(target);
+                builder.write_color(target);
+            },
+            {});
+        graph.add_pass(
+            "Present",
+            [&](RenderGraphPassBuilder& builder) {
+                builder.read(target);
+                builder.write_color(backbuffer);
+            },
+            {});
+
+        REQUIRE(graph.compile());
+        REQUIRE(execution_order_names(graph) == std::vector<zth::String>{ "Draw", "Blend", "Present" });
+    }
+}
+
+TEST_CASE("Render graph rejects invalid graphs", "[RenderGraph]")
+{
+    RenderGraph graph;
+
+    auto backbuffer = graph.backbuffer();
+    auto target = graph.create_texture("Target", color_desc);
+
+    SECTION("Reading a transient resource before it gets written")
+    {
+        graph.add_pass(
+            "Reader",
+            [&](RenderGraphPassBuilder& builder) {
+                builder.read(target);
+                builder.write_color(backbuffer);
+            },
+            {});
+        graph.add_pass("Writer", [&](RenderGraphPassBuilder& builder) { builder.write_color(target); }, {});
+
+        auto result = graph.compile();
+        REQUIRE(!result);
+        REQUIRE(result.error().contains("Target"));
+        REQUIRE(!graph.compiled());
+    }
+
+    SECTION("Rendering into the backbuffer together with other attachments")
+    {
+        graph.add_pass(
+            "Mixed",
+            [&](RenderGraphPassBuilder& builder) {
+                builder.write_color(backbuffer);
+                builder.write_color(target);
+            },
+            {});
+
+        REQUIRE(!graph.compile());
+    }
+}
+
+TEST_CASE("Render graph aliases transient resources with disjoint lifetimes", "[RenderGraph]")
+{
+    RenderGraph graph;
+
+    auto backbuffer = graph.backbuffer();
+
+    // A chain of passes, each of which reads the output of the previous one. Every texture is only needed until the
+    // next pass has run, so two allocations suffice for any number of passes.
+    constexpr u32 chain_length = 6;
+    std::vector<zth::RenderGraphTexture> targets;
+
+    for (u32 i = 0; i < chain_length; i++)
+        targets.push_back(graph.create_texture("Target", color_desc));
+
+    auto depth = graph.create_texture("Depth", { .size = { 256, 128 }, .format = SizedTextureFormat::Depth32f });
+    auto half_size = graph.create_texture("Half Size", { .size = { 128, 64 }, .format = SizedTextureFormat::Rgba8 });
+
+    graph.add_pass(
+        "Draw",
+        [&](RenderGraphPassBuilder& builder) {
+            builder.write_color(targets[0]);
+            builder.write_depth(depth);
+        },
+        {});
+
+    for (u32 i = 1; i < chain_length; i++)
+    {
+        graph.add_pass(
+            "Filter",
+            [&](RenderGraphPassBuilder& builder) {
+                builder.read(targets[i - 1]);
+                builder.write_color(targets[i]);
+            },
+            {});
+    }
+
+    graph.add_pass(
+        "Downsample",
+        [&](RenderGraphPassBuilder& builder) {
+            builder.read(targets.back());
+            builder.write_color(half_size);
+        },
+        {});
+    graph.add_pass(
+        "Present",
+        [&](RenderGraphPassBuilder& builder) {
+            builder.read(half_size);
+            builder.write_color(backbuffer);
+        },
+        {});
+
+    REQUIRE(graph.compile());
+
+    const auto& stats = graph.stats();
+    REQUIRE(stats.culled_passes == 0);
+    REQUIRE(stats.transient_resources == chain_length + 2);
+
+    // Two allocations for the chain, and one each for the depth and the half size texture, whose descriptions don't
+    // match any of the other textures.
+    REQUIRE(stats.allocations == 4);
+    REQUIRE(stats.transient_bytes == chain_length * color_bytes + color_bytes + color_bytes / 4);
+    REQUIRE(stats.allocated_bytes == 2 * color_bytes + color_bytes + color_bytes / 4);
+    REQUIRE(stats.saved_bytes() == (chain_length - 2) * color_bytes);
+
+    // Resources which share an allocation must never be alive at the same time.
+    for (const auto& allocation : graph.allocations())
+    {
+        for (auto first : allocation.resources)
+        {
+            for (auto second : allocation.resources)
+            {
+                if (first == second)
+                    continue;
+
+                const auto& a = graph.resources()[first];
+                const auto& b = graph.resources()[second];
+                REQUIRE((*a.last_use < *b.first_use || *b.last_use < *a.first_use));
+                REQUIRE(a.texture_desc == b.texture_desc);
+            }
+        }
+    }
+
+    REQUIRE(graph.resource(targets[0]).allocation == graph.resource(targets[2]).allocation);
+    REQUIRE(graph.resource(targets[0]).allocation != graph.resource(targets[1]).allocation);
+}
+
+TEST_CASE("Render graph aliases buffers of different sizes", "[RenderGraph]")
+{
+    RenderGraph graph;
+
+    auto backbuffer = graph.backbuffer();
+    auto small = graph.create_buffer("Small", { .size = 1024 });
+    auto large = graph.create_buffer("Large", { .size = 4096 });
+
+    graph.add_pass("Write Small", [&](RenderGraphPassBuilder& builder) { builder.write(small); }, {});
+    graph.add_pass(
+        "Read Small",
+        [&](RenderGraphPassBuilder& builder) {
+            builder.read(small);
+            builder.write_color(backbuffer);
+        },
+        {});
+    graph.add_pass("Write Large", [&](RenderGraphPassBuilder& builder) { builder.write(large); }, {});
+    graph.add_pass(
+        "Read Large",
+        [&](RenderGraphPassBuilder& builder) {
+            builder.read(large);
+            builder.write_color(backbuffer);
+        },
+        {});
+
+    REQUIRE(graph.compile());
+
+    // The allocation grows to fit the larger buffer.
+    REQUIRE(graph.stats().allocations == 1);
+    REQUIRE(graph.stats().allocated_bytes == 4096);
+    REQUIRE(graph.stats().saved_bytes() == 1024);
+}
+
+TEST_CASE("Render graph dump describes the compiled graph", "[RenderGraph]")
+{
+    RenderGraph graph;
+
+    auto backbuffer = graph.backbuffer();
+    auto first = graph.create_texture("First", color_desc);
+    auto second = graph.create_texture("Second", color_desc);
+    auto third = graph.create_texture("Third", color_desc);
+
+    graph.add_pass("Draw", [&](RenderGraphPassBuilder& builder) { builder.write_color(first); }, {});
+    graph.add_pass(
+        "Blur",
+        [&](RenderGraphPassBuilder& builder) {
+            builder.read(first);
+            builder.write_color(second);
+        },
+        {});
+    graph.add_pass(
+        "Sharpen",
+        [&](RenderGraphPassBuilder& builder) {
+            builder.read(second);
+            builder.write_color(third);
+        },
+        {});
+    graph.add_pass(
+        "Present",
+        [&](RenderGraphPassBuilder& builder) {
+            builder.read(third);
+            builder.write_color(backbuffer);
+        },
+        {});
+    graph.add_pass("Dead", [&](RenderGraphPassBuilder& builder) { builder.write_color(first); }, {});
+
+    REQUIRE(graph.compile());
+
+    auto dump = graph.dump();
+
+    REQUIRE(dump.contains("5 passes (1 culled)"));
+    REQUIRE(dump.contains("Dead (culled)"));
+    REQUIRE(dump.contains("0. Draw"));
+    REQUIRE(dump.contains("3. Present"));
+    REQUIRE(dump.contains("256x128 Rgba8"));
+    REQUIRE(dump.contains("Backbuffer (backbuffer)"));
+    REQUIRE(dump.contains("saved (33.3%)"));
+}
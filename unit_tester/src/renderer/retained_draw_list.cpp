@@ -0,0 +1,206 @@
+#include <glm/mat3x3.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+
+#include <random>
+#include <vector>
+
+#include <zenith/core/typedefs.hpp>
+#include <zenith/math/bounds.hpp>
+#include <zenith/renderer/retained_draw_list.hpp>
+
+using zth::u32;
+using zth::u64;
+
+using zth::RetainedInstanceSlots;
+using zth::SlotRange;
+
+namespace {
+
+auto translation(float x) -> glm::mat4
+{
+    glm::mat4 result{ 1.0f };
+    result[3] = glm::vec4{ x, 0.0f, 0.0f, 1.0f };
+    return result;
+}
+
+auto bounds_at(float x) -> zth::math::Aabb
+{
+    return zth::math::Aabb{ .min = glm::vec3{ x - 1.0f, -1.0f, -1.0f }, .max = glm::vec3{ x + 1.0f, 1.0f, 1.0f } };
+}
+
+// Submits the instance with the given key and version, storing a transform which tells where it came from.
+auto submit(RetainedInstanceSlots& slots, u64 key, u64 version) -> bool
+{
+    auto slot = slots.submit(key, version);
+
+    if (slot)
+    {
+        auto x = static_cast<float>(key * 1000 + version);
+        slots.store(*slot, translation(x), glm::mat3{ 1.0f }, bounds_at(x));
+    }
+
+    return slot.has_value();
+}
+
+auto dirty_ranges(RetainedInstanceSlots& slots) -> std::vector<SlotRange>
+{
+    auto ranges = slots.dirty_ranges();
+    return { ranges.begin(), ranges.end() };
+}
+
+// Every occupied slot must hold the data of the instance whose key is stored in it.
+auto require_consistent(const RetainedInstanceSlots& slots, auto&& version_of) -> void
+{
+    for (u32 slot = 0; slot < slots.size(); slot++)
+    {
+        auto key = slots.keys()[slot];
+        REQUIRE(slots.transforms()[slot][3].x == static_cast<float>(key * 1000 + version_of(key)));
+    }
+}
+
+} // namespace
+
+TEST_CASE("Retained instance slots only report the instances which changed", "[RetainedDrawList]")
+{
+    RetainedInstanceSlots slots;
+
+    for (u64 key = 0; key < 8; key++)
+        REQUIRE(submit(slots, key, 0));
+
+    auto stats = slots.end_frame();
+    REQUIRE(stats.added_instances == 8);
+    REQUIRE(stats.reused_instances == 0);
+    REQUIRE(stats.removed_instances == 0);
+
+    // Everything is new, so all the slots get uploaded with a single range.
+    REQUIRE(dirty_ranges(slots) == std::vector<SlotRange>{ { .first = 0, .count = 8 } });
+    slots.clear_dirty_slots();
+    REQUIRE(slots.dirty_ranges().empty());
+
+    SECTION("Resubmitting the same versions doesn't change anything")
+    {
+        for (u64 key = 0; key < 8; key++)
+            REQUIRE(!submit(slots, key, 0));
+
+        stats = slots.end_frame();
+        REQUIRE(stats.reused_instances == 8);
+        REQUIRE(stats.added_instances == 0);
+        REQUIRE(slots.dirty_ranges().empty());
+    }
+
+    SECTION("Changed instances get merged into contiguous ranges")
+    {
+        auto version_of = [](u64 key) { return key == 2 || key == 3 || key == 6 ? 1u : 0u; };
+
+        for (u64 key = 0; key < 8; key++)
+            REQUIRE(submit(slots, key, version_of(key)) == (version_of(key) != 0));
+
+        stats = slots.end_frame();
+        REQUIRE(stats.reused_instances == 5);
+        REQUIRE(dirty_ranges(slots)
+                == std::vector<SlotRange>{ { .first = 2, .count = 2 }, { .first = 6, .count = 1 } });
+
+        require_consistent(slots, version_of);
+    }
+
+    SECTION("Instances which don't get submitted get removed and the last instances fill their slots")
+    {
+        for (u64 key = 0; key < 8; key++)
+        {
+            if (key != 1 && key != 7)
+                REQUIRE(!submit(slots, key, 0));
+        }
+
+        stats = slots.end_frame();
+        REQUIRE(stats.removed_instances == 2);
+        REQUIRE(stats.reused_instances == 5);
+        REQUIRE(slots.size() == 6);
+
+        // Key 7 occupied the last slot, so it simply goes away, and key 6 moves into the slot of key 1.
+        REQUIRE(slots.keys()[1] == 6);
+        REQUIRE(dirty_ranges(slots) == std::vector<SlotRange>{ { .first = 1, .count = 1 } });
+
+        require_consistent(slots, [](u64) { return 0u; });
+    }
+
+    SECTION("Marking every slot dirty uploads everything again")
+    {
+        slots.mark_all_dirty();
+        REQUIRE(dirty_ranges(slots) == std::vector<SlotRange>{ { .first = 0, .count = 8 } });
+    }
+}
+
+TEST_CASE("Retained instance slots stay consistent under random changes", "[RetainedDrawList]")
+{
+    std::mt19937 generator{ 2025 };
+    std::uniform_int_distribution<u32> action_distribution{ 0, 9 };
+
+    constexpr u64 key_count = 256;
+
+    RetainedInstanceSlots slots;
+
+    // Mirrors what the GPU would hold after uploading the dirty ranges.
+    std::vector<float> uploaded;
+    std::vector<u64> versions(key_count, 0);
+    std::vector<bool> alive(key_count, false);
+
+    for (auto frame = 0; frame < 200; frame++)
+    {
+        u32 expected_size = 0;
+
+        for (u64 key = 0; key < key_count; key++)
+        {
+            auto action = action_distribution(generator);
+
+            if (action == 0)
+            {
+                alive[key] = !alive[key]; // Gets added or removed.
+            }
+            else if (action == 1 && alive[key])
+            {
+                versions[key]++;
+            }
+
+            if (alive[key])
+            {
+                (void)submit(slots, key, versions[key]);
+                expected_size++;
+            }
+        }
+
+        (void)slots.end_frame();
+        REQUIRE(slots.size() == expected_size);
+
+        uploaded.resize(slots.size());
+
+        for (auto [first, count] : slots.dirty_ranges())
+        {
+            for (auto slot = first; slot < first + count; slot++)
+                uploaded[slot] = slots.transforms()[slot][3].x;
+        }
+
+        slots.clear_dirty_slots();
+
+        // Only uploading the dirty ranges has to give the same result as uploading everything.
+        for (u32 slot = 0; slot < slots.size(); slot++)
+        {
+            auto key = slots.keys()[slot];
+            REQUIRE(alive[key]);
+            REQUIRE(uploaded[slot] == static_cast<float>(key * 1000 + versions[key]));
+        }
+
+        // The bounds contain every instance's bounds.
+        if (!slots.empty())
+        {
+            const auto& bounds = slots.bounds();
+
+            for (u32 slot = 0; slot < slots.size(); slot++)
+            {
+                auto x = slots.transforms()[slot][3].x;
+                REQUIRE(bounds.min.x <= x - 1.0f);
+                REQUIRE(bounds.max.x >= x + 1.0f);
+            }
+        }
+    }
+}
@@ -0,0 +1,269 @@
+#include <glm/geometric.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <zenith/core/typedefs.hpp>
+#include <zenith/gl/vertex_layout.hpp>
+#include <zenith/log/format.hpp>
+#include <zenith/math/matrix.hpp>
+#include <zenith/math/quantization.hpp>
+#include <zenith/renderer/vertex.hpp>
+
+using zth::usize;
+
+namespace {
+
+// The rotation gets quantized, so the decoded transform is only close to the original one. The columns get compared
+// relative to their lengths, which are the scale.
+auto require_close(const glm::mat4& actual, const glm::mat4& expected) -> void
+{
+    for (glm::length_t column = 0; column < 4; column++)
+    {
+        auto tolerance = 1e-3f * std::max(1.0f, glm::length(expected[column]));
+        REQUIRE(glm::distance(actual[column], expected[column]) <= tolerance);
+    }
+}
+
+auto require_close(const glm::mat3& actual, const glm::mat3& expected) -> void
+{
+    require_close(glm::mat4{ actual }, glm::mat4{ expected });
+}
+
+auto random_rotation(std::mt19937& generator) -> glm::quat
+{
+    std::uniform_real_distribution<float> distribution{ -1.0f, 1.0f };
+    glm::quat rotation{ distribution(generator), distribution(generator), distribution(generator),
+                        distribution(generator) };
+    return glm::normalize(rotation);
+}
+
+} // namespace
+
+TEST_CASE("Compact vertex layout", "[CompactVertex]")
+{
+    using enum zth::gl::VertexLayoutElement;
+
+    REQUIRE(sizeof(zth::CompactVertex) == 16);
+    REQUIRE(zth::CompactVertex::layout == zth::gl::VertexLayout{ { Unorm16Vec4, Snorm16Vec2, HalfVec2 }, 16 });
+
+    // The attributes have to be laid out back to back, the same way as in the struct.
+    usize size = 0;
+
+    for (auto element : zth::CompactVertex::layout)
+        size += zth::gl::get_vertex_layout_element_info(element).size_bytes;
+
+    REQUIRE(size == sizeof(zth::CompactVertex));
+}
+
+TEST_CASE("Compact vertices stay within the quantization error bounds", "[CompactVertex]")
+{
+    std::mt19937 generator{ 2025 };
+    // Far away from the origin and flat along y, so that the positions only fit the format relative to their bounds.
+    std::uniform_real_distribution<float> position_distribution{ 900.0f, 1100.0f };
+    std::uniform_real_distribution<float> height_distribution{ -1.0f, 1.0f };
+    std::uniform_real_distribution<float> uv_distribution{ -4.0f, 4.0f };
+    std::normal_distribution<float> normal_distribution;
+
+    std::vector<zth::StandardVertex> vertices;
+
+    for (auto i = 0; i < 10'000; i++)
+    {
+        vertices.push_back(zth::StandardVertex{
+            .position = glm::vec3{ position_distribution(generator), height_distribution(generator),
+                                   position_distribution(generator) },
+            .normal = glm::normalize(glm::vec3{ normal_distribution(generator), normal_distribution(generator),
+                                                normal_distribution(generator) }),
+            .uv = glm::vec2{ uv_distribution(generator), uv_distribution(generator) },
+        });
+    }
+
+    auto position_transform = zth::compact_position_transform(vertices);
+    auto compact_vertices = zth::compact_vertices(vertices, position_transform);
+
+    // The scale is the longest side of the bounds.
+    REQUIRE(position_transform.scale <= 200.0f);
+    REQUIRE(position_transform.scale >= 190.0f);
+
+    // The float math around the quantization adds some error of its own, relative to the distance from the origin.
+    auto max_position_error = position_transform.scale * zth::math::unorm16_max_error + 1e-4f;
+
+    for (usize i = 0; i < vertices.size(); i++)
+    {
+        const auto& vertex = vertices[i];
+        const auto& compact = compact_vertices[i];
+        auto decoded = compact.to_standard(position_transform);
+
+        // Shaders read the positions as they are, so w has to be 1.
+        REQUIRE(zth::math::dequantize_unorm16(compact.position.w) == 1.0f);
+
+        for (glm::length_t component = 0; component < 3; component++)
+        {
+            auto error = std::abs(decoded.position[component] - vertex.position[component]);
+            REQUIRE(error <= max_position_error);
+        }
+
+        for (glm::length_t component = 0; component < 2; component++)
+        {
+            auto error = std::abs(decoded.uv[component] - vertex.uv[component]);
+            REQUIRE(error <= std::abs(vertex.uv[component]) * zth::math::half_max_relative_error + 1e-7f);
+        }
+
+        REQUIRE(glm::distance(decoded.normal, vertex.normal) <= zth::math::octahedral_snorm16_max_error);
+        REQUIRE(decoded.position == compact.decode_position(position_transform));
+    }
+}
+
+TEST_CASE("Position transforms fold into instance transforms", "[CompactVertex]")
+{
+    std::mt19937 generator{ 2025 };
+    std::uniform_real_distribution<float> distribution{ -10.0f, 10.0f };
+
+    std::vector<zth::StandardVertex> vertices;
+
+    for (auto i = 0; i < 100; i++)
+    {
+        vertices.push_back(zth::StandardVertex{
+            .position = glm::vec3{ distribution(generator), distribution(generator), distribution(generator) },
+            .normal = glm::vec3{ 0.0f, 1.0f, 0.0f },
+            .uv = glm::vec2{ 0.0f },
+        });
+    }
+
+    auto position_transform = zth::compact_position_transform(vertices);
+    auto compact_vertices = zth::compact_vertices(vertices, position_transform);
+
+    auto transform = zth::math::compose_transform(glm::vec3{ 2.0f, 0.5f, 3.0f }, random_rotation(generator),
+                                                  glm::vec3{ 5.0f, -2.0f, 1.0f });
+    auto instance_transform = zth::apply_position_transform(transform, position_transform);
+
+    // Transforming the stored position with the instance's transform, like the shaders do, has to give the same
+    // result as transforming the decoded position with the original transform.
+    for (const auto& compact : compact_vertices)
+    {
+        auto stored_position = glm::vec4{ glm::vec3{ zth::math::unpack(compact.position) }, 1.0f };
+        auto decoded_position = glm::vec4{ compact.decode_position(position_transform), 1.0f };
+        REQUIRE(glm::distance(instance_transform * stored_position, transform * decoded_position) <= 1e-3f);
+    }
+
+    SECTION("vertices which are all in the same place only get offset")
+    {
+        std::vector<zth::StandardVertex> point(3, vertices.front());
+        auto point_transform = zth::compact_position_transform(point);
+
+        REQUIRE(point_transform.scale == 1.0f);
+        REQUIRE(point_transform.offset == vertices.front().position);
+        REQUIRE(zth::CompactVertex::from_standard(point.front(), point_transform).decode_position(point_transform)
+                == point.front().position);
+    }
+}
+
+TEST_CASE("Compact instance layout", "[CompactInstanceVertex]")
+{
+    using enum zth::gl::VertexLayoutElement;
+
+    REQUIRE(sizeof(zth::CompactInstanceVertex) == 40);
+    REQUIRE(zth::CompactInstanceVertex::layout == zth::gl::VertexLayout{ { Uint, Vec4, Snorm16Vec4, Vec3 }, 40 });
+
+    // The material index has to have the same attribute location in both instance formats.
+    REQUIRE(*zth::InstanceVertex::layout.begin() == Uint);
+
+    usize size = 0;
+
+    for (auto element : zth::CompactInstanceVertex::layout)
+        size += zth::gl::get_vertex_layout_element_info(element).size_bytes;
+
+    REQUIRE(size == sizeof(zth::CompactInstanceVertex));
+}
+
+TEST_CASE("Compact instances reproduce the transform and the normal matrix", "[CompactInstanceVertex]")
+{
+    std::mt19937 generator{ 2025 };
+    std::uniform_real_distribution<float> scale_distribution{ 0.2f, 5.0f };
+    std::uniform_real_distribution<float> translation_distribution{ -100.0f, 100.0f };
+
+    for (auto i = 0; i < 10'000; i++)
+    {
+        auto rotation = random_rotation(generator);
+        glm::vec3 scale{ scale_distribution(generator), scale_distribution(generator), scale_distribution(generator) };
+        glm::vec3 translation{ translation_distribution(generator), translation_distribution(generator),
+                               translation_distribution(generator) };
+        auto transform = zth::math::compose_transform(scale, rotation, translation);
+
+        auto instance = zth::CompactInstanceVertex::from_transform(transform, 7);
+
+        // Shaders tell compact instances apart by the translation's w.
+        REQUIRE(instance.translation.w == 0.0f);
+        REQUIRE(glm::vec3{ instance.translation } == translation);
+        REQUIRE(instance.material_index == 7);
+
+        require_close(instance.decode_transform(), transform);
+        require_close(instance.decode_normal_matrix(), zth::math::get_normal_matrix(transform));
+
+        auto from_trs = zth::CompactInstanceVertex::from_trs(translation, rotation, scale, 7);
+        require_close(from_trs.decode_transform(), transform);
+    }
+}
+
+TEST_CASE("Compact instances handle mirrored and flattened transforms", "[CompactInstanceVertex]")
+{
+    std::mt19937 generator{ 2025 };
+    glm::vec3 translation{ 1.0f, -2.0f, 3.0f };
+
+    for (auto scale : { glm::vec3{ -1.0f, 2.0f, 3.0f }, glm::vec3{ 2.0f, 3.0f, -0.5f }, glm::vec3{ 4.0f, 0.0f, 2.0f },
+                        glm::vec3{ 0.0f, 0.0f, 0.0f } })
+    {
+        for (auto i = 0; i < 100; i++)
+        {
+            auto transform = zth::math::compose_transform(scale, random_rotation(generator), translation);
+            auto instance = zth::CompactInstanceVertex::from_transform(transform, 0);
+
+            require_close(instance.decode_transform(), transform);
+        }
+    }
+}
+
+TEST_CASE("Instance packing benchmark", "[.][benchmark][CompactInstanceVertex]")
+{
+    // The instance count of a large scene. The compact format uploads less than half the data.
+    constexpr usize count = 200'000;
+
+    std::mt19937 generator{ 2025 };
+    std::uniform_real_distribution<float> scale_distribution{ 0.2f, 5.0f };
+
+    std::vector<glm::mat4> transforms;
+    std::vector<glm::mat3> normal_matrices;
+
+    for (usize i = 0; i < count; i++)
+    {
+        glm::vec3 scale{ scale_distribution(generator), scale_distribution(generator), scale_distribution(generator) };
+        transforms.push_back(zth::math::compose_transform(scale, random_rotation(generator), glm::vec3{ 0.0f }));
+        normal_matrices.push_back(zth::math::get_normal_matrix(transforms.back()));
+    }
+
+    std::vector<zth::InstanceVertex> instances(count);
+    std::vector<zth::CompactInstanceVertex> compact_instances(count);
+
+    BENCHMARK(zth::format("standard instances ({} KB)", count * sizeof(zth::InstanceVertex) / 1024))
+    {
+        for (usize i = 0; i < count; i++)
+        {
+            const auto& transform = transforms[i];
+            instances[i] = zth::InstanceVertex{ 0, transform[0], transform[1], transform[2], transform[3],
+                                                normal_matrices[i] };
+        }
+
+        return instances.back();
+    };
+
+    BENCHMARK(zth::format("compact instances ({} KB)", count * sizeof(zth::CompactInstanceVertex) / 1024))
+    {
+        for (usize i = 0; i < count; i++)
+            compact_instances[i] = zth::CompactInstanceVertex::from_transform(transforms[i], 0);
+
+        return compact_instances.back();
+    };
+}
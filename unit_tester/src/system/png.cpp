@@ -0,0 +1,76 @@
+#include <stb_image/stb_image.h>
+
+#include <algorithm>
+#include <array>
+
+#include <zenith/core/typedefs.hpp>
+#include <zenith/stl/vector.hpp>
+#include <zenith/system/png.hpp>
+
+using zth::u8;
+using zth::u32;
+using zth::usize;
+
+namespace {
+
+auto generate_pixels(glm::uvec2 size) -> zth::Vector<u8>
+{
+    zth::Vector<u8> result;
+
+    for (u32 y = 0; y < size.y; y++)
+    {
+        for (u32 x = 0; x < size.x; x++)
+        {
+            result.insert(result.end(), { static_cast<u8>(x), static_cast<u8>(y), static_cast<u8>(x ^ y),
+                                          static_cast<u8>(255 - x) });
+        }
+    }
+
+    return result;
+}
+
+auto decode(std::span<const u8> png, glm::uvec2 expected_size) -> zth::Vector<u8>
+{
+    int width, height, channels;
+    auto image = stbi_load_from_memory(png.data(), static_cast<int>(png.size()), &width, &height, &channels, 4);
+
+    REQUIRE(image != nullptr);
+    REQUIRE(width == static_cast<int>(expected_size.x));
+    REQUIRE(height == static_cast<int>(expected_size.y));
+    REQUIRE(channels == 4);
+
+    zth::Vector<u8> result{ image, image + static_cast<usize>(width) * static_cast<usize>(height) * 4 };
+    stbi_image_free(image);
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("PNG encoding", "[PNG]")
+{
+    SECTION("File structure")
+    {
+        auto png = zth::encode_png(generate_pixels({ 3, 2 }), { 3, 2 });
+
+        constexpr std::array<u8, 8> signature{ 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+        REQUIRE(std::ranges::equal(std::span{ png }.first(8), signature));
+
+        // The IEND chunk has no data, so its checksum is always the same.
+        constexpr std::array<u8, 12> end_chunk{ 0, 0, 0, 0, 'I', 'E', 'N', 'D', 0xae, 0x42, 0x60, 0x82 };
+        REQUIRE(std::ranges::equal(std::span{ png }.last(12), end_chunk));
+    }
+
+    SECTION("Small image round trip")
+    {
+        glm::uvec2 size{ 3, 2 };
+        auto pixels = generate_pixels(size);
+        REQUIRE(decode(zth::encode_png(pixels, size), size) == pixels);
+    }
+
+    SECTION("Image data spanning multiple deflate blocks")
+    {
+        glm::uvec2 size{ 200, 150 };
+        auto pixels = generate_pixels(size);
+        REQUIRE(decode(zth::encode_png(pixels, size), size) == pixels);
+    }
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <glm/vec3.hpp>
+
+#include <zenith/core/typedefs.hpp>
+#include <zenith/stl/vector.hpp>
+
+struct PositionMesh
+{
+    zth::Vector<glm::vec3> positions;
+    zth::Vector<zth::u32> indices;
+};
+
+// A flat square in the xy plane facing +z, made up of (size - 1)^2 quads.
+inline auto generate_grid(zth::u32 size) -> PositionMesh
+{
+    PositionMesh result;
+
+    for (zth::u32 y = 0; y < size; y++)
+    {
+        for (zth::u32 x = 0; x < size; x++)
+            result.positions.push_back(glm::vec3{ static_cast<float>(x), static_cast<float>(y), 0.0f });
+    }
+
+    for (zth::u32 y = 0; y + 1 < size; y++)
+    {
+        for (zth::u32 x = 0; x + 1 < size; x++)
+        {
+            auto bottom_left = y * size + x;
+            auto bottom_right = bottom_left + 1;
+            auto top_left = bottom_left + size;
+            auto top_right = top_left + 1;
+
+            result.indices.insert(result.indices.end(),
+                                  { bottom_left, bottom_right, top_right, bottom_left, top_right, top_left });
+        }
+    }
+
+    return result;
+}
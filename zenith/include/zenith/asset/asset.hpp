@@ -23,6 +23,7 @@ template<typename T> struct is_asset : std::false_type {};
 template<typename T> constexpr auto is_asset_v = is_asset<T>::value;
 
 template<> struct is_asset<Mesh> : std::true_type {};
+template<> struct is_asset<MeshLod> : std::true_type {};
 template<> struct is_asset<Material> : std::true_type {};
 template<> struct is_asset<gl::Shader> : std::true_type {};
 template<> struct is_asset<gl::Texture2D> : std::true_type {};
@@ -7,4 +7,5 @@
 #include "core/profiler.hpp"
 #include "core/random.hpp"
 #include "core/scene.hpp"
+#include "core/scene_bvh.hpp"
 #include "core/typedefs.hpp"
@@ -5,8 +5,10 @@ namespace zth {
 #if defined(ZTH_PROFILER)
 
 struct ProfilerEntryMarker;
+struct GpuProfilerScope;
 struct ProfilerEntry;
 class ScopeProfiler;
+class GpuScopeProfiler;
 class Profiler;
 
 #endif
@@ -16,4 +18,7 @@ class Random;
 class Scene;
 class SceneManager;
 
+struct SceneRayHit;
+class SceneBvh;
+
 } // namespace zth
@@ -3,6 +3,9 @@
 #if defined(ZTH_PROFILER)
 
 #include "zenith/core/typedefs.hpp"
+#include "zenith/gl/fwd.hpp"
+#include "zenith/memory/managed.hpp"
+#include "zenith/stl/map.hpp"
 #include "zenith/stl/vector.hpp"
 #include "zenith/system/temporary_storage.hpp"
 #include "zenith/util/macros.hpp"
@@ -22,6 +25,11 @@
 // array. Other pairs of opening and closing markers can be added in the meantime. This way the markers create a tree
 // structure of profiler entries. When the time comes to display the entries, the profiler constructs this tree
 // structure out of the marker array.
+//
+// GPU scopes additionally record a pair of timestamp queries around the measured scope. Their results only become
+// available a few frames later, so they're read back in start_frame() once the GPU has finished the frame, without
+// waiting for it unless too many frames are still in flight. GPU times are kept per label and get displayed next to the
+// CPU times of the entries with the same label.
 
 namespace zth {
 
@@ -47,6 +55,13 @@ private:
     static constexpr auto index_value_for_closing_marker = ~static_cast<EntryMarkerIndex>(0);
 };
 
+struct GpuProfilerScope
+{
+    const char* label;
+    u32 start_query;
+    u32 end_query = 0; // 0 while the scope is still open.
+};
+
 struct ProfilerEntry
 {
     const char* label;
@@ -66,18 +81,39 @@ private:
     double _start_time;
 };
 
+class GpuScopeProfiler
+{
+public:
+    explicit GpuScopeProfiler(const char* scope_name);
+    ZTH_NO_COPY_NO_MOVE(GpuScopeProfiler)
+    ~GpuScopeProfiler();
+
+private:
+    ScopeProfiler _cpu_scope_profiler;
+    u32 _scope_index;
+};
+
 class Profiler
 {
 public:
     Profiler() = delete;
 
+    // Frames whose GPU scopes haven't been read back yet. The profiler waits for the GPU if there are more.
+    static constexpr usize max_gpu_frames_in_flight = 4;
+
+public:
     static auto init() -> void;
     static auto start_frame() -> void;
+    static auto shut_down() -> void;
     static auto display(Optional<Reference<bool>> open = nil) -> void;
 
     static auto begin_entry(const char* label) -> void;
     static auto end_entry(double time) -> void;
 
+    // Returns the index of the scope, which has to be passed to end_gpu_scope().
+    [[nodiscard]] static auto begin_gpu_scope(const char* label) -> u32;
+    static auto end_gpu_scope(u32 scope_index) -> void;
+
 private:
     // This is used to get to the corresponding opening marker whenever we end an entry.
     static Vector<EntryMarkerIndex> _opening_marker_index_stack;
@@ -86,11 +122,19 @@ private:
     static Vector<ProfilerEntryMarker> _this_frame_markers;
     static Vector<ProfilerEntryMarker> _last_frame_markers;
 
+    static UniquePtr<gl::TimestampQueryPool> _gpu_query_pool;
+    static Vector<GpuProfilerScope> _this_frame_gpu_scopes;
+    static Vector<Vector<GpuProfilerScope>> _pending_gpu_frames; // The oldest frame comes first.
+    // In seconds. The total GPU time of the scopes with the same label in the most recent frame read back.
+    static UnorderedMap<const char*, double> _gpu_times;
+    static inline u32 _gpu_frames_in_flight = 0;
+
     static inline bool _snapshot = false;
 
 private:
     static auto begin_profile() -> void;
     static auto end_profile() -> void;
+    static auto collect_gpu_times() -> void;
 
     static auto merge_and_display_sub_entries(const TemporaryVector<EntryMarkerIndex>& indices) -> void;
 };
@@ -101,12 +145,17 @@ private:
 
 #define ZTH_PROFILE_SCOPE(scope_name) ::zth::ScopeProfiler ZTH_UNIQUE_NAME(scope_profiler_){ scope_name }
 #define ZTH_PROFILE_FUNCTION() ::zth::ScopeProfiler ZTH_UNIQUE_NAME(scope_profiler_){ __FUNCTION__ }
+// Measure both the CPU time and the GPU time of the scope. Require a current OpenGL context.
+#define ZTH_PROFILE_GPU_SCOPE(scope_name) ::zth::GpuScopeProfiler ZTH_UNIQUE_NAME(gpu_scope_profiler_){ scope_name }
+#define ZTH_PROFILE_GPU_FUNCTION() ::zth::GpuScopeProfiler ZTH_UNIQUE_NAME(gpu_scope_profiler_){ __FUNCTION__ }
 
 // clang-format on
 
 #else
 
-#define ZTH_PROFILE_SCOPE()
+#define ZTH_PROFILE_SCOPE(scope_name)
 #define ZTH_PROFILE_FUNCTION()
+#define ZTH_PROFILE_GPU_SCOPE(scope_name)
+#define ZTH_PROFILE_GPU_FUNCTION()
 
 #endif
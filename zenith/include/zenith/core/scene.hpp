@@ -1,11 +1,20 @@
 #pragma once
 
+#include <glm/vec3.hpp>
+
 #include <concepts>
 #include <functional>
+#include <limits>
 
+#include "zenith/core/scene_bvh.hpp"
 #include "zenith/ecs/ecs.hpp"
+#include "zenith/math/fwd.hpp"
 #include "zenith/memory/managed.hpp"
+#include "zenith/renderer/draw_list.hpp"
+#include "zenith/renderer/occlusion_buffer.hpp"
+#include "zenith/renderer/retained_draw_list.hpp"
 #include "zenith/stl/string.hpp"
+#include "zenith/stl/vector.hpp"
 #include "zenith/system/fwd.hpp"
 #include "zenith/system/temporary_storage.hpp"
 #include "zenith/util/macros.hpp"
@@ -36,14 +45,36 @@ public:
     [[nodiscard]] auto find_entity_by_tag(StringView tag) -> Optional<EntityHandle>;
     [[nodiscard]] auto find_entities_by_tag(StringView tag) -> TemporaryVector<EntityHandle>;
 
+    // Returns the closest entity with a mesh whose world space bounding box the ray hits.
+    [[nodiscard]] auto raycast(const math::Ray& ray, float max_distance = std::numeric_limits<float>::infinity())
+        -> Optional<SceneRayHit>;
+
     [[nodiscard]] auto name() const -> auto& { return _name; }
     [[nodiscard]] auto registry(this auto&& self) -> auto& { return self._registry; }
+    [[nodiscard]] auto bvh(this auto&& self) -> auto& { return self._bvh; }
+    // Holds the occluders rasterized during the last frame in which occlusion culling was enabled.
+    [[nodiscard]] auto occlusion_buffer() const -> auto& { return _occlusion_buffer; }
 
     friend class SceneManager;
 
 private:
     String _name;
     Registry _registry;
+    SceneBvh _bvh;
+
+    // The meshes get recorded into draw lists on the JobSystem, meshes_per_draw_list meshes per draw list. The draw
+    // lists have to stay alive until the renderer finishes rendering the scene, so they're kept around between frames.
+    static constexpr usize meshes_per_draw_list = 256;
+    Vector<EntityId> _meshes_to_render;
+    Vector<DrawList> _draw_lists;
+    Vector<EntityId> _lod_entities;
+
+    // Static meshes with opaque materials get submitted to the retained draw list instead, every frame, so that the
+    // list can tell which of them changed or went away.
+    RetainedDrawList _retained_draw_list;
+
+    OcclusionBuffer _occlusion_buffer;
+    Vector<u8> _occlusion_visibility; // Indexed like _meshes_to_render. Gets written to from multiple threads.
 
 private:
     auto load() -> void;
@@ -58,6 +89,13 @@ private:
     virtual auto on_unload() -> void {}
 
     auto set_up_registry_listeners() -> void;
+    auto select_lod_levels(glm::vec3 camera_position, float fov) -> void;
+    // Removes the meshes hidden behind the occluders from the meshes to render.
+    auto cull_occluded_meshes() -> void;
+    auto record_draw_lists() -> void;
+    // Returns the number of meshes submitted to the retained draw list.
+    auto submit_retained_meshes() -> u32;
+    [[nodiscard]] auto is_retained(EntityId entity_id) const -> bool;
 };
 
 // SceneManager ensures that there is always a scene loaded.
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <concepts>
+#include <limits>
+
+#include "zenith/core/typedefs.hpp"
+#include "zenith/ecs/ecs.hpp"
+#include "zenith/math/bvh.hpp"
+#include "zenith/renderer/fwd.hpp"
+#include "zenith/stl/map.hpp"
+#include "zenith/stl/vector.hpp"
+#include "zenith/util/optional.hpp"
+
+namespace zth {
+
+struct SceneRayHit
+{
+    EntityId entity;
+    float distance; // In multiples of the ray's direction.
+};
+
+// Bounding volume hierarchy over the world space bounding boxes of the entities which have a MeshRendererComponent.
+// Used to cull the meshes hierarchically and to answer ray queries.
+//
+// update() has to be called to pick up the changes made to the registry. It only looks at the entities listed in the
+// registry's transform and mesh renderer change logs, and clears the logs afterwards. Entities whose meshes got added
+// or removed get inserted into or removed from the hierarchy, and the ones whose transforms or meshes changed get
+// updated. The first update after construction or clear() builds the whole hierarchy with the surface area heuristic,
+// which gives a better hierarchy than inserting the entities one by one, so if most of the meshes changed, call
+// rebuild().
+//
+// Meshes with infinite bounds aren't stored in the hierarchy. They're always visible and can't be hit by rays.
+class SceneBvh
+{
+public:
+    explicit SceneBvh() = default;
+
+    auto update(Registry& registry) -> void;
+    auto rebuild(Registry& registry) -> void;
+    auto clear() -> void;
+
+    // Calls on_visible(entity_id) for every entity whose bounds intersect the frustum.
+    template<std::invocable<EntityId> F> auto query(const math::Frustum& frustum, F&& on_visible) const -> void;
+
+    // Returns the closest entity whose bounding box the ray hits.
+    [[nodiscard]] auto raycast(const math::Ray& ray, float max_distance = std::numeric_limits<float>::infinity()) const
+        -> Optional<SceneRayHit>;
+
+    // The number of entities with meshes that the hierarchy knows about, including the ones with infinite bounds.
+    [[nodiscard]] auto entity_count() const -> usize { return _locations.size(); }
+    [[nodiscard]] auto bvh() const -> auto& { return _bvh; }
+
+private:
+    struct Location
+    {
+        u32 index; // The entity's primitive index in the hierarchy, or its index in _unbounded_entities.
+        bool bounded;
+    };
+
+    math::Bvh _bvh;
+    Vector<EntityId> _entities; // Indexed with the hierarchy's primitive indices.
+    Vector<EntityId> _unbounded_entities;
+    UnorderedMap<EntityId, Location> _locations;
+    bool _needs_rebuild = true;
+
+private:
+    // Brings the entity's place in the hierarchy up to date with its components.
+    auto refresh(const Registry& registry, EntityId entity_id) -> void;
+    auto add(EntityId entity_id, const Mesh& mesh, const TransformComponent& transform) -> void;
+    auto remove(EntityId entity_id, Location location) -> void;
+};
+
+template<std::invocable<EntityId> F> auto SceneBvh::query(const math::Frustum& frustum, F&& on_visible) const -> void
+{
+    _bvh.query(frustum, [&](u32 primitive_index) { on_visible(_entities[primitive_index]); });
+
+    for (auto entity_id : _unbounded_entities)
+        on_visible(entity_id);
+}
+
+} // namespace zth
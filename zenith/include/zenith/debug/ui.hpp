@@ -18,6 +18,7 @@
 #include "zenith/core/typedefs.hpp"
 #include "zenith/ecs/ecs.hpp"
 #include "zenith/ecs/fwd.hpp"
+#include "zenith/gl/texture.hpp"
 #include "zenith/math/geometry.hpp"
 #include "zenith/math/quaternion.hpp"
 #include "zenith/memory/managed.hpp"
@@ -225,6 +226,8 @@ auto edit_component(CameraComponent& camera) -> void;
 auto edit_component(LightComponent& light) -> void;
 auto edit_component(SpriteRenderer2DComponent& sprite) -> void;
 auto edit_component(MeshRendererComponent& mesh) -> void;
+auto edit_component(MeshLodComponent& lod) -> void;
+auto edit_component(OccluderComponent& occluder) -> void;
 auto edit_component(MaterialComponent& material) -> void;
 auto edit_component(ScriptComponent& script) -> void;
 
@@ -315,6 +318,12 @@ public:
 
 private:
     u32 _frame_rate_limit = 60;
+
+    u32 _occlusion_buffer_level = 0;
+    Optional<gl::Texture2D> _occlusion_buffer_texture = nil;
+
+private:
+    auto display_occlusion_buffer() -> void;
 };
 
 class ScenePicker
@@ -333,6 +342,8 @@ public:
 
     auto prev_scene() -> void;
     auto next_scene() -> void;
+    // Returns false if there's no scene with the given name.
+    auto select_scene(StringView name) -> bool;
 
 private:
     usize _selected_scene_idx = 0;
@@ -2,5 +2,6 @@
 
 #include "ecs/fwd.hpp"
 
+#include "ecs/change_log.hpp"
 #include "ecs/components.hpp"
 #include "ecs/ecs.hpp"
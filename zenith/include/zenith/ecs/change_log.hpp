@@ -0,0 +1,66 @@
+#pragma once
+
+#include <entt/entity/entity.hpp>
+
+#include <mutex>
+#include <span>
+
+#include "zenith/core/typedefs.hpp"
+#include "zenith/stl/vector.hpp"
+#include "zenith/util/macros.hpp"
+
+namespace zth {
+
+// Lists the entities whose component of some type changed, got added or got removed since the log was last cleared,
+// so that systems which keep data derived from the components only have to look at those entities instead of every
+// entity with the component. An entity whose component changed only gets listed once, but an entity whose component
+// got removed might get listed again, and the listed entities might not exist anymore.
+//
+// Components get modified from multiple threads (e.g. the scene selects the meshes of LODs on the JobSystem), so adding
+// entities to the log is thread-safe. Reading and clearing it isn't.
+class ChangeLog
+{
+public:
+    explicit ChangeLog() = default;
+    ZTH_NO_COPY_NO_MOVE(ChangeLog)
+
+    auto add(entt::entity entity) -> void;
+    auto clear() -> void;
+
+    [[nodiscard]] auto entities() const -> std::span<const entt::entity> { return _entities; }
+    // Gets incremented every time the log gets cleared.
+    [[nodiscard]] auto generation() const -> u32 { return _generation; }
+
+private:
+    Vector<entt::entity> _entities;
+    std::mutex _mutex;
+    u32 _generation = 1;
+};
+
+// Lives inside of a component and adds the component's entity to a ChangeLog when the component changes. The registry
+// attaches it to the log when the component gets added to an entity.
+//
+// A copy of a component belongs to some other entity, so copying a component doesn't copy the tracker. Moving a
+// component moves the tracker along, because that's how the registry moves components around when it packs them,
+// unless the moved component isn't attached to an entity, e.g. when a component gets replaced with a new one.
+class ChangeTracker
+{
+public:
+    ChangeTracker() = default;
+    ChangeTracker(const ChangeTracker&) {}
+    ChangeTracker(ChangeTracker&& other) noexcept = default;
+    ~ChangeTracker() = default;
+
+    auto operator=(const ChangeTracker& other) -> ChangeTracker&;
+    auto operator=(ChangeTracker&& other) noexcept -> ChangeTracker&;
+
+    auto attach(ChangeLog& log, entt::entity entity) -> void;
+    auto mark_changed() -> void;
+
+private:
+    ChangeLog* _log = nullptr;
+    entt::entity _entity = entt::null;
+    u32 _logged_generation = 0; // The generation of the log in which the entity was last added to it.
+};
+
+} // namespace zth
@@ -9,6 +9,7 @@
 #include <memory>
 
 #include "zenith/core/typedefs.hpp"
+#include "zenith/ecs/change_log.hpp"
 #include "zenith/gl/fwd.hpp"
 #include "zenith/math/geometry.hpp"
 #include "zenith/math/quaternion.hpp"
@@ -39,7 +40,7 @@ struct TagComponent
 
 // --------------------------- TransformComponent ---------------------------
 
-// TransformComponent is integral for every entity.
+// TransformComponent is integral for every entity. Changes to it get listed in the registry's transform change log.
 class TransformComponent
 {
 public:
@@ -98,6 +99,13 @@ public:
     [[nodiscard]] auto up() const -> glm::vec3;
 
     [[nodiscard]] auto transform() const -> auto& { return _transform; }
+    // False if the transform was set straight from a matrix, which might contain shear that the translation, the
+    // rotation and the scale don't capture.
+    [[nodiscard]] auto is_composed() const { return _composed; }
+    // Changes every time the transform changes, so that systems which cache data derived from it (e.g.
+    // RetainedDrawList) can tell when it has to be recomputed. Versions are unique across every transform, so a
+    // transform which replaces another one never ends up with the same version as the old one had.
+    [[nodiscard]] auto version() const { return _version; }
 
     [[nodiscard]] static auto display_label() -> const char*;
 
@@ -110,8 +118,16 @@ private:
     glm::quat _rotation{ glm::identity<glm::quat>() };
     glm::vec3 _scale{ 1.0f };
 
+    u64 _version = next_version();
+    bool _composed = true;
+
+    ChangeTracker _change_tracker;
+
+    friend class Registry;
+
 private:
     auto update_transform() -> void;
+    [[nodiscard]] static auto next_version() -> u64;
 };
 
 // --------------------------- ScriptComponent ---------------------------
@@ -157,18 +173,73 @@ private:
 
 // --------------------------- MeshRendererComponent ---------------------------
 
+// Static meshes with opaque materials get rendered from the scene's retained draw list, which keeps their instance
+// data on the GPU between frames and only uploads it again when their transforms change. They only get culled
+// together with the other static meshes which use the same mesh and material.
+//
+// Changes to it get listed in the registry's mesh renderer change log.
 class MeshRendererComponent
 {
 public:
-    explicit MeshRendererComponent(std::shared_ptr<const Mesh> mesh = meshes::cube());
+    explicit MeshRendererComponent(std::shared_ptr<const Mesh> mesh = meshes::cube(), bool is_static = false);
 
     auto set_mesh(std::shared_ptr<const Mesh> mesh) -> void;
     [[nodiscard]] auto mesh() const -> const std::shared_ptr<const Mesh>&;
 
+    auto set_static(bool is_static) -> void;
+    [[nodiscard]] auto is_static() const -> bool { return _static; }
+
     [[nodiscard]] static auto display_label() -> const char*;
 
 private:
     std::shared_ptr<const Mesh> _mesh = meshes::cube(); // mesh cannot be null.
+    bool _static = false;
+
+    ChangeTracker _change_tracker;
+
+    friend class Registry;
+};
+
+// --------------------------- MeshLodComponent ---------------------------
+
+// Every frame, the scene picks the level of the LOD which suits how big the entity appears on the screen and puts its
+// mesh into the entity's MeshRendererComponent. A null LOD leaves the MeshRendererComponent alone.
+class MeshLodComponent
+{
+public:
+    explicit MeshLodComponent(std::shared_ptr<const MeshLod> lod = nullptr);
+
+    auto set_lod(std::shared_ptr<const MeshLod> lod) -> void;
+    [[nodiscard]] auto lod() const -> const std::shared_ptr<const MeshLod>&;
+
+    // Picks a level for a mesh which covers screen_size of the screen's height, taking the level that was picked the
+    // last time into account. Returns the level's mesh. The LOD mustn't be null.
+    auto select_level(float screen_size, float hysteresis) -> const std::shared_ptr<const Mesh>&;
+    [[nodiscard]] auto current_level() const { return _current_level; }
+
+    [[nodiscard]] static auto display_label() -> const char*;
+
+private:
+    std::shared_ptr<const MeshLod> _lod;
+    u32 _current_level = 0;
+};
+
+// --------------------------- OccluderComponent ---------------------------
+
+// The occluder gets rasterized into the scene's occlusion buffer with the entity's transform, so that the meshes behind
+// it can be culled. A null occluder doesn't hide anything.
+class OccluderComponent
+{
+public:
+    explicit OccluderComponent(std::shared_ptr<const OccluderMesh> occluder = nullptr);
+
+    auto set_occluder(std::shared_ptr<const OccluderMesh> occluder) -> void;
+    [[nodiscard]] auto occluder() const -> const std::shared_ptr<const OccluderMesh>&;
+
+    [[nodiscard]] static auto display_label() -> const char*;
+
+private:
+    std::shared_ptr<const OccluderMesh> _occluder;
 };
 
 // --------------------------- MaterialComponent ---------------------------
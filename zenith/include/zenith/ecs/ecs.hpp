@@ -8,6 +8,7 @@
 #include <utility>
 
 #include "zenith/core/typedefs.hpp"
+#include "zenith/ecs/change_log.hpp"
 #include "zenith/ecs/fwd.hpp"
 #include "zenith/log/format.hpp"
 #include "zenith/stl/string.hpp"
@@ -148,7 +149,7 @@ public:
 class Registry
 {
 public:
-    explicit Registry() = default;
+    explicit Registry();
     ZTH_NO_COPY_NO_MOVE(Registry) // Moving the registry would invalidate the references that listener adapters hold.
     ~Registry();
 
@@ -214,10 +215,23 @@ public:
 
     template<typename... Components> auto sort() -> void;
 
+    // The entities whose TransformComponent or MeshRendererComponent changed, got added or got removed since the log
+    // was last cleared. The scene's SceneBvh clears them whenever it catches up with the changes.
+    [[nodiscard]] auto transform_changes() -> ChangeLog& { return _transform_changes; }
+    [[nodiscard]] auto mesh_renderer_changes() -> ChangeLog& { return _mesh_renderer_changes; }
+
 private:
+    // Declared before the registry, so that they outlive the components which refer to them.
+    ChangeLog _transform_changes;
+    ChangeLog _mesh_renderer_changes;
+
     entt::registry _registry;
 
 private:
+    template<typename Component> auto track_changes(ChangeLog& log) -> void;
+    template<typename Component>
+    static auto attach_change_tracker(ChangeLog& log, entt::registry& registry, entt::entity entity) -> void;
+    static auto log_removal(ChangeLog& log, entt::registry& registry, entt::entity entity) -> void;
     template<auto Listener>
         requires(std::invocable<decltype(Listener), Registry&, EntityId>)
     auto listener_adapter(entt::registry& registry, entt::entity entity) -> void;
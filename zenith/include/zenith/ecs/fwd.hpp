@@ -7,6 +7,8 @@ class TransformComponent;
 class ScriptComponent;
 class SpriteRenderer2DComponent;
 class MeshRendererComponent;
+class MeshLodComponent;
+class OccluderComponent;
 class MaterialComponent;
 struct CameraComponent;
 class LightComponent;
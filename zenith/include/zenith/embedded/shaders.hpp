@@ -7,6 +7,9 @@
 namespace zth::embedded::shaders {
 
 extern const StringView defines_glsl;
+extern const StringView lighting_glsl;
+extern const StringView vertex_glsl;
+extern const StringView standard_vertex_glsl;
 
 extern const StringView fallback_vert;
 extern const StringView fallback_frag;
@@ -14,7 +17,13 @@ extern const StringView flat_color_vert;
 extern const StringView flat_color_frag;
 extern const StringView standard_vert;
 extern const StringView standard_frag;
+extern const StringView standard_compact_vert;
 extern const StringView texture_2d_vert;
 extern const StringView texture_2d_frag;
+extern const StringView deferred_geometry_frag;
+extern const StringView deferred_lighting_vert;
+extern const StringView deferred_lighting_frag;
+extern const StringView depth_only_vert;
+extern const StringView depth_only_frag;
 
 } // namespace zth::embedded::shaders
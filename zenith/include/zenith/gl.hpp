@@ -4,7 +4,11 @@
 
 #include "gl/buffer.hpp"
 #include "gl/context.hpp"
+#include "gl/framebuffer.hpp"
+#include "gl/gpu_timer.hpp"
+#include "gl/program_cache.hpp"
 #include "gl/shader.hpp"
+#include "gl/state_cache.hpp"
 #include "gl/texture.hpp"
 #include "gl/util.hpp"
 #include "gl/vertex_array.hpp"
@@ -2,6 +2,7 @@
 
 #include <glad/glad.h>
 
+#include <array>
 #include <ranges>
 #include <span>
 #include <type_traits>
@@ -9,6 +10,7 @@
 #include "zenith/core/typedefs.hpp"
 #include "zenith/gl/util.hpp"
 #include "zenith/gl/vertex_layout.hpp"
+#include "zenith/memory/managed.hpp"
 #include "zenith/util/macros.hpp"
 #include "zenith/util/optional.hpp"
 
@@ -57,8 +59,58 @@ struct BufferUsage
 enum class BufferState : u8
 {
     Uninitialized,
-    InitializedStatic,  // Buffer cannot be reinitialized, size cannot be changed and cannot be 0.
-    InitializedDynamic, // Buffer can be reinitialized, size can be changed.
+    InitializedStatic,    // Buffer cannot be reinitialized, size cannot be changed and cannot be 0.
+    InitializedDynamic,   // Buffer can be reinitialized, size can be changed.
+    InitializedStreaming, // Buffer is persistently mapped and split into regions. The CPU writes to one region while
+                          // the GPU reads from the other ones. Buffer cannot be reinitialized, size cannot be changed.
+};
+
+struct StreamingAllocation
+{
+    std::span<byte> data; // Persistently mapped memory which can be written to directly.
+    u32 offset;           // Offset from the start of the buffer.
+};
+
+struct StreamingBufferStats
+{
+    u32 bytes_streamed = 0;
+    u32 regions_entered = 0;
+    u32 fence_waits = 0;          // How many times we had to wait for the GPU to finish reading from a region.
+    double fence_wait_time = 0.0; // Total time spent waiting for the GPU, in seconds.
+};
+
+// Keeps track of which region of a streaming buffer is being written to and how much of it is used. Doesn't touch
+// OpenGL, fencing the regions is up to the buffer.
+class StreamingRegions
+{
+public:
+    explicit StreamingRegions(u32 region_size_bytes, u32 region_count);
+
+    // Returns the offset from the start of the buffer at which an allocation would start in what's left of the current
+    // region, or nil if it doesn't fit there. The offset is aligned to alignment, which doesn't have to be a power of
+    // two.
+    [[nodiscard]] auto offset_in_current_region(u32 size_bytes, u32 alignment) const -> Optional<u32>;
+    // Like offset_in_current_region(), but for an allocation at the start of the next region.
+    [[nodiscard]] auto offset_in_next_region(u32 size_bytes, u32 alignment) const -> Optional<u32>;
+
+    // The allocation has to come from offset_in_current_region().
+    auto allocate(u32 offset, u32 size_bytes) -> void;
+    auto next_region() -> void;
+
+    [[nodiscard]] auto region_size_bytes() const { return _region_size_bytes; }
+    [[nodiscard]] auto region_count() const { return _region_count; }
+    [[nodiscard]] auto current_region() const { return _current_region; }
+    [[nodiscard]] auto current_region_offset() const { return _current_region_offset; } // Bytes used.
+
+private:
+    u32 _region_size_bytes;
+    u32 _region_count;
+    u32 _current_region = 0;
+    u32 _current_region_offset = 0;
+
+private:
+    [[nodiscard]] auto offset_in_region(u32 region, u32 region_offset, u32 size_bytes, u32 alignment) const
+        -> Optional<u32>;
 };
 
 // --------------------------- Buffer ---------------------------
@@ -68,6 +120,9 @@ class Buffer
 public:
     using BufferId = GLuint;
 
+    static constexpr u32 default_streaming_region_count = 3;
+    static constexpr u32 max_streaming_region_count = 8;
+
 public:
     explicit Buffer();
 
@@ -93,6 +148,9 @@ public:
     [[nodiscard]] static auto create_dynamic_with_data(std::ranges::contiguous_range auto&& data,
                                                        BufferUsage usage = BufferUsage::dynamic_draw) -> Buffer;
 
+    [[nodiscard]] static auto create_streaming(u32 region_size_bytes,
+                                               u32 region_count = default_streaming_region_count) -> Buffer;
+
     Buffer(const Buffer& other);
     auto operator=(const Buffer& other) -> Buffer&;
 
@@ -120,6 +178,8 @@ public:
     auto init_dynamic_with_data(std::ranges::contiguous_range auto&& data,
                                 BufferUsage usage = BufferUsage::dynamic_draw) -> void;
 
+    auto init_streaming(u32 region_size_bytes, u32 region_count = default_streaming_region_count) -> void;
+
     // Returns the number of bytes written.
     auto buffer_data(std::span<const byte> data, u32 offset = 0) -> u32;
     // Returns the number of bytes written.
@@ -141,20 +201,44 @@ public:
     auto clear() -> void;
     auto free() noexcept -> void;
 
+    // Sub-allocates memory from the current region of a streaming buffer. If the allocation doesn't fit into what's
+    // left of the current region, we move on to the next one. Returns nil if the allocation is bigger than a whole
+    // region. The offset of the allocation is aligned to alignment relative to the start of the buffer.
+    [[nodiscard]] auto allocate_streaming(u32 size_bytes, u32 alignment = 1) -> Optional<StreamingAllocation>;
+    // Returns true if the allocation fits into what's left of the current region, i.e. allocating it wouldn't make us
+    // move on to the next region.
+    [[nodiscard]] auto fits_in_streaming_region(u32 size_bytes, u32 alignment = 1) const -> bool;
+    // Fences the current region of a streaming buffer and moves on to the next one, waiting for the GPU to finish
+    // reading from it if necessary. Should be called at the start of every frame.
+    auto next_streaming_region() -> void;
+    auto reset_streaming_stats() -> void;
+
     [[nodiscard]] auto native_handle() const { return _id; }
     [[nodiscard]] auto size_bytes() const { return _size_bytes; }
     [[nodiscard]] auto capacity_bytes() const { return _capacity_bytes; }
     [[nodiscard]] auto is_static() const { return _state == BufferState::InitializedStatic; }
     [[nodiscard]] auto is_dynamic() const { return _state == BufferState::InitializedDynamic; }
+    [[nodiscard]] auto is_streaming() const { return _state == BufferState::InitializedStreaming; }
     [[nodiscard]] auto is_initialized() const { return _state != BufferState::Uninitialized; }
     [[nodiscard]] auto state() const { return _state; }
+    [[nodiscard]] auto streaming_region_size_bytes() const -> u32;
+    [[nodiscard]] auto streaming_stats() const -> StreamingBufferStats;
 
 private:
+    struct StreamingState
+    {
+        byte* mapped_memory = nullptr;
+        StreamingRegions regions;
+        std::array<GLsync, max_streaming_region_count> region_fences{};
+        StreamingBufferStats stats{};
+    };
+
     BufferId _id = GL_NONE;
     u32 _size_bytes = 0;
     u32 _capacity_bytes = 0;
     BufferState _state = BufferState::Uninitialized;
     Optional<BufferUsage> _usage = nil;
+    UniquePtr<StreamingState> _streaming_state = nullptr; // Only allocated for streaming buffers.
 
 private:
     auto create() noexcept -> void;
@@ -165,6 +249,9 @@ private:
     auto buffer_data_static(std::span<const byte> data, u32 offset) -> u32;
     auto buffer_data_dynamic(std::span<const byte> data, u32 offset) -> u32;
 
+    auto wait_for_streaming_region(u32 region) -> void;
+    auto free_streaming_state() noexcept -> void;
+
     auto reallocate_exactly(u32 new_capacity_bytes) -> void;
     auto reallocate_at_least(u32 min_capacity_bytes) -> void;
 
@@ -205,6 +292,10 @@ public:
                                                        const VertexLayout& layout = derive_vertex_layout<V>())
         -> VertexBuffer;
 
+    [[nodiscard]] static auto create_streaming(u32 region_size_bytes, const VertexLayout& layout,
+                                               u32 region_count = Buffer::default_streaming_region_count)
+        -> VertexBuffer;
+
     ZTH_DEFAULT_COPY_DEFAULT_MOVE(VertexBuffer)
 
     ~VertexBuffer() = default;
@@ -228,6 +319,9 @@ public:
     auto init_dynamic_with_data(V&& vertices, BufferUsage usage = BufferUsage::dynamic_draw,
                                 const VertexLayout& layout = derive_vertex_layout<V>()) -> void;
 
+    auto init_streaming(u32 region_size_bytes, const VertexLayout& layout,
+                        u32 region_count = Buffer::default_streaming_region_count) -> void;
+
     auto buffer_data(std::span<const byte> data, u32 offset = 0) -> u32;
     auto buffer_data(VertexRange auto&& vertices, u32 offset = 0) -> u32;
 
@@ -241,6 +335,19 @@ public:
     auto clear() -> void { _buffer.clear(); }
     auto free() noexcept -> void;
 
+    [[nodiscard]] auto allocate_streaming(u32 size_bytes, u32 alignment = 1) -> Optional<StreamingAllocation>
+    {
+        return _buffer.allocate_streaming(size_bytes, alignment);
+    }
+
+    [[nodiscard]] auto fits_in_streaming_region(u32 size_bytes, u32 alignment = 1) const -> bool
+    {
+        return _buffer.fits_in_streaming_region(size_bytes, alignment);
+    }
+
+    auto next_streaming_region() -> void { _buffer.next_streaming_region(); }
+    auto reset_streaming_stats() -> void { _buffer.reset_streaming_stats(); }
+
     auto bind() const -> void;
     static auto unbind() -> void;
 
@@ -252,8 +359,11 @@ public:
     [[nodiscard]] auto capacity_bytes() const { return _buffer.capacity_bytes(); }
     [[nodiscard]] auto is_static() const { return _buffer.is_static(); }
     [[nodiscard]] auto is_dynamic() const { return _buffer.is_dynamic(); }
+    [[nodiscard]] auto is_streaming() const { return _buffer.is_streaming(); }
     [[nodiscard]] auto is_initialized() const { return _buffer.is_initialized(); }
     [[nodiscard]] auto state() const { return _buffer.state(); }
+    [[nodiscard]] auto streaming_region_size_bytes() const { return _buffer.streaming_region_size_bytes(); }
+    [[nodiscard]] auto streaming_stats() const { return _buffer.streaming_stats(); }
     [[nodiscard]] auto layout() const -> auto& { return _layout; }
     [[nodiscard]] auto stride() const { return _layout.stride(); }
     [[nodiscard]] auto count() const -> u32;
@@ -387,6 +497,10 @@ public:
                                                        const VertexLayout& layout = derive_vertex_layout<V>())
         -> InstanceBuffer;
 
+    [[nodiscard]] static auto create_streaming(u32 region_size_bytes, const VertexLayout& layout,
+                                               u32 region_count = Buffer::default_streaming_region_count)
+        -> InstanceBuffer;
+
     ZTH_DEFAULT_COPY_DEFAULT_MOVE(InstanceBuffer)
 
     ~InstanceBuffer() = default;
@@ -574,6 +688,8 @@ public:
 
     auto bind() const -> void;
     auto bind(u32 binding_point) const -> void;
+    // offset must be a multiple of Context::ssbo_offset_alignment().
+    auto bind_range(u32 binding_point, u32 offset, u32 size_bytes) const -> void;
     static auto unbind() -> void;
 
     [[nodiscard]] auto native_handle() const { return _buffer.native_handle(); }
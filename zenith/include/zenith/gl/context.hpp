@@ -45,6 +45,15 @@ public:
     [[nodiscard]] static auto forward_compatible_context() { return _forward_compatible_context; }
     [[nodiscard]] static auto debug_context() { return _debug_context; }
 
+    [[nodiscard]] static auto ssbo_offset_alignment() { return _ssbo_offset_alignment; }
+    // Zero if the driver can't save linked programs with glGetProgramBinary.
+    [[nodiscard]] static auto program_binary_formats() { return _program_binary_formats; }
+    // Whether GL_KHR_parallel_shader_compile (or its ARB twin) is supported, which lets the driver compile and link on
+    // its own threads and report GL_COMPLETION_STATUS_KHR without blocking.
+    [[nodiscard]] static auto parallel_shader_compile() { return _parallel_shader_compile; }
+
+    [[nodiscard]] static auto extension_supported(StringView name) -> bool;
+
 private:
     static inline const char* _vendor_string = nullptr;
     static inline const char* _renderer_string = nullptr;
@@ -56,8 +65,13 @@ private:
     static inline bool _forward_compatible_context;
     static inline bool _debug_context;
 
+    static inline u32 _ssbo_offset_alignment = 256; // The largest value that the spec allows.
+    static inline u32 _program_binary_formats = 0;
+    static inline bool _parallel_shader_compile = false;
+
 private:
     static auto retrieve_context_variables() -> void;
+    static auto set_up_parallel_shader_compile() -> void;
     static auto log_context_info() -> void; // log_context_info needs context variables to be retrieved first.
 };
 
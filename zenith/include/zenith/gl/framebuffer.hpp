@@ -0,0 +1,56 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+
+#include <span>
+
+#include "zenith/core/typedefs.hpp"
+#include "zenith/gl/fwd.hpp"
+#include "zenith/stl/vector.hpp"
+#include "zenith/util/macros.hpp"
+
+namespace zth::gl {
+
+// A framebuffer which renders into textures. The attachments aren't owned by the framebuffer, so they have to outlive
+// it. Color attachment i gets written by the fragment shader's output at location i.
+class Framebuffer
+{
+public:
+    using FramebufferId = GLuint;
+
+    [[nodiscard]] static auto create(std::span<const Texture2D* const> color_attachments,
+                                     const Texture2D* depth_attachment = nullptr) -> Framebuffer;
+
+    ZTH_NO_COPY(Framebuffer)
+
+    Framebuffer(Framebuffer&& other) noexcept;
+    auto operator=(Framebuffer&& other) noexcept -> Framebuffer&;
+
+    ~Framebuffer();
+
+    auto bind() const -> void;
+    static auto bind_default() -> void;
+
+    // Reads back the color of the default framebuffer's back buffer as 8-bit RGBA pixels, starting from the top row.
+    // Stalls until the GPU finishes rendering.
+    [[nodiscard]] static auto read_default_pixels(glm::uvec2 size) -> Vector<u8>;
+
+    auto clear_color(u32 attachment, glm::vec4 color) const -> void;
+    auto clear_color(u32 attachment, glm::uvec4 value) const -> void; // For attachments with integer formats.
+    auto clear_depth(float depth = 1.0f) const -> void;
+
+    [[nodiscard]] auto complete() const -> bool;
+    [[nodiscard]] auto native_handle() const { return _id; }
+
+private:
+    FramebufferId _id = GL_NONE;
+
+private:
+    explicit Framebuffer(std::span<const Texture2D* const> color_attachments, const Texture2D* depth_attachment);
+
+    auto destroy() const noexcept -> void;
+};
+
+} // namespace zth::gl
@@ -8,6 +8,9 @@ enum class BufferAccessFrequency : u8;
 enum class BufferAccessType : u8;
 struct BufferUsage;
 enum class BufferState : u8;
+struct StreamingAllocation;
+struct StreamingBufferStats;
+class StreamingRegions;
 class Buffer;
 class VertexBuffer;
 class IndexBuffer;
@@ -15,10 +18,25 @@ class InstanceBuffer;
 class UniformBuffer;
 class ShaderStorageBuffer;
 
+class Framebuffer;
+
+class GpuTimer;
+class SampleCounter;
+class TimestampQueryPool;
+
+struct ProgramStage;
+struct ProgramBinary;
+struct ProgramCacheStats;
+class ProgramCache;
+
 struct Version;
 enum class Profile : u8;
 class Context;
 
+enum class Capability : u8;
+struct StateCacheStats;
+class StateCache;
+
 enum class ShaderType : u16;
 struct ShaderSources;
 struct ShaderSourcePaths;
@@ -36,6 +54,7 @@ struct TextureParams;
 class Texture2D;
 
 struct VertexArrayLayout;
+struct VertexPositionTransform;
 class VertexArray;
 
 enum class VertexLayoutElement : u8;
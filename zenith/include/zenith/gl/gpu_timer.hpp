@@ -0,0 +1,121 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <array>
+
+#include "zenith/core/typedefs.hpp"
+#include "zenith/stl/vector.hpp"
+#include "zenith/util/macros.hpp"
+#include "zenith/util/optional.hpp"
+
+namespace zth::gl {
+
+// Measures how long the GPU takes to execute the commands issued between begin() and end(). The results arrive a few
+// frames late, so the timer keeps a small ring of timestamp queries in flight and never waits for the GPU unless every
+// one of them is still pending.
+class GpuTimer
+{
+public:
+    static constexpr usize max_queries_in_flight = 4;
+
+public:
+    explicit GpuTimer();
+
+    ZTH_NO_COPY(GpuTimer)
+
+    GpuTimer(GpuTimer&& other) noexcept;
+    auto operator=(GpuTimer&& other) noexcept -> GpuTimer&;
+
+    ~GpuTimer();
+
+    auto begin() -> void;
+    auto end() -> void;
+
+    // In seconds. The most recent measurement that the GPU has finished, or nil if there hasn't been any yet.
+    [[nodiscard]] auto last_elapsed_time() -> Optional<double>;
+
+private:
+    struct QueryPair
+    {
+        GLuint start = GL_NONE;
+        GLuint end = GL_NONE;
+    };
+
+    std::array<QueryPair, max_queries_in_flight> _queries;
+    usize _next_query = 0;
+    usize _pending_queries = 0;
+    bool _running = false;
+    Optional<double> _last_elapsed_time = nil;
+
+private:
+    // Returns false if the result isn't available yet and wait is false.
+    auto collect_oldest(bool wait) -> bool;
+    auto destroy() const noexcept -> void;
+};
+
+// Counts the samples which pass the depth test while the commands issued between begin() and end() execute. Like the
+// GpuTimer, it keeps a small ring of queries in flight, so the counts arrive a few frames late. Counters can't be
+// nested.
+class SampleCounter
+{
+public:
+    static constexpr usize max_queries_in_flight = 4;
+
+public:
+    explicit SampleCounter();
+
+    ZTH_NO_COPY(SampleCounter)
+
+    SampleCounter(SampleCounter&& other) noexcept;
+    auto operator=(SampleCounter&& other) noexcept -> SampleCounter&;
+
+    ~SampleCounter();
+
+    auto begin() -> void;
+    auto end() -> void;
+
+    // The most recent count that the GPU has finished, or nil if there hasn't been any yet.
+    [[nodiscard]] auto last_sample_count() -> Optional<u64>;
+
+private:
+    std::array<GLuint, max_queries_in_flight> _queries{};
+    usize _next_query = 0;
+    usize _pending_queries = 0;
+    bool _running = false;
+    Optional<u64> _last_sample_count = nil;
+
+private:
+    // Returns false if the result isn't available yet and wait is false.
+    auto collect_oldest(bool wait) -> bool;
+    auto destroy() const noexcept -> void;
+};
+
+// Hands out timestamp queries for timing any number of GPU scopes per frame. Timestamps are used instead of
+// GL_TIME_ELAPSED queries because elapsed time queries can't be nested. A query goes back to the pool once its result
+// has been read.
+class TimestampQueryPool
+{
+public:
+    explicit TimestampQueryPool() = default;
+
+    ZTH_NO_COPY_NO_MOVE(TimestampQueryPool)
+
+    ~TimestampQueryPool();
+
+    // Records the GPU's time once every command issued before it has been executed.
+    [[nodiscard]] auto record_timestamp() -> GLuint;
+    auto release(GLuint query) -> void;
+
+    [[nodiscard]] static auto result_available(GLuint query) -> bool;
+    // In nanoseconds. Waits for the result if it isn't available yet.
+    [[nodiscard]] static auto result(GLuint query) -> u64;
+
+    [[nodiscard]] auto query_count() const -> usize { return _queries.size(); }
+
+private:
+    Vector<GLuint> _queries;
+    Vector<GLuint> _free_queries;
+};
+
+} // namespace zth::gl
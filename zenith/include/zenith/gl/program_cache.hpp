@@ -0,0 +1,81 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <filesystem>
+#include <span>
+
+#include "zenith/core/typedefs.hpp"
+#include "zenith/stl/string.hpp"
+#include "zenith/stl/vector.hpp"
+#include "zenith/util/optional.hpp"
+
+namespace zth::gl {
+
+enum class ShaderType : u16;
+
+struct ProgramStage
+{
+    ShaderType type;
+    StringView source; // Preprocessed.
+};
+
+struct ProgramBinary
+{
+    GLenum format;
+    std::span<const byte> binary;
+};
+
+struct ProgramCacheStats
+{
+    u32 hits = 0;
+    u32 misses = 0;
+    u32 rejected = 0; // Misses which found a binary that couldn't be used, e.g. after a driver update.
+    u32 stored = 0;
+};
+
+// Identifies a program by the preprocessed sources of its stages and by the driver which compiled it, so that editing
+// a shader or updating the driver makes the program miss the cache instead of loading a stale binary.
+[[nodiscard]] auto program_cache_key(std::span<const ProgramStage> stages, StringView driver) -> u64;
+
+// A cache entry is a small header followed by the binary returned by glGetProgramBinary.
+[[nodiscard]] auto encode_program_binary(u64 key, ProgramBinary binary) -> Vector<byte>;
+// Returns nil if the entry is truncated, corrupted or belongs to a different key.
+[[nodiscard]] auto decode_program_binary(std::span<const byte> entry, u64 key) -> Optional<ProgramBinary>;
+
+// Keeps linked program binaries on disk, one file per program, so that later runs can skip compiling and linking
+// shaders which haven't changed. A binary which the driver rejects gets deleted and the program is compiled from source
+// again. Entries of programs which changed are never read again but aren't cleaned up either.
+class ProgramCache
+{
+public:
+    static constexpr auto default_directory = "shader_cache";
+
+public:
+    ProgramCache() = delete;
+
+    // Nil disables the cache.
+    static auto set_directory(const Optional<std::filesystem::path>& directory) -> void;
+
+    // Programs which are going to be stored have to be linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT set.
+    [[nodiscard]] static auto enabled() -> bool;
+    [[nodiscard]] static auto directory() -> const Optional<std::filesystem::path>& { return _directory; }
+
+    // Must be called with a current context, as the key includes the driver's vendor, renderer and version strings.
+    [[nodiscard]] static auto key(std::span<const ProgramStage> stages) -> u64;
+
+    // Returns a linked program or nil if there was nothing usable in the cache.
+    [[nodiscard]] static auto load(u64 key) -> Optional<GLuint>;
+    static auto store(u64 key, GLuint program) -> void;
+
+    [[nodiscard]] static auto stats() -> const ProgramCacheStats& { return _stats; }
+
+private:
+    static inline Optional<std::filesystem::path> _directory = default_directory;
+    static inline ProgramCacheStats _stats;
+
+private:
+    [[nodiscard]] static auto entry_path(u64 key) -> std::filesystem::path;
+};
+
+} // namespace zth::gl
@@ -7,6 +7,7 @@
 #include <glm/vec4.hpp>
 
 #include <filesystem>
+#include <span>
 
 #include "zenith/core/typedefs.hpp"
 #include "zenith/log/logger.hpp"
@@ -66,6 +67,9 @@ public:
     explicit Shader(const ShaderSourcePaths& paths);
 
     [[nodiscard]] static auto from_sources(const ShaderSources& sources) -> Shader;
+    // Starts compiling every program before waiting for any of them, which lets drivers supporting
+    // GL_KHR_parallel_shader_compile compile them all at once. Programs which are in the ProgramCache skip compilation.
+    [[nodiscard]] static auto from_sources(std::span<const ShaderSources> sources) -> Vector<Shader>;
     [[nodiscard]] static auto from_files(const ShaderSourcePaths& paths) -> Shader;
 
     ZTH_NO_COPY(Shader)
@@ -75,18 +79,28 @@ public:
 
     ~Shader();
 
-    auto bind() const -> void { glUseProgram(_id); }
-    static auto unbind() -> void { glUseProgram(GL_NONE); }
+    auto bind() const -> void;
+    static auto unbind() -> void;
 
     auto set_unif(StringView name, const auto& val) const -> void;
 
     [[nodiscard]] auto native_handle() const { return _id; }
 
+private:
+    struct PreprocessedStage
+    {
+        ShaderType type;
+        String source;
+    };
+
 private:
     ProgramId _id = GL_NONE;
     UnorderedMap<String, UniformInfo> _uniform_map;
 
 private:
+    // Switches to the fallback program if there's no program.
+    explicit Shader(Optional<ProgramId> program);
+
     auto retrieve_unif_info() -> void;
     [[nodiscard]] auto get_unif_info(StringView name) const -> Optional<UniformInfo>;
     [[nodiscard]] auto get_unif_location(StringView name) const -> Optional<GLint>;
@@ -98,15 +112,14 @@ private:
     static auto set_unif(GLint location, glm::vec4 val) -> void;
     static auto set_unif(GLint location, const glm::mat4& val) -> void;
 
-    [[nodiscard]] static auto create_shaders_from_sources(const ShaderSources& sources)
-        -> Optional<InPlaceVector<ShaderId, 5>>;
-    [[nodiscard]] static auto create_shader(StringView source, ShaderType type) -> Optional<ShaderId>;
-    [[nodiscard]] static auto compile_shader(ShaderId id, ShaderType type) -> bool;
+    [[nodiscard]] static auto preprocess_stages(const ShaderSources& sources)
+        -> Optional<InPlaceVector<PreprocessedStage, 5>>;
+    [[nodiscard]] static auto check_compile_status(ShaderId id, ShaderType type) -> bool;
+    [[nodiscard]] static auto check_link_status(ProgramId id) -> bool;
 
+    [[nodiscard]] static auto create_programs(std::span<const ShaderSources> sources) -> Vector<Optional<ProgramId>>;
     [[nodiscard]] static auto create_program_from_sources(const ShaderSources& sources) -> Optional<ProgramId>;
     [[nodiscard]] static auto create_program_from_files(const ShaderSourcePaths& paths) -> Optional<ProgramId>;
-    [[nodiscard]] static auto create_program(const InPlaceVector<ShaderId, 5>& shaders) -> Optional<ProgramId>;
-    [[nodiscard]] static auto link_program(ProgramId id) -> bool;
 
     static auto delete_shaders(const InPlaceVector<ShaderId, 5>& shaders) -> void;
 
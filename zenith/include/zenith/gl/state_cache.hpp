@@ -0,0 +1,132 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <array>
+#include <limits>
+
+#include "zenith/core/typedefs.hpp"
+#include "zenith/util/optional.hpp"
+
+namespace zth::gl {
+
+enum class Capability : u8
+{
+    Blend,
+    DepthTest,
+    CullFace,
+    Multisample,
+    StencilTest,
+    ScissorTest,
+};
+
+struct StateCacheStats
+{
+    u32 calls_issued = 0;
+    u32 calls_elided = 0; // Calls which wouldn't have changed anything, so they never reached the driver.
+
+    // Issued calls only.
+    u32 program_binds = 0;
+    u32 vertex_array_binds = 0;
+    u32 texture_binds = 0;
+};
+
+// Shadows the parts of OpenGL's state which change the most often while rendering, so that calls which wouldn't change
+// anything can be skipped. Every bind in the gl layer goes through it, so code which changes the same state by calling
+// OpenGL directly and doesn't restore it afterwards has to call invalidate().
+//
+// The element array buffer binding isn't cached, as it's a part of the bound vertex array's state.
+class StateCache
+{
+public:
+    StateCache() = delete;
+
+    static auto init() -> void;
+    static auto start_frame() -> void;
+
+    // Forgets everything that the cache knows, so that the next calls get issued no matter what.
+    static auto invalidate() -> void;
+
+    static auto use_program(GLuint program) -> void;
+    static auto bind_vertex_array(GLuint vertex_array) -> void;
+    // Binds the framebuffer for both drawing and reading.
+    static auto bind_framebuffer(GLuint framebuffer) -> void;
+    static auto bind_texture_unit(u32 unit, GLuint texture) -> void;
+    static auto bind_buffer(GLenum target, GLuint buffer) -> void;
+    // Also binds the buffer to the generic binding point of the target, just like glBindBufferBase does.
+    static auto bind_buffer_base(GLenum target, u32 index, GLuint buffer) -> void;
+    // Also binds the buffer to the generic binding point of the target, just like glBindBufferRange does.
+    static auto bind_buffer_range(GLenum target, u32 index, GLuint buffer, GLintptr offset, GLsizeiptr size)
+        -> void;
+
+    static auto set_enabled(Capability capability, bool enabled) -> void;
+    static auto set_blend_func(GLenum source_factor, GLenum destination_factor) -> void;
+    static auto set_cull_face(GLenum face) -> void;
+    static auto set_front_face(GLenum mode) -> void;
+    static auto set_polygon_mode(GLenum mode) -> void; // Sets the mode for both front and back faces.
+    static auto set_depth_func(GLenum func) -> void;
+    static auto set_depth_mask(bool enabled) -> void;
+    static auto set_color_mask(bool enabled) -> void; // Sets the mask for every channel of every draw buffer.
+
+    // Deleting an object unbinds it, so the objects have to let the cache know when they get deleted.
+    static auto forget_program(GLuint program) -> void;
+    static auto forget_vertex_array(GLuint vertex_array) -> void;
+    static auto forget_framebuffer(GLuint framebuffer) -> void;
+    static auto forget_texture(GLuint texture) -> void;
+    static auto forget_buffer(GLuint buffer) -> void;
+
+    [[nodiscard]] static auto stats_this_frame() -> auto& { return _stats_this_frame; }
+    [[nodiscard]] static auto stats_last_frame() -> auto& { return _stats_last_frame; }
+
+private:
+    // No object ever gets this name, so comparing against it always fails.
+    static constexpr GLuint unknown = std::numeric_limits<GLuint>::max();
+
+    static constexpr usize max_texture_units = 32;
+    static constexpr usize max_indexed_buffer_bindings = 16;
+    static constexpr usize capability_count = 6;
+
+    // Array buffer, uniform buffer, shader storage buffer and draw indirect buffer.
+    static constexpr usize buffer_target_count = 4;
+
+    struct IndexedBufferBinding
+    {
+        GLuint buffer;
+        GLintptr offset;
+        GLsizeiptr size; // 0 if the whole buffer is bound.
+
+        [[nodiscard]] auto operator==(const IndexedBufferBinding&) const -> bool = default;
+    };
+
+    static constexpr IndexedBufferBinding unknown_binding{ .buffer = unknown, .offset = 0, .size = 0 };
+
+    static inline GLuint _program = unknown;
+    static inline GLuint _vertex_array = unknown;
+    static inline GLuint _framebuffer = unknown;
+    static inline std::array<GLuint, max_texture_units> _texture_units;
+    static inline std::array<GLuint, buffer_target_count> _buffers;
+    static inline std::array<IndexedBufferBinding, max_indexed_buffer_bindings> _uniform_buffer_bindings;
+    static inline std::array<IndexedBufferBinding, max_indexed_buffer_bindings> _shader_storage_buffer_bindings;
+
+    static inline std::array<Optional<bool>, capability_count> _capabilities;
+    static inline Optional<std::array<GLenum, 2>> _blend_func = nil;
+    static inline Optional<GLenum> _cull_face = nil;
+    static inline Optional<GLenum> _front_face = nil;
+    static inline Optional<GLenum> _polygon_mode = nil;
+    static inline Optional<GLenum> _depth_func = nil;
+    static inline Optional<bool> _depth_mask = nil;
+    static inline Optional<bool> _color_mask = nil;
+
+    static inline StateCacheStats _stats_this_frame;
+    static inline StateCacheStats _stats_last_frame;
+
+private:
+    [[nodiscard]] static auto record_call(bool redundant) -> bool;
+    // Returns true if the call has to be issued.
+    [[nodiscard]] static auto update_indexed_binding(GLenum target, u32 index, const IndexedBufferBinding& binding)
+        -> bool;
+};
+
+[[nodiscard]] auto to_gl_enum(Capability capability) -> GLenum;
+
+} // namespace zth::gl
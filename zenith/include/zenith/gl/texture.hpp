@@ -27,6 +27,10 @@ enum class SizedTextureFormat : u16
     Rg8 = GL_RG8,     // 33 323
     Rgb8 = GL_RGB8,   // 32 849
     Rgba8 = GL_RGBA8, // 32 856
+
+    Rgba16f = GL_RGBA16F,             // 34 842
+    R32ui = GL_R32UI,                 // 33 334
+    Depth32f = GL_DEPTH_COMPONENT32F, // 36 012
 };
 
 enum class TextureWrapMode : u16
@@ -109,6 +113,9 @@ public:
     [[nodiscard]] static auto from_file_data(std::span<const byte> file_data, const TextureParams& params = {})
         -> Texture2D;
 
+    // A texture without mipmaps whose contents are undefined, meant to be rendered to.
+    [[nodiscard]] static auto with_size(u32 width, u32 height, const TextureParams& params = {}) -> Texture2D;
+
     ZTH_NO_COPY(Texture2D)
 
     Texture2D(Texture2D&& other) noexcept;
@@ -131,6 +138,7 @@ private:
 
     struct FromFileTag {};
     struct FromFileDataTag {};
+    struct WithSizeTag {};
 
     // clang-format on
 
@@ -152,6 +160,7 @@ private:
 
     explicit Texture2D(FromFileTag, const std::filesystem::path& path, const TextureParams& params);
     explicit Texture2D(FromFileDataTag, std::span<const byte> file_data, const TextureParams& params);
+    explicit Texture2D(WithSizeTag, u32 width, u32 height, const TextureParams& params);
 
     auto create() noexcept -> void;
     auto destroy() const noexcept -> void;
@@ -159,6 +168,7 @@ private:
     auto create_from_file_data(std::span<const byte> file_data, const TextureParams& params) -> void;
     auto create_from_pixels(std::span<const byte> pixels, DataType type, u32 width, u32 height, TextureFormat format,
                             const TextureParams& params) noexcept -> void;
+    auto set_params(const TextureParams& params) const noexcept -> void;
 };
 
 [[nodiscard]] auto to_gl_int(TextureWrapMode wrap) -> GLint;
@@ -168,5 +178,7 @@ private:
 [[nodiscard]] auto to_gl_enum(TextureFormat format) -> GLenum;
 [[nodiscard]] auto texture_format_from_channels(u32 channels) -> TextureFormat;
 [[nodiscard]] auto channels_in_texture_format(TextureFormat format) -> u32;
+[[nodiscard]] auto bytes_per_texel(SizedTextureFormat format) -> u32;
+[[nodiscard]] auto texture_format_name(SizedTextureFormat format) -> const char*;
 
 } // namespace zth::gl
@@ -23,6 +23,10 @@ enum class DataType : u16
     Int = GL_INT,                      // 5 124
     Float = GL_FLOAT,                  // 5 126
     Double = GL_DOUBLE,                // 5 130
+    HalfFloat = GL_HALF_FLOAT,         // 5 131
+
+    // Packs 4 components into 32 bits, with 10 bits for each of the first 3 components and 2 bits for the last one.
+    Int2101010Rev = GL_INT_2_10_10_10_REV, // 36 255
 };
 
 template<typename T> constexpr inline DataType to_data_type; // Must be specialized.
@@ -59,6 +63,10 @@ template<> constexpr inline auto to_data_type<GLdouble> = DataType::Double;
         return GL_FLOAT;
     case Double:
         return GL_DOUBLE;
+    case HalfFloat:
+        return GL_HALF_FLOAT;
+    case Int2101010Rev:
+        return GL_INT_2_10_10_10_REV;
     }
 
     ZTH_ASSERT(false);
@@ -80,6 +88,13 @@ concept IndexingType = indexing_data_type<T>;
     return type == UnsignedByte || type == UnsignedShort || type == UnsignedInt;
 }
 
+[[nodiscard]] constexpr auto is_an_integer_data_type(DataType type) -> bool
+{
+    using enum DataType;
+    return type == UnsignedByte || type == Byte || type == UnsignedShort || type == Short || type == UnsignedInt
+           || type == Int;
+}
+
 [[nodiscard]] constexpr auto size_of_data_type(DataType type) -> usize
 {
     switch (type)
@@ -103,6 +118,10 @@ concept IndexingType = indexing_data_type<T>;
         return sizeof(GLfloat);
     case Double:
         return sizeof(GLdouble);
+    case HalfFloat:
+        return sizeof(GLhalf);
+    case Int2101010Rev:
+        return sizeof(GLuint); // The size of all 4 components.
     }
 
     ZTH_ASSERT(false);
@@ -145,6 +164,7 @@ template<> constexpr inline usize std140_field_alignment<GLdouble> = 8;
 template<> constexpr inline usize std140_field_alignment<glm::vec2> = 8;
 template<> constexpr inline usize std140_field_alignment<glm::vec3> = 16;
 template<> constexpr inline usize std140_field_alignment<glm::vec4> = 16;
+template<> constexpr inline usize std140_field_alignment<glm::uvec4> = 16;
 template<> constexpr inline usize std140_field_alignment<glm::mat4> = 16;
 
 template<typename T> constexpr inline usize std430_field_alignment = alignof(T);
@@ -158,6 +178,7 @@ template<> constexpr inline usize std430_field_alignment<GLdouble> = 8;
 template<> constexpr inline usize std430_field_alignment<glm::vec2> = 8;
 template<> constexpr inline usize std430_field_alignment<glm::vec3> = 16;
 template<> constexpr inline usize std430_field_alignment<glm::vec4> = 16;
+template<> constexpr inline usize std430_field_alignment<glm::uvec4> = 16;
 template<> constexpr inline usize std430_field_alignment<glm::mat4> = 16;
 
 } // namespace zth::gl
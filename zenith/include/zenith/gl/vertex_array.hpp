@@ -1,6 +1,7 @@
 #pragma once
 
 #include <glad/glad.h>
+#include <glm/vec3.hpp>
 
 #include "zenith/core/typedefs.hpp"
 #include "zenith/gl/fwd.hpp"
@@ -15,6 +16,17 @@ struct VertexArrayLayout
     VertexLayout instance_buffer_layout{};
 };
 
+// Maps the positions stored in a vertex buffer to the local space of their mesh: position * scale + offset. Vertex
+// formats which quantize the positions store them relative to the bounds of the mesh, so that they use the whole range
+// of the format. The scale is uniform, so it doesn't change the directions of the normals.
+struct VertexPositionTransform
+{
+    glm::vec3 offset{ 0.0f };
+    float scale = 1.0f;
+
+    [[nodiscard]] auto operator==(const VertexPositionTransform&) const -> bool = default;
+};
+
 // We're using separate attribute format from OpenGL 4.3 and newer, which means that vertex layouts are bound to vertex
 // arrays instead of vertex buffers. Therefore, you can use the same vertex array with different vertex buffers without
 // having to specify the layout again as long as the layouts of the vertex buffers are the same.
@@ -74,7 +86,14 @@ public:
     auto set_count_limit(u32 limit) -> void;
     auto set_count_limit(Nil) -> void;
 
+    // Vertex arrays don't apply the transform themselves. The renderer folds it into the transforms of the instances.
+    auto set_position_transform(const VertexPositionTransform& transform) -> void;
+
     [[nodiscard]] auto native_handle() const { return _id; }
+    // Changes whenever a vertex buffer or an index buffer gets bound or unbound, and never repeats, not even across
+    // different vertex arrays, so unlike the native handle, which OpenGL reuses, it identifies the geometry the vertex
+    // array refers to.
+    [[nodiscard]] auto generation() const -> u64 { return _generation; }
     [[nodiscard]] auto count() const -> u32;
     [[nodiscard]] auto indexing_data_type() const -> DataType;
 
@@ -84,10 +103,13 @@ public:
     [[nodiscard]] auto instance_buffer() const { return _instance_buffer; }
 
     [[nodiscard]] auto layout() const -> VertexArrayLayout;
+    [[nodiscard]] auto position_transform() const -> auto& { return _position_transform; }
 
 private:
     VertexArrayId _id = GL_NONE;
+    u64 _generation = next_generation();
     Optional<u32> _count_limit = nil;
+    VertexPositionTransform _position_transform{};
 
     const VertexBuffer* _vertex_buffer = nullptr;
     const IndexBuffer* _index_buffer = nullptr;
@@ -99,6 +121,8 @@ private:
 
     auto bind_vertex_buffer_layout() const -> void;
     auto bind_instance_buffer_layout() const -> void;
+
+    [[nodiscard]] static auto next_generation() -> u64;
 };
 
 } // namespace zth::gl
@@ -13,6 +13,7 @@ enum class VertexLayoutElement : u8
     // @todo: Add all remaining types.
 
     Float,
+    Uint, // Gets passed to shaders as an integer.
 
     Vec2,
     Vec3,
@@ -20,6 +21,20 @@ enum class VertexLayoutElement : u8
 
     Mat3,
     Mat4,
+
+    // Quantized elements get converted to floats when the vertices get fetched, so shaders see them as floats. The
+    // matching storage types are declared in zenith/math/quantization.hpp.
+
+    HalfVec2,
+    HalfVec4,
+
+    Snorm16Vec2,
+    Snorm16Vec4,
+
+    Unorm16Vec2,
+    Unorm16Vec4,
+
+    Snorm1010102, // Gets passed to shaders as a vec4.
 };
 
 struct VertexLayoutElementInfo
@@ -28,6 +43,7 @@ struct VertexLayoutElementInfo
     DataType type;
     u32 size_bytes;
     u32 slots_occupied = 1;
+    bool normalized = false; // Whether integers get mapped to [0, 1] or [-1, 1] when they get converted to floats.
 };
 
 class VertexLayout
@@ -51,6 +67,8 @@ public:
 
     [[nodiscard]] constexpr auto stride() const { return _stride_bytes; }
 
+    [[nodiscard]] constexpr auto operator==(const VertexLayout& other) const -> bool;
+
 private:
     InPlaceVector<VertexLayoutElement, max_element_count> _elements;
     u32 _stride_bytes = 0;
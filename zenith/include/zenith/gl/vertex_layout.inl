@@ -6,6 +6,9 @@
 #include <glm/vec3.hpp>
 #include <glm/vec4.hpp>
 
+#include <algorithm>
+
+#include "zenith/math/quantization.hpp"
 #include "zenith/util/meta.hpp"
 
 namespace zth::gl {
@@ -14,6 +17,8 @@ template<typename T> constexpr inline VertexLayoutElement to_vertex_layout_elem;
 
 template<> constexpr inline auto to_vertex_layout_elem<GLfloat> = VertexLayoutElement::Float;
 template<> constexpr inline auto to_vertex_layout_elem<const GLfloat> = VertexLayoutElement::Float;
+template<> constexpr inline auto to_vertex_layout_elem<GLuint> = VertexLayoutElement::Uint;
+template<> constexpr inline auto to_vertex_layout_elem<const GLuint> = VertexLayoutElement::Uint;
 template<> constexpr inline auto to_vertex_layout_elem<glm::vec2> = VertexLayoutElement::Vec2;
 template<> constexpr inline auto to_vertex_layout_elem<const glm::vec2> = VertexLayoutElement::Vec2;
 template<> constexpr inline auto to_vertex_layout_elem<glm::vec3> = VertexLayoutElement::Vec3;
@@ -24,6 +29,20 @@ template<> constexpr inline auto to_vertex_layout_elem<glm::mat3> = VertexLayout
 template<> constexpr inline auto to_vertex_layout_elem<const glm::mat3> = VertexLayoutElement::Mat3;
 template<> constexpr inline auto to_vertex_layout_elem<glm::mat4> = VertexLayoutElement::Mat4;
 template<> constexpr inline auto to_vertex_layout_elem<const glm::mat4> = VertexLayoutElement::Mat4;
+template<> constexpr inline auto to_vertex_layout_elem<math::HalfVec2> = VertexLayoutElement::HalfVec2;
+template<> constexpr inline auto to_vertex_layout_elem<const math::HalfVec2> = VertexLayoutElement::HalfVec2;
+template<> constexpr inline auto to_vertex_layout_elem<math::HalfVec4> = VertexLayoutElement::HalfVec4;
+template<> constexpr inline auto to_vertex_layout_elem<const math::HalfVec4> = VertexLayoutElement::HalfVec4;
+template<> constexpr inline auto to_vertex_layout_elem<math::Snorm16Vec2> = VertexLayoutElement::Snorm16Vec2;
+template<> constexpr inline auto to_vertex_layout_elem<const math::Snorm16Vec2> = VertexLayoutElement::Snorm16Vec2;
+template<> constexpr inline auto to_vertex_layout_elem<math::Snorm16Vec4> = VertexLayoutElement::Snorm16Vec4;
+template<> constexpr inline auto to_vertex_layout_elem<const math::Snorm16Vec4> = VertexLayoutElement::Snorm16Vec4;
+template<> constexpr inline auto to_vertex_layout_elem<math::Unorm16Vec2> = VertexLayoutElement::Unorm16Vec2;
+template<> constexpr inline auto to_vertex_layout_elem<const math::Unorm16Vec2> = VertexLayoutElement::Unorm16Vec2;
+template<> constexpr inline auto to_vertex_layout_elem<math::Unorm16Vec4> = VertexLayoutElement::Unorm16Vec4;
+template<> constexpr inline auto to_vertex_layout_elem<const math::Unorm16Vec4> = VertexLayoutElement::Unorm16Vec4;
+template<> constexpr inline auto to_vertex_layout_elem<math::Snorm1010102> = VertexLayoutElement::Snorm1010102;
+template<> constexpr inline auto to_vertex_layout_elem<const math::Snorm1010102> = VertexLayoutElement::Snorm1010102;
 
 constexpr VertexLayout::VertexLayout(std::initializer_list<VertexLayoutElement> elements, u32 stride_bytes)
     : _elements{ elements }, _stride_bytes{ stride_bytes }
@@ -161,4 +180,9 @@ constexpr auto VertexLayout::clear() -> void
     _elements.clear();
 }
 
+constexpr auto VertexLayout::operator==(const VertexLayout& other) const -> bool
+{
+    return _stride_bytes == other._stride_bytes && std::ranges::equal(_elements, other._elements);
+}
+
 } // namespace zth::gl
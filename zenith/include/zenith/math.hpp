@@ -2,7 +2,10 @@
 
 #include "math/fwd.hpp"
 
+#include "math/bounds.hpp"
+#include "math/bvh.hpp"
 #include "math/float.hpp"
+#include "math/frustum.hpp"
 #include "math/geometry.hpp"
 #include "math/matrix.hpp"
 #include "math/quaternion.hpp"
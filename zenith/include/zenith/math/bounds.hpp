@@ -0,0 +1,71 @@
+#pragma once
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+
+#include <limits>
+#include <ranges>
+
+#include "zenith/util/optional.hpp"
+
+namespace zth::math {
+
+struct Aabb
+{
+    glm::vec3 min{ 0.0f };
+    glm::vec3 max{ 0.0f };
+
+    [[nodiscard]] auto center() const -> glm::vec3 { return (min + max) * 0.5f; }
+    [[nodiscard]] auto extents() const -> glm::vec3 { return (max - min) * 0.5f; } // Half of the size.
+    [[nodiscard]] auto surface_area() const -> float;
+};
+
+// @volatile: cull_bounding_spheres() relies on the layout of this struct.
+struct BoundingSphere
+{
+    glm::vec3 center{ 0.0f };
+    float radius = 0.0f;
+};
+
+static_assert(sizeof(BoundingSphere) == sizeof(float) * 4);
+
+struct Ray
+{
+    glm::vec3 origin{ 0.0f };
+    glm::vec3 direction{ 0.0f, 0.0f, -1.0f }; // Doesn't have to be normalized.
+};
+
+// Bounds of objects whose extent is unknown. Objects with these bounds never get culled.
+constexpr inline Aabb infinite_aabb{
+    .min = glm::vec3{ -std::numeric_limits<float>::infinity() },
+    .max = glm::vec3{ std::numeric_limits<float>::infinity() },
+};
+
+constexpr inline BoundingSphere infinite_bounding_sphere{
+    .center = glm::vec3{ 0.0f },
+    .radius = std::numeric_limits<float>::infinity(),
+};
+
+// Returns a degenerate AABB at the origin if there are no points.
+template<std::ranges::forward_range R> [[nodiscard]] auto compute_aabb(R&& points) -> Aabb;
+// The sphere is centered at the center of the points' AABB, which isn't optimal, but is good enough for culling.
+// Returns a degenerate sphere at the origin if there are no points.
+template<std::ranges::forward_range R> [[nodiscard]] auto compute_bounding_sphere(R&& points) -> BoundingSphere;
+
+// Returns the smallest AABB which contains both of the AABBs.
+[[nodiscard]] auto merge(const Aabb& a, const Aabb& b) -> Aabb;
+
+// Returns the distance along the ray (in multiples of the ray's direction) at which it enters the box, or nil if it
+// misses the box or enters it further than max_distance. Returns 0 if the ray starts inside of the box.
+[[nodiscard]] auto intersect(const Ray& ray, const Aabb& aabb,
+                             float max_distance = std::numeric_limits<float>::infinity()) -> Optional<float>;
+
+// Returns an AABB which contains the transformed AABB.
+[[nodiscard]] auto transform_aabb(const Aabb& aabb, const glm::mat4& transform) -> Aabb;
+// Returns a sphere which contains the transformed sphere. Non-uniform scale makes the sphere bigger than it has to be.
+[[nodiscard]] auto transform_bounding_sphere(const BoundingSphere& sphere, const glm::mat4& transform)
+    -> BoundingSphere;
+
+} // namespace zth::math
+
+#include "bounds.inl"
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+
+namespace zth::math {
+
+template<std::ranges::forward_range R> auto compute_aabb(R&& points) -> Aabb
+{
+    auto it = std::ranges::begin(points);
+    auto end = std::ranges::end(points);
+
+    if (it == end)
+        return Aabb{};
+
+    Aabb aabb{ .min = *it, .max = *it };
+
+    for (; it != end; ++it)
+    {
+        glm::vec3 point = *it;
+        aabb.min = glm::min(aabb.min, point);
+        aabb.max = glm::max(aabb.max, point);
+    }
+
+    return aabb;
+}
+
+template<std::ranges::forward_range R> auto compute_bounding_sphere(R&& points) -> BoundingSphere
+{
+    BoundingSphere sphere{ .center = compute_aabb(points).center(), .radius = 0.0f };
+
+    float max_distance_squared = 0.0f;
+
+    for (glm::vec3 point : points)
+    {
+        auto offset = point - sphere.center;
+        max_distance_squared = std::max(max_distance_squared, glm::dot(offset, offset));
+    }
+
+    sphere.radius = glm::sqrt(max_distance_squared);
+    return sphere;
+}
+
+} // namespace zth::math
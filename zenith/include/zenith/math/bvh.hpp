@@ -0,0 +1,153 @@
+#pragma once
+
+#include <concepts>
+#include <limits>
+#include <span>
+
+#include "zenith/core/typedefs.hpp"
+#include "zenith/math/bounds.hpp"
+#include "zenith/math/frustum.hpp"
+#include "zenith/stl/vector.hpp"
+#include "zenith/util/optional.hpp"
+
+namespace zth::math {
+
+struct BvhRayHit
+{
+    u32 primitive_index;
+    float distance; // In multiples of the ray's direction.
+};
+
+// Bounding volume hierarchy over a set of primitives described by their AABBs. build() creates the whole hierarchy at
+// once, using the surface area heuristic to choose where to split the nodes, and identifies the primitives by their
+// index in the span of bounds. Primitives can also be inserted and removed one at a time, which only touches the nodes
+// on the path from their leaf to the root. Inserted primitives get the indices of removed ones if there are any.
+//
+// The nodes are stored in a flat array. The root is the first node, and the two children of a node are always stored
+// next to each other, so a node only has to store the index of its first child and fits in 32 bytes. Every leaf owns a
+// block of max_leaf_size consecutive slots, and its primitives occupy the first primitive_count of them. The leaves'
+// primitives get culled a block at a time with cull_bounding_spheres().
+class Bvh
+{
+public:
+    struct Node
+    {
+        Aabb bounds;
+        u32 first;           // For leaves, the first slot of the leaf's block. For inner nodes, the first child.
+        u32 primitive_count; // inner_node for inner nodes.
+
+        [[nodiscard]] auto is_leaf() const -> bool { return primitive_count != inner_node; }
+    };
+
+    static_assert(sizeof(Node) == 32);
+
+    static constexpr u32 inner_node = std::numeric_limits<u32>::max();
+    static constexpr u32 no_node = std::numeric_limits<u32>::max();
+    static constexpr u32 no_primitive = std::numeric_limits<u32>::max();
+
+    // Leaves never hold more primitives than this.
+    static constexpr u32 max_leaf_size = 8;
+
+public:
+    explicit Bvh() = default;
+
+    // Builds the hierarchy from scratch, using the surface area heuristic to choose where to split the nodes.
+    auto build(std::span<const Aabb> primitive_bounds) -> void;
+    auto clear() -> void;
+
+    // Adds the primitive to the leaf whose bounds grow the least along the way, splitting the leaf if it's full, and
+    // returns the primitive's index.
+    [[nodiscard]] auto insert(const Aabb& bounds) -> u32;
+    // Removes the primitive from its leaf. A leaf which ends up empty gets replaced by its sibling.
+    auto remove(u32 primitive_index) -> void;
+
+    // Updates the bounds of a primitive. A primitive which moves out of its leaf gets moved to another leaf right away,
+    // otherwise the nodes don't get updated until refit() gets called. Either way the nodes keep containing the bounds
+    // of their primitives, so the hierarchy can be queried before refitting it, only less efficiently.
+    auto update_primitive(u32 primitive_index, const Aabb& bounds) -> void;
+    // Shrinks the nodes on the paths from the updated primitives to the root to fit their primitives again.
+    auto refit() -> void;
+
+    // Calls on_visible(primitive_index) for every primitive which intersects the frustum. Subtrees which lie entirely
+    // inside of the frustum get accepted without testing their primitives.
+    template<std::invocable<u32> F> auto query(const Frustum& frustum, F&& on_visible) const -> void;
+
+    // Returns the closest primitive whose bounds the ray hits.
+    [[nodiscard]] auto raycast(const Ray& ray, float max_distance = std::numeric_limits<float>::infinity()) const
+        -> Optional<BvhRayHit>;
+    // Returns the closest primitive for which intersect_primitive(primitive_index, ray, max_distance) returns a
+    // distance (an Optional<float>). intersect_primitive only gets called for the primitives in the leaves that the ray
+    // hits, and max_distance shrinks as closer hits are found.
+    template<std::invocable<u32, const Ray&, float> F>
+    [[nodiscard]] auto raycast(const Ray& ray, float max_distance, F&& intersect_primitive) const
+        -> Optional<BvhRayHit>;
+
+    // Free nodes are never referenced by the nodes reachable from the root.
+    [[nodiscard]] auto nodes() const -> std::span<const Node> { return _nodes; }
+    [[nodiscard]] auto parent(u32 node_index) const -> u32 { return _parents[node_index]; }
+    // The primitives in the leaves' blocks, indexed with slots. The unoccupied slots hold no_primitive.
+    [[nodiscard]] auto slots() const -> std::span<const u32> { return _slots; }
+    // Indexed with the primitives' indices. The bounds of removed primitives stay in here until the index gets reused.
+    [[nodiscard]] auto primitive_bounds() const -> std::span<const Aabb> { return _primitive_bounds; }
+    [[nodiscard]] auto contains(u32 primitive_index) const -> bool;
+    [[nodiscard]] auto primitive_count() const -> usize { return _primitive_bounds.size() - _free_primitives.size(); }
+    [[nodiscard]] auto empty() const -> bool { return _nodes.empty(); }
+
+private:
+    // The primitives get partitioned along with their bounds, which keeps the memory accesses during the build linear.
+    struct BuildPrimitive
+    {
+        Aabb bounds;
+        glm::vec3 centroid;
+        u32 index;
+    };
+
+    Vector<Node> _nodes;
+    Vector<u32> _parents;
+    Vector<u32> _free_node_pairs; // The first nodes of pairs of children which aren't used.
+
+    // Indexed with slots. The bounding spheres of the primitives' bounds are what cull_bounding_spheres() tests.
+    Vector<u32> _slots;
+    Vector<BoundingSphere> _slot_spheres;
+    Vector<u32> _block_leaves; // Indexed with blocks (slot / max_leaf_size).
+    Vector<u32> _free_blocks;
+
+    // Indexed with the primitives' indices.
+    Vector<Aabb> _primitive_bounds;
+    Vector<u32> _primitive_slots;
+    Vector<u32> _free_primitives;
+
+    Vector<u32> _updated_primitives;
+
+private:
+    auto build_node(std::span<BuildPrimitive> primitives, u32 node_index, u32 depth) -> void;
+
+    [[nodiscard]] auto allocate_node_pair(u32 parent) -> u32;
+    [[nodiscard]] auto allocate_block(u32 leaf) -> u32;
+    auto free_block(u32 first_slot) -> void;
+    auto place_primitive(u32 primitive_index, u32 slot) -> void;
+
+    // Descends from the root to the leaf which fits the bounds best and puts the primitive into it.
+    auto insert_into_leaf(u32 primitive_index) -> void;
+    auto split_leaf(u32 leaf, u32 primitive_index) -> void;
+    // Takes the primitive out of its leaf, but keeps its index.
+    auto remove_from_leaf(u32 primitive_index) -> void;
+
+    // Points the node's children or its block back at the node after its contents were moved into it.
+    auto adopt_children(u32 node_index) -> void;
+    auto move_node(u32 from, u32 to) -> void;
+    auto swap_nodes(u32 a, u32 b) -> void;
+    // Recomputes the node's bounds from its children or its primitives and returns whether they changed.
+    auto refit_node(u32 node_index) -> bool;
+    // Recomputes the bounds of the nodes from the given node up to the root, and rotates the subtrees along the way
+    // when that makes the nodes smaller, which keeps the hierarchy balanced as primitives get inserted and removed.
+    auto refit_and_rotate_ancestors(u32 node_index) -> void;
+    auto rotate(u32 node_index) -> void;
+
+    // Returns the node which follows the node's subtree in depth-first order, or no_node at the end of the traversal.
+    [[nodiscard]] auto next_node(u32 node_index) const -> u32;
+};
+
+} // namespace zth::math
+
+#include "bvh.inl"
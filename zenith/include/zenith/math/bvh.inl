@@ -0,0 +1,129 @@
+#pragma once
+
+#include <array>
+#include <span>
+#include <utility>
+
+namespace zth::math {
+
+template<std::invocable<u32> F> auto Bvh::query(const Frustum& frustum, F&& on_visible) const -> void
+{
+    if (_nodes.empty())
+        return;
+
+    // The node whose subtree lies entirely inside of the frustum, while we're walking through it.
+    auto inside_subtree = no_node;
+
+    auto advance = [&](u32 node_index) {
+        // First children are stored at odd indices. Same as next_node(), but notices leaving the inside subtree.
+        while (node_index != 0)
+        {
+            if (node_index == inside_subtree)
+                inside_subtree = no_node;
+
+            if (node_index % 2 == 1)
+                return node_index + 1;
+
+            node_index = _parents[node_index];
+        }
+
+        return no_node;
+    };
+
+    u32 node_index = 0;
+
+    while (node_index != no_node)
+    {
+        const auto& node = _nodes[node_index];
+        auto intersection =
+            inside_subtree == no_node ? classify(frustum, node.bounds) : FrustumIntersection::Inside;
+
+        if (intersection == FrustumIntersection::Outside)
+        {
+            node_index = advance(node_index);
+            continue;
+        }
+
+        if (intersection == FrustumIntersection::Inside && inside_subtree == no_node)
+            inside_subtree = node_index;
+
+        if (!node.is_leaf())
+        {
+            node_index = node.first;
+            continue;
+        }
+
+        auto primitives = std::span{ _slots }.subspan(node.first, node.primitive_count);
+
+        if (intersection == FrustumIntersection::Inside)
+        {
+            for (auto primitive_index : primitives)
+                on_visible(primitive_index);
+        }
+        else
+        {
+            // The spheres reject most of the primitives which lie outside of the frustum a few at a time, and the
+            // boxes of the rest get tested one by one, as they fit the primitives more tightly.
+            std::array<u32, max_leaf_size> visible_slots;
+            auto spheres = std::span{ _slot_spheres }.subspan(node.first, node.primitive_count);
+            auto visible_count = cull_bounding_spheres(frustum, spheres, visible_slots);
+
+            for (usize i = 0; i < visible_count; i++)
+            {
+                auto primitive_index = primitives[visible_slots[i]];
+
+                if (intersects(frustum, _primitive_bounds[primitive_index]))
+                    on_visible(primitive_index);
+            }
+        }
+
+        node_index = advance(node_index);
+    }
+}
+
+template<std::invocable<u32, const Ray&, float> F>
+auto Bvh::raycast(const Ray& ray, float max_distance, F&& intersect_primitive) const -> Optional<BvhRayHit>
+{
+    if (_nodes.empty())
+        return nil;
+
+    u32 node_index = 0;
+
+    Optional<BvhRayHit> closest_hit = nil;
+
+    // @speed: We always visit the first child first, regardless of which one is closer to the ray's origin, so we might
+    // end up testing primitives which are hidden behind ones we haven't found yet.
+    while (node_index != no_node)
+    {
+        const auto& node = _nodes[node_index];
+
+        if (!intersect(ray, node.bounds, max_distance))
+        {
+            node_index = next_node(node_index);
+            continue;
+        }
+
+        if (!node.is_leaf())
+        {
+            node_index = node.first;
+            continue;
+        }
+
+        for (auto primitive_index : std::span{ _slots }.subspan(node.first, node.primitive_count))
+        {
+            Optional<float> distance = intersect_primitive(primitive_index, ray, max_distance);
+
+            if (distance && *distance <= max_distance)
+            {
+                max_distance = *distance;
+                closest_hit = BvhRayHit{ .primitive_index = primitive_index, .distance = *distance };
+            }
+        }
+
+        node_index = next_node(node_index);
+    }
+
+    return closest_hit;
+}
+
+} // namespace zth::math
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include <array>
+#include <span>
+
+#include "zenith/core/typedefs.hpp"
+#include "zenith/math/bounds.hpp"
+
+namespace zth::math {
+
+enum class FrustumPlane : u8
+{
+    Left,
+    Right,
+    Bottom,
+    Top,
+    Near,
+    Far,
+};
+
+enum class FrustumIntersection : u8
+{
+    Outside,
+    Partial,
+    Inside,
+};
+
+struct Frustum
+{
+    static constexpr usize plane_count = 6;
+
+    // Every plane is stored as (normal, distance), where the normal is normalized and points towards the inside of the
+    // frustum, so that a point p lies inside of the half-space if dot(normal, p) + distance >= 0. The planes are
+    // indexed with FrustumPlane.
+    std::array<glm::vec4, plane_count> planes;
+
+    // Extracts the planes of the frustum in world space from a view-projection matrix (Gribb-Hartmann method). Assumes
+    // OpenGL clip space conventions, but is conservative for clip spaces with depth in the range [0, 1].
+    [[nodiscard]] static auto from_view_projection(const glm::mat4& view_projection) -> Frustum;
+
+    [[nodiscard]] auto plane(FrustumPlane which) const -> glm::vec4 { return planes[static_cast<usize>(which)]; }
+};
+
+[[nodiscard]] auto contains(const Frustum& frustum, glm::vec3 point) -> bool;
+// Conservative: may return true for spheres which lie near the corners of the frustum, but outside of it.
+[[nodiscard]] auto intersects(const Frustum& frustum, const BoundingSphere& sphere) -> bool;
+// Conservative: may return true for boxes which lie near the corners of the frustum, but outside of it.
+[[nodiscard]] auto intersects(const Frustum& frustum, const Aabb& aabb) -> bool;
+// Like intersects(), but also tells whether the box lies entirely inside of the frustum. Equally conservative.
+[[nodiscard]] auto classify(const Frustum& frustum, const Aabb& aabb) -> FrustumIntersection;
+
+// Tests all the spheres against the frustum and writes the indices of the ones which intersect it to visible_indices,
+// in ascending order. Returns the number of visible spheres. visible_indices must be at least as big as spheres. Tests
+// four spheres at a time when SSE is available, otherwise falls back to intersects().
+auto cull_bounding_spheres(const Frustum& frustum, std::span<const BoundingSphere> spheres,
+                           std::span<u32> visible_indices) -> usize;
+
+} // namespace zth::math
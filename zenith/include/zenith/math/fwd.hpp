@@ -1,8 +1,30 @@
 #pragma once
 
+#include "zenith/core/typedefs.hpp"
+
 namespace zth {
 
 template<typename T = float> struct Rect;
 template<typename T = float> struct BoundedRect;
 
 } // namespace zth
+
+namespace zth::math {
+
+struct Aabb;
+struct BoundingSphere;
+struct Ray;
+enum class FrustumPlane : u8;
+struct Frustum;
+enum class FrustumIntersection : u8;
+class Bvh;
+struct BvhRayHit;
+struct HalfVec2;
+struct HalfVec4;
+struct Snorm16Vec2;
+struct Snorm16Vec4;
+struct Unorm16Vec2;
+struct Unorm16Vec4;
+struct Snorm1010102;
+
+} // namespace zth::math
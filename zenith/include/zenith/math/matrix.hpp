@@ -5,6 +5,8 @@
 #include <glm/mat4x4.hpp>
 #include <glm/vec3.hpp>
 
+#include <span>
+
 #include "zenith/math/float.hpp"
 #include "zenith/math/quaternion.hpp"
 
@@ -27,6 +29,15 @@ struct TransformComponents
 
 [[nodiscard]] auto has_uniform_scale(const glm::mat4& transform, float epsilon = default_epsilon<float>) -> bool;
 [[nodiscard]] auto get_normal_matrix(const glm::mat4& transform) -> glm::mat3;
+// Analytic version for transforms composed from a rotation and a scale, which doesn't need an inverse.
+[[nodiscard]] auto get_normal_matrix(glm::quat rotation, glm::vec3 scale) -> glm::mat3;
+
+// Writes the normal matrix of every transform to normal_matrices, which must be at least as big as transforms. Uses
+// SSE (and AVX, if it's enabled at compile time) to process several matrices at once. The transforms must be
+// invertible.
+auto compute_normal_matrices(std::span<const glm::mat4> transforms, std::span<glm::mat3> normal_matrices) -> void;
+auto compute_normal_matrices(std::span<const glm::quat> rotations, std::span<const glm::vec3> scales,
+                             std::span<glm::mat3> normal_matrices) -> void;
 
 [[nodiscard]] auto rotation_matrix_from_quaternion(glm::quat rotation) -> glm::mat4;
 [[nodiscard]] auto rotation_matrix_from_euler_angles(EulerAngles angles) -> glm::mat4;
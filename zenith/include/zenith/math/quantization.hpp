@@ -0,0 +1,108 @@
+#pragma once
+
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include "zenith/core/typedefs.hpp"
+
+namespace zth::math {
+
+// Storage types for quantized vertex attributes. The GPU converts them back to floats when it fetches the vertices.
+
+struct HalfVec2
+{
+    u16 x = 0;
+    u16 y = 0;
+};
+
+struct HalfVec4
+{
+    u16 x = 0;
+    u16 y = 0;
+    u16 z = 0;
+    u16 w = 0;
+};
+
+// Maps [-32767, 32767] to [-1, 1]. -32768 maps to -1 as well.
+struct Snorm16Vec2
+{
+    i16 x = 0;
+    i16 y = 0;
+};
+
+struct Snorm16Vec4
+{
+    i16 x = 0;
+    i16 y = 0;
+    i16 z = 0;
+    i16 w = 0;
+};
+
+// Maps [0, 65535] to [0, 1].
+struct Unorm16Vec2
+{
+    u16 x = 0;
+    u16 y = 0;
+};
+
+struct Unorm16Vec4
+{
+    u16 x = 0;
+    u16 y = 0;
+    u16 z = 0;
+    u16 w = 0;
+};
+
+// A signed normalized vec4 packed into 32 bits: 10 bits for each of x, y and z (starting from the lowest bits) and 2
+// bits for w, which can only be -1, 0 or 1.
+struct Snorm1010102
+{
+    u32 bits = 0;
+};
+
+// The largest error that the quantization introduces, for values within the range of the format.
+constexpr inline float snorm16_max_error = 0.5f / 32767.0f;
+constexpr inline float unorm16_max_error = 0.5f / 65535.0f;
+constexpr inline float snorm10_max_error = 0.5f / 511.0f;
+// Relative to the value, for values within the normal range of half floats (between 2^-14 and 65504).
+constexpr inline float half_max_relative_error = 1.0f / 2048.0f;
+// The largest distance between a unit vector and the unit vector it decodes to after octahedral encoding with 16-bit
+// components.
+constexpr inline float octahedral_snorm16_max_error = 1e-4f;
+
+// Rounds to the nearest half float. Values too big for a half float turn into infinity.
+[[nodiscard]] auto float_to_half(float value) -> u16;
+[[nodiscard]] auto half_to_float(u16 value) -> float;
+
+// Values outside of the range of the format get clamped.
+[[nodiscard]] auto quantize_snorm16(float value) -> i16;
+[[nodiscard]] auto dequantize_snorm16(i16 value) -> float;
+[[nodiscard]] auto quantize_unorm16(float value) -> u16;
+[[nodiscard]] auto dequantize_unorm16(u16 value) -> float;
+
+[[nodiscard]] auto pack_half(glm::vec2 value) -> HalfVec2;
+[[nodiscard]] auto pack_half(glm::vec4 value) -> HalfVec4;
+[[nodiscard]] auto pack_snorm16(glm::vec2 value) -> Snorm16Vec2;
+[[nodiscard]] auto pack_snorm16(glm::vec4 value) -> Snorm16Vec4;
+[[nodiscard]] auto pack_unorm16(glm::vec2 value) -> Unorm16Vec2;
+[[nodiscard]] auto pack_unorm16(glm::vec4 value) -> Unorm16Vec4;
+[[nodiscard]] auto pack_snorm1010102(glm::vec4 value) -> Snorm1010102;
+
+[[nodiscard]] auto unpack(HalfVec2 value) -> glm::vec2;
+[[nodiscard]] auto unpack(HalfVec4 value) -> glm::vec4;
+[[nodiscard]] auto unpack(Snorm16Vec2 value) -> glm::vec2;
+[[nodiscard]] auto unpack(Snorm16Vec4 value) -> glm::vec4;
+[[nodiscard]] auto unpack(Unorm16Vec2 value) -> glm::vec2;
+[[nodiscard]] auto unpack(Unorm16Vec4 value) -> glm::vec4;
+[[nodiscard]] auto unpack(Snorm1010102 value) -> glm::vec4;
+
+// Maps a unit vector onto an octahedron and unfolds the octahedron into the [-1, 1] square. Keeps the precision much
+// more uniform than storing the 3 components.
+[[nodiscard]] auto encode_octahedral(glm::vec3 unit_vector) -> glm::vec2;
+[[nodiscard]] auto decode_octahedral(glm::vec2 encoded) -> glm::vec3;
+
+[[nodiscard]] auto pack_octahedral(glm::vec3 unit_vector) -> Snorm16Vec2;
+[[nodiscard]] auto unpack_octahedral(Snorm16Vec2 value) -> glm::vec3;
+
+} // namespace zth::math
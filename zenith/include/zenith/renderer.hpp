@@ -4,11 +4,17 @@
 
 #include "renderer/colors.hpp"
 #include "renderer/coordinate_space.hpp"
+#include "renderer/draw_key.hpp"
+#include "renderer/draw_list.hpp"
+#include "renderer/geometry_pool.hpp"
 #include "renderer/imgui_renderer.hpp"
 #include "renderer/light.hpp"
+#include "renderer/light_clusters.hpp"
 #include "renderer/material.hpp"
 #include "renderer/mesh.hpp"
+#include "renderer/occlusion_buffer.hpp"
 #include "renderer/primitives.hpp"
+#include "renderer/render_graph.hpp"
 #include "renderer/renderer.hpp"
 #include "renderer/resources.hpp"
 #include "renderer/shader_data.hpp"
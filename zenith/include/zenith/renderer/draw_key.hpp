@@ -0,0 +1,133 @@
+#pragma once
+
+#include <span>
+
+#include "zenith/core/typedefs.hpp"
+#include "zenith/stl/map.hpp"
+
+namespace zth {
+
+// Render passes occupy the most significant bits of a draw key, so all the draw commands which belong to an earlier
+// pass get rendered before the draw commands which belong to the later ones.
+enum class RenderPass : u8
+{
+    Opaque = 0,
+    // Rendered into the G-buffer and lit afterwards. Comes after the opaque pass, so that the lighting pass can depth
+    // test against what has already been rendered.
+    Deferred = 1,
+    // Blended over everything else, so it has to come last.
+    Transparent = 2,
+};
+
+// A draw key packs everything that determines the order in which draw commands get rendered into a single 64-bit
+// integer, which lets us sort draw commands with a radix sort. Opaque draw commands get ordered roughly front to back,
+// so that the closer surfaces hide the ones behind them before they get shaded, and then by state, from the most to the
+// least expensive state change (field sizes are in bits):
+//
+// | pass (4) | depth bucket (4) | shader (12) | material (16) | vertex array (16) | depth (12) |
+//
+// The depth bucket is made of the most significant bits of the quantized depth, so there are only a few of them and
+// draw commands which share state still mostly end up next to each other. Transparent draw commands have to be blended
+// back to front, so their whole depth comes first, inverted:
+//
+// | pass (4) | inverted depth (16) | shader (12) | material (16) | vertex array (16) |
+//
+// The renderer fills the material field with the id of the material's bindings (its shader and textures), as the rest
+// of the material gets read from the material table and doesn't require a state change.
+//
+// Shader, material and vertex array ids which don't fit into their fields get truncated. That only makes the sorting
+// less optimal, as draw commands get batched based on the objects they reference rather than on their keys.
+using DrawKey = u64;
+
+constexpr inline u32 draw_key_pass_bits = 4;
+constexpr inline u32 draw_key_shader_bits = 12;
+constexpr inline u32 draw_key_material_bits = 16;
+constexpr inline u32 draw_key_vertex_array_bits = 16;
+constexpr inline u32 draw_key_depth_bits = 16;
+constexpr inline u32 draw_key_depth_bucket_bits = 4;
+constexpr inline u32 draw_key_fine_depth_bits = draw_key_depth_bits - draw_key_depth_bucket_bits;
+
+static_assert(draw_key_pass_bits + draw_key_shader_bits + draw_key_material_bits + draw_key_vertex_array_bits
+                  + draw_key_depth_bits
+              == sizeof(DrawKey) * 8);
+
+// The shader, material and vertex array fields always stay together.
+constexpr inline u32 draw_key_state_bits = draw_key_shader_bits + draw_key_material_bits + draw_key_vertex_array_bits;
+constexpr inline u32 draw_key_pass_shift = draw_key_state_bits + draw_key_depth_bits;
+
+// An entry of the array which gets sorted. index refers to the draw command the key was built for.
+struct DrawKeyEntry
+{
+    DrawKey key;
+    u32 index;
+};
+
+[[nodiscard]] constexpr auto make_draw_key(RenderPass pass, u32 shader_id, u32 material_id, u32 vertex_array_id,
+                                           u16 depth) -> DrawKey
+{
+    constexpr auto mask = [](u32 bits) { return (DrawKey{ 1 } << bits) - 1; };
+
+    auto pass_field = (static_cast<DrawKey>(pass) & mask(draw_key_pass_bits)) << draw_key_pass_shift;
+    auto state = (static_cast<DrawKey>(shader_id) & mask(draw_key_shader_bits))
+                     << (draw_key_material_bits + draw_key_vertex_array_bits)
+                 | (static_cast<DrawKey>(material_id) & mask(draw_key_material_bits)) << draw_key_vertex_array_bits
+                 | (static_cast<DrawKey>(vertex_array_id) & mask(draw_key_vertex_array_bits));
+
+    if (pass == RenderPass::Transparent)
+    {
+        auto inverted_depth = static_cast<DrawKey>(depth) ^ mask(draw_key_depth_bits);
+        return pass_field | inverted_depth << draw_key_state_bits | state;
+    }
+
+    auto depth_bucket = static_cast<DrawKey>(depth) >> draw_key_fine_depth_bits;
+    auto fine_depth = static_cast<DrawKey>(depth) & mask(draw_key_fine_depth_bits);
+    return pass_field | depth_bucket << (draw_key_state_bits + draw_key_fine_depth_bits)
+           | state << draw_key_fine_depth_bits | fine_depth;
+}
+
+[[nodiscard]] constexpr auto draw_key_pass(DrawKey key) -> RenderPass
+{
+    return static_cast<RenderPass>(key >> draw_key_pass_shift);
+}
+
+// Maps view space depth in the range [near, far] onto the range of the depth field. The mapping is logarithmic, so that
+// the depth buckets cover the scene evenly instead of the farthest one taking up almost all of it. Values outside of
+// the range get clamped.
+[[nodiscard]] auto quantize_draw_key_depth(float view_depth, float near, float far) -> u16;
+
+// Sorts the entries by key in ascending order. The sort is stable. scratch must be at least as big as entries.
+auto radix_sort_draw_keys(std::span<DrawKeyEntry> entries, std::span<DrawKeyEntry> scratch) -> void;
+
+// Assigns consecutive ids to the objects referenced by draw commands, so that they can be packed into draw keys. The
+// ids are only meaningful until the map gets cleared, which happens at the end of every scene.
+template<typename T> class DrawKeyIdMap
+{
+public:
+    [[nodiscard]] auto get(const T* object) -> u32
+    {
+        // Consecutive submissions very often reference the same object.
+        if (object == _last_object)
+            return _last_id;
+
+        auto [kv, _] = _ids.try_emplace(object, static_cast<u32>(_ids.size()));
+
+        _last_object = object;
+        _last_id = kv->second;
+        return _last_id;
+    }
+
+    auto clear() -> void
+    {
+        _ids.clear();
+        _last_object = nullptr;
+        _last_id = 0;
+    }
+
+private:
+    UnorderedMap<const T*, u32> _ids;
+
+    const T* _last_object = nullptr;
+    u32 _last_id = 0;
+};
+
+} // namespace zth
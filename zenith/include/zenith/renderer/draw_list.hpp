@@ -0,0 +1,83 @@
+#pragma once
+
+#include <glm/gtc/quaternion.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+
+#include <span>
+
+#include "zenith/core/typedefs.hpp"
+#include "zenith/ecs/fwd.hpp"
+#include "zenith/gl/fwd.hpp"
+#include "zenith/renderer/fwd.hpp"
+#include "zenith/stl/vector.hpp"
+
+namespace zth {
+
+// A draw command recorded into a draw list. first_transform indexes the list's own transforms until the list gets
+// merged.
+struct DrawListEntry
+{
+    const gl::VertexArray* vertex_array;
+    const Material* material;
+    u32 first_transform;
+    u32 transform_count;
+    // Whether the transforms were composed from a rotation and a scale, which got recorded next to them.
+    bool composed = false;
+
+    [[nodiscard]] auto operator==(const DrawListEntry&) const -> bool = default;
+};
+
+// Records draw commands together with the transforms of their instances. Every thread can record into its own list
+// without synchronizing with the others, and merging the lists in order gives the same result as submitting their
+// contents one after another from a single thread.
+//
+// Doesn't touch OpenGL. A single list mustn't be used from multiple threads at once.
+class DrawList
+{
+public:
+    // The submitted mesh and material must be valid until the renderer finishes rendering the scene. The transform gets
+    // copied.
+    auto submit(const Mesh& mesh, const glm::mat4& transform, const Material& material) -> void;
+    auto submit(const gl::VertexArray& vertex_array, const glm::mat4& transform, const Material& material) -> void;
+    // Same as submitting the transform's matrix, but if the transform was composed from a rotation and a scale, they
+    // get recorded too, so that the renderer never has to recover them from the matrix.
+    auto submit(const Mesh& mesh, const TransformComponent& transform, const Material& material) -> void;
+    auto submit(const gl::VertexArray& vertex_array, const TransformComponent& transform, const Material& material)
+        -> void;
+
+    // Submits an instance for every transform in the range. The transforms get copied.
+    auto submit_instances(const Mesh& mesh, const Material& material, std::span<const glm::mat4> transforms) -> void;
+    auto submit_instances(const gl::VertexArray& vertex_array, const Material& material,
+                          std::span<const glm::mat4> transforms) -> void;
+
+    auto clear() -> void;
+
+    [[nodiscard]] auto empty() const -> bool { return _entries.empty(); }
+    [[nodiscard]] auto entries() const -> std::span<const DrawListEntry> { return _entries; }
+    [[nodiscard]] auto transforms() const -> std::span<const glm::mat4> { return _transforms; }
+    // Parallel to transforms(). Only meaningful for the transforms of composed entries.
+    [[nodiscard]] auto rotations() const -> std::span<const glm::quat> { return _rotations; }
+    [[nodiscard]] auto scales() const -> std::span<const glm::vec3> { return _scales; }
+
+    // Appends the entries, transforms, rotations and scales of every list to the output vectors in the order of the
+    // lists, with the entries' first_transform rebased onto the output transforms. The lists get copied in parallel on
+    // the JobSystem.
+    static auto merge(std::span<const DrawList* const> draw_lists, Vector<DrawListEntry>& entries,
+                      Vector<glm::mat4>& transforms, Vector<glm::quat>& rotations, Vector<glm::vec3>& scales) -> void;
+
+private:
+    Vector<DrawListEntry> _entries;
+    Vector<glm::mat4> _transforms;
+    // Parallel to _transforms, left as they are for transforms submitted as plain matrices.
+    Vector<glm::quat> _rotations;
+    Vector<glm::vec3> _scales;
+
+private:
+    // Returns the index of the first pushed transform.
+    auto push_transforms(std::span<const glm::mat4> transforms) -> u32;
+    auto copy_to(DrawListEntry* entries, glm::mat4* transforms, glm::quat* rotations, glm::vec3* scales,
+                 u32 transform_offset) const -> void;
+};
+
+} // namespace zth
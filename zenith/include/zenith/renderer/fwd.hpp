@@ -18,12 +18,68 @@ struct Material;
 
 class Mesh;
 
+struct MeshLodLevel;
+struct MeshLodSettings;
+class MeshLod;
+
+struct SimplifiedMesh;
+
+struct VertexCacheStats;
+struct MeshOptimizationStats;
+
+enum class RenderPass : u8;
+struct DrawKeyEntry;
+template<typename T> class DrawKeyIdMap;
+
+struct DrawListEntry;
+class DrawList;
+
+struct RetainedInstanceStats;
+struct SlotRange;
+class RetainedInstanceSlots;
+struct RetainedBatch;
+class RetainedDrawList;
+
+struct OcclusionCullingStats;
+class OccluderMesh;
+class OcclusionBuffer;
+
+struct LightCluster;
+struct LightClusterStats;
+class LightClusterGrid;
+
+struct PooledGeometry;
+class GeometryPool;
+
+struct RenderGraphTexture;
+struct RenderGraphBuffer;
+struct RenderGraphTextureDesc;
+struct RenderGraphBufferDesc;
+enum class RenderGraphResourceType : u8;
+struct RenderGraphResource;
+struct RenderGraphPass;
+struct RenderGraphAllocation;
+struct RenderGraphStats;
+class RenderGraphPassBuilder;
+class RenderGraphResourcePool;
+class RenderGraphPassContext;
+class RenderGraph;
+
+enum class ShadingMode : u8;
+struct MaterialBindings;
 struct DrawCommand;
 struct RenderBatch;
+struct RenderPassTimings;
+struct OverdrawStats;
+struct RendererStats;
+struct Renderer2DStats;
+struct DrawElementsIndirectCommand;
 struct DirectionalLightRenderData;
 struct PointLightRenderData;
 struct SpotLightRenderData;
 struct AmbientLightRenderData;
+struct LightsRenderData;
+struct LightsSsboRange;
 class Renderer;
 
 struct LightPropertiesShaderData;
@@ -37,13 +93,18 @@ struct SpotLightShaderData;
 struct SpotLightsSsboData;
 struct AmbientLightShaderData;
 struct AmbientLightsSsboData;
-struct MaterialUboData;
+struct MaterialShaderData;
+struct LightClustersSsboData;
 
 struct LineInfo;
 struct PreprocessShaderError;
 class ShaderPreprocessor;
 
+enum class InstanceFormat : u8;
+enum class VertexFormat : u8;
 struct InstanceVertex;
+struct CompactInstanceVertex;
 struct StandardVertex;
+struct CompactVertex;
 
 } // namespace zth
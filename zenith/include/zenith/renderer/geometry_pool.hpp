@@ -0,0 +1,99 @@
+#pragma once
+
+#include <initializer_list>
+
+#include "zenith/core/typedefs.hpp"
+#include "zenith/gl/buffer.hpp"
+#include "zenith/gl/fwd.hpp"
+#include "zenith/gl/util.hpp"
+#include "zenith/gl/vertex_array.hpp"
+#include "zenith/gl/vertex_layout.hpp"
+#include "zenith/memory/managed.hpp"
+#include "zenith/stl/map.hpp"
+#include "zenith/stl/vector.hpp"
+#include "zenith/util/macros.hpp"
+#include "zenith/util/optional.hpp"
+
+namespace zth {
+
+// Location of a vertex array's geometry inside the shared buffers of a geometry pool.
+struct PooledGeometry
+{
+    const gl::VertexArray* vertex_array; // The shared vertex array the geometry lives in.
+    u32 first_index;
+    u32 index_count;
+    i32 base_vertex;
+};
+
+// Geometry pool copies the geometry of vertex arrays into vertex and index buffers shared by all the vertex arrays with
+// the same vertex layout and indexing data type, so that meshes which live in the same shared buffers can be drawn with
+// a single multi-draw call. The geometry gets copied on the GPU the first time a vertex array is requested, and it
+// stays in the pool until the vertex array gets released or the pool gets cleared. Meshes release their vertex arrays
+// when they get destroyed. Entries are matched with the vertex array's generation, so binding different buffers to a
+// vertex array, or creating a new vertex array at the address of a destroyed one, gets its geometry copied again.
+// Changes made to the contents of a vertex array's buffers after it was copied aren't picked up unless their sizes
+// change. The space freed up by released or outdated geometry gets reused by the geometry added later.
+class GeometryPool
+{
+public:
+    // Every shared vertex array gets bound to the same one of the instance buffers as the vertex arrays whose geometry
+    // it holds.
+    explicit GeometryPool(std::initializer_list<const gl::InstanceBuffer*> instance_buffers);
+    ZTH_NO_COPY_NO_MOVE(GeometryPool)
+    ~GeometryPool() = default;
+
+    // Returns nil if the vertex array can't be pooled, which is the case if it's missing a vertex buffer or an index
+    // buffer, or if it isn't bound to one of the pool's instance buffers.
+    [[nodiscard]] auto get(const gl::VertexArray& vertex_array) -> Optional<PooledGeometry>;
+    // Frees up the space taken up by the vertex array's geometry. Does nothing if the vertex array isn't in the pool.
+    auto release(const gl::VertexArray& vertex_array) -> void;
+    auto clear() -> void;
+
+    [[nodiscard]] auto shared_vertex_array_count() const -> usize { return _shared_geometry.size(); }
+    [[nodiscard]] auto pooled_vertex_array_count() const -> usize { return _entries.size(); }
+
+private:
+    // A range of vertices or indices in the shared buffers.
+    struct Range
+    {
+        u32 first;
+        u32 count;
+    };
+
+    struct SharedGeometry
+    {
+        gl::VertexBuffer vertex_buffer;
+        gl::IndexBuffer index_buffer;
+        gl::VertexArray vertex_array;
+        u32 vertex_count = 0; // The number of vertices up to the end of the last range in use.
+        u32 index_count = 0; // The number of indices up to the end of the last range in use.
+        Vector<Range> free_vertex_ranges; // Sorted by the first vertex, never adjacent to each other.
+        Vector<Range> free_index_ranges; // Sorted by the first index, never adjacent to each other.
+    };
+
+    // We keep track of what the vertex array looked like when its geometry was copied, so that we can detect that it
+    // got bound to different buffers or that the sizes of its buffers changed.
+    struct Entry
+    {
+        u64 generation;
+        const gl::InstanceBuffer* instance_buffer;
+        u32 vertex_buffer_size_bytes;
+        SharedGeometry* shared_geometry;
+        Range vertices;
+        Range indices;
+    };
+
+    Vector<const gl::InstanceBuffer*> _instance_buffers;
+
+    // Shared geometry is heap-allocated, as the shared vertex arrays reference the shared buffers.
+    Vector<UniquePtr<SharedGeometry>> _shared_geometry;
+    UnorderedMap<const gl::VertexArray*, Entry> _entries;
+
+private:
+    [[nodiscard]] auto find_or_create_shared_geometry(const gl::VertexLayout& layout, gl::DataType indexing_data_type,
+                                                      const gl::InstanceBuffer& instance_buffer) -> SharedGeometry&;
+    [[nodiscard]] auto add(const gl::VertexArray& vertex_array) -> Entry;
+    auto free_geometry(const Entry& entry) -> void;
+};
+
+} // namespace zth
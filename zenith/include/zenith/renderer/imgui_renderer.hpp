@@ -15,6 +15,7 @@ public:
 
     [[nodiscard]] static auto init() -> Result<void, String>;
     static auto start_frame() -> void;
+    // Records a pass which renders ImGui's draw data into Renderer's frame graph.
     static auto render() -> void;
     static auto shut_down() -> void;
 };
@@ -25,6 +25,8 @@ struct LightProperties
     glm::vec3 ambient{ 0.2f };
     glm::vec3 diffuse{ 0.5f };
     glm::vec3 specular{ 1.0f };
+
+    [[nodiscard]] auto operator==(const LightProperties&) const -> bool = default;
 };
 
 // ### Example light attenuation values:
@@ -45,9 +47,17 @@ struct LightProperties
 
 struct LightAttenuation
 {
+    // Strength below which a light's contribution rounds to nothing on an 8-bit render target.
+    static constexpr float default_min_strength = 1.0f / 256.0f;
+
     float constant = 1.0f;
     float linear = 0.22f;
     float quadratic = 0.20f;
+
+    // The distance at which the light's strength drops to min_strength. Returns infinity if it never drops that low.
+    [[nodiscard]] auto range(float min_strength = default_min_strength) const -> float;
+
+    [[nodiscard]] auto operator==(const LightAttenuation&) const -> bool = default;
 };
 
 struct DirectionalLight
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+
+#include <span>
+
+#include "zenith/core/typedefs.hpp"
+#include "zenith/math/bounds.hpp"
+#include "zenith/stl/vector.hpp"
+
+namespace zth {
+
+// The lights which affect a cluster are light_indices()[first_light_index, first_light_index + point_light_count +
+// spot_light_count). Point lights come first. Matches a uvec4 in GLSL.
+struct LightCluster
+{
+    u32 first_light_index = 0;
+    u32 point_light_count = 0;
+    u32 spot_light_count = 0;
+    u32 unused = 0;
+};
+
+static_assert(sizeof(LightCluster) == sizeof(u32) * 4);
+
+struct LightClusterStats
+{
+    u32 cluster_count = 0;
+    u32 occupied_clusters = 0; // Clusters affected by at least one light.
+    u32 max_lights_per_cluster = 0;
+    float average_lights_per_occupied_cluster = 0.0f;
+    u32 light_index_count = 0;
+};
+
+// Splits the view frustum into a grid of clusters (screen-space tiles which get split further into slices along the
+// view direction) and bins the point and spot lights into the clusters their bounding spheres touch, so that a fragment
+// only has to evaluate the lights of its cluster. The slices get exponentially thicker with distance, so that clusters
+// stay roughly cube-shaped.
+//
+// Doesn't touch OpenGL. The slices get binned in parallel on the JobSystem.
+class LightClusterGrid
+{
+public:
+    static constexpr glm::uvec3 default_size{ 16, 9, 24 };
+
+public:
+    explicit LightClusterGrid(glm::uvec3 size = default_size);
+
+    // projection must be a perspective projection. The bounding spheres must be in view space, where the camera looks
+    // down the negative z axis. A spot light's index is its index in spot_lights, not in all the lights.
+    auto build(const glm::mat4& projection, float near, float far, std::span<const math::BoundingSphere> point_lights,
+               std::span<const math::BoundingSphere> spot_lights) -> void;
+
+    [[nodiscard]] auto size() const { return _size; }
+    [[nodiscard]] auto cluster_count() const -> u32 { return _size.x * _size.y * _size.z; }
+    [[nodiscard]] auto cluster_index(u32 x, u32 y, u32 slice) const -> u32
+    {
+        return (slice * _size.y + y) * _size.x + x;
+    }
+
+    // Slices are numbered from the near plane. Depth is the distance from the camera along the view direction.
+    [[nodiscard]] auto slice_at_depth(float depth) const -> u32;
+    // A fragment at view depth d falls into slice floor(log(d) * depth_slice_scale() + depth_slice_bias()).
+    [[nodiscard]] auto depth_slice_scale() const { return _depth_slice_scale; }
+    [[nodiscard]] auto depth_slice_bias() const { return _depth_slice_bias; }
+
+    [[nodiscard]] auto clusters() const -> std::span<const LightCluster> { return _clusters; }
+    [[nodiscard]] auto light_indices() const -> std::span<const u32> { return _light_indices; }
+    [[nodiscard]] auto cluster_bounds() const -> std::span<const math::Aabb> { return _cluster_bounds; }
+    [[nodiscard]] auto stats() const -> LightClusterStats;
+
+private:
+    struct LightSlices
+    {
+        u32 first;
+        u32 last;
+    };
+
+    // Binning works on one slice at a time, so every slice gets its own scratch space.
+    struct SliceBins
+    {
+        Vector<u32> pair_clusters; // Index of the cluster within the slice.
+        Vector<u32> pair_lights;
+        Vector<u32> counts;       // Per cluster within the slice.
+        Vector<u32> point_counts; // Per cluster within the slice.
+        Vector<u32> offsets;      // Per cluster within the slice.
+        Vector<u32> light_indices;
+    };
+
+    glm::uvec3 _size;
+
+    glm::mat4 _projection{ 0.0f };
+    float _near = 0.0f;
+    float _far = 0.0f;
+    float _depth_slice_scale = 0.0f;
+    float _depth_slice_bias = 0.0f;
+
+    Vector<math::Aabb> _cluster_bounds;
+    Vector<LightCluster> _clusters;
+    Vector<u32> _light_indices;
+
+    Vector<math::BoundingSphere> _lights; // Point lights followed by spot lights.
+    Vector<LightSlices> _light_slices;
+    Vector<SliceBins> _slice_bins;
+
+private:
+    auto compute_cluster_bounds() -> void;
+    auto bin_slice(u32 slice, u32 point_light_count) -> void;
+};
+
+// The bounding sphere of a spot light's cone.
+[[nodiscard]] auto spot_light_bounds(glm::vec3 position, glm::vec3 direction, float range, float outer_cutoff_cosine)
+    -> math::BoundingSphere;
+
+} // namespace zth
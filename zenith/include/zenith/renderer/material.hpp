@@ -22,6 +22,10 @@ struct Material
     glm::vec3 diffuse{ 1.0f };
     glm::vec3 specular{ 0.6f };
     float shininess = 32.0f;
+
+    // Transparent materials get rendered after everything else, back to front, blended with what's behind them and
+    // without writing depth.
+    bool transparent = false;
 };
 
 } // namespace zth
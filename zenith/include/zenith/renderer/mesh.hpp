@@ -1,17 +1,21 @@
 #pragma once
 
+#include <concepts>
 #include <span>
 
 #include "zenith/core/typedefs.hpp"
 #include "zenith/gl/buffer.hpp"
 #include "zenith/gl/util.hpp"
 #include "zenith/gl/vertex_array.hpp"
+#include "zenith/math/bounds.hpp"
+#include "zenith/renderer/vertex.hpp"
 #include "zenith/stl/vector.hpp"
 #include "zenith/util/macros.hpp"
 
 namespace zth {
 
-// Every mesh's vertex array gets implicitly bound to the renderer's instance buffer.
+// Every mesh's vertex array gets implicitly bound to the renderer's instance buffer. Meshes have local space bounds
+// which are used for culling. Meshes whose bounds weren't computed have infinite bounds and never get culled.
 class Mesh
 {
 public:
@@ -21,14 +25,33 @@ public:
 
     [[nodiscard]] virtual auto vertex_array() -> gl::VertexArray& = 0;
     [[nodiscard]] virtual auto vertex_array() const -> const gl::VertexArray& = 0;
+
+    [[nodiscard]] auto aabb() const -> const math::Aabb& { return _aabb; }
+    [[nodiscard]] auto bounding_sphere() const -> const math::BoundingSphere& { return _bounding_sphere; }
+
+protected:
+    // Computes the bounds from the positions of the vertices, if the vertices have a 3D position. Quantized positions
+    // get decoded with the position transform.
+    template<typename Vertex>
+    auto compute_bounds(std::span<const Vertex> vertices, const gl::VertexPositionTransform& position_transform = {})
+        -> void;
+
+private:
+    math::Aabb _aabb = math::infinite_aabb;
+    math::BoundingSphere _bounding_sphere = math::infinite_bounding_sphere;
 };
 
-// Every mesh's vertex array gets implicitly bound to the renderer's instance buffer.
+// Every mesh's vertex array gets implicitly bound to the renderer's instance buffer of the given instance format.
 template<typename Vertex = StandardVertex, gl::IndexingType Index = u32> class IndexedMesh : public Mesh
 {
 public:
     explicit IndexedMesh() = default;
-    explicit IndexedMesh(std::span<const Vertex> vertex_data, std::span<const Index> index_data);
+    explicit IndexedMesh(std::span<const Vertex> vertex_data, std::span<const Index> index_data,
+                         InstanceFormat instance_format = InstanceFormat::Standard);
+    // Quantizes the vertices relative to their bounds. The vertex array gets the position transform which decodes them.
+    explicit IndexedMesh(std::span<const StandardVertex> vertex_data, std::span<const Index> index_data,
+                         InstanceFormat instance_format = InstanceFormat::Standard)
+        requires std::same_as<Vertex, CompactVertex>;
 
     IndexedMesh(const IndexedMesh& other);
     auto operator=(const IndexedMesh& other) -> IndexedMesh&;
@@ -36,7 +59,7 @@ public:
     IndexedMesh(IndexedMesh&& other) noexcept;
     auto operator=(IndexedMesh&& other) noexcept -> IndexedMesh&;
 
-    ~IndexedMesh() override = default;
+    ~IndexedMesh() override;
 
     [[nodiscard]] auto vertex_array() -> gl::VertexArray& override { return _vertex_array; }
     [[nodiscard]] auto vertex_array() const -> const gl::VertexArray& override { return _vertex_array; }
@@ -57,17 +80,22 @@ private:
 
     Vector<Vertex> _vertices;
     Vector<Index> _indices;
+
+private:
+    explicit IndexedMesh(std::span<const StandardVertex> vertex_data, std::span<const Index> index_data,
+                         InstanceFormat instance_format, const gl::VertexPositionTransform& position_transform)
+        requires std::same_as<Vertex, CompactVertex>;
 };
 
 // QuadMesh is a mesh made up of quads (sets of two triangles). There's no need to provide indices. The order of
 // vertices for a single quad should be counter-clockwise starting from the top-left vertex. The number of vertices that
 // gets drawn is the number of vertices in the vertex buffer (its size divided by its stride). Every mesh's vertex array
-// gets implicitly bound to the renderer's instance buffer.
+// gets implicitly bound to the renderer's instance buffer of the given instance format.
 template<typename Vertex = StandardVertex> class QuadMesh : public Mesh
 {
 public:
     explicit QuadMesh() = default;
-    explicit QuadMesh(std::span<const Vertex> vertex_data);
+    explicit QuadMesh(std::span<const Vertex> vertex_data, InstanceFormat instance_format = InstanceFormat::Standard);
 
     QuadMesh(const QuadMesh& other);
     auto operator=(const QuadMesh& other) -> QuadMesh&;
@@ -75,7 +103,7 @@ public:
     QuadMesh(QuadMesh&& other) noexcept;
     auto operator=(QuadMesh&& other) noexcept -> QuadMesh&;
 
-    ~QuadMesh() override = default;
+    ~QuadMesh() override;
 
     [[nodiscard]] auto vertex_array() -> gl::VertexArray& override { return _vertex_array; }
     [[nodiscard]] auto vertex_array() const -> const gl::VertexArray& override { return _vertex_array; }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <concepts>
 #include <ranges>
 #include <utility>
 
@@ -9,17 +10,68 @@
 
 namespace zth {
 
+template<typename Vertex>
+auto Mesh::compute_bounds(std::span<const Vertex> vertices, const gl::VertexPositionTransform& position_transform)
+    -> void
+{
+    if constexpr (requires(const Vertex& vertex) {
+                      { vertex.position } -> std::convertible_to<glm::vec3>;
+                  })
+    {
+        auto positions = vertices | std::views::transform([](const Vertex& vertex) -> glm::vec3 {
+            return vertex.position;
+        });
+
+        _aabb = math::compute_aabb(positions);
+        _bounding_sphere = math::compute_bounding_sphere(positions);
+    }
+    else if constexpr (requires(const Vertex& vertex) {
+                           { vertex.decode_position(position_transform) } -> std::convertible_to<glm::vec3>;
+                       })
+    {
+        // The bounds have to contain the positions which actually get rendered, which are the quantized ones.
+        auto positions = vertices | std::views::transform([&](const Vertex& vertex) -> glm::vec3 {
+            return vertex.decode_position(position_transform);
+        });
+
+        _aabb = math::compute_aabb(positions);
+        _bounding_sphere = math::compute_bounding_sphere(positions);
+    }
+}
+
 template<typename Vertex, gl::IndexingType Index>
-IndexedMesh<Vertex, Index>::IndexedMesh(std::span<const Vertex> vertex_data, std::span<const Index> index_data)
+IndexedMesh<Vertex, Index>::IndexedMesh(std::span<const Vertex> vertex_data, std::span<const Index> index_data,
+                                        InstanceFormat instance_format)
     : _vertex_buffer{ gl::VertexBuffer::create_static_with_data(vertex_data) },
       _index_buffer{ gl::IndexBuffer::create_static_with_data(index_data) },
-      _vertex_array{ _vertex_buffer, _index_buffer, Renderer::instance_buffer() },
+      _vertex_array{ _vertex_buffer, _index_buffer, Renderer::instance_buffer(instance_format) },
       _vertices{ std::from_range_t{}, vertex_data }, _indices{ std::from_range_t{}, index_data }
+{
+    compute_bounds(vertex_data);
+}
+
+template<typename Vertex, gl::IndexingType Index>
+IndexedMesh<Vertex, Index>::IndexedMesh(std::span<const StandardVertex> vertex_data, std::span<const Index> index_data,
+                                        InstanceFormat instance_format)
+    requires std::same_as<Vertex, CompactVertex>
+    : IndexedMesh{ vertex_data, index_data, instance_format, compact_position_transform(vertex_data) }
 {}
 
+template<typename Vertex, gl::IndexingType Index>
+IndexedMesh<Vertex, Index>::IndexedMesh(std::span<const StandardVertex> vertex_data, std::span<const Index> index_data,
+                                        InstanceFormat instance_format,
+                                        const gl::VertexPositionTransform& position_transform)
+    requires std::same_as<Vertex, CompactVertex>
+    : IndexedMesh{ compact_vertices(vertex_data, position_transform), index_data, instance_format }
+{
+    // The bounds have to be computed again, as the positions couldn't be decoded without the position transform.
+    _vertex_array.set_position_transform(position_transform);
+    compute_bounds(std::span<const Vertex>{ _vertices }, position_transform);
+}
+
 template<typename Vertex, gl::IndexingType Index>
 IndexedMesh<Vertex, Index>::IndexedMesh(const IndexedMesh& other)
-    : _vertex_buffer{ other._vertex_buffer }, _index_buffer{ other._index_buffer },
+    : Mesh{ other }, _vertex_buffer{ other._vertex_buffer }, _index_buffer{ other._index_buffer },
       _vertex_array{ other._vertex_array }, _vertices{ other._vertices }, _indices{ other._indices }
 {
     // Make sure that the references in the vertex array are set after copying the buffers. We don't have to rebind the
@@ -34,6 +86,7 @@ auto IndexedMesh<Vertex, Index>::operator=(const IndexedMesh& other) -> IndexedM
     if (this == &other)
         return *this;
 
+    Mesh::operator=(other);
     _vertex_buffer = other._vertex_buffer;
     _index_buffer = other._index_buffer;
     _vertex_array = other._vertex_array;
@@ -50,7 +103,8 @@ auto IndexedMesh<Vertex, Index>::operator=(const IndexedMesh& other) -> IndexedM
 
 template<typename Vertex, gl::IndexingType Index>
 IndexedMesh<Vertex, Index>::IndexedMesh(IndexedMesh&& other) noexcept
-    : _vertex_buffer{ std::move(other._vertex_buffer) }, _index_buffer{ std::move(other._index_buffer) },
+    : Mesh{ std::move(other) }, _vertex_buffer{ std::move(other._vertex_buffer) },
+      _index_buffer{ std::move(other._index_buffer) },
       _vertex_array{ std::move(other._vertex_array) }, _vertices{ std::move(other._vertices) },
       _indices{ std::move(other._indices) }
 {
@@ -63,6 +117,7 @@ IndexedMesh<Vertex, Index>::IndexedMesh(IndexedMesh&& other) noexcept
 template<typename Vertex, gl::IndexingType Index>
 auto IndexedMesh<Vertex, Index>::operator=(IndexedMesh&& other) noexcept -> IndexedMesh&
 {
+    Mesh::operator=(std::move(other));
     _vertex_buffer = std::move(other._vertex_buffer);
     _index_buffer = std::move(other._index_buffer);
     _vertex_array = std::move(other._vertex_array);
@@ -77,17 +132,25 @@ auto IndexedMesh<Vertex, Index>::operator=(IndexedMesh&& other) noexcept -> Inde
     return *this;
 }
 
+template<typename Vertex, gl::IndexingType Index> IndexedMesh<Vertex, Index>::~IndexedMesh()
+{
+    Renderer::release_pooled_geometry(_vertex_array);
+}
+
 template<typename Vertex>
-QuadMesh<Vertex>::QuadMesh(std::span<const Vertex> vertex_data)
+QuadMesh<Vertex>::QuadMesh(std::span<const Vertex> vertex_data, InstanceFormat instance_format)
     : _vertex_buffer{ gl::VertexBuffer::create_static_with_data(vertex_data) },
-      _vertex_array{ _vertex_buffer, buffers::quads_index_buffer(), Renderer::instance_buffer(),
+      _vertex_array{ _vertex_buffer, buffers::quads_index_buffer(), Renderer::instance_buffer(instance_format),
                      static_cast<u32>(get_triangle_vertex_count_from_quad_vertex_count(_vertex_buffer.count())) },
       _vertices{ std::from_range_t{}, vertex_data }
-{}
+{
+    compute_bounds(vertex_data);
+}
 
 template<typename Vertex>
 QuadMesh<Vertex>::QuadMesh(const QuadMesh& other)
-    : _vertex_buffer{ other._vertex_buffer }, _vertex_array{ other._vertex_array }, _vertices{ other._vertices }
+    : Mesh{ other }, _vertex_buffer{ other._vertex_buffer }, _vertex_array{ other._vertex_array },
+      _vertices{ other._vertices }
 {
     // Make sure that the references in the vertex array are set after copying the vertex buffer. We don't have to
     // rebind the layout.
@@ -101,6 +164,7 @@ template<typename Vertex> auto QuadMesh<Vertex>::operator=(const QuadMesh& other
     if (this == &other)
         return *this;
 
+    Mesh::operator=(other);
     _vertex_buffer = other._vertex_buffer;
     _vertex_array = other._vertex_array;
     _vertices = other._vertices;
@@ -116,7 +180,8 @@ template<typename Vertex> auto QuadMesh<Vertex>::operator=(const QuadMesh& other
 
 template<typename Vertex>
 QuadMesh<Vertex>::QuadMesh(QuadMesh&& other) noexcept
-    : _vertex_buffer{ std::move(other._vertex_buffer) }, _vertex_array{ std::move(other._vertex_array) },
+    : Mesh{ std::move(other) }, _vertex_buffer{ std::move(other._vertex_buffer) },
+      _vertex_array{ std::move(other._vertex_array) },
       _vertices{ std::move(other._vertices) }
 {
     // Make sure that the references in the vertex array are set again after moving the buffers. We don't have to rebind
@@ -128,6 +193,7 @@ QuadMesh<Vertex>::QuadMesh(QuadMesh&& other) noexcept
 
 template<typename Vertex> auto QuadMesh<Vertex>::operator=(QuadMesh&& other) noexcept -> QuadMesh&
 {
+    Mesh::operator=(std::move(other));
     _vertex_buffer = std::move(other._vertex_buffer);
     _vertex_array = std::move(other._vertex_array);
     _vertices = std::move(other._vertices);
@@ -141,6 +207,11 @@ template<typename Vertex> auto QuadMesh<Vertex>::operator=(QuadMesh&& other) noe
     return *this;
 }
 
+template<typename Vertex> QuadMesh<Vertex>::~QuadMesh()
+{
+    Renderer::release_pooled_geometry(_vertex_array);
+}
+
 template<typename Vertex> auto QuadMesh<Vertex>::index_buffer() const -> const gl::IndexBuffer&
 {
     return buffers::quads_index_buffer();
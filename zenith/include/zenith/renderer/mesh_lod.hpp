@@ -0,0 +1,72 @@
+#pragma once
+
+#include <glm/vec3.hpp>
+
+#include <memory>
+#include <span>
+
+#include "zenith/core/typedefs.hpp"
+#include "zenith/math/bounds.hpp"
+#include "zenith/renderer/mesh.hpp"
+#include "zenith/renderer/vertex.hpp"
+#include "zenith/stl/vector.hpp"
+
+namespace zth {
+
+struct MeshLodLevel
+{
+    std::shared_ptr<const Mesh> mesh;
+    // The level gets used while the mesh covers at least this fraction of the screen's height. The levels' screen sizes
+    // have to be decreasing, and the last level gets used for anything smaller than its screen size as well.
+    float min_screen_size = 0.0f;
+};
+
+struct MeshLodSettings
+{
+    u32 level_count = 4;                // Including the source mesh.
+    float triangle_ratio = 0.5f;        // Every level aims for this fraction of the previous level's triangles.
+    float max_error = 0.02f;            // Relative to the radius of the source mesh's bounding sphere.
+    float first_min_screen_size = 0.5f; // The min screen size of the source mesh.
+    float min_screen_size_ratio = 0.5f; // Every level's min screen size is this fraction of the previous level's one.
+};
+
+// A chain of meshes of decreasing detail. Every level should look like the source mesh from far away enough. Levels
+// get selected based on the bounds of the first level, so that every level switches at the same distance regardless of
+// how much its own bounds shrank.
+class MeshLod
+{
+public:
+    // The fraction by which the screen size has to go past a threshold before the level changes, so that a mesh which
+    // sits right at a threshold doesn't keep switching back and forth between two levels.
+    static constexpr float default_hysteresis = 0.1f;
+
+public:
+    explicit MeshLod(Vector<MeshLodLevel>&& levels);
+
+    // Generates the levels by simplifying the mesh with simplify_mesh(). Stops early once the simplifier can't reduce
+    // the triangle count any further without going over the max error.
+    [[nodiscard]] static auto generate(const std::shared_ptr<const IndexedMesh<StandardVertex, u32>>& mesh,
+                                       const MeshLodSettings& settings = {}) -> MeshLod;
+
+    [[nodiscard]] auto levels() const -> std::span<const MeshLodLevel> { return _levels; }
+    [[nodiscard]] auto level_count() const -> u32 { return static_cast<u32>(_levels.size()); }
+    [[nodiscard]] auto bounding_sphere() const -> const math::BoundingSphere&;
+
+    [[nodiscard]] auto select_level(float screen_size, u32 current_level, float hysteresis = default_hysteresis) const
+        -> u32;
+
+private:
+    Vector<MeshLodLevel> _levels;
+};
+
+// Returns the level which should be used for a mesh which covers screen_size of the screen's height and currently uses
+// current_level. Doesn't touch OpenGL.
+[[nodiscard]] auto select_lod_level(std::span<const MeshLodLevel> levels, float screen_size, u32 current_level,
+                                    float hysteresis = MeshLod::default_hysteresis) -> u32;
+
+// Returns the fraction of the screen's height that the sphere covers when seen with a perspective camera with the given
+// vertical field of view (in radians). Returns infinity if the camera is inside of the sphere.
+[[nodiscard]] auto lod_screen_size(const math::BoundingSphere& world_bounds, glm::vec3 camera_position, float fov)
+    -> float;
+
+} // namespace zth
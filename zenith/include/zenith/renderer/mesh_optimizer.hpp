@@ -0,0 +1,60 @@
+#pragma once
+
+#include <glm/vec3.hpp>
+
+#include <concepts>
+#include <limits>
+#include <span>
+
+#include "zenith/core/typedefs.hpp"
+#include "zenith/stl/vector.hpp"
+
+namespace zth {
+
+struct VertexCacheStats
+{
+    // Average cache miss ratio: the number of vertex shader invocations per triangle. Lies between 0.5 (for big,
+    // regular meshes) and 3, lower is better.
+    float acmr = 0.0f;
+    // Average transformed vertex ratio: the number of vertex shader invocations per vertex. 1 is the best possible.
+    float atvr = 0.0f;
+};
+
+struct MeshOptimizationStats
+{
+    VertexCacheStats before;
+    VertexCacheStats after;
+};
+
+// The size of the FIFO post-transform cache that the vertex cache statistics and the overdraw optimization simulate.
+constexpr inline u32 default_vertex_cache_size = 16;
+// Marks the vertices which aren't referenced by any index in the table returned by remap_for_vertex_fetch().
+constexpr inline u32 unused_vertex = std::numeric_limits<u32>::max();
+
+// All of the following functions are pure CPU algorithms. Triangles always keep their winding.
+
+[[nodiscard]] auto analyze_vertex_cache(std::span<const u32> indices, usize vertex_count,
+                                        u32 cache_size = default_vertex_cache_size) -> VertexCacheStats;
+
+// Reorders the triangles so that they reuse the vertices which are still in the post-transform cache, using Tom
+// Forsyth's linear-speed vertex cache optimization. Doesn't assume any particular cache size.
+auto optimize_vertex_cache(std::span<u32> indices, usize vertex_count) -> void;
+
+// Splits the triangles into clusters and reorders the clusters so that the ones which face outwards of the mesh get
+// drawn first and occlude the ones behind them, which cuts down on overdraw. Should run after optimize_vertex_cache(),
+// as the clusters get split where the vertex cache would have been cold anyway. threshold is how much worse the ACMR of
+// a cluster is allowed to get in exchange for splitting it into smaller clusters, which sort better.
+auto optimize_overdraw(std::span<u32> indices, std::span<const glm::vec3> positions, float threshold = 1.05f) -> void;
+
+// Renumbers the vertices in the order in which the indices first reference them, so that the vertex fetches go through
+// memory linearly. Returns the new index of every vertex, or unused_vertex for the vertices which no index references.
+[[nodiscard]] auto remap_for_vertex_fetch(std::span<u32> indices, usize vertex_count) -> Vector<u32>;
+
+// Runs all of the optimizations on the mesh. Vertices which aren't referenced by any index get removed. The overdraw
+// optimization only runs if the vertices have a 3D position.
+template<typename Vertex, std::unsigned_integral Index>
+auto optimize_mesh(Vector<Vertex>& vertices, Vector<Index>& indices) -> MeshOptimizationStats;
+
+} // namespace zth
+
+#include "mesh_optimizer.inl"
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <ranges>
+#include <utility>
+
+namespace zth {
+
+template<typename Vertex, std::unsigned_integral Index>
+auto optimize_mesh(Vector<Vertex>& vertices, Vector<Index>& indices) -> MeshOptimizationStats
+{
+    MeshOptimizationStats result;
+
+    Vector<u32> working_indices{ std::from_range_t{}, indices };
+    result.before = analyze_vertex_cache(working_indices, vertices.size());
+
+    optimize_vertex_cache(working_indices, vertices.size());
+
+    if constexpr (requires(const Vertex& vertex) {
+                      { vertex.position } -> std::convertible_to<glm::vec3>;
+                  })
+    {
+        auto positions = vertices | std::views::transform([](const Vertex& vertex) -> glm::vec3 {
+            return vertex.position;
+        });
+
+        Vector<glm::vec3> position_data{ std::from_range_t{}, positions };
+        optimize_overdraw(working_indices, position_data);
+    }
+
+    auto remap = remap_for_vertex_fetch(working_indices, vertices.size());
+    result.after = analyze_vertex_cache(working_indices, vertices.size());
+
+    auto used_vertex_count = std::ranges::count_if(remap, [](u32 index) { return index != unused_vertex; });
+
+    Vector<Vertex> remapped_vertices;
+    remapped_vertices.resize(static_cast<usize>(used_vertex_count));
+
+    for (usize vertex = 0; vertex < vertices.size(); vertex++)
+    {
+        if (remap[vertex] != unused_vertex)
+            remapped_vertices[remap[vertex]] = vertices[vertex];
+    }
+
+    vertices = std::move(remapped_vertices);
+
+    for (usize i = 0; i < indices.size(); i++)
+        indices[i] = static_cast<Index>(working_indices[i]);
+
+    return result;
+}
+
+} // namespace zth
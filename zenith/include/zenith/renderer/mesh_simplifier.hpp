@@ -0,0 +1,32 @@
+#pragma once
+
+#include <limits>
+#include <span>
+
+#include "zenith/core/typedefs.hpp"
+#include "zenith/renderer/vertex.hpp"
+#include "zenith/stl/vector.hpp"
+
+namespace zth {
+
+struct SimplifiedMesh
+{
+    Vector<u32> indices; // Index into the vertices that were simplified.
+    // The square root of the biggest quadric error of all the collapses, which is roughly the furthest that the surface
+    // moved away from where it used to be, in the same units as the positions.
+    float error = 0.0f;
+};
+
+// Simplifies a triangle mesh by collapsing its edges one by one, always picking the collapses which introduce the least
+// error, measured with quadrics (Garland and Heckbert). Vertices only ever get collapsed onto one of their neighbours,
+// so the result indexes into the same vertices. Vertices on open borders and on attribute seams (where vertices share a
+// position, but have different normals or uvs) never move, which keeps the outline of the mesh and its texture mapping
+// intact. Collapses which would flip a triangle over or make the mesh non-manifold get rejected.
+//
+// Stops once there are no more than target_index_count indices left, or when every collapse that's left would introduce
+// an error bigger than max_error. Doesn't touch OpenGL.
+[[nodiscard]] auto simplify_mesh(std::span<const StandardVertex> vertices, std::span<const u32> indices,
+                                 usize target_index_count, float max_error = std::numeric_limits<float>::infinity())
+    -> SimplifiedMesh;
+
+} // namespace zth
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+
+#include <span>
+
+#include "zenith/core/typedefs.hpp"
+#include "zenith/math/bounds.hpp"
+#include "zenith/stl/vector.hpp"
+
+namespace zth {
+
+struct OcclusionCullingStats
+{
+    u32 occluders = 0;
+    u32 occluder_triangles = 0; // Triangles which ended up being rasterized, after clipping.
+    u32 tested_objects = 0;
+    u32 occluded_objects = 0;
+};
+
+// A low-poly stand-in for the geometry of an object which hides what's behind it, e.g. a wall. It has to lie entirely
+// inside of the object, otherwise it might hide things which are actually visible. Lives on the CPU only.
+class OccluderMesh
+{
+public:
+    explicit OccluderMesh(std::span<const glm::vec3> positions, std::span<const u32> indices);
+
+    // The 12 triangles of the box.
+    [[nodiscard]] static auto box(const math::Aabb& aabb) -> OccluderMesh;
+
+    [[nodiscard]] auto positions() const -> std::span<const glm::vec3> { return _positions; }
+    [[nodiscard]] auto indices() const -> std::span<const u32> { return _indices; }
+    [[nodiscard]] auto triangle_count() const -> u32 { return static_cast<u32>(_indices.size() / 3); }
+
+private:
+    Vector<glm::vec3> _positions;
+    Vector<u32> _indices;
+};
+
+// A small software depth buffer which the occluders get rasterized into, with a hierarchical depth pyramid built on top
+// of it. Every level of the pyramid stores the farthest depth of the 2x2 texels below it, so that a box is hidden if
+// its nearest point lies behind every texel of the level which covers its screen space rectangle with a few texels.
+//
+// The occluders get clipped against the near plane, transformed and binned into tiles, and then the tiles get
+// rasterized in parallel on the JobSystem, four pixels at a time when SSE is available. The depths stored are the
+// farthest depths of the triangles within every pixel, so that the buffer never hides more than the occluders do.
+// The pixels count as covered by a triangle if their centers are, which is the only approximation.
+//
+// Depth is the NDC depth mapped to [0, 1], so the buffer assumes OpenGL clip space conventions. Doesn't touch OpenGL.
+class OcclusionBuffer
+{
+public:
+    static constexpr glm::uvec2 default_size{ 256, 128 };
+    static constexpr u32 tile_size = 32;
+
+public:
+    // The size must be a multiple of the tile size.
+    explicit OcclusionBuffer(glm::uvec2 size = default_size);
+
+    // Clears the depth buffer and forgets the occluders of the last frame.
+    auto begin(const glm::mat4& view_projection) -> void;
+    // The occluder has to stay alive until finish() returns.
+    auto add_occluder(const OccluderMesh& occluder, const glm::mat4& transform) -> void;
+    // Rasterizes the occluders and builds the depth pyramid.
+    auto finish() -> void;
+
+    // Returns false only if the box lies entirely behind the occluders rasterized by the last call to finish(). Boxes
+    // which cross the near plane or which lie outside of the screen are always visible. Can be called concurrently.
+    [[nodiscard]] auto is_visible(const math::Aabb& aabb) const -> bool;
+
+    [[nodiscard]] auto size() const { return _size; }
+    [[nodiscard]] auto level_count() const -> u32 { return static_cast<u32>(_levels.size()); }
+    [[nodiscard]] auto level_size(u32 level) const -> glm::uvec2;
+    // Row-major, starting at the bottom row. Level 0 is the depth buffer itself.
+    [[nodiscard]] auto level(u32 level) const -> std::span<const float>;
+
+    [[nodiscard]] auto occluder_count() const -> u32 { return static_cast<u32>(_occluders.size()); }
+    [[nodiscard]] auto triangle_count() const -> u32 { return _triangle_count; }
+
+private:
+    struct Occluder
+    {
+        const OccluderMesh* mesh;
+        glm::mat4 transform; // Includes the view-projection.
+        u32 first_triangle;  // Every triangle of the mesh gets two slots, as clipping might split it in two.
+    };
+
+    // Vertices in pixel coordinates, with depth in [0, 1].
+    struct ScreenTriangle
+    {
+        glm::vec3 a{ 0.0f };
+        glm::vec3 b{ 0.0f };
+        glm::vec3 c{ 0.0f };
+        glm::ivec2 min{ 0 }; // Inclusive bounds of the pixels which might be covered, clamped to the screen.
+        glm::ivec2 max{ -1 };
+        bool valid = false;
+    };
+
+    struct Level
+    {
+        glm::uvec2 size;
+        u32 offset;
+    };
+
+    glm::uvec2 _size;
+    glm::uvec2 _tile_count;
+    glm::mat4 _view_projection{ 1.0f };
+
+    Vector<Level> _levels;
+    Vector<float> _depth; // All the levels, one after another.
+
+    Vector<Occluder> _occluders;
+    Vector<ScreenTriangle> _triangles;
+    Vector<Vector<u32>> _tile_bins; // Indices of the triangles which overlap every tile.
+    u32 _triangle_count = 0;
+
+private:
+    auto set_up_triangles(const Occluder& occluder) -> void;
+    auto rasterize_tile(u32 tile) -> void;
+    auto build_level(u32 level) -> void;
+};
+
+} // namespace zth
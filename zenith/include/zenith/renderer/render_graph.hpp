@@ -0,0 +1,271 @@
+#pragma once
+
+#include <glm/vec2.hpp>
+
+#include <functional>
+#include <span>
+
+#include "zenith/core/typedefs.hpp"
+#include "zenith/gl/buffer.hpp"
+#include "zenith/gl/framebuffer.hpp"
+#include "zenith/gl/fwd.hpp"
+#include "zenith/gl/texture.hpp"
+#include "zenith/memory/managed.hpp"
+#include "zenith/renderer/fwd.hpp"
+#include "zenith/stl/string.hpp"
+#include "zenith/stl/vector.hpp"
+#include "zenith/util/optional.hpp"
+#include "zenith/util/result.hpp"
+
+namespace zth {
+
+// Handles to the resources of a render graph. They're only valid for the graph which created them, until it gets
+// cleared.
+struct RenderGraphTexture
+{
+    u32 index = 0;
+};
+
+struct RenderGraphBuffer
+{
+    u32 index = 0;
+};
+
+struct RenderGraphTextureDesc
+{
+    glm::uvec2 size{ 0 };
+    gl::SizedTextureFormat format = gl::SizedTextureFormat::Rgba8;
+
+    [[nodiscard]] auto operator==(const RenderGraphTextureDesc& other) const -> bool = default;
+};
+
+struct RenderGraphBufferDesc
+{
+    u32 size = 0; // In bytes.
+};
+
+enum class RenderGraphResourceType : u8
+{
+    Texture,
+    Buffer,
+};
+
+struct RenderGraphResource
+{
+    String name;
+    RenderGraphResourceType type = RenderGraphResourceType::Texture;
+    RenderGraphTextureDesc texture_desc{};
+    RenderGraphBufferDesc buffer_desc{};
+    usize size_bytes = 0;
+
+    // Imported resources live outside of the graph. The graph doesn't allocate them and every write to them counts as a
+    // side effect, so the passes which write them never get culled.
+    bool imported = false;
+    bool backbuffer = false; // The default framebuffer.
+    const gl::Texture2D* imported_texture = nullptr;
+    const gl::Buffer* imported_buffer = nullptr;
+
+    // Filled in by compile(). Positions of the passes which use the resource first and last in the execution order.
+    // Unset if no pass which runs uses the resource.
+    Optional<u32> first_use = nil;
+    Optional<u32> last_use = nil;
+    // Index of the allocation that the transient resource shares with the other resources aliased onto it.
+    Optional<u32> allocation = nil;
+};
+
+class RenderGraphPassContext;
+
+struct RenderGraphPass
+{
+    using Execute = std::function<void(const RenderGraphPassContext& context)>;
+
+    String name;
+    Vector<u32> reads{};
+    Vector<u32> writes{}; // Includes the attachments.
+    Vector<u32> color_attachments{};
+    Optional<u32> depth_attachment = nil;
+    bool side_effect = false;
+    Execute execute{};
+
+    bool culled = false; // Filled in by compile().
+};
+
+// A single allocation shared by transient resources whose lifetimes don't overlap. Textures only share allocations with
+// textures with the same description, buffers share allocations with buffers of any size.
+struct RenderGraphAllocation
+{
+    RenderGraphResourceType type = RenderGraphResourceType::Texture;
+    RenderGraphTextureDesc texture_desc{};
+    RenderGraphBufferDesc buffer_desc{};
+    usize size_bytes = 0;
+    u32 last_use = 0;
+    Vector<u32> resources{};
+};
+
+struct RenderGraphStats
+{
+    u32 passes = 0;
+    u32 culled_passes = 0;
+    u32 transient_resources = 0; // Only the ones used by the passes which run.
+    u32 allocations = 0;
+    usize transient_bytes = 0; // What the transient resources would take up if each of them had its own allocation.
+    usize allocated_bytes = 0;
+
+    [[nodiscard]] auto saved_bytes() const -> usize { return transient_bytes - allocated_bytes; }
+};
+
+class RenderGraphPassBuilder
+{
+public:
+    explicit RenderGraphPassBuilder(RenderGraph& graph, u32 pass_index);
+
+    // The pass reads the resource, e.g. samples the texture or binds the buffer as a uniform buffer.
+    auto read(RenderGraphTexture texture) -> void;
+    auto read(RenderGraphBuffer buffer) -> void;
+    auto write(RenderGraphBuffer buffer) -> void;
+    // The pass renders into the texture. The color attachments get bound in the order in which they get declared.
+    auto write_color(RenderGraphTexture texture) -> void;
+    auto write_depth(RenderGraphTexture texture) -> void;
+    // Keeps the pass from getting culled even if nothing reads what it writes.
+    auto set_side_effect() -> void;
+
+private:
+    RenderGraph& _graph;
+    u32 _pass_index;
+};
+
+// Owns the OpenGL objects behind the transient resources of a render graph. Keeps them around between frames, so that
+// a graph which stays the same from frame to frame doesn't allocate anything after the first frame.
+class RenderGraphResourcePool
+{
+public:
+    // Objects which weren't used for this many frames get freed.
+    static constexpr u32 max_unused_frames = 3;
+
+public:
+    // The textures get clamped to the edges and sampled with nearest filtering.
+    [[nodiscard]] auto acquire_texture(const RenderGraphTextureDesc& desc) -> const gl::Texture2D&;
+    [[nodiscard]] auto acquire_buffer(const RenderGraphBufferDesc& desc) -> const gl::Buffer&;
+    [[nodiscard]] auto framebuffer(std::span<const gl::Texture2D* const> color_attachments,
+                                   const gl::Texture2D* depth_attachment) -> const gl::Framebuffer&;
+
+    // Releases everything acquired during the frame.
+    auto end_frame() -> void;
+    auto clear() -> void;
+
+    [[nodiscard]] auto allocated_bytes() const -> usize;
+
+private:
+    struct PooledTexture
+    {
+        RenderGraphTextureDesc desc;
+        gl::Texture2D texture;
+        usize size_bytes = 0;
+        u32 unused_frames = 0;
+        bool acquired = false;
+    };
+
+    struct PooledBuffer
+    {
+        RenderGraphBufferDesc desc;
+        gl::Buffer buffer;
+        u32 unused_frames = 0;
+        bool acquired = false;
+    };
+
+    struct CachedFramebuffer
+    {
+        Vector<const gl::Texture2D*> color_attachments;
+        const gl::Texture2D* depth_attachment;
+        gl::Framebuffer framebuffer;
+    };
+
+    // Behind pointers, so that the references handed out stay valid when more objects get acquired.
+    Vector<UniquePtr<PooledTexture>> _textures;
+    Vector<UniquePtr<PooledBuffer>> _buffers;
+    Vector<UniquePtr<CachedFramebuffer>> _framebuffers;
+};
+
+// Gets passed to every pass when it's executed. Gives the pass the objects behind its resources. The pass's attachments
+// are already bound when it's executed.
+class RenderGraphPassContext
+{
+public:
+    explicit RenderGraphPassContext(const RenderGraph& graph, std::span<const gl::Texture2D* const> textures,
+                                    std::span<const gl::Buffer* const> buffers, const gl::Framebuffer* framebuffer);
+
+    [[nodiscard]] auto texture(RenderGraphTexture texture) const -> const gl::Texture2D&;
+    [[nodiscard]] auto buffer(RenderGraphBuffer buffer) const -> const gl::Buffer&;
+    // Null if the pass renders into the default framebuffer or doesn't render into any attachments.
+    [[nodiscard]] auto framebuffer() const -> const gl::Framebuffer* { return _framebuffer; }
+
+private:
+    const RenderGraph& _graph;
+    std::span<const gl::Texture2D* const> _textures; // Indexed by the resource indices.
+    std::span<const gl::Buffer* const> _buffers;     // Indexed by the resource indices.
+    const gl::Framebuffer* _framebuffer;
+};
+
+// Describes the work of a frame as passes which declare the resources they read and write. Compiling the graph culls
+// the passes whose results nobody uses and works out how long every transient resource has to live, so that the
+// transient resources whose lifetimes don't overlap can share memory. Compiling doesn't touch OpenGL.
+//
+// Passes run in the order in which they were added, so a pass reads what the passes added before it wrote.
+class RenderGraph
+{
+public:
+    [[nodiscard]] auto create_texture(StringView name, const RenderGraphTextureDesc& desc) -> RenderGraphTexture;
+    [[nodiscard]] auto create_buffer(StringView name, const RenderGraphBufferDesc& desc) -> RenderGraphBuffer;
+    // The texture can be null if the graph only needs the resource to order the passes.
+    [[nodiscard]] auto import_texture(StringView name, const gl::Texture2D* texture = nullptr) -> RenderGraphTexture;
+    [[nodiscard]] auto import_buffer(StringView name, const gl::Buffer* buffer = nullptr) -> RenderGraphBuffer;
+    // The default framebuffer. Passes which render into it can't have any other attachments.
+    [[nodiscard]] auto backbuffer() -> RenderGraphTexture;
+
+    auto add_pass(StringView name, std::invocable<RenderGraphPassBuilder&> auto&& setup,
+                  RenderGraphPass::Execute execute) -> void;
+
+    [[nodiscard]] auto compile() -> Result<void, String>;
+    // Compiles the graph if it isn't compiled yet and runs the passes which didn't get culled.
+    auto execute(RenderGraphResourcePool& pool) -> void;
+    // Removes all the passes and resources.
+    auto clear() -> void;
+
+    // A human-readable description of the compiled graph: the passes in the order in which they run, the resources with
+    // their lifetimes and allocations, and the memory saved by aliasing.
+    [[nodiscard]] auto dump() const -> String;
+
+    [[nodiscard]] auto empty() const -> bool { return _passes.empty(); }
+    [[nodiscard]] auto compiled() const -> bool { return _compiled; }
+    [[nodiscard]] auto passes() const -> std::span<const RenderGraphPass> { return _passes; }
+    [[nodiscard]] auto resources() const -> std::span<const RenderGraphResource> { return _resources; }
+    [[nodiscard]] auto allocations() const -> std::span<const RenderGraphAllocation> { return _allocations; }
+    // Indices of the passes which run, in the order in which they run.
+    [[nodiscard]] auto execution_order() const -> std::span<const u32> { return _execution_order; }
+    [[nodiscard]] auto stats() const -> const RenderGraphStats& { return _stats; }
+
+    [[nodiscard]] auto resource(RenderGraphTexture texture) const -> const RenderGraphResource&;
+    [[nodiscard]] auto resource(RenderGraphBuffer buffer) const -> const RenderGraphResource&;
+
+private:
+    friend class RenderGraphPassBuilder;
+
+    Vector<RenderGraphPass> _passes;
+    Vector<RenderGraphResource> _resources;
+    Optional<u32> _backbuffer = nil;
+
+    bool _compiled = false;
+    Vector<u32> _execution_order;
+    Vector<RenderGraphAllocation> _allocations;
+    RenderGraphStats _stats{};
+
+private:
+    auto add_resource(RenderGraphResource&& resource) -> u32;
+    auto cull_passes() -> void;
+    auto compute_lifetimes() -> void;
+    auto alias_resources() -> void;
+};
+
+} // namespace zth
+
+#include "render_graph.inl"
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <functional>
+#include <utility>
+
+namespace zth {
+
+auto RenderGraph::add_pass(StringView name, std::invocable<RenderGraphPassBuilder&> auto&& setup,
+                           RenderGraphPass::Execute execute) -> void
+{
+    _compiled = false;
+
+    auto pass_index = static_cast<u32>(_passes.size());
+    _passes.push_back(RenderGraphPass{ .name = String{ name }, .execute = std::move(execute) });
+
+    RenderGraphPassBuilder builder{ *this, pass_index };
+    std::invoke(setup, builder);
+}
+
+} // namespace zth
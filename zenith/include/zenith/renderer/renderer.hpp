@@ -1,58 +1,209 @@
 #pragma once
 
 #include <glm/fwd.hpp>
+#include <glm/mat3x3.hpp>
 #include <glm/mat4x4.hpp>
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
 #include <glm/vec4.hpp>
 
+#include <array>
+#include <cstddef>
+#include <span>
+
 #include "zenith/core/typedefs.hpp"
 #include "zenith/ecs/fwd.hpp"
 #include "zenith/gl/buffer.hpp"
 #include "zenith/gl/fwd.hpp"
+#include "zenith/gl/gpu_timer.hpp"
+#include "zenith/gl/texture.hpp"
 #include "zenith/gl/vertex_array.hpp"
 #include "zenith/math/geometry.hpp"
 #include "zenith/renderer/colors.hpp"
+#include "zenith/renderer/draw_key.hpp"
+#include "zenith/renderer/draw_list.hpp"
 #include "zenith/renderer/fwd.hpp"
+#include "zenith/renderer/geometry_pool.hpp"
 #include "zenith/renderer/light.hpp"
+#include "zenith/renderer/light_clusters.hpp"
+#include "zenith/renderer/occlusion_buffer.hpp"
+#include "zenith/renderer/render_graph.hpp"
 #include "zenith/renderer/resources/buffers.hpp"
+#include "zenith/renderer/retained_draw_list.hpp"
 #include "zenith/renderer/shader_data.hpp"
 #include "zenith/renderer/vertex.hpp"
+#include "zenith/stl/map.hpp"
 #include "zenith/stl/string.hpp"
 #include "zenith/stl/vector.hpp"
 #include "zenith/system/fwd.hpp"
 #include "zenith/system/temporary_storage.hpp"
+#include "zenith/util/meta.hpp"
+#include "zenith/util/optional.hpp"
 #include "zenith/util/result.hpp"
 
 namespace zth {
 
+enum class ShadingMode : u8
+{
+    Forward,
+    // Materials which use the standard shader get rendered into a G-buffer first and lit afterwards with a single
+    // full-screen pass, so that every pixel gets lit only once no matter how much geometry overlaps it.
+    Deferred,
+
+    MinEnumValue = Forward,
+    MaxEnumValue = Deferred,
+};
+
+// The objects that a material binds when it's used for drawing. The rest of a material's properties get read by the
+// shaders from the material table, so materials with the same bindings can be used in the same draw call.
+struct MaterialBindings
+{
+    const gl::Shader* shader;
+    const gl::Texture2D* diffuse_map;
+    const gl::Texture2D* specular_map;
+    const gl::Texture2D* emission_map;
+
+    [[nodiscard]] static auto of(const Material& material) -> MaterialBindings;
+
+    [[nodiscard]] auto operator==(const MaterialBindings&) const -> bool = default;
+};
+
+template<> struct Hash<MaterialBindings>
+{
+    [[nodiscard]] auto operator()(const MaterialBindings& bindings) const -> std::size_t;
+};
+
+// The transforms of submitted instances get copied into the renderer's transform staging array, so a draw command only
+// refers to a range of that array. Retained draw commands don't have any transforms, as their instances already are in
+// the instance buffer of their vertex array, so they refer to a range of the instance buffer's slots instead.
 struct DrawCommand
 {
+    RenderPass pass;
     const gl::VertexArray* vertex_array;
     const Material* material;
-    const glm::mat4* transform;
-
-    // Comparison operators are used to sort draw commands into batches.
-    [[nodiscard]] auto operator==(const DrawCommand& other) const -> bool;
-    [[nodiscard]] auto operator<(const DrawCommand& other) const -> bool;
-    [[nodiscard]] auto operator>(const DrawCommand& other) const -> bool;
-    [[nodiscard]] auto operator<=(const DrawCommand& other) const -> bool;
-    [[nodiscard]] auto operator>=(const DrawCommand& other) const -> bool;
+    u32 material_index;       // Index into the material table.
+    u32 material_bindings_id; // Draw commands whose materials have the same bindings have the same id.
+    u32 first_transform;
+    u32 transform_count;
+    bool retained = false;
+    bool composed = false; // The rotations and the scales of the transforms are known.
+
+    // Draw commands which belong to the same pass, reference the same vertex array and whose materials have the same
+    // bindings can be rendered in the same batch. The bindings don't say whether a material is transparent, so the pass
+    // has to be compared as well.
+    [[nodiscard]] auto batchable_with(const DrawCommand& other) const -> bool;
 };
 
-// Draw commands which use the same vertex array get merged into a render batch in order to utilize instanced rendering.
-// Make sure that a render batch is destroyed before the next frame starts since it uses temporary storage.
+// Draw commands which use the same vertex array and material bindings get merged into a render batch in order to
+// utilize instanced rendering. A render batch refers to a range of the sorted draw keys, so it's only valid until the
+// end of the scene.
 struct RenderBatch
 {
+    RenderPass pass;
     const gl::VertexArray* vertex_array;
-    const Material* material;
-    TemporaryVector<const glm::mat4*> transforms;
+    const Material* material; // The material of the first draw command. Every draw command has the same bindings.
+    u32 material_bindings_id;
+    u32 first_draw_key;
+    u32 draw_key_count;
+    u32 instance_count;
+    bool retained = false; // Rendered straight from the vertex array's own instance buffer.
+};
+
+struct BatchingStats
+{
+    u32 batches = 0;
+    // Batches which would've been rendered separately if every material had to be bound on its own.
+    u32 merged_batches = 0;
+};
+
+// Merges the draw commands that the sorted draw keys refer to into render batches, which get appended to batches.
+// material_last_batch is scratch space. Doesn't touch OpenGL.
+[[nodiscard]] auto build_render_batches(std::span<const DrawCommand> draw_commands,
+                                        std::span<const DrawKeyEntry> sorted_draw_keys, u32 material_count,
+                                        Vector<u32>& material_last_batch, Vector<RenderBatch>& batches)
+    -> BatchingStats;
+
+struct CullingStats
+{
+    u32 submitted_instances = 0; // Instances which made it to the renderer.
+    u32 culled_instances = 0;    // Instances which were culled before being submitted.
+};
+
+// How long the GPU took to execute every pass of the last scene rendered, in seconds. The deferred shading passes are 0
+// in forward shading mode. The forward and G-buffer passes include their depth pre-passes.
+struct RenderPassTimings
+{
+    double forward_pass = 0.0;
+    double gbuffer_pass = 0.0;
+    double lighting_pass = 0.0;
+    double transparent_pass = 0.0;
+};
+
+// How many samples the opaque geometry of the last scene that the GPU finished shaded, compared to how many samples the
+// viewport has. Their ratio is the average overdraw, which the depth pre-pass brings down to 1 for the pixels which are
+// covered by opaque geometry. With multisampling every covered sample counts.
+struct OverdrawStats
+{
+    u64 shaded_samples = 0;
+    u64 viewport_samples = 0;
+};
+
+// Everything that the 3D renderer did during a frame. Binds only include the calls which reached the driver. Times are
+// in seconds.
+struct RendererStats
+{
+    u32 draw_calls = 0;
+    u32 depth_prepass_draw_calls = 0; // Included in draw_calls.
+    u32 transparent_draw_calls = 0;   // Included in draw_calls.
+    u32 instances = 0;
+    u64 triangles = 0;
+    u32 batches = 0;
+
+    u32 shader_binds = 0;
+    u32 material_binds = 0;
+    u32 texture_binds = 0;
+    u32 vertex_array_binds = 0;
+
+    u32 instance_bytes_uploaded = 0;
+    u32 draw_indirect_bytes_uploaded = 0;
+    u32 uniform_bytes_uploaded = 0;
+    u32 storage_bytes_uploaded = 0;
+    u32 buffer_reallocations = 0; // Uploads which didn't fit into a buffer, so the buffer had to grow.
+
+    u32 directional_lights = 0;
+    u32 point_lights = 0;
+    u32 spot_lights = 0;
+    u32 ambient_lights = 0;
+
+    double sort_time = 0.0;
+    double batch_time = 0.0; // Merging the draw lists and building the batches.
+    double upload_time = 0.0; // Uploading the camera, light and material data.
+};
+
+struct Renderer2DStats
+{
+    u32 draw_calls = 0;
+    u32 quads = 0;
+    u32 batches = 0;
+    u32 vertex_bytes_uploaded = 0;
+};
+
+// The layout of this struct is defined by OpenGL.
+struct DrawElementsIndirectCommand
+{
+    u32 count;
+    u32 instance_count;
+    u32 first_index;
+    i32 base_vertex;
+    u32 base_instance;
 };
 
 struct DirectionalLightRenderData
 {
     glm::vec3 direction;
     LightProperties properties;
+
+    [[nodiscard]] auto operator==(const DirectionalLightRenderData&) const -> bool = default;
 };
 
 struct PointLightRenderData
@@ -60,6 +211,8 @@ struct PointLightRenderData
     glm::vec3 position;
     LightProperties properties;
     LightAttenuation attenuation;
+
+    [[nodiscard]] auto operator==(const PointLightRenderData&) const -> bool = default;
 };
 
 struct SpotLightRenderData
@@ -70,11 +223,35 @@ struct SpotLightRenderData
     float outer_cutoff_cosine; // Cosine of the outer cone angle.
     LightProperties properties;
     LightAttenuation attenuation;
+
+    [[nodiscard]] auto operator==(const SpotLightRenderData&) const -> bool = default;
 };
 
 struct AmbientLightRenderData
 {
     glm::vec3 ambient;
+
+    [[nodiscard]] auto operator==(const AmbientLightRenderData&) const -> bool = default;
+};
+
+// The lights submitted during a scene.
+struct LightsRenderData
+{
+    Vector<DirectionalLightRenderData> directional_lights;
+    Vector<PointLightRenderData> point_lights;
+    Vector<SpotLightRenderData> spot_lights;
+    Vector<AmbientLightRenderData> ambient_lights;
+
+    auto clear() -> void;
+
+    [[nodiscard]] auto operator==(const LightsRenderData&) const -> bool = default;
+};
+
+// The section of the lights SSBO which holds a single kind of light.
+struct LightsSsboRange
+{
+    u32 offset;
+    u32 size;
 };
 
 // @test: Multiple directional lights.
@@ -95,22 +272,51 @@ public:
     static constexpr u32 specular_map_slot = 1;
     static constexpr u32 emission_map_slot = 2;
 
+    static constexpr u32 gbuffer_albedo_slot = 3;
+    static constexpr u32 gbuffer_normal_slot = 4;
+    static constexpr u32 gbuffer_specular_slot = 5;
+    static constexpr u32 gbuffer_emission_slot = 6;
+    static constexpr u32 gbuffer_material_index_slot = 7;
+    static constexpr u32 gbuffer_depth_slot = 8;
+
+    static constexpr u32 gbuffer_albedo_attachment = 0;
+    static constexpr u32 gbuffer_normal_attachment = 1;
+    static constexpr u32 gbuffer_specular_attachment = 2;
+    static constexpr u32 gbuffer_emission_attachment = 3;
+    static constexpr u32 gbuffer_material_index_attachment = 4;
+
     static constexpr u32 camera_ubo_binding_point = 0;
-    static constexpr u32 material_ubo_binding_point = 1;
 
     static constexpr u32 directional_lights_ssbo_binding_point = 0;
     static constexpr u32 point_lights_ssbo_binding_point = 1;
     static constexpr u32 spot_lights_ssbo_binding_point = 2;
     static constexpr u32 ambient_lights_ssbo_binding_point = 3;
-
-    static constexpr usize initial_directional_lights_ssbo_size =
-        sizeof(DirectionalLightsSsboData) + sizeof(DirectionalLightShaderData) * 3;
-    static constexpr usize initial_point_lights_ssbo_size =
-        sizeof(PointLightsSsboData) + sizeof(PointLightShaderData) * 10;
-    static constexpr usize initial_spot_lights_ssbo_size =
-        sizeof(SpotLightsSsboData) + sizeof(SpotLightShaderData) * 10;
-
-    static constexpr usize initial_instance_buffer_size = sizeof(InstanceVertex) * 1000;
+    static constexpr u32 materials_ssbo_binding_point = 4;
+    static constexpr u32 light_clusters_ssbo_binding_point = 5;
+    static constexpr u32 light_indices_ssbo_binding_point = 6;
+
+    // Every section of the lights SSBO starts with a 16 byte header and might have to be aligned to 256 bytes.
+    static constexpr usize initial_lights_ssbo_size = 256 * 4 + sizeof(DirectionalLightShaderData) * 3 +
+                                                      sizeof(PointLightShaderData) * 10 +
+                                                      sizeof(SpotLightShaderData) * 10;
+    static constexpr usize initial_materials_ssbo_size = sizeof(MaterialShaderData) * 64;
+    static constexpr usize initial_light_clusters_ssbo_size =
+        sizeof(LightClustersSsboData) +
+        sizeof(LightCluster) * LightClusterGrid::default_size.x * LightClusterGrid::default_size.y *
+            LightClusterGrid::default_size.z;
+    static constexpr usize initial_light_indices_ssbo_size = sizeof(u32) * 4096;
+
+    // Size of a single region of the instance buffers. The renderer writes to one region while the GPU reads from the
+    // other ones, and a batch which doesn't fit into a region gets split into multiple draw calls.
+    static constexpr usize instances_per_instance_buffer_region = 16384;
+    static constexpr usize instance_buffer_region_size = sizeof(InstanceVertex) * instances_per_instance_buffer_region;
+    static constexpr usize compact_instance_buffer_region_size =
+        sizeof(CompactInstanceVertex) * instances_per_instance_buffer_region;
+    static constexpr usize draw_indirect_buffer_region_size = sizeof(DrawElementsIndirectCommand) * 4096;
+    static constexpr usize max_draw_indirect_commands =
+        draw_indirect_buffer_region_size / sizeof(DrawElementsIndirectCommand);
+
+    static constexpr usize stats_history_size = 300; // In frames.
 
 public:
     explicit Renderer(Passkey);
@@ -125,13 +331,50 @@ public:
     static auto set_face_culling_enabled(bool enabled) -> void;
     static auto set_multisampling_enabled(bool enabled) -> void;
     static auto set_wireframe_mode_enabled(bool enabled) -> void;
+    // In multi-draw indirect mode the geometry of the submitted meshes gets copied into buffers shared by all meshes
+    // with the same vertex layout, and all the batches which use the same material bindings and shared buffers get
+    // rendered with a single draw call.
+    static auto set_multi_draw_indirect_enabled(bool enabled) -> void;
+    // Frustum culling is performed by the scene before submitting meshes to the renderer.
+    static auto set_frustum_culling_enabled(bool enabled) -> void;
+    // Occlusion culling is performed by the scene as well. It rasterizes the occluders into a software depth buffer and
+    // culls the meshes which lie entirely behind them. Retained meshes only get culled by the frustum.
+    static auto set_occlusion_culling_enabled(bool enabled) -> void;
+    // With light clustering enabled, point and spot lights get binned into clusters of the view frustum on the CPU and
+    // the standard shader only evaluates the lights of the cluster that a fragment falls into.
+    static auto set_light_clustering_enabled(bool enabled) -> void;
+    static auto set_shading_mode(ShadingMode mode) -> void;
+    // Orders opaque draw commands roughly front to back, so that the closer surfaces hide the ones behind them before
+    // they get shaded. Costs some batching, as the draw commands get grouped by distance before they get grouped by
+    // state. When it's disabled, draw commands which share state get rendered in the order in which they were
+    // submitted.
+    static auto set_front_to_back_sorting_enabled(bool enabled) -> void;
+    // Renders the opaque geometry's depth with a trivial shader first, and then shades only the fragments whose depth
+    // is equal to it, so that every pixel gets shaded at most once. Only the geometry drawn with the built-in shaders
+    // takes part in it, as other shaders might compute a different depth. Only takes effect when the depth test is
+    // enabled.
+    static auto set_depth_prepass_enabled(bool enabled) -> void;
+    // Shifts the screen sizes that the scene selects mesh LOD levels by. Every step of 1 halves them, so positive
+    // biases pick coarser levels and negative biases pick finer ones.
+    static auto set_lod_bias(float bias) -> void;
     static auto set_clear_color(glm::vec4 color) -> void;
 
     static auto clear() -> void;
 
+    // Scenes don't get rendered right away. Ending a scene records its passes into the frame graph, which gets executed
+    // after all the layers and overlays have recorded theirs. Beginning a scene while the passes of the previous one
+    // are still waiting executes the frame graph first.
     static auto begin_scene(const CameraComponent& camera, const TransformComponent& camera_transform) -> void;
     static auto end_scene() -> void;
 
+    // The graph which the passes of the current frame get recorded into. Passes added to it run after the passes which
+    // were recorded before them.
+    [[nodiscard]] static auto frame_graph() -> RenderGraph&;
+    // Runs the recorded passes and clears the frame graph.
+    static auto execute_frame_graph() -> void;
+    // The graph which was executed most recently, already compiled.
+    [[nodiscard]] static auto frame_graph_last_frame() -> const RenderGraph&;
+
     static auto submit_light(const LightComponent& light, const TransformComponent& light_transform) -> void;
     static auto submit_directional_light(const DirectionalLight& light, const TransformComponent& light_transform)
         -> void;
@@ -139,11 +382,36 @@ public:
     static auto submit_spot_light(const SpotLight& light, const TransformComponent& light_transform) -> void;
     static auto submit_ambient_light(const AmbientLight& light) -> void;
 
-    // The submitted references must all be valid until the renderer finishes rendering the scene.
+    // The submitted mesh and material must be valid until the renderer finishes rendering the scene. The transform gets
+    // copied.
     static auto submit(const Mesh& mesh, const glm::mat4& transform, const Material& material) -> void;
-    // The submitted references must all be valid until the renderer finishes rendering the scene.
+    // The submitted vertex array and material must be valid until the renderer finishes rendering the scene. The
+    // transform gets copied.
     static auto submit(const gl::VertexArray& vertex_array, const glm::mat4& transform, const Material& material)
         -> void;
+    // Same as submitting the transform's matrix, but the normal matrix gets computed straight from the transform's
+    // rotation and scale if the transform was composed from them.
+    static auto submit(const Mesh& mesh, const TransformComponent& transform, const Material& material) -> void;
+    static auto submit(const gl::VertexArray& vertex_array, const TransformComponent& transform,
+                       const Material& material) -> void;
+
+    // Submits an instance for every transform in the range. The submitted mesh and material must be valid until the
+    // renderer finishes rendering the scene. The transforms get copied.
+    static auto submit_instances(const Mesh& mesh, const Material& material, std::span<const glm::mat4> transforms)
+        -> void;
+    // Submits an instance for every transform in the range. The submitted vertex array and material must be valid until
+    // the renderer finishes rendering the scene. The transforms get copied.
+    static auto submit_instances(const gl::VertexArray& vertex_array, const Material& material,
+                                 std::span<const glm::mat4> transforms) -> void;
+    // Submits everything recorded into the draw list. The draw list must be valid until the renderer finishes rendering
+    // the scene. Draw lists get merged in the order in which they're submitted, after the meshes submitted directly, so
+    // the result is the same as if their contents were submitted directly one after another.
+    static auto submit(const DrawList& draw_list) -> void;
+    // Renders the batches of the retained draw list with the instance data which is already on the GPU, after
+    // removing the instances which weren't submitted to it since the last time it was rendered and uploading the ones
+    // which changed. The draw list must be valid until the renderer finishes rendering the scene. Retained draw lists
+    // get rendered before everything else, so that their materials keep the same indices from frame to frame.
+    static auto submit(RetainedDrawList& draw_list) -> void;
 
     [[nodiscard]] static auto viewport() -> glm::uvec2;
 
@@ -157,78 +425,245 @@ public:
     [[nodiscard]] static auto face_culling_enabled() -> bool;
     [[nodiscard]] static auto multisampling_enabled() -> bool;
     [[nodiscard]] static auto wireframe_mode_enabled() -> bool;
+    [[nodiscard]] static auto multi_draw_indirect_enabled() -> bool;
+    [[nodiscard]] static auto frustum_culling_enabled() -> bool;
+    [[nodiscard]] static auto occlusion_culling_enabled() -> bool;
+    [[nodiscard]] static auto light_clustering_enabled() -> bool;
+    [[nodiscard]] static auto shading_mode() -> ShadingMode;
+    [[nodiscard]] static auto front_to_back_sorting_enabled() -> bool;
+    [[nodiscard]] static auto depth_prepass_enabled() -> bool;
+    [[nodiscard]] static auto lod_bias() -> float;
+
+    // Removes the geometry of all the meshes from the buffers used in multi-draw indirect mode.
+    static auto clear_geometry_pool() -> void;
+    // Removes the vertex array's geometry from the buffers used in multi-draw indirect mode. Meshes call it when they
+    // get destroyed. Does nothing if the renderer isn't initialized.
+    static auto release_pooled_geometry(const gl::VertexArray& vertex_array) -> void;
 
     [[nodiscard]] static auto draw_calls_last_frame() -> u32;
-
-    [[nodiscard]] static auto instance_buffer() -> const gl::InstanceBuffer&;
+    [[nodiscard]] static auto stats_last_frame() -> const RendererStats&;
+    // The stats of the last stats_history_size frames at most, the oldest first.
+    [[nodiscard]] static auto stats_history() -> std::span<const RendererStats>;
+
+    // Instances get culled before they're submitted, so whoever culls them has to report them in order for them to show
+    // up in the stats.
+    static auto report_culled_instances(u32 count) -> void;
+    [[nodiscard]] static auto culling_stats_last_frame() -> const CullingStats&;
+    static auto report_occlusion_culling_stats(const OcclusionCullingStats& stats) -> void;
+    [[nodiscard]] static auto occlusion_culling_stats_last_frame() -> const OcclusionCullingStats&;
+    [[nodiscard]] static auto batching_stats_last_frame() -> const BatchingStats&;
+    [[nodiscard]] static auto retained_instance_stats_last_frame() -> const RetainedInstanceStats&;
+    [[nodiscard]] static auto light_cluster_stats_last_frame() -> const LightClusterStats&;
+    [[nodiscard]] static auto render_pass_timings_last_frame() -> const RenderPassTimings&;
+    [[nodiscard]] static auto overdraw_stats_last_frame() -> const OverdrawStats&;
+
+    // Vertex arrays choose their instance format by the instance buffer they get bound to.
+    [[nodiscard]] static auto instance_buffer(InstanceFormat format = InstanceFormat::Standard)
+        -> const gl::InstanceBuffer&;
+    [[nodiscard]] static auto instance_format(const gl::VertexArray& vertex_array) -> InstanceFormat;
+    // Vertex arrays choose their vertex format by the layout of their vertex buffer.
+    [[nodiscard]] static auto vertex_format(const gl::VertexArray& vertex_array) -> VertexFormat;
+    [[nodiscard]] static auto instance_buffer_stats_last_frame(InstanceFormat format = InstanceFormat::Standard)
+        -> const gl::StreamingBufferStats&;
 
 private:
     glm::vec3 _current_camera_position{ 0.0f };
     glm::mat4 _current_camera_view{ 1.0f };
     glm::mat4 _current_camera_projection{ 1.0f };
     glm::mat4 _current_camera_view_projection{ 1.0f };
+    float _current_camera_near = 0.0f;
+    float _current_camera_far = 0.0f;
 
-    Vector<DirectionalLightRenderData> _directional_lights;
-    Vector<PointLightRenderData> _point_lights;
-    Vector<SpotLightRenderData> _spot_lights;
-    Vector<AmbientLightRenderData> _ambient_lights;
+    LightsRenderData _lights;
 
     gl::UniformBuffer _camera_ubo =
         gl::UniformBuffer::create_static_with_size(sizeof(CameraUboData), camera_ubo_binding_point);
-    gl::UniformBuffer _material_ubo =
-        gl::UniformBuffer::create_static_with_size(sizeof(MaterialUboData), material_ubo_binding_point);
 
-    // @speed: It might be better to fit all lights into single buffer instead of creating a separate one for every kind
-    // of light.
-
-    gl::ShaderStorageBuffer _directional_lights_ssbo = gl::ShaderStorageBuffer::create_dynamic_with_size(
-        initial_directional_lights_ssbo_size, directional_lights_ssbo_binding_point);
-    gl::ShaderStorageBuffer _point_lights_ssbo = gl::ShaderStorageBuffer::create_dynamic_with_size(
-        initial_point_lights_ssbo_size, point_lights_ssbo_binding_point);
-    gl::ShaderStorageBuffer _spot_lights_ssbo = gl::ShaderStorageBuffer::create_dynamic_with_size(
-        initial_spot_lights_ssbo_size, spot_lights_ssbo_binding_point);
-    gl::ShaderStorageBuffer _ambient_lights_ssbo =
-        gl::ShaderStorageBuffer::create_dynamic(ambient_lights_ssbo_binding_point);
+    // The material table holds the properties of every material used in the current scene, indexed by the materials'
+    // draw key ids. It only gets uploaded when it differs from the one which was uploaded last.
+    gl::ShaderStorageBuffer _materials_ssbo = gl::ShaderStorageBuffer::create_dynamic_with_size(
+        initial_materials_ssbo_size, materials_ssbo_binding_point);
+    Vector<const Material*> _materials;
+    Vector<MaterialShaderData> _material_table;
+    Vector<MaterialShaderData> _uploaded_material_table;
+
+    // Material bindings ids of the materials in the material table.
+    Vector<u32> _material_bindings_ids;
+    UnorderedMap<MaterialBindings, u32> _material_bindings_id_map;
+
+    // Every kind of light gets its own section of a single SSBO, which gets bound as a range to that kind's binding
+    // point. The sections get written into a staging buffer and uploaded with a single call, but only when the
+    // submitted lights differ from the ones which were uploaded last.
+    gl::ShaderStorageBuffer _lights_ssbo = gl::ShaderStorageBuffer::create_dynamic_with_size(initial_lights_ssbo_size);
+    Vector<byte> _lights_staging;
+    Optional<LightsRenderData> _uploaded_lights = nil;
+    std::array<LightsSsboRange, 4> _lights_ssbo_ranges{}; // Directional, point, spot and ambient lights.
+
+    // The light clusters get rebuilt every frame, as they depend on the camera. Lights get binned by the view-space
+    // bounding spheres of the regions they light up.
+    LightClusterGrid _light_cluster_grid;
+    gl::ShaderStorageBuffer _light_clusters_ssbo = gl::ShaderStorageBuffer::create_dynamic_with_size(
+        initial_light_clusters_ssbo_size, light_clusters_ssbo_binding_point);
+    gl::ShaderStorageBuffer _light_indices_ssbo = gl::ShaderStorageBuffer::create_dynamic_with_size(
+        initial_light_indices_ssbo_size, light_indices_ssbo_binding_point);
+    Vector<math::BoundingSphere> _point_light_bounds;
+    Vector<math::BoundingSphere> _spot_light_bounds;
+    Vector<byte> _light_clusters_staging;
 
     // Right now we're drawing everything using instanced rendering, even if the number of objects to draw is only 1 as
     // there doesn't appear to be any drawback to doing so. Crucially, this means that every vertex array needs to be
-    // bound to the renderer's instance buffer.
-    Vector<InstanceVertex> _temporary_instance_data;
+    // bound to the renderer's instance buffer. Instance data gets written straight into the persistently mapped
+    // instance buffer, and every draw call selects its instances with a base instance offset.
     gl::InstanceBuffer _instance_buffer =
-        gl::InstanceBuffer::create_dynamic_with_size(initial_instance_buffer_size, InstanceVertex::layout);
+        gl::InstanceBuffer::create_streaming(instance_buffer_region_size, InstanceVertex::layout);
+    gl::InstanceBuffer _compact_instance_buffer =
+        gl::InstanceBuffer::create_streaming(compact_instance_buffer_region_size, CompactInstanceVertex::layout);
+    gl::StreamingBufferStats _instance_buffer_stats_last_frame{};
+    gl::StreamingBufferStats _compact_instance_buffer_stats_last_frame{};
+
+    GeometryPool _geometry_pool{ { &_instance_buffer, &_compact_instance_buffer } };
+    Vector<DrawElementsIndirectCommand> _draw_indirect_commands;
+    gl::Buffer _draw_indirect_buffer = gl::Buffer::create_streaming(draw_indirect_buffer_region_size);
 
     Vector<DrawCommand> _draw_commands;
     Vector<RenderBatch> _batches;
 
+    // Meshes submitted directly get recorded into the renderer's own draw list. Right before rendering, it gets merged
+    // with the submitted draw lists.
+    DrawList _draw_list;
+    Vector<const DrawList*> _draw_lists;
+    Vector<RetainedDrawList*> _retained_draw_lists;
+    Vector<DrawListEntry> _draw_list_entries;
+
+    // Transforms of all the instances submitted during the current scene.
+    Vector<glm::mat4> _transforms;
+    // Parallel to _transforms. The rotations and the scales are only meaningful for composed draw commands, and the
+    // normal matrices only get computed for draw commands with standard instances.
+    Vector<glm::quat> _rotations;
+    Vector<glm::vec3> _scales;
+    Vector<glm::mat3> _normal_matrices;
+
+    // Every draw command gets a draw key when it's submitted. The keys get sorted instead of the draw commands.
+    Vector<DrawKeyEntry> _draw_keys;
+    Vector<DrawKeyEntry> _draw_keys_scratch;
+    DrawKeyIdMap<gl::Shader> _shader_ids;
+    DrawKeyIdMap<Material> _material_ids;
+    DrawKeyIdMap<gl::VertexArray> _vertex_array_ids;
+
     bool _blending_enabled = false;
     bool _depth_test_enabled = false;
     bool _face_culling_enabled = false;
     bool _multisampling_enabled = false;
     bool _wireframe_mode_enabled = false;
-
-    u32 _draw_calls_this_frame = 0;
-    u32 _draw_calls_last_frame = 0;
+    bool _multi_draw_indirect_enabled = false;
+    bool _frustum_culling_enabled = true;
+    bool _occlusion_culling_enabled = true;
+    bool _light_clustering_enabled = true;
+    bool _front_to_back_sorting_enabled = true;
+    bool _depth_prepass_enabled = false;
+    float _lod_bias = 0.0f;
+
+    ShadingMode _shading_mode = ShadingMode::Forward;
+    gl::VertexArray _empty_vertex_array; // The lighting pass generates its vertices in the vertex shader.
+    // Gets bound instead of the materials' shaders when it's set.
+    const gl::Shader* _shader_override = nullptr;
+
+    RendererStats _stats_this_frame{};
+    RendererStats _stats_last_frame{};
+    // Holds up to twice as many frames as the history, so that old frames only have to be dropped once in a while.
+    Vector<RendererStats> _stats_history;
+
+    CullingStats _culling_stats_this_frame{};
+    CullingStats _culling_stats_last_frame{};
+
+    OcclusionCullingStats _occlusion_culling_stats_this_frame{};
+    OcclusionCullingStats _occlusion_culling_stats_last_frame{};
+
+    BatchingStats _batching_stats_this_frame{};
+    BatchingStats _batching_stats_last_frame{};
+
+    RetainedInstanceStats _retained_instance_stats_this_frame{};
+    RetainedInstanceStats _retained_instance_stats_last_frame{};
+
+    LightClusterStats _light_cluster_stats_this_frame{};
+    LightClusterStats _light_cluster_stats_last_frame{};
+    Vector<u32> _material_last_batch; // Used to count the materials in every batch.
+
+    gl::GpuTimer _forward_pass_timer;
+    gl::GpuTimer _gbuffer_pass_timer;
+    gl::GpuTimer _lighting_pass_timer;
+    gl::GpuTimer _transparent_pass_timer;
+    RenderPassTimings _render_pass_timings_last_frame{};
+
+    gl::SampleCounter _forward_pass_sample_counter;
+    gl::SampleCounter _gbuffer_pass_sample_counter;
+    OverdrawStats _overdraw_stats_last_frame{};
+
+    // The G-buffer and any other transient render targets come from the pool, which recreates them whenever the
+    // viewport gets resized and frees them once they stop being used.
+    RenderGraph _frame_graph;
+    RenderGraph _frame_graph_last_frame;
+    RenderGraphResourcePool _render_graph_pool;
+    bool _scene_recorded = false; // Whether the frame graph holds the passes of a scene which haven't run yet.
 
 private:
     explicit Renderer() = default;
 
+    // Prepares the scene's data and records the passes which render it into the frame graph.
     static auto render() -> void;
 
+    static auto merge_draw_lists() -> void;
+    // Updates the retained draw lists and pushes a draw command for every range of visible instances of their batches.
+    static auto push_retained_draw_commands() -> void;
+
     static auto draw_indexed(const gl::VertexArray& vertex_array, const Material& material) -> void;
-    static auto draw_instanced(const gl::VertexArray& vertex_array, const Material& material, u32 instances) -> void;
+    static auto draw_instanced(const gl::VertexArray& vertex_array, const Material& material, u32 instances,
+                               u32 base_instance = 0) -> void;
+
+    static auto push_draw_command(const gl::VertexArray& vertex_array, const Material& material, u32 first_transform,
+                                  u32 transform_count, bool composed) -> void;
+    // Returns the material's index into the material table.
+    static auto push_draw_command(const gl::VertexArray& vertex_array, const Material& material, float view_depth,
+                                  u32 first_transform, u32 transform_count, bool retained, bool composed) -> u32;
+    // Only standard instances store a normal matrix, compact ones get theirs derived in the vertex shader.
+    static auto compute_normal_matrices() -> void;
 
     static auto batch_draw_commands() -> void;
+    static auto render_batches(std::span<const RenderBatch> batches) -> void;
+    // Renders the batches with the depth pre-pass if it's enabled. The sample counter only counts the shaded samples.
+    static auto render_opaque(std::span<const RenderBatch> batches, gl::SampleCounter& sample_counter) -> void;
+    static auto render_transparent(std::span<const RenderBatch> batches) -> void;
     static auto render_batch(const RenderBatch& batch) -> void;
-
-    static auto bind_material(const Material& material) -> void;
+    static auto render_retained_batch(const RenderBatch& batch) -> void;
+    static auto render_batches_indirect(std::span<const RenderBatch> batches) -> void;
+    // Adds the G-buffer pass and the lighting pass to the frame graph.
+    static auto add_deferred_passes(std::span<const RenderBatch> batches) -> void;
+    static auto draw_indirect(const gl::VertexArray& vertex_array, const Material& material) -> void;
+
+    // Writes the batch's instance data into the instance buffer in chunks which fit into a single region of the buffer.
+    // on_chunk(instance_count, base_instance) gets called after every chunk gets written. before_region_change() gets
+    // called before moving on to the next region of the instance buffer, so that we can issue the draw calls which use
+    // the current region before it gets fenced.
+    // The instances get written in the format of the instance buffer that the batch's vertex array is bound to.
+    template<typename BeforeRegionChange, typename OnChunk>
+    static auto stream_instances(const RenderBatch& batch, BeforeRegionChange&& before_region_change,
+                                 OnChunk&& on_chunk) -> void;
+    template<typename Instance, typename BeforeRegionChange, typename OnChunk>
+    static auto stream_instances(const RenderBatch& batch, gl::InstanceBuffer& instance_buffer,
+                                 BeforeRegionChange&& before_region_change, OnChunk&& on_chunk) -> void;
+
+    // Binds the variant of the material's shader (or of the shader override) which reads the given vertex format.
+    static auto bind_material(const Material& material, VertexFormat vertex_format) -> void;
 
     static auto upload_camera_data(glm::vec3 camera_position, const glm::mat4& view_projection) -> void;
-    static auto upload_material_data(const Material& material) -> void;
+    static auto upload_material_table() -> void;
     static auto upload_light_data() -> void;
-    static auto upload_directional_lights_data() -> void;
-    static auto upload_point_lights_data() -> void;
-    static auto upload_spot_lights_data() -> void;
-    static auto upload_ambient_lights_data() -> void;
+    // Append a section of the lights SSBO to the staging buffer.
+    static auto stage_directional_lights_data() -> LightsSsboRange;
+    static auto stage_point_lights_data() -> LightsSsboRange;
+    static auto stage_spot_lights_data() -> LightsSsboRange;
+    static auto stage_ambient_lights_data() -> LightsSsboRange;
+    static auto upload_light_clusters() -> void;
 
     static auto reset_renderer_state() -> void;
 };
@@ -273,6 +708,7 @@ public:
     static auto start_frame() -> void;
     static auto shut_down() -> void;
 
+    // Ending a scene records a pass which renders it into the renderer's frame graph, same as with 3D scenes.
     static auto begin_scene() -> void;
     static auto end_scene() -> void;
 
@@ -284,6 +720,9 @@ public:
     [[nodiscard]] static auto viewport() -> glm::uvec2;
 
     [[nodiscard]] static auto draw_calls_last_frame() -> u32;
+    [[nodiscard]] static auto stats_last_frame() -> const Renderer2DStats&;
+    // The stats of the last Renderer::stats_history_size frames at most, the oldest first.
+    [[nodiscard]] static auto stats_history() -> std::span<const Renderer2DStats>;
 
 private:
     explicit Renderer2D() = default;
@@ -294,12 +733,11 @@ private:
     Vector<DrawRectCommand> _draw_rect_commands;
     Vector<RectRenderBatch> _rect_batches;
 
-    u32 _draw_calls_this_frame = 0;
-    u32 _draw_calls_last_frame = 0;
+    Renderer2DStats _stats_this_frame{};
+    Renderer2DStats _stats_last_frame{};
+    Vector<Renderer2DStats> _stats_history;
 
-    // We need to disable the depth test when we start a 2D scene, but we should restore its value to whatever it was
-    // before.
-    bool _depth_test_was_enabled = Renderer::depth_test_enabled();
+    bool _scene_recorded = false; // Whether the frame graph holds the pass of a scene which hasn't run yet.
 
 private:
     static auto render() -> void;
@@ -314,3 +752,5 @@ private:
 };
 
 } // namespace zth
+
+ZTH_DECLARE_REFLECTED_ENUM(zth::ShadingMode);
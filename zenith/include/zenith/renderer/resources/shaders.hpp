@@ -5,6 +5,7 @@
 
 #include "zenith/core/typedefs.hpp"
 #include "zenith/gl/fwd.hpp"
+#include "zenith/renderer/fwd.hpp"
 
 namespace zth::shaders {
 
@@ -12,8 +13,13 @@ constexpr inline usize fallback_shader_index = 0;
 constexpr inline usize flat_color_shader_index = 1;
 constexpr inline usize standard_shader_index = 2;
 constexpr inline usize texture_2d_shader_index = 3;
+constexpr inline usize deferred_geometry_shader_index = 4;
+constexpr inline usize deferred_lighting_shader_index = 5;
+constexpr inline usize depth_only_shader_index = 6;
+constexpr inline usize standard_compact_shader_index = 7;
+constexpr inline usize deferred_geometry_compact_shader_index = 8;
 
-using ShadersArray = std::array<std::shared_ptr<const gl::Shader>, texture_2d_shader_index + 1>;
+using ShadersArray = std::array<std::shared_ptr<const gl::Shader>, deferred_geometry_compact_shader_index + 1>;
 
 auto load() -> void;
 auto unload() -> void;
@@ -24,5 +30,18 @@ auto unload() -> void;
 [[nodiscard]] auto flat_color() -> const std::shared_ptr<const gl::Shader>&;
 [[nodiscard]] auto standard() -> const std::shared_ptr<const gl::Shader>&;
 [[nodiscard]] auto texture_2d() -> const std::shared_ptr<const gl::Shader>&;
+[[nodiscard]] auto deferred_geometry() -> const std::shared_ptr<const gl::Shader>&;
+[[nodiscard]] auto deferred_lighting() -> const std::shared_ptr<const gl::Shader>&;
+[[nodiscard]] auto depth_only() -> const std::shared_ptr<const gl::Shader>&;
+[[nodiscard]] auto standard_compact() -> const std::shared_ptr<const gl::Shader>&;
+[[nodiscard]] auto deferred_geometry_compact() -> const std::shared_ptr<const gl::Shader>&;
+
+// Returns the variant of the shader which reads vertices of the given format. Only the built-in shaders which read the
+// normals have variants for compact vertices. The others read both vertex formats in the same way.
+[[nodiscard]] auto vertex_format_variant(const gl::Shader& shader, VertexFormat vertex_format) -> const gl::Shader&;
+
+// Whether the shader's vertex stage computes gl_Position exactly like depth_only()'s one does and declares it
+// invariant, so that the depth it produces is equal to the one written by the depth pre-pass.
+[[nodiscard]] auto matches_depth_only(const gl::Shader& shader) -> bool;
 
 } // namespace zth::shaders
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <glm/mat3x3.hpp>
+#include <glm/mat4x4.hpp>
+
+#include <memory>
+#include <span>
+
+#include "zenith/core/typedefs.hpp"
+#include "zenith/ecs/fwd.hpp"
+#include "zenith/gl/buffer.hpp"
+#include "zenith/gl/vertex_array.hpp"
+#include "zenith/math/bounds.hpp"
+#include "zenith/memory/managed.hpp"
+#include "zenith/renderer/fwd.hpp"
+#include "zenith/renderer/vertex.hpp"
+#include "zenith/stl/map.hpp"
+#include "zenith/stl/vector.hpp"
+#include "zenith/util/optional.hpp"
+
+namespace zth {
+
+// What happened to the instances of the retained draw lists rendered during a frame.
+struct RetainedInstanceStats
+{
+    u32 reused_instances = 0; // Instances whose data on the GPU was already up to date.
+    // Instances which were added, changed or moved into the slot of a removed instance. Instances of culled batches
+    // only get uploaded once some instance of their batch is visible again.
+    u32 uploaded_instances = 0;
+    u32 added_instances = 0;
+    u32 removed_instances = 0;
+    u32 culled_instances = 0; // Instances which were outside of the frustum.
+    u32 uploads = 0;          // Every contiguous range of changed slots gets uploaded with a single call.
+    u32 uploaded_bytes = 0;
+
+    auto operator+=(const RetainedInstanceStats& other) -> RetainedInstanceStats&;
+};
+
+struct SlotRange
+{
+    u32 first;
+    u32 count;
+
+    [[nodiscard]] auto operator==(const SlotRange&) const -> bool = default;
+};
+
+// Keeps every instance of a retained batch in a persistent slot and keeps track of the slots which changed since they
+// were last uploaded. An instance is identified by its key and only counts as changed when it gets submitted with a
+// different version. The instances which weren't submitted during a frame get removed at the end of it, and the last
+// instances get moved into their slots, so that the occupied slots stay contiguous.
+//
+// Doesn't touch OpenGL.
+class RetainedInstanceSlots
+{
+public:
+    using Key = u64;
+
+    // Returns the slot of the instance if it was added or changed, in which case its data has to be stored again.
+    // Returns nil if the instance is the same as the last time it was submitted.
+    [[nodiscard]] auto submit(Key key, u64 version) -> Optional<u32>;
+    auto store(u32 slot, const glm::mat4& transform, const glm::mat3& normal_matrix, const math::Aabb& bounds) -> void;
+
+    // Removes the instances which weren't submitted since the last call and returns what happened to the instances
+    // during the frame. Only the reused, added and removed instances get counted.
+    auto end_frame() -> RetainedInstanceStats;
+
+    // The ranges of the occupied slots which changed since the last call to clear_dirty_slots(), in ascending order.
+    // Adjacent slots get merged into a single range. Valid until the slots change.
+    [[nodiscard]] auto dirty_ranges() -> std::span<const SlotRange>;
+    auto clear_dirty_slots() -> void;
+    // Makes every occupied slot dirty, e.g. after something that all the instances share changed.
+    auto mark_all_dirty() -> void;
+
+    auto clear() -> void;
+
+    [[nodiscard]] auto size() const -> u32 { return static_cast<u32>(_keys.size()); }
+    [[nodiscard]] auto empty() const -> bool { return _keys.empty(); }
+    [[nodiscard]] auto keys() const -> std::span<const Key> { return _keys; }
+    [[nodiscard]] auto transforms() const -> std::span<const glm::mat4> { return _transforms; }
+    [[nodiscard]] auto normal_matrices() const -> std::span<const glm::mat3> { return _normal_matrices; }
+    [[nodiscard]] auto instance_bounds() const -> std::span<const math::Aabb> { return _instance_bounds; }
+    // The smallest box which contains the bounds of every instance.
+    [[nodiscard]] auto bounds() -> const math::Aabb&;
+
+private:
+    UnorderedMap<Key, u32> _slots;
+    u32 _frame = 0;
+    u32 _added_instances = 0; // Since the last call to end_frame().
+
+    // Indexed by the slots.
+    Vector<Key> _keys;
+    Vector<u64> _versions;
+    Vector<u32> _last_submitted_frames;
+    Vector<glm::mat4> _transforms;
+    Vector<glm::mat3> _normal_matrices;
+    Vector<math::Aabb> _instance_bounds;
+    Vector<bool> _dirty;
+
+    Vector<u32> _dirty_slots; // Might contain duplicates and slots which aren't occupied anymore.
+    Vector<SlotRange> _dirty_ranges;
+
+    math::Aabb _bounds{};
+    bool _bounds_outdated = false;
+
+private:
+    auto mark_dirty(u32 slot) -> void;
+    auto remove(u32 slot) -> void;
+};
+
+// The instances of a retained draw list which use the same mesh and material. They live in the batch's own instance
+// buffer, which a copy of the mesh's vertex array is bound to, so the batch gets rendered with a single draw call
+// without streaming any instance data.
+struct RetainedBatch
+{
+    std::shared_ptr<const Mesh> mesh;
+    std::shared_ptr<const Material> material;
+    InstanceFormat instance_format = InstanceFormat::Standard;
+    gl::InstanceBuffer instance_buffer;
+    gl::VertexArray vertex_array;
+    RetainedInstanceSlots slots{};
+    // The material index which the uploaded instances refer to. The material table gets rebuilt for every scene, so
+    // the instances have to be uploaded again if it changes.
+    Optional<u32> material_index = nil;
+};
+
+// Keeps the instances of meshes which rarely move on the GPU between frames, so that only the instances which were
+// added, changed or removed have to be uploaded instead of every instance every frame. The renderer culls the
+// instances one by one and draws the contiguous ranges of visible slots, unless the bounds of the whole batch are
+// entirely inside or outside of the frustum.
+//
+// Every instance which should stay has to be submitted again every frame, before the list gets submitted to the
+// renderer, which should happen once per frame. The instances which weren't get removed when the renderer renders the
+// list. The list's buffers get updated by the renderer, so the list mustn't be used from multiple threads.
+class RetainedDrawList
+{
+public:
+    using Key = RetainedInstanceSlots::Key;
+
+    // The key identifies the instance, e.g. it can be the id of an entity. Its version has to change whenever the
+    // transform changes and mustn't go back to a version that the instance already had.
+    auto submit(Key key, u64 version, const std::shared_ptr<const Mesh>& mesh, const TransformComponent& transform,
+                const std::shared_ptr<const Material>& material) -> void;
+
+    // Removes the instances which weren't submitted since the last call, together with the batches which end up
+    // empty. Returns what happened to the instances during the frame.
+    auto end_frame() -> RetainedInstanceStats;
+    // Uploads the changed slots of the batch. Uploads every slot if the material index changed.
+    auto upload(RetainedBatch& batch, u32 material_index) -> RetainedInstanceStats;
+
+    auto clear() -> void;
+
+    [[nodiscard]] auto batches() const -> std::span<const UniquePtr<RetainedBatch>> { return _batches; }
+    [[nodiscard]] auto instance_count() const -> u32;
+
+private:
+    struct BatchKey
+    {
+        const gl::VertexArray* vertex_array;
+        const Material* material;
+
+        [[nodiscard]] auto operator==(const BatchKey&) const -> bool = default;
+    };
+
+    struct BatchKeyHash
+    {
+        [[nodiscard]] auto operator()(const BatchKey& key) const -> std::size_t;
+    };
+
+    // Behind pointers, as the batches' vertex arrays refer to their instance buffers.
+    Vector<UniquePtr<RetainedBatch>> _batches;
+    UnorderedMap<BatchKey, u32, BatchKeyHash> _batch_indices;
+    Vector<byte> _staging;
+
+private:
+    auto find_or_create_batch(const std::shared_ptr<const Mesh>& mesh, const std::shared_ptr<const Material>& material)
+        -> RetainedBatch&;
+    template<typename Instance> auto upload_ranges(RetainedBatch& batch, u32 material_index) -> RetainedInstanceStats;
+};
+
+} // namespace zth
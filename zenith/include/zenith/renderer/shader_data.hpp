@@ -2,7 +2,9 @@
 
 #include <glad/glad.h>
 #include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
 
 #include "zenith/core/typedefs.hpp"
 #include "zenith/gl/util.hpp"
@@ -94,13 +96,25 @@ struct AmbientLightsSsboData
     // Here goes a variable-length array of AmbientLightData (aligned at 16 bytes).
 };
 
-struct MaterialUboData
+struct MaterialShaderData
 {
-    ZTH_UBO_FIELD(glm::vec3, albedo);
-    ZTH_UBO_FIELD(glm::vec3, ambient);
-    ZTH_UBO_FIELD(glm::vec3, diffuse);
-    ZTH_UBO_FIELD(glm::vec3, specular);
-    ZTH_UBO_FIELD(GLfloat, shininess);
+    ZTH_SSBO_FIELD(glm::vec3, albedo);
+    ZTH_SSBO_FIELD(glm::vec3, ambient);
+    ZTH_SSBO_FIELD(glm::vec3, diffuse);
+    ZTH_SSBO_FIELD(glm::vec3, specular);
+    ZTH_SSBO_FIELD(GLfloat, shininess);
+
+    [[nodiscard]] auto operator==(const MaterialShaderData&) const -> bool = default;
+};
+
+struct LightClustersSsboData
+{
+    ZTH_SSBO_FIELD(glm::mat4, view);
+    ZTH_SSBO_FIELD(glm::uvec4, grid_size); // w is non-zero if light clustering is enabled.
+    ZTH_SSBO_FIELD(glm::vec2, viewport_size);
+    ZTH_SSBO_FIELD(GLfloat, depth_slice_scale);
+    ZTH_SSBO_FIELD(GLfloat, depth_slice_bias);
+    // Here goes a variable-length array of LightCluster (aligned at 16 bytes).
 };
 
 } // namespace zth
@@ -1,16 +1,42 @@
 #pragma once
 
+#include <glm/gtc/quaternion.hpp>
 #include <glm/mat3x3.hpp>
+#include <glm/mat4x4.hpp>
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
 #include <glm/vec4.hpp>
 
+#include <span>
+
+#include "zenith/core/typedefs.hpp"
+#include "zenith/gl/vertex_array.hpp"
 #include "zenith/gl/vertex_layout.hpp"
+#include "zenith/math/quantization.hpp"
+#include "zenith/stl/vector.hpp"
 
 namespace zth {
 
+// Every vertex array gets bound to the renderer's instance buffer of one of these formats. Shaders handle both of them.
+enum class InstanceFormat : u8
+{
+    Standard, // InstanceVertex.
+    Compact,  // CompactInstanceVertex.
+};
+
+// The renderer tells the vertex formats apart by the layout of the vertex buffer, and draws compact vertices with the
+// variants of the built-in shaders which decode them.
+enum class VertexFormat : u8
+{
+    Standard, // StandardVertex, or any other layout whose positions and normals are plain floats.
+    Compact,  // CompactVertex.
+};
+
+// The material index comes first, so that it has the same attribute location in both instance formats.
 struct InstanceVertex
 {
+    GLuint material_index; // Index into the renderer's material table.
+
     glm::vec3 transform_col_0;
     glm::vec3 transform_col_1;
     glm::vec3 transform_col_2;
@@ -23,6 +49,39 @@ struct InstanceVertex
 
 inline const gl::VertexLayout InstanceVertex::layout = gl::VertexLayout::derive_from_vertex<InstanceVertex>();
 
+// Less than half the size of InstanceVertex. The transform is stored as a translation, a rotation and a scale, so it
+// can't contain shear, and the vertex shader derives the normal matrix from the rotation and the scale instead of
+// reading it. The rotation is a quaternion quantized to 16 bits per component. Shaders tell compact instances apart
+// from standard ones by the translation's w, which is 0 for compact instances, whereas the first column of a standard
+// instance's transform reads as w = 1.
+struct CompactInstanceVertex
+{
+    GLuint material_index; // Index into the renderer's material table.
+
+    glm::vec4 translation;
+    math::Snorm16Vec4 rotation;
+    glm::vec3 scale;
+
+    // rotation must be normalized.
+    [[nodiscard]] static auto from_trs(glm::vec3 translation, glm::quat rotation, glm::vec3 scale,
+                                       GLuint material_index) -> CompactInstanceVertex;
+    // Splits the transform into a translation, a rotation and a scale. Shear gets lost.
+    [[nodiscard]] static auto from_transform(const glm::mat4& transform, GLuint material_index)
+        -> CompactInstanceVertex;
+
+    // What the vertex shader reconstructs.
+    [[nodiscard]] auto decode_rotation() const -> glm::quat;
+    [[nodiscard]] auto decode_transform() const -> glm::mat4;
+    [[nodiscard]] auto decode_normal_matrix() const -> glm::mat3;
+
+    static const gl::VertexLayout layout;
+};
+
+inline const gl::VertexLayout CompactInstanceVertex::layout =
+    gl::VertexLayout::derive_from_vertex<CompactInstanceVertex>();
+
+static_assert(sizeof(CompactInstanceVertex) * 2 < sizeof(InstanceVertex));
+
 struct StandardVertex
 {
     glm::vec3 position;
@@ -34,6 +93,39 @@ struct StandardVertex
 
 inline const gl::VertexLayout StandardVertex::layout = gl::VertexLayout::derive_from_vertex<StandardVertex>();
 
+// Half the size of StandardVertex. The position is stored as 16-bit unsigned normalized components relative to the
+// cube around the mesh's bounds, which the mesh's position transform maps back to the mesh's local space, so the
+// precision only depends on the size of the mesh. The normal is octahedral-encoded and the uv is stored as half floats.
+struct CompactVertex
+{
+    math::Unorm16Vec4 position; // w is always 1.
+    math::Snorm16Vec2 normal;
+    math::HalfVec2 uv;
+
+    [[nodiscard]] static auto from_standard(const StandardVertex& vertex,
+                                            const gl::VertexPositionTransform& position_transform) -> CompactVertex;
+    [[nodiscard]] auto to_standard(const gl::VertexPositionTransform& position_transform) const -> StandardVertex;
+
+    [[nodiscard]] auto decode_position(const gl::VertexPositionTransform& position_transform) const -> glm::vec3;
+
+    static const gl::VertexLayout layout;
+};
+
+inline const gl::VertexLayout CompactVertex::layout = gl::VertexLayout::derive_from_vertex<CompactVertex>();
+
+static_assert(sizeof(CompactVertex) * 2 == sizeof(StandardVertex));
+
+// Maps the unit cube onto the cube which starts at the minimum corner of the vertices' bounds and whose side is the
+// longest side of the bounds.
+[[nodiscard]] auto compact_position_transform(std::span<const StandardVertex> vertices) -> gl::VertexPositionTransform;
+[[nodiscard]] auto compact_vertices(std::span<const StandardVertex> vertices,
+                                    const gl::VertexPositionTransform& position_transform) -> Vector<CompactVertex>;
+
+// Folds a vertex array's position transform into the transform of an instance, so that the vertex shaders can read
+// the positions of every vertex format in the same way.
+[[nodiscard]] auto apply_position_transform(const glm::mat4& transform,
+                                            const gl::VertexPositionTransform& position_transform) -> glm::mat4;
+
 struct Vertex2D
 {
     glm::vec2 position;
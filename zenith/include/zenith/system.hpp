@@ -7,5 +7,7 @@
 #include "system/event_queue.hpp"
 #include "system/file.hpp"
 #include "system/input.hpp"
+#include "system/job_system.hpp"
+#include "system/png.hpp"
 #include "system/temporary_storage.hpp"
 #include "system/window.hpp"
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <filesystem>
+
 #include "zenith/core/typedefs.hpp"
+#include "zenith/gl/program_cache.hpp"
 #include "zenith/layer/layer.hpp"
 #include "zenith/log/logger.hpp"
 #include "zenith/memory/managed.hpp"
@@ -8,6 +11,7 @@
 #include "zenith/stl/string.hpp"
 #include "zenith/system/fwd.hpp"
 #include "zenith/system/window.hpp"
+#include "zenith/util/optional.hpp"
 #include "zenith/util/reference.hpp"
 #include "zenith/util/result.hpp"
 
@@ -21,6 +25,16 @@ struct ApplicationSpec
     double fixed_time_step = 1 / 60.0;  // In seconds.
     usize max_fixed_updates_per_frame = 50;
     usize temporary_storage_capacity = memory::megabytes(20);
+    // Quits after rendering this many frames. Together with a headless window this lets benchmarks and tests run
+    // unattended.
+    Optional<u64> frame_count = nil;
+    // Advances the simulation by the same amount every frame instead of by the measured frame time, which makes the
+    // rendered frames reproducible.
+    Optional<double> fixed_delta_time = nil; // In seconds.
+    // Saves the last frame rendered before quitting as a PNG image, e.g. to compare it against a golden image.
+    Optional<std::filesystem::path> screenshot_path = nil;
+    // Where linked shader programs get cached between runs. Nil disables the cache.
+    Optional<std::filesystem::path> shader_cache_directory = gl::ProgramCache::default_directory;
 };
 
 class Application
@@ -29,6 +43,7 @@ public:
     static inline double delta_time_limit = 1 / 30.0;
     static inline double fixed_time_step = 1 / 60.0;
     static inline usize max_fixed_updates_per_frame = 50;
+    static inline Optional<double> fixed_delta_time = nil;
 
 public:
     Application() = delete;
@@ -56,13 +71,19 @@ public:
     [[nodiscard]] static auto update_time() -> double;
     [[nodiscard]] static auto render_time() -> double;
 
+    [[nodiscard]] static auto frames_rendered() -> u64;
+
 private:
     static LayerStack _layers;
     static LayerStack _overlays;
 
     static inline usize _fixed_updates_performed = 0;
+    static inline u64 _frames_rendered = 0;
+    static inline Optional<u64> _frame_count = nil;
+    static inline Optional<std::filesystem::path> _screenshot_path = nil;
 
     static inline double _prev_start_frame_time_point = 0.0;
+    static inline double _simulation_time = 0.0;
     static inline double _delta_time = 0.0;
     static inline double _frame_time = 0.0;
     static inline double _fixed_update_time = 0.0;
@@ -80,6 +101,9 @@ private:
     static auto fixed_update() -> void;
     static auto update() -> void;
     static auto render() -> void;
+    static auto end_frame() -> void;
+
+    static auto save_screenshot(const std::filesystem::path& path) -> void;
 };
 
 } // namespace zth
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
+#include "zenith/core/typedefs.hpp"
+#include "zenith/stl/string.hpp"
+#include "zenith/stl/vector.hpp"
+#include "zenith/util/result.hpp"
+
+namespace zth {
+
+// A pool of worker threads which split data-parallel work with the calling thread. Only one parallel_for runs at a
+// time, and parallel_for calls made from within a job run on the calling thread. If the job system isn't initialized
+// (e.g. in tests), everything runs on the calling thread.
+class JobSystem
+{
+public:
+    JobSystem() = delete;
+
+    // 0 means one worker per hardware thread, minus one for the calling thread.
+    [[nodiscard]] static auto init(u32 worker_count = 0) -> Result<void, String>;
+    static auto shut_down() -> void;
+
+    // Calls f(begin, end) for ranges of at most range_size indices which together cover [0, count). Blocks until every
+    // range has been processed. f gets called concurrently, so it mustn't write to anything shared between the ranges.
+    template<std::invocable<usize, usize> F> static auto parallel_for(usize count, usize range_size, F&& f) -> void;
+
+    // The number of threads that parallel_for spreads the work across, including the calling thread.
+    [[nodiscard]] static auto thread_count() -> u32 { return static_cast<u32>(_workers.size()) + 1; }
+
+private:
+    struct Job
+    {
+        void* context;
+        void (*function)(void* context, usize begin, usize end);
+        usize count;
+        usize range_size;
+        usize range_count;
+        std::atomic<usize> next_range = 0;
+        std::atomic<usize> ranges_left;
+    };
+
+    static inline Vector<std::jthread> _workers;
+    static inline std::mutex _mutex;
+    static inline std::condition_variable _job_available;
+    static inline std::condition_variable _workers_idle;
+    static inline std::mutex _submit_mutex; // Serializes parallel_for calls from different threads.
+    static inline Job* _job = nullptr;
+    static inline u64 _job_generation = 0;
+    static inline u32 _active_workers = 0; // Workers which are holding a pointer to the current job.
+    static inline bool _stopping = false;
+
+    static inline thread_local bool _running_job = false;
+
+private:
+    static auto run(Job& job) -> void;
+    static auto work_on(Job& job) -> void;
+    static auto worker_main() -> void;
+};
+
+template<std::invocable<usize, usize> F> auto JobSystem::parallel_for(usize count, usize range_size, F&& f) -> void
+{
+    if (count == 0)
+        return;
+
+    range_size = std::max(range_size, usize{ 1 });
+
+    if (_workers.empty() || _running_job || count <= range_size)
+    {
+        for (usize begin = 0; begin < count; begin += range_size)
+            f(begin, std::min(begin + range_size, count));
+
+        return;
+    }
+
+    auto range_count = (count + range_size - 1) / range_size;
+
+    using Function = std::remove_reference_t<F>;
+
+    Job job{
+        .context = &f,
+        .function = [](void* context, usize begin, usize end) { (*static_cast<Function*>(context))(begin, end); },
+        .count = count,
+        .range_size = range_size,
+        .range_count = range_count,
+        .ranges_left = range_count,
+    };
+
+    run(job);
+}
+
+} // namespace zth
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <glm/vec2.hpp>
+
+#include <filesystem>
+#include <span>
+
+#include "zenith/core/typedefs.hpp"
+#include "zenith/stl/vector.hpp"
+
+namespace zth {
+
+// Encodes 8-bit RGBA pixels, starting from the top row, as a PNG image. The image data is stored without compression,
+// which keeps the encoder trivial and fast enough for screenshots and golden images.
+[[nodiscard]] auto encode_png(std::span<const u8> rgba_pixels, glm::uvec2 size) -> Vector<u8>;
+
+// Encodes the pixels as a PNG image and writes it to a file. Automatically creates new directories.
+auto write_png(const std::filesystem::path& path, std::span<const u8> rgba_pixels, glm::uvec2 size) -> bool;
+
+} // namespace zth
@@ -32,6 +32,10 @@ struct WindowSpec
     u32 samples = 4;
     bool transparent_framebuffer = false;
     Optional<WindowAspectRatio> forced_aspect_ratio = nil;
+    // Creates an invisible window and ignores fullscreen, maximized and vsync, so that nothing waits for the display.
+    // Meant for benchmarks and tests. When there's no display to connect to, falls back to GLFW's null platform with an
+    // OSMesa context (e.g. llvmpipe in a container), if the GLFW version supports it.
+    bool headless = false;
 };
 
 class Window
@@ -63,19 +67,26 @@ public:
     static auto disable_frame_rate_limit() -> void;
     static auto set_cursor_enabled(bool enabled) -> void;
 
+    // Returns null for functions which the context doesn't support. Meant for extension functions which glad doesn't
+    // load.
+    [[nodiscard]] static auto gl_proc_address(const char* name) -> void (*)();
+
     [[nodiscard]] static auto glfw_handle() -> GLFWwindow*;
     [[nodiscard]] static auto size() -> glm::uvec2;
+    [[nodiscard]] static auto framebuffer_size() -> glm::uvec2; // In pixels.
     [[nodiscard]] static auto aspect_ratio() -> float;
     [[nodiscard]] static auto mouse_pos() -> glm::vec2;
     [[nodiscard]] static auto frame_rate_limit() -> Optional<u32>;
     [[nodiscard]] static auto cursor_enabled() -> bool;
     [[nodiscard]] static auto target_frame_time() -> double;
+    [[nodiscard]] static auto headless() -> bool;
 
 private:
     static inline GLFWwindow* _window = nullptr;
     static inline double _target_frame_time = 0.0;
     static inline double _last_swap_buffers_time_point = 0.0;
     static inline Optional<u32> _frame_rate_limit = nil;
+    static inline bool _headless = false;
 
 private:
     [[nodiscard]] static auto create_glfw_window(glm::uvec2 size, const char* title, bool fullscreen) -> GLFWwindow*;
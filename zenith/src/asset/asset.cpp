@@ -5,15 +5,18 @@
 #include "zenith/log/logger.hpp"
 #include "zenith/renderer/material.hpp"
 #include "zenith/renderer/mesh.hpp"
+#include "zenith/renderer/mesh_lod.hpp"
 
 namespace zth {
 
 template<> AssetManager::AssetStorage<Mesh> AssetManager::_storage<Mesh>;
+template<> AssetManager::AssetStorage<MeshLod> AssetManager::_storage<MeshLod>;
 template<> AssetManager::AssetStorage<Material> AssetManager::_storage<Material>;
 template<> AssetManager::AssetStorage<gl::Shader> AssetManager::_storage<gl::Shader>;
 template<> AssetManager::AssetStorage<gl::Texture2D> AssetManager::_storage<gl::Texture2D>;
 
 template<> StringView AssetManager::_asset_type_string<Mesh> = "mesh";
+template<> StringView AssetManager::_asset_type_string<MeshLod> = "mesh LOD";
 template<> StringView AssetManager::_asset_type_string<Material> = "material";
 template<> StringView AssetManager::_asset_type_string<gl::Shader> = "shader";
 template<> StringView AssetManager::_asset_type_string<gl::Texture2D> = "texture";
@@ -29,6 +32,7 @@ auto AssetManager::shut_down() -> void
     ZTH_INTERNAL_TRACE("Shutting down asset manager...");
 
     _storage<Mesh>.clear();
+    _storage<MeshLod>.clear();
     _storage<Material>.clear();
     _storage<gl::Shader>.clear();
     _storage<gl::Texture2D>.clear();
@@ -4,8 +4,12 @@
 
 #include <imgui.h>
 
+#include <algorithm>
+#include <utility>
+
 #include "zenith/core/assert.hpp"
 #include "zenith/debug/ui.hpp"
+#include "zenith/gl/gpu_timer.hpp"
 #include "zenith/system/application.hpp"
 
 namespace zth {
@@ -16,6 +20,11 @@ Vector<ProfilerEntry> Profiler::_entry_stack;
 Vector<ProfilerEntryMarker> Profiler::_this_frame_markers;
 Vector<ProfilerEntryMarker> Profiler::_last_frame_markers;
 
+UniquePtr<gl::TimestampQueryPool> Profiler::_gpu_query_pool;
+Vector<GpuProfilerScope> Profiler::_this_frame_gpu_scopes;
+Vector<Vector<GpuProfilerScope>> Profiler::_pending_gpu_frames;
+UnorderedMap<const char*, double> Profiler::_gpu_times;
+
 auto ProfilerEntryMarker::make_opening_marker(const char* label) -> ProfilerEntryMarker
 {
     return ProfilerEntryMarker{
@@ -53,8 +62,19 @@ ScopeProfiler::~ScopeProfiler()
     Profiler::end_entry(duration);
 }
 
+GpuScopeProfiler::GpuScopeProfiler(const char* scope_name)
+    : _cpu_scope_profiler{ scope_name }, _scope_index{ Profiler::begin_gpu_scope(scope_name) }
+{}
+
+GpuScopeProfiler::~GpuScopeProfiler()
+{
+    Profiler::end_gpu_scope(_scope_index);
+}
+
 auto Profiler::init() -> void
 {
+    // The profiler gets initialized once the OpenGL context is current.
+    _gpu_query_pool = make_unique<gl::TimestampQueryPool>();
     begin_profile();
 }
 
@@ -65,9 +85,18 @@ auto Profiler::start_frame() -> void
     ZTH_ASSERT(_opening_marker_index_stack.empty());
     ZTH_ASSERT(_entry_stack.empty());
 
+    collect_gpu_times();
     begin_profile();
 }
 
+auto Profiler::shut_down() -> void
+{
+    _this_frame_gpu_scopes.clear();
+    _pending_gpu_frames.clear();
+    _gpu_times.clear();
+    _gpu_query_pool.free();
+}
+
 auto Profiler::display(Optional<Reference<bool>> open) -> void
 {
     ZTH_PROFILE_FUNCTION();
@@ -81,6 +110,13 @@ auto Profiler::display(Optional<Reference<bool>> open) -> void
     if (debug::button("Snapshot"))
         _snapshot = !_snapshot;
 
+    debug::text("GPU times are {} frames behind.", _gpu_frames_in_flight);
+
+    ImGui::SameLine(ImGui::GetWindowWidth() - ImGui::GetFontSize() * 10.0f);
+    debug::text("GPU");
+    ImGui::SameLine(ImGui::GetWindowWidth() - ImGui::GetFontSize() * 5.0f);
+    debug::text("CPU");
+
     merge_and_display_sub_entries({ 0 });
 
     debug::end_window();
@@ -104,6 +140,21 @@ auto Profiler::end_entry(double time) -> void
     _this_frame_markers.push_back(ProfilerEntryMarker::make_closing_marker(time));
 }
 
+auto Profiler::begin_gpu_scope(const char* label) -> u32
+{
+    auto scope_index = static_cast<u32>(_this_frame_gpu_scopes.size());
+    _this_frame_gpu_scopes.push_back(GpuProfilerScope{
+        .label = label,
+        .start_query = _gpu_query_pool->record_timestamp(),
+    });
+    return scope_index;
+}
+
+auto Profiler::end_gpu_scope(u32 scope_index) -> void
+{
+    _this_frame_gpu_scopes[scope_index].end_query = _gpu_query_pool->record_timestamp();
+}
+
 auto Profiler::begin_profile() -> void
 {
     if (!_snapshot)
@@ -118,6 +169,44 @@ auto Profiler::end_profile() -> void
     end_entry(0.0);
 }
 
+auto Profiler::collect_gpu_times() -> void
+{
+    _pending_gpu_frames.push_back(std::exchange(_this_frame_gpu_scopes, {}));
+
+    while (!_pending_gpu_frames.empty())
+    {
+        const auto& scopes = _pending_gpu_frames.front();
+
+        // Rather than stalling every frame, we only wait for the GPU when it falls too far behind.
+        auto wait = _pending_gpu_frames.size() > max_gpu_frames_in_flight;
+        auto available = std::ranges::all_of(scopes, [](const GpuProfilerScope& scope) {
+            return gl::TimestampQueryPool::result_available(scope.end_query);
+        });
+
+        if (!wait && !available)
+            break;
+
+        UnorderedMap<const char*, double> gpu_times;
+
+        for (const auto& scope : scopes)
+        {
+            auto start_time = gl::TimestampQueryPool::result(scope.start_query);
+            auto end_time = gl::TimestampQueryPool::result(scope.end_query);
+            gpu_times[scope.label] += static_cast<double>(end_time - start_time) / 1e9;
+
+            _gpu_query_pool->release(scope.start_query);
+            _gpu_query_pool->release(scope.end_query);
+        }
+
+        if (!_snapshot)
+            _gpu_times = std::move(gpu_times);
+
+        _pending_gpu_frames.erase(_pending_gpu_frames.begin());
+    }
+
+    _gpu_frames_in_flight = static_cast<u32>(_pending_gpu_frames.size());
+}
+
 auto Profiler::merge_and_display_sub_entries(const TemporaryVector<EntryMarkerIndex>& indices) -> void
 {
     // Display together sub entries of the entries pointed to by indices.
@@ -182,6 +271,12 @@ auto Profiler::merge_and_display_sub_entries(const TemporaryVector<EntryMarkerIn
         auto entry_label = format_to_temporary("{}", current_entry.label);
         auto node_opened = ImGui::TreeNode(entry_label.c_str());
 
+        if (auto gpu_time = _gpu_times.find(current_entry.label); gpu_time != _gpu_times.end())
+        {
+            ImGui::SameLine(ImGui::GetWindowWidth() - ImGui::GetFontSize() * 10.0f);
+            debug::text("{:.4f}ms", gpu_time->second * 1000.0);
+        }
+
         ImGui::SameLine(ImGui::GetWindowWidth() - ImGui::GetFontSize() * 5.0f);
         debug::text("{:.4f}ms", current_entry.time * 1000.0);
 
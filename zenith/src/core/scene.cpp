@@ -1,11 +1,19 @@
 #include "zenith/core/scene.hpp"
 
+#include <glm/common.hpp>
+#include <glm/exponential.hpp>
+#include <glm/vector_relational.hpp>
+
 #include "zenith/core/assert.hpp"
 #include "zenith/core/profiler.hpp"
 #include "zenith/ecs/components.hpp"
 #include "zenith/log/logger.hpp"
+#include "zenith/math/bounds.hpp"
+#include "zenith/math/frustum.hpp"
 #include "zenith/renderer/coordinate_space.hpp"
+#include "zenith/renderer/mesh_lod.hpp"
 #include "zenith/renderer/renderer.hpp"
+#include "zenith/system/job_system.hpp"
 
 namespace zth {
 
@@ -96,18 +104,56 @@ auto Scene::render() -> void
         Renderer::submit_light(light, transform);
     }
 
-    auto meshes = _registry.group<const MeshRendererComponent>(
-        GetComponents<const TransformComponent, const MaterialComponent>{});
+    // The LOD levels get selected before culling, so that the meshes get culled with the bounds of the levels that end
+    // up being rendered.
+    select_lod_levels(camera_transform.translation(), camera.fov);
+
+    auto retained_meshes = submit_retained_meshes();
+
+    // The rest of the meshes to render get collected first, and then recorded into draw lists in parallel.
+    _meshes_to_render.clear();
+
+    // The hierarchy gets updated even if it isn't used for culling, as updating it is what clears the registry's change
+    // logs, which would otherwise keep growing. It only looks at what changed, so it also keeps raycasts cheap.
+    _bvh.update(_registry);
 
-    for (auto&& [_, mesh, transform, material] : meshes.each())
+    if (Renderer::frustum_culling_enabled())
+    {
+        ZTH_PROFILE_SCOPE("Frustum culling");
+
+        auto frustum = math::Frustum::from_view_projection(Renderer::current_camera_view_projection());
+
+        _bvh.query(frustum, [&](EntityId entity_id) {
+            if (!is_retained(entity_id))
+                _meshes_to_render.push_back(entity_id);
+        });
+
+        // The retained meshes get culled by the renderer.
+        Renderer::report_culled_instances(
+            static_cast<u32>(_bvh.entity_count() - _meshes_to_render.size() - retained_meshes));
+    }
+    else
     {
-        auto& mesh_ptr = mesh.mesh();
-        auto& material_ptr = material.material();
-        ZTH_ASSERT(mesh_ptr != nullptr);
-        ZTH_ASSERT(material_ptr != nullptr);
-        Renderer::submit(*mesh_ptr, transform.transform(), *material_ptr);
+        auto meshes = _registry.group<const MeshRendererComponent>(
+            GetComponents<const TransformComponent, const MaterialComponent>{});
+
+        for (auto entity_id : meshes)
+        {
+            if (!is_retained(entity_id))
+                _meshes_to_render.push_back(entity_id);
+        }
     }
 
+    if (Renderer::occlusion_culling_enabled())
+        cull_occluded_meshes();
+
+    record_draw_lists();
+
+    Renderer::submit(_retained_draw_list);
+
+    for (const auto& draw_list : _draw_lists)
+        Renderer::submit(draw_list);
+
     Renderer::end_scene();
 
     Renderer2D::begin_scene();
@@ -125,6 +171,171 @@ auto Scene::render() -> void
     Renderer2D::end_scene();
 }
 
+auto Scene::select_lod_levels(glm::vec3 camera_position, float fov) -> void
+{
+    ZTH_PROFILE_FUNCTION();
+
+    _lod_entities.clear();
+
+    for (auto entity_id : _registry.view<const MeshLodComponent, const MeshRendererComponent>())
+        _lod_entities.push_back(entity_id);
+
+    auto screen_size_scale = glm::exp2(-Renderer::lod_bias());
+
+    // Every entity only touches its own components, so the entities can be processed in parallel.
+    JobSystem::parallel_for(_lod_entities.size(), meshes_per_draw_list, [&](usize begin, usize end) {
+        for (auto i = begin; i < end; i++)
+        {
+            auto entity_id = _lod_entities[i];
+
+            auto&& [lod, mesh, transform] =
+                _registry.get<MeshLodComponent, MeshRendererComponent, const TransformComponent>(entity_id);
+
+            if (!lod.lod())
+                continue;
+
+            auto bounds = math::transform_bounding_sphere(lod.lod()->bounding_sphere(), transform.transform());
+            auto screen_size = lod_screen_size(bounds, camera_position, fov) * screen_size_scale;
+            const auto& level_mesh = lod.select_level(screen_size, MeshLod::default_hysteresis);
+
+            if (mesh.mesh() != level_mesh)
+                mesh.set_mesh(level_mesh);
+        }
+    });
+}
+
+auto Scene::cull_occluded_meshes() -> void
+{
+    ZTH_PROFILE_FUNCTION();
+
+    _occlusion_buffer.begin(Renderer::current_camera_view_projection());
+
+    auto occluders = _registry.view<const OccluderComponent, const TransformComponent>();
+
+    for (auto&& [_, occluder, transform] : occluders.each())
+    {
+        if (occluder.occluder())
+            _occlusion_buffer.add_occluder(*occluder.occluder(), transform.transform());
+    }
+
+    _occlusion_buffer.finish();
+
+    OcclusionCullingStats stats{
+        .occluders = _occlusion_buffer.occluder_count(),
+        .occluder_triangles = _occlusion_buffer.triangle_count(),
+        .tested_objects = static_cast<u32>(_meshes_to_render.size()),
+    };
+
+    // Nothing can be hidden if no occluder made it to the screen.
+    if (_occlusion_buffer.triangle_count() == 0)
+    {
+        Renderer::report_occlusion_culling_stats(stats);
+        return;
+    }
+
+    _occlusion_visibility.resize(_meshes_to_render.size());
+
+    const auto& registry = _registry;
+
+    JobSystem::parallel_for(_meshes_to_render.size(), meshes_per_draw_list, [&](usize begin, usize end) {
+        for (auto i = begin; i < end; i++)
+        {
+            const auto& [mesh, transform] =
+                registry.get<const MeshRendererComponent, const TransformComponent>(_meshes_to_render[i]);
+
+            // Transforming infinite bounds would give us NaNs.
+            const auto& aabb = mesh.mesh()->aabb();
+            auto infinite = glm::any(glm::isinf(aabb.min)) || glm::any(glm::isinf(aabb.max));
+
+            _occlusion_visibility[i] =
+                infinite || _occlusion_buffer.is_visible(math::transform_aabb(aabb, transform.transform()));
+        }
+    });
+
+    usize visible_count = 0;
+
+    for (usize i = 0; i < _meshes_to_render.size(); i++)
+    {
+        if (_occlusion_visibility[i])
+            _meshes_to_render[visible_count++] = _meshes_to_render[i];
+    }
+
+    stats.occluded_objects = static_cast<u32>(_meshes_to_render.size() - visible_count);
+    _meshes_to_render.resize(visible_count);
+
+    Renderer::report_culled_instances(stats.occluded_objects);
+    Renderer::report_occlusion_culling_stats(stats);
+}
+
+auto Scene::record_draw_lists() -> void
+{
+    ZTH_PROFILE_FUNCTION();
+
+    auto draw_list_count = (_meshes_to_render.size() + meshes_per_draw_list - 1) / meshes_per_draw_list;
+    _draw_lists.resize(draw_list_count);
+
+    // Every range of meshes gets recorded into its own draw list, so the order of the draw lists matches the order in
+    // which the meshes were collected.
+    const auto& registry = _registry;
+
+    JobSystem::parallel_for(_meshes_to_render.size(), meshes_per_draw_list, [&](usize begin, usize end) {
+        auto& draw_list = _draw_lists[begin / meshes_per_draw_list];
+        draw_list.clear();
+
+        for (auto i = begin; i < end; i++)
+        {
+            auto entity_id = _meshes_to_render[i];
+
+            // The hierarchy contains every entity with a mesh, but we only render the ones with a material.
+            auto material = registry.try_get<const MaterialComponent>(entity_id);
+
+            if (!material)
+                continue;
+
+            const auto& [mesh, transform] =
+                registry.get<const MeshRendererComponent, const TransformComponent>(entity_id);
+
+            auto& mesh_ptr = mesh.mesh();
+            auto& material_ptr = material->get().material();
+            ZTH_ASSERT(mesh_ptr != nullptr);
+            ZTH_ASSERT(material_ptr != nullptr);
+            draw_list.submit(*mesh_ptr, transform, *material_ptr);
+        }
+    });
+}
+
+auto Scene::submit_retained_meshes() -> u32
+{
+    ZTH_PROFILE_FUNCTION();
+
+    auto meshes = _registry.group<const MeshRendererComponent>(
+        GetComponents<const TransformComponent, const MaterialComponent>{});
+
+    u32 count = 0;
+
+    for (auto&& [entity_id, mesh, transform, material] : meshes.each())
+    {
+        // Same as is_retained(), but without looking the components up again.
+        if (!mesh.is_static() || material.material()->transparent)
+            continue;
+
+        // Entity ids include a version, so an entity which reuses the id of a destroyed one gets a different key.
+        _retained_draw_list.submit(static_cast<RetainedDrawList::Key>(entity_id), transform.version(), mesh.mesh(),
+                                   transform, material.material());
+        count++;
+    }
+
+    return count;
+}
+
+auto Scene::is_retained(EntityId entity_id) const -> bool
+{
+    // Transparent meshes have to be sorted back to front one by one, which a retained batch can't do.
+    auto material = _registry.try_get<const MaterialComponent>(entity_id);
+    return material && !material->get().material()->transparent
+           && _registry.get<const MeshRendererComponent>(entity_id).is_static();
+}
+
 auto Scene::create_entity(const String& tag) -> EntityHandle
 {
     return _registry.create(tag);
@@ -145,6 +356,12 @@ auto Scene::find_entities_by_tag(StringView tag) -> TemporaryVector<EntityHandle
     return _registry.find_entities_by_tag(tag);
 }
 
+auto Scene::raycast(const math::Ray& ray, float max_distance) -> Optional<SceneRayHit>
+{
+    _bvh.update(_registry);
+    return _bvh.raycast(ray, max_distance);
+}
+
 auto Scene::load() -> void
 {
     ZTH_INTERNAL_TRACE("Loading scene \"{}\"...", _name);
@@ -157,6 +374,8 @@ auto Scene::unload() -> void
     ZTH_INTERNAL_TRACE("Unloading scene \"{}\"...", _name);
     on_unload();
     _registry.clear();
+    _bvh.clear();
+    _retained_draw_list.clear();
     ZTH_INTERNAL_TRACE("Scene \"{}\" unloaded.", _name);
 }
 
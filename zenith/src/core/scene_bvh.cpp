@@ -0,0 +1,192 @@
+#include "zenith/core/scene_bvh.hpp"
+
+#include <glm/common.hpp>
+#include <glm/vector_relational.hpp>
+
+#include "zenith/core/assert.hpp"
+#include "zenith/core/profiler.hpp"
+#include "zenith/ecs/components.hpp"
+#include "zenith/math/bounds.hpp"
+#include "zenith/renderer/mesh.hpp"
+#include "zenith/system/temporary_storage.hpp"
+
+namespace zth {
+
+namespace {
+
+auto has_finite_bounds(const Mesh& mesh) -> bool
+{
+    const auto& aabb = mesh.aabb();
+    return glm::all(glm::not_(glm::isinf(aabb.min))) && glm::all(glm::not_(glm::isinf(aabb.max)));
+}
+
+auto world_bounds(const Mesh& mesh, const TransformComponent& transform) -> math::Aabb
+{
+    return math::transform_aabb(mesh.aabb(), transform.transform());
+}
+
+} // namespace
+
+auto SceneBvh::update(Registry& registry) -> void
+{
+    ZTH_PROFILE_FUNCTION();
+
+    if (_needs_rebuild)
+    {
+        rebuild(registry);
+        return;
+    }
+
+    auto& mesh_renderer_changes = registry.mesh_renderer_changes();
+    auto& transform_changes = registry.transform_changes();
+
+    for (auto entity_id : mesh_renderer_changes.entities())
+        refresh(registry, entity_id);
+
+    // Only the transforms of the entities with meshes matter. Entities whose meshes were added have already been
+    // refreshed, so refreshing them again just gives them the same bounds.
+    for (auto entity_id : transform_changes.entities())
+    {
+        if (_locations.contains(entity_id))
+            refresh(registry, entity_id);
+    }
+
+    mesh_renderer_changes.clear();
+    transform_changes.clear();
+
+    _bvh.refit();
+}
+
+auto SceneBvh::rebuild(Registry& registry) -> void
+{
+    ZTH_PROFILE_FUNCTION();
+
+    _entities.clear();
+    _unbounded_entities.clear();
+    _locations.clear();
+
+    TemporaryVector<math::Aabb> bounds;
+
+    auto meshes = registry.view<const MeshRendererComponent, const TransformComponent>();
+
+    for (auto&& [entity_id, mesh_renderer, transform] : meshes.each())
+    {
+        const auto& mesh = mesh_renderer.mesh();
+        ZTH_ASSERT(mesh != nullptr);
+
+        if (!has_finite_bounds(*mesh))
+        {
+            _locations.emplace(entity_id,
+                               Location{ .index = static_cast<u32>(_unbounded_entities.size()), .bounded = false });
+            _unbounded_entities.push_back(entity_id);
+            continue;
+        }
+
+        _locations.emplace(entity_id, Location{ .index = static_cast<u32>(_entities.size()), .bounded = true });
+        _entities.push_back(entity_id);
+        bounds.push_back(world_bounds(*mesh, transform));
+    }
+
+    _bvh.build(bounds);
+
+    // Everything the logs list is already accounted for.
+    registry.mesh_renderer_changes().clear();
+    registry.transform_changes().clear();
+
+    _needs_rebuild = false;
+}
+
+auto SceneBvh::clear() -> void
+{
+    _bvh.clear();
+    _entities.clear();
+    _unbounded_entities.clear();
+    _locations.clear();
+    _needs_rebuild = true;
+}
+
+auto SceneBvh::raycast(const math::Ray& ray, float max_distance) const -> Optional<SceneRayHit>
+{
+    auto hit = _bvh.raycast(ray, max_distance);
+
+    if (!hit)
+        return nil;
+
+    return SceneRayHit{ .entity = _entities[hit->primitive_index], .distance = hit->distance };
+}
+
+auto SceneBvh::refresh(const Registry& registry, EntityId entity_id) -> void
+{
+    auto location = _locations.find(entity_id);
+    auto has_mesh = registry.valid(entity_id) && registry.all_of<MeshRendererComponent>(entity_id);
+
+    if (!has_mesh)
+    {
+        if (location != _locations.end())
+            remove(entity_id, location->second);
+
+        return;
+    }
+
+    const auto& [mesh_renderer, transform] =
+        registry.get<const MeshRendererComponent, const TransformComponent>(entity_id);
+    const auto& mesh = *mesh_renderer.mesh();
+
+    // An entity whose mesh went from finite to infinite bounds or back moves between the hierarchy and the unbounded
+    // entities.
+    if (location != _locations.end() && location->second.bounded != has_finite_bounds(mesh))
+    {
+        remove(entity_id, location->second);
+        location = _locations.end();
+    }
+
+    if (location == _locations.end())
+    {
+        add(entity_id, mesh, transform);
+        return;
+    }
+
+    if (location->second.bounded)
+        _bvh.update_primitive(location->second.index, world_bounds(mesh, transform));
+}
+
+auto SceneBvh::add(EntityId entity_id, const Mesh& mesh, const TransformComponent& transform) -> void
+{
+    if (!has_finite_bounds(mesh))
+    {
+        _locations.emplace(entity_id,
+                           Location{ .index = static_cast<u32>(_unbounded_entities.size()), .bounded = false });
+        _unbounded_entities.push_back(entity_id);
+        return;
+    }
+
+    auto primitive_index = _bvh.insert(world_bounds(mesh, transform));
+
+    if (primitive_index >= _entities.size())
+        _entities.resize(primitive_index + 1, null_entity);
+
+    _entities[primitive_index] = entity_id;
+    _locations.emplace(entity_id, Location{ .index = primitive_index, .bounded = true });
+}
+
+auto SceneBvh::remove(EntityId entity_id, Location location) -> void
+{
+    _locations.erase(entity_id);
+
+    if (location.bounded)
+    {
+        _bvh.remove(location.index);
+        _entities[location.index] = null_entity;
+        return;
+    }
+
+    // The last unbounded entity takes the removed one's place.
+    auto moved_entity_id = _unbounded_entities.back();
+    _unbounded_entities[location.index] = moved_entity_id;
+    _unbounded_entities.pop_back();
+
+    if (moved_entity_id != entity_id)
+        _locations[moved_entity_id].index = location.index;
+}
+
+} // namespace zth
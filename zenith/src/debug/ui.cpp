@@ -4,13 +4,22 @@
 #include <glm/trigonometric.hpp>
 #include <imgui_stdlib.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+
 #include "zenith/core/assert.hpp"
 #include "zenith/core/scene.hpp"
 #include "zenith/ecs/components.hpp"
+#include "zenith/gl/buffer.hpp"
 #include "zenith/gl/context.hpp"
+#include "zenith/gl/state_cache.hpp"
 #include "zenith/memory/memory.hpp"
 #include "zenith/renderer/light.hpp"
 #include "zenith/renderer/material.hpp"
+#include "zenith/renderer/mesh_lod.hpp"
+#include "zenith/renderer/occlusion_buffer.hpp"
 #include "zenith/renderer/renderer.hpp"
 #include "zenith/stl/string_algorithm.hpp"
 #include "zenith/system/application.hpp"
@@ -97,6 +106,142 @@ template<typename Component> auto display_component_for_entity_in_inspector(Enti
     }
 }
 
+// A row of a table with the columns: stat, last frame, average and max over the history.
+template<typename Stats, typename Get>
+auto stats_table_row(const char* label, std::span<const Stats> history, Get get) -> void
+{
+    ImGui::TableNextRow();
+    ImGui::TableNextColumn();
+    text(label);
+
+    if (history.empty())
+        return;
+
+    auto sum = 0.0;
+    auto max = 0.0;
+
+    for (const auto& stats : history)
+    {
+        auto value = static_cast<double>(get(stats));
+        sum += value;
+        max = std::max(max, value);
+    }
+
+    ImGui::TableNextColumn();
+    text("{:.2f}", static_cast<double>(get(history.back())));
+    ImGui::TableNextColumn();
+    text("{:.2f}", sum / static_cast<double>(history.size()));
+    ImGui::TableNextColumn();
+    text("{:.2f}", max);
+}
+
+auto begin_stats_table(const char* label) -> bool
+{
+    if (!ImGui::BeginTable(label, 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit))
+        return false;
+
+    ImGui::TableSetupColumn("Stat");
+    ImGui::TableSetupColumn("Last frame");
+    ImGui::TableSetupColumn("Average");
+    ImGui::TableSetupColumn("Max");
+    ImGui::TableHeadersRow();
+    return true;
+}
+
+auto renderer_stats_table() -> void
+{
+    auto history = Renderer::stats_history();
+
+    if (!begin_stats_table("Renderer Stats"))
+        return;
+
+    auto row = [&](const char* label, auto get) { stats_table_row(label, history, get); };
+
+    row("Draw calls", [](auto& stats) { return stats.draw_calls; });
+    row("Depth pre-pass draw calls", [](auto& stats) { return stats.depth_prepass_draw_calls; });
+    row("Transparent draw calls", [](auto& stats) { return stats.transparent_draw_calls; });
+    row("Instances", [](auto& stats) { return stats.instances; });
+    row("Triangles", [](auto& stats) { return stats.triangles; });
+    row("Batches", [](auto& stats) { return stats.batches; });
+    row("Shader binds", [](auto& stats) { return stats.shader_binds; });
+    row("Material binds", [](auto& stats) { return stats.material_binds; });
+    row("Texture binds", [](auto& stats) { return stats.texture_binds; });
+    row("Vertex array binds", [](auto& stats) { return stats.vertex_array_binds; });
+    row("Instance data (KB)", [](auto& stats) { return memory::to_kilobytes(stats.instance_bytes_uploaded); });
+    row("Indirect commands (KB)",
+        [](auto& stats) { return memory::to_kilobytes(stats.draw_indirect_bytes_uploaded); });
+    row("Uniform data (KB)", [](auto& stats) { return memory::to_kilobytes(stats.uniform_bytes_uploaded); });
+    row("Storage data (KB)", [](auto& stats) { return memory::to_kilobytes(stats.storage_bytes_uploaded); });
+    row("Buffer reallocations", [](auto& stats) { return stats.buffer_reallocations; });
+    row("Directional lights", [](auto& stats) { return stats.directional_lights; });
+    row("Point lights", [](auto& stats) { return stats.point_lights; });
+    row("Spot lights", [](auto& stats) { return stats.spot_lights; });
+    row("Ambient lights", [](auto& stats) { return stats.ambient_lights; });
+    row("Sort time (ms)", [](auto& stats) { return stats.sort_time * 1000.0; });
+    row("Batch time (ms)", [](auto& stats) { return stats.batch_time * 1000.0; });
+    row("Upload time (ms)", [](auto& stats) { return stats.upload_time * 1000.0; });
+
+    ImGui::EndTable();
+}
+
+auto renderer_2d_stats_table() -> void
+{
+    auto history = Renderer2D::stats_history();
+
+    if (!begin_stats_table("Renderer 2D Stats"))
+        return;
+
+    auto row = [&](const char* label, auto get) { stats_table_row(label, history, get); };
+
+    row("Draw calls", [](auto& stats) { return stats.draw_calls; });
+    row("Quads", [](auto& stats) { return stats.quads; });
+    row("Batches", [](auto& stats) { return stats.batches; });
+    row("Vertex data (KB)", [](auto& stats) { return memory::to_kilobytes(stats.vertex_bytes_uploaded); });
+
+    ImGui::EndTable();
+}
+
+// ImTextureID is a pointer in some versions of ImGui and an integer in others.
+template<typename TextureId = ImTextureID> [[nodiscard]] auto to_imgui_texture_id(const gl::Texture2D& texture)
+    -> TextureId
+{
+    if constexpr (std::is_pointer_v<TextureId>)
+        return reinterpret_cast<TextureId>(static_cast<std::uintptr_t>(texture.native_handle()));
+    else
+        return static_cast<TextureId>(texture.native_handle());
+}
+
+// The depths get stretched over the range of the depths of the covered texels, as perspective depth bunches up close to
+// 1. Closer texels are brighter and the texels which no occluder covers are black.
+[[nodiscard]] auto occlusion_buffer_image(std::span<const float> depths) -> TemporaryVector<glm::vec<4, u8>>
+{
+    auto nearest = 1.0f;
+    auto farthest = 0.0f;
+
+    for (auto depth : depths)
+    {
+        if (depth < 1.0f)
+        {
+            nearest = std::min(nearest, depth);
+            farthest = std::max(farthest, depth);
+        }
+    }
+
+    auto range = std::max(farthest - nearest, 1e-6f);
+
+    TemporaryVector<glm::vec<4, u8>> pixels;
+    pixels.reserve(depths.size());
+
+    for (auto depth : depths)
+    {
+        auto brightness = depth < 1.0f ? 255.0f - (depth - nearest) / range * 191.0f : 0.0f;
+        auto value = static_cast<u8>(brightness);
+        pixels.emplace_back(value, value, value, 255);
+    }
+
+    return pixels;
+}
+
 } // namespace
 
 auto begin_window(const char* label, Optional<Reference<bool>> open) -> void
@@ -842,6 +987,7 @@ auto edit_material(Material& material) -> void
     drag_vec("Diffuse", material.diffuse);
     drag_vec("Specular", material.specular);
     drag_float("Shininess", material.shininess, material_shininess_drag_speed);
+    checkbox("Transparent", material.transparent);
 }
 
 auto edit_light_properties(LightProperties& properties) -> void
@@ -956,11 +1102,34 @@ auto edit_component(SpriteRenderer2DComponent& sprite) -> void
 
 auto edit_component(MeshRendererComponent& mesh) -> void
 {
-    (void)mesh;
+    auto is_static = mesh.is_static();
 
-    text("TODO!");
+    if (checkbox("Static", is_static))
+        mesh.set_static(is_static);
 
-    // @todo
+    // @todo: Mesh selection.
+}
+
+auto edit_component(MeshLodComponent& lod) -> void
+{
+    if (!lod.lod())
+    {
+        text("No LOD");
+        return;
+    }
+
+    text("Level: {} / {}", lod.current_level(), lod.lod()->level_count());
+}
+
+auto edit_component(OccluderComponent& occluder) -> void
+{
+    if (!occluder.occluder())
+    {
+        text("No occluder");
+        return;
+    }
+
+    text("Triangles: {}", occluder.occluder()->triangle_count());
 }
 
 auto edit_component(MaterialComponent& material) -> void
@@ -1023,6 +1192,12 @@ auto EntityInspectorPanel::display(EntityHandle entity, Optional<Reference<bool>
     if (entity.any_of<MeshRendererComponent>())
         display_component_for_entity_in_inspector<MeshRendererComponent>(entity);
 
+    if (entity.any_of<MeshLodComponent>())
+        display_component_for_entity_in_inspector<MeshLodComponent>(entity);
+
+    if (entity.any_of<OccluderComponent>())
+        display_component_for_entity_in_inspector<OccluderComponent>(entity);
+
     if (entity.any_of<MaterialComponent>())
         display_component_for_entity_in_inspector<MaterialComponent>(entity);
 
@@ -1048,6 +1223,8 @@ auto EntityInspectorPanel::display(EntityHandle entity, Optional<Reference<bool>
         add_component_menu_item(std::type_identity<LightComponent>{});
         add_component_menu_item(std::type_identity<SpriteRenderer2DComponent>{});
         add_component_menu_item(std::type_identity<MeshRendererComponent>{});
+        add_component_menu_item(std::type_identity<MeshLodComponent>{});
+        add_component_menu_item(std::type_identity<OccluderComponent>{});
         add_component_menu_item(std::type_identity<MaterialComponent>{});
         add_component_menu_item(std::type_identity<ScriptComponent>{});
 
@@ -1220,6 +1397,86 @@ auto DebugPanel::display(Optional<Reference<bool>> open) -> void
         text("Draw Calls (3D): {}", Renderer::draw_calls_last_frame());
         text("Draw Calls (2D): {}", Renderer2D::draw_calls_last_frame());
 
+        if (ImGui::TreeNode("Renderer stats"))
+        {
+            renderer_stats_table();
+            renderer_2d_stats_table();
+            ImGui::TreePop();
+        }
+
+        auto& batching_stats = Renderer::batching_stats_last_frame();
+        text("Batches (3D): {}", batching_stats.batches);
+        text("Batches merged by the material table: {}", batching_stats.merged_batches);
+
+        auto& state_cache_stats = gl::StateCache::stats_last_frame();
+        text("GL state calls issued: {}", state_cache_stats.calls_issued);
+        text("GL state calls elided: {}", state_cache_stats.calls_elided);
+
+        auto& culling_stats = Renderer::culling_stats_last_frame();
+        text("Instances submitted: {}", culling_stats.submitted_instances);
+        text("Instances culled: {}", culling_stats.culled_instances);
+
+        auto& retained_stats = Renderer::retained_instance_stats_last_frame();
+        text("Retained instances reused: {}", retained_stats.reused_instances);
+        text("Retained instances uploaded: {} ({} uploads, {:.2f} KB)", retained_stats.uploaded_instances,
+             retained_stats.uploads, memory::to_kilobytes(retained_stats.uploaded_bytes));
+        text("Retained instances added / removed: {} / {}", retained_stats.added_instances,
+             retained_stats.removed_instances);
+        text("Retained instances culled: {}", retained_stats.culled_instances);
+
+        auto& occlusion_culling_stats = Renderer::occlusion_culling_stats_last_frame();
+        text("Occluders: {} ({} triangles rasterized)", occlusion_culling_stats.occluders,
+             occlusion_culling_stats.occluder_triangles);
+        text("Objects occluded: {} / {}", occlusion_culling_stats.occluded_objects,
+             occlusion_culling_stats.tested_objects);
+
+        if (ImGui::TreeNode("Occlusion buffer"))
+        {
+            display_occlusion_buffer();
+            ImGui::TreePop();
+        }
+
+        auto& light_cluster_stats = Renderer::light_cluster_stats_last_frame();
+        text("Light clusters occupied: {} / {}", light_cluster_stats.occupied_clusters,
+             light_cluster_stats.cluster_count);
+        text("Lights per occupied cluster: {:.2f} avg, {} max",
+             light_cluster_stats.average_lights_per_occupied_cluster, light_cluster_stats.max_lights_per_cluster);
+
+        auto& render_pass_timings = Renderer::render_pass_timings_last_frame();
+        text("GPU forward pass: {:.4f}ms", render_pass_timings.forward_pass * 1000.0);
+        text("GPU G-buffer pass: {:.4f}ms", render_pass_timings.gbuffer_pass * 1000.0);
+        text("GPU lighting pass: {:.4f}ms", render_pass_timings.lighting_pass * 1000.0);
+        text("GPU transparent pass: {:.4f}ms", render_pass_timings.transparent_pass * 1000.0);
+
+        if (ImGui::TreeNode("Render graph"))
+        {
+            const auto& render_graph = Renderer::frame_graph_last_frame();
+            const auto& render_graph_stats = render_graph.stats();
+
+            text("Passes: {} ({} culled)", render_graph_stats.passes, render_graph_stats.culled_passes);
+            text("Transient memory: {:.2f}MB ({:.2f}MB without aliasing)",
+                 memory::to_megabytes(render_graph_stats.allocated_bytes),
+                 memory::to_megabytes(render_graph_stats.transient_bytes));
+
+            auto dump = render_graph.dump();
+            ImGui::TextUnformatted(dump.c_str());
+            ImGui::TreePop();
+        }
+
+        auto& overdraw_stats = Renderer::overdraw_stats_last_frame();
+        text("Shaded samples: {} ({:.2f} per viewport sample)", overdraw_stats.shaded_samples,
+             static_cast<double>(overdraw_stats.shaded_samples)
+                 / static_cast<double>(std::max(overdraw_stats.viewport_samples, u64{ 1 })));
+
+        auto& instance_buffer_stats = Renderer::instance_buffer_stats_last_frame(InstanceFormat::Standard);
+        auto& compact_instance_buffer_stats = Renderer::instance_buffer_stats_last_frame(InstanceFormat::Compact);
+        text("Instance data streamed: {:.2f}MB ({:.2f}MB compact)",
+             memory::to_megabytes(instance_buffer_stats.bytes_streamed + compact_instance_buffer_stats.bytes_streamed),
+             memory::to_megabytes(compact_instance_buffer_stats.bytes_streamed));
+        text("Instance buffer fence waits: {} ({:.3f}ms)",
+             instance_buffer_stats.fence_waits + compact_instance_buffer_stats.fence_waits,
+             (instance_buffer_stats.fence_wait_time + compact_instance_buffer_stats.fence_wait_time) * 1000.0);
+
         auto temporary_storage_capacity = TemporaryStorage::capacity();
         auto temporary_storage_usage = TemporaryStorage::usage_last_frame();
 
@@ -1286,6 +1543,62 @@ auto DebugPanel::display(Optional<Reference<bool>> open) -> void
             Renderer::set_wireframe_mode_enabled(wireframe_mode_enabled);
     }
 
+    {
+        auto frustum_culling_enabled = Renderer::frustum_culling_enabled();
+
+        if (checkbox("Frustum Culling", frustum_culling_enabled))
+            Renderer::set_frustum_culling_enabled(frustum_culling_enabled);
+    }
+
+    {
+        auto occlusion_culling_enabled = Renderer::occlusion_culling_enabled();
+
+        if (checkbox("Occlusion Culling", occlusion_culling_enabled))
+            Renderer::set_occlusion_culling_enabled(occlusion_culling_enabled);
+    }
+
+    {
+        auto lod_bias = Renderer::lod_bias();
+
+        if (drag_float("LOD Bias", lod_bias))
+            Renderer::set_lod_bias(lod_bias);
+    }
+
+    {
+        auto shading_mode = Renderer::shading_mode();
+
+        if (select_enum("Shading Mode", shading_mode))
+            Renderer::set_shading_mode(shading_mode);
+    }
+
+    {
+        auto front_to_back_sorting_enabled = Renderer::front_to_back_sorting_enabled();
+
+        if (checkbox("Front-to-Back Sorting", front_to_back_sorting_enabled))
+            Renderer::set_front_to_back_sorting_enabled(front_to_back_sorting_enabled);
+    }
+
+    {
+        auto depth_prepass_enabled = Renderer::depth_prepass_enabled();
+
+        if (checkbox("Depth Pre-Pass", depth_prepass_enabled))
+            Renderer::set_depth_prepass_enabled(depth_prepass_enabled);
+    }
+
+    {
+        auto light_clustering_enabled = Renderer::light_clustering_enabled();
+
+        if (checkbox("Light Clustering", light_clustering_enabled))
+            Renderer::set_light_clustering_enabled(light_clustering_enabled);
+    }
+
+    {
+        auto multi_draw_indirect_enabled = Renderer::multi_draw_indirect_enabled();
+
+        if (checkbox("Multi-Draw Indirect", multi_draw_indirect_enabled))
+            Renderer::set_multi_draw_indirect_enabled(multi_draw_indirect_enabled);
+    }
+
     input_float("Delta time limit", Application::delta_time_limit);
     input_float("Fixed time step", Application::fixed_time_step);
     input_int("Max fixed updates per frame", Application::max_fixed_updates_per_frame);
@@ -1298,6 +1611,35 @@ auto DebugPanel::display(Optional<Reference<bool>> open) -> void
     end_window();
 }
 
+auto DebugPanel::display_occlusion_buffer() -> void
+{
+    const auto& occlusion_buffer = SceneManager::scene().occlusion_buffer();
+
+    drag_int("Level", _occlusion_buffer_level);
+    _occlusion_buffer_level = std::min(_occlusion_buffer_level, occlusion_buffer.level_count() - 1);
+
+    auto level_size = occlusion_buffer.level_size(_occlusion_buffer_level);
+    auto pixels = occlusion_buffer_image(occlusion_buffer.level(_occlusion_buffer_level));
+
+    gl::TextureParams texture_params{
+        .horizontal_wrap = gl::TextureWrapMode::ClampToEdge,
+        .vertical_wrap = gl::TextureWrapMode::ClampToEdge,
+        .min_filter = gl::TextureMinFilter::nearest_mipmap_nearest,
+        .mag_filter = gl::TextureMagFilter::nearest,
+    };
+
+    // The buffer changes every frame, so the texture gets recreated every frame as long as the buffer is displayed.
+    _occlusion_buffer_texture = gl::Texture2D::from_rgba8(pixels, level_size.x, level_size.y, texture_params);
+
+    auto size = occlusion_buffer.size();
+    auto width = ImGui::GetContentRegionAvail().x;
+    ImVec2 image_size{ width, width * static_cast<float>(size.y) / static_cast<float>(size.x) };
+
+    // The rows of the buffer start at the bottom.
+    ImGui::Image(to_imgui_texture_id(*_occlusion_buffer_texture), image_size, ImVec2{ 0.0f, 1.0f },
+                 ImVec2{ 1.0f, 0.0f });
+}
+
 ScenePicker::ScenePicker(StringView label) : display_label{ label } {}
 
 auto ScenePicker::display(Optional<Reference<bool>> open) -> void
@@ -1350,6 +1692,18 @@ auto ScenePicker::next_scene() -> void
     load_scene(_selected_scene_idx);
 }
 
+auto ScenePicker::select_scene(StringView name) -> bool
+{
+    auto scene = std::ranges::find(_scene_names, name);
+
+    if (scene == _scene_names.end())
+        return false;
+
+    _selected_scene_idx = static_cast<usize>(scene - _scene_names.begin());
+    load_scene(_selected_scene_idx);
+    return true;
+}
+
 auto ScenePicker::load_scene(usize idx) const -> void
 {
     SceneManager::queue_scene(_scene_factories[idx]);
@@ -0,0 +1,54 @@
+#include "zenith/ecs/change_log.hpp"
+
+namespace zth {
+
+auto ChangeLog::add(entt::entity entity) -> void
+{
+    std::scoped_lock lock{ _mutex };
+    _entities.push_back(entity);
+}
+
+auto ChangeLog::clear() -> void
+{
+    _entities.clear();
+    _generation++;
+}
+
+auto ChangeTracker::operator=([[maybe_unused]] const ChangeTracker& other) -> ChangeTracker&
+{
+    // The component which is being assigned to stays attached to its own entity.
+    mark_changed();
+    return *this;
+}
+
+auto ChangeTracker::operator=(ChangeTracker&& other) noexcept -> ChangeTracker&
+{
+    if (this != &other && other._log)
+    {
+        _log = other._log;
+        _entity = other._entity;
+        _logged_generation = other._logged_generation;
+    }
+
+    mark_changed();
+    return *this;
+}
+
+auto ChangeTracker::attach(ChangeLog& log, entt::entity entity) -> void
+{
+    _log = &log;
+    _entity = entity;
+    _logged_generation = 0;
+    mark_changed();
+}
+
+auto ChangeTracker::mark_changed() -> void
+{
+    if (!_log || _logged_generation == _log->generation())
+        return;
+
+    _logged_generation = _log->generation();
+    _log->add(_entity);
+}
+
+} // namespace zth
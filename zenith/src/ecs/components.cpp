@@ -2,9 +2,12 @@
 
 #include <glm/ext/matrix_clip_space.hpp>
 
+#include <atomic>
+
 #include "zenith/core/assert.hpp"
 #include "zenith/math/matrix.hpp"
 #include "zenith/math/vector.hpp"
+#include "zenith/renderer/mesh_lod.hpp"
 
 namespace zth {
 
@@ -196,6 +199,9 @@ auto TransformComponent::set_transform(const glm::mat4& transform) -> TransformC
     _scale = scale;
 
     _transform = transform;
+    _composed = false;
+    _version = next_version();
+    _change_tracker.mark_changed();
     return *this;
 }
 
@@ -232,6 +238,16 @@ auto TransformComponent::display_label() -> const char*
 auto TransformComponent::update_transform() -> void
 {
     _transform = math::compose_transform(_scale, _rotation, _translation);
+    _composed = true;
+    _version = next_version();
+    _change_tracker.mark_changed();
+}
+
+auto TransformComponent::next_version() -> u64
+{
+    // Transforms might get created and modified from multiple threads. The versions only have to be unique.
+    static std::atomic<u64> version = 0;
+    return version.fetch_add(1, std::memory_order_relaxed);
 }
 
 // --------------------------- ScriptComponent ---------------------------
@@ -301,7 +317,8 @@ auto SpriteRenderer2DComponent::get_default_rect() -> Rect<u32>
 
 // --------------------------- MeshRendererComponent ---------------------------
 
-MeshRendererComponent::MeshRendererComponent(std::shared_ptr<const Mesh> mesh) : _mesh{ std::move(mesh) }
+MeshRendererComponent::MeshRendererComponent(std::shared_ptr<const Mesh> mesh, bool is_static)
+    : _mesh{ std::move(mesh) }, _static{ is_static }
 {
     ZTH_ASSERT(_mesh != nullptr);
 }
@@ -310,6 +327,7 @@ auto MeshRendererComponent::set_mesh(std::shared_ptr<const Mesh> mesh) -> void
 {
     ZTH_ASSERT(mesh != nullptr);
     _mesh = std::move(mesh);
+    _change_tracker.mark_changed();
 }
 
 auto MeshRendererComponent::mesh() const -> const std::shared_ptr<const Mesh>&
@@ -317,11 +335,64 @@ auto MeshRendererComponent::mesh() const -> const std::shared_ptr<const Mesh>&
     return _mesh;
 }
 
+auto MeshRendererComponent::set_static(bool is_static) -> void
+{
+    _static = is_static;
+    _change_tracker.mark_changed();
+}
+
 auto MeshRendererComponent::display_label() -> const char*
 {
     return "Mesh Renderer";
 }
 
+// --------------------------- MeshLodComponent ---------------------------
+
+MeshLodComponent::MeshLodComponent(std::shared_ptr<const MeshLod> lod) : _lod{ std::move(lod) } {}
+
+auto MeshLodComponent::set_lod(std::shared_ptr<const MeshLod> lod) -> void
+{
+    _lod = std::move(lod);
+    _current_level = 0;
+}
+
+auto MeshLodComponent::lod() const -> const std::shared_ptr<const MeshLod>&
+{
+    return _lod;
+}
+
+auto MeshLodComponent::select_level(float screen_size, float hysteresis) -> const std::shared_ptr<const Mesh>&
+{
+    ZTH_ASSERT(_lod != nullptr);
+    _current_level = _lod->select_level(screen_size, _current_level, hysteresis);
+    return _lod->levels()[_current_level].mesh;
+}
+
+auto MeshLodComponent::display_label() -> const char*
+{
+    return "Mesh LOD";
+}
+
+// --------------------------- OccluderComponent ---------------------------
+
+OccluderComponent::OccluderComponent(std::shared_ptr<const OccluderMesh> occluder) : _occluder{ std::move(occluder) }
+{}
+
+auto OccluderComponent::set_occluder(std::shared_ptr<const OccluderMesh> occluder) -> void
+{
+    _occluder = std::move(occluder);
+}
+
+auto OccluderComponent::occluder() const -> const std::shared_ptr<const OccluderMesh>&
+{
+    return _occluder;
+}
+
+auto OccluderComponent::display_label() -> const char*
+{
+    return "Occluder";
+}
+
 // --------------------------- MaterialComponent ---------------------------
 
 MaterialComponent::MaterialComponent(std::shared_ptr<const Material> material) : _material{ std::move(material) }
@@ -94,6 +94,30 @@ auto EntityHandle::registry_unchecked() const -> Registry&
     return *_registry;
 }
 
+template<typename Component> auto Registry::track_changes(ChangeLog& log) -> void
+{
+    _registry.on_construct<Component>().template connect<&Registry::attach_change_tracker<Component>>(log);
+    _registry.on_destroy<Component>().template connect<&Registry::log_removal>(log);
+}
+
+template<typename Component>
+auto Registry::attach_change_tracker(ChangeLog& log, entt::registry& registry, entt::entity entity) -> void
+{
+    // Only now is the component in its final place in the registry's storage.
+    registry.get<Component>(entity)._change_tracker.attach(log, entity);
+}
+
+auto Registry::log_removal(ChangeLog& log, [[maybe_unused]] entt::registry& registry, entt::entity entity) -> void
+{
+    log.add(entity);
+}
+
+Registry::Registry()
+{
+    track_changes<TransformComponent>(_transform_changes);
+    track_changes<MeshRendererComponent>(_mesh_renderer_changes);
+}
+
 Registry::~Registry()
 {
     clear();
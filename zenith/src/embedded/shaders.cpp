@@ -5,6 +5,9 @@
 namespace zth::embedded::shaders {
 
 const StringView defines_glsl = b::embed<"src/shaders/zth_defines.glsl">().str();
+const StringView lighting_glsl = b::embed<"src/shaders/zth_lighting.glsl">().str();
+const StringView vertex_glsl = b::embed<"src/shaders/zth_vertex.glsl">().str();
+const StringView standard_vertex_glsl = b::embed<"src/shaders/zth_standard_vertex.glsl">().str();
 
 const StringView fallback_vert = b::embed<"src/shaders/zth_fallback.vert">().str();
 const StringView fallback_frag = b::embed<"src/shaders/zth_fallback.frag">().str();
@@ -12,7 +15,13 @@ const StringView flat_color_vert = b::embed<"src/shaders/zth_flat_color.vert">()
 const StringView flat_color_frag = b::embed<"src/shaders/zth_flat_color.frag">().str();
 const StringView standard_vert = b::embed<"src/shaders/zth_standard.vert">().str();
 const StringView standard_frag = b::embed<"src/shaders/zth_standard.frag">().str();
+const StringView standard_compact_vert = b::embed<"src/shaders/zth_standard_compact.vert">().str();
 const StringView texture_2d_vert = b::embed<"src/shaders/zth_texture_2d.vert">().str();
 const StringView texture_2d_frag = b::embed<"src/shaders/zth_texture_2d.frag">().str();
+const StringView deferred_geometry_frag = b::embed<"src/shaders/zth_deferred_geometry.frag">().str();
+const StringView deferred_lighting_vert = b::embed<"src/shaders/zth_deferred_lighting.vert">().str();
+const StringView deferred_lighting_frag = b::embed<"src/shaders/zth_deferred_lighting.frag">().str();
+const StringView depth_only_vert = b::embed<"src/shaders/zth_depth_only.vert">().str();
+const StringView depth_only_frag = b::embed<"src/shaders/zth_depth_only.frag">().str();
 
 } // namespace zth::embedded::shaders
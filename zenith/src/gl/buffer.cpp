@@ -1,6 +1,10 @@
 #include "zenith/gl/buffer.hpp"
 
+#include <chrono>
+
 #include "zenith/core/assert.hpp"
+#include "zenith/gl/context.hpp"
+#include "zenith/gl/state_cache.hpp"
 
 namespace zth::gl {
 
@@ -16,6 +20,58 @@ constinit const BufferUsage BufferUsage::stream_copy{ BufferAccessFrequency::Str
 constinit const BufferUsage BufferUsage::static_copy{ BufferAccessFrequency::Static, BufferAccessType::Copy };
 constinit const BufferUsage BufferUsage::dynamic_copy{ BufferAccessFrequency::Dynamic, BufferAccessType::Copy };
 
+// --------------------------- StreamingRegions ---------------------------
+
+StreamingRegions::StreamingRegions(u32 region_size_bytes, u32 region_count)
+    : _region_size_bytes{ region_size_bytes }, _region_count{ region_count }
+{
+    ZTH_ASSERT(region_size_bytes != 0);
+    ZTH_ASSERT(region_count != 0);
+}
+
+auto StreamingRegions::offset_in_current_region(u32 size_bytes, u32 alignment) const -> Optional<u32>
+{
+    return offset_in_region(_current_region, _current_region_offset, size_bytes, alignment);
+}
+
+auto StreamingRegions::offset_in_next_region(u32 size_bytes, u32 alignment) const -> Optional<u32>
+{
+    return offset_in_region((_current_region + 1) % _region_count, 0, size_bytes, alignment);
+}
+
+auto StreamingRegions::allocate(u32 offset, u32 size_bytes) -> void
+{
+    const auto region_begin = _current_region * _region_size_bytes;
+
+    ZTH_ASSERT(offset >= region_begin + _current_region_offset);
+    ZTH_ASSERT(offset + size_bytes <= region_begin + _region_size_bytes);
+
+    _current_region_offset = offset + size_bytes - region_begin;
+}
+
+auto StreamingRegions::next_region() -> void
+{
+    _current_region = (_current_region + 1) % _region_count;
+    _current_region_offset = 0;
+}
+
+auto StreamingRegions::offset_in_region(u32 region, u32 region_offset, u32 size_bytes, u32 alignment) const
+    -> Optional<u32>
+{
+    ZTH_ASSERT(alignment != 0);
+
+    const auto region_begin = region * _region_size_bytes;
+    const auto region_end = region_begin + _region_size_bytes;
+
+    // Alignment doesn't have to be a power of two, as instance data gets aligned to the size of an instance.
+    const auto offset = (region_begin + region_offset + alignment - 1) / alignment * alignment;
+
+    if (offset > region_end || size_bytes > region_end - offset)
+        return nil;
+
+    return offset;
+}
+
 // --------------------------- Buffer ---------------------------
 
 Buffer::Buffer()
@@ -58,6 +114,13 @@ auto Buffer::create_dynamic_with_data(std::span<const byte> data, BufferUsage us
     return buffer;
 }
 
+auto Buffer::create_streaming(u32 region_size_bytes, u32 region_count) -> Buffer
+{
+    Buffer buffer;
+    buffer.init_streaming(region_size_bytes, region_count);
+    return buffer;
+}
+
 Buffer::Buffer(const Buffer& other) : Buffer()
 {
     copy_initialize(other);
@@ -77,7 +140,8 @@ auto Buffer::operator=(const Buffer& other) -> Buffer&
 Buffer::Buffer(Buffer&& other) noexcept
     : _id{ std::exchange(other._id, GL_NONE) }, _size_bytes{ std::exchange(other._size_bytes, 0) },
       _capacity_bytes{ std::exchange(other._capacity_bytes, 0) },
-      _state{ std::exchange(other._state, BufferState::Uninitialized) }, _usage{ std::exchange(other._usage, nil) }
+      _state{ std::exchange(other._state, BufferState::Uninitialized) }, _usage{ std::exchange(other._usage, nil) },
+      _streaming_state{ std::move(other._streaming_state) }
 {}
 
 auto Buffer::operator=(Buffer&& other) noexcept -> Buffer&
@@ -89,6 +153,7 @@ auto Buffer::operator=(Buffer&& other) noexcept -> Buffer&
     _capacity_bytes = std::exchange(other._capacity_bytes, 0);
     _state = std::exchange(other._state, BufferState::Uninitialized);
     _usage = std::exchange(other._usage, nil);
+    _streaming_state = std::move(other._streaming_state);
 
     return *this;
 }
@@ -122,6 +187,28 @@ auto Buffer::init_static_with_data(std::span<const byte> data) -> void
     _state = BufferState::InitializedStatic;
 }
 
+auto Buffer::init_streaming(u32 region_size_bytes, u32 region_count) -> void
+{
+    ZTH_ASSERT(_state == BufferState::Uninitialized);
+    ZTH_ASSERT(region_size_bytes != 0);
+    ZTH_ASSERT(region_count >= 2 && region_count <= max_streaming_region_count);
+
+    _size_bytes = region_size_bytes * region_count;
+    _capacity_bytes = _size_bytes;
+
+    constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glNamedBufferStorage(_id, _size_bytes, nullptr, flags);
+
+    _streaming_state = make_unique<StreamingState>(StreamingState{
+        .mapped_memory = static_cast<byte*>(glMapNamedBufferRange(_id, 0, _size_bytes, flags)),
+        .regions = StreamingRegions{ region_size_bytes, region_count },
+    });
+
+    ZTH_ASSERT(_streaming_state->mapped_memory != nullptr);
+
+    _state = BufferState::InitializedStreaming;
+}
+
 auto Buffer::init_dynamic(BufferUsage usage) -> void
 {
     init_dynamic_with_size(0, usage);
@@ -129,7 +216,8 @@ auto Buffer::init_dynamic(BufferUsage usage) -> void
 
 auto Buffer::init_dynamic_with_size(u32 size_bytes, BufferUsage usage) -> void
 {
-    ZTH_ASSERT(_state != BufferState::InitializedStatic); // Dynamic buffers can be reinitialized.
+    // Dynamic buffers can be reinitialized.
+    ZTH_ASSERT(_state != BufferState::InitializedStatic && _state != BufferState::InitializedStreaming);
 
     _size_bytes = size_bytes;
     _capacity_bytes = size_bytes;
@@ -141,7 +229,8 @@ auto Buffer::init_dynamic_with_size(u32 size_bytes, BufferUsage usage) -> void
 
 auto Buffer::init_dynamic_with_data(std::span<const byte> data, BufferUsage usage) -> void
 {
-    ZTH_ASSERT(_state != BufferState::InitializedStatic); // Dynamic buffers can be reinitialized.
+    // Dynamic buffers can be reinitialized.
+    ZTH_ASSERT(_state != BufferState::InitializedStatic && _state != BufferState::InitializedStreaming);
 
     _size_bytes = static_cast<u32>(data.size_bytes());
     _capacity_bytes = static_cast<u32>(data.size_bytes());
@@ -206,8 +295,82 @@ auto Buffer::clear() -> void
     resize(0);
 }
 
+auto Buffer::allocate_streaming(u32 size_bytes, u32 alignment) -> Optional<StreamingAllocation>
+{
+    ZTH_ASSERT(_state == BufferState::InitializedStreaming);
+    ZTH_ASSERT(alignment != 0);
+
+    auto& streaming = *_streaming_state;
+
+    auto offset = streaming.regions.offset_in_current_region(size_bytes, alignment);
+
+    if (!offset)
+    {
+        // The next region is empty, so this only fails if the allocation is bigger than a whole region.
+        if (!streaming.regions.offset_in_next_region(size_bytes, alignment))
+            return nil;
+
+        next_streaming_region();
+        offset = streaming.regions.offset_in_current_region(size_bytes, alignment);
+        ZTH_ASSERT(offset.has_value());
+    }
+
+    streaming.regions.allocate(*offset, size_bytes);
+    streaming.stats.bytes_streamed += size_bytes;
+
+    return StreamingAllocation{
+        .data = std::span{ streaming.mapped_memory + *offset, size_bytes },
+        .offset = *offset,
+    };
+}
+
+auto Buffer::fits_in_streaming_region(u32 size_bytes, u32 alignment) const -> bool
+{
+    ZTH_ASSERT(_state == BufferState::InitializedStreaming);
+
+    return _streaming_state->regions.offset_in_current_region(size_bytes, alignment).has_value();
+}
+
+auto Buffer::next_streaming_region() -> void
+{
+    ZTH_ASSERT(_state == BufferState::InitializedStreaming);
+
+    auto& streaming = *_streaming_state;
+
+    // Nothing was written to the current region, so there's nothing the GPU could still be reading.
+    if (auto region = streaming.regions.current_region(); streaming.regions.current_region_offset() != 0)
+    {
+        ZTH_ASSERT(streaming.region_fences[region] == nullptr);
+        streaming.region_fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+
+    streaming.regions.next_region();
+    streaming.stats.regions_entered++;
+
+    wait_for_streaming_region(streaming.regions.current_region());
+}
+
+auto Buffer::reset_streaming_stats() -> void
+{
+    ZTH_ASSERT(_state == BufferState::InitializedStreaming);
+    _streaming_state->stats = {};
+}
+
+auto Buffer::streaming_region_size_bytes() const -> u32
+{
+    ZTH_ASSERT(_state == BufferState::InitializedStreaming);
+    return _streaming_state->regions.region_size_bytes();
+}
+
+auto Buffer::streaming_stats() const -> StreamingBufferStats
+{
+    ZTH_ASSERT(_state == BufferState::InitializedStreaming);
+    return _streaming_state->stats;
+}
+
 auto Buffer::free() noexcept -> void
 {
+    free_streaming_state();
     destroy();
 
     _id = GL_NONE;
@@ -224,6 +387,7 @@ auto Buffer::create() noexcept -> void
 
 auto Buffer::destroy() noexcept -> void
 {
+    StateCache::forget_buffer(_id);
     glDeleteBuffers(1, &_id);
 }
 
@@ -250,6 +414,14 @@ auto Buffer::copy_initialize(const Buffer& other) -> void
         copy_buffer_data(*this, other, other._size_bytes);
     }
     break;
+    case InitializedStreaming:
+    {
+        // The contents of a streaming buffer are only meaningful for the frame they were written in, so there's no
+        // point in copying them.
+        init_streaming(other._streaming_state->regions.region_size_bytes(),
+                       other._streaming_state->regions.region_count());
+    }
+    break;
     }
 }
 
@@ -269,6 +441,57 @@ auto Buffer::buffer_data_dynamic(std::span<const byte> data, u32 offset) -> u32
     return static_cast<u32>(data.size_bytes());
 }
 
+auto Buffer::wait_for_streaming_region(u32 region) -> void
+{
+    auto& streaming = *_streaming_state;
+    auto& fence = streaming.region_fences[region];
+
+    if (!fence)
+        return;
+
+    // Poll first, so that only the actual waits get counted. Flushing makes sure that the fence gets submitted to the
+    // GPU, otherwise we could end up waiting for it forever.
+    auto result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+
+    if (result == GL_TIMEOUT_EXPIRED)
+    {
+        constexpr GLuint64 timeout_ns = 1'000'000;
+
+        auto wait_start = std::chrono::steady_clock::now();
+        streaming.stats.fence_waits++;
+
+        do
+        {
+            result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeout_ns);
+        } while (result == GL_TIMEOUT_EXPIRED);
+
+        std::chrono::duration<double> wait_time = std::chrono::steady_clock::now() - wait_start;
+        streaming.stats.fence_wait_time += wait_time.count();
+    }
+
+    ZTH_ASSERT(result != GL_WAIT_FAILED);
+
+    glDeleteSync(fence);
+    fence = nullptr;
+}
+
+auto Buffer::free_streaming_state() noexcept -> void
+{
+    if (!_streaming_state)
+        return;
+
+    for (auto& fence : _streaming_state->region_fences)
+    {
+        if (fence)
+            glDeleteSync(fence);
+
+        fence = nullptr;
+    }
+
+    // Deleting the buffer unmaps it implicitly.
+    _streaming_state.free();
+}
+
 auto Buffer::reallocate_exactly(u32 new_capacity_bytes) -> void
 {
     ZTH_ASSERT(_state == BufferState::InitializedDynamic);
@@ -353,6 +576,14 @@ auto VertexBuffer::create_dynamic_with_data(std::span<const byte> data, const Ve
     return buffer;
 }
 
+auto VertexBuffer::create_streaming(u32 region_size_bytes, const VertexLayout& layout, u32 region_count)
+    -> VertexBuffer
+{
+    VertexBuffer buffer;
+    buffer.init_streaming(region_size_bytes, layout, region_count);
+    return buffer;
+}
+
 auto VertexBuffer::init_static_with_size(u32 size_bytes, const VertexLayout& layout) -> void
 {
     _buffer.init_static_with_size(size_bytes);
@@ -384,6 +615,12 @@ auto VertexBuffer::init_dynamic_with_data(std::span<const byte> data, const Vert
     _layout = layout;
 }
 
+auto VertexBuffer::init_streaming(u32 region_size_bytes, const VertexLayout& layout, u32 region_count) -> void
+{
+    _buffer.init_streaming(region_size_bytes, region_count);
+    _layout = layout;
+}
+
 auto VertexBuffer::buffer_data(std::span<const byte> data, u32 offset) -> u32
 {
     return _buffer.buffer_data(data, offset);
@@ -402,12 +639,12 @@ auto VertexBuffer::free() noexcept -> void
 
 auto VertexBuffer::bind() const -> void
 {
-    glBindBuffer(GL_ARRAY_BUFFER, native_handle());
+    StateCache::bind_buffer(GL_ARRAY_BUFFER, native_handle());
 }
 
 auto VertexBuffer::unbind() -> void
 {
-    glBindBuffer(GL_ARRAY_BUFFER, GL_NONE);
+    StateCache::bind_buffer(GL_ARRAY_BUFFER, GL_NONE);
 }
 
 auto VertexBuffer::set_layout(const VertexLayout& layout) -> void
@@ -522,12 +759,12 @@ auto IndexBuffer::free() noexcept -> void
 
 auto IndexBuffer::bind() const -> void
 {
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, native_handle());
+    StateCache::bind_buffer(GL_ELEMENT_ARRAY_BUFFER, native_handle());
 }
 
 auto IndexBuffer::unbind() -> void
 {
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, GL_NONE);
+    StateCache::bind_buffer(GL_ELEMENT_ARRAY_BUFFER, GL_NONE);
 }
 
 auto IndexBuffer::set_indexing_data_type(DataType type) -> void
@@ -580,6 +817,14 @@ auto InstanceBuffer::create_dynamic_with_data(std::span<const byte> data, const
     return buffer;
 }
 
+auto InstanceBuffer::create_streaming(u32 region_size_bytes, const VertexLayout& layout, u32 region_count)
+    -> InstanceBuffer
+{
+    InstanceBuffer buffer;
+    buffer.init_streaming(region_size_bytes, layout, region_count);
+    return buffer;
+}
+
 // --------------------------- UniformBuffer ---------------------------
 
 auto UniformBuffer::create_static_with_size(u32 size_bytes) -> UniformBuffer
@@ -644,17 +889,17 @@ auto UniformBuffer::free() noexcept -> void
 
 auto UniformBuffer::bind() const -> void
 {
-    glBindBuffer(GL_UNIFORM_BUFFER, native_handle());
+    StateCache::bind_buffer(GL_UNIFORM_BUFFER, native_handle());
 }
 
 auto UniformBuffer::bind(u32 binding_point) const -> void
 {
-    glBindBufferBase(GL_UNIFORM_BUFFER, binding_point, native_handle());
+    StateCache::bind_buffer_base(GL_UNIFORM_BUFFER, binding_point, native_handle());
 }
 
 auto UniformBuffer::unbind() -> void
 {
-    glBindBuffer(GL_UNIFORM_BUFFER, GL_NONE);
+    StateCache::bind_buffer(GL_UNIFORM_BUFFER, GL_NONE);
 }
 
 // --------------------------- ShaderStorageBuffer ---------------------------
@@ -799,17 +1044,25 @@ auto ShaderStorageBuffer::free() noexcept -> void
 
 auto ShaderStorageBuffer::bind() const -> void
 {
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, native_handle());
+    StateCache::bind_buffer(GL_SHADER_STORAGE_BUFFER, native_handle());
 }
 
 auto ShaderStorageBuffer::bind(u32 binding_point) const -> void
 {
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding_point, native_handle());
+    StateCache::bind_buffer_base(GL_SHADER_STORAGE_BUFFER, binding_point, native_handle());
+}
+
+auto ShaderStorageBuffer::bind_range(u32 binding_point, u32 offset, u32 size_bytes) const -> void
+{
+    ZTH_ASSERT(offset % Context::ssbo_offset_alignment() == 0);
+    ZTH_ASSERT(offset + size_bytes <= this->size_bytes());
+
+    StateCache::bind_buffer_range(GL_SHADER_STORAGE_BUFFER, binding_point, native_handle(), offset, size_bytes);
 }
 
 auto ShaderStorageBuffer::unbind() -> void
 {
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, GL_NONE);
+    StateCache::bind_buffer(GL_SHADER_STORAGE_BUFFER, GL_NONE);
 }
 
 auto to_gl_enum(BufferUsage buffer_usage) -> GLenum
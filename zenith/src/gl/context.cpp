@@ -2,7 +2,9 @@
 
 #include <glad/glad.h>
 
+#include "zenith/gl/state_cache.hpp"
 #include "zenith/log/logger.hpp"
+#include "zenith/system/window.hpp"
 #include "zenith/util/macros.hpp"
 
 namespace zth::gl {
@@ -60,6 +62,7 @@ auto Context::init() -> Result<void, String>
     ZTH_INTERNAL_TRACE("Initializing OpenGL context...");
 
     retrieve_context_variables();
+    set_up_parallel_shader_compile();
 
 #if defined(ZTH_GL_DEBUG)
     set_debug_context();
@@ -67,6 +70,8 @@ auto Context::init() -> Result<void, String>
 
     log_context_info();
 
+    StateCache::init();
+
     ZTH_INTERNAL_TRACE("OpenGL context initialized.");
     return {};
 }
@@ -93,6 +98,22 @@ auto Context::set_debug_context() -> void
     _debug_context = true;
 }
 
+auto Context::extension_supported(StringView name) -> bool
+{
+    GLint extension_count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &extension_count);
+
+    for (GLint i = 0; i < extension_count; i++)
+    {
+        auto extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+
+        if (extension && name == extension)
+            return true;
+    }
+
+    return false;
+}
+
 auto Context::retrieve_context_variables() -> void
 {
     {
@@ -115,6 +136,45 @@ auto Context::retrieve_context_variables() -> void
         _forward_compatible_context = flags & GL_CONTEXT_FLAG_FORWARD_COMPATIBLE_BIT;
         _debug_context = flags & GL_CONTEXT_FLAG_DEBUG_BIT;
     }
+
+    {
+        GLint alignment;
+        glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+        _ssbo_offset_alignment = static_cast<u32>(alignment);
+    }
+
+    {
+        GLint format_count;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &format_count);
+        _program_binary_formats = static_cast<u32>(format_count);
+    }
+}
+
+auto Context::set_up_parallel_shader_compile() -> void
+{
+    // glad doesn't load these extensions, so their only function is loaded by hand. The KHR and ARB versions share the
+    // same enums and semantics.
+    using MaxShaderCompilerThreads = void(APIENTRYP)(GLuint count);
+
+    MaxShaderCompilerThreads max_shader_compiler_threads = nullptr;
+
+    if (extension_supported("GL_KHR_parallel_shader_compile"))
+    {
+        max_shader_compiler_threads =
+            reinterpret_cast<MaxShaderCompilerThreads>(Window::gl_proc_address("glMaxShaderCompilerThreadsKHR"));
+    }
+    else if (extension_supported("GL_ARB_parallel_shader_compile"))
+    {
+        max_shader_compiler_threads =
+            reinterpret_cast<MaxShaderCompilerThreads>(Window::gl_proc_address("glMaxShaderCompilerThreadsARB"));
+    }
+
+    if (!max_shader_compiler_threads)
+        return;
+
+    // 0xFFFFFFFF lets the driver use as many threads as it wants.
+    max_shader_compiler_threads(0xFFFFFFFF);
+    _parallel_shader_compile = true;
 }
 
 auto Context::log_context_info() -> void
@@ -123,8 +183,11 @@ auto Context::log_context_info() -> void
                       "\tVendor: {}\n"
                       "\tRenderer: {}\n"
                       "\tVersion: {}\n"
-                      "\tGLSL Version: {}",
-                      _vendor_string, _renderer_string, _version_string, _glsl_version_string);
+                      "\tGLSL Version: {}\n"
+                      "\tProgram binary formats: {}\n"
+                      "\tParallel shader compilation: {}",
+                      _vendor_string, _renderer_string, _version_string, _glsl_version_string, _program_binary_formats,
+                      _parallel_shader_compile);
 }
 
 } // namespace zth::gl
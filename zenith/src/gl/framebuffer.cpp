@@ -0,0 +1,113 @@
+#include "zenith/gl/framebuffer.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#include "zenith/core/assert.hpp"
+#include "zenith/gl/state_cache.hpp"
+#include "zenith/gl/texture.hpp"
+#include "zenith/log/logger.hpp"
+#include "zenith/stl/vector.hpp"
+
+namespace zth::gl {
+
+auto Framebuffer::create(std::span<const Texture2D* const> color_attachments, const Texture2D* depth_attachment)
+    -> Framebuffer
+{
+    return Framebuffer{ color_attachments, depth_attachment };
+}
+
+Framebuffer::Framebuffer(Framebuffer&& other) noexcept : _id{ std::exchange(other._id, GL_NONE) } {}
+
+auto Framebuffer::operator=(Framebuffer&& other) noexcept -> Framebuffer&
+{
+    destroy();
+    _id = std::exchange(other._id, GL_NONE);
+    return *this;
+}
+
+Framebuffer::~Framebuffer()
+{
+    destroy();
+}
+
+auto Framebuffer::bind() const -> void
+{
+    StateCache::bind_framebuffer(_id);
+}
+
+auto Framebuffer::bind_default() -> void
+{
+    StateCache::bind_framebuffer(GL_NONE);
+}
+
+auto Framebuffer::read_default_pixels(glm::uvec2 size) -> Vector<u8>
+{
+    auto row_size = static_cast<usize>(size.x) * 4;
+    Vector<u8> pixels(row_size * size.y);
+
+    bind_default();
+    glNamedFramebufferReadBuffer(GL_NONE, GL_BACK);
+    glReadnPixels(0, 0, static_cast<GLsizei>(size.x), static_cast<GLsizei>(size.y), GL_RGBA, GL_UNSIGNED_BYTE,
+                  static_cast<GLsizei>(pixels.size()), pixels.data());
+
+    // OpenGL returns the bottom row first.
+    for (usize row = 0; row < size.y / 2; row++)
+    {
+        auto top = pixels.begin() + static_cast<std::ptrdiff_t>(row * row_size);
+        auto bottom = pixels.begin() + static_cast<std::ptrdiff_t>((size.y - 1 - row) * row_size);
+        std::swap_ranges(top, top + static_cast<std::ptrdiff_t>(row_size), bottom);
+    }
+
+    return pixels;
+}
+
+auto Framebuffer::clear_color(u32 attachment, glm::vec4 color) const -> void
+{
+    glClearNamedFramebufferfv(_id, GL_COLOR, static_cast<GLint>(attachment), &color.x);
+}
+
+auto Framebuffer::clear_color(u32 attachment, glm::uvec4 value) const -> void
+{
+    glClearNamedFramebufferuiv(_id, GL_COLOR, static_cast<GLint>(attachment), &value.x);
+}
+
+auto Framebuffer::clear_depth(float depth) const -> void
+{
+    glClearNamedFramebufferfv(_id, GL_DEPTH, 0, &depth);
+}
+
+auto Framebuffer::complete() const -> bool
+{
+    return glCheckNamedFramebufferStatus(_id, GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+}
+
+Framebuffer::Framebuffer(std::span<const Texture2D* const> color_attachments, const Texture2D* depth_attachment)
+{
+    glCreateFramebuffers(1, &_id);
+
+    Vector<GLenum> draw_buffers;
+
+    for (u32 i = 0; i < color_attachments.size(); i++)
+    {
+        ZTH_ASSERT(color_attachments[i] != nullptr);
+        glNamedFramebufferTexture(_id, GL_COLOR_ATTACHMENT0 + i, color_attachments[i]->native_handle(), 0);
+        draw_buffers.push_back(GL_COLOR_ATTACHMENT0 + i);
+    }
+
+    glNamedFramebufferDrawBuffers(_id, static_cast<GLsizei>(draw_buffers.size()), draw_buffers.data());
+
+    if (depth_attachment)
+        glNamedFramebufferTexture(_id, GL_DEPTH_ATTACHMENT, depth_attachment->native_handle(), 0);
+
+    if (!complete())
+        ZTH_INTERNAL_ERROR("[Framebuffer] Framebuffer {} is incomplete.", _id);
+}
+
+auto Framebuffer::destroy() const noexcept -> void
+{
+    StateCache::forget_framebuffer(_id);
+    glDeleteFramebuffers(1, &_id);
+}
+
+} // namespace zth::gl
@@ -0,0 +1,246 @@
+#include "zenith/gl/gpu_timer.hpp"
+
+#include <utility>
+
+#include "zenith/core/assert.hpp"
+
+namespace zth::gl {
+
+GpuTimer::GpuTimer()
+{
+    for (auto& [start, end] : _queries)
+    {
+        glCreateQueries(GL_TIMESTAMP, 1, &start);
+        glCreateQueries(GL_TIMESTAMP, 1, &end);
+    }
+}
+
+GpuTimer::GpuTimer(GpuTimer&& other) noexcept
+    : _queries{ std::exchange(other._queries, {}) }, _next_query{ std::exchange(other._next_query, 0) },
+      _pending_queries{ std::exchange(other._pending_queries, 0) }, _running{ std::exchange(other._running, false) },
+      _last_elapsed_time{ std::exchange(other._last_elapsed_time, nil) }
+{}
+
+auto GpuTimer::operator=(GpuTimer&& other) noexcept -> GpuTimer&
+{
+    destroy();
+
+    _queries = std::exchange(other._queries, {});
+    _next_query = std::exchange(other._next_query, 0);
+    _pending_queries = std::exchange(other._pending_queries, 0);
+    _running = std::exchange(other._running, false);
+    _last_elapsed_time = std::exchange(other._last_elapsed_time, nil);
+
+    return *this;
+}
+
+GpuTimer::~GpuTimer()
+{
+    destroy();
+}
+
+auto GpuTimer::begin() -> void
+{
+    ZTH_ASSERT(!_running);
+
+    // Every query is still in flight, so the oldest one has to be read back before its objects can be reused.
+    if (_pending_queries == max_queries_in_flight)
+        collect_oldest(true);
+
+    glQueryCounter(_queries[_next_query].start, GL_TIMESTAMP);
+    _running = true;
+}
+
+auto GpuTimer::end() -> void
+{
+    ZTH_ASSERT(_running);
+
+    glQueryCounter(_queries[_next_query].end, GL_TIMESTAMP);
+
+    _next_query = (_next_query + 1) % max_queries_in_flight;
+    _pending_queries++;
+    _running = false;
+}
+
+auto GpuTimer::last_elapsed_time() -> Optional<double>
+{
+    while (_pending_queries > 0)
+    {
+        if (!collect_oldest(false))
+            break;
+    }
+
+    return _last_elapsed_time;
+}
+
+auto GpuTimer::collect_oldest(bool wait) -> bool
+{
+    ZTH_ASSERT(_pending_queries > 0);
+
+    auto oldest = (_next_query + max_queries_in_flight - _pending_queries) % max_queries_in_flight;
+    auto [start, end] = _queries[oldest];
+
+    if (!wait)
+    {
+        // The end query gets issued last, so the start query is available whenever the end query is.
+        GLint available = GL_FALSE;
+        glGetQueryObjectiv(end, GL_QUERY_RESULT_AVAILABLE, &available);
+
+        if (!available)
+            return false;
+    }
+
+    GLuint64 start_time = 0;
+    GLuint64 end_time = 0;
+    glGetQueryObjectui64v(start, GL_QUERY_RESULT, &start_time);
+    glGetQueryObjectui64v(end, GL_QUERY_RESULT, &end_time);
+
+    _last_elapsed_time = static_cast<double>(end_time - start_time) / 1e9;
+    _pending_queries--;
+
+    return true;
+}
+
+auto GpuTimer::destroy() const noexcept -> void
+{
+    for (const auto& [start, end] : _queries)
+    {
+        glDeleteQueries(1, &start);
+        glDeleteQueries(1, &end);
+    }
+}
+
+SampleCounter::SampleCounter()
+{
+    glCreateQueries(GL_SAMPLES_PASSED, static_cast<GLsizei>(_queries.size()), _queries.data());
+}
+
+SampleCounter::SampleCounter(SampleCounter&& other) noexcept
+    : _queries{ std::exchange(other._queries, {}) }, _next_query{ std::exchange(other._next_query, 0) },
+      _pending_queries{ std::exchange(other._pending_queries, 0) }, _running{ std::exchange(other._running, false) },
+      _last_sample_count{ std::exchange(other._last_sample_count, nil) }
+{}
+
+auto SampleCounter::operator=(SampleCounter&& other) noexcept -> SampleCounter&
+{
+    destroy();
+
+    _queries = std::exchange(other._queries, {});
+    _next_query = std::exchange(other._next_query, 0);
+    _pending_queries = std::exchange(other._pending_queries, 0);
+    _running = std::exchange(other._running, false);
+    _last_sample_count = std::exchange(other._last_sample_count, nil);
+
+    return *this;
+}
+
+SampleCounter::~SampleCounter()
+{
+    destroy();
+}
+
+auto SampleCounter::begin() -> void
+{
+    ZTH_ASSERT(!_running);
+
+    // Every query is still in flight, so the oldest one has to be read back before it can be reused.
+    if (_pending_queries == max_queries_in_flight)
+        collect_oldest(true);
+
+    glBeginQuery(GL_SAMPLES_PASSED, _queries[_next_query]);
+    _running = true;
+}
+
+auto SampleCounter::end() -> void
+{
+    ZTH_ASSERT(_running);
+
+    glEndQuery(GL_SAMPLES_PASSED);
+
+    _next_query = (_next_query + 1) % max_queries_in_flight;
+    _pending_queries++;
+    _running = false;
+}
+
+auto SampleCounter::last_sample_count() -> Optional<u64>
+{
+    while (_pending_queries > 0)
+    {
+        if (!collect_oldest(false))
+            break;
+    }
+
+    return _last_sample_count;
+}
+
+auto SampleCounter::collect_oldest(bool wait) -> bool
+{
+    ZTH_ASSERT(_pending_queries > 0);
+
+    auto oldest = _queries[(_next_query + max_queries_in_flight - _pending_queries) % max_queries_in_flight];
+
+    if (!wait)
+    {
+        GLint available = GL_FALSE;
+        glGetQueryObjectiv(oldest, GL_QUERY_RESULT_AVAILABLE, &available);
+
+        if (!available)
+            return false;
+    }
+
+    GLuint64 sample_count = 0;
+    glGetQueryObjectui64v(oldest, GL_QUERY_RESULT, &sample_count);
+
+    _last_sample_count = sample_count;
+    _pending_queries--;
+
+    return true;
+}
+
+auto SampleCounter::destroy() const noexcept -> void
+{
+    glDeleteQueries(static_cast<GLsizei>(_queries.size()), _queries.data());
+}
+
+TimestampQueryPool::~TimestampQueryPool()
+{
+    glDeleteQueries(static_cast<GLsizei>(_queries.size()), _queries.data());
+}
+
+auto TimestampQueryPool::record_timestamp() -> GLuint
+{
+    if (_free_queries.empty())
+    {
+        GLuint query = GL_NONE;
+        glCreateQueries(GL_TIMESTAMP, 1, &query);
+        _queries.push_back(query);
+        _free_queries.push_back(query);
+    }
+
+    auto query = _free_queries.back();
+    _free_queries.pop_back();
+
+    glQueryCounter(query, GL_TIMESTAMP);
+    return query;
+}
+
+auto TimestampQueryPool::release(GLuint query) -> void
+{
+    _free_queries.push_back(query);
+}
+
+auto TimestampQueryPool::result_available(GLuint query) -> bool
+{
+    GLint available = GL_FALSE;
+    glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+    return available == GL_TRUE;
+}
+
+auto TimestampQueryPool::result(GLuint query) -> u64
+{
+    GLuint64 time = 0;
+    glGetQueryObjectui64v(query, GL_QUERY_RESULT, &time);
+    return time;
+}
+
+} // namespace zth::gl
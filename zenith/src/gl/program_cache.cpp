@@ -0,0 +1,216 @@
+#include "zenith/gl/program_cache.hpp"
+
+#include <cstring>
+#include <system_error>
+#include <type_traits>
+
+#include "zenith/gl/context.hpp"
+#include "zenith/log/logger.hpp"
+#include "zenith/system/file.hpp"
+#include "zenith/system/temporary_storage.hpp"
+#include "zenith/util/defer.hpp"
+
+namespace zth::gl {
+
+namespace {
+
+constexpr u32 entry_magic = 0x5a505243; // "ZPRC"
+constexpr u32 entry_version = 1;
+
+struct EntryHeader
+{
+    u32 magic;
+    u32 version;
+    u64 key;
+    u32 format;
+    u32 binary_size;
+    u64 checksum; // Of the binary.
+};
+
+static_assert(std::is_trivially_copyable_v<EntryHeader>);
+
+constexpr u64 fnv_offset_basis = 14695981039346656037ull;
+constexpr u64 fnv_prime = 1099511628211ull;
+
+[[nodiscard]] auto fnv1a(u64 hash, std::span<const byte> data) -> u64
+{
+    for (auto b : data)
+    {
+        hash ^= static_cast<u64>(b);
+        hash *= fnv_prime;
+    }
+
+    return hash;
+}
+
+template<typename T> [[nodiscard]] auto fnv1a(u64 hash, const T& value) -> u64
+{
+    return fnv1a(hash, std::as_bytes(std::span{ &value, 1 }));
+}
+
+[[nodiscard]] auto fnv1a(u64 hash, StringView string) -> u64
+{
+    hash = fnv1a(hash, static_cast<u64>(string.size()));
+    return fnv1a(hash, std::as_bytes(std::span{ string }));
+}
+
+} // namespace
+
+auto program_cache_key(std::span<const ProgramStage> stages, StringView driver) -> u64
+{
+    auto hash = fnv1a(fnv_offset_basis, entry_version);
+
+    for (auto& stage : stages)
+    {
+        hash = fnv1a(hash, stage.type);
+        hash = fnv1a(hash, stage.source);
+    }
+
+    return fnv1a(hash, driver);
+}
+
+auto encode_program_binary(u64 key, ProgramBinary binary) -> Vector<byte>
+{
+    const EntryHeader header = {
+        .magic = entry_magic,
+        .version = entry_version,
+        .key = key,
+        .format = binary.format,
+        .binary_size = static_cast<u32>(binary.binary.size()),
+        .checksum = fnv1a(fnv_offset_basis, binary.binary),
+    };
+
+    Vector<byte> entry(sizeof(EntryHeader) + binary.binary.size());
+    std::memcpy(entry.data(), &header, sizeof(EntryHeader));
+
+    if (!binary.binary.empty())
+        std::memcpy(entry.data() + sizeof(EntryHeader), binary.binary.data(), binary.binary.size());
+
+    return entry;
+}
+
+auto decode_program_binary(std::span<const byte> entry, u64 key) -> Optional<ProgramBinary>
+{
+    if (entry.size() < sizeof(EntryHeader))
+        return nil;
+
+    EntryHeader header;
+    std::memcpy(&header, entry.data(), sizeof(EntryHeader));
+
+    if (header.magic != entry_magic || header.version != entry_version || header.key != key)
+        return nil;
+
+    auto binary = entry.subspan(sizeof(EntryHeader));
+
+    if (binary.size() != header.binary_size || fnv1a(fnv_offset_basis, binary) != header.checksum)
+        return nil;
+
+    return ProgramBinary{ .format = header.format, .binary = binary };
+}
+
+auto ProgramCache::set_directory(const Optional<std::filesystem::path>& directory) -> void
+{
+    _directory = directory;
+}
+
+auto ProgramCache::enabled() -> bool
+{
+    return _directory.has_value() && Context::program_binary_formats() > 0;
+}
+
+auto ProgramCache::key(std::span<const ProgramStage> stages) -> u64
+{
+    auto driver = format_to_temporary("{}\n{}\n{}", Context::vendor_string(), Context::renderer_string(),
+                                      Context::version_string());
+    return program_cache_key(stages, driver);
+}
+
+auto ProgramCache::load(u64 key) -> Optional<GLuint>
+{
+    if (!enabled())
+        return nil;
+
+    auto path = entry_path(key);
+    std::error_code error_code;
+
+    if (!std::filesystem::exists(path, error_code))
+    {
+        _stats.misses++;
+        return nil;
+    }
+
+    Defer reject{ [&] {
+        _stats.misses++;
+        _stats.rejected++;
+        std::filesystem::remove(path, error_code);
+    } };
+
+    auto entry = fs::read_to<TemporaryVector<byte>>(path);
+
+    if (!entry)
+        return nil;
+
+    auto binary = decode_program_binary(*entry, key);
+
+    if (!binary)
+    {
+        ZTH_INTERNAL_WARN("[Program Cache] Discarding corrupted cache entry {:016x}.", key);
+        return nil;
+    }
+
+    auto program = glCreateProgram();
+    glProgramBinary(program, binary->format, binary->binary.data(), static_cast<GLsizei>(binary->binary.size()));
+
+    GLint is_linked = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &is_linked);
+
+    if (is_linked == GL_FALSE)
+    {
+        // Drivers are allowed to reject binaries for any reason, e.g. after an update which didn't change the version
+        // string, so this isn't an error.
+        ZTH_INTERNAL_INFO("[Program Cache] Driver rejected cached program {:016x}. Recompiling it.", key);
+        glDeleteProgram(program);
+        return nil;
+    }
+
+    reject.dismiss();
+    _stats.hits++;
+    return program;
+}
+
+auto ProgramCache::store(u64 key, GLuint program) -> void
+{
+    if (!enabled())
+        return;
+
+    GLint binary_length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &binary_length);
+
+    if (binary_length <= 0)
+        return;
+
+    auto binary = make_temporary_for_overwrite<byte[]>(static_cast<usize>(binary_length));
+    GLsizei written_length = 0;
+    GLenum format = GL_NONE;
+    glGetProgramBinary(program, binary_length, &written_length, &format, binary.get());
+
+    if (written_length <= 0)
+        return;
+
+    const ProgramBinary program_binary = {
+        .format = format,
+        .binary = std::span{ binary.get(), static_cast<usize>(written_length) },
+    };
+
+    auto entry = encode_program_binary(key, program_binary);
+
+    if (fs::write_to(entry_path(key), entry))
+        _stats.stored++;
+}
+
+auto ProgramCache::entry_path(u64 key) -> std::filesystem::path
+{
+    return *_directory / format_to_temporary("{:016x}.bin", key);
+}
+
+} // namespace zth::gl
@@ -3,39 +3,34 @@
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtx/structured_bindings.hpp>
 
+#include <algorithm>
+#include <array>
+
 #include "zenith/core/assert.hpp"
 #include "zenith/embedded/shaders.hpp"
+#include "zenith/gl/context.hpp"
+#include "zenith/gl/program_cache.hpp"
+#include "zenith/gl/state_cache.hpp"
 #include "zenith/renderer/shader_preprocessor.hpp"
 #include "zenith/system/file.hpp"
 #include "zenith/system/temporary_storage.hpp"
 #include "zenith/util/defer.hpp"
 
+// Comes from GL_KHR_parallel_shader_compile, which glad doesn't know about.
+#if !defined(GL_COMPLETION_STATUS_KHR)
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
 namespace zth::gl {
 
 // @test: All shader types (tess control, tess evaluation, geometry) and loading them from files.
 
-Shader::Shader(const ShaderSources& sources)
-{
-    auto program = create_program_from_sources(sources);
-
-    if (!program)
-    {
-        ZTH_INTERNAL_WARN("[Shader] Shader compilation failed. Switching to fallback shader.");
-
-        program = create_fallback_program();
-
-        if (!program)
-            return;
-    }
+Shader::Shader(const ShaderSources& sources) : Shader{ create_program_from_sources(sources) } {}
 
-    _id = *program;
-    retrieve_unif_info();
-}
+Shader::Shader(const ShaderSourcePaths& paths) : Shader{ create_program_from_files(paths) } {}
 
-Shader::Shader(const ShaderSourcePaths& paths)
+Shader::Shader(Optional<ProgramId> program)
 {
-    auto program = create_program_from_files(paths);
-
     if (!program)
     {
         ZTH_INTERNAL_WARN("[Shader] Shader compilation failed. Switching to fallback shader.");
@@ -55,6 +50,19 @@ auto Shader::from_sources(const ShaderSources& sources) -> Shader
     return Shader{ sources };
 }
 
+auto Shader::from_sources(std::span<const ShaderSources> sources) -> Vector<Shader>
+{
+    auto programs = create_programs(sources);
+
+    Vector<Shader> shaders;
+    shaders.reserve(programs.size());
+
+    for (auto program : programs)
+        shaders.push_back(Shader{ program });
+
+    return shaders;
+}
+
 auto Shader::from_files(const ShaderSourcePaths& paths) -> Shader
 {
     return Shader{ paths };
@@ -73,9 +81,20 @@ auto Shader::operator=(Shader&& other) noexcept -> Shader&
 
 Shader::~Shader()
 {
+    StateCache::forget_program(_id);
     glDeleteProgram(_id);
 }
 
+auto Shader::bind() const -> void
+{
+    StateCache::use_program(_id);
+}
+
+auto Shader::unbind() -> void
+{
+    StateCache::use_program(GL_NONE);
+}
+
 auto Shader::retrieve_unif_info() -> void
 {
     GLint uniform_count = 0;
@@ -158,92 +177,91 @@ auto Shader::set_unif(GLint location, const glm::mat4& val) -> void
     glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(val));
 }
 
-auto Shader::create_shaders_from_sources(const ShaderSources& sources) -> Optional<InPlaceVector<ShaderId, 5>>
+auto Shader::preprocess_stages(const ShaderSources& sources) -> Optional<InPlaceVector<PreprocessedStage, 5>>
 {
-    InPlaceVector<ShaderId, 5> shaders;
-    Defer shaders_cleanup{ [&] { delete_shaders(shaders); } };
+    InPlaceVector<PreprocessedStage, 5> stages;
 
-    auto add_shader = [&](StringView source, ShaderType type) {
-        auto shader = create_shader(source, type);
+    auto add_stage = [&](StringView source, ShaderType type) {
+        auto preprocessed_source = ShaderPreprocessor::preprocess(source);
 
-        if (!shader)
+        if (!preprocessed_source)
+        {
+            ZTH_INTERNAL_ERROR("[Shader] Failed to preprocess {} shader source: {}", type,
+                               preprocessed_source.error());
+            ZTH_DEBUG_BREAK;
             return false;
+        }
 
-        shaders.push_back(*shader);
+        stages.emplace_back(PreprocessedStage{ .type = type, .source = std::move(*preprocessed_source) });
         return true;
     };
 
-    if (!add_shader(sources.vertex_source, ShaderType::Vertex))
+    if (!add_stage(sources.vertex_source, ShaderType::Vertex))
         return nil;
 
-    if (!add_shader(sources.fragment_source, ShaderType::Fragment))
+    if (!add_stage(sources.fragment_source, ShaderType::Fragment))
         return nil;
 
     if (sources.tess_control_source)
     {
-        if (!add_shader(*sources.tess_control_source, ShaderType::TessControl))
+        if (!add_stage(*sources.tess_control_source, ShaderType::TessControl))
             return nil;
     }
 
     if (sources.tess_evaluation_source)
     {
-        if (!add_shader(*sources.tess_evaluation_source, ShaderType::TessEvaluation))
+        if (!add_stage(*sources.tess_evaluation_source, ShaderType::TessEvaluation))
             return nil;
     }
 
     if (sources.geometry_source)
     {
-        if (!add_shader(*sources.geometry_source, ShaderType::Geometry))
+        if (!add_stage(*sources.geometry_source, ShaderType::Geometry))
             return nil;
     }
 
-    shaders_cleanup.dismiss();
-    return shaders;
+    return stages;
 }
 
-auto Shader::create_shader(const StringView source, ShaderType type) -> Optional<ShaderId>
+auto Shader::check_compile_status(ShaderId id, ShaderType type) -> bool
 {
-    auto preprocessed_source = ShaderPreprocessor::preprocess(source);
+    GLint is_compiled = 0;
+    glGetShaderiv(id, GL_COMPILE_STATUS, &is_compiled);
 
-    if (!preprocessed_source)
+    if (is_compiled == GL_FALSE)
     {
-        ZTH_INTERNAL_ERROR("[Shader] Failed to preprocess shader source: {}", preprocessed_source.error());
-        ZTH_DEBUG_BREAK;
-        return nil;
-    }
+        GLint info_log_length = 0;
+        glGetShaderiv(id, GL_INFO_LOG_LENGTH, &info_log_length);
 
-    auto shader = glCreateShader(to_gl_enum(type));
-    Defer delete_shader{ [&] { glDeleteShader(shader); } };
+        auto info_log = make_temporary_for_overwrite<GLchar[]>(info_log_length);
 
-    const std::array sources = { preprocessed_source->data() };
-    const std::array sources_lengths = { static_cast<GLint>(preprocessed_source->size()) };
-    glShaderSource(shader, static_cast<GLsizei>(sources.size()), sources.data(), sources_lengths.data());
+        // glGetShaderInfoLog returns a null-terminated string.
+        glGetShaderInfoLog(id, info_log_length, &info_log_length, info_log.get());
 
-    if (!compile_shader(shader, type))
-        return nil;
+        ZTH_INTERNAL_ERROR("[Shader] Failed to compile {} shader: {}", type, info_log.get());
+        ZTH_DEBUG_BREAK;
+        return false;
+    }
 
-    delete_shader.dismiss();
-    return shader;
+    return true;
 }
 
-auto Shader::compile_shader(ShaderId id, ShaderType type) -> bool
+auto Shader::check_link_status(ProgramId id) -> bool
 {
-    glCompileShader(id);
-
-    GLint is_compiled = 0;
-    glGetShaderiv(id, GL_COMPILE_STATUS, &is_compiled);
+    GLint is_linked = 0;
+    glGetProgramiv(id, GL_LINK_STATUS, &is_linked);
 
-    if (is_compiled == GL_FALSE)
+    if (is_linked == GL_FALSE)
     {
         GLint info_log_length = 0;
-        glGetShaderiv(id, GL_INFO_LOG_LENGTH, &info_log_length);
+        glGetProgramiv(id, GL_INFO_LOG_LENGTH, &info_log_length);
 
         auto info_log = make_temporary_for_overwrite<GLchar[]>(info_log_length);
 
-        // glGetShaderInfoLog returns a null-terminated string.
-        glGetShaderInfoLog(id, info_log_length, &info_log_length, info_log.get());
+        // glGetProgramInfoLog returns a null-terminated string.
+        glGetProgramInfoLog(id, info_log_length, &info_log_length, info_log.get());
 
-        ZTH_INTERNAL_ERROR("[Shader] Failed to compile {} shader: {}", type, info_log.get());
+        ZTH_INTERNAL_ERROR("[Shader] Failed to link shader: {}", info_log.get());
         ZTH_DEBUG_BREAK;
         return false;
     }
@@ -251,26 +269,155 @@ auto Shader::compile_shader(ShaderId id, ShaderType type) -> bool
     return true;
 }
 
-auto Shader::create_program_from_sources(const ShaderSources& sources) -> Optional<ProgramId>
+auto Shader::create_programs(std::span<const ShaderSources> sources) -> Vector<Optional<ProgramId>>
 {
-    auto shaders = create_shaders_from_sources(sources);
+    struct PendingProgram
+    {
+        usize index;
+        u64 cache_key;
+        InPlaceVector<PreprocessedStage, 5> stages;
+        InPlaceVector<ShaderId, 5> shaders{};
+        ProgramId program = GL_NONE;
+        bool finished = false;
+    };
 
-    if (!shaders)
-        return nil;
+    Vector<Optional<ProgramId>> programs(sources.size(), nil);
+    Vector<PendingProgram> pending;
+    pending.reserve(sources.size());
 
-    Defer shaders_cleanup{ [&] { delete_shaders(*shaders); } };
+    // Programs which fail to preprocess are left empty, and programs found in the cache need no more work.
+    for (usize i = 0; i < sources.size(); i++)
+    {
+        auto stages = preprocess_stages(sources[i]);
 
-    auto program = create_program(*shaders);
+        if (!stages)
+            continue;
 
-    if (!program)
-        return nil;
+        u64 cache_key = 0;
+
+        if (ProgramCache::enabled())
+        {
+            InPlaceVector<ProgramStage, 5> key_stages;
+
+            for (auto& stage : *stages)
+                key_stages.emplace_back(ProgramStage{ .type = stage.type, .source = stage.source });
+
+            cache_key = ProgramCache::key(key_stages);
+
+            if (auto program = ProgramCache::load(cache_key))
+            {
+                programs[i] = *program;
+                continue;
+            }
+        }
+
+        pending.push_back(PendingProgram{ .index = i, .cache_key = cache_key, .stages = std::move(*stages) });
+    }
+
+    // Kick off every compilation and link before asking for the result of any of them. Querying a status blocks until
+    // the driver is done with that object, so checking each shader right after compiling it would serialize all the
+    // work, even on drivers which compile on their own threads.
+    for (auto& pending_program : pending)
+    {
+        for (auto& stage : pending_program.stages)
+        {
+            auto shader = glCreateShader(to_gl_enum(stage.type));
+
+            const std::array sources_strings = { stage.source.data() };
+            const std::array sources_lengths = { static_cast<GLint>(stage.source.size()) };
+            glShaderSource(shader, static_cast<GLsizei>(sources_strings.size()), sources_strings.data(),
+                           sources_lengths.data());
+            glCompileShader(shader);
+
+            pending_program.shaders.push_back(shader);
+        }
+
+        pending_program.program = glCreateProgram();
+
+        if (ProgramCache::enabled())
+            glProgramParameteri(pending_program.program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
+        for (auto shader : pending_program.shaders)
+            glAttachShader(pending_program.program, shader);
+
+        glLinkProgram(pending_program.program);
+    }
+
+    auto finish_program = [&](PendingProgram& pending_program) {
+        pending_program.finished = true;
+
+        auto program = pending_program.program;
+        auto& shaders = pending_program.shaders;
+        Defer shaders_cleanup{ [&] { delete_shaders(shaders); } };
+
+        // If a shader didn't compile, the link error doesn't say anything new.
+        bool success = true;
+
+        for (usize i = 0; i < shaders.size(); i++)
+            success = check_compile_status(shaders[i], pending_program.stages[i].type) && success;
+
+        success = success && check_link_status(program);
+
+        for (auto shader : shaders)
+            glDetachShader(program, shader);
+
+        if (!success)
+        {
+            glDeleteProgram(program);
+            return;
+        }
 
 #if defined(ZTH_GL_DEBUG)
-    // If we don't delete the shaders we can look at their source code when using API debugging tools.
-    shaders_cleanup.dismiss();
+        // If we don't delete the shaders we can look at their source code when using API debugging tools.
+        shaders_cleanup.dismiss();
 #endif
 
-    return program;
+        ProgramCache::store(pending_program.cache_key, program);
+        programs[pending_program.index] = program;
+    };
+
+    // With GL_KHR_parallel_shader_compile, programs are picked up in the order in which the driver finishes them. When
+    // none of the remaining ones are done yet, we block on the first one, as there's nothing else left to do anyway.
+    auto remaining = pending.size();
+
+    while (remaining > 0)
+    {
+        bool block = true;
+
+        for (auto& pending_program : pending)
+        {
+            if (pending_program.finished)
+                continue;
+
+            if (Context::parallel_shader_compile())
+            {
+                GLint is_completed = GL_FALSE;
+                glGetProgramiv(pending_program.program, GL_COMPLETION_STATUS_KHR, &is_completed);
+
+                if (is_completed == GL_FALSE)
+                    continue;
+            }
+
+            finish_program(pending_program);
+            remaining--;
+            block = false;
+        }
+
+        if (block)
+        {
+            auto first_unfinished =
+                std::ranges::find_if(pending, [](auto& pending_program) { return !pending_program.finished; });
+            finish_program(*first_unfinished);
+            remaining--;
+        }
+    }
+
+    return programs;
+}
+
+auto Shader::create_program_from_sources(const ShaderSources& sources) -> Optional<ProgramId>
+{
+    return create_programs(std::span{ &sources, 1 }).front();
 }
 
 auto Shader::create_program_from_files(const ShaderSourcePaths& paths) -> Optional<ProgramId>
@@ -352,55 +499,6 @@ auto Shader::create_program_from_files(const ShaderSourcePaths& paths) -> Option
     return create_program_from_sources(sources);
 }
 
-auto Shader::create_program(const InPlaceVector<ShaderId, 5>& shaders) -> Optional<ProgramId>
-{
-    auto program = glCreateProgram();
-    Defer delete_program{ [&] { glDeleteProgram(program); } };
-
-    for (auto shader : shaders)
-        glAttachShader(program, shader);
-
-    auto success = link_program(program);
-
-    for (auto shader : shaders)
-        glDetachShader(program, shader);
-
-    if (success)
-    {
-        delete_program.dismiss();
-        return program;
-    }
-    else
-    {
-        return nil;
-    }
-}
-
-auto Shader::link_program(ProgramId id) -> bool
-{
-    glLinkProgram(id);
-
-    GLint is_linked = 0;
-    glGetProgramiv(id, GL_LINK_STATUS, &is_linked);
-
-    if (is_linked == GL_FALSE)
-    {
-        GLint info_log_length = 0;
-        glGetProgramiv(id, GL_INFO_LOG_LENGTH, &info_log_length);
-
-        auto info_log = make_temporary_for_overwrite<GLchar[]>(info_log_length);
-
-        // glGetProgramInfoLog returns a null-terminated string.
-        glGetProgramInfoLog(id, info_log_length, &info_log_length, info_log.get());
-
-        ZTH_INTERNAL_ERROR("[Shader] Failed to link shader: {}", info_log.get());
-        ZTH_DEBUG_BREAK;
-        return false;
-    }
-
-    return true;
-}
-
 auto Shader::delete_shaders(const InPlaceVector<ShaderId, 5>& shaders) -> void
 {
     for (auto shader : shaders)
@@ -0,0 +1,276 @@
+#include "zenith/gl/state_cache.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#include "zenith/core/assert.hpp"
+
+namespace zth::gl {
+
+namespace {
+
+// Returns true if the cached value changed.
+template<typename T, typename U> auto update_cached(T& cached, const U& value) -> bool
+{
+    if (cached == value)
+        return false;
+
+    cached = value;
+    return true;
+}
+
+auto buffer_target_index(GLenum target) -> Optional<usize>
+{
+    switch (target)
+    {
+    case GL_ARRAY_BUFFER:
+        return 0;
+    case GL_UNIFORM_BUFFER:
+        return 1;
+    case GL_SHADER_STORAGE_BUFFER:
+        return 2;
+    case GL_DRAW_INDIRECT_BUFFER:
+        return 3;
+    default:
+        return nil;
+    }
+}
+
+} // namespace
+
+auto StateCache::init() -> void
+{
+    invalidate();
+    _stats_this_frame = {};
+    _stats_last_frame = {};
+}
+
+auto StateCache::start_frame() -> void
+{
+    _stats_last_frame = _stats_this_frame;
+    _stats_this_frame = {};
+}
+
+auto StateCache::invalidate() -> void
+{
+    _program = unknown;
+    _vertex_array = unknown;
+    _framebuffer = unknown;
+    _texture_units.fill(unknown);
+    _buffers.fill(unknown);
+    _uniform_buffer_bindings.fill(unknown_binding);
+    _shader_storage_buffer_bindings.fill(unknown_binding);
+
+    _capabilities.fill(nil);
+    _blend_func = nil;
+    _cull_face = nil;
+    _front_face = nil;
+    _polygon_mode = nil;
+    _depth_func = nil;
+    _depth_mask = nil;
+    _color_mask = nil;
+}
+
+auto StateCache::use_program(GLuint program) -> void
+{
+    if (record_call(!update_cached(_program, program)))
+    {
+        glUseProgram(program);
+        _stats_this_frame.program_binds++;
+    }
+}
+
+auto StateCache::bind_vertex_array(GLuint vertex_array) -> void
+{
+    if (record_call(!update_cached(_vertex_array, vertex_array)))
+    {
+        glBindVertexArray(vertex_array);
+        _stats_this_frame.vertex_array_binds++;
+    }
+}
+
+auto StateCache::bind_framebuffer(GLuint framebuffer) -> void
+{
+    if (record_call(!update_cached(_framebuffer, framebuffer)))
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+}
+
+auto StateCache::bind_texture_unit(u32 unit, GLuint texture) -> void
+{
+    auto redundant = unit < max_texture_units && !update_cached(_texture_units[unit], texture);
+
+    if (record_call(redundant))
+    {
+        glBindTextureUnit(unit, texture);
+        _stats_this_frame.texture_binds++;
+    }
+}
+
+auto StateCache::bind_buffer(GLenum target, GLuint buffer) -> void
+{
+    auto target_index = buffer_target_index(target);
+    auto redundant = target_index && !update_cached(_buffers[*target_index], buffer);
+
+    if (record_call(redundant))
+        glBindBuffer(target, buffer);
+}
+
+auto StateCache::bind_buffer_base(GLenum target, u32 index, GLuint buffer) -> void
+{
+    if (update_indexed_binding(target, index, IndexedBufferBinding{ .buffer = buffer, .offset = 0, .size = 0 }))
+        glBindBufferBase(target, index, buffer);
+}
+
+auto StateCache::bind_buffer_range(GLenum target, u32 index, GLuint buffer, GLintptr offset, GLsizeiptr size) -> void
+{
+    ZTH_ASSERT(size > 0);
+
+    if (update_indexed_binding(target, index, IndexedBufferBinding{ .buffer = buffer, .offset = offset, .size = size }))
+        glBindBufferRange(target, index, buffer, offset, size);
+}
+
+auto StateCache::set_enabled(Capability capability, bool enabled) -> void
+{
+    auto& cached = _capabilities[static_cast<usize>(capability)];
+
+    if (!record_call(!update_cached(cached, enabled)))
+        return;
+
+    if (enabled)
+        glEnable(to_gl_enum(capability));
+    else
+        glDisable(to_gl_enum(capability));
+}
+
+auto StateCache::set_blend_func(GLenum source_factor, GLenum destination_factor) -> void
+{
+    if (record_call(!update_cached(_blend_func, std::array{ source_factor, destination_factor })))
+        glBlendFunc(source_factor, destination_factor);
+}
+
+auto StateCache::set_cull_face(GLenum face) -> void
+{
+    if (record_call(!update_cached(_cull_face, face)))
+        glCullFace(face);
+}
+
+auto StateCache::set_front_face(GLenum mode) -> void
+{
+    if (record_call(!update_cached(_front_face, mode)))
+        glFrontFace(mode);
+}
+
+auto StateCache::set_polygon_mode(GLenum mode) -> void
+{
+    if (record_call(!update_cached(_polygon_mode, mode)))
+        glPolygonMode(GL_FRONT_AND_BACK, mode);
+}
+
+auto StateCache::set_depth_func(GLenum func) -> void
+{
+    if (record_call(!update_cached(_depth_func, func)))
+        glDepthFunc(func);
+}
+
+auto StateCache::set_depth_mask(bool enabled) -> void
+{
+    if (record_call(!update_cached(_depth_mask, enabled)))
+        glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+}
+
+auto StateCache::set_color_mask(bool enabled) -> void
+{
+    auto mask = enabled ? GL_TRUE : GL_FALSE;
+
+    if (record_call(!update_cached(_color_mask, enabled)))
+        glColorMask(mask, mask, mask, mask);
+}
+
+auto StateCache::forget_program(GLuint program) -> void
+{
+    if (_program == program)
+        _program = unknown;
+}
+
+auto StateCache::forget_vertex_array(GLuint vertex_array) -> void
+{
+    if (_vertex_array == vertex_array)
+        _vertex_array = unknown;
+}
+
+auto StateCache::forget_framebuffer(GLuint framebuffer) -> void
+{
+    // Deleting the bound framebuffer makes the default framebuffer bound.
+    if (_framebuffer == framebuffer)
+        _framebuffer = GL_NONE;
+}
+
+auto StateCache::forget_texture(GLuint texture) -> void
+{
+    std::ranges::replace(_texture_units, texture, unknown);
+}
+
+auto StateCache::forget_buffer(GLuint buffer) -> void
+{
+    std::ranges::replace(_buffers, buffer, unknown);
+
+    for (auto* bindings : { &_uniform_buffer_bindings, &_shader_storage_buffer_bindings })
+    {
+        for (auto& binding : *bindings)
+        {
+            if (binding.buffer == buffer)
+                binding = unknown_binding;
+        }
+    }
+}
+
+auto StateCache::record_call(bool redundant) -> bool
+{
+    if (redundant)
+        _stats_this_frame.calls_elided++;
+    else
+        _stats_this_frame.calls_issued++;
+
+    return !redundant;
+}
+
+auto StateCache::update_indexed_binding(GLenum target, u32 index, const IndexedBufferBinding& binding) -> bool
+{
+    ZTH_ASSERT(target == GL_UNIFORM_BUFFER || target == GL_SHADER_STORAGE_BUFFER);
+
+    auto& bindings = target == GL_UNIFORM_BUFFER ? _uniform_buffer_bindings : _shader_storage_buffer_bindings;
+    auto redundant = index < max_indexed_buffer_bindings && !update_cached(bindings[index], binding);
+
+    if (!record_call(redundant))
+        return false;
+
+    if (auto target_index = buffer_target_index(target))
+        _buffers[*target_index] = binding.buffer;
+
+    return true;
+}
+
+auto to_gl_enum(Capability capability) -> GLenum
+{
+    switch (capability)
+    {
+        using enum Capability;
+    case Blend:
+        return GL_BLEND;
+    case DepthTest:
+        return GL_DEPTH_TEST;
+    case CullFace:
+        return GL_CULL_FACE;
+    case Multisample:
+        return GL_MULTISAMPLE;
+    case StencilTest:
+        return GL_STENCIL_TEST;
+    case ScissorTest:
+        return GL_SCISSOR_TEST;
+    }
+
+    ZTH_ASSERT(false);
+    std::unreachable();
+}
+
+} // namespace zth::gl
@@ -3,6 +3,7 @@
 #include <stb_image/stb_image.h>
 
 #include "zenith/core/assert.hpp"
+#include "zenith/gl/state_cache.hpp"
 #include "zenith/log/logger.hpp"
 #include "zenith/memory/buffer.hpp"
 #include "zenith/system/file.hpp"
@@ -78,6 +79,11 @@ auto Texture2D::from_file_data(std::span<const byte> file_data, const TexturePar
     return Texture2D{ FromFileDataTag{}, file_data, params };
 }
 
+auto Texture2D::with_size(u32 width, u32 height, const TextureParams& params) -> Texture2D
+{
+    return Texture2D{ WithSizeTag{}, width, height, params };
+}
+
 Texture2D::Texture2D(Texture2D&& other) noexcept : _id{ std::exchange(other._id, GL_NONE) } {}
 
 auto Texture2D::operator=(Texture2D&& other) noexcept -> Texture2D&
@@ -93,12 +99,12 @@ Texture2D::~Texture2D()
 
 auto Texture2D::bind(u32 slot) const -> void
 {
-    glBindTextureUnit(slot, _id);
+    StateCache::bind_texture_unit(slot, _id);
 }
 
 auto Texture2D::unbind(u32 slot) -> void
 {
-    glBindTextureUnit(slot, GL_NONE);
+    StateCache::bind_texture_unit(slot, GL_NONE);
 }
 
 Texture2D::Texture2D(FromRgbTag, std::span<const float> data, u32 width, u32 height, const TextureParams& params)
@@ -163,6 +169,18 @@ Texture2D::Texture2D(FromFileDataTag, std::span<const byte> file_data, const Tex
     create_from_file_data(file_data, params);
 }
 
+Texture2D::Texture2D(WithSizeTag, u32 width, u32 height, const TextureParams& params)
+{
+    create();
+    set_params(params);
+
+    // The texture only has one level, so mipmapped min filters have to be limited to it for the texture to be complete.
+    glTextureParameteri(_id, GL_TEXTURE_MAX_LEVEL, 0);
+
+    glTextureStorage2D(_id, 1, to_gl_enum(params.internal_format), static_cast<GLsizei>(width),
+                       static_cast<GLsizei>(height));
+}
+
 auto Texture2D::create() noexcept -> void
 {
     glCreateTextures(GL_TEXTURE_2D, 1, &_id);
@@ -170,6 +188,7 @@ auto Texture2D::create() noexcept -> void
 
 auto Texture2D::destroy() const noexcept -> void
 {
+    StateCache::forget_texture(_id);
     glDeleteTextures(1, &_id);
 }
 
@@ -209,11 +228,7 @@ auto Texture2D::create_from_pixels(std::span<const byte> pixels, DataType type,
 #endif
 
     create();
-
-    glTextureParameteri(_id, GL_TEXTURE_WRAP_S, to_gl_int(params.horizontal_wrap));
-    glTextureParameteri(_id, GL_TEXTURE_WRAP_T, to_gl_int(params.vertical_wrap));
-    glTextureParameteri(_id, GL_TEXTURE_MIN_FILTER, to_gl_int(params.min_filter));
-    glTextureParameteri(_id, GL_TEXTURE_MAG_FILTER, to_gl_int(params.mag_filter));
+    set_params(params);
 
     glTextureStorage2D(_id, 1, to_gl_enum(params.internal_format), static_cast<GLsizei>(width),
                        static_cast<GLsizei>(height));
@@ -222,6 +237,14 @@ auto Texture2D::create_from_pixels(std::span<const byte> pixels, DataType type,
     glGenerateTextureMipmap(_id);
 }
 
+auto Texture2D::set_params(const TextureParams& params) const noexcept -> void
+{
+    glTextureParameteri(_id, GL_TEXTURE_WRAP_S, to_gl_int(params.horizontal_wrap));
+    glTextureParameteri(_id, GL_TEXTURE_WRAP_T, to_gl_int(params.vertical_wrap));
+    glTextureParameteri(_id, GL_TEXTURE_MIN_FILTER, to_gl_int(params.min_filter));
+    glTextureParameteri(_id, GL_TEXTURE_MAG_FILTER, to_gl_int(params.mag_filter));
+}
+
 auto to_gl_int(TextureWrapMode wrap) -> GLint
 {
     switch (wrap)
@@ -277,6 +300,12 @@ auto to_gl_enum(SizedTextureFormat format) -> GLenum
         return GL_RGB8;
     case Rgba8:
         return GL_RGBA8;
+    case Rgba16f:
+        return GL_RGBA16F;
+    case R32ui:
+        return GL_R32UI;
+    case Depth32f:
+        return GL_DEPTH_COMPONENT32F;
     }
 
     ZTH_ASSERT(false);
@@ -340,4 +369,52 @@ auto channels_in_texture_format(TextureFormat format) -> u32
     return 0;
 }
 
+auto bytes_per_texel(SizedTextureFormat format) -> u32
+{
+    switch (format)
+    {
+        using enum SizedTextureFormat;
+    case R8:
+        return 1;
+    case Rg8:
+        return 2;
+    case Rgb8:
+        return 3;
+    case Rgba8:
+    case R32ui:
+    case Depth32f:
+        return 4;
+    case Rgba16f:
+        return 8;
+    }
+
+    ZTH_ASSERT(false);
+    std::unreachable();
+}
+
+auto texture_format_name(SizedTextureFormat format) -> const char*
+{
+    switch (format)
+    {
+        using enum SizedTextureFormat;
+    case R8:
+        return "R8";
+    case Rg8:
+        return "Rg8";
+    case Rgb8:
+        return "Rgb8";
+    case Rgba8:
+        return "Rgba8";
+    case Rgba16f:
+        return "Rgba16f";
+    case R32ui:
+        return "R32ui";
+    case Depth32f:
+        return "Depth32f";
+    }
+
+    ZTH_ASSERT(false);
+    std::unreachable();
+}
+
 } // namespace zth::gl
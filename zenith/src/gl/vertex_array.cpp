@@ -2,10 +2,27 @@
 
 #include "zenith/core/assert.hpp"
 #include "zenith/gl/buffer.hpp"
+#include "zenith/gl/state_cache.hpp"
 #include "zenith/gl/util.hpp"
 
 namespace zth::gl {
 
+namespace {
+
+auto set_attrib_format(GLuint vertex_array, GLuint index, u32 count, DataType type, bool normalized, GLuint offset)
+    -> void
+{
+    // Integer attributes would get converted to floats by glVertexArrayAttribFormat, unless they're normalized, in
+    // which case that's exactly what we want.
+    if (is_an_integer_data_type(type) && !normalized)
+        glVertexArrayAttribIFormat(vertex_array, index, static_cast<GLint>(count), to_gl_enum(type), offset);
+    else
+        glVertexArrayAttribFormat(vertex_array, index, static_cast<GLint>(count), to_gl_enum(type),
+                                  normalized ? GL_TRUE : GL_FALSE, offset);
+}
+
+} // namespace
+
 VertexArray::VertexArray()
 {
     create();
@@ -54,6 +71,7 @@ VertexArray::VertexArray(const VertexArray& other) : VertexArray()
 
     rebind_layout();
     _count_limit = other._count_limit;
+    _position_transform = other._position_transform;
 }
 
 auto VertexArray::operator=(const VertexArray& other) -> VertexArray&
@@ -80,12 +98,15 @@ auto VertexArray::operator=(const VertexArray& other) -> VertexArray&
 
     rebind_layout();
     _count_limit = other._count_limit;
+    _position_transform = other._position_transform;
 
     return *this;
 }
 
 VertexArray::VertexArray(VertexArray&& other) noexcept
-    : _id{ std::exchange(other._id, GL_NONE) }, _count_limit{ std::exchange(other._count_limit, nil) },
+    : _id{ std::exchange(other._id, GL_NONE) }, _generation{ std::exchange(other._generation, next_generation()) },
+      _count_limit{ std::exchange(other._count_limit, nil) },
+      _position_transform{ std::exchange(other._position_transform, VertexPositionTransform{}) },
       _vertex_buffer{ std::exchange(other._vertex_buffer, nullptr) },
       _index_buffer{ std::exchange(other._index_buffer, nullptr) },
       _instance_buffer{ std::exchange(other._instance_buffer, nullptr) }
@@ -96,7 +117,9 @@ auto VertexArray::operator=(VertexArray&& other) noexcept -> VertexArray&
     destroy();
 
     _id = std::exchange(other._id, GL_NONE);
+    _generation = std::exchange(other._generation, next_generation());
     _count_limit = std::exchange(other._count_limit, nil);
+    _position_transform = std::exchange(other._position_transform, VertexPositionTransform{});
     _vertex_buffer = std::exchange(other._vertex_buffer, nullptr);
     _index_buffer = std::exchange(other._index_buffer, nullptr);
     _instance_buffer = std::exchange(other._instance_buffer, nullptr);
@@ -111,17 +134,18 @@ VertexArray::~VertexArray()
 
 auto VertexArray::bind() const -> void
 {
-    glBindVertexArray(_id);
+    StateCache::bind_vertex_array(_id);
 }
 
 auto VertexArray::unbind() -> void
 {
-    glBindVertexArray(GL_NONE);
+    StateCache::bind_vertex_array(GL_NONE);
 }
 
 auto VertexArray::bind_vertex_buffer(const VertexBuffer& vertex_buffer) -> void
 {
     _vertex_buffer = &vertex_buffer;
+    _generation = next_generation();
     glVertexArrayVertexBuffer(_id, vertex_buffer_binding_index, _vertex_buffer->native_handle(), 0,
                               static_cast<GLsizei>(_vertex_buffer->stride()));
 }
@@ -129,6 +153,7 @@ auto VertexArray::bind_vertex_buffer(const VertexBuffer& vertex_buffer) -> void
 auto VertexArray::bind_index_buffer(const IndexBuffer& index_buffer) -> void
 {
     _index_buffer = &index_buffer;
+    _generation = next_generation();
     glVertexArrayElementBuffer(_id, _index_buffer->native_handle());
 }
 
@@ -152,12 +177,14 @@ auto VertexArray::unbind_vertex_buffer() -> void
 {
     glVertexArrayVertexBuffer(_id, vertex_buffer_binding_index, GL_NONE, 0, 0);
     _vertex_buffer = nullptr;
+    _generation = next_generation();
 }
 
 auto VertexArray::unbind_index_buffer() -> void
 {
     glVertexArrayElementBuffer(_id, GL_NONE);
     _index_buffer = nullptr;
+    _generation = next_generation();
 }
 
 auto VertexArray::unbind_instance_buffer() -> void
@@ -183,6 +210,11 @@ auto VertexArray::set_count_limit(Nil) -> void
     _count_limit = nil;
 }
 
+auto VertexArray::set_position_transform(const VertexPositionTransform& transform) -> void
+{
+    _position_transform = transform;
+}
+
 auto VertexArray::count() const -> u32
 {
     if (!_index_buffer)
@@ -222,6 +254,7 @@ auto VertexArray::create() noexcept -> void
 
 auto VertexArray::destroy() const noexcept -> void
 {
+    StateCache::forget_vertex_array(_id);
     glDeleteVertexArrays(1, &_id);
 }
 
@@ -236,12 +269,12 @@ auto VertexArray::bind_vertex_buffer_layout() const -> void
 
     for (auto& elem : layout)
     {
-        auto [count, type, size, slots_occupied] = get_vertex_layout_element_info(elem);
+        auto [count, type, size, slots_occupied, normalized] = get_vertex_layout_element_info(elem);
 
         for (GLuint i = 0; i < slots_occupied; i++)
         {
             glEnableVertexArrayAttrib(_id, index);
-            glVertexArrayAttribFormat(_id, index, static_cast<GLint>(count), to_gl_enum(type), GL_FALSE, offset);
+            set_attrib_format(_id, index, count, type, normalized, offset);
             glVertexArrayAttribBinding(_id, index, vertex_buffer_binding_index);
 
             index++;
@@ -264,12 +297,12 @@ auto VertexArray::bind_instance_buffer_layout() const -> void
 
     for (auto& elem : layout)
     {
-        auto [count, type, size, slots_occupied] = get_vertex_layout_element_info(elem);
+        auto [count, type, size, slots_occupied, normalized] = get_vertex_layout_element_info(elem);
 
         for (GLuint i = 0; i < slots_occupied; i++)
         {
             glEnableVertexArrayAttrib(_id, index);
-            glVertexArrayAttribFormat(_id, index, static_cast<GLint>(count), to_gl_enum(type), GL_FALSE, offset);
+            set_attrib_format(_id, index, count, type, normalized, offset);
             glVertexArrayAttribBinding(_id, index, instance_buffer_binding_index);
             glVertexArrayBindingDivisor(_id, instance_buffer_binding_index, 1);
 
@@ -279,4 +312,11 @@ auto VertexArray::bind_instance_buffer_layout() const -> void
     }
 }
 
+auto VertexArray::next_generation() -> u64
+{
+    // Vertex arrays only get created and modified on the thread which owns the OpenGL context.
+    static u64 generation = 0;
+    return generation++;
+}
+
 } // namespace zth::gl
@@ -13,6 +13,10 @@ auto get_vertex_layout_element_info(VertexLayoutElement elem) -> VertexLayoutEle
         return { .count = 1,
                  .type = DataType::Float,
                  .size_bytes = static_cast<u32>(size_of_data_type(DataType::Float)) };
+    case Uint:
+        return { .count = 1,
+                 .type = DataType::UnsignedInt,
+                 .size_bytes = static_cast<u32>(size_of_data_type(DataType::UnsignedInt)) };
     case Vec2:
         return { .count = 2,
                  .type = DataType::Float,
@@ -35,6 +39,39 @@ auto get_vertex_layout_element_info(VertexLayoutElement elem) -> VertexLayoutEle
                  .type = DataType::Float,
                  .size_bytes = static_cast<u32>(size_of_data_type(DataType::Float)) * 4,
                  .slots_occupied = 4 };
+    case HalfVec2:
+        return { .count = 2,
+                 .type = DataType::HalfFloat,
+                 .size_bytes = static_cast<u32>(size_of_data_type(DataType::HalfFloat)) * 2 };
+    case HalfVec4:
+        return { .count = 4,
+                 .type = DataType::HalfFloat,
+                 .size_bytes = static_cast<u32>(size_of_data_type(DataType::HalfFloat)) * 4 };
+    case Snorm16Vec2:
+        return { .count = 2,
+                 .type = DataType::Short,
+                 .size_bytes = static_cast<u32>(size_of_data_type(DataType::Short)) * 2,
+                 .normalized = true };
+    case Snorm16Vec4:
+        return { .count = 4,
+                 .type = DataType::Short,
+                 .size_bytes = static_cast<u32>(size_of_data_type(DataType::Short)) * 4,
+                 .normalized = true };
+    case Unorm16Vec2:
+        return { .count = 2,
+                 .type = DataType::UnsignedShort,
+                 .size_bytes = static_cast<u32>(size_of_data_type(DataType::UnsignedShort)) * 2,
+                 .normalized = true };
+    case Unorm16Vec4:
+        return { .count = 4,
+                 .type = DataType::UnsignedShort,
+                 .size_bytes = static_cast<u32>(size_of_data_type(DataType::UnsignedShort)) * 4,
+                 .normalized = true };
+    case Snorm1010102:
+        return { .count = 4,
+                 .type = DataType::Int2101010Rev,
+                 .size_bytes = static_cast<u32>(size_of_data_type(DataType::Int2101010Rev)),
+                 .normalized = true };
     }
 
     ZTH_ASSERT(false);
@@ -10,6 +10,7 @@
 #include "zenith/renderer/renderer.hpp"
 #include "zenith/renderer/shader_preprocessor.hpp"
 #include "zenith/system/event.hpp"
+#include "zenith/system/job_system.hpp"
 #include "zenith/system/temporary_storage.hpp"
 #include "zenith/util/defer.hpp"
 
@@ -18,9 +19,10 @@ namespace zth {
 // --- System Layer
 // 1. Logger
 // 2. TemporaryStorage
-// 3. Window
-// 4. gl::Context
-// 5. Input
+// 3. JobSystem
+// 4. Window
+// 5. gl::Context
+// 6. Input
 
 SystemLayer::SystemLayer(const LoggerSpec& logger_spec, const WindowSpec& window_spec, usize temporary_storage_capacity)
     : _logger_spec{ logger_spec }, _window_spec{ window_spec },
@@ -55,6 +57,11 @@ auto SystemLayer::on_attach() -> Result<void, String>
         return Error{ result.error() };
     Defer shut_down_temporary_storage{ [] { TemporaryStorage::shut_down(); } };
 
+    result = JobSystem::init();
+    if (!result)
+        return Error{ result.error() };
+    Defer shut_down_job_system{ [] { JobSystem::shut_down(); } };
+
     result = Window::init(_window_spec);
     if (!result)
         return Error{ result.error() };
@@ -72,6 +79,7 @@ auto SystemLayer::on_attach() -> Result<void, String>
 
     shut_down_logger.dismiss();
     shut_down_temporary_storage.dismiss();
+    shut_down_job_system.dismiss();
     shut_down_window.dismiss();
     shut_down_gl_context.dismiss();
     shut_down_input.dismiss();
@@ -88,6 +96,7 @@ auto SystemLayer::on_detach() -> void
     Input::shut_down();
     gl::Context::shut_down();
     Window::shut_down();
+    JobSystem::shut_down();
     TemporaryStorage::shut_down();
     Logger::shut_down();
 }
@@ -0,0 +1,65 @@
+#include "zenith/math/bounds.hpp"
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+
+#include "zenith/math/matrix.hpp"
+#include "zenith/math/vector.hpp"
+
+namespace zth::math {
+
+auto Aabb::surface_area() const -> float
+{
+    auto size = max - min;
+    return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+auto merge(const Aabb& a, const Aabb& b) -> Aabb
+{
+    return Aabb{ .min = glm::min(a.min, b.min), .max = glm::max(a.max, b.max) };
+}
+
+auto intersect(const Ray& ray, const Aabb& aabb, float max_distance) -> Optional<float>
+{
+    // Slab method. Division by zero gives infinities, which make the comparisons below work out for axis-aligned rays.
+    auto inverse_direction = 1.0f / ray.direction;
+    auto t_0 = (aabb.min - ray.origin) * inverse_direction;
+    auto t_1 = (aabb.max - ray.origin) * inverse_direction;
+
+    auto t_near = glm::min(t_0, t_1);
+    auto t_far = glm::max(t_0, t_1);
+
+    auto enter = std::max({ t_near.x, t_near.y, t_near.z, 0.0f });
+    auto exit = std::min({ t_far.x, t_far.y, t_far.z, max_distance });
+
+    if (enter > exit)
+        return nil;
+
+    return enter;
+}
+
+auto transform_aabb(const Aabb& aabb, const glm::mat4& transform) -> Aabb
+{
+    // Transform the center and project the extents onto the axes of the transformed box (Arvo's method).
+    auto center = glm::vec3{ transform * glm::vec4{ aabb.center(), 1.0f } };
+    auto extents = aabb.extents();
+
+    glm::vec3 new_extents{ 0.0f };
+
+    for (glm::length_t i = 0; i < 3; i++)
+        new_extents += glm::abs(glm::vec3{ transform[i] }) * extents[i];
+
+    return Aabb{ .min = center - new_extents, .max = center + new_extents };
+}
+
+auto transform_bounding_sphere(const BoundingSphere& sphere, const glm::mat4& transform) -> BoundingSphere
+{
+    return BoundingSphere{
+        .center = glm::vec3{ transform * glm::vec4{ sphere.center, 1.0f } },
+        .radius = sphere.radius * max_component(extract_scale(transform)),
+    };
+}
+
+} // namespace zth::math
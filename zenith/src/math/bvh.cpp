@@ -0,0 +1,734 @@
+#include "zenith/math/bvh.hpp"
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <glm/vector_relational.hpp>
+
+#include <algorithm>
+#include <array>
+
+#include "zenith/core/assert.hpp"
+
+namespace zth::math {
+
+namespace {
+
+constexpr u32 no_slot = std::numeric_limits<u32>::max();
+
+// Number of buckets the centroids get sorted into when searching for the best split.
+constexpr u32 bin_count = 16;
+
+// Past this depth nodes get split in the middle instead, which bounds the depth of the recursion.
+constexpr u32 max_sah_depth = 48;
+
+// Cost of visiting a node relative to the cost of testing a primitive.
+constexpr float traversal_cost = 1.0f;
+
+struct Bin
+{
+    Aabb bounds;
+    u32 count = 0;
+};
+
+struct Split
+{
+    u32 bin; // Primitives in the bins before this one go to the first child.
+    float cost;
+};
+
+struct Rotation
+{
+    u32 child;
+    u32 grandchild;
+    float area_change; // Of the node whose child the grandchild is.
+};
+
+auto bin_index(float centroid, float min, float scale) -> u32
+{
+    return std::min(static_cast<u32>((centroid - min) * scale), bin_count - 1);
+}
+
+auto add_to_bounds(Aabb& bounds, u32& count, const Aabb& added, u32 added_count) -> void
+{
+    bounds = count == 0 ? added : merge(bounds, added);
+    count += added_count;
+}
+
+auto encloses(const Aabb& outer, const Aabb& inner) -> bool
+{
+    return glm::all(glm::lessThanEqual(outer.min, inner.min)) && glm::all(glm::greaterThanEqual(outer.max, inner.max));
+}
+
+auto longest_axis(glm::vec3 extent) -> glm::length_t
+{
+    return extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+}
+
+auto bounding_sphere(const Aabb& bounds) -> BoundingSphere
+{
+    // Slightly bigger than the sphere around the box, so that rounding errors never make the sphere miss the frustum
+    // when the box intersects it.
+    return BoundingSphere{ .center = bounds.center(), .radius = glm::length(bounds.extents()) * 1.0001f };
+}
+
+} // namespace
+
+auto Bvh::build(std::span<const Aabb> primitive_bounds) -> void
+{
+    clear();
+
+    if (primitive_bounds.empty())
+        return;
+
+    ZTH_ASSERT(primitive_bounds.size() < no_primitive);
+    auto count = static_cast<u32>(primitive_bounds.size());
+
+    _primitive_bounds.assign(primitive_bounds.begin(), primitive_bounds.end());
+    _primitive_slots.resize(count, no_slot);
+
+    // A binary tree with at least one primitive per leaf never has more nodes than this.
+    _nodes.reserve(count * 2 - 1);
+    _parents.reserve(count * 2 - 1);
+
+    Vector<BuildPrimitive> build_primitives;
+    build_primitives.reserve(count);
+
+    for (u32 i = 0; i < count; i++)
+    {
+        const auto& bounds = primitive_bounds[i];
+        build_primitives.push_back(BuildPrimitive{ .bounds = bounds, .centroid = bounds.center(), .index = i });
+    }
+
+    _nodes.push_back(Node{ .bounds = {}, .first = 0, .primitive_count = 0 });
+    _parents.push_back(no_node);
+
+    build_node(build_primitives, 0, 0);
+}
+
+auto Bvh::clear() -> void
+{
+    _nodes.clear();
+    _parents.clear();
+    _free_node_pairs.clear();
+
+    _slots.clear();
+    _slot_spheres.clear();
+    _block_leaves.clear();
+    _free_blocks.clear();
+
+    _primitive_bounds.clear();
+    _primitive_slots.clear();
+    _free_primitives.clear();
+
+    _updated_primitives.clear();
+}
+
+auto Bvh::insert(const Aabb& bounds) -> u32
+{
+    u32 primitive_index = 0;
+
+    if (!_free_primitives.empty())
+    {
+        primitive_index = _free_primitives.back();
+        _free_primitives.pop_back();
+        _primitive_bounds[primitive_index] = bounds;
+    }
+    else
+    {
+        ZTH_ASSERT(_primitive_bounds.size() < no_primitive);
+        primitive_index = static_cast<u32>(_primitive_bounds.size());
+        _primitive_bounds.push_back(bounds);
+        _primitive_slots.push_back(no_slot);
+    }
+
+    insert_into_leaf(primitive_index);
+    return primitive_index;
+}
+
+auto Bvh::remove(u32 primitive_index) -> void
+{
+    ZTH_ASSERT(contains(primitive_index));
+
+    remove_from_leaf(primitive_index);
+    _free_primitives.push_back(primitive_index);
+}
+
+auto Bvh::update_primitive(u32 primitive_index, const Aabb& bounds) -> void
+{
+    ZTH_ASSERT(contains(primitive_index));
+
+    _primitive_bounds[primitive_index] = bounds;
+
+    auto slot = _primitive_slots[primitive_index];
+    auto leaf = _block_leaves[slot / max_leaf_size];
+
+    // Growing the leaf would make it overlap its neighbours more and more as the primitive keeps moving, so the
+    // primitive goes wherever it fits best instead.
+    if (!encloses(_nodes[leaf].bounds, bounds))
+    {
+        remove_from_leaf(primitive_index);
+        insert_into_leaf(primitive_index);
+        return;
+    }
+
+    _slot_spheres[slot] = bounding_sphere(bounds);
+    _updated_primitives.push_back(primitive_index);
+}
+
+auto Bvh::refit() -> void
+{
+    // The updated primitives might have been removed since, along with the rest of the hierarchy.
+    if (_nodes.empty())
+        _updated_primitives.clear();
+
+    if (_updated_primitives.empty())
+        return;
+
+    // Walking up from every updated leaf visits about log2(node count) nodes per primitive. Once that adds up to a
+    // sizeable part of the hierarchy, it's cheaper to refit every node in a single pass.
+    if (_updated_primitives.size() * 16 > _nodes.size())
+    {
+        // Goes through the nodes in post-order, so that both of a node's children are refitted before the node.
+        u32 node_index = 0;
+
+        while (true)
+        {
+            while (!_nodes[node_index].is_leaf())
+                node_index = _nodes[node_index].first;
+
+            refit_node(node_index);
+
+            // Second children are stored at even indices. Once we're done with one, we're done with its parent too.
+            while (node_index != 0 && node_index % 2 == 0)
+            {
+                node_index = _parents[node_index];
+                refit_node(node_index);
+            }
+
+            if (node_index == 0)
+                break;
+
+            node_index++;
+        }
+    }
+    else
+    {
+        // We can stop once a node's bounds don't change, as its ancestors' bounds won't change either.
+        for (auto primitive_index : _updated_primitives)
+        {
+            // The primitive might have been removed or moved to another leaf since it was updated.
+            if (!contains(primitive_index))
+                continue;
+
+            for (auto node_index = _block_leaves[_primitive_slots[primitive_index] / max_leaf_size];
+                 node_index != no_node; node_index = _parents[node_index])
+            {
+                if (!refit_node(node_index))
+                    break;
+            }
+        }
+    }
+
+    _updated_primitives.clear();
+}
+
+auto Bvh::raycast(const Ray& ray, float max_distance) const -> Optional<BvhRayHit>
+{
+    return raycast(ray, max_distance, [this](u32 primitive_index, const Ray& tested_ray, float distance_limit) {
+        return intersect(tested_ray, _primitive_bounds[primitive_index], distance_limit);
+    });
+}
+
+auto Bvh::contains(u32 primitive_index) const -> bool
+{
+    return primitive_index < _primitive_slots.size() && _primitive_slots[primitive_index] != no_slot;
+}
+
+auto Bvh::build_node(std::span<BuildPrimitive> primitives, u32 node_index, u32 depth) -> void
+{
+    ZTH_ASSERT(!primitives.empty());
+
+    auto count = static_cast<u32>(primitives.size());
+
+    Aabb bounds = primitives[0].bounds;
+    Aabb centroid_bounds{ .min = primitives[0].centroid, .max = primitives[0].centroid };
+
+    for (const auto& primitive : primitives)
+    {
+        bounds = merge(bounds, primitive.bounds);
+        centroid_bounds.min = glm::min(centroid_bounds.min, primitive.centroid);
+        centroid_bounds.max = glm::max(centroid_bounds.max, primitive.centroid);
+    }
+
+    _nodes[node_index].bounds = bounds;
+
+    auto make_leaf = [&] {
+        auto first_slot = allocate_block(node_index);
+        _nodes[node_index].first = first_slot;
+        _nodes[node_index].primitive_count = count;
+
+        for (u32 i = 0; i < count; i++)
+            place_primitive(primitives[i].index, first_slot + i);
+    };
+
+    if (count == 1)
+    {
+        make_leaf();
+        return;
+    }
+
+    // We only look for splits along the axis along which the centroids are spread out the most, which is where the
+    // best split almost always is, and costs a third of binning along every axis.
+    auto centroid_extent = centroid_bounds.max - centroid_bounds.min;
+    auto axis = longest_axis(centroid_extent);
+
+    auto min = centroid_bounds.min[axis];
+    auto scale = static_cast<float>(bin_count) / centroid_extent[axis];
+
+    Optional<Split> best_split = nil;
+
+    if (depth < max_sah_depth && centroid_extent[axis] > 0.0f)
+    {
+        std::array<Bin, bin_count> bins{};
+
+        for (const auto& primitive : primitives)
+        {
+            auto& bin = bins[bin_index(primitive.centroid[axis], min, scale)];
+            add_to_bounds(bin.bounds, bin.count, primitive.bounds, 1);
+        }
+
+        // Sweep from the right to gather the cost of everything after every split, then sweep from the left.
+        std::array<float, bin_count> right_costs{};
+        Aabb right_bounds;
+        u32 right_count = 0;
+
+        for (auto i = bin_count - 1; i > 0; i--)
+        {
+            if (bins[i].count > 0)
+                add_to_bounds(right_bounds, right_count, bins[i].bounds, bins[i].count);
+
+            right_costs[i] = right_count > 0 ? right_bounds.surface_area() * static_cast<float>(right_count) : 0.0f;
+        }
+
+        Aabb left_bounds;
+        u32 left_count = 0;
+
+        for (u32 i = 1; i < bin_count; i++)
+        {
+            if (bins[i - 1].count > 0)
+                add_to_bounds(left_bounds, left_count, bins[i - 1].bounds, bins[i - 1].count);
+
+            if (left_count == 0 || left_count == count)
+                continue;
+
+            auto cost = left_bounds.surface_area() * static_cast<float>(left_count) + right_costs[i];
+
+            if (!best_split || cost < best_split->cost)
+                best_split = Split{ .bin = i, .cost = cost };
+        }
+    }
+
+    u32 first_child_count = 0;
+
+    if (best_split)
+    {
+        // Costs are relative to the probability of a ray or a frustum hitting the node, which is proportional to its
+        // surface area.
+        auto area = bounds.surface_area();
+        auto leaf_cost = area * static_cast<float>(count);
+        auto split_cost = area * traversal_cost + best_split->cost;
+
+        if (count <= max_leaf_size && leaf_cost <= split_cost)
+        {
+            make_leaf();
+            return;
+        }
+
+        auto second_child = std::partition(primitives.begin(), primitives.end(), [&](const BuildPrimitive& primitive) {
+            return bin_index(primitive.centroid[axis], min, scale) < best_split->bin;
+        });
+
+        first_child_count = static_cast<u32>(second_child - primitives.begin());
+    }
+    else
+    {
+        if (count <= max_leaf_size)
+        {
+            make_leaf();
+            return;
+        }
+
+        // Every centroid is in the same spot or we're too deep. Split the primitives in half.
+        first_child_count = count / 2;
+        std::nth_element(primitives.begin(), primitives.begin() + first_child_count, primitives.end(),
+                         [&](const BuildPrimitive& a, const BuildPrimitive& b) {
+                             return a.centroid[axis] < b.centroid[axis];
+                         });
+    }
+
+    ZTH_ASSERT(first_child_count > 0 && first_child_count < count);
+
+    auto first_child = allocate_node_pair(node_index);
+    _nodes[node_index].first = first_child;
+    _nodes[node_index].primitive_count = inner_node;
+
+    build_node(primitives.first(first_child_count), first_child, depth + 1);
+    build_node(primitives.subspan(first_child_count), first_child + 1, depth + 1);
+}
+
+auto Bvh::allocate_node_pair(u32 parent) -> u32
+{
+    u32 first_child = 0;
+
+    if (!_free_node_pairs.empty())
+    {
+        first_child = _free_node_pairs.back();
+        _free_node_pairs.pop_back();
+    }
+    else
+    {
+        // The root is alone, so first children always end up at odd indices.
+        first_child = static_cast<u32>(_nodes.size());
+        _nodes.resize(_nodes.size() + 2);
+        _parents.resize(_parents.size() + 2);
+    }
+
+    _parents[first_child] = parent;
+    _parents[first_child + 1] = parent;
+    return first_child;
+}
+
+auto Bvh::allocate_block(u32 leaf) -> u32
+{
+    u32 block = 0;
+
+    if (!_free_blocks.empty())
+    {
+        block = _free_blocks.back();
+        _free_blocks.pop_back();
+    }
+    else
+    {
+        block = static_cast<u32>(_block_leaves.size());
+        _block_leaves.push_back(no_node);
+        _slots.resize(_slots.size() + max_leaf_size, no_primitive);
+        _slot_spheres.resize(_slot_spheres.size() + max_leaf_size);
+    }
+
+    _block_leaves[block] = leaf;
+    return block * max_leaf_size;
+}
+
+auto Bvh::free_block(u32 first_slot) -> void
+{
+    auto block = first_slot / max_leaf_size;
+    _block_leaves[block] = no_node;
+    std::fill_n(_slots.begin() + first_slot, max_leaf_size, no_primitive);
+    _free_blocks.push_back(block);
+}
+
+auto Bvh::place_primitive(u32 primitive_index, u32 slot) -> void
+{
+    _slots[slot] = primitive_index;
+    _slot_spheres[slot] = bounding_sphere(_primitive_bounds[primitive_index]);
+    _primitive_slots[primitive_index] = slot;
+}
+
+auto Bvh::insert_into_leaf(u32 primitive_index) -> void
+{
+    auto bounds = _primitive_bounds[primitive_index];
+
+    if (_nodes.empty())
+    {
+        _nodes.push_back(Node{ .bounds = bounds, .first = 0, .primitive_count = 0 });
+        _parents.push_back(no_node);
+        _nodes[0].first = allocate_block(0);
+    }
+
+    u32 node_index = 0;
+
+    while (!_nodes[node_index].is_leaf())
+    {
+        auto first_child = _nodes[node_index].first;
+
+        auto growth = [&](u32 child) {
+            const auto& child_bounds = _nodes[child].bounds;
+            return merge(child_bounds, bounds).surface_area() - child_bounds.surface_area();
+        };
+
+        // Go down the child whose bounds grow the least, or the smaller one if the primitive fits into both.
+        auto first_growth = growth(first_child);
+        auto second_growth = growth(first_child + 1);
+
+        if (first_growth == second_growth)
+        {
+            node_index = _nodes[first_child].bounds.surface_area() <= _nodes[first_child + 1].bounds.surface_area()
+                             ? first_child
+                             : first_child + 1;
+        }
+        else
+        {
+            node_index = first_growth < second_growth ? first_child : first_child + 1;
+        }
+    }
+
+    auto& leaf = _nodes[node_index];
+
+    if (leaf.primitive_count == max_leaf_size)
+    {
+        split_leaf(node_index, primitive_index);
+    }
+    else
+    {
+        leaf.bounds = leaf.primitive_count == 0 ? bounds : merge(leaf.bounds, bounds);
+        place_primitive(primitive_index, leaf.first + leaf.primitive_count);
+        leaf.primitive_count++;
+    }
+
+    refit_and_rotate_ancestors(_parents[node_index]);
+}
+
+auto Bvh::split_leaf(u32 leaf, u32 primitive_index) -> void
+{
+    constexpr auto count = max_leaf_size + 1;
+
+    auto first_slot = _nodes[leaf].first;
+
+    std::array<u32, count> primitives;
+    std::copy_n(_slots.begin() + first_slot, max_leaf_size, primitives.begin());
+    primitives.back() = primitive_index;
+
+    auto bounds = [&](u32 primitive) -> const Aabb& { return _primitive_bounds[primitive]; };
+
+    Aabb centroid_bounds{ .min = bounds(primitive_index).center(), .max = bounds(primitive_index).center() };
+
+    for (auto primitive : primitives)
+    {
+        centroid_bounds.min = glm::min(centroid_bounds.min, bounds(primitive).center());
+        centroid_bounds.max = glm::max(centroid_bounds.max, bounds(primitive).center());
+    }
+
+    // Same as building a node, only with few enough primitives to try every split along the axis.
+    auto axis = longest_axis(centroid_bounds.max - centroid_bounds.min);
+    std::ranges::sort(primitives, [&](u32 a, u32 b) { return bounds(a).center()[axis] < bounds(b).center()[axis]; });
+
+    std::array<float, count> right_areas{};
+    auto right_bounds = bounds(primitives.back());
+
+    for (auto i = count - 1; i > 0; i--)
+    {
+        right_bounds = merge(right_bounds, bounds(primitives[i]));
+        right_areas[i] = right_bounds.surface_area();
+    }
+
+    auto left_bounds = bounds(primitives.front());
+    u32 first_child_count = 1;
+    auto best_cost = std::numeric_limits<float>::infinity();
+
+    for (u32 i = 1; i < count; i++)
+    {
+        left_bounds = merge(left_bounds, bounds(primitives[i - 1]));
+        auto cost = left_bounds.surface_area() * static_cast<float>(i)
+                    + right_areas[i] * static_cast<float>(count - i);
+
+        if (cost < best_cost)
+        {
+            best_cost = cost;
+            first_child_count = i;
+        }
+    }
+
+    // The first child keeps the leaf's block.
+    auto first_child = allocate_node_pair(leaf);
+    auto second_child = first_child + 1;
+
+    std::fill_n(_slots.begin() + first_slot, max_leaf_size, no_primitive);
+    _block_leaves[first_slot / max_leaf_size] = first_child;
+    _nodes[first_child] = Node{ .bounds = {}, .first = first_slot, .primitive_count = first_child_count };
+    _nodes[second_child] = Node{
+        .bounds = {},
+        .first = allocate_block(second_child),
+        .primitive_count = count - first_child_count,
+    };
+
+    for (u32 i = 0; i < count; i++)
+    {
+        auto child = i < first_child_count ? first_child : second_child;
+        auto slot = _nodes[child].first + (i < first_child_count ? i : i - first_child_count);
+        place_primitive(primitives[i], slot);
+    }
+
+    refit_node(first_child);
+    refit_node(second_child);
+
+    _nodes[leaf].first = first_child;
+    _nodes[leaf].primitive_count = inner_node;
+    refit_node(leaf);
+}
+
+auto Bvh::remove_from_leaf(u32 primitive_index) -> void
+{
+    auto slot = _primitive_slots[primitive_index];
+    ZTH_ASSERT(slot != no_slot);
+
+    auto leaf = _block_leaves[slot / max_leaf_size];
+    auto& node = _nodes[leaf];
+
+    // The last primitive of the leaf takes the removed primitive's slot, so the leaf's primitives stay packed.
+    auto last_slot = node.first + node.primitive_count - 1;
+
+    if (slot != last_slot)
+        place_primitive(_slots[last_slot], slot);
+
+    _slots[last_slot] = no_primitive;
+    _primitive_slots[primitive_index] = no_slot;
+    node.primitive_count--;
+
+    if (node.primitive_count > 0)
+    {
+        refit_and_rotate_ancestors(leaf);
+        return;
+    }
+
+    if (leaf == 0)
+    {
+        // The hierarchy is empty, so every node and every block is free.
+        _nodes.clear();
+        _parents.clear();
+        _free_node_pairs.clear();
+        _slots.clear();
+        _slot_spheres.clear();
+        _block_leaves.clear();
+        _free_blocks.clear();
+        return;
+    }
+
+    // The parent takes over the sibling's contents, and the pair of children goes away.
+    auto parent = _parents[leaf];
+    auto sibling = leaf % 2 == 1 ? leaf + 1 : leaf - 1;
+
+    free_block(node.first);
+    move_node(sibling, parent);
+    _free_node_pairs.push_back(std::min(leaf, sibling));
+
+    refit_and_rotate_ancestors(_parents[parent]);
+}
+
+auto Bvh::adopt_children(u32 node_index) -> void
+{
+    const auto& node = _nodes[node_index];
+
+    if (node.is_leaf())
+    {
+        _block_leaves[node.first / max_leaf_size] = node_index;
+    }
+    else
+    {
+        _parents[node.first] = node_index;
+        _parents[node.first + 1] = node_index;
+    }
+}
+
+auto Bvh::move_node(u32 from, u32 to) -> void
+{
+    _nodes[to] = _nodes[from];
+    adopt_children(to);
+}
+
+auto Bvh::swap_nodes(u32 a, u32 b) -> void
+{
+    std::swap(_nodes[a], _nodes[b]);
+    adopt_children(a);
+    adopt_children(b);
+}
+
+auto Bvh::refit_node(u32 node_index) -> bool
+{
+    auto& node = _nodes[node_index];
+    Aabb bounds;
+
+    if (node.is_leaf())
+    {
+        // Only the root can be an empty leaf, and only while a primitive is being inserted into it.
+        if (node.primitive_count == 0)
+            return false;
+
+        bounds = _primitive_bounds[_slots[node.first]];
+
+        for (auto slot = node.first + 1; slot < node.first + node.primitive_count; slot++)
+            bounds = merge(bounds, _primitive_bounds[_slots[slot]]);
+    }
+    else
+    {
+        bounds = merge(_nodes[node.first].bounds, _nodes[node.first + 1].bounds);
+    }
+
+    auto changed = bounds.min != node.bounds.min || bounds.max != node.bounds.max;
+    node.bounds = bounds;
+    return changed;
+}
+
+auto Bvh::refit_and_rotate_ancestors(u32 node_index) -> void
+{
+    for (; node_index != no_node; node_index = _parents[node_index])
+    {
+        refit_node(node_index);
+        rotate(node_index);
+    }
+}
+
+auto Bvh::rotate(u32 node_index) -> void
+{
+    const auto& node = _nodes[node_index];
+
+    if (node.is_leaf())
+        return;
+
+    // Swapping one of the node's children with one of the other child's children doesn't change the node's bounds,
+    // but it changes the bounds of the other child. We make the swap which shrinks them the most, if any.
+    Optional<Rotation> best_rotation = nil;
+
+    auto consider = [&](u32 child, u32 other_child) {
+        const auto& other = _nodes[other_child];
+
+        if (other.is_leaf())
+            return;
+
+        auto area = other.bounds.surface_area();
+
+        for (auto grandchild : { other.first, other.first + 1 })
+        {
+            auto kept_grandchild = grandchild == other.first ? other.first + 1 : other.first;
+            auto area_change = merge(_nodes[child].bounds, _nodes[kept_grandchild].bounds).surface_area() - area;
+
+            if (area_change < 0.0f && (!best_rotation || area_change < best_rotation->area_change))
+                best_rotation = Rotation{ .child = child, .grandchild = grandchild, .area_change = area_change };
+        }
+    };
+
+    consider(node.first, node.first + 1);
+    consider(node.first + 1, node.first);
+
+    if (!best_rotation)
+        return;
+
+    auto other_child = _parents[best_rotation->grandchild];
+    swap_nodes(best_rotation->child, best_rotation->grandchild);
+    refit_node(other_child);
+}
+
+auto Bvh::next_node(u32 node_index) const -> u32
+{
+    // First children are stored at odd indices, and their siblings right after them.
+    while (node_index != 0)
+    {
+        if (node_index % 2 == 1)
+            return node_index + 1;
+
+        node_index = _parents[node_index];
+    }
+
+    return no_node;
+}
+
+} // namespace zth::math
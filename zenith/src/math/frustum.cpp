@@ -0,0 +1,189 @@
+#include "zenith/math/frustum.hpp"
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+#include "zenith/core/assert.hpp"
+
+#if defined(__SSE__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define ZTH_FRUSTUM_CULLING_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace zth::math {
+
+namespace {
+
+auto signed_distance(glm::vec4 plane, glm::vec3 point) -> float
+{
+    return glm::dot(glm::vec3{ plane }, point) + plane.w;
+}
+
+} // namespace
+
+auto Frustum::from_view_projection(const glm::mat4& view_projection) -> Frustum
+{
+    // glm matrices are column-major, so we have to gather the rows ourselves.
+    auto row = [&](glm::length_t i) {
+        return glm::vec4{ view_projection[0][i], view_projection[1][i], view_projection[2][i], view_projection[3][i] };
+    };
+
+    auto row_0 = row(0);
+    auto row_1 = row(1);
+    auto row_2 = row(2);
+    auto row_3 = row(3);
+
+    Frustum frustum{ .planes = {
+                         row_3 + row_0, // Left.
+                         row_3 - row_0, // Right.
+                         row_3 + row_1, // Bottom.
+                         row_3 - row_1, // Top.
+                         row_3 + row_2, // Near.
+                         row_3 - row_2, // Far.
+                     } };
+
+    for (auto& plane : frustum.planes)
+        plane /= glm::length(glm::vec3{ plane });
+
+    return frustum;
+}
+
+auto contains(const Frustum& frustum, glm::vec3 point) -> bool
+{
+    for (const auto& plane : frustum.planes)
+    {
+        if (signed_distance(plane, point) < 0.0f)
+            return false;
+    }
+
+    return true;
+}
+
+auto intersects(const Frustum& frustum, const BoundingSphere& sphere) -> bool
+{
+    for (const auto& plane : frustum.planes)
+    {
+        if (signed_distance(plane, sphere.center) < -sphere.radius)
+            return false;
+    }
+
+    return true;
+}
+
+auto intersects(const Frustum& frustum, const Aabb& aabb) -> bool
+{
+    auto center = aabb.center();
+    auto extents = aabb.extents();
+
+    for (const auto& plane : frustum.planes)
+    {
+        // Projection of the box's extents onto the plane's normal.
+        auto radius = glm::dot(glm::abs(glm::vec3{ plane }), extents);
+
+        if (signed_distance(plane, center) < -radius)
+            return false;
+    }
+
+    return true;
+}
+
+auto classify(const Frustum& frustum, const Aabb& aabb) -> FrustumIntersection
+{
+    auto center = aabb.center();
+    auto extents = aabb.extents();
+    auto result = FrustumIntersection::Inside;
+
+    for (const auto& plane : frustum.planes)
+    {
+        auto radius = glm::dot(glm::abs(glm::vec3{ plane }), extents);
+        auto distance = signed_distance(plane, center);
+
+        if (distance < -radius)
+            return FrustumIntersection::Outside;
+
+        if (distance < radius)
+            result = FrustumIntersection::Partial;
+    }
+
+    return result;
+}
+
+auto cull_bounding_spheres(const Frustum& frustum, std::span<const BoundingSphere> spheres,
+                           std::span<u32> visible_indices) -> usize
+{
+    ZTH_ASSERT(visible_indices.size() >= spheres.size());
+
+    usize visible_count = 0;
+    usize i = 0;
+
+#if defined(ZTH_FRUSTUM_CULLING_SSE)
+    struct PlaneComponents
+    {
+        __m128 x, y, z, w;
+    };
+
+    std::array<PlaneComponents, Frustum::plane_count> planes;
+
+    for (usize p = 0; p < Frustum::plane_count; p++)
+    {
+        const auto& plane = frustum.planes[p];
+        planes[p] = {
+            .x = _mm_set1_ps(plane.x),
+            .y = _mm_set1_ps(plane.y),
+            .z = _mm_set1_ps(plane.z),
+            .w = _mm_set1_ps(plane.w),
+        };
+    }
+
+    const auto zero = _mm_setzero_ps();
+
+    for (; i + 4 <= spheres.size(); i += 4)
+    {
+        // Every sphere is four floats (center and radius), so loading four spheres and transposing them gives us the
+        // spheres' components in structure of arrays form.
+        auto s0 = _mm_loadu_ps(&spheres[i + 0].center.x);
+        auto s1 = _mm_loadu_ps(&spheres[i + 1].center.x);
+        auto s2 = _mm_loadu_ps(&spheres[i + 2].center.x);
+        auto s3 = _mm_loadu_ps(&spheres[i + 3].center.x);
+
+        auto t0 = _mm_unpacklo_ps(s0, s1); // x0 x1 y0 y1
+        auto t1 = _mm_unpacklo_ps(s2, s3); // x2 x3 y2 y3
+        auto t2 = _mm_unpackhi_ps(s0, s1); // z0 z1 r0 r1
+        auto t3 = _mm_unpackhi_ps(s2, s3); // z2 z3 r2 r3
+
+        auto x = _mm_movelh_ps(t0, t1);
+        auto y = _mm_movehl_ps(t1, t0);
+        auto z = _mm_movelh_ps(t2, t3);
+        auto negative_radius = _mm_sub_ps(zero, _mm_movehl_ps(t3, t2));
+
+        auto inside = _mm_cmpeq_ps(zero, zero);
+
+        for (const auto& plane : planes)
+        {
+            // Same order of operations as in signed_distance().
+            auto distance = _mm_add_ps(_mm_mul_ps(plane.x, x), _mm_mul_ps(plane.y, y));
+            distance = _mm_add_ps(_mm_add_ps(distance, _mm_mul_ps(plane.z, z)), plane.w);
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negative_radius));
+        }
+
+        auto mask = static_cast<u32>(_mm_movemask_ps(inside));
+
+        // Branchless compaction. We might write past the visible indices, but never past the end of the span.
+        for (u32 lane = 0; lane < 4; lane++)
+        {
+            visible_indices[visible_count] = static_cast<u32>(i + lane);
+            visible_count += (mask >> lane) & 1u;
+        }
+    }
+#endif
+
+    for (; i < spheres.size(); i++)
+    {
+        if (intersects(frustum, spheres[i]))
+            visible_indices[visible_count++] = static_cast<u32>(i);
+    }
+
+    return visible_count;
+}
+
+} // namespace zth::math
@@ -7,10 +7,212 @@
 #include <glm/gtx/euler_angles.hpp>
 #include <glm/gtx/matrix_decompose.hpp>
 
+#include <array>
+
+#include "zenith/core/assert.hpp"
 #include "zenith/math/vector.hpp"
 
+#if defined(__SSE__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define ZTH_NORMAL_MATRICES_SSE
+#include <xmmintrin.h>
+#endif
+
+#if defined(__AVX__)
+#define ZTH_NORMAL_MATRICES_AVX
+#include <immintrin.h>
+#endif
+
 namespace zth::math {
 
+namespace {
+
+// The transpose of the inverse of a matrix with columns a, b and c has columns b x c, c x a and a x b, divided by the
+// determinant. Unlike glm::inverseTranspose this doesn't need the full inverse, and maps well onto SIMD registers.
+auto normal_matrix_from_cofactors(const glm::mat4& transform) -> glm::mat3
+{
+    glm::vec3 a{ transform[0] };
+    glm::vec3 b{ transform[1] };
+    glm::vec3 c{ transform[2] };
+
+    auto bc = glm::cross(b, c);
+    auto inverse_determinant = 1.0f / glm::dot(a, bc);
+
+    return glm::mat3{ bc * inverse_determinant, glm::cross(c, a) * inverse_determinant,
+                      glm::cross(a, b) * inverse_determinant };
+}
+
+#if defined(ZTH_NORMAL_MATRICES_SSE)
+
+// The kernel below is written once against these wrappers, so that the same code handles 4 matrices at a time with
+// SSE and 8 at a time with AVX. Every lane of a register holds the same element of a different matrix.
+struct Sse
+{
+    using Register = __m128;
+
+    static constexpr usize width = 4;
+
+    // Loads a column of the matrices [first, first + 4).
+    static auto load_column(const glm::mat4* first, usize matrix, glm::length_t column) -> Register
+    {
+        return _mm_loadu_ps(&first[matrix][column].x);
+    }
+
+    // Returns the 4 lanes which belong to the matrices [first + group * 4, first + group * 4 + 4).
+    static auto group(Register value, [[maybe_unused]] usize group_index) -> __m128 { return value; }
+
+    static auto add(Register a, Register b) -> Register { return _mm_add_ps(a, b); }
+    static auto sub(Register a, Register b) -> Register { return _mm_sub_ps(a, b); }
+    static auto mul(Register a, Register b) -> Register { return _mm_mul_ps(a, b); }
+    static auto div(Register a, Register b) -> Register { return _mm_div_ps(a, b); }
+    static auto set1(float value) -> Register { return _mm_set1_ps(value); }
+    static auto store(float* destination, Register value) -> void { _mm_storeu_ps(destination, value); }
+
+    static auto unpack_low(Register a, Register b) -> Register { return _mm_unpacklo_ps(a, b); }
+    static auto unpack_high(Register a, Register b) -> Register { return _mm_unpackhi_ps(a, b); }
+    // [a0, a1, b0, b1] and [a2, a3, b2, b3] within every group of 4 lanes.
+    static auto low_halves(Register a, Register b) -> Register { return _mm_movelh_ps(a, b); }
+    static auto high_halves(Register a, Register b) -> Register { return _mm_movehl_ps(b, a); }
+};
+
+#if defined(ZTH_NORMAL_MATRICES_AVX)
+
+// AVX shuffles work within 128-bit lanes, so the low half of every register holds matrices [first, first + 4) and the
+// high half holds matrices [first + 4, first + 8). The transposes are then the same as with SSE.
+struct Avx
+{
+    using Register = __m256;
+
+    static constexpr usize width = 8;
+
+    static auto load_column(const glm::mat4* first, usize matrix, glm::length_t column) -> Register
+    {
+        auto low = _mm_loadu_ps(&first[matrix][column].x);
+        auto high = _mm_loadu_ps(&first[matrix + 4][column].x);
+        return _mm256_insertf128_ps(_mm256_castps128_ps256(low), high, 1);
+    }
+
+    static auto group(Register value, usize group_index) -> __m128
+    {
+        return group_index == 0 ? _mm256_castps256_ps128(value) : _mm256_extractf128_ps(value, 1);
+    }
+
+    static auto add(Register a, Register b) -> Register { return _mm256_add_ps(a, b); }
+    static auto sub(Register a, Register b) -> Register { return _mm256_sub_ps(a, b); }
+    static auto mul(Register a, Register b) -> Register { return _mm256_mul_ps(a, b); }
+    static auto div(Register a, Register b) -> Register { return _mm256_div_ps(a, b); }
+    static auto set1(float value) -> Register { return _mm256_set1_ps(value); }
+    static auto store(float* destination, Register value) -> void { _mm256_storeu_ps(destination, value); }
+
+    static auto unpack_low(Register a, Register b) -> Register { return _mm256_unpacklo_ps(a, b); }
+    static auto unpack_high(Register a, Register b) -> Register { return _mm256_unpackhi_ps(a, b); }
+    static auto low_halves(Register a, Register b) -> Register { return _mm256_shuffle_ps(a, b, 0b01'00'01'00); }
+    static auto high_halves(Register a, Register b) -> Register { return _mm256_shuffle_ps(a, b, 0b11'10'11'10); }
+};
+
+#endif
+
+template<typename Simd> struct Vec3s
+{
+    typename Simd::Register x, y, z;
+};
+
+template<typename Simd> auto cross(const Vec3s<Simd>& a, const Vec3s<Simd>& b) -> Vec3s<Simd>
+{
+    return Vec3s<Simd>{
+        .x = Simd::sub(Simd::mul(a.y, b.z), Simd::mul(a.z, b.y)),
+        .y = Simd::sub(Simd::mul(a.z, b.x), Simd::mul(a.x, b.z)),
+        .z = Simd::sub(Simd::mul(a.x, b.y), Simd::mul(a.y, b.x)),
+    };
+}
+
+template<typename Simd> auto multiply(const Vec3s<Simd>& v, typename Simd::Register factor) -> Vec3s<Simd>
+{
+    return Vec3s<Simd>{ .x = Simd::mul(v.x, factor), .y = Simd::mul(v.y, factor), .z = Simd::mul(v.z, factor) };
+}
+
+// Transposes 4 registers as if they were the rows of a 4x4 matrix (within every group of 4 lanes).
+template<typename Simd> auto transpose(std::array<typename Simd::Register, 4>& rows) -> void
+{
+    auto t0 = Simd::unpack_low(rows[0], rows[1]);  // 00 10 01 11
+    auto t1 = Simd::unpack_low(rows[2], rows[3]);  // 20 30 21 31
+    auto t2 = Simd::unpack_high(rows[0], rows[1]); // 02 12 03 13
+    auto t3 = Simd::unpack_high(rows[2], rows[3]); // 22 32 23 33
+
+    rows[0] = Simd::low_halves(t0, t1);
+    rows[1] = Simd::high_halves(t0, t1);
+    rows[2] = Simd::low_halves(t2, t3);
+    rows[3] = Simd::high_halves(t2, t3);
+}
+
+template<typename Simd> auto load_column(const glm::mat4* first, glm::length_t column) -> Vec3s<Simd>
+{
+    std::array<typename Simd::Register, 4> columns = {
+        Simd::load_column(first, 0, column),
+        Simd::load_column(first, 1, column),
+        Simd::load_column(first, 2, column),
+        Simd::load_column(first, 3, column),
+    };
+
+    transpose<Simd>(columns);
+
+    // The w components end up in columns[3], which we don't need.
+    return Vec3s<Simd>{ .x = columns[0], .y = columns[1], .z = columns[2] };
+}
+
+// Returns how many matrices were processed. The rest is left for the scalar code.
+template<typename Simd>
+auto compute_normal_matrices_simd(std::span<const glm::mat4> transforms, std::span<glm::mat3> normal_matrices)
+    -> usize
+{
+    static_assert(sizeof(glm::mat3) == 9 * sizeof(float));
+
+    usize i = 0;
+
+    for (; i + Simd::width <= transforms.size(); i += Simd::width)
+    {
+        auto a = load_column<Simd>(&transforms[i], 0);
+        auto b = load_column<Simd>(&transforms[i], 1);
+        auto c = load_column<Simd>(&transforms[i], 2);
+
+        auto bc = cross<Simd>(b, c);
+        auto determinant = Simd::add(Simd::add(Simd::mul(a.x, bc.x), Simd::mul(a.y, bc.y)), Simd::mul(a.z, bc.z));
+        auto inverse_determinant = Simd::div(Simd::set1(1.0f), determinant);
+
+        auto n0 = multiply<Simd>(bc, inverse_determinant);
+        auto n1 = multiply<Simd>(cross<Simd>(c, a), inverse_determinant);
+        auto n2 = multiply<Simd>(cross<Simd>(a, b), inverse_determinant);
+
+        // A mat3 is 9 consecutive floats. Transposing the first 8 elements back gives us the first and the second
+        // group of 4 floats of every matrix. The last element gets written separately.
+        std::array<typename Simd::Register, 4> first_elements = { n0.x, n0.y, n0.z, n1.x };
+        std::array<typename Simd::Register, 4> second_elements = { n1.y, n1.z, n2.x, n2.y };
+        transpose<Simd>(first_elements);
+        transpose<Simd>(second_elements);
+
+        alignas(32) std::array<float, Simd::width> last_elements;
+        Simd::store(last_elements.data(), n2.z);
+
+        for (usize group = 0; group < Simd::width / 4; group++)
+        {
+            for (usize k = 0; k < 4; k++)
+            {
+                auto matrix_index = i + group * 4 + k;
+                auto destination = &normal_matrices[matrix_index][0].x;
+
+                _mm_storeu_ps(destination, Simd::group(first_elements[k], group));
+                _mm_storeu_ps(destination + 4, Simd::group(second_elements[k], group));
+                destination[8] = last_elements[group * 4 + k];
+            }
+        }
+    }
+
+    return i;
+}
+
+#endif
+
+} // namespace
+
 auto compose_transform(glm::vec3 scale, glm::quat rotation, glm::vec3 translation) -> glm::mat4
 {
     glm::mat4 transform = glm::translate(glm::mat4{ 1.0f }, translation);
@@ -86,6 +288,44 @@ auto get_normal_matrix(const glm::mat4& transform) -> glm::mat3
     return glm::inverseTranspose(glm::mat3{ transform });
 }
 
+auto get_normal_matrix(glm::quat rotation, glm::vec3 scale) -> glm::mat3
+{
+    // The inverse transpose of R * S is R * S^-1, as R is orthonormal and S is diagonal.
+    auto normal_matrix = glm::mat3_cast(rotation);
+    normal_matrix[0] /= scale.x;
+    normal_matrix[1] /= scale.y;
+    normal_matrix[2] /= scale.z;
+    return normal_matrix;
+}
+
+auto compute_normal_matrices(std::span<const glm::mat4> transforms, std::span<glm::mat3> normal_matrices) -> void
+{
+    ZTH_ASSERT(normal_matrices.size() >= transforms.size());
+
+    usize i = 0;
+
+#if defined(ZTH_NORMAL_MATRICES_AVX)
+    i = compute_normal_matrices_simd<Avx>(transforms, normal_matrices);
+#endif
+
+#if defined(ZTH_NORMAL_MATRICES_SSE)
+    i += compute_normal_matrices_simd<Sse>(transforms.subspan(i), normal_matrices.subspan(i));
+#endif
+
+    for (; i < transforms.size(); i++)
+        normal_matrices[i] = normal_matrix_from_cofactors(transforms[i]);
+}
+
+auto compute_normal_matrices(std::span<const glm::quat> rotations, std::span<const glm::vec3> scales,
+                             std::span<glm::mat3> normal_matrices) -> void
+{
+    ZTH_ASSERT(rotations.size() == scales.size());
+    ZTH_ASSERT(normal_matrices.size() >= rotations.size());
+
+    for (usize i = 0; i < rotations.size(); i++)
+        normal_matrices[i] = get_normal_matrix(rotations[i], scales[i]);
+}
+
 auto rotation_matrix_from_quaternion(glm::quat rotation) -> glm::mat4
 {
     return glm::mat4_cast(rotation);
@@ -0,0 +1,274 @@
+#include "zenith/math/quantization.hpp"
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+
+namespace zth::math {
+
+namespace {
+
+constexpr u32 float_exponent_bias = 127;
+constexpr u32 half_exponent_bias = 15;
+
+// Rounds to nearest, ties to even.
+auto round_shifted_mantissa(u32 mantissa, u32 shift) -> u32
+{
+    auto result = mantissa >> shift;
+    auto remainder = mantissa & ((1u << shift) - 1);
+    auto halfway = 1u << (shift - 1);
+
+    if (remainder > halfway || (remainder == halfway && (result & 1) != 0))
+        result++;
+
+    return result;
+}
+
+// The OpenGL conversion from a signed normalized integer with the given number of bits to a float.
+auto dequantize_snorm(i32 value, u32 bits) -> float
+{
+    auto max = static_cast<float>((1 << (bits - 1)) - 1);
+    return std::max(static_cast<float>(value) / max, -1.0f);
+}
+
+auto quantize_snorm(float value, u32 bits) -> i32
+{
+    auto max = static_cast<float>((1 << (bits - 1)) - 1);
+    return static_cast<i32>(std::round(std::clamp(value, -1.0f, 1.0f) * max));
+}
+
+// Sign extends the field which starts at the given bit.
+auto extract_signed_field(u32 bits, u32 first_bit, u32 bit_count) -> i32
+{
+    return static_cast<i32>(bits << (32 - first_bit - bit_count)) >> (32 - bit_count);
+}
+
+auto sign_not_zero(glm::vec2 value) -> glm::vec2
+{
+    return glm::vec2{ value.x >= 0.0f ? 1.0f : -1.0f, value.y >= 0.0f ? 1.0f : -1.0f };
+}
+
+} // namespace
+
+auto float_to_half(float value) -> u16
+{
+    auto bits = std::bit_cast<u32>(value);
+    auto sign = (bits >> 16) & 0x8000u;
+    auto exponent = (bits >> 23) & 0xffu;
+    auto mantissa = bits & 0x7fffffu;
+
+    // Infinity stays infinity and NaN stays NaN.
+    if (exponent == 0xff)
+        return static_cast<u16>(sign | 0x7c00u | (mantissa != 0 ? 0x200u : 0u));
+
+    auto half_exponent = static_cast<i32>(exponent) - static_cast<i32>(float_exponent_bias - half_exponent_bias);
+
+    if (half_exponent >= 0x1f)
+        return static_cast<u16>(sign | 0x7c00u);
+
+    if (half_exponent <= 0)
+    {
+        // Too small even for a subnormal half float.
+        if (half_exponent < -10)
+            return static_cast<u16>(sign);
+
+        // A subnormal half float. Rounding up can carry over into the exponent, which gives the right result.
+        mantissa |= 0x800000u;
+        return static_cast<u16>(sign | round_shifted_mantissa(mantissa, static_cast<u32>(14 - half_exponent)));
+    }
+
+    // Rounding up can carry over into the exponent, and from the largest half float into infinity, which both give the
+    // right result.
+    auto result = static_cast<u32>(half_exponent) << 10 | mantissa >> 13;
+    auto remainder = mantissa & 0x1fffu;
+
+    if (remainder > 0x1000u || (remainder == 0x1000u && (result & 1) != 0))
+        result++;
+
+    return static_cast<u16>(sign | result);
+}
+
+auto half_to_float(u16 value) -> float
+{
+    auto sign = static_cast<u32>(value & 0x8000u) << 16;
+    auto exponent = (value >> 10) & 0x1fu;
+    auto mantissa = static_cast<u32>(value & 0x3ffu);
+
+    if (exponent == 0)
+    {
+        // Zero or a subnormal half float, which is a normal float.
+        auto magnitude = std::ldexp(static_cast<float>(mantissa), -24);
+        return sign != 0 ? -magnitude : magnitude;
+    }
+
+    if (exponent == 0x1f)
+        return std::bit_cast<float>(sign | 0x7f800000u | mantissa << 13);
+
+    return std::bit_cast<float>(sign | (exponent + float_exponent_bias - half_exponent_bias) << 23 | mantissa << 13);
+}
+
+auto quantize_snorm16(float value) -> i16
+{
+    return static_cast<i16>(quantize_snorm(value, 16));
+}
+
+auto dequantize_snorm16(i16 value) -> float
+{
+    return dequantize_snorm(value, 16);
+}
+
+auto quantize_unorm16(float value) -> u16
+{
+    constexpr auto max = static_cast<float>(std::numeric_limits<u16>::max());
+    return static_cast<u16>(std::round(std::clamp(value, 0.0f, 1.0f) * max));
+}
+
+auto dequantize_unorm16(u16 value) -> float
+{
+    constexpr auto max = static_cast<float>(std::numeric_limits<u16>::max());
+    return static_cast<float>(value) / max;
+}
+
+auto pack_half(glm::vec2 value) -> HalfVec2
+{
+    return HalfVec2{ .x = float_to_half(value.x), .y = float_to_half(value.y) };
+}
+
+auto pack_half(glm::vec4 value) -> HalfVec4
+{
+    return HalfVec4{
+        .x = float_to_half(value.x),
+        .y = float_to_half(value.y),
+        .z = float_to_half(value.z),
+        .w = float_to_half(value.w),
+    };
+}
+
+auto pack_snorm16(glm::vec2 value) -> Snorm16Vec2
+{
+    return Snorm16Vec2{ .x = quantize_snorm16(value.x), .y = quantize_snorm16(value.y) };
+}
+
+auto pack_snorm16(glm::vec4 value) -> Snorm16Vec4
+{
+    return Snorm16Vec4{
+        .x = quantize_snorm16(value.x),
+        .y = quantize_snorm16(value.y),
+        .z = quantize_snorm16(value.z),
+        .w = quantize_snorm16(value.w),
+    };
+}
+
+auto pack_unorm16(glm::vec2 value) -> Unorm16Vec2
+{
+    return Unorm16Vec2{ .x = quantize_unorm16(value.x), .y = quantize_unorm16(value.y) };
+}
+
+auto pack_unorm16(glm::vec4 value) -> Unorm16Vec4
+{
+    return Unorm16Vec4{
+        .x = quantize_unorm16(value.x),
+        .y = quantize_unorm16(value.y),
+        .z = quantize_unorm16(value.z),
+        .w = quantize_unorm16(value.w),
+    };
+}
+
+auto pack_snorm1010102(glm::vec4 value) -> Snorm1010102
+{
+    auto field = [](float component, u32 bit_count) {
+        return static_cast<u32>(quantize_snorm(component, bit_count)) & ((1u << bit_count) - 1);
+    };
+
+    return Snorm1010102{
+        .bits = field(value.x, 10) | field(value.y, 10) << 10 | field(value.z, 10) << 20 | field(value.w, 2) << 30,
+    };
+}
+
+auto unpack(HalfVec2 value) -> glm::vec2
+{
+    return glm::vec2{ half_to_float(value.x), half_to_float(value.y) };
+}
+
+auto unpack(HalfVec4 value) -> glm::vec4
+{
+    return glm::vec4{ half_to_float(value.x), half_to_float(value.y), half_to_float(value.z), half_to_float(value.w) };
+}
+
+auto unpack(Snorm16Vec2 value) -> glm::vec2
+{
+    return glm::vec2{ dequantize_snorm16(value.x), dequantize_snorm16(value.y) };
+}
+
+auto unpack(Snorm16Vec4 value) -> glm::vec4
+{
+    return glm::vec4{ dequantize_snorm16(value.x), dequantize_snorm16(value.y), dequantize_snorm16(value.z),
+                      dequantize_snorm16(value.w) };
+}
+
+auto unpack(Unorm16Vec2 value) -> glm::vec2
+{
+    return glm::vec2{ dequantize_unorm16(value.x), dequantize_unorm16(value.y) };
+}
+
+auto unpack(Unorm16Vec4 value) -> glm::vec4
+{
+    return glm::vec4{ dequantize_unorm16(value.x), dequantize_unorm16(value.y), dequantize_unorm16(value.z),
+                      dequantize_unorm16(value.w) };
+}
+
+auto unpack(Snorm1010102 value) -> glm::vec4
+{
+    return glm::vec4{
+        dequantize_snorm(extract_signed_field(value.bits, 0, 10), 10),
+        dequantize_snorm(extract_signed_field(value.bits, 10, 10), 10),
+        dequantize_snorm(extract_signed_field(value.bits, 20, 10), 10),
+        dequantize_snorm(extract_signed_field(value.bits, 30, 2), 2),
+    };
+}
+
+auto encode_octahedral(glm::vec3 unit_vector) -> glm::vec2
+{
+    auto manhattan_length = std::abs(unit_vector.x) + std::abs(unit_vector.y) + std::abs(unit_vector.z);
+
+    // Zero vectors don't have a direction, so they get an arbitrary one instead of NaNs.
+    if (manhattan_length == 0.0f)
+        return glm::vec2{ 0.0f };
+
+    auto projected = unit_vector / manhattan_length;
+    auto result = glm::vec2{ projected.x, projected.y };
+
+    // The lower half of the octahedron gets folded over the diagonals.
+    if (projected.z < 0.0f)
+        result = (1.0f - glm::abs(glm::vec2{ result.y, result.x })) * sign_not_zero(result);
+
+    return result;
+}
+
+auto decode_octahedral(glm::vec2 encoded) -> glm::vec3
+{
+    glm::vec3 result{ encoded.x, encoded.y, 1.0f - std::abs(encoded.x) - std::abs(encoded.y) };
+
+    // Unfolds the lower half of the octahedron.
+    auto fold = std::max(-result.z, 0.0f);
+    result.x += result.x >= 0.0f ? -fold : fold;
+    result.y += result.y >= 0.0f ? -fold : fold;
+
+    return glm::normalize(result);
+}
+
+auto pack_octahedral(glm::vec3 unit_vector) -> Snorm16Vec2
+{
+    return pack_snorm16(encode_octahedral(unit_vector));
+}
+
+auto unpack_octahedral(Snorm16Vec2 value) -> glm::vec3
+{
+    return decode_octahedral(unpack(value));
+}
+
+} // namespace zth::math
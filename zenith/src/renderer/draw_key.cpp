@@ -0,0 +1,86 @@
+#include "zenith/renderer/draw_key.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#include "zenith/core/assert.hpp"
+
+namespace zth {
+
+auto quantize_draw_key_depth(float view_depth, float near, float far) -> u16
+{
+    constexpr auto max_depth = static_cast<float>(std::numeric_limits<u16>::max());
+
+    if (far <= near)
+        return 0;
+
+    // A logarithm can't be taken of a near plane which isn't in front of the camera.
+    if (near <= 0.0f)
+        return static_cast<u16>(std::clamp((view_depth - near) / (far - near), 0.0f, 1.0f) * max_depth);
+
+    auto clamped_depth = std::clamp(view_depth, near, far);
+    auto normalized_depth = std::log(clamped_depth / near) / std::log(far / near);
+    return static_cast<u16>(std::clamp(normalized_depth, 0.0f, 1.0f) * max_depth);
+}
+
+auto radix_sort_draw_keys(std::span<DrawKeyEntry> entries, std::span<DrawKeyEntry> scratch) -> void
+{
+    // Least significant digit radix sort with 8-bit digits. All the histograms get built in a single pass over the
+    // entries, and passes in which every key has the same digit get skipped. In practice most of the key's bits are
+    // zero (there usually aren't many shaders, materials and vertex arrays), so only a few of the passes actually run.
+
+    constexpr usize digit_bits = 8;
+    constexpr usize bucket_count = usize{ 1 } << digit_bits;
+    constexpr usize digit_mask = bucket_count - 1;
+    constexpr usize pass_count = sizeof(DrawKey) * 8 / digit_bits;
+
+    ZTH_ASSERT(scratch.size() >= entries.size());
+    ZTH_ASSERT(entries.size() <= std::numeric_limits<u32>::max());
+
+    const auto count = entries.size();
+
+    if (count <= 1)
+        return;
+
+    std::array<std::array<u32, bucket_count>, pass_count> histograms{};
+
+    for (const auto& entry : entries)
+    {
+        for (usize pass = 0; pass < pass_count; pass++)
+            histograms[pass][(entry.key >> (pass * digit_bits)) & digit_mask]++;
+    }
+
+    auto source = entries.data();
+    auto destination = scratch.data();
+
+    for (usize pass = 0; pass < pass_count; pass++)
+    {
+        auto& offsets = histograms[pass];
+        const auto shift = pass * digit_bits;
+
+        // This pass wouldn't change the order of the entries.
+        if (offsets[(source[0].key >> shift) & digit_mask] == count)
+            continue;
+
+        u32 offset = 0;
+
+        for (auto& bucket : offsets)
+            offset += std::exchange(bucket, offset);
+
+        for (usize i = 0; i < count; i++)
+        {
+            const auto& entry = source[i];
+            destination[offsets[(entry.key >> shift) & digit_mask]++] = entry;
+        }
+
+        std::swap(source, destination);
+    }
+
+    if (source != entries.data())
+        std::copy_n(source, count, entries.data());
+}
+
+} // namespace zth
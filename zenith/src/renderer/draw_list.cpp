@@ -0,0 +1,133 @@
+#include "zenith/renderer/draw_list.hpp"
+
+#include <algorithm>
+
+#include "zenith/core/assert.hpp"
+#include "zenith/ecs/components.hpp"
+#include "zenith/renderer/mesh.hpp"
+#include "zenith/system/job_system.hpp"
+
+namespace zth {
+
+auto DrawList::submit(const Mesh& mesh, const glm::mat4& transform, const Material& material) -> void
+{
+    submit(mesh.vertex_array(), transform, material);
+}
+
+auto DrawList::submit(const gl::VertexArray& vertex_array, const glm::mat4& transform, const Material& material)
+    -> void
+{
+    auto first_transform = push_transforms(std::span{ &transform, 1 });
+    _entries.emplace_back(&vertex_array, &material, first_transform, 1);
+}
+
+auto DrawList::submit(const Mesh& mesh, const TransformComponent& transform, const Material& material) -> void
+{
+    submit(mesh.vertex_array(), transform, material);
+}
+
+auto DrawList::submit(const gl::VertexArray& vertex_array, const TransformComponent& transform,
+                      const Material& material) -> void
+{
+    // A transform set straight from a matrix might contain shear, which the rotation and the scale can't express.
+    if (!transform.is_composed())
+    {
+        submit(vertex_array, transform.transform(), material);
+        return;
+    }
+
+    auto first_transform = static_cast<u32>(_transforms.size());
+    _transforms.push_back(transform.transform());
+    _rotations.push_back(transform.rotation());
+    _scales.push_back(transform.scale());
+    _entries.emplace_back(&vertex_array, &material, first_transform, 1, true);
+}
+
+auto DrawList::submit_instances(const Mesh& mesh, const Material& material, std::span<const glm::mat4> transforms)
+    -> void
+{
+    submit_instances(mesh.vertex_array(), material, transforms);
+}
+
+auto DrawList::submit_instances(const gl::VertexArray& vertex_array, const Material& material,
+                                std::span<const glm::mat4> transforms) -> void
+{
+    if (transforms.empty())
+        return;
+
+    auto first_transform = push_transforms(transforms);
+    _entries.emplace_back(&vertex_array, &material, first_transform, static_cast<u32>(transforms.size()));
+}
+
+auto DrawList::clear() -> void
+{
+    _entries.clear();
+    _transforms.clear();
+    _rotations.clear();
+    _scales.clear();
+}
+
+auto DrawList::merge(std::span<const DrawList* const> draw_lists, Vector<DrawListEntry>& entries,
+                     Vector<glm::mat4>& transforms, Vector<glm::quat>& rotations, Vector<glm::vec3>& scales)
+    -> void
+{
+    ZTH_ASSERT(transforms.size() == rotations.size());
+    ZTH_ASSERT(transforms.size() == scales.size());
+
+    // Every list gets copied to its own part of the output, so the lists can be copied independently.
+    Vector<u32> entry_offsets;
+    Vector<u32> transform_offsets;
+    entry_offsets.reserve(draw_lists.size());
+    transform_offsets.reserve(draw_lists.size());
+
+    auto entry_count = static_cast<u32>(entries.size());
+    auto transform_count = static_cast<u32>(transforms.size());
+
+    for (const auto* draw_list : draw_lists)
+    {
+        entry_offsets.push_back(entry_count);
+        transform_offsets.push_back(transform_count);
+        entry_count += static_cast<u32>(draw_list->_entries.size());
+        transform_count += static_cast<u32>(draw_list->_transforms.size());
+    }
+
+    entries.resize(entry_count);
+    transforms.resize(transform_count);
+    rotations.resize(transform_count);
+    scales.resize(transform_count);
+
+    JobSystem::parallel_for(draw_lists.size(), 1, [&](usize begin, usize end) {
+        for (auto i = begin; i < end; i++)
+        {
+            draw_lists[i]->copy_to(entries.data() + entry_offsets[i], transforms.data() + transform_offsets[i],
+                                   rotations.data() + transform_offsets[i], scales.data() + transform_offsets[i],
+                                   transform_offsets[i]);
+        }
+    });
+}
+
+auto DrawList::push_transforms(std::span<const glm::mat4> transforms) -> u32
+{
+    auto first = static_cast<u32>(_transforms.size());
+
+    _transforms.insert(_transforms.end(), transforms.begin(), transforms.end());
+    _rotations.resize(_transforms.size());
+    _scales.resize(_transforms.size());
+
+    return first;
+}
+
+auto DrawList::copy_to(DrawListEntry* entries, glm::mat4* transforms, glm::quat* rotations, glm::vec3* scales,
+                       u32 transform_offset) const -> void
+{
+    std::ranges::transform(_entries, entries, [&](DrawListEntry entry) {
+        entry.first_transform += transform_offset;
+        return entry;
+    });
+
+    std::ranges::copy(_transforms, transforms);
+    std::ranges::copy(_rotations, rotations);
+    std::ranges::copy(_scales, scales);
+}
+
+} // namespace zth
@@ -0,0 +1,206 @@
+#include "zenith/renderer/geometry_pool.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+#include "zenith/core/assert.hpp"
+#include "zenith/core/profiler.hpp"
+
+namespace zth {
+
+namespace {
+
+// Takes the first free range which is large enough, or appends the range at the end.
+template<typename Range> auto allocate_range(Vector<Range>& free_ranges, u32& end, u32 count) -> Range
+{
+    auto fit = std::ranges::find_if(free_ranges, [&](const Range& range) { return range.count >= count; });
+
+    if (fit == free_ranges.end())
+    {
+        Range range{ .first = end, .count = count };
+        end += count;
+        return range;
+    }
+
+    Range range{ .first = fit->first, .count = count };
+    fit->first += count;
+    fit->count -= count;
+
+    if (fit->count == 0)
+        free_ranges.erase(fit);
+
+    return range;
+}
+
+// Merges the range with the adjacent free ranges. A free range which reaches the end gets cut off instead.
+template<typename Range> auto free_range(Vector<Range>& free_ranges, u32& end, Range range) -> void
+{
+    if (range.count == 0)
+        return;
+
+    auto next = std::ranges::lower_bound(free_ranges, range.first, {}, &Range::first);
+
+    if (next != free_ranges.end() && range.first + range.count == next->first)
+    {
+        range.count += next->count;
+        next = free_ranges.erase(next);
+    }
+
+    if (next != free_ranges.begin())
+    {
+        auto prev = std::prev(next);
+
+        if (prev->first + prev->count == range.first)
+        {
+            range.first = prev->first;
+            range.count += prev->count;
+            next = free_ranges.erase(prev);
+        }
+    }
+
+    if (range.first + range.count == end)
+    {
+        end = range.first;
+        return;
+    }
+
+    free_ranges.insert(next, range);
+}
+
+} // namespace
+
+GeometryPool::GeometryPool(std::initializer_list<const gl::InstanceBuffer*> instance_buffers)
+    : _instance_buffers{ instance_buffers }
+{}
+
+auto GeometryPool::get(const gl::VertexArray& vertex_array) -> Optional<PooledGeometry>
+{
+    const auto* vertex_buffer = vertex_array.vertex_buffer();
+    const auto* index_buffer = vertex_array.index_buffer();
+
+    if (!vertex_buffer || !index_buffer)
+        return nil;
+
+    if (std::ranges::find(_instance_buffers, vertex_array.instance_buffer()) == _instance_buffers.end())
+        return nil;
+
+    if (vertex_array.count() == 0)
+        return nil;
+
+    auto kv = _entries.find(&vertex_array);
+
+    if (kv != _entries.end())
+    {
+        const auto& entry = kv->second;
+
+        if (entry.generation != vertex_array.generation() || entry.instance_buffer != vertex_array.instance_buffer()
+            || entry.vertex_buffer_size_bytes != vertex_buffer->size_bytes()
+            || entry.indices.count != vertex_array.count())
+        {
+            free_geometry(entry);
+            _entries.erase(kv);
+            kv = _entries.end();
+        }
+    }
+
+    if (kv == _entries.end())
+        kv = _entries.emplace(&vertex_array, add(vertex_array)).first;
+
+    const auto& entry = kv->second;
+
+    return PooledGeometry{
+        .vertex_array = &entry.shared_geometry->vertex_array,
+        .first_index = entry.indices.first,
+        .index_count = entry.indices.count,
+        .base_vertex = static_cast<i32>(entry.vertices.first),
+    };
+}
+
+auto GeometryPool::release(const gl::VertexArray& vertex_array) -> void
+{
+    auto kv = _entries.find(&vertex_array);
+
+    if (kv == _entries.end())
+        return;
+
+    free_geometry(kv->second);
+    _entries.erase(kv);
+}
+
+auto GeometryPool::clear() -> void
+{
+    _entries.clear();
+    _shared_geometry.clear();
+}
+
+auto GeometryPool::find_or_create_shared_geometry(const gl::VertexLayout& layout, gl::DataType indexing_data_type,
+                                                  const gl::InstanceBuffer& instance_buffer) -> SharedGeometry&
+{
+    for (auto& shared_geometry : _shared_geometry)
+    {
+        if (shared_geometry->vertex_buffer.layout() == layout
+            && shared_geometry->index_buffer.indexing_data_type() == indexing_data_type
+            && shared_geometry->vertex_array.instance_buffer() == &instance_buffer)
+        {
+            return *shared_geometry;
+        }
+    }
+
+    auto shared_geometry = make_unique<SharedGeometry>();
+    shared_geometry->vertex_buffer = gl::VertexBuffer::create_dynamic(layout, gl::BufferUsage::static_draw);
+    shared_geometry->index_buffer = gl::IndexBuffer::create_dynamic(indexing_data_type, gl::BufferUsage::static_draw);
+
+    auto& vertex_array = shared_geometry->vertex_array;
+    vertex_array.bind_vertex_buffer(shared_geometry->vertex_buffer);
+    vertex_array.bind_index_buffer(shared_geometry->index_buffer);
+    vertex_array.bind_instance_buffer(instance_buffer);
+    vertex_array.rebind_layout();
+
+    _shared_geometry.push_back(std::move(shared_geometry));
+    return *_shared_geometry.back();
+}
+
+auto GeometryPool::add(const gl::VertexArray& vertex_array) -> Entry
+{
+    ZTH_PROFILE_FUNCTION();
+
+    const auto& vertex_buffer = *vertex_array.vertex_buffer();
+    const auto& index_buffer = *vertex_array.index_buffer();
+
+    ZTH_ASSERT(vertex_buffer.stride() != 0);
+
+    auto& shared_geometry = find_or_create_shared_geometry(vertex_buffer.layout(), index_buffer.indexing_data_type(),
+                                                           *vertex_array.instance_buffer());
+
+    const auto index_size = static_cast<u32>(gl::size_of_data_type(index_buffer.indexing_data_type()));
+    const auto vertex_count = vertex_buffer.count();
+    const auto index_count = vertex_array.count();
+
+    Entry entry = {
+        .generation = vertex_array.generation(),
+        .instance_buffer = vertex_array.instance_buffer(),
+        .vertex_buffer_size_bytes = vertex_buffer.size_bytes(),
+        .shared_geometry = &shared_geometry,
+        .vertices = allocate_range(shared_geometry.free_vertex_ranges, shared_geometry.vertex_count, vertex_count),
+        .indices = allocate_range(shared_geometry.free_index_ranges, shared_geometry.index_count, index_count),
+    };
+
+    // Indices don't have to be offset, as the draw commands specify the base vertex.
+    gl::copy_buffer_data_to_dynamic_buffer(shared_geometry.vertex_buffer, vertex_buffer,
+                                           vertex_count * vertex_buffer.stride(),
+                                           entry.vertices.first * vertex_buffer.stride());
+    gl::copy_buffer_data_to_dynamic_buffer(shared_geometry.index_buffer, index_buffer, index_count * index_size,
+                                           entry.indices.first * index_size);
+
+    return entry;
+}
+
+auto GeometryPool::free_geometry(const Entry& entry) -> void
+{
+    auto& shared_geometry = *entry.shared_geometry;
+    free_range(shared_geometry.free_vertex_ranges, shared_geometry.vertex_count, entry.vertices);
+    free_range(shared_geometry.free_index_ranges, shared_geometry.index_count, entry.indices);
+}
+
+} // namespace zth
@@ -6,6 +6,8 @@
 #include <ImGuizmo.h>
 
 #include "zenith/log/logger.hpp"
+#include "zenith/renderer/render_graph.hpp"
+#include "zenith/renderer/renderer.hpp"
 #include "zenith/system/window.hpp"
 
 namespace zth {
@@ -45,14 +47,23 @@ auto ImGuiRenderer::start_frame() -> void
 
 auto ImGuiRenderer::render() -> void
 {
+    // The draw data stays valid until the next frame starts, so it can be rendered once the frame graph gets executed.
     ImGui::Render();
-    ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 
-    ImGui::UpdatePlatformWindows();
-    ImGui::RenderPlatformWindowsDefault();
+    auto& graph = Renderer::frame_graph();
+    auto backbuffer = graph.backbuffer();
 
-    // Platform functions may change the current OpenGL context, so we need to restore it.
-    Window::make_context_current();
+    graph.add_pass(
+        "ImGui", [&](RenderGraphPassBuilder& builder) { builder.write_color(backbuffer); },
+        [](const RenderGraphPassContext&) {
+            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+
+            ImGui::UpdatePlatformWindows();
+            ImGui::RenderPlatformWindowsDefault();
+
+            // Platform functions may change the current OpenGL context, so we need to restore it.
+            Window::make_context_current();
+        });
 }
 
 auto ImGuiRenderer::shut_down() -> void
@@ -1,3 +1,28 @@
 #include "zenith/renderer/light.hpp"
 
+#include <glm/exponential.hpp>
+
+#include <limits>
+
+namespace zth {
+
+auto LightAttenuation::range(float min_strength) const -> float
+{
+    // Strength is 1 / (constant + linear * d + quadratic * d^2), so we're solving a quadratic equation for d.
+    auto c = constant - 1.0f / min_strength;
+
+    if (c >= 0.0f)
+        return 0.0f;
+
+    if (quadratic > 0.0f)
+        return (-linear + glm::sqrt(linear * linear - 4.0f * quadratic * c)) / (2.0f * quadratic);
+
+    if (linear > 0.0f)
+        return -c / linear;
+
+    return std::numeric_limits<float>::infinity();
+}
+
+} // namespace zth
+
 ZTH_DEFINE_REFLECTED_ENUM(zth::LightType);
@@ -0,0 +1,326 @@
+#include "zenith/renderer/light_clusters.hpp"
+
+#include <glm/common.hpp>
+#include <glm/exponential.hpp>
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include "zenith/core/assert.hpp"
+#include "zenith/system/job_system.hpp"
+#include "zenith/util/optional.hpp"
+
+namespace zth {
+
+namespace {
+
+struct TileRange
+{
+    u32 first;
+    u32 last;
+};
+
+auto intersects(const math::BoundingSphere& sphere, const math::Aabb& aabb) -> bool
+{
+    auto closest_point = glm::clamp(sphere.center, aabb.min, aabb.max);
+    auto offset = sphere.center - closest_point;
+    return glm::dot(offset, offset) <= sphere.radius * sphere.radius;
+}
+
+// Returns nil if the range lies entirely outside of [-1, 1].
+auto ndc_range_to_tiles(float ndc_min, float ndc_max, u32 tile_count) -> Optional<TileRange>
+{
+    if (ndc_max < -1.0f || ndc_min > 1.0f)
+        return nil;
+
+    auto to_tile = [&](float ndc) {
+        auto tile = glm::floor((ndc * 0.5f + 0.5f) * static_cast<float>(tile_count));
+        return static_cast<u32>(std::clamp(tile, 0.0f, static_cast<float>(tile_count - 1)));
+    };
+
+    return TileRange{ .first = to_tile(ndc_min), .last = to_tile(ndc_max) };
+}
+
+} // namespace
+
+LightClusterGrid::LightClusterGrid(glm::uvec3 size) : _size{ size }
+{
+    ZTH_ASSERT(size.x > 0 && size.y > 0 && size.z > 0);
+}
+
+auto LightClusterGrid::build(const glm::mat4& projection, float near, float far,
+                             std::span<const math::BoundingSphere> point_lights,
+                             std::span<const math::BoundingSphere> spot_lights) -> void
+{
+    ZTH_ASSERT(near > 0.0f && far > near);
+
+    if (projection != _projection || near != _near || far != _far)
+    {
+        _projection = projection;
+        _near = near;
+        _far = far;
+
+        auto log_depth_ratio = glm::log(far / near);
+        _depth_slice_scale = static_cast<float>(_size.z) / log_depth_ratio;
+        _depth_slice_bias = -static_cast<float>(_size.z) * glm::log(near) / log_depth_ratio;
+
+        compute_cluster_bounds();
+    }
+
+    _lights.clear();
+    _lights.insert(_lights.end(), point_lights.begin(), point_lights.end());
+    _lights.insert(_lights.end(), spot_lights.begin(), spot_lights.end());
+
+    _light_slices.clear();
+
+    for (const auto& light : _lights)
+    {
+        auto depth = -light.center.z;
+        auto min_depth = depth - light.radius;
+        auto max_depth = depth + light.radius;
+
+        if (max_depth < near || min_depth > far)
+        {
+            _light_slices.push_back(LightSlices{ .first = 1, .last = 0 }); // Doesn't affect any slice.
+            continue;
+        }
+
+        _light_slices.push_back(LightSlices{
+            .first = slice_at_depth(std::max(min_depth, near)),
+            .last = slice_at_depth(std::min(max_depth, far)),
+        });
+    }
+
+    auto point_light_count = static_cast<u32>(point_lights.size());
+    _slice_bins.resize(_size.z);
+
+    JobSystem::parallel_for(_size.z, 1, [&](usize begin, usize end) {
+        for (auto slice = begin; slice < end; slice++)
+            bin_slice(static_cast<u32>(slice), point_light_count);
+    });
+
+    const auto tiles_per_slice = _size.x * _size.y;
+
+    _clusters.resize(cluster_count());
+    _light_indices.clear();
+
+    for (u32 slice = 0; slice < _size.z; slice++)
+    {
+        const auto& bins = _slice_bins[slice];
+        auto first_light_index = static_cast<u32>(_light_indices.size());
+
+        for (u32 tile = 0; tile < tiles_per_slice; tile++)
+        {
+            _clusters[slice * tiles_per_slice + tile] = LightCluster{
+                .first_light_index = first_light_index + bins.offsets[tile],
+                .point_light_count = bins.point_counts[tile],
+                .spot_light_count = bins.counts[tile] - bins.point_counts[tile],
+            };
+        }
+
+        _light_indices.insert(_light_indices.end(), bins.light_indices.begin(), bins.light_indices.end());
+    }
+}
+
+auto LightClusterGrid::slice_at_depth(float depth) const -> u32
+{
+    if (depth <= 0.0f)
+        return 0;
+
+    auto slice = glm::floor(glm::log(depth) * _depth_slice_scale + _depth_slice_bias);
+    return static_cast<u32>(std::clamp(slice, 0.0f, static_cast<float>(_size.z - 1)));
+}
+
+auto LightClusterGrid::stats() const -> LightClusterStats
+{
+    LightClusterStats result{
+        .cluster_count = cluster_count(),
+        .light_index_count = static_cast<u32>(_light_indices.size()),
+    };
+
+    for (const auto& cluster : _clusters)
+    {
+        auto light_count = cluster.point_light_count + cluster.spot_light_count;
+
+        if (light_count == 0)
+            continue;
+
+        result.occupied_clusters++;
+        result.max_lights_per_cluster = std::max(result.max_lights_per_cluster, light_count);
+    }
+
+    if (result.occupied_clusters > 0)
+    {
+        result.average_lights_per_occupied_cluster =
+            static_cast<float>(result.light_index_count) / static_cast<float>(result.occupied_clusters);
+    }
+
+    return result;
+}
+
+auto LightClusterGrid::compute_cluster_bounds() -> void
+{
+    // A point in view space at depth d which gets projected to ndc (nx, ny) lies at
+    // x = (nx + P[2][0]) * d / P[0][0], y = (ny + P[2][1]) * d / P[1][1].
+
+    _cluster_bounds.resize(cluster_count());
+
+    auto slice_depth = [&](u32 slice) {
+        return _near * glm::pow(_far / _near, static_cast<float>(slice) / static_cast<float>(_size.z));
+    };
+
+    auto tile_ndc = [](u32 tile, u32 tile_count) {
+        return -1.0f + 2.0f * static_cast<float>(tile) / static_cast<float>(tile_count);
+    };
+
+    for (u32 slice = 0; slice < _size.z; slice++)
+    {
+        auto near_depth = slice_depth(slice);
+        auto far_depth = slice_depth(slice + 1);
+
+        for (u32 y = 0; y < _size.y; y++)
+        {
+            auto ndc_y_min = tile_ndc(y, _size.y) + _projection[2][1];
+            auto ndc_y_max = tile_ndc(y + 1, _size.y) + _projection[2][1];
+
+            std::array ys{ ndc_y_min * near_depth, ndc_y_min * far_depth, ndc_y_max * near_depth,
+                           ndc_y_max * far_depth };
+
+            for (u32 x = 0; x < _size.x; x++)
+            {
+                auto ndc_x_min = tile_ndc(x, _size.x) + _projection[2][0];
+                auto ndc_x_max = tile_ndc(x + 1, _size.x) + _projection[2][0];
+
+                std::array xs{ ndc_x_min * near_depth, ndc_x_min * far_depth, ndc_x_max * near_depth,
+                               ndc_x_max * far_depth };
+
+                auto [min_x, max_x] = std::ranges::minmax(xs);
+                auto [min_y, max_y] = std::ranges::minmax(ys);
+
+                _cluster_bounds[cluster_index(x, y, slice)] = math::Aabb{
+                    .min = glm::vec3{ min_x / _projection[0][0], min_y / _projection[1][1], -far_depth },
+                    .max = glm::vec3{ max_x / _projection[0][0], max_y / _projection[1][1], -near_depth },
+                };
+            }
+        }
+    }
+}
+
+auto LightClusterGrid::bin_slice(u32 slice, u32 point_light_count) -> void
+{
+    // Collects (cluster, light) pairs and then sorts them by cluster with a counting sort. The sort is stable, so point
+    // lights stay ahead of spot lights within every cluster.
+
+    const auto tiles_per_slice = _size.x * _size.y;
+    auto& bins = _slice_bins[slice];
+
+    bins.pair_clusters.clear();
+    bins.pair_lights.clear();
+    bins.counts.assign(tiles_per_slice, 0);
+    bins.point_counts.assign(tiles_per_slice, 0);
+    bins.offsets.resize(tiles_per_slice);
+
+    auto slice_near_depth = -_cluster_bounds[cluster_index(0, 0, slice)].max.z;
+    auto slice_far_depth = -_cluster_bounds[cluster_index(0, 0, slice)].min.z;
+
+    auto ndc_x = [&](float x, float depth) { return _projection[0][0] * x / depth - _projection[2][0]; };
+    auto ndc_y = [&](float y, float depth) { return _projection[1][1] * y / depth - _projection[2][1]; };
+
+    for (u32 light_index = 0; light_index < _lights.size(); light_index++)
+    {
+        auto [first_slice, last_slice] = _light_slices[light_index];
+
+        if (slice < first_slice || slice > last_slice)
+            continue;
+
+        const auto& light = _lights[light_index];
+
+        // Conservative screen-space bounds of the part of the sphere which lies within the slice. The sphere's
+        // horizontal extent projects furthest out at either end of its depth range within the slice.
+        auto depth = -light.center.z;
+        auto min_depth = std::max(slice_near_depth, depth - light.radius);
+        auto max_depth = std::min(slice_far_depth, depth + light.radius);
+
+        auto left = light.center.x - light.radius;
+        auto right = light.center.x + light.radius;
+        auto bottom = light.center.y - light.radius;
+        auto top = light.center.y + light.radius;
+
+        auto x_tiles = ndc_range_to_tiles(std::min(ndc_x(left, min_depth), ndc_x(left, max_depth)),
+                                          std::max(ndc_x(right, min_depth), ndc_x(right, max_depth)), _size.x);
+        auto y_tiles = ndc_range_to_tiles(std::min(ndc_y(bottom, min_depth), ndc_y(bottom, max_depth)),
+                                          std::max(ndc_y(top, min_depth), ndc_y(top, max_depth)), _size.y);
+
+        if (!x_tiles || !y_tiles)
+            continue;
+
+        for (auto y = y_tiles->first; y <= y_tiles->last; y++)
+        {
+            for (auto x = x_tiles->first; x <= x_tiles->last; x++)
+            {
+                if (!intersects(light, _cluster_bounds[cluster_index(x, y, slice)]))
+                    continue;
+
+                auto tile = y * _size.x + x;
+
+                bins.pair_clusters.push_back(tile);
+                bins.pair_lights.push_back(light_index);
+                bins.counts[tile]++;
+
+                if (light_index < point_light_count)
+                    bins.point_counts[tile]++;
+            }
+        }
+    }
+
+    u32 offset = 0;
+
+    for (u32 tile = 0; tile < tiles_per_slice; tile++)
+    {
+        bins.offsets[tile] = offset;
+        offset += bins.counts[tile];
+    }
+
+    bins.light_indices.resize(bins.pair_lights.size());
+
+    for (usize i = 0; i < bins.pair_lights.size(); i++)
+    {
+        auto tile = bins.pair_clusters[i];
+        auto light_index = bins.pair_lights[i];
+
+        bins.light_indices[bins.offsets[tile]++] =
+            light_index < point_light_count ? light_index : light_index - point_light_count;
+    }
+
+    for (u32 tile = 0; tile < tiles_per_slice; tile++)
+        bins.offsets[tile] -= bins.counts[tile];
+}
+
+auto spot_light_bounds(glm::vec3 position, glm::vec3 direction, float range, float outer_cutoff_cosine)
+    -> math::BoundingSphere
+{
+    // The lit region is a cone with a spherical cap. Wide cones are bounded best by the sphere around the cap's base,
+    // narrow ones by the sphere which passes through the apex and the edge of the cap.
+
+    constexpr auto cos_45_degrees = 0.70710678f;
+
+    if (outer_cutoff_cosine <= 0.0f || std::isinf(range))
+        return math::BoundingSphere{ .center = position, .radius = range };
+
+    if (outer_cutoff_cosine >= cos_45_degrees)
+    {
+        auto radius = range / (2.0f * outer_cutoff_cosine);
+        return math::BoundingSphere{ .center = position + direction * radius, .radius = radius };
+    }
+
+    auto outer_cutoff_sine = glm::sqrt(1.0f - outer_cutoff_cosine * outer_cutoff_cosine);
+
+    return math::BoundingSphere{
+        .center = position + direction * range * outer_cutoff_cosine,
+        .radius = range * outer_cutoff_sine,
+    };
+}
+
+} // namespace zth
@@ -0,0 +1,116 @@
+#include "zenith/renderer/mesh_lod.hpp"
+
+#include <glm/geometric.hpp>
+#include <glm/trigonometric.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include "zenith/core/assert.hpp"
+#include "zenith/renderer/mesh_optimizer.hpp"
+#include "zenith/renderer/mesh_simplifier.hpp"
+
+namespace zth {
+
+MeshLod::MeshLod(Vector<MeshLodLevel>&& levels) : _levels{ std::move(levels) }
+{
+    ZTH_ASSERT(!_levels.empty());
+
+    for (usize i = 0; i < _levels.size(); i++)
+    {
+        ZTH_ASSERT(_levels[i].mesh != nullptr);
+        ZTH_ASSERT(i == 0 || _levels[i].min_screen_size <= _levels[i - 1].min_screen_size);
+    }
+}
+
+auto MeshLod::generate(const std::shared_ptr<const IndexedMesh<StandardVertex, u32>>& mesh,
+                       const MeshLodSettings& settings) -> MeshLod
+{
+    ZTH_ASSERT(mesh != nullptr);
+    ZTH_ASSERT(settings.level_count > 0);
+
+    // A level which doesn't get rid of at least this fraction of the previous level's triangles isn't worth it.
+    constexpr auto min_triangle_reduction = 0.1f;
+
+    const auto& vertices = mesh->vertices();
+    auto max_error = settings.max_error * mesh->bounding_sphere().radius;
+
+    Vector<MeshLodLevel> levels;
+    levels.push_back(MeshLodLevel{ .mesh = mesh, .min_screen_size = settings.first_min_screen_size });
+
+    // Every level gets simplified from the previous one, which is faster than starting over from the source mesh.
+    auto indices = mesh->indices();
+
+    for (u32 level = 1; level < settings.level_count; level++)
+    {
+        auto triangle_count = static_cast<float>(indices.size() / 3);
+        auto target_index_count = static_cast<usize>(triangle_count * settings.triangle_ratio) * 3;
+        auto simplified = simplify_mesh(vertices, indices, target_index_count, max_error);
+
+        if (static_cast<float>(simplified.indices.size() / 3) > triangle_count * (1.0f - min_triangle_reduction))
+            break;
+
+        indices = std::move(simplified.indices);
+
+        // Also gets rid of the vertices which the level doesn't use anymore.
+        auto level_vertices = vertices;
+        auto level_indices = indices;
+        optimize_mesh(level_vertices, level_indices);
+
+        levels.push_back(MeshLodLevel{
+            .mesh = std::make_shared<const IndexedMesh<StandardVertex, u32>>(level_vertices, level_indices),
+            .min_screen_size = levels.back().min_screen_size * settings.min_screen_size_ratio,
+        });
+    }
+
+    levels.back().min_screen_size = 0.0f;
+    return MeshLod{ std::move(levels) };
+}
+
+auto MeshLod::bounding_sphere() const -> const math::BoundingSphere&
+{
+    return _levels.front().mesh->bounding_sphere();
+}
+
+auto MeshLod::select_level(float screen_size, u32 current_level, float hysteresis) const -> u32
+{
+    return select_lod_level(_levels, screen_size, current_level, hysteresis);
+}
+
+auto select_lod_level(std::span<const MeshLodLevel> levels, float screen_size, u32 current_level, float hysteresis)
+    -> u32
+{
+    ZTH_ASSERT(!levels.empty());
+
+    // Returns the first level whose min screen size, scaled by threshold_scale, the mesh covers.
+    auto level_for = [&](float threshold_scale) {
+        for (u32 level = 0; level < levels.size(); level++)
+        {
+            if (screen_size >= levels[level].min_screen_size * threshold_scale)
+                return level;
+        }
+
+        return static_cast<u32>(levels.size() - 1);
+    };
+
+    // A mesh only moves on to a coarser level once it gets smaller than the threshold lowered by the hysteresis, and
+    // only moves back to a finer level once it gets bigger than the threshold raised by the hysteresis. In between, it
+    // keeps its current level.
+    auto finest_level = level_for(1.0f - hysteresis);
+    auto coarsest_level = level_for(1.0f + hysteresis);
+    return std::clamp(current_level, finest_level, coarsest_level);
+}
+
+auto lod_screen_size(const math::BoundingSphere& world_bounds, glm::vec3 camera_position, float fov) -> float
+{
+    auto distance = glm::distance(world_bounds.center, camera_position);
+
+    if (distance <= world_bounds.radius)
+        return std::numeric_limits<float>::infinity();
+
+    // The sphere's diameter over the height of the view frustum at the sphere's distance.
+    return world_bounds.radius / (distance * glm::tan(fov * 0.5f));
+}
+
+} // namespace zth
@@ -0,0 +1,472 @@
+#include "zenith/renderer/mesh_optimizer.hpp"
+
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#include "zenith/core/assert.hpp"
+
+namespace zth {
+
+namespace {
+
+// Simulates a FIFO post-transform cache. Every vertex remembers when it got put into the cache, and it's still there if
+// fewer than cache_size other vertices have been put into the cache since then.
+class FifoCache
+{
+public:
+    explicit FifoCache(usize vertex_count, u32 cache_size)
+        : _timestamps(vertex_count, 0), _time{ cache_size + 1 }, _cache_size{ cache_size }
+    {}
+
+    // Returns whether the vertex had to be transformed.
+    auto access(u32 vertex) -> bool
+    {
+        ZTH_ASSERT(vertex < _timestamps.size());
+
+        if (_time - _timestamps[vertex] <= _cache_size)
+            return false;
+
+        _timestamps[vertex] = _time++;
+        return true;
+    }
+
+    auto access_triangle(std::span<const u32> indices, usize triangle) -> u32
+    {
+        auto misses = 0u;
+
+        for (usize corner = 0; corner < 3; corner++)
+        {
+            if (access(indices[triangle * 3 + corner]))
+                misses++;
+        }
+
+        return misses;
+    }
+
+    auto clear() -> void { _time += _cache_size + 1; }
+
+private:
+    Vector<u32> _timestamps;
+    u32 _time;
+    u32 _cache_size;
+};
+
+// The constants of Tom Forsyth's scoring function, from the original article.
+constexpr u32 max_cache_size = 32;
+constexpr float cache_decay_power = 1.5f;
+constexpr float last_triangle_score = 0.75f;
+constexpr float valence_boost_scale = 2.0f;
+constexpr float valence_boost_power = 0.5f;
+constexpr u32 valence_score_table_size = 32;
+
+constexpr auto no_triangle = std::numeric_limits<usize>::max();
+
+auto contains(std::span<const u32> vertices, u32 vertex) -> bool
+{
+    return std::ranges::find(vertices, vertex) != vertices.end();
+}
+
+class VertexScorer
+{
+public:
+    VertexScorer()
+    {
+        for (u32 position = 0; position < max_cache_size; position++)
+        {
+            // The vertices of the last triangle get a fixed score, so that the next triangle doesn't just reuse the
+            // edge which was just drawn.
+            if (position < 3)
+            {
+                _cache_scores[position] = last_triangle_score;
+                continue;
+            }
+
+            auto scale = 1.0f / static_cast<float>(max_cache_size - 3);
+            _cache_scores[position] = std::pow(1.0f - static_cast<float>(position - 3) * scale, cache_decay_power);
+        }
+
+        for (u32 valence = 1; valence < valence_score_table_size; valence++)
+            _valence_scores[valence] = valence_score(valence);
+    }
+
+    // cache_position is negative for vertices which aren't in the cache.
+    [[nodiscard]] auto score(i32 cache_position, u32 remaining_triangles) const -> float
+    {
+        // Vertices without any triangles left don't matter anymore.
+        if (remaining_triangles == 0)
+            return -1.0f;
+
+        auto result = cache_position >= 0 ? _cache_scores[static_cast<usize>(cache_position)] : 0.0f;
+
+        // Vertices with only a few triangles left get boosted, so that they get finished off and don't keep coming
+        // back.
+        if (remaining_triangles < valence_score_table_size)
+            result += _valence_scores[remaining_triangles];
+        else
+            result += valence_score(remaining_triangles);
+
+        return result;
+    }
+
+private:
+    std::array<float, max_cache_size> _cache_scores{};
+    std::array<float, valence_score_table_size> _valence_scores{};
+
+private:
+    [[nodiscard]] static auto valence_score(u32 remaining_triangles) -> float
+    {
+        return valence_boost_scale * std::pow(static_cast<float>(remaining_triangles), -valence_boost_power);
+    }
+};
+
+// Returns the index of the first triangle of every cluster, followed by the triangle count. Clusters first get split
+// wherever the vertex cache would be cold anyway (every vertex of a triangle misses the cache), and then further
+// wherever the ACMR of the part of the cluster before the split doesn't go over the cluster's ACMR times threshold.
+auto split_into_clusters(std::span<const u32> indices, usize vertex_count, float threshold) -> Vector<u32>
+{
+    auto triangle_count = indices.size() / 3;
+    FifoCache cache{ vertex_count, default_vertex_cache_size };
+
+    Vector<u32> hard_boundaries;
+
+    for (usize triangle = 0; triangle < triangle_count; triangle++)
+    {
+        if (cache.access_triangle(indices, triangle) == 3 || triangle == 0)
+            hard_boundaries.push_back(static_cast<u32>(triangle));
+    }
+
+    hard_boundaries.push_back(static_cast<u32>(triangle_count));
+
+    Vector<u32> result;
+
+    for (usize cluster = 0; cluster + 1 < hard_boundaries.size(); cluster++)
+    {
+        auto begin = hard_boundaries[cluster];
+        auto end = hard_boundaries[cluster + 1];
+
+        cache.clear();
+        auto cluster_misses = 0u;
+
+        for (auto triangle = begin; triangle < end; triangle++)
+            cluster_misses += cache.access_triangle(indices, triangle);
+
+        auto max_acmr = static_cast<float>(cluster_misses) / static_cast<float>(end - begin) * threshold;
+
+        cache.clear();
+        result.push_back(begin);
+
+        auto start = begin;
+        auto misses = 0u;
+
+        for (auto triangle = begin; triangle + 1 < end; triangle++)
+        {
+            misses += cache.access_triangle(indices, triangle);
+
+            if (static_cast<float>(misses) <= max_acmr * static_cast<float>(triangle + 1 - start))
+            {
+                start = triangle + 1;
+                misses = 0;
+                cache.clear();
+                result.push_back(start);
+            }
+        }
+    }
+
+    result.push_back(static_cast<u32>(triangle_count));
+    return result;
+}
+
+} // namespace
+
+auto analyze_vertex_cache(std::span<const u32> indices, usize vertex_count, u32 cache_size) -> VertexCacheStats
+{
+    ZTH_ASSERT(indices.size() % 3 == 0);
+    ZTH_ASSERT(cache_size > 0);
+
+    if (indices.empty())
+        return VertexCacheStats{};
+
+    FifoCache cache{ vertex_count, cache_size };
+    Vector<bool> used(vertex_count, false);
+
+    usize misses = 0;
+    usize used_vertex_count = 0;
+
+    for (auto index : indices)
+    {
+        if (cache.access(index))
+            misses++;
+
+        if (!used[index])
+        {
+            used[index] = true;
+            used_vertex_count++;
+        }
+    }
+
+    return VertexCacheStats{
+        .acmr = static_cast<float>(misses) / static_cast<float>(indices.size() / 3),
+        .atvr = static_cast<float>(misses) / static_cast<float>(used_vertex_count),
+    };
+}
+
+auto optimize_vertex_cache(std::span<u32> indices, usize vertex_count) -> void
+{
+    ZTH_ASSERT(indices.size() % 3 == 0);
+
+    auto triangle_count = indices.size() / 3;
+
+    if (triangle_count == 0)
+        return;
+
+    // The triangles around vertex v which haven't been emitted yet are vertex_triangles[triangle_offsets[v],
+    // triangle_offsets[v] + remaining_triangles[v]).
+    Vector<u32> remaining_triangles(vertex_count, 0);
+    Vector<u32> triangle_offsets(vertex_count, 0);
+    Vector<u32> vertex_triangles(indices.size());
+
+    for (auto index : indices)
+    {
+        ZTH_ASSERT(index < vertex_count);
+        remaining_triangles[index]++;
+    }
+
+    for (usize vertex = 0, offset = 0; vertex < vertex_count; vertex++)
+    {
+        triangle_offsets[vertex] = static_cast<u32>(offset);
+        offset += remaining_triangles[vertex];
+    }
+
+    {
+        Vector<u32> filled(vertex_count, 0);
+
+        for (usize i = 0; i < indices.size(); i++)
+        {
+            auto vertex = indices[i];
+            vertex_triangles[triangle_offsets[vertex] + filled[vertex]++] = static_cast<u32>(i / 3);
+        }
+    }
+
+    const VertexScorer scorer;
+
+    Vector<i32> cache_positions(vertex_count, -1);
+    Vector<float> vertex_scores(vertex_count);
+    Vector<float> triangle_scores(triangle_count);
+    Vector<bool> emitted(triangle_count, false);
+
+    for (usize vertex = 0; vertex < vertex_count; vertex++)
+        vertex_scores[vertex] = scorer.score(-1, remaining_triangles[vertex]);
+
+    auto triangle_score = [&](usize triangle) {
+        return vertex_scores[indices[triangle * 3]] + vertex_scores[indices[triangle * 3 + 1]]
+               + vertex_scores[indices[triangle * 3 + 2]];
+    };
+
+    auto best_triangle = usize{ 0 };
+
+    for (usize triangle = 0; triangle < triangle_count; triangle++)
+    {
+        triangle_scores[triangle] = triangle_score(triangle);
+
+        if (triangle_scores[triangle] > triangle_scores[best_triangle])
+            best_triangle = triangle;
+    }
+
+    // The 3 vertices of the emitted triangle can push up to 3 vertices out of the cache.
+    std::array<u32, max_cache_size + 3> cache{};
+    std::array<u32, max_cache_size + 3> new_cache{};
+    usize cache_size = 0;
+
+    Vector<u32> result;
+    result.reserve(indices.size());
+
+    usize first_unemitted = 0;
+
+    for (usize emitted_count = 0; emitted_count < triangle_count; emitted_count++)
+    {
+        // None of the cached vertices have any triangles left, so start over from the first triangle which hasn't been
+        // emitted yet.
+        if (best_triangle == no_triangle)
+        {
+            while (emitted[first_unemitted])
+                first_unemitted++;
+
+            best_triangle = first_unemitted;
+        }
+
+        auto triangle = std::exchange(best_triangle, no_triangle);
+        emitted[triangle] = true;
+
+        usize new_cache_size = 0;
+
+        for (usize corner = 0; corner < 3; corner++)
+        {
+            auto vertex = indices[triangle * 3 + corner];
+            result.push_back(vertex);
+
+            auto first = vertex_triangles.begin() + triangle_offsets[vertex];
+            auto last = first + remaining_triangles[vertex]--;
+            std::iter_swap(std::find(first, last, static_cast<u32>(triangle)), last - 1);
+
+            if (!contains(std::span{ new_cache }.first(new_cache_size), vertex))
+                new_cache[new_cache_size++] = vertex;
+        }
+
+        auto triangle_vertices = std::span{ new_cache }.first(new_cache_size);
+
+        for (auto vertex : std::span{ cache }.first(cache_size))
+        {
+            if (!contains(triangle_vertices, vertex))
+                new_cache[new_cache_size++] = vertex;
+        }
+
+        // The vertices past max_cache_size just got pushed out of the cache, but they still need their scores updated.
+        for (usize i = 0; i < new_cache_size; i++)
+        {
+            auto vertex = new_cache[i];
+            cache_positions[vertex] = i < max_cache_size ? static_cast<i32>(i) : -1;
+            vertex_scores[vertex] = scorer.score(cache_positions[vertex], remaining_triangles[vertex]);
+        }
+
+        // Only the triangles around the vertices whose scores changed can have their scores changed, and the next
+        // triangle is picked from among them.
+        auto best_score = -1.0f;
+
+        for (usize i = 0; i < new_cache_size; i++)
+        {
+            auto vertex = new_cache[i];
+            auto first = triangle_offsets[vertex];
+
+            for (auto j = first; j < first + remaining_triangles[vertex]; j++)
+            {
+                auto neighbour = vertex_triangles[j];
+                triangle_scores[neighbour] = triangle_score(neighbour);
+
+                if (triangle_scores[neighbour] > best_score)
+                {
+                    best_score = triangle_scores[neighbour];
+                    best_triangle = neighbour;
+                }
+            }
+        }
+
+        cache_size = std::min(new_cache_size, usize{ max_cache_size });
+        std::copy_n(new_cache.begin(), cache_size, cache.begin());
+    }
+
+    std::ranges::copy(result, indices.begin());
+}
+
+auto optimize_overdraw(std::span<u32> indices, std::span<const glm::vec3> positions, float threshold) -> void
+{
+    ZTH_ASSERT(indices.size() % 3 == 0);
+    ZTH_ASSERT(threshold >= 1.0f);
+
+    auto triangle_count = indices.size() / 3;
+
+    if (triangle_count <= 1)
+        return;
+
+    auto cluster_boundaries = split_into_clusters(indices, positions.size(), threshold);
+
+    struct Cluster
+    {
+        u32 begin;
+        u32 end;
+        // How far out the cluster sits in the direction it faces. Clusters which sit further out are less likely to be
+        // occluded by the rest of the mesh, and more likely to occlude it themselves.
+        float sort_key;
+    };
+
+    struct ClusterGeometry
+    {
+        glm::vec3 weighted_centroid{ 0.0f };
+        glm::vec3 weighted_normal{ 0.0f };
+        float area = 0.0f;
+    };
+
+    auto cluster_count = cluster_boundaries.size() - 1;
+    Vector<ClusterGeometry> geometry(cluster_count);
+    ClusterGeometry mesh_geometry;
+
+    for (usize cluster = 0; cluster < cluster_count; cluster++)
+    {
+        for (auto triangle = cluster_boundaries[cluster]; triangle < cluster_boundaries[cluster + 1]; triangle++)
+        {
+            auto a = positions[indices[triangle * 3]];
+            auto b = positions[indices[triangle * 3 + 1]];
+            auto c = positions[indices[triangle * 3 + 2]];
+
+            // The length of the cross product is twice the triangle's area, which weighs the normals by area as well.
+            auto normal = glm::cross(b - a, c - a);
+            auto area = glm::length(normal) * 0.5f;
+            auto centroid = (a + b + c) / 3.0f;
+
+            geometry[cluster].weighted_centroid += centroid * area;
+            geometry[cluster].weighted_normal += normal;
+            geometry[cluster].area += area;
+        }
+
+        mesh_geometry.weighted_centroid += geometry[cluster].weighted_centroid;
+        mesh_geometry.area += geometry[cluster].area;
+    }
+
+    if (mesh_geometry.area <= 0.0f)
+        return;
+
+    auto mesh_centroid = mesh_geometry.weighted_centroid / mesh_geometry.area;
+
+    Vector<Cluster> clusters;
+    clusters.reserve(cluster_count);
+
+    for (usize cluster = 0; cluster < cluster_count; cluster++)
+    {
+        auto [weighted_centroid, weighted_normal, area] = geometry[cluster];
+        auto normal_length = glm::length(weighted_normal);
+        auto sort_key = 0.0f;
+
+        if (area > 0.0f && normal_length > 0.0f)
+            sort_key = glm::dot(weighted_centroid / area - mesh_centroid, weighted_normal / normal_length);
+
+        clusters.push_back(Cluster{
+            .begin = cluster_boundaries[cluster],
+            .end = cluster_boundaries[cluster + 1],
+            .sort_key = sort_key,
+        });
+    }
+
+    std::ranges::stable_sort(clusters, std::ranges::greater{}, &Cluster::sort_key);
+
+    Vector<u32> result;
+    result.reserve(indices.size());
+
+    for (const auto& cluster : clusters)
+        result.insert(result.end(), indices.begin() + cluster.begin * 3, indices.begin() + cluster.end * 3);
+
+    std::ranges::copy(result, indices.begin());
+}
+
+auto remap_for_vertex_fetch(std::span<u32> indices, usize vertex_count) -> Vector<u32>
+{
+    Vector<u32> remap(vertex_count, unused_vertex);
+    u32 next_vertex = 0;
+
+    for (auto& index : indices)
+    {
+        ZTH_ASSERT(index < vertex_count);
+
+        if (remap[index] == unused_vertex)
+            remap[index] = next_vertex++;
+
+        index = remap[index];
+    }
+
+    return remap;
+}
+
+} // namespace zth
@@ -0,0 +1,463 @@
+#include "zenith/renderer/mesh_simplifier.hpp"
+
+#include <glm/geometric.hpp>
+#include <glm/vec3.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "zenith/stl/map.hpp"
+
+namespace zth {
+
+namespace {
+
+// A symmetric 4x4 matrix which sums up the weighted squared distances to a set of planes.
+struct Quadric
+{
+    double a00 = 0.0, a01 = 0.0, a02 = 0.0, a03 = 0.0;
+    double a11 = 0.0, a12 = 0.0, a13 = 0.0;
+    double a22 = 0.0, a23 = 0.0;
+    double a33 = 0.0;
+    double weight = 0.0;
+
+    auto operator+=(const Quadric& other) -> Quadric&
+    {
+        a00 += other.a00;
+        a01 += other.a01;
+        a02 += other.a02;
+        a03 += other.a03;
+        a11 += other.a11;
+        a12 += other.a12;
+        a13 += other.a13;
+        a22 += other.a22;
+        a23 += other.a23;
+        a33 += other.a33;
+        weight += other.weight;
+        return *this;
+    }
+};
+
+struct Collapse
+{
+    u32 from;
+    u32 to;
+    double cost;
+};
+
+// The plane is the set of points p where dot(normal, p) + distance == 0. normal must be normalized.
+auto plane_quadric(glm::dvec3 normal, double distance, double weight) -> Quadric
+{
+    auto a = normal.x;
+    auto b = normal.y;
+    auto c = normal.z;
+    auto d = distance;
+
+    return Quadric{
+        .a00 = weight * a * a,
+        .a01 = weight * a * b,
+        .a02 = weight * a * c,
+        .a03 = weight * a * d,
+        .a11 = weight * b * b,
+        .a12 = weight * b * c,
+        .a13 = weight * b * d,
+        .a22 = weight * c * c,
+        .a23 = weight * c * d,
+        .a33 = weight * d * d,
+        .weight = weight,
+    };
+}
+
+// Returns the weighted average of the squared distances to the planes.
+auto evaluate(const Quadric& quadric, glm::vec3 point) -> double
+{
+    if (quadric.weight <= 0.0)
+        return 0.0;
+
+    auto x = static_cast<double>(point.x);
+    auto y = static_cast<double>(point.y);
+    auto z = static_cast<double>(point.z);
+
+    auto result = quadric.a00 * x * x + quadric.a11 * y * y + quadric.a22 * z * z +
+                  2.0 * (quadric.a01 * x * y + quadric.a02 * x * z + quadric.a12 * y * z) +
+                  2.0 * (quadric.a03 * x + quadric.a13 * y + quadric.a23 * z) + quadric.a33;
+
+    return std::max(result, 0.0) / quadric.weight;
+}
+
+auto edge_key(u32 a, u32 b) -> u64
+{
+    auto [first, second] = std::minmax(a, b);
+    return u64{ first } << 32 | second;
+}
+
+class Simplifier
+{
+public:
+    explicit Simplifier(std::span<const StandardVertex> vertices, std::span<const u32> indices);
+
+    auto run(usize target_index_count, float max_error) -> SimplifiedMesh;
+
+private:
+    std::span<const StandardVertex> _vertices;
+    Vector<u32> _indices;
+    Vector<Quadric> _quadrics;
+    Vector<bool> _locked;
+
+    // Rebuilt on every pass. The triangles around vertex v are _vertex_triangles[_triangle_offsets[v],
+    // _triangle_offsets[v + 1]).
+    Vector<u32> _triangle_offsets;
+    Vector<u32> _vertex_triangles;
+    Vector<Collapse> _collapses;
+    Vector<bool> _touched; // Vertices which took part in a collapse during the current pass.
+
+    Vector<u32> _marks; // Used to find the neighbours two vertices share.
+    u32 _mark = 0;
+
+private:
+    auto lock_borders() -> void;
+    auto compute_quadrics() -> void;
+    auto build_adjacency() -> void;
+    auto collect_collapses() -> void;
+
+    [[nodiscard]] auto position(u32 vertex) const -> glm::vec3 { return _vertices[vertex].position; }
+    [[nodiscard]] auto triangle(u32 index) const -> std::span<const u32>
+    {
+        return std::span{ _indices }.subspan(usize{ index } * 3, 3);
+    }
+    [[nodiscard]] auto triangles_around(u32 vertex) const -> std::span<const u32>
+    {
+        return std::span{ _vertex_triangles }.subspan(_triangle_offsets[vertex],
+                                                      _triangle_offsets[vertex + 1] - _triangle_offsets[vertex]);
+    }
+    [[nodiscard]] auto is_degenerate(u32 index) const -> bool;
+
+    [[nodiscard]] auto collapse_cost(u32 from, u32 to) const -> double;
+    [[nodiscard]] auto can_collapse(u32 from, u32 to) -> bool;
+    // Returns the number of triangles that got removed.
+    auto collapse(u32 from, u32 to) -> usize;
+    auto remove_degenerate_triangles() -> void;
+};
+
+Simplifier::Simplifier(std::span<const StandardVertex> vertices, std::span<const u32> indices)
+    : _vertices{ vertices }, _indices{ std::from_range_t{}, indices }, _quadrics(vertices.size()),
+      _locked(vertices.size(), false), _triangle_offsets(vertices.size() + 1), _touched(vertices.size(), false),
+      _marks(vertices.size(), 0)
+{
+    // Drop the indices of an incomplete triangle.
+    _indices.resize(_indices.size() / 3 * 3);
+
+    remove_degenerate_triangles();
+    lock_borders();
+    compute_quadrics();
+}
+
+auto Simplifier::run(usize target_index_count, float max_error) -> SimplifiedMesh
+{
+    auto max_cost = static_cast<double>(max_error) * static_cast<double>(max_error);
+    auto target_triangle_count = target_index_count / 3;
+    auto max_collapse_cost = 0.0;
+
+    while (_indices.size() > target_index_count)
+    {
+        // Every pass collapses as many edges as it can, cheapest first, but a vertex can only take part in one collapse
+        // per pass, because the costs of the collapses around it change once it moves.
+
+        build_adjacency();
+        collect_collapses();
+
+        _touched.assign(_touched.size(), false);
+
+        auto triangle_count = _indices.size() / 3;
+        usize collapse_count = 0;
+
+        for (const auto& [from, to, cost] : _collapses)
+        {
+            if (triangle_count <= target_triangle_count || cost > max_cost)
+                break;
+
+            if (_touched[from] || _touched[to] || !can_collapse(from, to))
+                continue;
+
+            triangle_count -= collapse(from, to);
+            _touched[from] = true;
+            _touched[to] = true;
+
+            max_collapse_cost = std::max(max_collapse_cost, cost);
+            collapse_count++;
+        }
+
+        remove_degenerate_triangles();
+
+        if (collapse_count == 0)
+            break;
+    }
+
+    return SimplifiedMesh{
+        .indices = std::move(_indices),
+        .error = static_cast<float>(std::sqrt(max_collapse_cost)),
+    };
+}
+
+auto Simplifier::lock_borders() -> void
+{
+    // Edges which belong to a single triangle lie on the border of the mesh. Vertices on attribute seams are separate
+    // vertices on either side of the seam, so the edges along a seam belong to a single triangle too. Edges shared by
+    // more than two triangles are non-manifold and are left alone as well.
+
+    UnorderedMap<u64, u32> edge_triangle_counts;
+
+    for (usize i = 0; i < _indices.size(); i += 3)
+    {
+        for (usize corner = 0; corner < 3; corner++)
+            edge_triangle_counts[edge_key(_indices[i + corner], _indices[i + (corner + 1) % 3])]++;
+    }
+
+    for (const auto& [key, triangle_count] : edge_triangle_counts)
+    {
+        if (triangle_count == 2)
+            continue;
+
+        _locked[static_cast<usize>(key >> 32)] = true;
+        _locked[static_cast<usize>(key & 0xffffffff)] = true;
+    }
+}
+
+auto Simplifier::compute_quadrics() -> void
+{
+    for (usize i = 0; i < _indices.size(); i += 3)
+    {
+        glm::dvec3 a{ position(_indices[i]) };
+        glm::dvec3 b{ position(_indices[i + 1]) };
+        glm::dvec3 c{ position(_indices[i + 2]) };
+
+        auto normal = glm::cross(b - a, c - a);
+        auto double_area = glm::length(normal);
+
+        if (double_area <= 0.0)
+            continue;
+
+        normal /= double_area;
+
+        auto quadric = plane_quadric(normal, -glm::dot(normal, a), double_area * 0.5);
+
+        for (usize corner = 0; corner < 3; corner++)
+            _quadrics[_indices[i + corner]] += quadric;
+    }
+}
+
+auto Simplifier::build_adjacency() -> void
+{
+    std::ranges::fill(_triangle_offsets, 0u);
+
+    for (auto index : _indices)
+        _triangle_offsets[index + 1]++;
+
+    for (usize vertex = 0; vertex < _vertices.size(); vertex++)
+        _triangle_offsets[vertex + 1] += _triangle_offsets[vertex];
+
+    _vertex_triangles.resize(_indices.size());
+
+    // Every offset gets advanced past its list while filling the lists in, and then shifted back by one vertex.
+    for (usize i = 0; i < _indices.size(); i++)
+        _vertex_triangles[_triangle_offsets[_indices[i]]++] = static_cast<u32>(i / 3);
+
+    for (auto vertex = _vertices.size(); vertex > 0; vertex--)
+        _triangle_offsets[vertex] = _triangle_offsets[vertex - 1];
+
+    _triangle_offsets[0] = 0;
+}
+
+auto Simplifier::collect_collapses() -> void
+{
+    _collapses.clear();
+
+    for (usize i = 0; i < _indices.size(); i += 3)
+    {
+        for (usize corner = 0; corner < 3; corner++)
+        {
+            auto a = _indices[i + corner];
+            auto b = _indices[i + (corner + 1) % 3];
+
+            // Every edge which isn't on the border also shows up the other way around in the neighbouring triangle, and
+            // both ends of a border edge are locked.
+            if (a > b)
+                continue;
+
+            Collapse best{ .from = a, .to = b, .cost = std::numeric_limits<double>::infinity() };
+
+            if (!_locked[a])
+                best.cost = collapse_cost(a, b);
+
+            if (!_locked[b])
+            {
+                if (auto cost = collapse_cost(b, a); cost < best.cost)
+                    best = Collapse{ .from = b, .to = a, .cost = cost };
+            }
+
+            if (best.cost != std::numeric_limits<double>::infinity())
+                _collapses.push_back(best);
+        }
+    }
+
+    std::ranges::sort(_collapses, [](const Collapse& a, const Collapse& b) {
+        if (a.cost != b.cost)
+            return a.cost < b.cost;
+
+        return edge_key(a.from, a.to) < edge_key(b.from, b.to);
+    });
+}
+
+auto Simplifier::is_degenerate(u32 index) const -> bool
+{
+    auto corners = triangle(index);
+    return corners[0] == corners[1] || corners[1] == corners[2] || corners[2] == corners[0];
+}
+
+auto Simplifier::collapse_cost(u32 from, u32 to) const -> double
+{
+    auto quadric = _quadrics[from];
+    quadric += _quadrics[to];
+    return evaluate(quadric, position(to));
+}
+
+auto Simplifier::can_collapse(u32 from, u32 to) -> bool
+{
+    // The indices of the triangles around from and to are up to date, even though the adjacency was built at the start
+    // of the pass. Collapses within a pass only ever rewrite the triangles around vertices which have been touched, and
+    // the triangles around a vertex never stop containing it.
+
+    // The vertices adjacent to both ends of the edge must be exactly the vertices opposite to the edge in the triangles
+    // which share the edge, otherwise the collapse would fold the mesh onto itself.
+
+    _mark += 2;
+    auto neighbour_mark = _mark;
+    auto shared_neighbour_mark = _mark + 1;
+
+    usize shared_triangle_count = 0;
+    usize shared_neighbour_count = 0;
+
+    for (auto index : triangles_around(from))
+    {
+        if (is_degenerate(index))
+            continue;
+
+        auto corners = triangle(index);
+
+        if (std::ranges::find(corners, to) != corners.end())
+            shared_triangle_count++;
+
+        for (auto vertex : corners)
+        {
+            if (vertex != from && vertex != to)
+                _marks[vertex] = neighbour_mark;
+        }
+    }
+
+    for (auto index : triangles_around(to))
+    {
+        if (is_degenerate(index))
+            continue;
+
+        for (auto vertex : triangle(index))
+        {
+            if (_marks[vertex] == neighbour_mark)
+            {
+                _marks[vertex] = shared_neighbour_mark;
+                shared_neighbour_count++;
+            }
+        }
+    }
+
+    if (shared_neighbour_count != shared_triangle_count)
+        return false;
+
+    // Moving from onto to must not turn any of the remaining triangles over. Normals which turn by more than ~75
+    // degrees count as turning over too, as the triangles end up folded onto their neighbours.
+
+    constexpr auto min_normal_cosine = 0.25f;
+
+    for (auto index : triangles_around(from))
+    {
+        if (is_degenerate(index))
+            continue;
+
+        auto corners = triangle(index);
+
+        if (std::ranges::find(corners, to) != corners.end())
+            continue;
+
+        glm::vec3 old_positions[3]{ position(corners[0]), position(corners[1]), position(corners[2]) };
+        glm::vec3 new_positions[3]{ old_positions[0], old_positions[1], old_positions[2] };
+
+        for (usize corner = 0; corner < 3; corner++)
+        {
+            if (corners[corner] == from)
+                new_positions[corner] = position(to);
+        }
+
+        auto old_normal = glm::cross(old_positions[1] - old_positions[0], old_positions[2] - old_positions[0]);
+        auto new_normal = glm::cross(new_positions[1] - new_positions[0], new_positions[2] - new_positions[0]);
+
+        if (glm::dot(old_normal, new_normal) <=
+            min_normal_cosine * glm::length(old_normal) * glm::length(new_normal))
+            return false;
+    }
+
+    return true;
+}
+
+auto Simplifier::collapse(u32 from, u32 to) -> usize
+{
+    _quadrics[to] += _quadrics[from];
+
+    usize removed_triangle_count = 0;
+
+    for (auto index : triangles_around(from))
+    {
+        if (is_degenerate(index))
+            continue;
+
+        auto corners = std::span{ _indices }.subspan(usize{ index } * 3, 3);
+
+        if (std::ranges::find(corners, to) != corners.end())
+            removed_triangle_count++;
+
+        std::ranges::replace(corners, from, to);
+    }
+
+    return removed_triangle_count;
+}
+
+auto Simplifier::remove_degenerate_triangles() -> void
+{
+    usize kept_index_count = 0;
+
+    for (usize i = 0; i < _indices.size(); i += 3)
+    {
+        auto a = _indices[i];
+        auto b = _indices[i + 1];
+        auto c = _indices[i + 2];
+
+        if (a == b || b == c || c == a)
+            continue;
+
+        _indices[kept_index_count++] = a;
+        _indices[kept_index_count++] = b;
+        _indices[kept_index_count++] = c;
+    }
+
+    _indices.resize(kept_index_count);
+}
+
+} // namespace
+
+auto simplify_mesh(std::span<const StandardVertex> vertices, std::span<const u32> indices, usize target_index_count,
+                   float max_error) -> SimplifiedMesh
+{
+    Simplifier simplifier{ vertices, indices };
+    return simplifier.run(target_index_count, max_error);
+}
+
+} // namespace zth
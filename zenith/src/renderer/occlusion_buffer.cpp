@@ -0,0 +1,468 @@
+#include "zenith/renderer/occlusion_buffer.hpp"
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <glm/vec4.hpp>
+#include <glm/vector_relational.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#include "zenith/core/assert.hpp"
+#include "zenith/system/job_system.hpp"
+
+#if defined(__SSE__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define ZTH_OCCLUSION_BUFFER_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace zth {
+
+namespace {
+
+constexpr usize occluders_per_job = 16;
+constexpr usize rows_per_job = 16;
+
+// The vertices which lie in front of the near plane get cut off. A triangle ends up as a polygon with up to four
+// vertices. Returns the number of vertices of the polygon.
+auto clip_against_near_plane(const std::array<glm::vec4, 3>& triangle, std::array<glm::vec4, 4>& polygon) -> u32
+{
+    u32 count = 0;
+
+    for (usize i = 0; i < triangle.size(); i++)
+    {
+        const auto& current = triangle[i];
+        const auto& next = triangle[(i + 1) % triangle.size()];
+
+        // A point lies behind the near plane if z >= -w.
+        auto current_distance = current.z + current.w;
+        auto next_distance = next.z + next.w;
+
+        if (current_distance >= 0.0f)
+            polygon[count++] = current;
+
+        if ((current_distance >= 0.0f) != (next_distance >= 0.0f))
+            polygon[count++] = glm::mix(current, next, current_distance / (current_distance - next_distance));
+    }
+
+    return count;
+}
+
+// Signed area of the parallelogram spanned by the edge from a to b and the vector from a to p. Positive if p lies on
+// the left of the edge.
+auto edge_function(glm::vec2 a, glm::vec2 b, glm::vec2 p) -> float
+{
+    return (b.x - a.x) * (p.y - a.y) - (b.y - a.y) * (p.x - a.x);
+}
+
+} // namespace
+
+OccluderMesh::OccluderMesh(std::span<const glm::vec3> positions, std::span<const u32> indices)
+    : _positions{ positions.begin(), positions.end() }, _indices{ indices.begin(), indices.end() }
+{
+    ZTH_ASSERT(_indices.size() % 3 == 0);
+    ZTH_ASSERT(std::ranges::all_of(_indices, [&](u32 index) { return index < _positions.size(); }));
+}
+
+auto OccluderMesh::box(const math::Aabb& aabb) -> OccluderMesh
+{
+    std::array<glm::vec3, 8> positions;
+
+    for (u32 i = 0; i < positions.size(); i++)
+    {
+        positions[i] = glm::vec3{
+            i & 1 ? aabb.max.x : aabb.min.x,
+            i & 2 ? aabb.max.y : aabb.min.y,
+            i & 4 ? aabb.max.z : aabb.min.z,
+        };
+    }
+
+    // The winding doesn't matter, as the occluders get rasterized from both sides.
+    static constexpr std::array<u32, 36> indices = {
+        0, 2, 1, 1, 2, 3, // -z
+        4, 5, 6, 5, 7, 6, // +z
+        0, 4, 2, 2, 4, 6, // -x
+        1, 3, 5, 3, 7, 5, // +x
+        0, 1, 4, 1, 5, 4, // -y
+        2, 6, 3, 3, 6, 7, // +y
+    };
+
+    return OccluderMesh{ positions, indices };
+}
+
+OcclusionBuffer::OcclusionBuffer(glm::uvec2 size) : _size{ size }, _tile_count{ size / tile_size }
+{
+    ZTH_ASSERT(size.x > 0 && size.y > 0);
+    ZTH_ASSERT(size.x % tile_size == 0 && size.y % tile_size == 0);
+
+    u32 offset = 0;
+
+    for (auto level_size = size;; level_size = (level_size + 1u) / 2u)
+    {
+        _levels.push_back(Level{ .size = level_size, .offset = offset });
+        offset += level_size.x * level_size.y;
+
+        if (level_size == glm::uvec2{ 1 })
+            break;
+    }
+
+    _depth.resize(offset, 1.0f);
+    _tile_bins.resize(usize{ _tile_count.x } * _tile_count.y);
+}
+
+auto OcclusionBuffer::begin(const glm::mat4& view_projection) -> void
+{
+    _view_projection = view_projection;
+    _occluders.clear();
+    _triangle_count = 0;
+    std::ranges::fill(_depth, 1.0f);
+}
+
+auto OcclusionBuffer::add_occluder(const OccluderMesh& occluder, const glm::mat4& transform) -> void
+{
+    auto first_triangle = _occluders.empty() ? 0 : _occluders.back().first_triangle
+                                                       + _occluders.back().mesh->triangle_count() * 2;
+
+    _occluders.push_back(Occluder{
+        .mesh = &occluder,
+        .transform = _view_projection * transform,
+        .first_triangle = first_triangle,
+    });
+}
+
+auto OcclusionBuffer::finish() -> void
+{
+    auto triangle_slots = _occluders.empty() ? 0 : _occluders.back().first_triangle
+                                                       + _occluders.back().mesh->triangle_count() * 2;
+    _triangles.assign(triangle_slots, ScreenTriangle{});
+
+    // Every occluder only writes to its own triangle slots.
+    JobSystem::parallel_for(_occluders.size(), occluders_per_job, [&](usize begin, usize end) {
+        for (auto i = begin; i < end; i++)
+            set_up_triangles(_occluders[i]);
+    });
+
+    for (auto& bin : _tile_bins)
+        bin.clear();
+
+    _triangle_count = 0;
+
+    for (u32 i = 0; i < _triangles.size(); i++)
+    {
+        const auto& triangle = _triangles[i];
+
+        if (!triangle.valid)
+            continue;
+
+        _triangle_count++;
+
+        auto first_tile = glm::uvec2{ triangle.min } / tile_size;
+        auto last_tile = glm::uvec2{ triangle.max } / tile_size;
+
+        for (auto y = first_tile.y; y <= last_tile.y; y++)
+        {
+            for (auto x = first_tile.x; x <= last_tile.x; x++)
+                _tile_bins[y * _tile_count.x + x].push_back(i);
+        }
+    }
+
+    // Every tile only writes to its own pixels.
+    JobSystem::parallel_for(_tile_bins.size(), 1, [&](usize begin, usize end) {
+        for (auto tile = begin; tile < end; tile++)
+            rasterize_tile(static_cast<u32>(tile));
+    });
+
+    for (u32 level = 1; level < level_count(); level++)
+        build_level(level);
+}
+
+auto OcclusionBuffer::is_visible(const math::Aabb& aabb) const -> bool
+{
+    if (glm::any(glm::isinf(aabb.min)) || glm::any(glm::isinf(aabb.max)))
+        return true;
+
+    glm::vec2 ndc_min{ std::numeric_limits<float>::infinity() };
+    glm::vec2 ndc_max{ -std::numeric_limits<float>::infinity() };
+    auto ndc_nearest_depth = std::numeric_limits<float>::infinity();
+
+    for (u32 i = 0; i < 8; i++)
+    {
+        glm::vec4 corner{
+            i & 1 ? aabb.max.x : aabb.min.x,
+            i & 2 ? aabb.max.y : aabb.min.y,
+            i & 4 ? aabb.max.z : aabb.min.z,
+            1.0f,
+        };
+
+        auto clip = _view_projection * corner;
+
+        // The box reaches the camera, so there's nothing which could hide it.
+        if (clip.w <= 0.0f || clip.z < -clip.w)
+            return true;
+
+        glm::vec3 ndc = glm::vec3{ clip } / clip.w;
+        ndc_min = glm::min(ndc_min, glm::vec2{ ndc });
+        ndc_max = glm::max(ndc_max, glm::vec2{ ndc });
+        ndc_nearest_depth = std::min(ndc_nearest_depth, ndc.z);
+    }
+
+    auto size = glm::vec2{ _size };
+    auto screen_min = (ndc_min * 0.5f + 0.5f) * size;
+    auto screen_max = (ndc_max * 0.5f + 0.5f) * size;
+
+    // What lies outside of the screen is up to frustum culling.
+    if (screen_max.x < 0.0f || screen_max.y < 0.0f || screen_min.x > size.x || screen_min.y > size.y)
+        return true;
+
+    auto nearest_depth = ndc_nearest_depth * 0.5f + 0.5f;
+
+    // Every pixel which the rectangle touches, even partially.
+    auto first = glm::uvec2{ glm::clamp(glm::floor(screen_min), glm::vec2{ 0.0f }, size - 1.0f) };
+    auto last = glm::uvec2{ glm::clamp(glm::floor(screen_max), glm::vec2{ 0.0f }, size - 1.0f) };
+
+    // The first level at which the rectangle covers at most 4x4 texels.
+    u32 level = 0;
+
+    while (level + 1 < level_count()
+           && ((last.x >> level) - (first.x >> level) > 3 || (last.y >> level) - (first.y >> level) > 3))
+    {
+        level++;
+    }
+
+    auto [level_size, offset] = _levels[level];
+
+    for (auto y = first.y >> level; y <= last.y >> level; y++)
+    {
+        for (auto x = first.x >> level; x <= last.x >> level; x++)
+        {
+            if (nearest_depth <= _depth[offset + y * level_size.x + x])
+                return true;
+        }
+    }
+
+    return false;
+}
+
+auto OcclusionBuffer::level_size(u32 level) const -> glm::uvec2
+{
+    ZTH_ASSERT(level < level_count());
+    return _levels[level].size;
+}
+
+auto OcclusionBuffer::level(u32 level) const -> std::span<const float>
+{
+    ZTH_ASSERT(level < level_count());
+    auto [size, offset] = _levels[level];
+    return std::span{ _depth }.subspan(offset, usize{ size.x } * size.y);
+}
+
+auto OcclusionBuffer::set_up_triangles(const Occluder& occluder) -> void
+{
+    auto positions = occluder.mesh->positions();
+    auto indices = occluder.mesh->indices();
+    auto size = glm::vec2{ _size };
+
+    for (u32 t = 0; t < occluder.mesh->triangle_count(); t++)
+    {
+        std::array<glm::vec4, 3> triangle;
+
+        for (u32 v = 0; v < 3; v++)
+            triangle[v] = occluder.transform * glm::vec4{ positions[indices[t * 3 + v]], 1.0f };
+
+        std::array<glm::vec4, 4> polygon;
+        auto vertex_count = clip_against_near_plane(triangle, polygon);
+
+        if (vertex_count < 3)
+            continue;
+
+        std::array<glm::vec3, 4> screen_polygon;
+        auto behind_camera = false;
+
+        for (u32 v = 0; v < vertex_count; v++)
+        {
+            // Can only happen with unusual projections, e.g. ones with the near plane at the camera.
+            if (polygon[v].w <= 0.0f)
+                behind_camera = true;
+
+            auto ndc = glm::vec3{ polygon[v] } / polygon[v].w;
+            screen_polygon[v] = glm::vec3{ (glm::vec2{ ndc } * 0.5f + 0.5f) * size, ndc.z * 0.5f + 0.5f };
+        }
+
+        if (behind_camera)
+            continue;
+
+        // The polygon gets split into a fan of triangles.
+        for (u32 v = 1; v + 1 < vertex_count; v++)
+        {
+            ScreenTriangle screen_triangle{
+                .a = screen_polygon[0],
+                .b = screen_polygon[v],
+                .c = screen_polygon[v + 1],
+            };
+
+            auto min = glm::min(glm::min(glm::vec2{ screen_triangle.a }, glm::vec2{ screen_triangle.b }),
+                                glm::vec2{ screen_triangle.c });
+            auto max = glm::max(glm::max(glm::vec2{ screen_triangle.a }, glm::vec2{ screen_triangle.b }),
+                                glm::vec2{ screen_triangle.c });
+
+            // The pixels whose centers lie within the bounds.
+            auto first_pixel = glm::ceil(min - 0.5f);
+            auto last_pixel = glm::floor(max - 0.5f);
+
+            if (last_pixel.x < 0.0f || last_pixel.y < 0.0f || first_pixel.x > size.x - 1.0f
+                || first_pixel.y > size.y - 1.0f || first_pixel.x > last_pixel.x || first_pixel.y > last_pixel.y)
+            {
+                continue;
+            }
+
+            auto area = edge_function(glm::vec2{ screen_triangle.a }, glm::vec2{ screen_triangle.b },
+                                      glm::vec2{ screen_triangle.c });
+
+            if (area == 0.0f || std::isnan(area))
+                continue;
+
+            // Counter-clockwise triangles have the inside on the left of every edge.
+            if (area < 0.0f)
+                std::swap(screen_triangle.b, screen_triangle.c);
+
+            screen_triangle.min = glm::ivec2{ glm::clamp(first_pixel, glm::vec2{ 0.0f }, size - 1.0f) };
+            screen_triangle.max = glm::ivec2{ glm::clamp(last_pixel, glm::vec2{ 0.0f }, size - 1.0f) };
+            screen_triangle.valid = true;
+
+            _triangles[occluder.first_triangle + t * 2 + (v - 1)] = screen_triangle;
+        }
+    }
+}
+
+auto OcclusionBuffer::rasterize_tile(u32 tile) -> void
+{
+    auto tile_min = glm::ivec2{ glm::uvec2{ tile % _tile_count.x, tile / _tile_count.x } * tile_size };
+    auto tile_max = tile_min + static_cast<i32>(tile_size) - 1;
+
+    auto depth_buffer = _depth.data();
+    auto width = static_cast<i32>(_size.x);
+
+    for (auto index : _tile_bins[tile])
+    {
+        const auto& triangle = _triangles[index];
+        const auto& a = triangle.a;
+        const auto& b = triangle.b;
+        const auto& c = triangle.c;
+
+        auto min = glm::max(triangle.min, tile_min);
+        auto max = glm::min(triangle.max, tile_max);
+
+        auto area = edge_function(glm::vec2{ a }, glm::vec2{ b }, glm::vec2{ c });
+
+        // Every edge function is ex * (p.x - start.x) + ey * (p.y - start.y), where start is the start of the edge.
+        glm::vec3 ex{ b.y - c.y, c.y - a.y, a.y - b.y };
+        glm::vec3 ey{ c.x - b.x, a.x - c.x, b.x - a.x };
+
+        // The depth is interpolated with the edge functions, which are the barycentric coordinates scaled by the area.
+        glm::vec3 depths{ a.z, b.z, c.z };
+        auto depth_dx = glm::dot(ex, depths) / area;
+        auto depth_dy = glm::dot(ey, depths) / area;
+
+        // The farthest depth of the triangle within a pixel lies at most half a pixel away from its center.
+        auto depth_bias = 0.5f * (std::abs(depth_dx) + std::abs(depth_dy));
+        auto farthest_depth = std::max({ a.z, b.z, c.z });
+
+        for (auto y = min.y; y <= max.y; y++)
+        {
+            auto py = static_cast<float>(y) + 0.5f;
+            auto row = depth_buffer + y * width;
+
+            // The parts of the edge functions and the depth which stay the same along the row.
+            auto e0_row = ey.x * (py - b.y);
+            auto e1_row = ey.y * (py - c.y);
+            auto e2_row = ey.z * (py - a.y);
+            auto depth_row = a.z + depth_dy * (py - a.y) + depth_bias;
+
+            auto x = min.x;
+
+#if defined(ZTH_OCCLUSION_BUFFER_SSE)
+            // Tiles start at multiples of four, so the pixels before the triangle's bounds still belong to the tile.
+            // They lie outside of the triangle, so they don't get written.
+            x &= ~3;
+
+            const auto zero = _mm_setzero_ps();
+            const auto lane_offsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+
+            for (; x <= max.x; x += 4)
+            {
+                auto px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), lane_offsets);
+
+                auto e0 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(ex.x), _mm_sub_ps(px, _mm_set1_ps(b.x))),
+                                     _mm_set1_ps(e0_row));
+                auto e1 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(ex.y), _mm_sub_ps(px, _mm_set1_ps(c.x))),
+                                     _mm_set1_ps(e1_row));
+                auto e2 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(ex.z), _mm_sub_ps(px, _mm_set1_ps(a.x))),
+                                     _mm_set1_ps(e2_row));
+
+                auto inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)),
+                                         _mm_cmpge_ps(e2, zero));
+
+                if (_mm_movemask_ps(inside) == 0)
+                    continue;
+
+                // Same order of operations as in the scalar loop below.
+                auto depth = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(depth_dx), _mm_sub_ps(px, _mm_set1_ps(a.x))),
+                                        _mm_set1_ps(depth_row));
+                depth = _mm_min_ps(depth, _mm_set1_ps(farthest_depth));
+
+                auto stored = _mm_loadu_ps(row + x);
+                auto closer = _mm_min_ps(stored, depth);
+                _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, closer), _mm_andnot_ps(inside, stored)));
+            }
+#endif
+
+            for (; x <= max.x; x++)
+            {
+                auto px = static_cast<float>(x) + 0.5f;
+
+                auto e0 = ex.x * (px - b.x) + e0_row;
+                auto e1 = ex.y * (px - c.x) + e1_row;
+                auto e2 = ex.z * (px - a.x) + e2_row;
+
+                if (e0 < 0.0f || e1 < 0.0f || e2 < 0.0f)
+                    continue;
+
+                auto depth = std::min(depth_dx * (px - a.x) + depth_row, farthest_depth);
+                row[x] = std::min(row[x], depth);
+            }
+        }
+    }
+}
+
+auto OcclusionBuffer::build_level(u32 level) -> void
+{
+    ZTH_ASSERT(level > 0);
+
+    auto [size, offset] = _levels[level];
+    auto [previous_size, previous_offset] = _levels[level - 1];
+
+    // Every row only writes to its own texels.
+    JobSystem::parallel_for(size.y, rows_per_job, [&](usize begin, usize end) {
+        for (auto y = static_cast<u32>(begin); y < end; y++)
+        {
+            // A level with an odd size has texels which only cover a single row or column of the level below.
+            auto y0 = y * 2;
+            auto y1 = std::min(y0 + 1, previous_size.y - 1);
+
+            for (u32 x = 0; x < size.x; x++)
+            {
+                auto x0 = x * 2;
+                auto x1 = std::min(x0 + 1, previous_size.x - 1);
+
+                auto texel = [&](u32 tx, u32 ty) { return _depth[previous_offset + ty * previous_size.x + tx]; };
+                _depth[offset + y * size.x + x] =
+                    std::max({ texel(x0, y0), texel(x1, y0), texel(x0, y1), texel(x1, y1) });
+            }
+        }
+    });
+}
+
+} // namespace zth
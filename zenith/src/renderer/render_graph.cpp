@@ -0,0 +1,672 @@
+#include "zenith/renderer/render_graph.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <ranges>
+
+#include "zenith/core/assert.hpp"
+#include "zenith/log/format.hpp"
+#include "zenith/log/logger.hpp"
+
+namespace zth {
+
+namespace {
+
+auto format_bytes(usize bytes) -> String
+{
+    constexpr auto kibibyte = 1024.0;
+    constexpr auto mebibyte = 1024.0 * kibibyte;
+
+    auto value = static_cast<double>(bytes);
+
+    if (value >= mebibyte)
+        return format("{:.2f} MiB", value / mebibyte);
+    else if (value >= kibibyte)
+        return format("{:.2f} KiB", value / kibibyte);
+
+    return format("{} B", bytes);
+}
+
+auto contains(const Vector<u32>& indices, u32 index) -> bool
+{
+    return std::ranges::find(indices, index) != indices.end();
+}
+
+} // namespace
+
+RenderGraphPassBuilder::RenderGraphPassBuilder(RenderGraph& graph, u32 pass_index)
+    : _graph{ graph }, _pass_index{ pass_index }
+{}
+
+auto RenderGraphPassBuilder::read(RenderGraphTexture texture) -> void
+{
+    ZTH_ASSERT(texture.index < _graph._resources.size());
+    _graph._passes[_pass_index].reads.push_back(texture.index);
+}
+
+auto RenderGraphPassBuilder::read(RenderGraphBuffer buffer) -> void
+{
+    ZTH_ASSERT(buffer.index < _graph._resources.size());
+    _graph._passes[_pass_index].reads.push_back(buffer.index);
+}
+
+auto RenderGraphPassBuilder::write(RenderGraphBuffer buffer) -> void
+{
+    ZTH_ASSERT(buffer.index < _graph._resources.size());
+    _graph._passes[_pass_index].writes.push_back(buffer.index);
+}
+
+auto RenderGraphPassBuilder::write_color(RenderGraphTexture texture) -> void
+{
+    ZTH_ASSERT(texture.index < _graph._resources.size());
+
+    auto& pass = _graph._passes[_pass_index];
+    pass.writes.push_back(texture.index);
+    pass.color_attachments.push_back(texture.index);
+}
+
+auto RenderGraphPassBuilder::write_depth(RenderGraphTexture texture) -> void
+{
+    ZTH_ASSERT(texture.index < _graph._resources.size());
+
+    auto& pass = _graph._passes[_pass_index];
+    ZTH_ASSERT(!pass.depth_attachment);
+    pass.writes.push_back(texture.index);
+    pass.depth_attachment = texture.index;
+}
+
+auto RenderGraphPassBuilder::set_side_effect() -> void
+{
+    _graph._passes[_pass_index].side_effect = true;
+}
+
+auto RenderGraphResourcePool::acquire_texture(const RenderGraphTextureDesc& desc) -> const gl::Texture2D&
+{
+    auto pooled = std::ranges::find_if(_textures, [&](const auto& texture) {
+        return !texture->acquired && texture->desc == desc;
+    });
+
+    if (pooled == _textures.end())
+    {
+        auto texture = gl::Texture2D::with_size(desc.size.x, desc.size.y,
+                                                gl::TextureParams{
+                                                    .horizontal_wrap = gl::TextureWrapMode::ClampToEdge,
+                                                    .vertical_wrap = gl::TextureWrapMode::ClampToEdge,
+                                                    .min_filter = gl::TextureMinFilter::nearest_mipmap_nearest,
+                                                    .mag_filter = gl::TextureMagFilter::nearest,
+                                                    .internal_format = desc.format,
+                                                });
+
+        _textures.push_back(make_unique<PooledTexture>(PooledTexture{
+            .desc = desc,
+            .texture = std::move(texture),
+            .size_bytes = usize{ desc.size.x } * desc.size.y * gl::bytes_per_texel(desc.format),
+        }));
+
+        pooled = std::prev(_textures.end());
+    }
+
+    (*pooled)->acquired = true;
+    (*pooled)->unused_frames = 0;
+    return (*pooled)->texture;
+}
+
+auto RenderGraphResourcePool::acquire_buffer(const RenderGraphBufferDesc& desc) -> const gl::Buffer&
+{
+    auto pooled = std::ranges::find_if(_buffers, [&](const auto& buffer) {
+        return !buffer->acquired && buffer->desc.size >= desc.size;
+    });
+
+    if (pooled == _buffers.end())
+    {
+        _buffers.push_back(make_unique<PooledBuffer>(PooledBuffer{
+            .desc = desc,
+            .buffer = gl::Buffer::create_static_with_size(desc.size),
+        }));
+
+        pooled = std::prev(_buffers.end());
+    }
+
+    (*pooled)->acquired = true;
+    (*pooled)->unused_frames = 0;
+    return (*pooled)->buffer;
+}
+
+auto RenderGraphResourcePool::framebuffer(std::span<const gl::Texture2D* const> color_attachments,
+                                          const gl::Texture2D* depth_attachment) -> const gl::Framebuffer&
+{
+    auto cached = std::ranges::find_if(_framebuffers, [&](const auto& framebuffer) {
+        return std::ranges::equal(framebuffer->color_attachments, color_attachments)
+               && framebuffer->depth_attachment == depth_attachment;
+    });
+
+    if (cached == _framebuffers.end())
+    {
+        _framebuffers.push_back(make_unique<CachedFramebuffer>(CachedFramebuffer{
+            .color_attachments = Vector<const gl::Texture2D*>{ color_attachments.begin(), color_attachments.end() },
+            .depth_attachment = depth_attachment,
+            .framebuffer = gl::Framebuffer::create(color_attachments, depth_attachment),
+        }));
+
+        cached = std::prev(_framebuffers.end());
+    }
+
+    return (*cached)->framebuffer;
+}
+
+auto RenderGraphResourcePool::end_frame() -> void
+{
+    auto unused_for_too_long = [](const auto& object) { return object->unused_frames > max_unused_frames; };
+
+    for (auto& texture : _textures)
+    {
+        if (!std::exchange(texture->acquired, false))
+            texture->unused_frames++;
+    }
+
+    for (auto& buffer : _buffers)
+    {
+        if (!std::exchange(buffer->acquired, false))
+            buffer->unused_frames++;
+    }
+
+    // The framebuffers which render into the textures that are about to be freed have to go first.
+    std::erase_if(_framebuffers, [&](const auto& framebuffer) {
+        auto uses_freed_texture = [&](const gl::Texture2D* attachment) {
+            return std::ranges::any_of(_textures, [&](const auto& texture) {
+                return &texture->texture == attachment && unused_for_too_long(texture);
+            });
+        };
+
+        return std::ranges::any_of(framebuffer->color_attachments, uses_freed_texture)
+               || (framebuffer->depth_attachment && uses_freed_texture(framebuffer->depth_attachment));
+    });
+
+    std::erase_if(_textures, unused_for_too_long);
+    std::erase_if(_buffers, unused_for_too_long);
+}
+
+auto RenderGraphResourcePool::clear() -> void
+{
+    _framebuffers.clear();
+    _textures.clear();
+    _buffers.clear();
+}
+
+auto RenderGraphResourcePool::allocated_bytes() const -> usize
+{
+    usize result = 0;
+
+    for (const auto& texture : _textures)
+        result += texture->size_bytes;
+
+    for (const auto& buffer : _buffers)
+        result += buffer->desc.size;
+
+    return result;
+}
+
+RenderGraphPassContext::RenderGraphPassContext(const RenderGraph& graph,
+                                               std::span<const gl::Texture2D* const> textures,
+                                               std::span<const gl::Buffer* const> buffers,
+                                               const gl::Framebuffer* framebuffer)
+    : _graph{ graph }, _textures{ textures }, _buffers{ buffers }, _framebuffer{ framebuffer }
+{}
+
+auto RenderGraphPassContext::texture(RenderGraphTexture texture) const -> const gl::Texture2D&
+{
+    ZTH_ASSERT(_graph.resource(texture).type == RenderGraphResourceType::Texture);
+    ZTH_ASSERT(_textures[texture.index] != nullptr);
+    return *_textures[texture.index];
+}
+
+auto RenderGraphPassContext::buffer(RenderGraphBuffer buffer) const -> const gl::Buffer&
+{
+    ZTH_ASSERT(_graph.resource(buffer).type == RenderGraphResourceType::Buffer);
+    ZTH_ASSERT(_buffers[buffer.index] != nullptr);
+    return *_buffers[buffer.index];
+}
+
+auto RenderGraph::create_texture(StringView name, const RenderGraphTextureDesc& desc) -> RenderGraphTexture
+{
+    return RenderGraphTexture{ add_resource(RenderGraphResource{
+        .name = String{ name },
+        .type = RenderGraphResourceType::Texture,
+        .texture_desc = desc,
+        .size_bytes = usize{ desc.size.x } * desc.size.y * gl::bytes_per_texel(desc.format),
+    }) };
+}
+
+auto RenderGraph::create_buffer(StringView name, const RenderGraphBufferDesc& desc) -> RenderGraphBuffer
+{
+    return RenderGraphBuffer{ add_resource(RenderGraphResource{
+        .name = String{ name },
+        .type = RenderGraphResourceType::Buffer,
+        .buffer_desc = desc,
+        .size_bytes = desc.size,
+    }) };
+}
+
+auto RenderGraph::import_texture(StringView name, const gl::Texture2D* texture) -> RenderGraphTexture
+{
+    return RenderGraphTexture{ add_resource(RenderGraphResource{
+        .name = String{ name },
+        .type = RenderGraphResourceType::Texture,
+        .imported = true,
+        .imported_texture = texture,
+    }) };
+}
+
+auto RenderGraph::import_buffer(StringView name, const gl::Buffer* buffer) -> RenderGraphBuffer
+{
+    return RenderGraphBuffer{ add_resource(RenderGraphResource{
+        .name = String{ name },
+        .type = RenderGraphResourceType::Buffer,
+        .imported = true,
+        .imported_buffer = buffer,
+    }) };
+}
+
+auto RenderGraph::backbuffer() -> RenderGraphTexture
+{
+    if (!_backbuffer)
+    {
+        _backbuffer = add_resource(RenderGraphResource{
+            .name = "Backbuffer",
+            .type = RenderGraphResourceType::Texture,
+            .imported = true,
+            .backbuffer = true,
+        });
+    }
+
+    return RenderGraphTexture{ *_backbuffer };
+}
+
+auto RenderGraph::compile() -> Result<void, String>
+{
+    _compiled = false;
+    _execution_order.clear();
+    _allocations.clear();
+    _stats = RenderGraphStats{};
+
+    for (auto& resource : _resources)
+    {
+        resource.first_use = nil;
+        resource.last_use = nil;
+        resource.allocation = nil;
+    }
+
+    for (const auto& pass : _passes)
+    {
+        auto renders_into_backbuffer = _backbuffer && contains(pass.color_attachments, *_backbuffer);
+
+        if (renders_into_backbuffer && (pass.color_attachments.size() > 1 || pass.depth_attachment))
+        {
+            return Error{ format("Pass \"{}\" renders into the backbuffer together with other attachments.",
+                                 pass.name) };
+        }
+
+        for (auto index : pass.color_attachments)
+        {
+            if (_resources[index].type != RenderGraphResourceType::Texture)
+            {
+                return Error{ format("Pass \"{}\" renders into a buffer (\"{}\").", pass.name,
+                                     _resources[index].name) };
+            }
+        }
+    }
+
+    // Reading a transient resource which no pass has written before is a mistake, as its contents are undefined.
+    Vector<bool> written(_resources.size(), false);
+
+    for (const auto& pass : _passes)
+    {
+        for (auto index : pass.reads)
+        {
+            if (!_resources[index].imported && !written[index])
+            {
+                return Error{ format("Pass \"{}\" reads \"{}\" before any pass writes it.", pass.name,
+                                     _resources[index].name) };
+            }
+        }
+
+        for (auto index : pass.writes)
+            written[index] = true;
+    }
+
+    cull_passes();
+
+    for (u32 i = 0; i < _passes.size(); i++)
+    {
+        if (!_passes[i].culled)
+            _execution_order.push_back(i);
+    }
+
+    compute_lifetimes();
+    alias_resources();
+
+    _stats.passes = static_cast<u32>(_passes.size());
+    _stats.culled_passes = static_cast<u32>(_passes.size() - _execution_order.size());
+    _stats.allocations = static_cast<u32>(_allocations.size());
+
+    for (const auto& resource : _resources)
+    {
+        if (resource.allocation)
+        {
+            _stats.transient_resources++;
+            _stats.transient_bytes += resource.size_bytes;
+        }
+    }
+
+    for (const auto& allocation : _allocations)
+        _stats.allocated_bytes += allocation.size_bytes;
+
+    _compiled = true;
+    return {};
+}
+
+auto RenderGraph::execute(RenderGraphResourcePool& pool) -> void
+{
+    if (!_compiled)
+    {
+        auto result = compile();
+
+        if (!result)
+        {
+            ZTH_INTERNAL_ERROR("[Render Graph] Failed to compile the render graph: {}", result.error());
+            return;
+        }
+    }
+
+    // Every resource aliased onto an allocation gets the same object.
+    Vector<const gl::Texture2D*> textures(_resources.size(), nullptr);
+    Vector<const gl::Buffer*> buffers(_resources.size(), nullptr);
+
+    for (const auto& allocation : _allocations)
+    {
+        const gl::Texture2D* texture = nullptr;
+        const gl::Buffer* buffer = nullptr;
+
+        if (allocation.type == RenderGraphResourceType::Texture)
+            texture = &pool.acquire_texture(allocation.texture_desc);
+        else
+            buffer = &pool.acquire_buffer(allocation.buffer_desc);
+
+        for (auto index : allocation.resources)
+        {
+            textures[index] = texture;
+            buffers[index] = buffer;
+        }
+    }
+
+    for (u32 i = 0; i < _resources.size(); i++)
+    {
+        if (_resources[i].imported)
+        {
+            textures[i] = _resources[i].imported_texture;
+            buffers[i] = _resources[i].imported_buffer;
+        }
+    }
+
+    Vector<const gl::Texture2D*> color_attachments;
+
+    for (auto pass_index : _execution_order)
+    {
+        const auto& pass = _passes[pass_index];
+        const gl::Framebuffer* framebuffer = nullptr;
+
+        if (pass.color_attachments.empty() && !pass.depth_attachment)
+        {
+            gl::Framebuffer::bind_default();
+        }
+        else if (_backbuffer && contains(pass.color_attachments, *_backbuffer))
+        {
+            gl::Framebuffer::bind_default();
+        }
+        else
+        {
+            color_attachments.clear();
+
+            for (auto index : pass.color_attachments)
+                color_attachments.push_back(textures[index]);
+
+            framebuffer = &pool.framebuffer(color_attachments,
+                                            pass.depth_attachment ? textures[*pass.depth_attachment] : nullptr);
+            framebuffer->bind();
+        }
+
+        if (pass.execute)
+            pass.execute(RenderGraphPassContext{ *this, textures, buffers, framebuffer });
+    }
+
+    gl::Framebuffer::bind_default();
+    pool.end_frame();
+}
+
+auto RenderGraph::clear() -> void
+{
+    _passes.clear();
+    _resources.clear();
+    _backbuffer = nil;
+
+    _compiled = false;
+    _execution_order.clear();
+    _allocations.clear();
+    _stats = RenderGraphStats{};
+}
+
+auto RenderGraph::dump() const -> String
+{
+    String result;
+    auto out = std::back_inserter(result);
+
+    format_to(out, "Render graph: {} passes ({} culled), {} transient resources in {} allocations\n", _stats.passes,
+              _stats.culled_passes, _stats.transient_resources, _stats.allocations);
+
+    format_to(out, "Passes:\n");
+
+    auto resource_names = [&](const Vector<u32>& indices) {
+        String names;
+
+        for (auto index : indices)
+            format_to(std::back_inserter(names), "{}{}", names.empty() ? "" : ", ", _resources[index].name);
+
+        return names.empty() ? String{ "-" } : names;
+    };
+
+    auto position = 0u;
+
+    for (const auto& pass : _passes)
+    {
+        if (pass.culled)
+            format_to(out, "  -  {} (culled)\n", pass.name);
+        else
+            format_to(out, "  {}. {}\n", position++, pass.name);
+
+        format_to(out, "       reads: {}\n", resource_names(pass.reads));
+        format_to(out, "       writes: {}\n", resource_names(pass.writes));
+    }
+
+    format_to(out, "Resources:\n");
+
+    for (const auto& resource : _resources)
+    {
+        format_to(out, "  {}", resource.name);
+
+        if (resource.backbuffer)
+            format_to(out, " (backbuffer)");
+        else if (resource.imported)
+            format_to(out, " (imported)");
+        else if (resource.type == RenderGraphResourceType::Texture)
+            format_to(out, " {}x{} {}, {}", resource.texture_desc.size.x, resource.texture_desc.size.y,
+                      gl::texture_format_name(resource.texture_desc.format), format_bytes(resource.size_bytes));
+        else
+            format_to(out, " buffer, {}", format_bytes(resource.size_bytes));
+
+        if (resource.first_use && resource.last_use)
+            format_to(out, ", passes {}-{}", *resource.first_use, *resource.last_use);
+        else
+            format_to(out, ", unused");
+
+        if (resource.allocation)
+            format_to(out, ", allocation {}", *resource.allocation);
+
+        format_to(out, "\n");
+    }
+
+    auto saved_percentage = _stats.transient_bytes == 0 ? 0.0
+                                                        : static_cast<double>(_stats.saved_bytes()) * 100.0
+                                                              / static_cast<double>(_stats.transient_bytes);
+
+    format_to(out, "Memory: {} without aliasing, {} with aliasing, {} saved ({:.1f}%)\n",
+              format_bytes(_stats.transient_bytes), format_bytes(_stats.allocated_bytes),
+              format_bytes(_stats.saved_bytes()), saved_percentage);
+
+    return result;
+}
+
+auto RenderGraph::resource(RenderGraphTexture texture) const -> const RenderGraphResource&
+{
+    ZTH_ASSERT(texture.index < _resources.size());
+    return _resources[texture.index];
+}
+
+auto RenderGraph::resource(RenderGraphBuffer buffer) const -> const RenderGraphResource&
+{
+    ZTH_ASSERT(buffer.index < _resources.size());
+    return _resources[buffer.index];
+}
+
+auto RenderGraph::add_resource(RenderGraphResource&& resource) -> u32
+{
+    _compiled = false;
+    _resources.push_back(std::move(resource));
+    return static_cast<u32>(_resources.size() - 1);
+}
+
+auto RenderGraph::cull_passes() -> void
+{
+    // A pass has to run if it has side effects, or if a pass which has to run reads something it writes. Passes only
+    // read what the passes added before them wrote, so going through the passes backwards visits every pass after all
+    // the passes which depend on it.
+    Vector<bool> needed(_resources.size(), false);
+
+    for (auto& pass : std::views::reverse(_passes))
+    {
+        auto writes_needed_resource = std::ranges::any_of(pass.writes, [&](u32 index) {
+            return needed[index] || _resources[index].imported;
+        });
+
+        pass.culled = !pass.side_effect && !writes_needed_resource;
+
+        if (pass.culled)
+            continue;
+
+        // What this pass writes is no longer needed from the passes before it, unless this pass reads it as well.
+        for (auto index : pass.writes)
+            needed[index] = false;
+
+        for (auto index : pass.reads)
+            needed[index] = true;
+    }
+}
+
+auto RenderGraph::compute_lifetimes() -> void
+{
+    for (u32 position = 0; position < _execution_order.size(); position++)
+    {
+        const auto& pass = _passes[_execution_order[position]];
+
+        auto use = [&](u32 index) {
+            auto& resource = _resources[index];
+
+            if (!resource.first_use)
+                resource.first_use = position;
+
+            resource.last_use = position;
+        };
+
+        std::ranges::for_each(pass.reads, use);
+        std::ranges::for_each(pass.writes, use);
+    }
+}
+
+auto RenderGraph::alias_resources() -> void
+{
+    // The resources get placed in the order in which they're first used. A resource can take over an allocation once
+    // the last pass which uses the allocation's current resource has run.
+    Vector<u32> transient_resources;
+
+    for (u32 i = 0; i < _resources.size(); i++)
+    {
+        if (!_resources[i].imported && _resources[i].first_use)
+            transient_resources.push_back(i);
+    }
+
+    std::ranges::stable_sort(transient_resources, {}, [&](u32 index) { return *_resources[index].first_use; });
+
+    for (auto index : transient_resources)
+    {
+        auto& resource = _resources[index];
+        Optional<u32> best_allocation = nil;
+
+        for (u32 i = 0; i < _allocations.size(); i++)
+        {
+            const auto& allocation = _allocations[i];
+
+            if (allocation.type != resource.type || allocation.last_use >= *resource.first_use)
+                continue;
+
+            if (resource.type == RenderGraphResourceType::Texture)
+            {
+                if (allocation.texture_desc == resource.texture_desc)
+                {
+                    best_allocation = i;
+                    break;
+                }
+
+                continue;
+            }
+
+            // Buffers prefer the smallest allocation that they fit into, and otherwise grow the largest one.
+            if (!best_allocation)
+            {
+                best_allocation = i;
+                continue;
+            }
+
+            const auto& best = _allocations[*best_allocation];
+            auto fits = allocation.size_bytes >= resource.size_bytes;
+            auto best_fits = best.size_bytes >= resource.size_bytes;
+
+            if ((fits && (!best_fits || allocation.size_bytes < best.size_bytes))
+                || (!fits && !best_fits && allocation.size_bytes > best.size_bytes))
+                best_allocation = i;
+        }
+
+        if (!best_allocation)
+        {
+            best_allocation = static_cast<u32>(_allocations.size());
+            _allocations.push_back(RenderGraphAllocation{
+                .type = resource.type,
+                .texture_desc = resource.texture_desc,
+                .buffer_desc = resource.buffer_desc,
+                .size_bytes = resource.size_bytes,
+            });
+        }
+
+        auto& allocation = _allocations[*best_allocation];
+        allocation.last_use = *resource.last_use;
+        allocation.resources.push_back(index);
+
+        if (resource.type == RenderGraphResourceType::Buffer && resource.size_bytes > allocation.size_bytes)
+        {
+            allocation.size_bytes = resource.size_bytes;
+            allocation.buffer_desc = resource.buffer_desc;
+        }
+
+        resource.allocation = best_allocation;
+    }
+}
+
+} // namespace zth
@@ -1,15 +1,30 @@
 #include "zenith/renderer/renderer.hpp"
 
 #include <glad/glad.h>
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
 #include <glm/gtx/structured_bindings.hpp>
+#include <glm/matrix.hpp>
+#include <glm/vector_relational.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <concepts>
+#include <functional>
+#include <limits>
+#include <utility>
 
 #include "zenith/core/assert.hpp"
 #include "zenith/core/profiler.hpp"
 #include "zenith/ecs/components.hpp"
+#include "zenith/gl/context.hpp"
 #include "zenith/gl/shader.hpp"
+#include "zenith/gl/state_cache.hpp"
 #include "zenith/gl/texture.hpp"
 #include "zenith/gl/util.hpp"
 #include "zenith/log/logger.hpp"
+#include "zenith/math/frustum.hpp"
 #include "zenith/math/matrix.hpp"
 #include "zenith/memory/managed.hpp"
 #include "zenith/renderer/material.hpp"
@@ -20,6 +35,8 @@
 #include "zenith/renderer/resources/shaders.hpp"
 #include "zenith/renderer/resources/textures.hpp"
 #include "zenith/system/event.hpp"
+#include "zenith/system/job_system.hpp"
+#include "zenith/system/temporary_storage.hpp"
 #include "zenith/system/window.hpp"
 #include "zenith/util/macros.hpp"
 
@@ -30,52 +47,187 @@ namespace {
 UniquePtr<Renderer> renderer;
 UniquePtr<Renderer2D> renderer_2d;
 
-} // namespace
+auto seconds_since(std::chrono::steady_clock::time_point start) -> double
+{
+    return std::chrono::duration<double>{ std::chrono::steady_clock::now() - start }.count();
+}
+
+// Only the calls made while rendering the scene count towards the renderer's binds.
+auto count_binds(RendererStats& stats, auto&& render) -> void
+{
+    auto state_cache_stats = gl::StateCache::stats_this_frame();
+
+    std::invoke(render);
+
+    const auto& state_cache_stats_after = gl::StateCache::stats_this_frame();
+    stats.shader_binds += state_cache_stats_after.program_binds - state_cache_stats.program_binds;
+    stats.texture_binds += state_cache_stats_after.texture_binds - state_cache_stats.texture_binds;
+    stats.vertex_array_binds += state_cache_stats_after.vertex_array_binds - state_cache_stats.vertex_array_binds;
+}
+
+// Uploads the data and adds the upload to the stats.
+auto upload_to(auto& buffer, auto&& data, u32& bytes_uploaded, u32& buffer_reallocations) -> void
+{
+    auto capacity_bytes = buffer.capacity_bytes();
+    bytes_uploaded += buffer.buffer_data(data);
+
+    if (buffer.capacity_bytes() != capacity_bytes)
+        buffer_reallocations++;
+}
+
+template<typename Stats> auto push_to_history(Vector<Stats>& history, const Stats& stats) -> void
+{
+    constexpr auto history_size = static_cast<isize>(Renderer::stats_history_size);
 
-auto DrawCommand::operator==(const DrawCommand& other) const -> bool
+    if (history.size() == Renderer::stats_history_size * 2)
+        history.erase(history.begin(), history.begin() + history_size);
+
+    history.push_back(stats);
+}
+
+template<typename Stats> auto history_of(const Vector<Stats>& history) -> std::span<const Stats>
 {
-    // Ignore transform.
-    return vertex_array == other.vertex_array && material == other.material;
+    auto frames = std::span{ history };
+    return frames.last(std::min(frames.size(), Renderer::stats_history_size));
 }
 
-auto DrawCommand::operator<(const DrawCommand& other) const -> bool
+auto to_shader_data(const LightProperties& properties) -> LightPropertiesShaderData
 {
-    // Sort by vertex array first.
-    if (vertex_array < other.vertex_array)
-        return true;
-    else if (vertex_array > other.vertex_array)
-        return false;
+    return LightPropertiesShaderData{
+        .color = properties.color,
+        .ambient = properties.ambient,
+        .diffuse = properties.diffuse,
+        .specular = properties.specular,
+    };
+}
 
-    // Sort by material second.
-    if (material < other.material)
-        return true;
+auto to_shader_data(const LightAttenuation& attenuation) -> LightAttenuationShaderData
+{
+    return LightAttenuationShaderData{
+        .constant = attenuation.constant,
+        .linear = attenuation.linear,
+        .quadratic = attenuation.quadratic,
+    };
+}
 
-    return false;
+template<typename T> auto append_bytes(Vector<byte>& staging, const T& data) -> void
+{
+    auto bytes = std::as_bytes(std::span{ &data, 1 });
+    staging.insert(staging.end(), bytes.begin(), bytes.end());
 }
 
-auto DrawCommand::operator>(const DrawCommand& other) const -> bool
+// Appends a header with the light count followed by the converted lights. The section starts at an offset which can be
+// bound as a range of the buffer.
+template<typename Header, typename RenderData, typename Convert>
+auto stage_lights(Vector<byte>& staging, const Vector<RenderData>& lights, Convert&& convert) -> LightsSsboRange
 {
-    // Sort by vertex array first.
-    if (vertex_array > other.vertex_array)
-        return true;
-    else if (vertex_array < other.vertex_array)
-        return false;
+    auto alignment = gl::Context::ssbo_offset_alignment();
+    auto offset = (static_cast<u32>(staging.size()) + alignment - 1) / alignment * alignment;
+    staging.resize(offset);
+
+    append_bytes(staging, Header{ .count = static_cast<GLuint>(lights.size()) });
 
-    // Sort by material second.
-    if (material > other.material)
-        return true;
+    for (const auto& light : lights)
+        append_bytes(staging, convert(light));
 
-    return false;
+    return LightsSsboRange{ .offset = offset, .size = static_cast<u32>(staging.size()) - offset };
 }
 
-auto DrawCommand::operator<=(const DrawCommand& other) const -> bool
+} // namespace
+
+auto LightsRenderData::clear() -> void
 {
-    return *this < other || *this == other;
+    directional_lights.clear();
+    point_lights.clear();
+    spot_lights.clear();
+    ambient_lights.clear();
 }
 
-auto DrawCommand::operator>=(const DrawCommand& other) const -> bool
+auto MaterialBindings::of(const Material& material) -> MaterialBindings
 {
-    return *this > other || *this == other;
+    return MaterialBindings{
+        .shader = material.shader.get(),
+        .diffuse_map = material.diffuse_map.get(),
+        .specular_map = material.specular_map.get(),
+        .emission_map = material.emission_map.get(),
+    };
+}
+
+auto Hash<MaterialBindings>::operator()(const MaterialBindings& bindings) const -> std::size_t
+{
+    auto hash = [](const void* object) { return std::hash<const void*>{}(object); };
+
+    auto result = hash(bindings.shader);
+    result = result * 31 + hash(bindings.diffuse_map);
+    result = result * 31 + hash(bindings.specular_map);
+    result = result * 31 + hash(bindings.emission_map);
+    return result;
+}
+
+auto DrawCommand::batchable_with(const DrawCommand& other) const -> bool
+{
+    // Ignore transform and material index.
+    return pass == other.pass && vertex_array == other.vertex_array
+           && material_bindings_id == other.material_bindings_id;
+}
+
+auto build_render_batches(std::span<const DrawCommand> draw_commands, std::span<const DrawKeyEntry> sorted_draw_keys,
+                          u32 material_count, Vector<u32>& material_last_batch, Vector<RenderBatch>& batches)
+    -> BatchingStats
+{
+    auto first_batch = batches.size();
+
+    // Every material which shows up in a batch for the first time would've required a separate batch if materials had
+    // to be bound one by one.
+    material_last_batch.assign(material_count, std::numeric_limits<u32>::max());
+    u32 materials_in_batches = 0;
+
+    auto count_material = [&](const DrawCommand& draw_command) {
+        auto batch_index = static_cast<u32>(batches.size());
+
+        if (std::exchange(material_last_batch[draw_command.material_index], batch_index) != batch_index)
+            materials_in_batches++;
+    };
+
+    for (usize i = 0; i < sorted_draw_keys.size(); i++)
+    {
+        // This is the draw command that we'll be comparing with the next draw commands in order to determine whether we
+        // can batch them together.
+        const auto& base_draw_command = draw_commands[sorted_draw_keys[i].index];
+        count_material(base_draw_command);
+
+        RenderBatch batch = {
+            .pass = base_draw_command.pass,
+            .vertex_array = base_draw_command.vertex_array,
+            .material = base_draw_command.material,
+            .material_bindings_id = base_draw_command.material_bindings_id,
+            .first_draw_key = static_cast<u32>(i),
+            .draw_key_count = 1,
+            .instance_count = base_draw_command.transform_count,
+            .retained = base_draw_command.retained,
+        };
+
+        // Go through all the commands which can be rendered in the same batch.
+        while (i + 1 < sorted_draw_keys.size()
+               && base_draw_command.batchable_with(draw_commands[sorted_draw_keys[i + 1].index]))
+        {
+            const auto& draw_command = draw_commands[sorted_draw_keys[i + 1].index];
+            count_material(draw_command);
+
+            batch.draw_key_count++;
+            batch.instance_count += draw_command.transform_count;
+            i++;
+        }
+
+        batches.push_back(batch);
+    }
+
+    auto batch_count = static_cast<u32>(batches.size() - first_batch);
+
+    return BatchingStats{
+        .batches = batch_count,
+        .merged_batches = materials_in_batches - batch_count,
+    };
 }
 
 // This constructor exists only for the purpose of allowing make_unique to construct an instance of the Renderer.
@@ -109,8 +261,53 @@ auto Renderer::start_frame() -> void
 {
     clear();
 
-    renderer->_draw_calls_last_frame = renderer->_draw_calls_this_frame;
-    renderer->_draw_calls_this_frame = 0;
+    gl::StateCache::start_frame();
+
+    auto& stats = renderer->_stats_this_frame;
+    stats.batches = renderer->_batching_stats_this_frame.batches;
+    stats.instance_bytes_uploaded = renderer->_instance_buffer.streaming_stats().bytes_streamed
+                                    + renderer->_compact_instance_buffer.streaming_stats().bytes_streamed
+                                    + renderer->_retained_instance_stats_this_frame.uploaded_bytes;
+    renderer->_stats_last_frame = std::exchange(stats, RendererStats{});
+    push_to_history(renderer->_stats_history, renderer->_stats_last_frame);
+
+    renderer->_culling_stats_last_frame = std::exchange(renderer->_culling_stats_this_frame, CullingStats{});
+    renderer->_occlusion_culling_stats_last_frame =
+        std::exchange(renderer->_occlusion_culling_stats_this_frame, OcclusionCullingStats{});
+    renderer->_batching_stats_last_frame = std::exchange(renderer->_batching_stats_this_frame, BatchingStats{});
+    renderer->_retained_instance_stats_last_frame =
+        std::exchange(renderer->_retained_instance_stats_this_frame, RetainedInstanceStats{});
+    renderer->_light_cluster_stats_last_frame =
+        std::exchange(renderer->_light_cluster_stats_this_frame, LightClusterStats{});
+
+    // The timings arrive a few frames late, so they're the latest ones that the GPU has finished.
+    auto deferred = renderer->_shading_mode == ShadingMode::Deferred;
+    renderer->_render_pass_timings_last_frame = RenderPassTimings{
+        .forward_pass = renderer->_forward_pass_timer.last_elapsed_time().value_or(0.0),
+        .gbuffer_pass = deferred ? renderer->_gbuffer_pass_timer.last_elapsed_time().value_or(0.0) : 0.0,
+        .lighting_pass = deferred ? renderer->_lighting_pass_timer.last_elapsed_time().value_or(0.0) : 0.0,
+        .transparent_pass = renderer->_transparent_pass_timer.last_elapsed_time().value_or(0.0),
+    };
+
+    GLint samples_per_pixel = 0;
+    glGetIntegerv(GL_SAMPLES, &samples_per_pixel);
+    auto viewport_size = viewport();
+    auto viewport_pixels = u64{ viewport_size.x } * viewport_size.y;
+
+    renderer->_overdraw_stats_last_frame = OverdrawStats{
+        .shaded_samples =
+            renderer->_forward_pass_sample_counter.last_sample_count().value_or(0)
+            + (deferred ? renderer->_gbuffer_pass_sample_counter.last_sample_count().value_or(0) : 0),
+        .viewport_samples = viewport_pixels * static_cast<u64>(std::max(samples_per_pixel, 1)),
+    };
+
+    renderer->_instance_buffer_stats_last_frame = renderer->_instance_buffer.streaming_stats();
+    renderer->_instance_buffer.reset_streaming_stats();
+    renderer->_instance_buffer.next_streaming_region();
+    renderer->_compact_instance_buffer_stats_last_frame = renderer->_compact_instance_buffer.streaming_stats();
+    renderer->_compact_instance_buffer.reset_streaming_stats();
+    renderer->_compact_instance_buffer.next_streaming_region();
+    renderer->_draw_indirect_buffer.next_streaming_region();
 }
 
 auto Renderer::on_window_event(const Event& event) -> void
@@ -144,24 +341,16 @@ auto Renderer::shut_down() -> void
 auto Renderer::set_blending_enabled(bool enabled) -> void
 {
     if (enabled)
-    {
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-        glEnable(GL_BLEND);
-    }
-    else
-    {
-        glDisable(GL_BLEND);
-    }
+        gl::StateCache::set_blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    gl::StateCache::set_enabled(gl::Capability::Blend, enabled);
 
     renderer->_blending_enabled = enabled;
 }
 
 auto Renderer::set_depth_test_enabled(bool enabled) -> void
 {
-    if (enabled)
-        glEnable(GL_DEPTH_TEST);
-    else
-        glDisable(GL_DEPTH_TEST);
+    gl::StateCache::set_enabled(gl::Capability::DepthTest, enabled);
 
     renderer->_depth_test_enabled = enabled;
 }
@@ -170,38 +359,70 @@ auto Renderer::set_face_culling_enabled(bool enabled) -> void
 {
     if (enabled)
     {
-        glFrontFace(GL_CCW);
-        glCullFace(GL_BACK);
-        glEnable(GL_CULL_FACE);
-    }
-    else
-    {
-        glDisable(GL_CULL_FACE);
+        gl::StateCache::set_front_face(GL_CCW);
+        gl::StateCache::set_cull_face(GL_BACK);
     }
 
+    gl::StateCache::set_enabled(gl::Capability::CullFace, enabled);
+
     renderer->_face_culling_enabled = enabled;
 }
 
 auto Renderer::set_multisampling_enabled(bool enabled) -> void
 {
-    if (enabled)
-        glEnable(GL_MULTISAMPLE);
-    else
-        glDisable(GL_MULTISAMPLE);
+    gl::StateCache::set_enabled(gl::Capability::Multisample, enabled);
 
     renderer->_multisampling_enabled = enabled;
 }
 
 auto Renderer::set_wireframe_mode_enabled(bool enabled) -> void
 {
-    if (enabled)
-        glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-    else
-        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+    gl::StateCache::set_polygon_mode(enabled ? GL_LINE : GL_FILL);
 
     renderer->_wireframe_mode_enabled = enabled;
 }
 
+auto Renderer::set_multi_draw_indirect_enabled(bool enabled) -> void
+{
+    renderer->_multi_draw_indirect_enabled = enabled;
+}
+
+auto Renderer::set_frustum_culling_enabled(bool enabled) -> void
+{
+    renderer->_frustum_culling_enabled = enabled;
+}
+
+auto Renderer::set_occlusion_culling_enabled(bool enabled) -> void
+{
+    renderer->_occlusion_culling_enabled = enabled;
+}
+
+auto Renderer::set_light_clustering_enabled(bool enabled) -> void
+{
+    renderer->_light_clustering_enabled = enabled;
+}
+
+auto Renderer::set_shading_mode(ShadingMode mode) -> void
+{
+    // The G-buffer's textures get freed by the render graph's pool once the G-buffer pass stops running.
+    renderer->_shading_mode = mode;
+}
+
+auto Renderer::set_front_to_back_sorting_enabled(bool enabled) -> void
+{
+    renderer->_front_to_back_sorting_enabled = enabled;
+}
+
+auto Renderer::set_depth_prepass_enabled(bool enabled) -> void
+{
+    renderer->_depth_prepass_enabled = enabled;
+}
+
+auto Renderer::set_lod_bias(float bias) -> void
+{
+    renderer->_lod_bias = bias;
+}
+
 auto Renderer::set_clear_color(glm::vec4 color) -> void
 {
     auto [r, g, b, a] = color;
@@ -215,6 +436,10 @@ auto Renderer::clear() -> void
 
 auto Renderer::begin_scene(const CameraComponent& camera, const TransformComponent& camera_transform) -> void
 {
+    // The passes of the previous scene still need the data which is about to be overwritten.
+    if (renderer->_scene_recorded)
+        execute_frame_graph();
+
     auto view = camera.view(camera_transform);
     auto projection = camera.projection();
     auto view_projection = projection * view;
@@ -223,12 +448,39 @@ auto Renderer::begin_scene(const CameraComponent& camera, const TransformCompone
     renderer->_current_camera_view = view;
     renderer->_current_camera_projection = projection;
     renderer->_current_camera_view_projection = view_projection;
+    renderer->_current_camera_near = camera.near;
+    renderer->_current_camera_far = camera.far;
 }
 
 auto Renderer::end_scene() -> void
 {
     render();
+    renderer->_scene_recorded = true;
+}
+
+auto Renderer::frame_graph() -> RenderGraph&
+{
+    return renderer->_frame_graph;
+}
+
+auto Renderer::execute_frame_graph() -> void
+{
+    ZTH_PROFILE_FUNCTION();
+
+    auto& graph = renderer->_frame_graph;
+    graph.execute(renderer->_render_graph_pool);
+
+    std::swap(graph, renderer->_frame_graph_last_frame);
+    graph.clear();
+
+    // The scene's data has to stay around until its passes have run.
     reset_renderer_state();
+    renderer->_scene_recorded = false;
+}
+
+auto Renderer::frame_graph_last_frame() -> const RenderGraph&
+{
+    return renderer->_frame_graph_last_frame;
 }
 
 auto Renderer::submit_light(const LightComponent& light, const TransformComponent& light_transform) -> void
@@ -254,7 +506,7 @@ auto Renderer::submit_light(const LightComponent& light, const TransformComponen
 auto Renderer::submit_directional_light(const DirectionalLight& light, const TransformComponent& light_transform)
     -> void
 {
-    renderer->_directional_lights.push_back(DirectionalLightRenderData{
+    renderer->_lights.directional_lights.push_back(DirectionalLightRenderData{
         .direction = light_transform.direction(),
         .properties = light.properties,
     });
@@ -262,7 +514,7 @@ auto Renderer::submit_directional_light(const DirectionalLight& light, const Tra
 
 auto Renderer::submit_point_light(const PointLight& light, const TransformComponent& light_transform) -> void
 {
-    renderer->_point_lights.push_back(PointLightRenderData{
+    renderer->_lights.point_lights.push_back(PointLightRenderData{
         .position = light_transform.translation(),
         .properties = light.properties,
         .attenuation = light.attenuation,
@@ -271,7 +523,7 @@ auto Renderer::submit_point_light(const PointLight& light, const TransformCompon
 
 auto Renderer::submit_spot_light(const SpotLight& light, const TransformComponent& light_transform) -> void
 {
-    renderer->_spot_lights.push_back(SpotLightRenderData{
+    renderer->_lights.spot_lights.push_back(SpotLightRenderData{
         .position = light_transform.translation(),
         .direction = light_transform.direction(),
         .inner_cutoff_cosine = light.inner_cutoff_cosine,
@@ -283,19 +535,52 @@ auto Renderer::submit_spot_light(const SpotLight& light, const TransformComponen
 
 auto Renderer::submit_ambient_light(const AmbientLight& light) -> void
 {
-    renderer->_ambient_lights.push_back(AmbientLightRenderData{
+    renderer->_lights.ambient_lights.push_back(AmbientLightRenderData{
         .ambient = light.ambient,
     });
 }
 
 auto Renderer::submit(const Mesh& mesh, const glm::mat4& transform, const Material& material) -> void
 {
-    submit(mesh.vertex_array(), transform, material);
+    renderer->_draw_list.submit(mesh, transform, material);
 }
 
 auto Renderer::submit(const gl::VertexArray& vertex_array, const glm::mat4& transform, const Material& material) -> void
 {
-    renderer->_draw_commands.emplace_back(&vertex_array, &material, &transform);
+    renderer->_draw_list.submit(vertex_array, transform, material);
+}
+
+auto Renderer::submit(const Mesh& mesh, const TransformComponent& transform, const Material& material) -> void
+{
+    renderer->_draw_list.submit(mesh, transform, material);
+}
+
+auto Renderer::submit(const gl::VertexArray& vertex_array, const TransformComponent& transform,
+                      const Material& material) -> void
+{
+    renderer->_draw_list.submit(vertex_array, transform, material);
+}
+
+auto Renderer::submit_instances(const Mesh& mesh, const Material& material, std::span<const glm::mat4> transforms)
+    -> void
+{
+    renderer->_draw_list.submit_instances(mesh, material, transforms);
+}
+
+auto Renderer::submit_instances(const gl::VertexArray& vertex_array, const Material& material,
+                                std::span<const glm::mat4> transforms) -> void
+{
+    renderer->_draw_list.submit_instances(vertex_array, material, transforms);
+}
+
+auto Renderer::submit(const DrawList& draw_list) -> void
+{
+    renderer->_draw_lists.push_back(&draw_list);
+}
+
+auto Renderer::submit(RetainedDrawList& draw_list) -> void
+{
+    renderer->_retained_draw_lists.push_back(&draw_list);
 }
 
 auto Renderer::viewport() -> glm::uvec2
@@ -348,118 +633,933 @@ auto Renderer::wireframe_mode_enabled() -> bool
     return renderer->_wireframe_mode_enabled;
 }
 
+auto Renderer::multi_draw_indirect_enabled() -> bool
+{
+    return renderer->_multi_draw_indirect_enabled;
+}
+
+auto Renderer::frustum_culling_enabled() -> bool
+{
+    return renderer->_frustum_culling_enabled;
+}
+
+auto Renderer::occlusion_culling_enabled() -> bool
+{
+    return renderer->_occlusion_culling_enabled;
+}
+
+auto Renderer::light_clustering_enabled() -> bool
+{
+    return renderer->_light_clustering_enabled;
+}
+
+auto Renderer::shading_mode() -> ShadingMode
+{
+    return renderer->_shading_mode;
+}
+
+auto Renderer::front_to_back_sorting_enabled() -> bool
+{
+    return renderer->_front_to_back_sorting_enabled;
+}
+
+auto Renderer::depth_prepass_enabled() -> bool
+{
+    return renderer->_depth_prepass_enabled;
+}
+
+auto Renderer::lod_bias() -> float
+{
+    return renderer->_lod_bias;
+}
+
+auto Renderer::clear_geometry_pool() -> void
+{
+    renderer->_geometry_pool.clear();
+}
+
+auto Renderer::release_pooled_geometry(const gl::VertexArray& vertex_array) -> void
+{
+    // Meshes might outlive the renderer.
+    if (!renderer)
+        return;
+
+    renderer->_geometry_pool.release(vertex_array);
+}
+
 auto Renderer::draw_calls_last_frame() -> u32
 {
-    return renderer->_draw_calls_last_frame;
+    return renderer->_stats_last_frame.draw_calls;
+}
+
+auto Renderer::stats_last_frame() -> const RendererStats&
+{
+    return renderer->_stats_last_frame;
+}
+
+auto Renderer::stats_history() -> std::span<const RendererStats>
+{
+    return history_of(renderer->_stats_history);
 }
 
-auto Renderer::instance_buffer() -> const gl::InstanceBuffer&
+auto Renderer::report_culled_instances(u32 count) -> void
 {
-    return renderer->_instance_buffer;
+    renderer->_culling_stats_this_frame.culled_instances += count;
+}
+
+auto Renderer::culling_stats_last_frame() -> const CullingStats&
+{
+    return renderer->_culling_stats_last_frame;
+}
+
+auto Renderer::report_occlusion_culling_stats(const OcclusionCullingStats& stats) -> void
+{
+    renderer->_occlusion_culling_stats_this_frame = stats;
+}
+
+auto Renderer::occlusion_culling_stats_last_frame() -> const OcclusionCullingStats&
+{
+    return renderer->_occlusion_culling_stats_last_frame;
+}
+
+auto Renderer::batching_stats_last_frame() -> const BatchingStats&
+{
+    return renderer->_batching_stats_last_frame;
+}
+
+auto Renderer::retained_instance_stats_last_frame() -> const RetainedInstanceStats&
+{
+    return renderer->_retained_instance_stats_last_frame;
+}
+
+auto Renderer::light_cluster_stats_last_frame() -> const LightClusterStats&
+{
+    return renderer->_light_cluster_stats_last_frame;
+}
+
+auto Renderer::render_pass_timings_last_frame() -> const RenderPassTimings&
+{
+    return renderer->_render_pass_timings_last_frame;
+}
+
+auto Renderer::overdraw_stats_last_frame() -> const OverdrawStats&
+{
+    return renderer->_overdraw_stats_last_frame;
+}
+
+auto Renderer::instance_buffer(InstanceFormat format) -> const gl::InstanceBuffer&
+{
+    switch (format)
+    {
+        using enum InstanceFormat;
+    case Standard:
+        return renderer->_instance_buffer;
+    case Compact:
+        return renderer->_compact_instance_buffer;
+    }
+
+    ZTH_ASSERT(false);
+    std::unreachable();
+}
+
+auto Renderer::instance_format(const gl::VertexArray& vertex_array) -> InstanceFormat
+{
+    if (vertex_array.instance_buffer() == &renderer->_compact_instance_buffer)
+        return InstanceFormat::Compact;
+
+    return InstanceFormat::Standard;
+}
+
+auto Renderer::vertex_format(const gl::VertexArray& vertex_array) -> VertexFormat
+{
+    auto vertex_buffer = vertex_array.vertex_buffer();
+
+    if (vertex_buffer && vertex_buffer->layout() == CompactVertex::layout)
+        return VertexFormat::Compact;
+
+    return VertexFormat::Standard;
+}
+
+auto Renderer::instance_buffer_stats_last_frame(InstanceFormat format) -> const gl::StreamingBufferStats&
+{
+    switch (format)
+    {
+        using enum InstanceFormat;
+    case Standard:
+        return renderer->_instance_buffer_stats_last_frame;
+    case Compact:
+        return renderer->_compact_instance_buffer_stats_last_frame;
+    }
+
+    ZTH_ASSERT(false);
+    std::unreachable();
 }
 
 auto Renderer::render() -> void
 {
     ZTH_PROFILE_FUNCTION();
 
+    auto& stats = renderer->_stats_this_frame;
+
+    stats.directional_lights += static_cast<u32>(renderer->_lights.directional_lights.size());
+    stats.point_lights += static_cast<u32>(renderer->_lights.point_lights.size());
+    stats.spot_lights += static_cast<u32>(renderer->_lights.spot_lights.size());
+    stats.ambient_lights += static_cast<u32>(renderer->_lights.ambient_lights.size());
+
+    auto upload_start = std::chrono::steady_clock::now();
     upload_camera_data(renderer->_current_camera_position, renderer->_current_camera_view_projection);
     upload_light_data();
+    upload_material_table();
+    stats.upload_time += seconds_since(upload_start);
+
+    auto merge_start = std::chrono::steady_clock::now();
+    push_retained_draw_commands();
+    merge_draw_lists();
+    stats.batch_time += seconds_since(merge_start);
+
     batch_draw_commands();
 
-    for (const auto& batch : renderer->_batches)
-        render_batch(batch);
+    // The batches are sorted by pass. They stay around until the frame graph gets executed.
+    auto pass_batches = [batches = std::span{ renderer->_batches }](RenderPass pass) {
+        auto [begin, end] = std::ranges::equal_range(batches, pass, {}, &RenderBatch::pass);
+        return std::span{ begin, end };
+    };
+
+    auto& graph = renderer->_frame_graph;
+    auto backbuffer = graph.backbuffer();
+
+    graph.add_pass(
+        "Forward", [&](RenderGraphPassBuilder& builder) { builder.write_color(backbuffer); },
+        [batches = pass_batches(RenderPass::Opaque)](const RenderGraphPassContext&) {
+            ZTH_PROFILE_GPU_SCOPE("Forward pass");
+
+            count_binds(renderer->_stats_this_frame, [&] {
+                renderer->_forward_pass_timer.begin();
+                render_opaque(batches, renderer->_forward_pass_sample_counter);
+                renderer->_forward_pass_timer.end();
+            });
+        });
+
+    if (auto deferred_batches = pass_batches(RenderPass::Deferred); !deferred_batches.empty())
+        add_deferred_passes(deferred_batches);
+
+    if (auto transparent_batches = pass_batches(RenderPass::Transparent); !transparent_batches.empty())
+    {
+        graph.add_pass(
+            "Transparent", [&](RenderGraphPassBuilder& builder) { builder.write_color(backbuffer); },
+            [transparent_batches](const RenderGraphPassContext&) {
+                count_binds(renderer->_stats_this_frame, [&] { render_transparent(transparent_batches); });
+            });
+    }
+}
+
+auto Renderer::merge_draw_lists() -> void
+{
+    ZTH_PROFILE_FUNCTION();
+
+    auto& draw_lists = renderer->_draw_lists;
+    draw_lists.insert(draw_lists.begin(), &renderer->_draw_list);
+
+    DrawList::merge(draw_lists, renderer->_draw_list_entries, renderer->_transforms, renderer->_rotations,
+                    renderer->_scales);
+
+    // Ids get assigned in submission order, so this part has to stay serial for the batches to come out the same no
+    // matter how the draw lists were recorded.
+    for (const auto& entry : renderer->_draw_list_entries)
+    {
+        push_draw_command(*entry.vertex_array, *entry.material, entry.first_transform, entry.transform_count,
+                          entry.composed);
+    }
+
+    compute_normal_matrices();
+}
+
+auto Renderer::compute_normal_matrices() -> void
+{
+    ZTH_PROFILE_FUNCTION();
+
+    const auto& draw_commands = renderer->_draw_commands;
+    renderer->_normal_matrices.resize(renderer->_transforms.size());
+
+    JobSystem::parallel_for(draw_commands.size(), 64, [&](usize begin, usize end) {
+        for (auto i = begin; i < end; i++)
+        {
+            const auto& draw_command = draw_commands[i];
+
+            if (draw_command.retained || instance_format(*draw_command.vertex_array) == InstanceFormat::Compact)
+                continue;
+
+            auto first = draw_command.first_transform;
+            auto count = draw_command.transform_count;
+            auto normal_matrices = std::span{ renderer->_normal_matrices }.subspan(first, count);
+
+            // Composed transforms don't need an inverse.
+            if (draw_command.composed)
+            {
+                math::compute_normal_matrices(std::span{ renderer->_rotations }.subspan(first, count),
+                                              std::span{ renderer->_scales }.subspan(first, count), normal_matrices);
+            }
+            else
+            {
+                math::compute_normal_matrices(std::span{ renderer->_transforms }.subspan(first, count),
+                                              normal_matrices);
+            }
+        }
+    });
+}
+
+auto Renderer::push_retained_draw_commands() -> void
+{
+    ZTH_PROFILE_FUNCTION();
+
+    auto& stats = renderer->_retained_instance_stats_this_frame;
+    auto frustum = math::Frustum::from_view_projection(renderer->_current_camera_view_projection);
+
+    for (auto draw_list : renderer->_retained_draw_lists)
+    {
+        stats += draw_list->end_frame();
+
+        for (const auto& batch : draw_list->batches())
+        {
+            const auto& slots = batch->slots;
+            const auto& bounds = batch->slots.bounds();
+
+            // Batches with meshes whose bounds weren't computed have infinite bounds and never get culled.
+            auto intersection = math::FrustumIntersection::Inside;
+
+            if (renderer->_frustum_culling_enabled && !glm::any(glm::isinf(bounds.min)))
+                intersection = math::classify(frustum, bounds);
+
+            // The instances of culled batches stay dirty until some of them are visible again.
+            if (intersection == math::FrustumIntersection::Outside)
+            {
+                stats.culled_instances += slots.size();
+                continue;
+            }
+
+            Optional<u32> material_index = nil;
+
+            // Every contiguous range of visible slots gets its own draw command. Just like for the other draw
+            // commands, the depth is determined by the first instance.
+            auto push_slots = [&](u32 first_slot, u32 slot_count) {
+                auto view_depth = -(renderer->_current_camera_view * slots.transforms()[first_slot][3]).z;
+                material_index = push_draw_command(batch->vertex_array, *batch->material, view_depth, first_slot,
+                                                   slot_count, true, false);
+            };
+
+            if (intersection == math::FrustumIntersection::Inside)
+            {
+                push_slots(0, slots.size());
+            }
+            else
+            {
+                auto instance_bounds = slots.instance_bounds();
+                u32 first_visible_slot = 0;
+                u32 visible_slot_count = 0;
+
+                for (u32 slot = 0; slot < slots.size(); slot++)
+                {
+                    if (math::intersects(frustum, instance_bounds[slot]))
+                    {
+                        if (visible_slot_count++ == 0)
+                            first_visible_slot = slot;
+
+                        continue;
+                    }
+
+                    stats.culled_instances++;
+
+                    if (visible_slot_count != 0)
+                        push_slots(first_visible_slot, std::exchange(visible_slot_count, 0));
+                }
+
+                if (visible_slot_count != 0)
+                    push_slots(first_visible_slot, visible_slot_count);
+            }
+
+            if (material_index)
+                stats += draw_list->upload(*batch, *material_index);
+        }
+    }
 }
 
 auto Renderer::draw_indexed(const gl::VertexArray& vertex_array, const Material& material) -> void
 {
     vertex_array.bind();
-    bind_material(material);
+    bind_material(material, vertex_format(vertex_array));
 
     glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(vertex_array.count()),
                    gl::to_gl_enum(vertex_array.indexing_data_type()), nullptr);
 
-    renderer->_draw_calls_this_frame++;
+    auto& stats = renderer->_stats_this_frame;
+    stats.draw_calls++;
+    stats.instances++;
+    stats.triangles += vertex_array.count() / 3;
 }
 
-auto Renderer::draw_instanced(const gl::VertexArray& vertex_array, const Material& material, u32 instances) -> void
+auto Renderer::draw_instanced(const gl::VertexArray& vertex_array, const Material& material, u32 instances,
+                              u32 base_instance) -> void
 {
     vertex_array.bind();
-    bind_material(material);
+    bind_material(material, vertex_format(vertex_array));
 
-    glDrawElementsInstanced(GL_TRIANGLES, static_cast<GLsizei>(vertex_array.count()),
-                            gl::to_gl_enum(vertex_array.indexing_data_type()), nullptr,
-                            static_cast<GLsizei>(instances));
+    glDrawElementsInstancedBaseInstance(GL_TRIANGLES, static_cast<GLsizei>(vertex_array.count()),
+                                        gl::to_gl_enum(vertex_array.indexing_data_type()), nullptr,
+                                        static_cast<GLsizei>(instances), base_instance);
+
+    auto& stats = renderer->_stats_this_frame;
+    stats.draw_calls++;
+    stats.instances += instances;
+    stats.triangles += u64{ vertex_array.count() / 3 } * instances;
+}
+
+auto Renderer::draw_indirect(const gl::VertexArray& vertex_array, const Material& material) -> void
+{
+    auto& commands = renderer->_draw_indirect_commands;
+
+    if (commands.empty())
+        return;
+
+    constexpr auto command_size = static_cast<u32>(sizeof(DrawElementsIndirectCommand));
+    constexpr auto command_alignment = static_cast<u32>(alignof(DrawElementsIndirectCommand));
+
+    auto size_bytes = static_cast<u32>(commands.size()) * command_size;
+    auto allocation = renderer->_draw_indirect_buffer.allocate_streaming(size_bytes, command_alignment);
+    ZTH_ASSERT(allocation.has_value());
+    std::ranges::copy(std::as_bytes(std::span{ commands }), allocation->data.begin());
+
+    vertex_array.bind();
+    bind_material(material, vertex_format(vertex_array));
+
+    // The indirect buffer gets bound in render_batches_indirect().
+    glMultiDrawElementsIndirect(GL_TRIANGLES, gl::to_gl_enum(vertex_array.indexing_data_type()),
+                                reinterpret_cast<const void*>(static_cast<uptr_t>(allocation->offset)),
+                                static_cast<GLsizei>(commands.size()), 0);
+
+    auto& stats = renderer->_stats_this_frame;
+    stats.draw_calls++;
+    stats.draw_indirect_bytes_uploaded += size_bytes;
+
+    for (const auto& command : commands)
+    {
+        stats.instances += command.instance_count;
+        stats.triangles += u64{ command.count / 3 } * command.instance_count;
+    }
+
+    commands.clear();
+}
 
-    renderer->_draw_calls_this_frame++;
+auto Renderer::push_draw_command(const gl::VertexArray& vertex_array, const Material& material, u32 first_transform,
+                                 u32 transform_count, bool composed) -> void
+{
+    // The depth of a draw command is determined by its first instance.
+    auto view_depth = -(renderer->_current_camera_view * renderer->_transforms[first_transform][3]).z;
+    push_draw_command(vertex_array, material, view_depth, first_transform, transform_count, false, composed);
+}
+
+auto Renderer::push_draw_command(const gl::VertexArray& vertex_array, const Material& material, float view_depth,
+                                 u32 first_transform, u32 transform_count, bool retained, bool composed) -> u32
+{
+    // Material ids are assigned in the order in which the materials get submitted, so a new material always gets the
+    // next free slot in the material table.
+    auto material_index = renderer->_material_ids.get(&material);
+
+    if (material_index == renderer->_materials.size())
+    {
+        auto [kv, _] = renderer->_material_bindings_id_map.try_emplace(
+            MaterialBindings::of(material), static_cast<u32>(renderer->_material_bindings_id_map.size()));
+
+        renderer->_materials.push_back(&material);
+        renderer->_material_bindings_ids.push_back(kv->second);
+    }
+
+    auto material_bindings_id = renderer->_material_bindings_ids[material_index];
+
+    auto pass = RenderPass::Opaque;
+
+    if (material.transparent)
+        pass = RenderPass::Transparent;
+    else if (renderer->_shading_mode == ShadingMode::Deferred && material.shader == shaders::standard())
+        pass = RenderPass::Deferred; // Only the standard shader's lighting has a deferred counterpart.
+
+    // Without a depth, opaque draw commands which share state stay in the order in which they were submitted.
+    u16 depth = 0;
+
+    if (renderer->_front_to_back_sorting_enabled || pass == RenderPass::Transparent)
+        depth = quantize_draw_key_depth(view_depth, renderer->_current_camera_near, renderer->_current_camera_far);
+
+    auto key = make_draw_key(pass, renderer->_shader_ids.get(material.shader.get()), material_bindings_id,
+                             renderer->_vertex_array_ids.get(&vertex_array), depth);
+
+    renderer->_culling_stats_this_frame.submitted_instances += transform_count;
+    renderer->_draw_keys.emplace_back(key, static_cast<u32>(renderer->_draw_commands.size()));
+    renderer->_draw_commands.emplace_back(pass, &vertex_array, &material, material_index, material_bindings_id,
+                                          first_transform, transform_count, retained, composed);
+
+    return material_index;
 }
 
 auto Renderer::batch_draw_commands() -> void
 {
     ZTH_PROFILE_FUNCTION();
 
-    // @speed: We should look into how we could batch draw commands more efficiently. It would probably also be more
-    // optimal to copy the transforms rather than storing pointers to them for better cache efficiency.
+    auto& draw_keys = renderer->_draw_keys;
 
-    auto& draw_commands = renderer->_draw_commands;
-    std::ranges::sort(draw_commands);
+    auto& stats = renderer->_stats_this_frame;
 
-    // @todo: Get rid of the temporary transforms vector.
-    // @cleanup: This shouldn't be static.
-    static Vector<const glm::mat4*> transforms;
-    transforms.clear();
+    auto sort_start = std::chrono::steady_clock::now();
+    renderer->_draw_keys_scratch.resize(draw_keys.size());
+    radix_sort_draw_keys(draw_keys, renderer->_draw_keys_scratch);
+    stats.sort_time += seconds_since(sort_start);
 
-    for (usize i = 0; i < draw_commands.size(); i++)
+    auto batch_start = std::chrono::steady_clock::now();
+    auto material_count = static_cast<u32>(renderer->_materials.size());
+    auto batching_stats = build_render_batches(renderer->_draw_commands, draw_keys, material_count,
+                                               renderer->_material_last_batch, renderer->_batches);
+    stats.batch_time += seconds_since(batch_start);
+
+    renderer->_batching_stats_this_frame.batches += batching_stats.batches;
+    renderer->_batching_stats_this_frame.merged_batches += batching_stats.merged_batches;
+}
+
+template<typename BeforeRegionChange, typename OnChunk>
+auto Renderer::stream_instances(const RenderBatch& batch, BeforeRegionChange&& before_region_change,
+                                OnChunk&& on_chunk) -> void
+{
+    switch (instance_format(*batch.vertex_array))
     {
-        // This is the draw command that we'll be comparing with the next draw commands in order to determine whether we
-        // can batch them together.
-        const auto& base_draw_command = draw_commands[i];
-        transforms.push_back(base_draw_command.transform);
+        using enum InstanceFormat;
+    case Standard:
+        stream_instances<InstanceVertex>(batch, renderer->_instance_buffer, before_region_change, on_chunk);
+        break;
+    case Compact:
+        stream_instances<CompactInstanceVertex>(batch, renderer->_compact_instance_buffer, before_region_change,
+                                                on_chunk);
+        break;
+    }
+}
 
-        // Go through all the commands which can be rendered in the same batch.
-        while (i + 1 < draw_commands.size() && base_draw_command == draw_commands[i + 1])
+template<typename Instance, typename BeforeRegionChange, typename OnChunk>
+auto Renderer::stream_instances(const RenderBatch& batch, gl::InstanceBuffer& instance_buffer,
+                                BeforeRegionChange&& before_region_change, OnChunk&& on_chunk) -> void
+{
+    constexpr auto instance_size = static_cast<u32>(sizeof(Instance));
+    constexpr auto max_instances_per_chunk = static_cast<u32>(instances_per_instance_buffer_region);
+
+    std::span<Instance> instances;
+    u32 instances_written = 0;
+    u32 instances_left = batch.instance_count;
+    u32 base_instance = 0;
+
+    auto allocate_chunk = [&] {
+        auto instance_count = std::min(instances_left, max_instances_per_chunk);
+
+        if (!instance_buffer.fits_in_streaming_region(instance_count * instance_size, instance_size))
+            before_region_change();
+
+        auto allocation = instance_buffer.allocate_streaming(instance_count * instance_size, instance_size);
+        ZTH_ASSERT(allocation.has_value());
+
+        instances = { static_cast<Instance*>(static_cast<void*>(allocation->data.data())), instance_count };
+        instances_written = 0;
+        base_instance = allocation->offset / instance_size;
+    };
+
+    const auto draw_keys = std::span{ renderer->_draw_keys }.subspan(batch.first_draw_key, batch.draw_key_count);
+
+    for (const auto& draw_key : draw_keys)
+    {
+        const auto& draw_command = renderer->_draw_commands[draw_key.index];
+        const auto& position_transform = draw_command.vertex_array->position_transform();
+        auto transforms_end = draw_command.first_transform + draw_command.transform_count;
+
+        for (auto i = draw_command.first_transform; i < transforms_end; i++)
         {
-            transforms.push_back(draw_commands[i + 1].transform);
-            i++;
+            if (instances_written == instances.size())
+            {
+                if (instances_written != 0)
+                    on_chunk(instances_written, base_instance);
+
+                allocate_chunk();
+            }
+
+            // We're writing straight into mapped memory, so we shouldn't read from it.
+            const auto& transform = renderer->_transforms[i];
+
+            if constexpr (std::same_as<Instance, CompactInstanceVertex>)
+            {
+                if (draw_command.composed)
+                {
+                    // The position transform's offset gets rotated and scaled together with the positions.
+                    auto rotation = renderer->_rotations[i];
+                    auto scale = renderer->_scales[i];
+                    auto translation = glm::vec3{ transform[3] } + rotation * (scale * position_transform.offset);
+
+                    instances[instances_written++] = CompactInstanceVertex::from_trs(
+                        translation, rotation, scale * position_transform.scale, draw_command.material_index);
+                }
+                else
+                {
+                    // Only transforms which weren't composed from a rotation and a scale have to be decomposed.
+                    instances[instances_written++] = CompactInstanceVertex::from_transform(
+                        apply_position_transform(transform, position_transform), draw_command.material_index);
+                }
+            }
+            else
+            {
+                // The normal matrix stays the same, as the position transform's scale is uniform.
+                auto instance_transform = apply_position_transform(transform, position_transform);
+
+                instances[instances_written++] = InstanceVertex{
+                    draw_command.material_index, instance_transform[0], instance_transform[1], instance_transform[2],
+                    instance_transform[3], renderer->_normal_matrices[i],
+                };
+            }
+
+            instances_left--;
         }
+    }
 
-        RenderBatch batch = {
-            .vertex_array = base_draw_command.vertex_array,
-            .material = base_draw_command.material,
-            .transforms = {},
-        };
+    if (instances_written != 0)
+        on_chunk(instances_written, base_instance);
+}
 
-        // @speed: We could probably do something better here than copying all the pointers.
-        std::ranges::move(transforms, std::back_inserter(batch.transforms));
-        renderer->_batches.push_back(std::move(batch));
-        transforms.clear();
+auto Renderer::render_batches(std::span<const RenderBatch> batches) -> void
+{
+    if (renderer->_multi_draw_indirect_enabled)
+    {
+        render_batches_indirect(batches);
+    }
+    else
+    {
+        for (const auto& batch : batches)
+            render_batch(batch);
     }
 }
 
+auto Renderer::render_opaque(std::span<const RenderBatch> batches, gl::SampleCounter& sample_counter) -> void
+{
+    if (!renderer->_depth_prepass_enabled || !renderer->_depth_test_enabled)
+    {
+        sample_counter.begin();
+        render_batches(batches);
+        sample_counter.end();
+        return;
+    }
+
+    // Only the batches whose vertex shaders produce the same depth as the depth-only one can be shaded with GL_EQUAL.
+    // The rest, e.g. the ones with custom shaders, don't take part in the pre-pass and get depth tested as usual.
+    TemporaryVector<RenderBatch> prepass_batches;
+    TemporaryVector<RenderBatch> other_batches;
+
+    for (const auto& batch : batches)
+    {
+        const auto& shader = renderer->_shader_override ? *renderer->_shader_override : *batch.material->shader;
+
+        if (shaders::matches_depth_only(shader))
+            prepass_batches.push_back(batch);
+        else
+            other_batches.push_back(batch);
+    }
+
+    auto& stats = renderer->_stats_this_frame;
+
+    if (!prepass_batches.empty())
+    {
+        ZTH_PROFILE_GPU_SCOPE("Depth pre-pass");
+
+        // The instance data gets streamed again for the shading pass. Holding on to it would require keeping the
+        // regions of the instance buffer that the pre-pass used from being reused in the meantime.
+        auto draw_calls = stats.draw_calls;
+        auto shading_shader = std::exchange(renderer->_shader_override, shaders::depth_only().get());
+        gl::StateCache::set_color_mask(false);
+
+        render_batches(prepass_batches);
+
+        gl::StateCache::set_color_mask(true);
+        renderer->_shader_override = shading_shader;
+        stats.depth_prepass_draw_calls += stats.draw_calls - draw_calls;
+    }
+
+    sample_counter.begin();
+
+    // The batches which weren't in the pre-pass go first, so that the depth they write keeps the fragments of the
+    // pre-pass batches which are hidden behind them from being shaded too. They're drawn with GL_LEQUAL, so that they
+    // still show up where they're exactly as close as the pre-pass's depth.
+    gl::StateCache::set_depth_func(GL_LEQUAL);
+    render_batches(other_batches);
+
+    // Only the closest surfaces pass, so the fragments hidden behind them never get shaded.
+    gl::StateCache::set_depth_func(GL_EQUAL);
+    gl::StateCache::set_depth_mask(false);
+    render_batches(prepass_batches);
+
+    sample_counter.end();
+
+    gl::StateCache::set_depth_func(GL_LESS);
+    gl::StateCache::set_depth_mask(true);
+}
+
+auto Renderer::render_transparent(std::span<const RenderBatch> batches) -> void
+{
+    ZTH_PROFILE_GPU_SCOPE("Transparent pass");
+
+    auto& stats = renderer->_stats_this_frame;
+    auto draw_calls = stats.draw_calls;
+
+    renderer->_transparent_pass_timer.begin();
+
+    // Transparent surfaces get blended over each other back to front, so they mustn't hide the ones behind them.
+    gl::StateCache::set_blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    gl::StateCache::set_enabled(gl::Capability::Blend, true);
+    gl::StateCache::set_depth_mask(false);
+
+    render_batches(batches);
+
+    gl::StateCache::set_depth_mask(true);
+    set_blending_enabled(renderer->_blending_enabled);
+
+    renderer->_transparent_pass_timer.end();
+
+    stats.transparent_draw_calls += stats.draw_calls - draw_calls;
+}
+
 auto Renderer::render_batch(const RenderBatch& batch) -> void
 {
-    ZTH_PROFILE_FUNCTION();
+    if (batch.retained)
+    {
+        render_retained_batch(batch);
+        return;
+    }
+
+    // Every chunk gets drawn right after it's written, so there are no pending draw calls when the region changes.
+    stream_instances(
+        batch, [] {},
+        [&](u32 instance_count, u32 base_instance) {
+            draw_instanced(*batch.vertex_array, *batch.material, instance_count, base_instance);
+        });
+}
+
+auto Renderer::render_retained_batch(const RenderBatch& batch) -> void
+{
+    // A retained batch's instances are already in its vertex array's own instance buffer. Every draw command refers to
+    // a range of its slots.
+    const auto draw_keys = std::span{ renderer->_draw_keys }.subspan(batch.first_draw_key, batch.draw_key_count);
+
+    if (draw_keys.size() == 1 || !renderer->_multi_draw_indirect_enabled)
+    {
+        for (const auto& draw_key : draw_keys)
+        {
+            const auto& draw_command = renderer->_draw_commands[draw_key.index];
+            draw_instanced(*batch.vertex_array, *batch.material, draw_command.transform_count,
+                           draw_command.first_transform);
+        }
+
+        return;
+    }
+
+    // The ranges which were left over after culling the batch's instances get drawn with a single call.
+    auto& commands = renderer->_draw_indirect_commands;
+    ZTH_ASSERT(commands.empty());
 
-    auto& instance_data = renderer->_temporary_instance_data;
-    instance_data.clear();
+    gl::StateCache::bind_buffer(GL_DRAW_INDIRECT_BUFFER, renderer->_draw_indirect_buffer.native_handle());
 
-    for (auto& transform_ptr : batch.transforms)
+    for (const auto& draw_key : draw_keys)
     {
-        const auto& transform = *transform_ptr;
-        auto normal_matrix = math::get_normal_matrix(transform);
-        instance_data.emplace_back(transform[0], transform[1], transform[2], transform[3], normal_matrix);
+        const auto& draw_command = renderer->_draw_commands[draw_key.index];
+
+        commands.push_back(DrawElementsIndirectCommand{
+            .count = batch.vertex_array->count(),
+            .instance_count = draw_command.transform_count,
+            .first_index = 0,
+            .base_vertex = 0,
+            .base_instance = draw_command.first_transform,
+        });
+
+        if (commands.size() == max_draw_indirect_commands)
+            draw_indirect(*batch.vertex_array, *batch.material);
     }
 
-    renderer->_instance_buffer.buffer_data(instance_data);
-    draw_instanced(*batch.vertex_array, *batch.material, static_cast<u32>(instance_data.size()));
+    draw_indirect(*batch.vertex_array, *batch.material);
 }
 
-auto Renderer::bind_material(const Material& material) -> void
+auto Renderer::render_batches_indirect(std::span<const RenderBatch> batches) -> void
+{
+    auto& commands = renderer->_draw_indirect_commands;
+    ZTH_ASSERT(commands.empty());
+
+    // Commands get accumulated for as long as the batches use the same shared vertex array and material bindings.
+    const gl::VertexArray* vertex_array = nullptr;
+    const Material* material = nullptr;
+    u32 material_bindings_id = 0;
+
+    auto flush = [&] {
+        if (vertex_array)
+            draw_indirect(*vertex_array, *material);
+    };
+
+    gl::StateCache::bind_buffer(GL_DRAW_INDIRECT_BUFFER, renderer->_draw_indirect_buffer.native_handle());
+
+    for (const auto& batch : batches)
+    {
+        // Retained batches aren't in the geometry pool, as their vertex arrays are bound to their own instance buffers.
+        auto geometry = batch.retained ? nil : renderer->_geometry_pool.get(*batch.vertex_array);
+
+        if (!geometry)
+        {
+            // The pending commands have to be drawn first, as rendering the batch might make us move on to the next
+            // region of the instance buffer.
+            flush();
+            render_batch(batch);
+            continue;
+        }
+
+        if (geometry->vertex_array != vertex_array || batch.material_bindings_id != material_bindings_id)
+        {
+            flush();
+            vertex_array = geometry->vertex_array;
+            material = batch.material;
+            material_bindings_id = batch.material_bindings_id;
+        }
+
+        stream_instances(batch, flush, [&](u32 instance_count, u32 base_instance) {
+            commands.push_back(DrawElementsIndirectCommand{
+                .count = geometry->index_count,
+                .instance_count = instance_count,
+                .first_index = geometry->first_index,
+                .base_vertex = geometry->base_vertex,
+                .base_instance = base_instance,
+            });
+
+            if (commands.size() == max_draw_indirect_commands)
+                flush();
+        });
+    }
+
+    flush();
+    gl::StateCache::bind_buffer(GL_DRAW_INDIRECT_BUFFER, GL_NONE);
+}
+
+auto Renderer::add_deferred_passes(std::span<const RenderBatch> batches) -> void
+{
+    auto viewport_size = viewport();
+
+    // The window is minimized.
+    if (viewport_size.x == 0 || viewport_size.y == 0)
+        return;
+
+    auto& graph = renderer->_frame_graph;
+
+    auto create_target = [&](StringView name, gl::SizedTextureFormat format) {
+        return graph.create_texture(name, RenderGraphTextureDesc{ .size = viewport_size, .format = format });
+    };
+
+    auto albedo = create_target("G-Buffer Albedo", gl::SizedTextureFormat::Rgba8);
+    auto normal = create_target("G-Buffer Normal", gl::SizedTextureFormat::Rgba16f);
+    auto specular = create_target("G-Buffer Specular", gl::SizedTextureFormat::Rgba8);
+    auto emission = create_target("G-Buffer Emission", gl::SizedTextureFormat::Rgba8);
+    auto material_index = create_target("G-Buffer Material Index", gl::SizedTextureFormat::R32ui);
+    auto depth = create_target("G-Buffer Depth", gl::SizedTextureFormat::Depth32f);
+
+    graph.add_pass(
+        "G-Buffer",
+        [&](RenderGraphPassBuilder& builder) {
+            // The color attachments get bound in the order in which they're declared.
+            static_assert(gbuffer_albedo_attachment == 0);
+            static_assert(gbuffer_normal_attachment == 1);
+            static_assert(gbuffer_specular_attachment == 2);
+            static_assert(gbuffer_emission_attachment == 3);
+            static_assert(gbuffer_material_index_attachment == 4);
+
+            builder.write_color(albedo);
+            builder.write_color(normal);
+            builder.write_color(specular);
+            builder.write_color(emission);
+            builder.write_color(material_index);
+            builder.write_depth(depth);
+        },
+        [batches](const RenderGraphPassContext& context) {
+            ZTH_PROFILE_GPU_SCOPE("G-buffer pass");
+
+            const auto& framebuffer = *context.framebuffer();
+
+            // Blending would mix the G-buffer's contents with the values it was cleared to.
+            gl::StateCache::set_enabled(gl::Capability::Blend, false);
+
+            renderer->_gbuffer_pass_timer.begin();
+
+            for (auto attachment : { gbuffer_albedo_attachment, gbuffer_normal_attachment,
+                                     gbuffer_specular_attachment, gbuffer_emission_attachment })
+                framebuffer.clear_color(attachment, glm::vec4{ 0.0f });
+
+            framebuffer.clear_color(gbuffer_material_index_attachment, glm::uvec4{ 0 });
+            framebuffer.clear_depth();
+
+            count_binds(renderer->_stats_this_frame, [&] {
+                renderer->_shader_override = shaders::deferred_geometry().get();
+                render_opaque(batches, renderer->_gbuffer_pass_sample_counter);
+                renderer->_shader_override = nullptr;
+            });
+
+            renderer->_gbuffer_pass_timer.end();
+        });
+
+    graph.add_pass(
+        "Deferred Lighting",
+        [&](RenderGraphPassBuilder& builder) {
+            builder.read(albedo);
+            builder.read(normal);
+            builder.read(specular);
+            builder.read(emission);
+            builder.read(material_index);
+            builder.read(depth);
+            builder.write_color(graph.backbuffer());
+        },
+        [=, inverse_view_projection = glm::inverse(renderer->_current_camera_view_projection)](
+            const RenderGraphPassContext& context) {
+            ZTH_PROFILE_GPU_SCOPE("Lighting pass");
+
+            renderer->_lighting_pass_timer.begin();
+
+            count_binds(renderer->_stats_this_frame, [&] {
+                context.texture(albedo).bind(gbuffer_albedo_slot);
+                context.texture(normal).bind(gbuffer_normal_slot);
+                context.texture(specular).bind(gbuffer_specular_slot);
+                context.texture(emission).bind(gbuffer_emission_slot);
+                context.texture(material_index).bind(gbuffer_material_index_slot);
+                context.texture(depth).bind(gbuffer_depth_slot);
+
+                const auto& lighting_shader = *shaders::deferred_lighting();
+                lighting_shader.bind();
+                lighting_shader.set_unif("inverse_view_projection", inverse_view_projection);
+
+                // The lighting pass writes the G-buffer's depth, so anything that has been rendered in front of the
+                // deferred geometry stays visible.
+                gl::StateCache::set_polygon_mode(GL_FILL);
+                renderer->_empty_vertex_array.bind();
+            });
+
+            glDrawArrays(GL_TRIANGLES, 0, 3);
+            renderer->_stats_this_frame.draw_calls++;
+            renderer->_stats_this_frame.triangles++;
+
+            renderer->_lighting_pass_timer.end();
+
+            set_wireframe_mode_enabled(renderer->_wireframe_mode_enabled);
+            set_blending_enabled(renderer->_blending_enabled);
+        });
+}
+
+auto Renderer::bind_material(const Material& material, VertexFormat vertex_format) -> void
 {
     ZTH_PROFILE_FUNCTION();
 
     ZTH_ASSERT(material.shader != nullptr);
-    material.shader->bind();
-    upload_material_data(material);
+
+    renderer->_stats_this_frame.material_binds++;
+
+    const auto& shader = renderer->_shader_override ? *renderer->_shader_override : *material.shader;
+    shaders::vertex_format_variant(shader, vertex_format).bind();
 
     if (material.diffuse_map)
         material.diffuse_map->bind(diffuse_map_slot);
@@ -486,154 +1586,206 @@ auto Renderer::upload_camera_data(glm::vec3 camera_position, const glm::mat4& vi
         .camera_position = camera_position,
     };
 
-    renderer->_camera_ubo.buffer_data(camera_ubo_data);
+    auto& stats = renderer->_stats_this_frame;
+    upload_to(renderer->_camera_ubo, camera_ubo_data, stats.uniform_bytes_uploaded, stats.buffer_reallocations);
 }
 
-auto Renderer::upload_material_data(const Material& material) -> void
+auto Renderer::upload_material_table() -> void
 {
     ZTH_PROFILE_FUNCTION();
 
-    MaterialUboData material_ubo_data = {
-        .albedo = material.albedo,
-        .ambient = material.ambient,
-        .diffuse = material.diffuse,
-        .specular = material.specular,
-        .shininess = material.shininess,
-    };
+    auto& material_table = renderer->_material_table;
+    material_table.clear();
+
+    for (const auto* material : renderer->_materials)
+    {
+        material_table.push_back(MaterialShaderData{
+            .albedo = material->albedo,
+            .ambient = material->ambient,
+            .diffuse = material->diffuse,
+            .specular = material->specular,
+            .shininess = material->shininess,
+        });
+    }
+
+    // Materials rarely change from one frame to the next, and they usually get submitted in the same order.
+    if (material_table == renderer->_uploaded_material_table)
+        return;
 
-    renderer->_material_ubo.buffer_data(material_ubo_data);
+    auto& stats = renderer->_stats_this_frame;
+    upload_to(renderer->_materials_ssbo, material_table, stats.storage_bytes_uploaded, stats.buffer_reallocations);
+    std::swap(material_table, renderer->_uploaded_material_table);
 }
 
 auto Renderer::upload_light_data() -> void
 {
     ZTH_PROFILE_FUNCTION();
 
-    // @speed: Maybe we should collect all the data first and then buffer it all at once in these functions?
-    // Also: we probably shouldn't buffer all this data every frame, but only when it changes.
+    // Lights rarely change from one frame to the next, in which case the data we uploaded last is still valid.
+    if (!renderer->_uploaded_lights || renderer->_lights != *renderer->_uploaded_lights)
+    {
+        renderer->_lights_staging.clear();
 
-    upload_directional_lights_data();
-    upload_point_lights_data();
-    upload_spot_lights_data();
-    upload_ambient_lights_data();
-}
+        renderer->_lights_ssbo_ranges = {
+            stage_directional_lights_data(),
+            stage_point_lights_data(),
+            stage_spot_lights_data(),
+            stage_ambient_lights_data(),
+        };
 
-auto Renderer::upload_directional_lights_data() -> void
-{
-    DirectionalLightsSsboData directional_lights_ssbo_data = {
-        .count = static_cast<GLuint>(renderer->_directional_lights.size()),
-    };
+        auto& stats = renderer->_stats_this_frame;
+        upload_to(renderer->_lights_ssbo, renderer->_lights_staging, stats.storage_bytes_uploaded,
+                  stats.buffer_reallocations);
+        renderer->_uploaded_lights = renderer->_lights;
+    }
 
-    u32 offset = 0;
-    offset += renderer->_directional_lights_ssbo.buffer_data(directional_lights_ssbo_data);
+    static constexpr std::array binding_points = {
+        directional_lights_ssbo_binding_point,
+        point_lights_ssbo_binding_point,
+        spot_lights_ssbo_binding_point,
+        ambient_lights_ssbo_binding_point,
+    };
 
-    for (const auto& [direction, properties] : renderer->_directional_lights)
+    for (usize i = 0; i < binding_points.size(); i++)
     {
-        DirectionalLightShaderData data = {
-            .direction = direction,
-            .properties = {
-                .color = properties.color,
-                .ambient = properties.ambient,
-                .diffuse = properties.diffuse,
-                .specular = properties.specular,
-            },
-        };
-
-        offset += renderer->_directional_lights_ssbo.buffer_data(data, offset);
+        auto [offset, size] = renderer->_lights_ssbo_ranges[i];
+        renderer->_lights_ssbo.bind_range(binding_points[i], offset, size);
     }
+
+    upload_light_clusters();
 }
 
-auto Renderer::upload_point_lights_data() -> void
+auto Renderer::stage_directional_lights_data() -> LightsSsboRange
 {
-    PointLightsSsboData point_lights_ssbo_data = {
-        .count = static_cast<GLuint>(renderer->_point_lights.size()),
-    };
+    return stage_lights<DirectionalLightsSsboData>(
+        renderer->_lights_staging, renderer->_lights.directional_lights,
+        [](const DirectionalLightRenderData& light) {
+            return DirectionalLightShaderData{
+                .direction = light.direction,
+                .properties = to_shader_data(light.properties),
+            };
+        });
+}
 
-    u32 offset = 0;
-    offset += renderer->_point_lights_ssbo.buffer_data(point_lights_ssbo_data);
+auto Renderer::stage_point_lights_data() -> LightsSsboRange
+{
+    return stage_lights<PointLightsSsboData>(renderer->_lights_staging, renderer->_lights.point_lights,
+                                             [](const PointLightRenderData& light) {
+                                                 return PointLightShaderData{
+                                                     .position = light.position,
+                                                     .properties = to_shader_data(light.properties),
+                                                     .attenuation = to_shader_data(light.attenuation),
+                                                 };
+                                             });
+}
 
-    for (const auto& [position, properties, attenuation] : renderer->_point_lights)
-    {
-        PointLightShaderData data = {
-            .position = position,
-            .properties = {
-                .color = properties.color,
-                .ambient = properties.ambient,
-                .diffuse = properties.diffuse,
-                .specular = properties.specular,
-            },
-            .attenuation = {
-                .constant = attenuation.constant,
-                .linear = attenuation.linear,
-                .quadratic = attenuation.quadratic,
-            },
-        };
+auto Renderer::stage_spot_lights_data() -> LightsSsboRange
+{
+    return stage_lights<SpotLightsSsboData>(renderer->_lights_staging, renderer->_lights.spot_lights,
+                                            [](const SpotLightRenderData& light) {
+                                                return SpotLightShaderData{
+                                                    .position = light.position,
+                                                    .direction = light.direction,
+                                                    .inner_cutoff_cosine = light.inner_cutoff_cosine,
+                                                    .outer_cutoff_cosine = light.outer_cutoff_cosine,
+                                                    .properties = to_shader_data(light.properties),
+                                                    .attenuation = to_shader_data(light.attenuation),
+                                                };
+                                            });
+}
 
-        offset += renderer->_point_lights_ssbo.buffer_data(data, offset);
-    }
+auto Renderer::stage_ambient_lights_data() -> LightsSsboRange
+{
+    return stage_lights<AmbientLightsSsboData>(renderer->_lights_staging, renderer->_lights.ambient_lights,
+                                               [](const AmbientLightRenderData& light) {
+                                                   return AmbientLightShaderData{ .ambient = light.ambient };
+                                               });
 }
 
-auto Renderer::upload_spot_lights_data() -> void
+auto Renderer::upload_light_clusters() -> void
 {
-    SpotLightsSsboData spot_lights_ssbo_data = {
-        .count = static_cast<GLuint>(renderer->_spot_lights.size()),
-    };
+    ZTH_PROFILE_FUNCTION();
 
-    u32 offset = 0;
-    offset += renderer->_spot_lights_ssbo.buffer_data(spot_lights_ssbo_data);
+    const auto& view = renderer->_current_camera_view;
+    auto& grid = renderer->_light_cluster_grid;
+    auto& staging = renderer->_light_clusters_staging;
+    auto& stats = renderer->_stats_this_frame;
 
-    for (const auto& [position, direction, inner_cutoff_cosine, outer_cutoff_cosine, properties, attenuation] :
-         renderer->_spot_lights)
-    {
-        SpotLightShaderData data = {
-            .position = position,
-            .direction = direction,
-            .inner_cutoff_cosine = inner_cutoff_cosine,
-            .outer_cutoff_cosine = outer_cutoff_cosine,
-            .properties = {
-                .color = properties.color,
-                .ambient = properties.ambient,
-                .diffuse = properties.diffuse,
-                .specular = properties.specular,
-            },
-            .attenuation = {
-                .constant = attenuation.constant,
-                .linear = attenuation.linear,
-                .quadratic = attenuation.quadratic,
-            },
-        };
+    staging.clear();
 
-        offset += renderer->_spot_lights_ssbo.buffer_data(data, offset);
+    if (!renderer->_light_clustering_enabled)
+    {
+        // The shader falls back to iterating over every light.
+        append_bytes(staging, LightClustersSsboData{ .grid_size = glm::uvec4{ grid.size(), 0 } });
+        upload_to(renderer->_light_clusters_ssbo, staging, stats.storage_bytes_uploaded, stats.buffer_reallocations);
+        return;
     }
-}
 
-auto Renderer::upload_ambient_lights_data() -> void
-{
-    AmbientLightsSsboData ambient_lights_ssbo_data = {
-        .count = static_cast<GLuint>(renderer->_ambient_lights.size()),
-    };
+    auto& point_light_bounds = renderer->_point_light_bounds;
+    auto& spot_light_bounds = renderer->_spot_light_bounds;
 
-    u32 offset = 0;
-    offset += renderer->_ambient_lights_ssbo.buffer_data(ambient_lights_ssbo_data);
+    point_light_bounds.clear();
+    spot_light_bounds.clear();
 
-    for (const auto& [ambient] : renderer->_ambient_lights)
+    for (const auto& light : renderer->_lights.point_lights)
     {
-        AmbientLightShaderData data = {
-            .ambient = ambient,
-        };
+        point_light_bounds.push_back(math::BoundingSphere{
+            .center = glm::vec3{ view * glm::vec4{ light.position, 1.0f } },
+            .radius = light.attenuation.range(),
+        });
+    }
 
-        offset += renderer->_ambient_lights_ssbo.buffer_data(data, offset);
+    for (const auto& light : renderer->_lights.spot_lights)
+    {
+        spot_light_bounds.push_back(zth::spot_light_bounds(glm::vec3{ view * glm::vec4{ light.position, 1.0f } },
+                                                           glm::normalize(glm::mat3{ view } * light.direction),
+                                                           light.attenuation.range(), light.outer_cutoff_cosine));
     }
+
+    grid.build(renderer->_current_camera_projection, renderer->_current_camera_near, renderer->_current_camera_far,
+               point_light_bounds, spot_light_bounds);
+
+    append_bytes(staging, LightClustersSsboData{
+                              .view = view,
+                              .grid_size = glm::uvec4{ grid.size(), 1 },
+                              .viewport_size = glm::vec2{ viewport() },
+                              .depth_slice_scale = grid.depth_slice_scale(),
+                              .depth_slice_bias = grid.depth_slice_bias(),
+                          });
+
+    auto clusters = std::as_bytes(grid.clusters());
+    staging.insert(staging.end(), clusters.begin(), clusters.end());
+
+    upload_to(renderer->_light_clusters_ssbo, staging, stats.storage_bytes_uploaded, stats.buffer_reallocations);
+    upload_to(renderer->_light_indices_ssbo, grid.light_indices(), stats.storage_bytes_uploaded,
+              stats.buffer_reallocations);
+
+    renderer->_light_cluster_stats_this_frame = grid.stats();
 }
 
 auto Renderer::reset_renderer_state() -> void
 {
     renderer->_draw_commands.clear();
     renderer->_batches.clear();
+    renderer->_draw_list.clear();
+    renderer->_draw_lists.clear();
+    renderer->_retained_draw_lists.clear();
+    renderer->_draw_list_entries.clear();
+    renderer->_transforms.clear();
+    renderer->_rotations.clear();
+    renderer->_scales.clear();
+    renderer->_normal_matrices.clear();
+
+    renderer->_materials.clear();
+    renderer->_material_bindings_ids.clear();
+    renderer->_material_bindings_id_map.clear();
+
+    renderer->_draw_keys.clear();
+    renderer->_shader_ids.clear();
+    renderer->_material_ids.clear();
+    renderer->_vertex_array_ids.clear();
 
-    renderer->_directional_lights.clear();
-    renderer->_point_lights.clear();
-    renderer->_spot_lights.clear();
-    renderer->_ambient_lights.clear();
+    renderer->_lights.clear();
 }
 
 auto DrawRectCommand::operator==(const DrawRectCommand& other) const -> bool
@@ -674,8 +1826,8 @@ auto Renderer2D::init() -> Result<void, String>
 
 auto Renderer2D::start_frame() -> void
 {
-    renderer_2d->_draw_calls_last_frame = renderer_2d->_draw_calls_this_frame;
-    renderer_2d->_draw_calls_this_frame = 0;
+    renderer_2d->_stats_last_frame = std::exchange(renderer_2d->_stats_this_frame, Renderer2DStats{});
+    push_to_history(renderer_2d->_stats_history, renderer_2d->_stats_last_frame);
 }
 
 auto Renderer2D::shut_down() -> void
@@ -687,15 +1839,35 @@ auto Renderer2D::shut_down() -> void
 
 auto Renderer2D::begin_scene() -> void
 {
-    renderer_2d->_depth_test_was_enabled = Renderer::depth_test_enabled();
-    Renderer::set_depth_test_enabled(false);
+    // The draw commands of the previous scene haven't been rendered yet.
+    if (renderer_2d->_scene_recorded)
+        Renderer::execute_frame_graph();
 }
 
 auto Renderer2D::end_scene() -> void
 {
-    render();
-    reset_renderer_state();
-    Renderer::set_depth_test_enabled(renderer_2d->_depth_test_was_enabled);
+    if (renderer_2d->_draw_rect_commands.empty())
+        return;
+
+    auto& graph = Renderer::frame_graph();
+    auto backbuffer = graph.backbuffer();
+
+    graph.add_pass(
+        "2D", [&](RenderGraphPassBuilder& builder) { builder.write_color(backbuffer); },
+        [](const RenderGraphPassContext&) {
+            // The depth test has to be disabled while rendering a 2D scene, but its value should be restored to
+            // whatever it was before.
+            auto depth_test_was_enabled = Renderer::depth_test_enabled();
+            Renderer::set_depth_test_enabled(false);
+
+            render();
+            reset_renderer_state();
+            renderer_2d->_scene_recorded = false;
+
+            Renderer::set_depth_test_enabled(depth_test_was_enabled);
+        });
+
+    renderer_2d->_scene_recorded = true;
 }
 
 auto Renderer2D::submit(BoundedRect<> rect, glm::vec4 color) -> void
@@ -715,7 +1887,17 @@ auto Renderer2D::viewport() -> glm::uvec2
 
 auto Renderer2D::draw_calls_last_frame() -> u32
 {
-    return renderer_2d->_draw_calls_last_frame;
+    return renderer_2d->_stats_last_frame.draw_calls;
+}
+
+auto Renderer2D::stats_last_frame() -> const Renderer2DStats&
+{
+    return renderer_2d->_stats_last_frame;
+}
+
+auto Renderer2D::stats_history() -> std::span<const Renderer2DStats>
+{
+    return history_of(renderer_2d->_stats_history);
 }
 
 auto Renderer2D::render() -> void
@@ -725,6 +1907,7 @@ auto Renderer2D::render() -> void
     shaders::texture_2d()->bind();
 
     batch_draw_rect_commands();
+    renderer_2d->_stats_this_frame.batches += static_cast<u32>(renderer_2d->_rect_batches.size());
 
     for (const auto& batch : renderer_2d->_rect_batches)
         render_batch(batch);
@@ -737,7 +1920,7 @@ auto Renderer2D::draw_indexed(const gl::VertexArray& vertex_array) -> void
     glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(vertex_array.count()),
                    gl::to_gl_enum(vertex_array.indexing_data_type()), nullptr);
 
-    renderer_2d->_draw_calls_this_frame++;
+    renderer_2d->_stats_this_frame.draw_calls++;
 }
 
 auto Renderer2D::draw_instanced(const gl::VertexArray& vertex_array, u32 instances) -> void
@@ -748,7 +1931,7 @@ auto Renderer2D::draw_instanced(const gl::VertexArray& vertex_array, u32 instanc
                             gl::to_gl_enum(vertex_array.indexing_data_type()), nullptr,
                             static_cast<GLsizei>(instances));
 
-    renderer_2d->_draw_calls_this_frame++;
+    renderer_2d->_stats_this_frame.draw_calls++;
 }
 
 auto Renderer2D::batch_draw_rect_commands() -> void
@@ -806,6 +1989,7 @@ auto Renderer2D::render_batch(const RectRenderBatch& batch) -> void
 
     renderer_2d->_vertex_buffer.clear();
     const auto quad_count = batch.rects.size();
+    renderer_2d->_stats_this_frame.quads += static_cast<u32>(quad_count);
 
     // @todo: We should handle the case when the number of quads to draw is higher than the number of quads supported by
     // quads index buffer.
@@ -846,7 +2030,7 @@ auto Renderer2D::render_batch(const RectRenderBatch& batch) -> void
             },
         };
 
-        renderer_2d->_vertex_buffer.append_data(quad);
+        renderer_2d->_stats_this_frame.vertex_bytes_uploaded += renderer_2d->_vertex_buffer.append_data(quad);
     }
 
     if (batch.texture)
@@ -866,3 +2050,5 @@ auto Renderer2D::reset_renderer_state() -> void
 }
 
 } // namespace zth
+
+ZTH_DEFINE_REFLECTED_ENUM(zth::ShadingMode);
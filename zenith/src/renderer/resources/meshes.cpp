@@ -1,8 +1,12 @@
 #include "zenith/renderer/resources/meshes.hpp"
 
+#include <string_view>
+
 #include "zenith/log/logger.hpp"
 #include "zenith/renderer/mesh.hpp"
+#include "zenith/renderer/mesh_optimizer.hpp"
 #include "zenith/renderer/vertex.hpp"
+#include "zenith/stl/vector.hpp"
 
 namespace zth::meshes {
 
@@ -1966,6 +1970,21 @@ const std::array<u16, 3072> sphere_indices = {
 
 MeshesArray meshes_array;
 
+// The data above is laid out to be easy to read, so it gets optimized for the GPU before the mesh gets created.
+template<typename Vertex, typename Index, usize vertex_count, usize index_count>
+auto create_optimized_mesh(std::string_view name, const std::array<Vertex, vertex_count>& vertices,
+                           const std::array<Index, index_count>& indices) -> std::shared_ptr<const Mesh>
+{
+    Vector<Vertex> vertex_data{ std::from_range_t{}, vertices };
+    Vector<Index> index_data{ std::from_range_t{}, indices };
+
+    auto [before, after] = optimize_mesh(vertex_data, index_data);
+    ZTH_INTERNAL_TRACE("Optimized {} mesh: ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}.", name, before.acmr,
+                       after.acmr, before.atvr, after.atvr);
+
+    return std::make_shared<IndexedMesh<Vertex, Index>>(vertex_data, index_data);
+}
+
 } // namespace
 
 auto load() -> void
@@ -1980,11 +1999,9 @@ auto load() -> void
     }
 #endif
 
-    meshes_array[cube_mesh_index] = std::make_shared<IndexedMesh<StandardVertex, u8>>(cube_vertices, cube_indices);
-    meshes_array[pyramid_mesh_index] =
-        std::make_shared<IndexedMesh<StandardVertex, u8>>(pyramid_vertices, pyramid_indices);
-    meshes_array[sphere_mesh_index] =
-        std::make_shared<IndexedMesh<StandardVertex, u16>>(sphere_vertices, sphere_indices);
+    meshes_array[cube_mesh_index] = create_optimized_mesh("cube", cube_vertices, cube_indices);
+    meshes_array[pyramid_mesh_index] = create_optimized_mesh("pyramid", pyramid_vertices, pyramid_indices);
+    meshes_array[sphere_mesh_index] = create_optimized_mesh("sphere", sphere_vertices, sphere_indices);
 
 #if defined(ZTH_ASSERTIONS)
     for (auto& mesh : meshes_array)
@@ -1,9 +1,14 @@
 #include "zenith/renderer/resources/shaders.hpp"
 
+#include <chrono>
+#include <tuple>
+
 #include "zenith/core/assert.hpp"
 #include "zenith/embedded/shaders.hpp"
+#include "zenith/gl/program_cache.hpp"
 #include "zenith/gl/shader.hpp"
 #include "zenith/log/logger.hpp"
+#include "zenith/renderer/vertex.hpp"
 
 namespace zth::shaders {
 
@@ -25,21 +30,42 @@ auto load() -> void
     }
 #endif
 
-    shaders_array[fallback_shader_index] =
-        std::make_shared<gl::Shader>(gl::ShaderSources{ .vertex_source = embedded::shaders::fallback_vert,
-                                                        .fragment_source = embedded::shaders::fallback_frag });
-
-    shaders_array[flat_color_shader_index] =
-        std::make_shared<gl::Shader>(gl::ShaderSources{ .vertex_source = embedded::shaders::flat_color_vert,
-                                                        .fragment_source = embedded::shaders::flat_color_frag });
-
-    shaders_array[standard_shader_index] =
-        std::make_shared<gl::Shader>(gl::ShaderSources{ .vertex_source = embedded::shaders::standard_vert,
-                                                        .fragment_source = embedded::shaders::standard_frag });
-
-    shaders_array[texture_2d_shader_index] =
-        std::make_shared<gl::Shader>(gl::ShaderSources{ .vertex_source = embedded::shaders::texture_2d_vert,
-                                                        .fragment_source = embedded::shaders::texture_2d_frag });
+    // In the order of the shader indices.
+    const std::array<gl::ShaderSources, std::tuple_size_v<ShadersArray>> sources = {
+        gl::ShaderSources{ .vertex_source = embedded::shaders::fallback_vert,
+                           .fragment_source = embedded::shaders::fallback_frag },
+        gl::ShaderSources{ .vertex_source = embedded::shaders::flat_color_vert,
+                           .fragment_source = embedded::shaders::flat_color_frag },
+        gl::ShaderSources{ .vertex_source = embedded::shaders::standard_vert,
+                           .fragment_source = embedded::shaders::standard_frag },
+        gl::ShaderSources{ .vertex_source = embedded::shaders::texture_2d_vert,
+                           .fragment_source = embedded::shaders::texture_2d_frag },
+        gl::ShaderSources{ .vertex_source = embedded::shaders::standard_vert,
+                           .fragment_source = embedded::shaders::deferred_geometry_frag },
+        gl::ShaderSources{ .vertex_source = embedded::shaders::deferred_lighting_vert,
+                           .fragment_source = embedded::shaders::deferred_lighting_frag },
+        gl::ShaderSources{ .vertex_source = embedded::shaders::depth_only_vert,
+                           .fragment_source = embedded::shaders::depth_only_frag },
+        gl::ShaderSources{ .vertex_source = embedded::shaders::standard_compact_vert,
+                           .fragment_source = embedded::shaders::standard_frag },
+        gl::ShaderSources{ .vertex_source = embedded::shaders::standard_compact_vert,
+                           .fragment_source = embedded::shaders::deferred_geometry_frag },
+    };
+
+    // The cache stats tell a cold start, which compiles everything, from a warm one, which loads the cached binaries.
+    auto cache_stats_before = gl::ProgramCache::stats();
+    auto load_start = std::chrono::steady_clock::now();
+
+    auto shaders = gl::Shader::from_sources(sources);
+
+    std::chrono::duration<double, std::milli> load_time = std::chrono::steady_clock::now() - load_start;
+    auto cache_hits = gl::ProgramCache::stats().hits - cache_stats_before.hits;
+
+    for (usize i = 0; i < shaders.size(); i++)
+        shaders_array[i] = std::make_shared<gl::Shader>(std::move(shaders[i]));
+
+    ZTH_INTERNAL_INFO("[Shaders] Loaded {} shaders in {:.2f} ms ({} from the program cache, {} compiled).",
+                      shaders.size(), load_time.count(), cache_hits, shaders.size() - cache_hits);
 
 #if defined(ZTH_ASSERTIONS)
     for (auto& shader : shaders_array)
@@ -81,5 +107,32 @@ ZTH_SHADER_GETTER(fallback);
 ZTH_SHADER_GETTER(flat_color);
 ZTH_SHADER_GETTER(standard);
 ZTH_SHADER_GETTER(texture_2d);
+ZTH_SHADER_GETTER(deferred_geometry);
+ZTH_SHADER_GETTER(deferred_lighting);
+ZTH_SHADER_GETTER(depth_only);
+ZTH_SHADER_GETTER(standard_compact);
+ZTH_SHADER_GETTER(deferred_geometry_compact);
+
+auto matches_depth_only(const gl::Shader& shader) -> bool
+{
+    // @volatile: These shaders' vertex stages have to be kept in sync with zth_depth_only.vert.
+    return &shader == fallback().get() || &shader == flat_color().get() || &shader == standard().get()
+           || &shader == deferred_geometry().get() || &shader == standard_compact().get()
+           || &shader == deferred_geometry_compact().get();
+}
+
+auto vertex_format_variant(const gl::Shader& shader, VertexFormat vertex_format) -> const gl::Shader&
+{
+    if (vertex_format == VertexFormat::Standard)
+        return shader;
+
+    if (&shader == standard().get())
+        return *standard_compact();
+
+    if (&shader == deferred_geometry().get())
+        return *deferred_geometry_compact();
+
+    return shader;
+}
 
 } // namespace zth::shaders
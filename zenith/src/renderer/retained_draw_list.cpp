@@ -0,0 +1,385 @@
+#include "zenith/renderer/retained_draw_list.hpp"
+
+#include <glm/common.hpp>
+#include <glm/vector_relational.hpp>
+
+#include <algorithm>
+#include <concepts>
+#include <functional>
+#include <utility>
+
+#include "zenith/core/assert.hpp"
+#include "zenith/ecs/components.hpp"
+#include "zenith/math/matrix.hpp"
+#include "zenith/renderer/mesh.hpp"
+#include "zenith/renderer/renderer.hpp"
+
+namespace zth {
+
+namespace {
+
+auto world_bounds(const Mesh& mesh, const glm::mat4& transform) -> math::Aabb
+{
+    const auto& aabb = mesh.aabb();
+
+    // Transforming infinite bounds would give us NaNs.
+    if (glm::any(glm::isinf(aabb.min)) || glm::any(glm::isinf(aabb.max)))
+        return math::infinite_aabb;
+
+    return math::transform_aabb(aabb, transform);
+}
+
+} // namespace
+
+auto RetainedInstanceStats::operator+=(const RetainedInstanceStats& other) -> RetainedInstanceStats&
+{
+    reused_instances += other.reused_instances;
+    uploaded_instances += other.uploaded_instances;
+    added_instances += other.added_instances;
+    removed_instances += other.removed_instances;
+    culled_instances += other.culled_instances;
+    uploads += other.uploads;
+    uploaded_bytes += other.uploaded_bytes;
+    return *this;
+}
+
+auto RetainedInstanceSlots::submit(Key key, u64 version) -> Optional<u32>
+{
+    if (auto kv = _slots.find(key); kv != _slots.end())
+    {
+        auto slot = kv->second;
+        _last_submitted_frames[slot] = _frame;
+
+        if (_versions[slot] == version)
+            return nil;
+
+        _versions[slot] = version;
+        mark_dirty(slot);
+        return slot;
+    }
+
+    auto slot = size();
+    _slots.emplace(key, slot);
+
+    _keys.push_back(key);
+    _versions.push_back(version);
+    _last_submitted_frames.push_back(_frame);
+    _transforms.emplace_back(1.0f);
+    _normal_matrices.emplace_back(1.0f);
+    _instance_bounds.emplace_back();
+    _dirty.push_back(false);
+
+    _added_instances++;
+    mark_dirty(slot);
+    return slot;
+}
+
+auto RetainedInstanceSlots::store(u32 slot, const glm::mat4& transform, const glm::mat3& normal_matrix,
+                                  const math::Aabb& bounds) -> void
+{
+    ZTH_ASSERT(slot < size());
+
+    _transforms[slot] = transform;
+    _normal_matrices[slot] = normal_matrix;
+    _instance_bounds[slot] = bounds;
+    _bounds_outdated = true;
+}
+
+auto RetainedInstanceSlots::end_frame() -> RetainedInstanceStats
+{
+    RetainedInstanceStats stats{ .added_instances = std::exchange(_added_instances, 0) };
+
+    // Going backwards, the instance which gets moved into a removed instance's slot has already been checked.
+    for (auto slot = size(); slot-- > 0;)
+    {
+        if (_last_submitted_frames[slot] == _frame)
+            continue;
+
+        remove(slot);
+        stats.removed_instances++;
+    }
+
+    for (auto slot = 0u; slot < size(); slot++)
+    {
+        if (!_dirty[slot])
+            stats.reused_instances++;
+    }
+
+    _frame++;
+    return stats;
+}
+
+auto RetainedInstanceSlots::dirty_ranges() -> std::span<const SlotRange>
+{
+    _dirty_ranges.clear();
+
+    std::ranges::sort(_dirty_slots);
+    auto [last, end] = std::ranges::unique(_dirty_slots);
+    _dirty_slots.erase(last, end);
+
+    for (auto slot : _dirty_slots)
+    {
+        if (slot >= size() || !_dirty[slot])
+            continue;
+
+        if (!_dirty_ranges.empty() && _dirty_ranges.back().first + _dirty_ranges.back().count == slot)
+            _dirty_ranges.back().count++;
+        else
+            _dirty_ranges.push_back(SlotRange{ .first = slot, .count = 1 });
+    }
+
+    return _dirty_ranges;
+}
+
+auto RetainedInstanceSlots::clear_dirty_slots() -> void
+{
+    for (auto slot : _dirty_slots)
+    {
+        if (slot < size())
+            _dirty[slot] = false;
+    }
+
+    _dirty_slots.clear();
+    _dirty_ranges.clear();
+}
+
+auto RetainedInstanceSlots::mark_all_dirty() -> void
+{
+    for (auto slot = 0u; slot < size(); slot++)
+        mark_dirty(slot);
+}
+
+auto RetainedInstanceSlots::clear() -> void
+{
+    _slots.clear();
+
+    _keys.clear();
+    _versions.clear();
+    _last_submitted_frames.clear();
+    _transforms.clear();
+    _normal_matrices.clear();
+    _instance_bounds.clear();
+    _dirty.clear();
+
+    _dirty_slots.clear();
+    _dirty_ranges.clear();
+
+    _bounds = math::Aabb{};
+    _bounds_outdated = false;
+    _added_instances = 0;
+}
+
+auto RetainedInstanceSlots::bounds() -> const math::Aabb&
+{
+    if (!_bounds_outdated)
+        return _bounds;
+
+    _bounds = _instance_bounds.empty() ? math::Aabb{} : _instance_bounds.front();
+
+    for (const auto& instance_bounds : _instance_bounds)
+        _bounds = math::merge(_bounds, instance_bounds);
+
+    _bounds_outdated = false;
+    return _bounds;
+}
+
+auto RetainedInstanceSlots::mark_dirty(u32 slot) -> void
+{
+    if (_dirty[slot])
+        return;
+
+    _dirty[slot] = true;
+    _dirty_slots.push_back(slot);
+}
+
+auto RetainedInstanceSlots::remove(u32 slot) -> void
+{
+    auto last = size() - 1;
+    _slots.erase(_keys[slot]);
+
+    if (slot != last)
+    {
+        _keys[slot] = _keys[last];
+        _versions[slot] = _versions[last];
+        _last_submitted_frames[slot] = _last_submitted_frames[last];
+        _transforms[slot] = _transforms[last];
+        _normal_matrices[slot] = _normal_matrices[last];
+        _instance_bounds[slot] = _instance_bounds[last];
+
+        _slots[_keys[slot]] = slot;
+        mark_dirty(slot);
+    }
+
+    _keys.pop_back();
+    _versions.pop_back();
+    _last_submitted_frames.pop_back();
+    _transforms.pop_back();
+    _normal_matrices.pop_back();
+    _instance_bounds.pop_back();
+    _dirty.pop_back();
+
+    _bounds_outdated = true;
+}
+
+auto RetainedDrawList::submit(Key key, u64 version, const std::shared_ptr<const Mesh>& mesh,
+                              const TransformComponent& transform, const std::shared_ptr<const Material>& material)
+    -> void
+{
+    ZTH_ASSERT(mesh != nullptr);
+    ZTH_ASSERT(material != nullptr);
+
+    auto& batch = find_or_create_batch(mesh, material);
+    auto slot = batch.slots.submit(key, version);
+
+    // The normal matrix and the bounds only get computed for the instances which changed.
+    if (!slot)
+        return;
+
+    const auto& transform_matrix = transform.transform();
+
+    // A transform set straight from a matrix might contain shear, which the rotation and the scale can't express.
+    auto normal_matrix = transform.is_composed() ? math::get_normal_matrix(transform.rotation(), transform.scale())
+                                                 : math::get_normal_matrix(transform_matrix);
+
+    batch.slots.store(*slot, transform_matrix, normal_matrix, world_bounds(*mesh, transform_matrix));
+}
+
+auto RetainedDrawList::end_frame() -> RetainedInstanceStats
+{
+    RetainedInstanceStats stats{};
+
+    for (const auto& batch : _batches)
+        stats += batch->slots.end_frame();
+
+    // Dropping a batch also releases its mesh and material.
+    auto [first_empty, end] = std::ranges::remove_if(_batches, [](const auto& batch) { return batch->slots.empty(); });
+
+    if (first_empty != end)
+    {
+        _batches.erase(first_empty, end);
+        _batch_indices.clear();
+
+        for (u32 i = 0; i < _batches.size(); i++)
+        {
+            const auto& batch = *_batches[i];
+            _batch_indices.emplace(BatchKey{ &batch.mesh->vertex_array(), batch.material.get() }, i);
+        }
+    }
+
+    return stats;
+}
+
+auto RetainedDrawList::upload(RetainedBatch& batch, u32 material_index) -> RetainedInstanceStats
+{
+    if (batch.material_index != material_index)
+    {
+        batch.slots.mark_all_dirty();
+        batch.material_index = material_index;
+    }
+
+    switch (batch.instance_format)
+    {
+        using enum InstanceFormat;
+    case Standard:
+        return upload_ranges<InstanceVertex>(batch, material_index);
+    case Compact:
+        return upload_ranges<CompactInstanceVertex>(batch, material_index);
+    }
+
+    ZTH_ASSERT(false);
+    std::unreachable();
+}
+
+auto RetainedDrawList::clear() -> void
+{
+    _batches.clear();
+    _batch_indices.clear();
+}
+
+auto RetainedDrawList::instance_count() const -> u32
+{
+    u32 count = 0;
+
+    for (const auto& batch : _batches)
+        count += batch->slots.size();
+
+    return count;
+}
+
+auto RetainedDrawList::BatchKeyHash::operator()(const BatchKey& key) const -> std::size_t
+{
+    auto hash = [](const void* object) { return std::hash<const void*>{}(object); };
+    return hash(key.vertex_array) * 31 + hash(key.material);
+}
+
+auto RetainedDrawList::find_or_create_batch(const std::shared_ptr<const Mesh>& mesh,
+                                            const std::shared_ptr<const Material>& material) -> RetainedBatch&
+{
+    BatchKey key{ &mesh->vertex_array(), material.get() };
+    auto [kv, inserted] = _batch_indices.try_emplace(key, static_cast<u32>(_batches.size()));
+
+    if (!inserted)
+        return *_batches[kv->second];
+
+    auto instance_format = Renderer::instance_format(mesh->vertex_array());
+    const auto& layout =
+        instance_format == InstanceFormat::Compact ? CompactInstanceVertex::layout : InstanceVertex::layout;
+
+    auto& batch = *_batches.emplace_back(make_unique<RetainedBatch>(RetainedBatch{
+        .mesh = mesh,
+        .material = material,
+        .instance_format = instance_format,
+        .instance_buffer = gl::InstanceBuffer::create_dynamic(layout),
+        .vertex_array = gl::VertexArray{ mesh->vertex_array() },
+    }));
+
+    // The batch's vertex array has to be bound to the instance buffer at its final address.
+    batch.vertex_array.bind_instance_buffer(batch.instance_buffer);
+    batch.vertex_array.rebind_layout();
+
+    return batch;
+}
+
+template<typename Instance>
+auto RetainedDrawList::upload_ranges(RetainedBatch& batch, u32 material_index) -> RetainedInstanceStats
+{
+    constexpr auto instance_size = static_cast<u32>(sizeof(Instance));
+
+    RetainedInstanceStats stats{};
+
+    auto transforms = batch.slots.transforms();
+    auto normal_matrices = batch.slots.normal_matrices();
+    const auto& position_transform = batch.vertex_array.position_transform();
+
+    for (auto [first, count] : batch.slots.dirty_ranges())
+    {
+        _staging.resize(usize{ count } * instance_size);
+        auto instances = std::span{ static_cast<Instance*>(static_cast<void*>(_staging.data())), count };
+
+        for (u32 i = 0; i < count; i++)
+        {
+            auto transform = apply_position_transform(transforms[first + i], position_transform);
+
+            if constexpr (std::same_as<Instance, CompactInstanceVertex>)
+            {
+                instances[i] = CompactInstanceVertex::from_transform(transform, material_index);
+            }
+            else
+            {
+                instances[i] = InstanceVertex{
+                    material_index, transform[0], transform[1], transform[2], transform[3], normal_matrices[first + i],
+                };
+            }
+        }
+
+        stats.uploaded_bytes +=
+            batch.instance_buffer.buffer_data(std::span<const byte>{ _staging }, first * instance_size);
+        stats.uploaded_instances += count;
+        stats.uploads++;
+    }
+
+    batch.slots.clear_dirty_slots();
+    return stats;
+}
+
+} // namespace zth
@@ -23,6 +23,9 @@ auto ShaderPreprocessor::init() -> Result<void, String>
 {
     ZTH_INTERNAL_TRACE("Initializing shader preprocessor...");
     add_source("zth_defines.glsl", embedded::shaders::defines_glsl);
+    add_source("zth_lighting.glsl", embedded::shaders::lighting_glsl);
+    add_source("zth_vertex.glsl", embedded::shaders::vertex_glsl);
+    add_source("zth_standard_vertex.glsl", embedded::shaders::standard_vertex_glsl);
     ZTH_INTERNAL_TRACE("Shader preprocessor initialized.");
     return {};
 }
@@ -0,0 +1,144 @@
+#include "zenith/renderer/vertex.hpp"
+
+#include <glm/geometric.hpp>
+#include <glm/matrix.hpp>
+
+#include <algorithm>
+#include <ranges>
+
+#include "zenith/math/bounds.hpp"
+#include "zenith/math/matrix.hpp"
+
+namespace zth {
+
+auto CompactInstanceVertex::from_trs(glm::vec3 translation, glm::quat rotation, glm::vec3 scale,
+                                     GLuint material_index) -> CompactInstanceVertex
+{
+    return CompactInstanceVertex{
+        .material_index = material_index,
+        .translation = glm::vec4{ translation, 0.0f },
+        .rotation = math::pack_snorm16(glm::vec4{ rotation.x, rotation.y, rotation.z, rotation.w }),
+        .scale = scale,
+    };
+}
+
+auto CompactInstanceVertex::from_transform(const glm::mat4& transform, GLuint material_index)
+    -> CompactInstanceVertex
+{
+    glm::mat3 basis{ transform };
+    glm::vec3 scale{ glm::length(basis[0]), glm::length(basis[1]), glm::length(basis[2]) };
+
+    // A rotation can't mirror, so the scale has to.
+    if (glm::determinant(basis) < 0.0f)
+        scale.x = -scale.x;
+
+    u32 flattened_axes = 0;
+
+    for (glm::length_t axis = 0; axis < 3; axis++)
+    {
+        if (scale[axis] != 0.0f)
+            basis[axis] /= scale[axis];
+        else
+            flattened_axes++;
+    }
+
+    auto rotation = glm::identity<glm::quat>();
+
+    // The direction of an axis which got scaled down to nothing can be recovered from the other two. The scale then
+    // collapses the axis anyway.
+    if (flattened_axes <= 1)
+    {
+        for (glm::length_t axis = 0; axis < 3; axis++)
+        {
+            if (scale[axis] == 0.0f)
+                basis[axis] = glm::cross(basis[(axis + 1) % 3], basis[(axis + 2) % 3]);
+        }
+
+        rotation = glm::normalize(glm::quat_cast(basis));
+    }
+
+    return from_trs(glm::vec3{ transform[3] }, rotation, scale, material_index);
+}
+
+auto CompactInstanceVertex::decode_rotation() const -> glm::quat
+{
+    auto components = glm::normalize(math::unpack(rotation));
+    return glm::quat::wxyz(components.w, components.x, components.y, components.z);
+}
+
+auto CompactInstanceVertex::decode_transform() const -> glm::mat4
+{
+    glm::mat4 result{ glm::mat3_cast(decode_rotation()) };
+    result[0] *= scale.x;
+    result[1] *= scale.y;
+    result[2] *= scale.z;
+    result[3] = glm::vec4{ glm::vec3{ translation }, 1.0f };
+    return result;
+}
+
+auto CompactInstanceVertex::decode_normal_matrix() const -> glm::mat3
+{
+    return math::get_normal_matrix(decode_rotation(), scale);
+}
+
+auto CompactVertex::from_standard(const StandardVertex& vertex, const gl::VertexPositionTransform& position_transform)
+    -> CompactVertex
+{
+    auto position = (vertex.position - position_transform.offset) / position_transform.scale;
+
+    return CompactVertex{
+        .position = math::pack_unorm16(glm::vec4{ position, 1.0f }),
+        .normal = math::pack_octahedral(vertex.normal),
+        .uv = math::pack_half(vertex.uv),
+    };
+}
+
+auto CompactVertex::to_standard(const gl::VertexPositionTransform& position_transform) const -> StandardVertex
+{
+    return StandardVertex{
+        .position = decode_position(position_transform),
+        .normal = math::unpack_octahedral(normal),
+        .uv = math::unpack(uv),
+    };
+}
+
+auto CompactVertex::decode_position(const gl::VertexPositionTransform& position_transform) const -> glm::vec3
+{
+    return glm::vec3{ math::unpack(position) } * position_transform.scale + position_transform.offset;
+}
+
+auto compact_position_transform(std::span<const StandardVertex> vertices) -> gl::VertexPositionTransform
+{
+    auto aabb = math::compute_aabb(vertices | std::views::transform(&StandardVertex::position));
+    auto size = aabb.max - aabb.min;
+    auto scale = std::max({ size.x, size.y, size.z });
+
+    // There are no vertices or every vertex is in the same place, so the positions only have to be offset.
+    if (scale <= 0.0f)
+        scale = 1.0f;
+
+    return gl::VertexPositionTransform{ .offset = aabb.min, .scale = scale };
+}
+
+auto compact_vertices(std::span<const StandardVertex> vertices, const gl::VertexPositionTransform& position_transform)
+    -> Vector<CompactVertex>
+{
+    auto compact = [&](const StandardVertex& vertex) {
+        return CompactVertex::from_standard(vertex, position_transform);
+    };
+
+    return Vector<CompactVertex>{ std::from_range_t{}, vertices | std::views::transform(compact) };
+}
+
+auto apply_position_transform(const glm::mat4& transform, const gl::VertexPositionTransform& position_transform)
+    -> glm::mat4
+{
+    return glm::mat4{
+        transform[0] * position_transform.scale,
+        transform[1] * position_transform.scale,
+        transform[2] * position_transform.scale,
+        transform * glm::vec4{ position_transform.offset, 1.0f },
+    };
+}
+
+} // namespace zth
@@ -0,0 +1,33 @@
+#version 460 core
+
+#include "zth_defines.glsl"
+#include "zth_lighting.glsl"
+
+// Writes everything that the lighting pass needs into the G-buffer. Pairs with zth_standard.vert.
+
+in vec3 Position;
+in vec3 Normal;
+in vec2 UV;
+in flat uint MaterialIndex;
+
+layout (binding = ZTH_DIFFUSE_MAP_SLOT) uniform sampler2D diffuse_map;
+layout (binding = ZTH_SPECULAR_MAP_SLOT) uniform sampler2D specular_map;
+layout (binding = ZTH_EMISSION_MAP_SLOT) uniform sampler2D emission_map;
+
+layout (location = ZTH_GBUFFER_ALBEDO_ATTACHMENT) out vec4 out_albedo;
+layout (location = ZTH_GBUFFER_NORMAL_ATTACHMENT) out vec4 out_normal;
+layout (location = ZTH_GBUFFER_SPECULAR_ATTACHMENT) out vec4 out_specular;
+layout (location = ZTH_GBUFFER_EMISSION_ATTACHMENT) out vec4 out_emission;
+layout (location = ZTH_GBUFFER_MATERIAL_INDEX_ATTACHMENT) out uint out_material_index;
+
+void main()
+{
+    vec4 object_color = vec4(materials[MaterialIndex].albedo, 1.0);
+	object_color *= texture(diffuse_map, UV);
+
+    out_albedo = object_color;
+    out_normal = vec4(Normal, 0.0);
+    out_specular = texture(specular_map, UV);
+    out_emission = texture(emission_map, UV);
+    out_material_index = MaterialIndex;
+}
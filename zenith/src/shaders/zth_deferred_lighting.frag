@@ -0,0 +1,57 @@
+#version 460 core
+
+#include "zth_defines.glsl"
+#include "zth_lighting.glsl"
+
+// Lights every pixel that the geometry pass has written to. The world position gets reconstructed from the depth.
+
+layout (std140, binding = ZTH_CAMERA_UBO_BINDING_POINT) uniform CameraUbo
+{
+    mat4 view_projection;
+    vec3 position;
+} camera;
+
+layout (binding = ZTH_GBUFFER_ALBEDO_SLOT) uniform sampler2D gbuffer_albedo;
+layout (binding = ZTH_GBUFFER_NORMAL_SLOT) uniform sampler2D gbuffer_normal;
+layout (binding = ZTH_GBUFFER_SPECULAR_SLOT) uniform sampler2D gbuffer_specular;
+layout (binding = ZTH_GBUFFER_EMISSION_SLOT) uniform sampler2D gbuffer_emission;
+layout (binding = ZTH_GBUFFER_MATERIAL_INDEX_SLOT) uniform usampler2D gbuffer_material_index;
+layout (binding = ZTH_GBUFFER_DEPTH_SLOT) uniform sampler2D gbuffer_depth;
+
+uniform mat4 inverse_view_projection;
+
+out vec4 out_color;
+
+void main()
+{
+    ivec2 texel = ivec2(gl_FragCoord.xy);
+    float depth = texelFetch(gbuffer_depth, texel, 0).r;
+
+    // Nothing got drawn here.
+    if (depth == 1.0)
+        discard;
+
+    // The geometry pass rendered into textures which are exactly the size of the viewport.
+    vec2 uv = gl_FragCoord.xy / vec2(textureSize(gbuffer_depth, 0));
+    vec4 ndc_position = vec4(vec3(uv, depth) * 2.0 - 1.0, 1.0);
+    vec4 world_position = inverse_view_projection * ndc_position;
+    vec3 position = world_position.xyz / world_position.w;
+
+    vec4 object_color = texelFetch(gbuffer_albedo, texel, 0);
+
+    Surface surface = Surface(
+        position,
+        texelFetch(gbuffer_normal, texel, 0).xyz,
+        normalize(position - camera.position),
+        texelFetch(gbuffer_specular, texel, 0).rgb,
+        materials[texelFetch(gbuffer_material_index, texel, 0).r]
+    );
+
+    vec3 light_strength = calc_lighting(surface);
+
+    out_color = vec4(light_strength * object_color.rgb, object_color.a);
+    out_color += texelFetch(gbuffer_emission, texel, 0);
+
+    // Lets the forward pass which follows depth test against the deferred geometry.
+    gl_FragDepth = depth;
+}
@@ -0,0 +1,9 @@
+#version 460 core
+
+// A triangle which covers the whole screen, drawn without any vertex buffers.
+
+void main()
+{
+    vec2 position = vec2(float((gl_VertexID & 1) << 2), float((gl_VertexID & 2) << 1)) - 1.0;
+    gl_Position = vec4(position, 0.0, 1.0);
+}
@@ -4,12 +4,28 @@
 #define ZTH_SPECULAR_MAP_SLOT 1
 #define ZTH_EMISSION_MAP_SLOT 2
 
+#define ZTH_GBUFFER_ALBEDO_SLOT 3
+#define ZTH_GBUFFER_NORMAL_SLOT 4
+#define ZTH_GBUFFER_SPECULAR_SLOT 5
+#define ZTH_GBUFFER_EMISSION_SLOT 6
+#define ZTH_GBUFFER_MATERIAL_INDEX_SLOT 7
+#define ZTH_GBUFFER_DEPTH_SLOT 8
+
+#define ZTH_GBUFFER_ALBEDO_ATTACHMENT 0
+#define ZTH_GBUFFER_NORMAL_ATTACHMENT 1
+#define ZTH_GBUFFER_SPECULAR_ATTACHMENT 2
+#define ZTH_GBUFFER_EMISSION_ATTACHMENT 3
+#define ZTH_GBUFFER_MATERIAL_INDEX_ATTACHMENT 4
+
 #define ZTH_TEXTURE_2D_SLOT 0
 
 #define ZTH_CAMERA_UBO_BINDING_POINT 0
-#define ZTH_MATERIAL_UBO_BINDING_POINT 1
 
+// Ranges of the same buffer get bound to the light binding points.
 #define ZTH_DIRECTIONAL_LIGHTS_SSBO_BINDING_POINT 0
 #define ZTH_POINT_LIGHTS_SSBO_BINDING_POINT 1
 #define ZTH_SPOT_LIGHTS_SSBO_BINDING_POINT 2
-#define ZTH_AMBIENT_LIGHTS_SSBO_BINDING_POINT 3
\ No newline at end of file
+#define ZTH_AMBIENT_LIGHTS_SSBO_BINDING_POINT 3
+#define ZTH_MATERIALS_SSBO_BINDING_POINT 4
+#define ZTH_LIGHT_CLUSTERS_SSBO_BINDING_POINT 5
+#define ZTH_LIGHT_INDICES_SSBO_BINDING_POINT 6
\ No newline at end of file
@@ -0,0 +1,7 @@
+#version 460 core
+
+// Only the depth gets written.
+
+void main()
+{
+}
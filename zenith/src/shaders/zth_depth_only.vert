@@ -0,0 +1,30 @@
+#version 460 core
+
+#include "zth_defines.glsl"
+#include "zth_vertex.glsl"
+
+// Used by the depth pre-pass. The shading pass only lets through the fragments whose depth is equal to the one written
+// here, so every vertex shader which draws opaque geometry has to compute gl_Position in exactly the same way and
+// declare it invariant.
+
+layout (location = 0) in vec3 in_position;
+
+layout (location = 4) in vec4 in_instance_0;
+layout (location = 5) in vec4 in_instance_1;
+layout (location = 6) in vec3 in_instance_2;
+layout (location = 7) in vec3 in_instance_3;
+
+layout (std140, binding = ZTH_CAMERA_UBO_BINDING_POINT) uniform CameraUbo
+{
+    mat4 view_projection;
+    vec3 position;
+} camera;
+
+invariant gl_Position;
+
+void main()
+{
+    mat4 transform = zth_instance_transform(in_instance_0, in_instance_1, in_instance_2, in_instance_3);
+
+    gl_Position = camera.view_projection * (transform * vec4(in_position, 1.0));
+}
@@ -1,13 +1,14 @@
 #version 460 core
 
 #include "zth_defines.glsl"
+#include "zth_vertex.glsl"
 
 layout (location = 0) in vec3 in_position;
 
-layout (location = 3) in vec3 in_transform_col_0;
-layout (location = 4) in vec3 in_transform_col_1;
-layout (location = 5) in vec3 in_transform_col_2;
-layout (location = 6) in vec3 in_transform_col_3;
+layout (location = 4) in vec4 in_instance_0;
+layout (location = 5) in vec4 in_instance_1;
+layout (location = 6) in vec3 in_instance_2;
+layout (location = 7) in vec3 in_instance_3;
 
 layout (std140, binding = ZTH_CAMERA_UBO_BINDING_POINT) uniform CameraUbo
 {
@@ -15,15 +16,12 @@ layout (std140, binding = ZTH_CAMERA_UBO_BINDING_POINT) uniform CameraUbo
     vec3 position;
 } camera;
 
+// @volatile: Keep in sync with zth_depth_only.vert.
+invariant gl_Position;
+
 void main()
 {
-    // Transform matrix's last row is always (0, 0, 0, 1).
-    mat4 transform = mat4(
-        vec4(in_transform_col_0, 0.0),
-        vec4(in_transform_col_1, 0.0),
-        vec4(in_transform_col_2, 0.0),
-        vec4(in_transform_col_3, 1.0)
-    );
+    mat4 transform = zth_instance_transform(in_instance_0, in_instance_1, in_instance_2, in_instance_3);
 
-    gl_Position = camera.view_projection * transform * vec4(in_position, 1.0);
+    gl_Position = camera.view_projection * (transform * vec4(in_position, 1.0));
 }
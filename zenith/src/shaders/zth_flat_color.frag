@@ -2,14 +2,25 @@
 
 #include "zth_defines.glsl"
 
-layout (std140, binding = ZTH_MATERIAL_UBO_BINDING_POINT) uniform MaterialUbo
+struct Material
 {
     vec3 albedo;
-} material;
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+    float shininess;
+};
+
+in flat uint MaterialIndex;
+
+layout (std430, binding = ZTH_MATERIALS_SSBO_BINDING_POINT) restrict readonly buffer MaterialsSsbo
+{
+    Material materials[];
+};
 
 out vec4 out_color;
 
 void main()
 {
-    out_color = vec4(material.albedo, 1.0);
+    out_color = vec4(materials[MaterialIndex].albedo, 1.0);
 }
@@ -0,0 +1,292 @@
+// Lighting shared by the forward and the deferred shading paths. Expects zth_defines.glsl to be included first.
+
+struct LightProperties
+{
+    vec3 color;
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+};
+
+struct LightAttenuation
+{
+    float constant;
+    float linear;
+    float quadratic;
+};
+
+struct Light
+{
+    vec3 direction;
+    LightProperties properties;
+    float strength;
+};
+
+struct DirectionalLight
+{
+    vec3 direction;
+    LightProperties properties;
+};
+
+struct PointLight
+{
+    vec3 position;
+    LightProperties properties;
+    LightAttenuation attenuation;
+};
+
+struct SpotLight
+{
+    vec3 position;
+    vec3 direction;
+    float inner_cutoff_cosine;
+    float outer_cutoff_cosine;
+    LightProperties properties;
+    LightAttenuation attenuation;
+};
+
+struct AmbientLight
+{
+    vec3 ambient;
+};
+
+struct Material
+{
+    vec3 albedo;
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+    float shininess;
+};
+
+// Everything that the lighting needs to know about a fragment.
+struct Surface
+{
+    vec3 position;
+    vec3 normal;
+    vec3 view_direction;
+    vec3 specular_sample; // Sampled from the specular map.
+    Material material;
+};
+
+layout (std430, binding = ZTH_DIRECTIONAL_LIGHTS_SSBO_BINDING_POINT) restrict readonly buffer DirectionalLightsSsbo
+{
+    uint count;
+    DirectionalLight lights[];
+} directional_lights;
+
+layout (std430, binding = ZTH_POINT_LIGHTS_SSBO_BINDING_POINT) restrict readonly buffer PointLightsSsbo
+{
+    uint count;
+    PointLight lights[];
+} point_lights;
+
+layout (std430, binding = ZTH_SPOT_LIGHTS_SSBO_BINDING_POINT) restrict readonly buffer SpotLightsSsbo
+{
+    uint count;
+    SpotLight lights[];
+} spot_lights;
+
+layout (std430, binding = ZTH_AMBIENT_LIGHTS_SSBO_BINDING_POINT) restrict readonly buffer AmbientLightsSsbo
+{
+    uint count;
+    AmbientLight lights[];
+} ambient_lights;
+
+layout (std430, binding = ZTH_MATERIALS_SSBO_BINDING_POINT) restrict readonly buffer MaterialsSsbo
+{
+    Material materials[];
+};
+
+layout (std430, binding = ZTH_LIGHT_CLUSTERS_SSBO_BINDING_POINT) restrict readonly buffer LightClustersSsbo
+{
+    mat4 view;
+    uvec4 grid_size; // w is non-zero if light clustering is enabled.
+    vec2 viewport_size;
+    float depth_slice_scale;
+    float depth_slice_bias;
+    uvec4 clusters[]; // x: first light index, y: point light count, z: spot light count.
+} light_clusters;
+
+layout (std430, binding = ZTH_LIGHT_INDICES_SSBO_BINDING_POINT) restrict readonly buffer LightIndicesSsbo
+{
+    uint light_indices[];
+};
+
+float calc_strength(LightAttenuation attenuation, float dist)
+{
+    return 1.0 / (attenuation.constant + attenuation.linear * dist + attenuation.quadratic * (dist * dist));
+}
+
+Light convert_directional_light(DirectionalLight directional_light)
+{
+    return Light(normalize(directional_light.direction), directional_light.properties, 1.0);
+}
+
+Light convert_point_light(PointLight point_light, vec3 position)
+{
+    vec3 diff = position - point_light.position;
+    float dist = length(diff);
+    float strength = calc_strength(point_light.attenuation, dist);
+    vec3 point_light_direction = normalize(diff);
+
+    return Light(point_light_direction, point_light.properties, strength);
+}
+
+// dist is the distance from frag position to spot light.
+// angle is the dot product of the direction from spot light to frag position and spot light direction.
+Light convert_spot_light(SpotLight spot_light, float dist, float angle_cosine)
+{
+    float strength = calc_strength(spot_light.attenuation, dist);
+
+    float intensity = (angle_cosine - spot_light.outer_cutoff_cosine) /
+        (spot_light.inner_cutoff_cosine - spot_light.outer_cutoff_cosine);
+    intensity = clamp(intensity, 0.0, 1.0);
+    strength *= intensity;
+
+    return Light(normalize(spot_light.direction), spot_light.properties, strength);
+}
+
+vec3 calc_light_ambient(Light light)
+{
+    return light.properties.ambient;
+}
+
+vec3 calc_light_diffuse(Light light, vec3 normal)
+{
+    return light.properties.diffuse * max(dot(-light.direction, normal), 0.0);
+}
+
+vec3 calc_light_specular(Light light, Surface surface)
+{
+    vec3 reflection = reflect(light.direction, surface.normal);
+    vec3 specular_factor = light.properties.specular
+        * pow(max(dot(reflection, -surface.view_direction), 0.0), surface.material.shininess);
+    return specular_factor * surface.specular_sample;
+}
+
+vec3 calc_light(Light light, Surface surface)
+{
+    vec3 ambient = calc_light_ambient(light) * surface.material.ambient;
+    vec3 diffuse = calc_light_diffuse(light, surface.normal) * surface.material.diffuse;
+    vec3 specular = calc_light_specular(light, surface) * surface.material.specular;
+    return (ambient + diffuse + specular) * light.properties.color * light.strength;
+}
+
+vec3 calc_directional_lights(Surface surface)
+{
+    vec3 result = vec3(0.0);
+
+    for (uint i = 0; i < directional_lights.count; i++)
+    {
+        Light directional_light = convert_directional_light(directional_lights.lights[i]);
+        result += calc_light(directional_light, surface);
+    }
+
+    return result;
+}
+
+bool light_clustering_enabled()
+{
+    return light_clusters.grid_size.w != 0;
+}
+
+uvec4 find_cluster(vec3 position)
+{
+    uvec3 grid_size = light_clusters.grid_size.xyz;
+
+    uvec2 tile = uvec2(gl_FragCoord.xy / light_clusters.viewport_size * vec2(grid_size.xy));
+    tile = min(tile, grid_size.xy - 1);
+
+    float depth = -(light_clusters.view * vec4(position, 1.0)).z;
+    float slice = floor(log(depth) * light_clusters.depth_slice_scale + light_clusters.depth_slice_bias);
+    uint z = uint(clamp(slice, 0.0, float(grid_size.z - 1)));
+
+    return light_clusters.clusters[(z * grid_size.y + tile.y) * grid_size.x + tile.x];
+}
+
+vec3 calc_point_light(uint index, Surface surface)
+{
+    Light light = convert_point_light(point_lights.lights[index], surface.position);
+    return calc_light(light, surface);
+}
+
+vec3 calc_point_lights(Surface surface, uvec4 cluster)
+{
+    vec3 result = vec3(0.0);
+
+    if (light_clustering_enabled())
+    {
+        for (uint i = 0; i < cluster.y; i++)
+            result += calc_point_light(light_indices[cluster.x + i], surface);
+    }
+    else
+    {
+        for (uint i = 0; i < point_lights.count; i++)
+            result += calc_point_light(i, surface);
+    }
+
+    return result;
+}
+
+vec3 calc_spot_light(uint index, Surface surface)
+{
+    SpotLight spot_light = spot_lights.lights[index];
+    vec3 diff_from_spot_light = surface.position - spot_light.position;
+    float distance_from_spot_light = length(diff_from_spot_light);
+    vec3 normalized_diff = diff_from_spot_light / distance_from_spot_light;
+    float angle_cosine = dot(spot_light.direction, normalized_diff);
+
+    if (angle_cosine <= spot_light.outer_cutoff_cosine)
+        return vec3(0.0);
+
+    Light light = convert_spot_light(spot_light, distance_from_spot_light, angle_cosine);
+    return calc_light(light, surface);
+}
+
+vec3 calc_spot_lights(Surface surface, uvec4 cluster)
+{
+    vec3 result = vec3(0.0);
+
+    if (light_clustering_enabled())
+    {
+        // Spot lights follow the point lights in the cluster's part of the light index list.
+        for (uint i = 0; i < cluster.z; i++)
+            result += calc_spot_light(light_indices[cluster.x + cluster.y + i], surface);
+    }
+    else
+    {
+        for (uint i = 0; i < spot_lights.count; i++)
+            result += calc_spot_light(i, surface);
+    }
+
+    return result;
+}
+
+vec3 calc_ambient_lights()
+{
+    vec3 result = vec3(0.0);
+
+    for (uint i = 0; i < ambient_lights.count; i++)
+        result += ambient_lights.lights[i].ambient;
+
+    return result;
+}
+
+// The strength of the light which reaches the surface, to be multiplied by the surface's color.
+vec3 calc_lighting(Surface surface)
+{
+    uvec4 cluster = uvec4(0);
+
+    if (light_clustering_enabled())
+        cluster = find_cluster(surface.position);
+
+    vec3 result = vec3(0.0);
+
+    result += calc_directional_lights(surface);
+    result += calc_point_lights(surface, cluster);
+    result += calc_spot_lights(surface, cluster);
+    result += calc_ambient_lights();
+
+    return result;
+}
@@ -0,0 +1,4 @@
+#version 460 core
+
+#define ZTH_COMPACT_VERTEX
+#include "zth_standard_vertex.glsl"
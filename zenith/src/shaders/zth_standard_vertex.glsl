@@ -0,0 +1,47 @@
+// The vertex stage of the standard shader. Gets compiled once for every vertex format, with ZTH_COMPACT_VERTEX
+// defined for compact vertices.
+
+#include "zth_defines.glsl"
+#include "zth_vertex.glsl"
+
+layout (location = 0) in vec3 in_position;
+layout (location = 1) in vec3 in_normal;
+layout (location = 2) in vec2 in_uv;
+
+layout (location = 3) in uint in_material_index;
+
+layout (location = 4) in vec4 in_instance_0;
+layout (location = 5) in vec4 in_instance_1;
+layout (location = 6) in vec3 in_instance_2;
+layout (location = 7) in vec3 in_instance_3;
+
+layout (location = 8) in mat3 in_normal_mat;
+
+layout (std140, binding = ZTH_CAMERA_UBO_BINDING_POINT) uniform CameraUbo
+{
+	mat4 view_projection;
+    vec3 position;
+} camera;
+
+out vec3 Position;
+out flat vec3 Normal;
+out vec2 UV;
+out flat uint MaterialIndex;
+
+// @volatile: Keep in sync with zth_depth_only.vert.
+invariant gl_Position;
+
+void main()
+{
+    mat4 transform = zth_instance_transform(in_instance_0, in_instance_1, in_instance_2, in_instance_3);
+
+    vec4 world_position = transform * vec4(in_position, 1.0);
+
+    Position = world_position.xyz;
+    vec3 normal = zth_vertex_normal(in_normal);
+    Normal = normalize(zth_instance_normal(in_instance_0, in_instance_1, in_instance_2, in_normal_mat, normal));
+    UV = in_uv;
+    MaterialIndex = in_material_index;
+
+    gl_Position = camera.view_projection * world_position;
+}
@@ -0,0 +1,90 @@
+// Decoding of the vertex and instance formats declared in vertex.hpp.
+// @volatile: Keep in sync with CompactVertex, InstanceVertex and CompactInstanceVertex.
+
+// Compact vertices store their positions relative to the bounds of their mesh. The renderer folds the transform which
+// maps them back to the mesh's local space into the transforms of the instances, so the positions of both vertex
+// formats get read in the same way. Shaders which read the normals get compiled separately for compact vertices, with
+// ZTH_COMPACT_VERTEX defined.
+
+vec2 zth_sign_not_zero(vec2 value)
+{
+    return vec2(value.x >= 0.0 ? 1.0 : -1.0, value.y >= 0.0 ? 1.0 : -1.0);
+}
+
+vec3 zth_decode_octahedral(vec2 encoded)
+{
+    vec3 result = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+
+    // Unfolds the lower half of the octahedron.
+    float fold = max(-result.z, 0.0);
+    result.xy -= fold * zth_sign_not_zero(result.xy);
+
+    return normalize(result);
+}
+
+// Compact vertices store their normal octahedral-encoded in the first 2 components.
+vec3 zth_vertex_normal(vec3 normal)
+{
+#if defined(ZTH_COMPACT_VERTEX)
+    return zth_decode_octahedral(normal.xy);
+#else
+    return normal;
+#endif
+}
+
+// Both instance formats share the attribute locations, so every shader which draws meshes declares them the same way:
+//
+// location | InstanceVertex     | CompactInstanceVertex
+// 3        | material index     | material index
+// 4        | transform column 0 | translation (w = 0)
+// 5        | transform column 1 | rotation quaternion
+// 6        | transform column 2 | scale
+// 7        | transform column 3 | -
+// 8        | normal matrix      | -
+
+// Standard instances supply the first column of their transform as a vec3, which reads as w = 1.0. Compact instances
+// store 0.0 in their translation's w.
+bool zth_is_compact_instance(vec4 instance_0)
+{
+    return instance_0.w == 0.0;
+}
+
+vec3 zth_rotate(vec4 quaternion, vec3 vector)
+{
+    vec3 t = 2.0 * cross(quaternion.xyz, vector);
+    return vector + quaternion.w * t + cross(quaternion.xyz, t);
+}
+
+// Transform matrix's last row is always (0, 0, 0, 1).
+mat4 zth_instance_transform(vec4 instance_0, vec4 instance_1, vec3 instance_2, vec3 instance_3)
+{
+    if (!zth_is_compact_instance(instance_0))
+    {
+        return mat4(
+            vec4(instance_0.xyz, 0.0),
+            vec4(instance_1.xyz, 0.0),
+            vec4(instance_2, 0.0),
+            vec4(instance_3, 1.0)
+        );
+    }
+
+    // The rotation got quantized, so it has to be normalized again.
+    vec4 rotation = normalize(instance_1);
+    vec3 scale = instance_2;
+
+    return mat4(
+        vec4(zth_rotate(rotation, vec3(scale.x, 0.0, 0.0)), 0.0),
+        vec4(zth_rotate(rotation, vec3(0.0, scale.y, 0.0)), 0.0),
+        vec4(zth_rotate(rotation, vec3(0.0, 0.0, scale.z)), 0.0),
+        vec4(instance_0.xyz, 1.0)
+    );
+}
+
+// The inverse transpose of R * S is R * S^-1, so compact instances don't need a normal matrix.
+vec3 zth_instance_normal(vec4 instance_0, vec4 instance_1, vec3 instance_2, mat3 normal_mat, vec3 normal)
+{
+    if (!zth_is_compact_instance(instance_0))
+        return normal_mat * normal;
+
+    return zth_rotate(normalize(instance_1), normal / instance_2);
+}
@@ -4,8 +4,12 @@
 
 #include "zenith/core/profiler.hpp"
 #include "zenith/core/scene.hpp"
+#include "zenith/gl/framebuffer.hpp"
+#include "zenith/gl/program_cache.hpp"
 #include "zenith/layer/layers.hpp"
+#include "zenith/renderer/renderer.hpp"
 #include "zenith/system/event_queue.hpp"
+#include "zenith/system/png.hpp"
 #include "zenith/system/window.hpp"
 #include "zenith/util/defer.hpp"
 
@@ -19,6 +23,10 @@ auto Application::init(const ApplicationSpec& spec) -> Result<void, String>
     delta_time_limit = spec.delta_time_limit;
     fixed_time_step = spec.fixed_time_step;
     max_fixed_updates_per_frame = spec.max_fixed_updates_per_frame;
+    fixed_delta_time = spec.fixed_delta_time;
+    _frame_count = spec.frame_count;
+    _screenshot_path = spec.screenshot_path;
+    gl::ProgramCache::set_directory(spec.shader_cache_directory);
 
     Defer cleanup{ [&] {
         pop_all_overlays();
@@ -86,6 +94,7 @@ auto Application::run() -> void
         fixed_update();
         update();
         render();
+        end_frame();
 
         Window::swap_buffers();
         Window::poll_events();
@@ -135,9 +144,20 @@ auto Application::render_time() -> double
     return _render_time;
 }
 
+auto Application::frames_rendered() -> u64
+{
+    return _frames_rendered;
+}
+
 auto Application::shut_down() -> void
 {
     ZTH_INTERNAL_TRACE("Shutting down application...");
+
+#if defined(ZTH_PROFILER)
+    // The profiler's queries have to be deleted while the OpenGL context, which the system layer owns, is still alive.
+    Profiler::shut_down();
+#endif
+
     pop_all_overlays();
     pop_all_layers();
 }
@@ -160,8 +180,9 @@ auto Application::start_frame() -> void
 
     auto current_time = time();
     _frame_time = current_time - _prev_start_frame_time_point;
-    _delta_time = std::min(_frame_time, delta_time_limit);
+    _delta_time = fixed_delta_time ? *fixed_delta_time : std::min(_frame_time, delta_time_limit);
     _prev_start_frame_time_point = current_time;
+    _simulation_time += _delta_time;
 
     _layers.start_frame();
     _overlays.start_frame();
@@ -179,8 +200,11 @@ auto Application::fixed_update() -> void
 
     auto start_fixed_update_time_point = time();
 
+    // With a fixed delta time the fixed updates have to follow the simulation instead of the wall clock as well.
+    auto elapsed_time = fixed_delta_time ? _simulation_time : time();
     auto accumulated_fixed_update_time = static_cast<double>(_fixed_updates_performed) * fixed_time_step;
-    auto fixed_updates_to_perform = static_cast<usize>((time() - accumulated_fixed_update_time) / fixed_time_step);
+    auto fixed_updates_to_perform =
+        static_cast<usize>((elapsed_time - accumulated_fixed_update_time) / fixed_time_step);
     fixed_updates_to_perform = std::min(fixed_updates_to_perform, max_fixed_updates_per_frame);
 
     for (usize i = 0; i < fixed_updates_to_perform; i++)
@@ -215,7 +239,34 @@ auto Application::render() -> void
     _layers.render();
     _overlays.render();
 
+    // The layers and overlays only record their passes.
+    Renderer::execute_frame_graph();
+
     _render_time = time() - start_render_time_point;
 }
 
+auto Application::end_frame() -> void
+{
+    _frames_rendered++;
+
+    if (_frame_count && _frames_rendered >= *_frame_count)
+        quit();
+
+    // The back buffer has to be read before it gets swapped.
+    if (_screenshot_path && Window::should_close())
+        save_screenshot(*_screenshot_path);
+}
+
+auto Application::save_screenshot(const std::filesystem::path& path) -> void
+{
+    ZTH_PROFILE_FUNCTION();
+
+    auto size = Window::framebuffer_size();
+    auto pixels = gl::Framebuffer::read_default_pixels(size);
+
+    // @robustness: std::filesystem::path::string() throws.
+    if (write_png(path, pixels, size))
+        ZTH_INTERNAL_INFO("[Application] Saved a screenshot to \"{}\".", path.string());
+}
+
 } // namespace zth
@@ -8,11 +8,14 @@ auto write_to(const std::filesystem::path& path, std::span<const byte> data, std
 
     Defer log_error{ [&] { ZTH_INTERNAL_ERROR("[Filesystem] Couldn't write to file: \"{}\".", path.string()); } };
 
-    std::error_code error_code;
-    std::filesystem::create_directories(path, error_code);
-
-    if (error_code)
-        return false;
+    if (path.has_parent_path())
+    {
+        std::error_code error_code;
+        std::filesystem::create_directories(path.parent_path(), error_code);
+
+        if (error_code)
+            return false;
+    }
 
     std::ofstream file{ path, mode };
 
@@ -0,0 +1,111 @@
+#include "zenith/system/job_system.hpp"
+
+#include "zenith/core/assert.hpp"
+#include "zenith/log/logger.hpp"
+
+namespace zth {
+
+auto JobSystem::init(u32 worker_count) -> Result<void, String>
+{
+    ZTH_INTERNAL_TRACE("Initializing job system...");
+
+    if (worker_count == 0)
+        worker_count = std::max(std::thread::hardware_concurrency(), 1u) - 1;
+
+    _stopping = false;
+    _workers.reserve(worker_count);
+
+    for (u32 i = 0; i < worker_count; i++)
+        _workers.emplace_back(worker_main);
+
+    ZTH_INTERNAL_TRACE("Job system initialized with {} worker threads.", worker_count);
+    return {};
+}
+
+auto JobSystem::shut_down() -> void
+{
+    ZTH_INTERNAL_TRACE("Shutting down job system...");
+
+    {
+        std::scoped_lock lock{ _mutex };
+        _stopping = true;
+    }
+
+    _job_available.notify_all();
+    _workers.clear(); // Joins the threads.
+}
+
+auto JobSystem::run(Job& job) -> void
+{
+    std::scoped_lock submit_lock{ _submit_mutex };
+
+    {
+        std::scoped_lock lock{ _mutex };
+        _job = &job;
+        _job_generation++;
+    }
+
+    _job_available.notify_all();
+
+    _running_job = true;
+    work_on(job);
+    _running_job = false;
+
+    for (auto left = job.ranges_left.load(); left != 0; left = job.ranges_left.load())
+        job.ranges_left.wait(left);
+
+    // Workers which picked up the job might still be about to touch it, so it has to outlive them.
+    std::unique_lock lock{ _mutex };
+    _job = nullptr;
+    _workers_idle.wait(lock, [] { return _active_workers == 0; });
+}
+
+auto JobSystem::work_on(Job& job) -> void
+{
+    for (auto range = job.next_range.fetch_add(1); range < job.range_count; range = job.next_range.fetch_add(1))
+    {
+        auto begin = range * job.range_size;
+        auto end = std::min(begin + job.range_size, job.count);
+        job.function(job.context, begin, end);
+
+        if (job.ranges_left.fetch_sub(1) == 1)
+            job.ranges_left.notify_all();
+    }
+}
+
+auto JobSystem::worker_main() -> void
+{
+    _running_job = true; // Workers only ever run jobs, so their nested parallel_for calls mustn't wait for the pool.
+
+    u64 seen_generation = 0;
+
+    while (true)
+    {
+        Job* job = nullptr;
+
+        {
+            std::unique_lock lock{ _mutex };
+            _job_available.wait(lock, [&] { return _stopping || _job_generation != seen_generation; });
+
+            if (_stopping)
+                return;
+
+            seen_generation = _job_generation;
+            job = _job;
+
+            if (!job)
+                continue;
+
+            _active_workers++;
+        }
+
+        work_on(*job);
+
+        std::scoped_lock lock{ _mutex };
+
+        if (--_active_workers == 0)
+            _workers_idle.notify_all();
+    }
+}
+
+} // namespace zth
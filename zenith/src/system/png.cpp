@@ -0,0 +1,141 @@
+#include "zenith/system/png.hpp"
+
+#include <algorithm>
+#include <array>
+#include <string_view>
+
+#include "zenith/core/assert.hpp"
+#include "zenith/system/file.hpp"
+
+namespace zth {
+
+namespace {
+
+constexpr u32 bytes_per_pixel = 4;
+// The largest amount of data a stored (uncompressed) deflate block can hold.
+constexpr usize max_stored_block_size = 65535;
+
+constexpr auto crc_table = [] {
+    std::array<u32, 256> result{};
+
+    for (u32 i = 0; i < result.size(); i++)
+    {
+        auto crc = i;
+
+        for (auto bit = 0; bit < 8; bit++)
+            crc = (crc & 1) != 0 ? 0xedb88320u ^ (crc >> 1) : crc >> 1;
+
+        result[i] = crc;
+    }
+
+    return result;
+}();
+
+auto update_crc(u32 crc, std::span<const u8> data) -> u32
+{
+    for (auto value : data)
+        crc = crc_table[(crc ^ value) & 0xff] ^ (crc >> 8);
+
+    return crc;
+}
+
+auto append_u32_big_endian(Vector<u8>& output, u32 value) -> void
+{
+    output.insert(output.end(), { static_cast<u8>(value >> 24), static_cast<u8>(value >> 16),
+                                  static_cast<u8>(value >> 8), static_cast<u8>(value) });
+}
+
+auto append_chunk(Vector<u8>& output, std::string_view type, std::span<const u8> data) -> void
+{
+    ZTH_ASSERT(type.size() == 4);
+
+    append_u32_big_endian(output, static_cast<u32>(data.size()));
+
+    // The checksum covers the chunk type and the data.
+    auto chunk_start = output.size();
+    output.insert(output.end(), type.begin(), type.end());
+    output.insert(output.end(), data.begin(), data.end());
+
+    auto crc = update_crc(0xffffffffu, std::span{ output }.subspan(chunk_start)) ^ 0xffffffffu;
+    append_u32_big_endian(output, crc);
+}
+
+// Wraps the data in a zlib stream made up of stored deflate blocks.
+auto zlib_store(std::span<const u8> data) -> Vector<u8>
+{
+    Vector<u8> result;
+    result.reserve(data.size() + data.size() / max_stored_block_size * 5 + 16);
+
+    // Deflate with a 32K window and no compression.
+    result.insert(result.end(), { 0x78, 0x01 });
+
+    usize offset = 0;
+
+    do
+    {
+        auto block_size = std::min(data.size() - offset, max_stored_block_size);
+        auto last_block = offset + block_size == data.size();
+        auto length = static_cast<u16>(block_size);
+        auto inverted_length = static_cast<u16>(~length);
+
+        result.insert(result.end(), { static_cast<u8>(last_block ? 1 : 0), static_cast<u8>(length),
+                                      static_cast<u8>(length >> 8), static_cast<u8>(inverted_length),
+                                      static_cast<u8>(inverted_length >> 8) });
+
+        auto block = data.subspan(offset, block_size);
+        result.insert(result.end(), block.begin(), block.end());
+        offset += block_size;
+    } while (offset < data.size());
+
+    // Adler-32 checksum of the uncompressed data.
+    constexpr u32 adler_modulus = 65521;
+    u32 a = 1;
+    u32 b = 0;
+
+    for (auto value : data)
+    {
+        a = (a + value) % adler_modulus;
+        b = (b + a) % adler_modulus;
+    }
+
+    append_u32_big_endian(result, b << 16 | a);
+    return result;
+}
+
+} // namespace
+
+auto encode_png(std::span<const u8> rgba_pixels, glm::uvec2 size) -> Vector<u8>
+{
+    auto row_size = static_cast<usize>(size.x) * bytes_per_pixel;
+    ZTH_ASSERT(rgba_pixels.size() == row_size * size.y);
+
+    // Every row starts with the filter type, which is always none.
+    Vector<u8> filtered_pixels;
+    filtered_pixels.reserve((row_size + 1) * size.y);
+
+    for (usize row = 0; row < size.y; row++)
+    {
+        auto row_pixels = rgba_pixels.subspan(row * row_size, row_size);
+        filtered_pixels.push_back(0);
+        filtered_pixels.insert(filtered_pixels.end(), row_pixels.begin(), row_pixels.end());
+    }
+
+    Vector<u8> header;
+    append_u32_big_endian(header, size.x);
+    append_u32_big_endian(header, size.y);
+    // 8 bits per channel, RGBA, deflate compression, adaptive filtering, no interlacing.
+    header.insert(header.end(), { 8, 6, 0, 0, 0 });
+
+    Vector<u8> result{ 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+    append_chunk(result, "IHDR", header);
+    append_chunk(result, "IDAT", zlib_store(filtered_pixels));
+    append_chunk(result, "IEND", {});
+    return result;
+}
+
+auto write_png(const std::filesystem::path& path, std::span<const u8> rgba_pixels, glm::uvec2 size) -> bool
+{
+    return fs::write_to(path, encode_png(rgba_pixels, size));
+}
+
+} // namespace zth
@@ -34,6 +34,29 @@ namespace {
     std::unreachable();
 }
 
+[[nodiscard]] auto init_glfw([[maybe_unused]] bool headless) -> bool
+{
+    if (glfwInit())
+        return true;
+
+#if defined(GLFW_PLATFORM_NULL)
+    // Without a display only the null platform is available, and it can only create OSMesa contexts.
+    if (headless)
+    {
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+
+        if (glfwInit())
+        {
+            ZTH_INTERNAL_INFO("[Window] No display available. Using the null platform with an OSMesa context.");
+            glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+            return true;
+        }
+    }
+#endif
+
+    return false;
+}
+
 [[nodiscard]] auto init_glad() -> bool
 {
     return gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress));
@@ -60,7 +83,7 @@ auto Window::init(const WindowSpec& spec) -> Result<void, String>
         return Error{ error_message };
     }
 
-    if (!glfwInit())
+    if (!init_glfw(spec.headless))
         return Error{ "Failed to initialize GLFW." };
 
     Defer terminate_glfw{ [] { glfwTerminate(); } };
@@ -69,23 +92,27 @@ auto Window::init(const WindowSpec& spec) -> Result<void, String>
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, static_cast<int>(spec.gl_version.minor));
     glfwWindowHint(GLFW_OPENGL_PROFILE, to_glfw_enum(spec.gl_profile));
     glfwWindowHint(GLFW_RESIZABLE, to_glfw_enum(spec.resizable));
-    glfwWindowHint(GLFW_MAXIMIZED, to_glfw_enum(spec.maximized));
+    glfwWindowHint(GLFW_MAXIMIZED, to_glfw_enum(spec.maximized && !spec.headless));
     glfwWindowHint(GLFW_SAMPLES, static_cast<int>(spec.samples));
     glfwWindowHint(GLFW_TRANSPARENT_FRAMEBUFFER, to_glfw_enum(spec.transparent_framebuffer));
+    glfwWindowHint(GLFW_VISIBLE, to_glfw_enum(!spec.headless));
+    glfwWindowHint(GLFW_FOCUSED, to_glfw_enum(!spec.headless));
 
 #if defined(ZTH_GL_DEBUG)
     glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, true);
 #endif
 
-    _window = create_glfw_window(spec.size, spec.title.data(), spec.fullscreen);
+    _window = create_glfw_window(spec.size, spec.title.data(), spec.fullscreen && !spec.headless);
 
     if (!_window)
         return Error{ "Failed to create a window." };
 
     Defer destroy_window{ [&] { glfwDestroyWindow(_window); } };
 
+    _headless = spec.headless;
+
     make_context_current();
-    set_vsync_enabled(spec.vsync);
+    set_vsync_enabled(spec.vsync && !spec.headless);
 
     if (spec.frame_rate_limit)
         set_frame_rate_limit(*spec.frame_rate_limit);
@@ -201,6 +228,11 @@ auto Window::set_cursor_enabled(bool enabled) -> void
     }
 }
 
+auto Window::gl_proc_address(const char* name) -> void (*)()
+{
+    return glfwGetProcAddress(name);
+}
+
 auto Window::glfw_handle() -> GLFWwindow*
 {
     return _window;
@@ -213,6 +245,13 @@ auto Window::size() -> glm::uvec2
     return glm::uvec2{ static_cast<unsigned int>(width), static_cast<unsigned int>(height) };
 }
 
+auto Window::framebuffer_size() -> glm::uvec2
+{
+    int width, height;
+    glfwGetFramebufferSize(_window, &width, &height);
+    return glm::uvec2{ static_cast<unsigned int>(width), static_cast<unsigned int>(height) };
+}
+
 auto Window::aspect_ratio() -> float
 {
     int width, height;
@@ -250,6 +289,11 @@ auto Window::target_frame_time() -> double
     return _target_frame_time;
 }
 
+auto Window::headless() -> bool
+{
+    return _headless;
+}
+
 auto Window::create_glfw_window(glm::uvec2 size, const char* title, bool fullscreen) -> GLFWwindow*
 {
     GLFWmonitor* monitor = nullptr;